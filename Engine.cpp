@@ -6,6 +6,7 @@
 #include "common/debug.h"
 #include "util/Time.h"
 #include "GL/GraphicsGL.h"
+#include "Null/GraphicsNull.h"
 #include "geometry/Vector3.h"
 #include "math/Math.h"
 #include "math/Quaternion.h"
@@ -13,18 +14,23 @@
 #include "animation/Skeleton.h"
 #include "animation/VertexBoneMap.h"
 #include "render/BaseObject3DRenderer.h"
+#include "render/MeshRenderer.h"
 #include "render/ReflectionProbe.h"
+#include "render/MatrixBuffer.h"
 #include "scene/Scene.h"
 #include "scene/Object3D.h"
 #include "render/Camera.h"
 #include "geometry/Mesh.h"
+#include "geometry/InterleavedAttributeGPUStorage.h"
 #include "image/CubeTexture.h"
 #include "material/BasicMaterial.h"
+#include "material/BasicColoredMaterial.h"
 #include "material/BasicCubeMaterial.h"
 #include "material/BasicTexturedMaterial.h"
 #include "material/BasicTexturedLitMaterial.h"
 #include "material/StandardPhysicalMaterial.h"
 #include "material/AmbientPhysicalMaterial.h"
+#include "material/ShaderManager.h"
 #include "particles/ParticleSystemManager.h"
 #include "particles/ParticleSystem.h"
 #include "particles/initializer/BasicParticleStateInitializer.h"
@@ -34,6 +40,10 @@ namespace Core {
 
     std::shared_ptr<Engine> Engine::_instance;
     Bool Engine::_shuttingDown = false;
+    GraphicsBackend Engine::_graphicsBackend = GraphicsBackend::OpenGL;
+    std::string Engine::_shaderCacheDirectory;
+    std::string Engine::_preprocessedShaderPath;
+    Bool Engine::_lazyShaderCompilation = false;
 
     WeakPointer<Engine> Engine::instance() {
         errorIfShuttingDown();
@@ -48,6 +58,66 @@ namespace Core {
         return _shuttingDown;
     }
 
+    /*
+     * Choose the graphics system the engine is created with. The choice is made once, so this must be
+     * called before the first call to instance().
+     */
+    void Engine::setGraphicsBackend(GraphicsBackend backend) {
+        if (_instance) {
+            throw Exception("Engine::setGraphicsBackend() -> The graphics backend can't be changed once the engine exists.");
+        }
+        _graphicsBackend = backend;
+    }
+
+    GraphicsBackend Engine::getGraphicsBackend() {
+        return _graphicsBackend;
+    }
+
+    /*
+     * Directory in which linked shader programs are cached between runs (see GLProgramBinaryCache). Caching
+     * is off while no directory is set.
+     */
+    void Engine::setShaderCacheDirectory(const std::string& directory) {
+        if (_instance) {
+            throw Exception("Engine::setShaderCacheDirectory() -> The shader cache can't be changed once the engine exists.");
+        }
+        _shaderCacheDirectory = directory;
+    }
+
+    const std::string& Engine::getShaderCacheDirectory() {
+        return _shaderCacheDirectory;
+    }
+
+    /*
+     * File with the shader sources expanded at build time (see ShaderManager::savePreprocessedSources()).
+     * Shader sources are expanded at runtime while no file is set, or if the file is out of date.
+     */
+    void Engine::setPreprocessedShaderPath(const std::string& path) {
+        if (_instance) {
+            throw Exception("Engine::setPreprocessedShaderPath() -> The preprocessed shaders can't be changed once the engine exists.");
+        }
+        _preprocessedShaderPath = path;
+    }
+
+    const std::string& Engine::getPreprocessedShaderPath() {
+        return _preprocessedShaderPath;
+    }
+
+    /*
+     * Compile shader programs when something is first drawn with them (or when warmupShaders() queues them)
+     * rather than when their materials are built. Must be chosen before the first call to instance().
+     */
+    void Engine::setLazyShaderCompilation(Bool lazy) {
+        if (_instance) {
+            throw Exception("Engine::setLazyShaderCompilation() -> Lazy shader compilation can't be changed once the engine exists.");
+        }
+        _lazyShaderCompilation = lazy;
+    }
+
+    Bool Engine::isLazyShaderCompilationEnabled() {
+        return _lazyShaderCompilation;
+    }
+
     void Engine::errorIfShuttingDown() {
         if(_shuttingDown) {
             throw Exception("Cannot access engine during shutdown.");
@@ -64,9 +134,15 @@ namespace Core {
     
     void Engine::init() {
 
-        // TODO: make this configurable so that it is not hard-coded to use OpenGL
-        std::shared_ptr<GraphicsGL> graphicsSystem(new GraphicsGL(GraphicsGL::GLVersion::Three));
-        this->graphics = std::static_pointer_cast<Graphics>(graphicsSystem);
+        switch (_graphicsBackend) {
+            case GraphicsBackend::Null:
+                this->graphics = std::shared_ptr<Graphics>(new GraphicsNull());
+            break;
+            case GraphicsBackend::OpenGL:
+            default:
+                this->graphics = std::shared_ptr<Graphics>(new GraphicsGL(GraphicsGL::GLVersion::Three));
+            break;
+        }
         this->graphics->init();
 
         this->animationManager = std::shared_ptr<AnimationManager>(new AnimationManager());
@@ -112,6 +188,12 @@ namespace Core {
         LongMaskUtil::setBit(&materialAttributes, (Int16)ShaderMaterialCharacteristic::CubeTextured);
         LongMaskUtil::setBit(&materialAttributes, (Int16)ShaderMaterialCharacteristic::VertexNormals);
         this->materialLibrary.addEntry(materialAttributes, basicCubeMaterial);
+
+        // drawn in place of materials whose shaders are still compiling, so it's built right away
+        WeakPointer<BasicColoredMaterial> fallbackMaterial = this->createMaterial<BasicColoredMaterial>();
+        fallbackMaterial->setObjectColor(Color(0.5f, 0.5f, 0.5f, 1.0f));
+        fallbackMaterial->prepareShader(true);
+        this->fallbackMaterial = fallbackMaterial;
     }
 
     void Engine::update() {
@@ -120,6 +202,7 @@ namespace Core {
         Time::update();
         this->animationManager->update();
         this->particleSystemManager->update();
+        this->textureStreamer.update();
         if (this->updateCallbacks.size() > 0) {
             
             for (auto func : this->updateCallbacks) {
@@ -152,6 +235,7 @@ namespace Core {
     void Engine::render() {
         if (this->activeScene) {
             this->graphics->preRender();
+            this->graphics->getShaderManager().update();
             this->resolveRenderCallbacks(this->preRenderCallbacks, this->persistentPreRenderCallbacks);
             if (this->graphics->getRenderer()) {
                this->graphics->getRenderer()->renderScene(this->activeScene);
@@ -177,10 +261,42 @@ namespace Core {
         return this->materialLibrary;
     }
 
+    WeakPointer<Material> Engine::getFallbackMaterial() {
+        return this->fallbackMaterial;
+    }
+
+    void Engine::setFallbackMaterial(WeakPointer<Material> material) {
+        if (!material.isValid()) {
+            throw InvalidArgumentException("Engine::setFallbackMaterial() -> 'material' is not valid.");
+        }
+        material->prepareShader(true);
+        this->fallbackMaterial = material;
+    }
+
+    /*
+     * Queue the shaders of the meshes in [scene] to be built over the next few frames, ahead of their first
+     * use. Returns the number of shaders queued.
+     */
+    UInt32 Engine::warmupShaders(WeakPointer<Scene> scene) {
+        ShaderManager& shaderManager = this->graphics->getShaderManager();
+        UInt32 queued = 0;
+        scene->visitScene(scene->getRoot(), [&shaderManager, &queued](WeakPointer<Object3D> object) {
+            WeakPointer<MeshRenderer> meshRenderer = WeakPointer<BaseObject3DRenderer>::dynamicPointerCast<MeshRenderer>(object->getBaseRenderer());
+            if (!meshRenderer.isValid()) return;
+            WeakPointer<Material> material = meshRenderer->getMaterial();
+            if (material.isValid() && shaderManager.enqueueWarmup(material->getShader())) queued++;
+        });
+        return queued;
+    }
+
     ModelLoader& Engine::getModelLoader() {
         return this->modelLoader;
     }
 
+    TextureStreamer& Engine::getTextureStreamer() {
+        return this->textureStreamer;
+    }
+
     WeakPointer<Graphics> Engine::getGraphicsSystem() {
         errorIfShuttingDown();
         return this->graphics;
@@ -301,12 +417,28 @@ namespace Core {
         return spGPUStorage;
     }
 
+    WeakPointer<AttributeArrayGPUStorage> Engine::createInterleavedGPUStorage(std::shared_ptr<InterleavedVertexBuffer> buffer, UInt32 element) {
+        InterleavedAttributeGPUStorage* newGPUStoragePtr = new(std::nothrow) InterleavedAttributeGPUStorage(buffer, element);
+        if (newGPUStoragePtr == nullptr) {
+            throw AllocationException("Engine::createInterleavedGPUStorage -> Unable to allocate new InterleavedAttributeGPUStorage");
+        }
+        std::shared_ptr<AttributeArrayGPUStorage> spGPUStorage = std::shared_ptr<AttributeArrayGPUStorage>(newGPUStoragePtr);
+        this->objectManager.addReference(spGPUStorage, CoreObjectReferenceManager::OwnerType::Single);
+        return spGPUStorage;
+    }
+
     WeakPointer<IndexBuffer> Engine::createIndexBuffer(UInt32 size) {
         std::shared_ptr<IndexBuffer> spIndexBufer = this->graphics->createIndexBuffer(size);
         this->objectManager.addReference(spIndexBufer, CoreObjectReferenceManager::OwnerType::Single);
         return spIndexBufer;
     }
 
+    WeakPointer<MatrixBuffer> Engine::createMatrixBuffer(UInt32 capacity) {
+        std::shared_ptr<MatrixBuffer> spMatrixBuffer = this->graphics->createMatrixBuffer(capacity);
+        this->objectManager.addReference(spMatrixBuffer, CoreObjectReferenceManager::OwnerType::Single);
+        return spMatrixBuffer;
+    }
+
     WeakPointer<ReflectionProbe> Engine::createReflectionProbe(WeakPointer<Object3D> owner) {
         ReflectionProbe* newReflectionProbePtr = new(std::nothrow) ReflectionProbe(owner);
         if (newReflectionProbePtr == nullptr) {
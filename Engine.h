@@ -7,6 +7,7 @@
 #include "base/CoreObjectReferenceManager.h"
 #include "scene/Object3D.h"
 #include "asset/ModelLoader.h"
+#include "image/TextureStreamer.h"
 #include "geometry/Vector4.h"
 #include "image/TextureAttr.h"
 #include "material/Material.h"
@@ -37,7 +38,15 @@ namespace Core {
     class VertexBoneMap;
     class Mesh;
     class AttributeArrayGPUStorage;
+    class InterleavedVertexBuffer;
     class IndexBuffer;
+    class MatrixBuffer;
+
+    enum class GraphicsBackend {
+        OpenGL = 0,
+        // records the commands it is given instead of executing them (see GraphicsNull)
+        Null = 1
+    };
 
     class Engine final {
     public:
@@ -47,6 +56,14 @@ namespace Core {
 
         static WeakPointer<Engine> instance();
         static Bool isShuttingDown();
+        static void setGraphicsBackend(GraphicsBackend backend);
+        static GraphicsBackend getGraphicsBackend();
+        static void setShaderCacheDirectory(const std::string& directory);
+        static const std::string& getShaderCacheDirectory();
+        static void setPreprocessedShaderPath(const std::string& path);
+        static const std::string& getPreprocessedShaderPath();
+        static void setLazyShaderCompilation(Bool lazy);
+        static Bool isLazyShaderCompilationEnabled();
 
         void update();
         void render();
@@ -56,7 +73,11 @@ namespace Core {
         void setDefaultViewport(UInt32 hOffset, UInt32 vOffset, UInt32 viewPortWidth, UInt32 viewPortHeight);
 
         MaterialLibrary& getMaterialLibrary();
+        WeakPointer<Material> getFallbackMaterial();
+        void setFallbackMaterial(WeakPointer<Material> material);
+        UInt32 warmupShaders(WeakPointer<Scene> scene);
         ModelLoader& getModelLoader();
+        TextureStreamer& getTextureStreamer();
 
         WeakPointer<Graphics> getGraphicsSystem();
         WeakPointer<AnimationManager> getAnimationManager();
@@ -162,7 +183,9 @@ namespace Core {
         WeakPointer<CubeTexture> createCubeTexture(const TextureAttributes& attributes);
 
         WeakPointer<AttributeArrayGPUStorage> createGPUStorage(UInt32 size, UInt32 componentCount, AttributeType type, Bool normalize);
+        WeakPointer<AttributeArrayGPUStorage> createInterleavedGPUStorage(std::shared_ptr<InterleavedVertexBuffer> buffer, UInt32 element);
         WeakPointer<IndexBuffer> createIndexBuffer(UInt32 size);
+        WeakPointer<MatrixBuffer> createMatrixBuffer(UInt32 capacity);
 
         WeakPointer<ReflectionProbe> createReflectionProbe(WeakPointer<Object3D> owner);
 
@@ -190,6 +213,10 @@ namespace Core {
 
         static std::shared_ptr<Engine> _instance;
         static Bool _shuttingDown;
+        static GraphicsBackend _graphicsBackend;
+        static std::string _shaderCacheDirectory;
+        static std::string _preprocessedShaderPath;
+        static Bool _lazyShaderCompilation;
         static void errorIfShuttingDown();
 
         Bool profilingEnabled;
@@ -210,6 +237,8 @@ namespace Core {
         std::vector<LifecycleEventCallback> persistentPostRenderCallbacks;
 
         MaterialLibrary materialLibrary;
+        PersistentWeakPointer<Material> fallbackMaterial;
         ModelLoader modelLoader;
+        TextureStreamer textureStreamer;
     };
 }
@@ -0,0 +1,61 @@
+#include <stdint.h>
+
+#include "AttributeArrayGPUStorageGL.h"
+#include "GraphicsGL.h"
+
+namespace Core {
+
+    /*
+     * The array buffer is left bound after the attribute pointer is set up (the pointer keeps referring to
+     * the buffer it was set up with), so that consecutive attributes from the same buffer don't rebind it.
+     */
+    void AttributeArrayGPUStorageGL::enableAndSendToActiveShader(UInt32 location) {
+        GraphicsGL::getStateCache().bindBuffer(GL_ARRAY_BUFFER, this->bufferID);
+        glEnableVertexAttribArray(location);
+        if (isIntegerAttribute(this->type, this->normalize)) {
+#ifdef __APPLE__
+            glVertexAttribIPointerEXT(location, this->componentCount, this->type, this->stride, 0);
+#else
+            glVertexAttribIPointer(location, this->componentCount, this->type, this->stride, 0);
+#endif
+        } else {
+            glVertexAttribPointer(location, this->componentCount, this->type, this->normalize, this->stride, 0);
+        }
+    }
+
+    void AttributeArrayGPUStorageGL::bind() {
+        GraphicsGL::getStateCache().bindBuffer(GL_ARRAY_BUFFER, this->bufferID);
+    }
+
+    /*
+     * All elements of an interleaved buffer are sent back to back, so the caller binds the buffer once
+     * with bind() instead of every element binding it again.
+     */
+    void AttributeArrayGPUStorageGL::enableAndSendElementToActiveShader(UInt32 location, UInt32 componentCount, AttributeType type,
+                                                                        Bool normalize, UInt32 stride, UInt32 offset) {
+        GLenum glType = GraphicsGL::convertAttributeType(type);
+        const void* pointer = reinterpret_cast<const void*>((uintptr_t)offset);
+        glEnableVertexAttribArray(location);
+        if (isIntegerAttribute(glType, normalize ? GL_TRUE : GL_FALSE)) {
+#ifdef __APPLE__
+            glVertexAttribIPointerEXT(location, componentCount, glType, stride, pointer);
+#else
+            glVertexAttribIPointer(location, componentCount, glType, stride, pointer);
+#endif
+        } else {
+            glVertexAttribPointer(location, componentCount, glType, normalize ? GL_TRUE : GL_FALSE, stride, pointer);
+        }
+    }
+
+    void AttributeArrayGPUStorageGL::updateBufferData(void * data) {
+        GLStateCache& stateCache = GraphicsGL::getStateCache();
+        stateCache.bindBuffer(GL_ARRAY_BUFFER, this->bufferID);
+        glBufferData(GL_ARRAY_BUFFER, this->size, data, GL_DYNAMIC_DRAW);
+        stateCache.bindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+
+    void AttributeArrayGPUStorageGL::destroyGPUBuffer() {
+        glDeleteBuffers(1, &this->bufferID);
+        GraphicsGL::getStateCache().bufferDeleted(this->bufferID);
+    }
+}
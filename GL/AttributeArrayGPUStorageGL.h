@@ -36,29 +36,25 @@ namespace Core {
             return stride;
         }
 
-        void enableAndSendToActiveShader(UInt32 location) override {
-            glBindBuffer(GL_ARRAY_BUFFER, this->bufferID);
-            glEnableVertexAttribArray(location);
-            if (this->type == GL_INT || this->type == GL_UNSIGNED_INT) {
-#ifdef __APPLE__
-                glVertexAttribIPointerEXT(location, this->componentCount, this->type, this->stride, 0);
-#else
-                glVertexAttribIPointer(location, this->componentCount, this->type, this->stride, 0);
-#endif
-            } else {
-                glVertexAttribPointer(location, this->componentCount, this->type, this->normalize, this->stride, 0);
-            }
-            glBindBuffer(GL_ARRAY_BUFFER, 0);
-        }
+        void enableAndSendToActiveShader(UInt32 location) override;
+        void bind() override;
+        void enableAndSendElementToActiveShader(UInt32 location, UInt32 componentCount, AttributeType type,
+                                                Bool normalize, UInt32 stride, UInt32 offset) override;
 
          void disable(UInt32 location) override {
             glDisableVertexAttribArray(location);
         }
 
-        void updateBufferData(void * data) override {
-            glBindBuffer(GL_ARRAY_BUFFER, this->bufferID);
-            glBufferData(GL_ARRAY_BUFFER, this->size, data, GL_DYNAMIC_DRAW);
-            glBindBuffer(GL_ARRAY_BUFFER, 0);
+        void setDivisor(UInt32 location, UInt32 divisor) override {
+            glVertexAttribDivisor(location, divisor);
+        }
+
+        void updateBufferData(void * data) override;
+
+        // integer data that is not normalized must reach the shader as integers (e.g. bone indices)
+        static Bool isIntegerAttribute(GLenum type, GLboolean normalize) {
+            if (type == GL_INT || type == GL_UNSIGNED_INT) return true;
+            return (type == GL_UNSIGNED_BYTE || type == GL_UNSIGNED_SHORT) && normalize == GL_FALSE;
         }
 
     private:
@@ -73,9 +69,7 @@ namespace Core {
             glGenBuffers(1, &this->bufferID);
         }
 
-        void destroyGPUBuffer() {
-            glDeleteBuffers(1, &this->bufferID);
-        }
+        void destroyGPUBuffer();
 
     };
 }
@@ -47,9 +47,10 @@ namespace Core {
     }
 
     void CubeTextureGL::updateMipMaps() {
-        glBindTexture(GL_TEXTURE_CUBE_MAP, this->getTextureID());
+        GLStateCache& stateCache = GraphicsGL::getStateCache();
+        stateCache.bindTexture(GL_TEXTURE_CUBE_MAP, this->getTextureID());
         glGenerateMipmap(GL_TEXTURE_CUBE_MAP);
-        glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
+        stateCache.bindTexture(GL_TEXTURE_CUBE_MAP, 0);
     }
 
     void CubeTextureGL::setupTexture(UInt32 width, UInt32 height, Byte* front, Byte* back, Byte* top, Byte* bottom, Byte* left, Byte* right) {
@@ -63,7 +64,8 @@ namespace Core {
         if (!tex) {
             throw AllocationException("CubeTexture::createCubeTexture -> Unable to generate texture");
         }
-        glBindTexture(GL_TEXTURE_CUBE_MAP, tex);
+        GLStateCache& stateCache = GraphicsGL::getStateCache();
+        stateCache.bindTexture(GL_TEXTURE_CUBE_MAP, tex);
 
         GLvoid * frontPixels = front != nullptr ? front : (GLvoid*)0;
         GLvoid * backPixels = back != nullptr ? back : (GLvoid*)0;
@@ -135,7 +137,7 @@ namespace Core {
             glGenerateMipmap(GL_TEXTURE_CUBE_MAP);
         }
 
-        glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
+        stateCache.bindTexture(GL_TEXTURE_CUBE_MAP, 0);
 
         this->textureId = (Int32)tex;
     }
@@ -0,0 +1,181 @@
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+#include "GLProgramBinaryCache.h"
+
+namespace Core {
+
+    static const UInt32 ProgramBinaryMagic = 0x4E494250; // "PBIN"
+    static const UInt32 ProgramBinaryVersion = 1;
+
+    static UInt64 hashString(const char* value, UInt64 hash) {
+        // the terminator is hashed too, so that adjacent strings can't run into each other
+        for (const char* c = value; ; c++) {
+            hash ^= (Byte)*c;
+            hash *= 1099511628211ULL;
+            if (*c == '\0') break;
+        }
+        return hash;
+    }
+
+    GLProgramBinaryCache::GLProgramBinaryCache() {
+        this->supported = false;
+        this->driverHash = 0;
+    }
+
+    /*
+     * Check whether the current context can retrieve program binaries, and identify its driver. Must be
+     * called with the context current.
+     */
+    void GLProgramBinaryCache::init() {
+        this->supported = false;
+        this->driverHash = 14695981039346656037ULL;
+        const GLenum names[] = {GL_VENDOR, GL_RENDERER, GL_VERSION};
+        for (GLenum name : names) {
+            const char* value = (const char*)glGetString(name);
+            this->driverHash = hashString(value != nullptr ? value : "", this->driverHash);
+        }
+
+        // program binaries are core in GL 4.1 and GLES 3.0; before that they need ARB_get_program_binary
+        Bool hasEntryPoints = false;
+        GLint major = 0, minor = 0;
+        glGetIntegerv(GL_MAJOR_VERSION, &major);
+        glGetIntegerv(GL_MINOR_VERSION, &minor);
+        if (major * 10 + minor >= 41) {
+            hasEntryPoints = true;
+        } else {
+            GLint extensionCount = 0;
+            glGetIntegerv(GL_NUM_EXTENSIONS, &extensionCount);
+            for (GLint i = 0; i < extensionCount && !hasEntryPoints; i++) {
+                const char* extension = (const char*)glGetStringi(GL_EXTENSIONS, (GLuint)i);
+                hasEntryPoints = extension != nullptr && strcmp(extension, "GL_ARB_get_program_binary") == 0;
+            }
+        }
+        glGetError();
+
+        // a driver may support the entry points and still offer no format to save programs in
+        GLint formatCount = 0;
+        if (hasEntryPoints) glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+        this->supported = hasEntryPoints && formatCount > 0;
+    }
+
+    void GLProgramBinaryCache::setDirectory(const std::string& directory) {
+        this->directory = directory;
+    }
+
+    const std::string& GLProgramBinaryCache::getDirectory() const {
+        return this->directory;
+    }
+
+    Bool GLProgramBinaryCache::isSupported() const {
+        return this->supported;
+    }
+
+    Bool GLProgramBinaryCache::isEnabled() const {
+        return this->supported && this->directory.size() > 0;
+    }
+
+    /*
+     * Create a program from the binary stored for [sourceHash]. Returns 0 if there is no binary for this
+     * driver, or if the driver rejects it; a rejected file is removed so that it gets replaced.
+     */
+    GLuint GLProgramBinaryCache::loadProgram(UInt64 sourceHash) {
+        if (!this->isEnabled()) return 0;
+        std::string path = this->getFilePath(sourceHash);
+        FILE* file = fopen(path.c_str(), "rb");
+        if (file == nullptr) return 0;
+
+        UInt32 header[2];
+        UInt64 hashes[2];
+        UInt32 binaryInfo[2];
+        Bool success = fread(header, sizeof(UInt32), 2, file) == 2 && fread(hashes, sizeof(UInt64), 2, file) == 2 &&
+                       fread(binaryInfo, sizeof(UInt32), 2, file) == 2;
+        success = success && header[0] == ProgramBinaryMagic && header[1] == ProgramBinaryVersion &&
+                  hashes[0] == this->driverHash && hashes[1] == sourceHash && binaryInfo[1] > 0;
+        std::vector<Byte> binary;
+        if (success) {
+            binary.resize(binaryInfo[1]);
+            success = fread(binary.data(), 1, binary.size(), file) == binary.size();
+        }
+        fclose(file);
+        if (!success) {
+            remove(path.c_str());
+            return 0;
+        }
+
+        GLuint program = glCreateProgram();
+        if (!program) return 0;
+        glProgramBinary(program, (GLenum)binaryInfo[0], binary.data(), (GLsizei)binary.size());
+        GLint linked = GL_FALSE;
+        glGetProgramiv(program, GL_LINK_STATUS, &linked);
+        if (!linked) {
+            // usually a driver update that kept the version string; the binary has to be rebuilt
+            glGetError();
+            glDeleteProgram(program);
+            remove(path.c_str());
+            return 0;
+        }
+        return program;
+    }
+
+    /*
+     * Ask the driver to keep [program] retrievable. Must be called before the program is linked.
+     */
+    void GLProgramBinaryCache::prepareProgram(GLuint program) {
+        if (this->isEnabled()) glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+
+    /*
+     * Save the binary of the linked [program] under [sourceHash]. The file is written next to its final
+     * location and renamed into place, so a concurrent or interrupted run never sees a partial binary.
+     */
+    Bool GLProgramBinaryCache::storeProgram(UInt64 sourceHash, GLuint program) {
+        if (!this->isEnabled()) return false;
+        GLint length = 0;
+        glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+        if (length <= 0) return false;
+        std::vector<Byte> binary((size_t)length);
+        GLenum format = 0;
+        GLsizei written = 0;
+        glGetProgramBinary(program, length, &written, &format, binary.data());
+        if (written <= 0) {
+            glGetError();
+            return false;
+        }
+
+        UInt32 header[2] = {ProgramBinaryMagic, ProgramBinaryVersion};
+        UInt64 hashes[2] = {this->driverHash, sourceHash};
+        UInt32 binaryInfo[2] = {(UInt32)format, (UInt32)written};
+        std::string path = this->getFilePath(sourceHash);
+        std::string tempPath = path + ".tmp";
+        FILE* file = fopen(tempPath.c_str(), "wb");
+        if (file == nullptr) return false;
+        Bool success = fwrite(header, sizeof(UInt32), 2, file) == 2 && fwrite(hashes, sizeof(UInt64), 2, file) == 2 &&
+                       fwrite(binaryInfo, sizeof(UInt32), 2, file) == 2 &&
+                       fwrite(binary.data(), 1, (size_t)written, file) == (size_t)written;
+        success = fclose(file) == 0 && success;
+        if (success) success = rename(tempPath.c_str(), path.c_str()) == 0;
+        if (!success) remove(tempPath.c_str());
+        return success;
+    }
+
+    UInt64 GLProgramBinaryCache::hashSources(const std::string& vertex, const std::string* geometry, const std::string& fragment) {
+        UInt64 hash = 14695981039346656037ULL;
+        hash = hashString(vertex.c_str(), hash);
+        hash = hashString(geometry != nullptr ? geometry->c_str() : "", hash);
+        hash = hashString(fragment.c_str(), hash);
+        // without this a program with an empty geometry shader would share a key with one that has none
+        hash ^= geometry != nullptr ? 1 : 0;
+        hash *= 1099511628211ULL;
+        return hash;
+    }
+
+    std::string GLProgramBinaryCache::getFilePath(UInt64 sourceHash) const {
+        char name[32];
+        snprintf(name, sizeof(name), "%016llx.bin", (unsigned long long)sourceHash);
+        std::string path = this->directory;
+        if (path.back() != '/') path += '/';
+        return path + name;
+    }
+}
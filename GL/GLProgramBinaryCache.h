@@ -0,0 +1,38 @@
+#pragma once
+
+#include <string>
+
+#include "../common/gl.h"
+#include "../common/types.h"
+
+namespace Core {
+
+    // On-disk cache of linked program binaries (glGetProgramBinary / glProgramBinary). A binary is stored per
+    // program under the hash of its sources, and is only ever handed back to the same driver: the file
+    // records a hash of the GL vendor, renderer and version strings. The cache is off until a directory is
+    // set, and stays off when the context can't retrieve program binaries. Any failure (a missing or stale
+    // file, or a driver that rejects the binary) makes the caller compile from source as usual.
+    class GLProgramBinaryCache final {
+    public:
+        GLProgramBinaryCache();
+
+        void init();
+        void setDirectory(const std::string& directory);
+        const std::string& getDirectory() const;
+        Bool isSupported() const;
+        Bool isEnabled() const;
+
+        GLuint loadProgram(UInt64 sourceHash);
+        void prepareProgram(GLuint program);
+        Bool storeProgram(UInt64 sourceHash, GLuint program);
+
+        static UInt64 hashSources(const std::string& vertex, const std::string* geometry, const std::string& fragment);
+
+    private:
+        std::string getFilePath(UInt64 sourceHash) const;
+
+        Bool supported;
+        UInt64 driverHash;
+        std::string directory;
+    };
+}
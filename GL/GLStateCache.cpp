@@ -0,0 +1,750 @@
+#include "GLStateCache.h"
+#include "../common/debug.h"
+
+namespace Core {
+
+    static void glStateEnable(GLenum capability) { glEnable(capability); }
+    static void glStateDisable(GLenum capability) { glDisable(capability); }
+    static void glStateBlendEquation(GLenum equation) { glBlendEquation(equation); }
+    static void glStateBlendFuncSeparate(GLenum source, GLenum dest, GLenum sourceAlpha, GLenum destAlpha) {
+        glBlendFuncSeparate(source, dest, sourceAlpha, destAlpha);
+    }
+    static void glStateDepthFunc(GLenum function) { glDepthFunc(function); }
+    static void glStateDepthMask(GLboolean enabled) { glDepthMask(enabled); }
+    static void glStateColorMask(GLboolean red, GLboolean green, GLboolean blue, GLboolean alpha) {
+        glColorMask(red, green, blue, alpha);
+    }
+    static void glStateCullFace(GLenum face) { glCullFace(face); }
+    static void glStateFrontFace(GLenum face) { glFrontFace(face); }
+    static void glStateStencilFunc(GLenum function, GLint reference, GLuint mask) { glStencilFunc(function, reference, mask); }
+    static void glStateStencilOp(GLenum sFail, GLenum dpFail, GLenum dpPass) { glStencilOp(sFail, dpFail, dpPass); }
+    static void glStateStencilMask(GLuint mask) { glStencilMask(mask); }
+    static void glStateLineWidth(GLfloat width) { glLineWidth(width); }
+    static void glStatePolygonMode(GLenum face, GLenum mode) { glPolygonMode(face, mode); }
+    static void glStateViewport(GLint x, GLint y, GLsizei width, GLsizei height) { glViewport(x, y, width, height); }
+    static void glStateClearColor(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha) {
+        glClearColor(red, green, blue, alpha);
+    }
+    static void glStateUseProgram(GLuint program) { glUseProgram(program); }
+    static void glStateActiveTexture(GLenum unit) { glActiveTexture(unit); }
+    static void glStateBindTexture(GLenum target, GLuint texture) { glBindTexture(target, texture); }
+    static void glStateBindBuffer(GLenum target, GLuint buffer) { glBindBuffer(target, buffer); }
+    static void glStateBindFramebuffer(GLenum target, GLuint framebuffer) { glBindFramebuffer(target, framebuffer); }
+    static void glStateGetIntegerv(GLenum name, GLint* values) { glGetIntegerv(name, values); }
+    static void glStateGetBooleanv(GLenum name, GLboolean* values) { glGetBooleanv(name, values); }
+    static void glStateGetFloatv(GLenum name, GLfloat* values) { glGetFloatv(name, values); }
+
+    GLStateFunctions GLStateFunctions::getDefault() {
+        GLStateFunctions functions;
+        functions.enable = glStateEnable;
+        functions.disable = glStateDisable;
+        functions.blendEquation = glStateBlendEquation;
+        functions.blendFuncSeparate = glStateBlendFuncSeparate;
+        functions.depthFunc = glStateDepthFunc;
+        functions.depthMask = glStateDepthMask;
+        functions.colorMask = glStateColorMask;
+        functions.cullFace = glStateCullFace;
+        functions.frontFace = glStateFrontFace;
+        functions.stencilFunc = glStateStencilFunc;
+        functions.stencilOp = glStateStencilOp;
+        functions.stencilMask = glStateStencilMask;
+        functions.lineWidth = glStateLineWidth;
+        functions.polygonMode = glStatePolygonMode;
+        functions.viewport = glStateViewport;
+        functions.clearColor = glStateClearColor;
+        functions.useProgram = glStateUseProgram;
+        functions.activeTexture = glStateActiveTexture;
+        functions.bindTexture = glStateBindTexture;
+        functions.bindBuffer = glStateBindBuffer;
+        functions.bindFramebuffer = glStateBindFramebuffer;
+        functions.getIntegerv = glStateGetIntegerv;
+        functions.getBooleanv = glStateGetBooleanv;
+        functions.getFloatv = glStateGetFloatv;
+        return functions;
+    }
+
+    GLStateCache::GLStateCache(): gl(GLStateFunctions::getDefault()) {
+        this->validationEnabled = false;
+        this->validationFailures = 0;
+    }
+
+    /*
+     * Replace the GL entry points. Nothing is known about the state behind the new functions, so the shadow
+     * state is invalidated.
+     */
+    void GLStateCache::setFunctions(const GLStateFunctions& functions) {
+        this->gl = functions;
+        this->invalidate();
+    }
+
+    const GLStateFunctions& GLStateCache::getFunctions() const {
+        return this->gl;
+    }
+
+    /*
+     * Forget the shadowed state, so that the next call to each setter reaches GL. This must be called whenever
+     * GL may have been changed behind the cache's back, e.g. by a host application sharing the context.
+     */
+    void GLStateCache::invalidate() {
+        for (UInt32 i = 0; i < (UInt32)Capability::_Count; i++) this->capabilities[i].known = false;
+        this->blendEquation.known = false;
+        this->blendFunction.known = false;
+        this->depthFunction.known = false;
+        this->depthMask.known = false;
+        this->colorMask.known = false;
+        this->cullFace.known = false;
+        this->frontFace.known = false;
+        this->stencilFunction.known = false;
+        this->stencilOperation.known = false;
+        this->stencilMask.known = false;
+        this->lineWidth.known = false;
+        this->polygonMode.known = false;
+        this->viewport.known = false;
+        this->clearColor.known = false;
+        this->program.known = false;
+        this->activeTextureUnit.known = false;
+        for (UInt32 u = 0; u < MaxTextureUnits; u++) {
+            for (UInt32 t = 0; t < (UInt32)TextureTarget::_Count; t++) this->textures[u][t].known = false;
+        }
+        for (UInt32 i = 0; i < (UInt32)BufferTarget::_Count; i++) this->buffers[i].known = false;
+        this->drawFramebuffer.known = false;
+        this->readFramebuffer.known = false;
+    }
+
+    /*
+     * Start counting the calls of a new frame. In validation mode the whole shadow state is checked against GL
+     * at the same time.
+     */
+    void GLStateCache::beginFrame() {
+        this->lastFrameCounters = this->frameCounters;
+        this->frameCounters = Counters();
+        if (this->validationEnabled) this->validate();
+    }
+
+    const GLStateCache::Counters& GLStateCache::getFrameCounters() const {
+        return this->frameCounters;
+    }
+
+    const GLStateCache::Counters& GLStateCache::getLastFrameCounters() const {
+        return this->lastFrameCounters;
+    }
+
+    /*
+     * In validation mode every filtered call, and the whole shadow state at the start of each frame, is checked
+     * against the state queried from GL. A mismatch is reported and the offending state is invalidated, so that
+     * the next call to its setter goes through. Querying GL stalls the pipeline, so this is a debugging aid only.
+     */
+    void GLStateCache::setValidationEnabled(Bool enabled) {
+        this->validationEnabled = enabled;
+    }
+
+    Bool GLStateCache::isValidationEnabled() const {
+        return this->validationEnabled;
+    }
+
+    UInt32 GLStateCache::getValidationFailureCount() const {
+        return this->validationFailures;
+    }
+
+    /*
+     * Check all known shadow state against GL. Returns false if any of it was out of date.
+     */
+    Bool GLStateCache::validate() {
+        UInt32 failures = this->validationFailures;
+        for (UInt32 i = 0; i < (UInt32)Capability::_Count; i++) this->validateCapability(i);
+        this->validateBlend();
+        this->validateDepth();
+        this->validateColorMask();
+        this->validateFaces();
+        this->validateStencil();
+        this->validateRasterization();
+        this->validateViewport();
+        this->validateClearColor();
+        this->validateProgram();
+        for (UInt32 u = 0; u < MaxTextureUnits; u++) this->validateTextureUnit(u);
+        this->validateBuffers();
+        this->validateFramebuffers();
+        return failures == this->validationFailures;
+    }
+
+    void GLStateCache::setCapability(GLenum capability, Bool enabled) {
+        Int32 index = getCapabilityIndex(capability);
+        GLboolean value = enabled ? GL_TRUE : GL_FALSE;
+        if (index >= 0 && this->filter(this->capabilities[index].matches(&value))) {
+            if (this->validationEnabled) this->validateCapability(index);
+            return;
+        }
+        if (index < 0) this->frameCounters.issued++;
+        if (enabled) this->gl.enable(capability);
+        else this->gl.disable(capability);
+        if (index >= 0) this->capabilities[index].set(&value);
+    }
+
+    void GLStateCache::setBlendEquation(GLenum equation) {
+        if (this->filter(this->blendEquation.matches(&equation))) {
+            if (this->validationEnabled) this->validateBlend();
+            return;
+        }
+        this->gl.blendEquation(equation);
+        this->blendEquation.set(&equation);
+    }
+
+    void GLStateCache::setBlendFunction(GLenum source, GLenum dest, GLenum sourceAlpha, GLenum destAlpha) {
+        GLenum values[] = {source, dest, sourceAlpha, destAlpha};
+        if (this->filter(this->blendFunction.matches(values))) {
+            if (this->validationEnabled) this->validateBlend();
+            return;
+        }
+        this->gl.blendFuncSeparate(source, dest, sourceAlpha, destAlpha);
+        this->blendFunction.set(values);
+    }
+
+    void GLStateCache::setDepthFunction(GLenum function) {
+        if (this->filter(this->depthFunction.matches(&function))) {
+            if (this->validationEnabled) this->validateDepth();
+            return;
+        }
+        this->gl.depthFunc(function);
+        this->depthFunction.set(&function);
+    }
+
+    void GLStateCache::setDepthMask(Bool enabled) {
+        GLboolean value = enabled ? GL_TRUE : GL_FALSE;
+        if (this->filter(this->depthMask.matches(&value))) {
+            if (this->validationEnabled) this->validateDepth();
+            return;
+        }
+        this->gl.depthMask(value);
+        this->depthMask.set(&value);
+    }
+
+    void GLStateCache::setColorMask(Bool red, Bool green, Bool blue, Bool alpha) {
+        GLboolean values[] = {red ? (GLboolean)GL_TRUE : (GLboolean)GL_FALSE, green ? (GLboolean)GL_TRUE : (GLboolean)GL_FALSE,
+                              blue ? (GLboolean)GL_TRUE : (GLboolean)GL_FALSE, alpha ? (GLboolean)GL_TRUE : (GLboolean)GL_FALSE};
+        if (this->filter(this->colorMask.matches(values))) {
+            if (this->validationEnabled) this->validateColorMask();
+            return;
+        }
+        this->gl.colorMask(values[0], values[1], values[2], values[3]);
+        this->colorMask.set(values);
+    }
+
+    void GLStateCache::setCullFace(GLenum face) {
+        if (this->filter(this->cullFace.matches(&face))) {
+            if (this->validationEnabled) this->validateFaces();
+            return;
+        }
+        this->gl.cullFace(face);
+        this->cullFace.set(&face);
+    }
+
+    void GLStateCache::setFrontFace(GLenum face) {
+        if (this->filter(this->frontFace.matches(&face))) {
+            if (this->validationEnabled) this->validateFaces();
+            return;
+        }
+        this->gl.frontFace(face);
+        this->frontFace.set(&face);
+    }
+
+    void GLStateCache::setStencilFunction(GLenum function, GLint reference, GLuint mask) {
+        GLuint values[] = {function, (GLuint)reference, mask};
+        if (this->filter(this->stencilFunction.matches(values))) {
+            if (this->validationEnabled) this->validateStencil();
+            return;
+        }
+        this->gl.stencilFunc(function, reference, mask);
+        this->stencilFunction.set(values);
+    }
+
+    void GLStateCache::setStencilOperation(GLenum sFail, GLenum dpFail, GLenum dpPass) {
+        GLenum values[] = {sFail, dpFail, dpPass};
+        if (this->filter(this->stencilOperation.matches(values))) {
+            if (this->validationEnabled) this->validateStencil();
+            return;
+        }
+        this->gl.stencilOp(sFail, dpFail, dpPass);
+        this->stencilOperation.set(values);
+    }
+
+    void GLStateCache::setStencilMask(GLuint mask) {
+        if (this->filter(this->stencilMask.matches(&mask))) {
+            if (this->validationEnabled) this->validateStencil();
+            return;
+        }
+        this->gl.stencilMask(mask);
+        this->stencilMask.set(&mask);
+    }
+
+    void GLStateCache::setLineWidth(GLfloat width) {
+        if (this->filter(this->lineWidth.matches(&width))) {
+            if (this->validationEnabled) this->validateRasterization();
+            return;
+        }
+        this->gl.lineWidth(width);
+        this->lineWidth.set(&width);
+    }
+
+    /*
+     * The front and back polygon modes are shadowed separately; a call for one face leaves the shadowed mode
+     * of the other face unchanged.
+     */
+    void GLStateCache::setPolygonMode(GLenum face, GLenum mode) {
+        GLenum values[] = {this->polygonMode.values[0], this->polygonMode.values[1]};
+        if (face == GL_FRONT || face == GL_FRONT_AND_BACK) values[0] = mode;
+        if (face == GL_BACK || face == GL_FRONT_AND_BACK) values[1] = mode;
+        if (this->filter(this->polygonMode.matches(values))) {
+            if (this->validationEnabled) this->validateRasterization();
+            return;
+        }
+        this->gl.polygonMode(face, mode);
+        if (this->polygonMode.known || face == GL_FRONT_AND_BACK) this->polygonMode.set(values);
+    }
+
+    void GLStateCache::setViewport(GLint x, GLint y, GLsizei width, GLsizei height) {
+        GLint values[] = {x, y, (GLint)width, (GLint)height};
+        if (this->filter(this->viewport.matches(values))) {
+            if (this->validationEnabled) this->validateViewport();
+            return;
+        }
+        this->gl.viewport(x, y, width, height);
+        this->viewport.set(values);
+    }
+
+    void GLStateCache::setClearColor(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha) {
+        GLfloat values[] = {red, green, blue, alpha};
+        if (this->filter(this->clearColor.matches(values))) {
+            if (this->validationEnabled) this->validateClearColor();
+            return;
+        }
+        this->gl.clearColor(red, green, blue, alpha);
+        this->clearColor.set(values);
+    }
+
+    void GLStateCache::useProgram(GLuint program) {
+        if (this->filter(this->program.matches(&program))) {
+            if (this->validationEnabled) this->validateProgram();
+            return;
+        }
+        this->gl.useProgram(program);
+        this->program.set(&program);
+    }
+
+    void GLStateCache::setActiveTextureUnit(UInt32 unit) {
+        if (this->filter(this->activeTextureUnit.matches(&unit))) {
+            if (this->validationEnabled) this->validateTextureUnit(unit);
+            return;
+        }
+        this->gl.activeTexture(GL_TEXTURE0 + unit);
+        this->activeTextureUnit.set(&unit);
+    }
+
+    /*
+     * Bind [texture] to [target] of the active texture unit. If the active unit isn't known the binding can't
+     * be attributed to a unit, so it always reaches GL and isn't shadowed.
+     */
+    void GLStateCache::bindTexture(GLenum target, GLuint texture) {
+        Int32 targetIndex = getTextureTargetIndex(target);
+        UInt32 unit = this->activeTextureUnit.values[0];
+        Bool cached = targetIndex >= 0 && this->activeTextureUnit.known && unit < MaxTextureUnits;
+        if (cached && this->filter(this->textures[unit][targetIndex].matches(&texture))) {
+            if (this->validationEnabled) this->validateTextureUnit(unit);
+            return;
+        }
+        if (!cached) this->frameCounters.issued++;
+        this->gl.bindTexture(target, texture);
+        if (cached) this->textures[unit][targetIndex].set(&texture);
+    }
+
+    /*
+     * Bind [texture] to [target] of texture unit [unit]. The active unit is only switched when the binding
+     * actually has to change.
+     */
+    void GLStateCache::bindTexture(UInt32 unit, GLenum target, GLuint texture) {
+        Int32 targetIndex = getTextureTargetIndex(target);
+        if (targetIndex >= 0 && unit < MaxTextureUnits && this->textures[unit][targetIndex].matches(&texture)) {
+            this->filter(true);
+            if (this->validationEnabled) this->validateTextureUnit(unit);
+            return;
+        }
+        this->setActiveTextureUnit(unit);
+        this->bindTexture(target, texture);
+    }
+
+    void GLStateCache::bindBuffer(GLenum target, GLuint buffer) {
+        Int32 index = getBufferTargetIndex(target);
+        if (index >= 0 && this->filter(this->buffers[index].matches(&buffer))) {
+            if (this->validationEnabled) this->validateBuffers();
+            return;
+        }
+        if (index < 0) this->frameCounters.issued++;
+        this->gl.bindBuffer(target, buffer);
+        if (index >= 0) this->buffers[index].set(&buffer);
+    }
+
+    /*
+     * GL_FRAMEBUFFER binds both the draw and the read framebuffer, so it's only redundant when both of them
+     * are already [framebuffer].
+     */
+    void GLStateCache::bindFramebuffer(GLenum target, GLuint framebuffer) {
+        Bool draw = target == GL_FRAMEBUFFER || target == GL_DRAW_FRAMEBUFFER;
+        Bool read = target == GL_FRAMEBUFFER || target == GL_READ_FRAMEBUFFER;
+        Bool redundant = (!draw || this->drawFramebuffer.matches(&framebuffer)) &&
+                         (!read || this->readFramebuffer.matches(&framebuffer));
+        if (this->filter(redundant)) {
+            if (this->validationEnabled) this->validateFramebuffers();
+            return;
+        }
+        this->gl.bindFramebuffer(target, framebuffer);
+        if (draw) this->drawFramebuffer.set(&framebuffer);
+        if (read) this->readFramebuffer.set(&framebuffer);
+    }
+
+    void GLStateCache::textureDeleted(GLuint texture) {
+        if (texture == 0) return;
+        GLuint none = 0;
+        for (UInt32 u = 0; u < MaxTextureUnits; u++) {
+            for (UInt32 t = 0; t < (UInt32)TextureTarget::_Count; t++) {
+                if (this->textures[u][t].matches(&texture)) this->textures[u][t].set(&none);
+            }
+        }
+    }
+
+    void GLStateCache::bufferDeleted(GLuint buffer) {
+        if (buffer == 0) return;
+        GLuint none = 0;
+        for (UInt32 i = 0; i < (UInt32)BufferTarget::_Count; i++) {
+            if (this->buffers[i].matches(&buffer)) this->buffers[i].set(&none);
+        }
+    }
+
+    void GLStateCache::framebufferDeleted(GLuint framebuffer) {
+        if (framebuffer == 0) return;
+        GLuint none = 0;
+        if (this->drawFramebuffer.matches(&framebuffer)) this->drawFramebuffer.set(&none);
+        if (this->readFramebuffer.matches(&framebuffer)) this->readFramebuffer.set(&none);
+    }
+
+    Int32 GLStateCache::getCapabilityIndex(GLenum capability) {
+        switch (capability) {
+            case GL_BLEND:
+                return (Int32)Capability::Blend;
+            case GL_DEPTH_TEST:
+                return (Int32)Capability::DepthTest;
+            case GL_CULL_FACE:
+                return (Int32)Capability::CullFace;
+            case GL_STENCIL_TEST:
+                return (Int32)Capability::StencilTest;
+            case GL_LINE_SMOOTH:
+                return (Int32)Capability::LineSmooth;
+            case GL_TEXTURE_CUBE_MAP_SEAMLESS:
+                return (Int32)Capability::CubeMapSeamless;
+            default:
+                break;
+        }
+        return -1;
+    }
+
+    GLenum GLStateCache::getCapabilityEnum(UInt32 index) {
+        static const GLenum capabilities[] = {GL_BLEND, GL_DEPTH_TEST, GL_CULL_FACE, GL_STENCIL_TEST, GL_LINE_SMOOTH,
+                                              GL_TEXTURE_CUBE_MAP_SEAMLESS};
+        return capabilities[index];
+    }
+
+    Int32 GLStateCache::getTextureTargetIndex(GLenum target) {
+        switch (target) {
+            case GL_TEXTURE_2D:
+                return (Int32)TextureTarget::Texture2D;
+            case GL_TEXTURE_CUBE_MAP:
+                return (Int32)TextureTarget::CubeMap;
+            case GL_TEXTURE_BUFFER:
+                return (Int32)TextureTarget::Buffer;
+            default:
+                break;
+        }
+        return -1;
+    }
+
+    GLenum GLStateCache::getTextureBindingEnum(UInt32 index) {
+        static const GLenum bindings[] = {GL_TEXTURE_BINDING_2D, GL_TEXTURE_BINDING_CUBE_MAP, GL_TEXTURE_BINDING_BUFFER};
+        return bindings[index];
+    }
+
+    Int32 GLStateCache::getBufferTargetIndex(GLenum target) {
+        switch (target) {
+            case GL_ARRAY_BUFFER:
+                return (Int32)BufferTarget::Array;
+            case GL_ELEMENT_ARRAY_BUFFER:
+                return (Int32)BufferTarget::ElementArray;
+            case GL_TEXTURE_BUFFER:
+                return (Int32)BufferTarget::Texture;
+            default:
+                break;
+        }
+        return -1;
+    }
+
+    GLenum GLStateCache::getBufferBindingEnum(UInt32 index) {
+        // the buffer bound to GL_TEXTURE_BUFFER is queried with the target itself
+        static const GLenum bindings[] = {GL_ARRAY_BUFFER_BINDING, GL_ELEMENT_ARRAY_BUFFER_BINDING, GL_TEXTURE_BUFFER};
+        return bindings[index];
+    }
+
+    /*
+     * Count a setter call as filtered if [redundant] or as issued otherwise, and return [redundant].
+     */
+    Bool GLStateCache::filter(Bool redundant) {
+        if (redundant) this->frameCounters.filtered++;
+        else this->frameCounters.issued++;
+        return redundant;
+    }
+
+    void GLStateCache::reportMismatch(const char* state) {
+        this->validationFailures++;
+        Debug::PrintError("GLStateCache -> Shadowed %s does not match the GL state.", state);
+    }
+
+    void GLStateCache::validateCapability(UInt32 index) {
+        Shadowed<GLboolean, 1>& capability = this->capabilities[index];
+        if (!capability.known) return;
+        GLboolean value = GL_FALSE;
+        this->gl.getBooleanv(getCapabilityEnum(index), &value);
+        if (!capability.matches(&value)) {
+            this->reportMismatch("capability");
+            capability.known = false;
+        }
+    }
+
+    void GLStateCache::validateBlend() {
+        if (this->blendEquation.known) {
+            GLint equation = 0;
+            this->gl.getIntegerv(GL_BLEND_EQUATION_RGB, &equation);
+            GLenum value = (GLenum)equation;
+            if (!this->blendEquation.matches(&value)) {
+                this->reportMismatch("blend equation");
+                this->blendEquation.known = false;
+            }
+        }
+        if (this->blendFunction.known) {
+            static const GLenum names[] = {GL_BLEND_SRC_RGB, GL_BLEND_DST_RGB, GL_BLEND_SRC_ALPHA, GL_BLEND_DST_ALPHA};
+            GLenum values[4];
+            for (UInt32 i = 0; i < 4; i++) {
+                GLint factor = 0;
+                this->gl.getIntegerv(names[i], &factor);
+                values[i] = (GLenum)factor;
+            }
+            if (!this->blendFunction.matches(values)) {
+                this->reportMismatch("blend function");
+                this->blendFunction.known = false;
+            }
+        }
+    }
+
+    void GLStateCache::validateDepth() {
+        if (this->depthFunction.known) {
+            GLint function = 0;
+            this->gl.getIntegerv(GL_DEPTH_FUNC, &function);
+            GLenum value = (GLenum)function;
+            if (!this->depthFunction.matches(&value)) {
+                this->reportMismatch("depth function");
+                this->depthFunction.known = false;
+            }
+        }
+        if (this->depthMask.known) {
+            GLboolean value = GL_FALSE;
+            this->gl.getBooleanv(GL_DEPTH_WRITEMASK, &value);
+            if (!this->depthMask.matches(&value)) {
+                this->reportMismatch("depth mask");
+                this->depthMask.known = false;
+            }
+        }
+    }
+
+    void GLStateCache::validateColorMask() {
+        if (!this->colorMask.known) return;
+        GLboolean values[4] = {GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE};
+        this->gl.getBooleanv(GL_COLOR_WRITEMASK, values);
+        if (!this->colorMask.matches(values)) {
+            this->reportMismatch("color mask");
+            this->colorMask.known = false;
+        }
+    }
+
+    void GLStateCache::validateFaces() {
+        if (this->cullFace.known) {
+            GLint face = 0;
+            this->gl.getIntegerv(GL_CULL_FACE_MODE, &face);
+            GLenum value = (GLenum)face;
+            if (!this->cullFace.matches(&value)) {
+                this->reportMismatch("cull face");
+                this->cullFace.known = false;
+            }
+        }
+        if (this->frontFace.known) {
+            GLint face = 0;
+            this->gl.getIntegerv(GL_FRONT_FACE, &face);
+            GLenum value = (GLenum)face;
+            if (!this->frontFace.matches(&value)) {
+                this->reportMismatch("front face");
+                this->frontFace.known = false;
+            }
+        }
+    }
+
+    void GLStateCache::validateStencil() {
+        if (this->stencilFunction.known) {
+            static const GLenum names[] = {GL_STENCIL_FUNC, GL_STENCIL_REF, GL_STENCIL_VALUE_MASK};
+            GLuint values[3];
+            for (UInt32 i = 0; i < 3; i++) {
+                GLint value = 0;
+                this->gl.getIntegerv(names[i], &value);
+                values[i] = (GLuint)value;
+            }
+            if (!this->stencilFunction.matches(values)) {
+                this->reportMismatch("stencil function");
+                this->stencilFunction.known = false;
+            }
+        }
+        if (this->stencilOperation.known) {
+            static const GLenum names[] = {GL_STENCIL_FAIL, GL_STENCIL_PASS_DEPTH_FAIL, GL_STENCIL_PASS_DEPTH_PASS};
+            GLenum values[3];
+            for (UInt32 i = 0; i < 3; i++) {
+                GLint value = 0;
+                this->gl.getIntegerv(names[i], &value);
+                values[i] = (GLenum)value;
+            }
+            if (!this->stencilOperation.matches(values)) {
+                this->reportMismatch("stencil operation");
+                this->stencilOperation.known = false;
+            }
+        }
+        if (this->stencilMask.known) {
+            GLint mask = 0;
+            this->gl.getIntegerv(GL_STENCIL_WRITEMASK, &mask);
+            GLuint value = (GLuint)mask;
+            if (!this->stencilMask.matches(&value)) {
+                this->reportMismatch("stencil mask");
+                this->stencilMask.known = false;
+            }
+        }
+    }
+
+    void GLStateCache::validateRasterization() {
+        if (this->lineWidth.known) {
+            GLfloat value = 0.0f;
+            this->gl.getFloatv(GL_LINE_WIDTH, &value);
+            if (!this->lineWidth.matches(&value)) {
+                this->reportMismatch("line width");
+                this->lineWidth.known = false;
+            }
+        }
+        if (this->polygonMode.known) {
+            GLint modes[2] = {0, 0};
+            this->gl.getIntegerv(GL_POLYGON_MODE, modes);
+            GLenum values[] = {(GLenum)modes[0], (GLenum)modes[1]};
+            if (!this->polygonMode.matches(values)) {
+                this->reportMismatch("polygon mode");
+                this->polygonMode.known = false;
+            }
+        }
+    }
+
+    void GLStateCache::validateViewport() {
+        if (!this->viewport.known) return;
+        GLint values[4] = {0, 0, 0, 0};
+        this->gl.getIntegerv(GL_VIEWPORT, values);
+        if (!this->viewport.matches(values)) {
+            this->reportMismatch("viewport");
+            this->viewport.known = false;
+        }
+    }
+
+    void GLStateCache::validateClearColor() {
+        if (!this->clearColor.known) return;
+        GLfloat values[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+        this->gl.getFloatv(GL_COLOR_CLEAR_VALUE, values);
+        if (!this->clearColor.matches(values)) {
+            this->reportMismatch("clear color");
+            this->clearColor.known = false;
+        }
+    }
+
+    void GLStateCache::validateProgram() {
+        if (!this->program.known) return;
+        GLint program = 0;
+        this->gl.getIntegerv(GL_CURRENT_PROGRAM, &program);
+        GLuint value = (GLuint)program;
+        if (!this->program.matches(&value)) {
+            this->reportMismatch("program");
+            this->program.known = false;
+        }
+    }
+
+    /*
+     * Texture bindings can only be queried for the active unit, so the active unit is switched to [unit] for
+     * the queries and switched back afterwards.
+     */
+    void GLStateCache::validateTextureUnit(UInt32 unit) {
+        GLint activeUnit = 0;
+        this->gl.getIntegerv(GL_ACTIVE_TEXTURE, &activeUnit);
+        UInt32 activeIndex = (UInt32)activeUnit - GL_TEXTURE0;
+        if (this->activeTextureUnit.known && !this->activeTextureUnit.matches(&activeIndex)) {
+            this->reportMismatch("active texture unit");
+            this->activeTextureUnit.known = false;
+        }
+        if (unit >= MaxTextureUnits) return;
+
+        Bool anyKnown = false;
+        for (UInt32 t = 0; t < (UInt32)TextureTarget::_Count; t++) anyKnown = anyKnown || this->textures[unit][t].known;
+        if (!anyKnown) return;
+
+        if (activeIndex != unit) this->gl.activeTexture(GL_TEXTURE0 + unit);
+        for (UInt32 t = 0; t < (UInt32)TextureTarget::_Count; t++) {
+            Shadowed<GLuint, 1>& binding = this->textures[unit][t];
+            if (!binding.known) continue;
+            GLint texture = 0;
+            this->gl.getIntegerv(getTextureBindingEnum(t), &texture);
+            GLuint value = (GLuint)texture;
+            if (!binding.matches(&value)) {
+                this->reportMismatch("texture binding");
+                binding.known = false;
+            }
+        }
+        if (activeIndex != unit) this->gl.activeTexture((GLenum)activeUnit);
+    }
+
+    void GLStateCache::validateBuffers() {
+        for (UInt32 i = 0; i < (UInt32)BufferTarget::_Count; i++) {
+            Shadowed<GLuint, 1>& binding = this->buffers[i];
+            if (!binding.known) continue;
+            GLint buffer = 0;
+            this->gl.getIntegerv(getBufferBindingEnum(i), &buffer);
+            GLuint value = (GLuint)buffer;
+            if (!binding.matches(&value)) {
+                this->reportMismatch("buffer binding");
+                binding.known = false;
+            }
+        }
+    }
+
+    void GLStateCache::validateFramebuffers() {
+        if (this->drawFramebuffer.known) {
+            GLint framebuffer = 0;
+            this->gl.getIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &framebuffer);
+            GLuint value = (GLuint)framebuffer;
+            if (!this->drawFramebuffer.matches(&value)) {
+                this->reportMismatch("draw framebuffer");
+                this->drawFramebuffer.known = false;
+            }
+        }
+        if (this->readFramebuffer.known) {
+            GLint framebuffer = 0;
+            this->gl.getIntegerv(GL_READ_FRAMEBUFFER_BINDING, &framebuffer);
+            GLuint value = (GLuint)framebuffer;
+            if (!this->readFramebuffer.matches(&value)) {
+                this->reportMismatch("read framebuffer");
+                this->readFramebuffer.known = false;
+            }
+        }
+    }
+}
@@ -0,0 +1,198 @@
+#pragma once
+
+#include "../common/gl.h"
+#include "../common/types.h"
+
+namespace Core {
+
+    // The GL entry points through which the state cache reaches the driver. The default table calls straight
+    // into GL; another table can be installed to trace or mock the calls the cache lets through.
+    struct GLStateFunctions {
+        void (*enable)(GLenum capability);
+        void (*disable)(GLenum capability);
+        void (*blendEquation)(GLenum equation);
+        void (*blendFuncSeparate)(GLenum source, GLenum dest, GLenum sourceAlpha, GLenum destAlpha);
+        void (*depthFunc)(GLenum function);
+        void (*depthMask)(GLboolean enabled);
+        void (*colorMask)(GLboolean red, GLboolean green, GLboolean blue, GLboolean alpha);
+        void (*cullFace)(GLenum face);
+        void (*frontFace)(GLenum face);
+        void (*stencilFunc)(GLenum function, GLint reference, GLuint mask);
+        void (*stencilOp)(GLenum sFail, GLenum dpFail, GLenum dpPass);
+        void (*stencilMask)(GLuint mask);
+        void (*lineWidth)(GLfloat width);
+        void (*polygonMode)(GLenum face, GLenum mode);
+        void (*viewport)(GLint x, GLint y, GLsizei width, GLsizei height);
+        void (*clearColor)(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha);
+        void (*useProgram)(GLuint program);
+        void (*activeTexture)(GLenum unit);
+        void (*bindTexture)(GLenum target, GLuint texture);
+        void (*bindBuffer)(GLenum target, GLuint buffer);
+        void (*bindFramebuffer)(GLenum target, GLuint framebuffer);
+        void (*getIntegerv)(GLenum name, GLint* values);
+        void (*getBooleanv)(GLenum name, GLboolean* values);
+        void (*getFloatv)(GLenum name, GLfloat* values);
+
+        static GLStateFunctions getDefault();
+    };
+
+    // Shadow copy of the GL state that the engine changes. A setter only reaches GL when the requested value
+    // differs from the shadowed one, or when the shadowed value is unknown (after invalidate(), or for state
+    // the cache has never set). The GL objects that bind textures, buffers and framebuffers go through the
+    // same cache, so they must report deletions: GL reverts the bindings of a deleted object to zero, and the
+    // driver is free to hand its name out again.
+    class GLStateCache final {
+    public:
+        static const UInt32 MaxTextureUnits = 32;
+
+        class Counters {
+        public:
+            Counters(): issued(0), filtered(0) {}
+            // calls that reached GL
+            UInt32 issued;
+            // calls dropped because they would not have changed the state
+            UInt32 filtered;
+        };
+
+        GLStateCache();
+
+        void setFunctions(const GLStateFunctions& functions);
+        const GLStateFunctions& getFunctions() const;
+        void invalidate();
+        void beginFrame();
+        const Counters& getFrameCounters() const;
+        const Counters& getLastFrameCounters() const;
+
+        void setValidationEnabled(Bool enabled);
+        Bool isValidationEnabled() const;
+        UInt32 getValidationFailureCount() const;
+        Bool validate();
+
+        void setCapability(GLenum capability, Bool enabled);
+        void setBlendEquation(GLenum equation);
+        void setBlendFunction(GLenum source, GLenum dest, GLenum sourceAlpha, GLenum destAlpha);
+        void setDepthFunction(GLenum function);
+        void setDepthMask(Bool enabled);
+        void setColorMask(Bool red, Bool green, Bool blue, Bool alpha);
+        void setCullFace(GLenum face);
+        void setFrontFace(GLenum face);
+        void setStencilFunction(GLenum function, GLint reference, GLuint mask);
+        void setStencilOperation(GLenum sFail, GLenum dpFail, GLenum dpPass);
+        void setStencilMask(GLuint mask);
+        void setLineWidth(GLfloat width);
+        void setPolygonMode(GLenum face, GLenum mode);
+        void setViewport(GLint x, GLint y, GLsizei width, GLsizei height);
+        void setClearColor(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha);
+        void useProgram(GLuint program);
+        void setActiveTextureUnit(UInt32 unit);
+        void bindTexture(GLenum target, GLuint texture);
+        void bindTexture(UInt32 unit, GLenum target, GLuint texture);
+        void bindBuffer(GLenum target, GLuint buffer);
+        void bindFramebuffer(GLenum target, GLuint framebuffer);
+
+        void textureDeleted(GLuint texture);
+        void bufferDeleted(GLuint buffer);
+        void framebufferDeleted(GLuint framebuffer);
+
+    private:
+        enum class Capability {
+            Blend = 0,
+            DepthTest = 1,
+            CullFace = 2,
+            StencilTest = 3,
+            LineSmooth = 4,
+            CubeMapSeamless = 5,
+            _Count = 6
+        };
+
+        enum class TextureTarget {
+            Texture2D = 0,
+            CubeMap = 1,
+            Buffer = 2,
+            _Count = 3
+        };
+
+        enum class BufferTarget {
+            Array = 0,
+            ElementArray = 1,
+            Texture = 2,
+            _Count = 3
+        };
+
+        template <typename T, UInt32 N>
+        class Shadowed {
+        public:
+            Shadowed(): known(false) {
+                for (UInt32 i = 0; i < N; i++) this->values[i] = T();
+            }
+
+            Bool matches(const T* values) const {
+                if (!this->known) return false;
+                for (UInt32 i = 0; i < N; i++) {
+                    if (this->values[i] != values[i]) return false;
+                }
+                return true;
+            }
+
+            void set(const T* values) {
+                for (UInt32 i = 0; i < N; i++) this->values[i] = values[i];
+                this->known = true;
+            }
+
+            T values[N];
+            Bool known;
+        };
+
+        static Int32 getCapabilityIndex(GLenum capability);
+        static GLenum getCapabilityEnum(UInt32 index);
+        static Int32 getTextureTargetIndex(GLenum target);
+        static GLenum getTextureBindingEnum(UInt32 index);
+        static Int32 getBufferTargetIndex(GLenum target);
+        static GLenum getBufferBindingEnum(UInt32 index);
+
+        Bool filter(Bool redundant);
+        void reportMismatch(const char* state);
+        void validateCapability(UInt32 index);
+        void validateBlend();
+        void validateDepth();
+        void validateColorMask();
+        void validateFaces();
+        void validateStencil();
+        void validateRasterization();
+        void validateViewport();
+        void validateClearColor();
+        void validateProgram();
+        void validateTextureUnit(UInt32 unit);
+        void validateBuffers();
+        void validateFramebuffers();
+
+        GLStateFunctions gl;
+        Counters frameCounters;
+        Counters lastFrameCounters;
+        Bool validationEnabled;
+        UInt32 validationFailures;
+
+        Shadowed<GLboolean, 1> capabilities[(UInt32)Capability::_Count];
+        Shadowed<GLenum, 1> blendEquation;
+        Shadowed<GLenum, 4> blendFunction;
+        Shadowed<GLenum, 1> depthFunction;
+        Shadowed<GLboolean, 1> depthMask;
+        Shadowed<GLboolean, 4> colorMask;
+        Shadowed<GLenum, 1> cullFace;
+        Shadowed<GLenum, 1> frontFace;
+        Shadowed<GLuint, 3> stencilFunction;
+        Shadowed<GLenum, 3> stencilOperation;
+        Shadowed<GLuint, 1> stencilMask;
+        Shadowed<GLfloat, 1> lineWidth;
+        // front and back
+        Shadowed<GLenum, 2> polygonMode;
+        Shadowed<GLint, 4> viewport;
+        Shadowed<GLfloat, 4> clearColor;
+        Shadowed<GLuint, 1> program;
+        Shadowed<UInt32, 1> activeTextureUnit;
+        Shadowed<GLuint, 1> textures[MaxTextureUnits][(UInt32)TextureTarget::_Count];
+        Shadowed<GLuint, 1> buffers[(UInt32)BufferTarget::_Count];
+        Shadowed<GLuint, 1> drawFramebuffer;
+        Shadowed<GLuint, 1> readFramebuffer;
+    };
+}
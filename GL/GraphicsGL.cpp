@@ -1,10 +1,15 @@
 #include <algorithm>
+#include <string.h>
+#include <string>
+#include <vector>
 
 #include "../common/Exception.h"
+#include "../Engine.h"
 #include "GraphicsGL.h"
 #include "AttributeArrayGPUStorageGL.h"
 #include "CubeTextureGL.h"
 #include "IndexBufferGL.h"
+#include "MatrixBufferGL.h"
 #include "RendererGL.h"
 #include "ShaderGL.h"
 #include "Texture2DGL.h"
@@ -18,6 +23,56 @@ namespace Core {
         Debug::PrintMessage("GL %s: %s\n", name, v);
     }
 
+    /*
+     * Extract the version number from a GL_VERSION string, which is "<major>.<minor>..." for desktop GL
+     * and "OpenGL ES <major>.<minor>..." for GLES.
+     */
+    static void parseGLVersion(const char* versionStr, UInt32& major, UInt32& minor, Bool& embedded) {
+        major = minor = 0;
+        embedded = false;
+        if (versionStr == nullptr) return;
+        const char* esPrefix = "OpenGL ES";
+        if (strncmp(versionStr, esPrefix, strlen(esPrefix)) == 0) {
+            embedded = true;
+            versionStr += strlen(esPrefix);
+        }
+        while (*versionStr != '\0' && (*versionStr < '0' || *versionStr > '9')) versionStr++;
+        while (*versionStr >= '0' && *versionStr <= '9') major = major * 10 + (UInt32)(*versionStr++ - '0');
+        if (*versionStr == '.') versionStr++;
+        while (*versionStr >= '0' && *versionStr <= '9') minor = minor * 10 + (UInt32)(*versionStr++ - '0');
+    }
+
+    /*
+     * The names of the extensions the context supports. From GL 3.0 and GLES 3.0 they are listed one at a time
+     * with glGetStringi(): core profiles no longer return the space separated GL_EXTENSIONS string at all.
+     */
+    static std::vector<std::string> getGLExtensions(Bool indexed) {
+        std::vector<std::string> extensions;
+        if (indexed) {
+            GLint extensionCount = 0;
+            glGetIntegerv(GL_NUM_EXTENSIONS, &extensionCount);
+            for (GLint i = 0; i < extensionCount; i++) {
+                const char* extension = (const char*)glGetStringi(GL_EXTENSIONS, (GLuint)i);
+                if (extension != nullptr) extensions.push_back(extension);
+            }
+            return extensions;
+        }
+
+        const char* extensionsStr = (const char*)glGetString(GL_EXTENSIONS);
+        if (extensionsStr == nullptr) return extensions;
+        for (const char* start = extensionsStr; *start != '\0';) {
+            const char* end = strchr(start, ' ');
+            if (end == nullptr) end = start + strlen(start);
+            if (end > start) extensions.push_back(std::string(start, end - start));
+            start = *end == ' ' ? end + 1 : end;
+        }
+        return extensions;
+    }
+
+    static Bool hasGLExtension(const std::vector<std::string>& extensions, const char* extension) {
+        return std::find(extensions.begin(), extensions.end(), extension) != extensions.end();
+    }
+
     GraphicsGL::GraphicsGL(GLVersion version) : glVersion(version) {
         this->renderStyle = RenderStyle::Fill;
     }
@@ -31,29 +86,57 @@ namespace Core {
         printGlString("Version", GL_VERSION);
         printGlString("Vendor", GL_VENDOR);
         printGlString("Renderer", GL_RENDERER);
-        printGlString("Extensions", GL_EXTENSIONS);
 
-        UInt32 maxGL = 0;
-        UNUSED(maxGL);
         const char* versionStr = (const char*)glGetString(GL_VERSION);
-        UNUSED(versionStr);
+        UInt32 major = 0, minor = 0;
+        Bool embedded = false;
+        parseGLVersion(versionStr, major, minor, embedded);
+        UInt32 version = major * 10 + minor;
+        std::vector<std::string> extensions = getGLExtensions(major >= 3);
+        Debug::PrintMessage("GL Extensions: %u\n", (UInt32)extensions.size());
+        // geometry shaders are core in GL 3.2 and GLES 3.2, attribute divisors in GL 3.3 and GLES 3.0
+        this->geometryShadersSupported = version >= 32;
+        this->instancingSupported = embedded ? version >= 30 : version >= 33 || hasGLExtension(extensions, "GL_ARB_instanced_arrays");
+        // lets the driver compile and link on its own threads; completion is then polled with GL_COMPLETION_STATUS_KHR
+        if (hasGLExtension(extensions, "GL_KHR_parallel_shader_compile")) {
+            glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);
+            this->parallelShaderCompileSupported = true;
+        } else if (hasGLExtension(extensions, "GL_ARB_parallel_shader_compile")) {
+            glMaxShaderCompilerThreadsARB(0xFFFFFFFF);
+            this->parallelShaderCompileSupported = true;
+        }
         this->defaultRenderTarget = this->createDefaultRenderTarget();
         this->currentRenderTarget = this->defaultRenderTarget;
         this->shaderDirectory.init();
+        const std::string& preprocessedShaderPath = Engine::getPreprocessedShaderPath();
+        if (preprocessedShaderPath.size() > 0 && !this->shaderDirectory.loadPreprocessedSources(preprocessedShaderPath)) {
+            Debug::PrintMessage("Preprocessed shaders in %s are missing or out of date; expanding shader sources at runtime.",
+                                preprocessedShaderPath.c_str());
+        }
+        GLProgramBinaryCache& programBinaryCache = getProgramBinaryCache();
+        programBinaryCache.setDirectory(Engine::getShaderCacheDirectory());
+        programBinaryCache.init();
 
         this->renderer = this->createRenderer();
         if (!this->sharedRenderState) {
             this->setupRenderState();
         }
         
-        glEnable(GL_TEXTURE_CUBE_MAP_SEAMLESS);
+        getStateCache().setCapability(GL_TEXTURE_CUBE_MAP_SEAMLESS, true);
     }
 
     WeakPointer<Renderer> GraphicsGL::getRenderer() {
         return std::static_pointer_cast<Renderer>(this->renderer);
     }
 
+    /*
+     * The state cache starts every frame knowing nothing: GL may have been changed by whoever else uses the
+     * context (the host application when the render state is shared) since the last frame.
+     */
     void GraphicsGL::preRender() {
+        GLStateCache& stateCache = getStateCache();
+        stateCache.invalidate();
+        stateCache.beginFrame();
         if (!this->sharedRenderState) {
             this->saveState();
             this->setupRenderState();
@@ -61,6 +144,10 @@ namespace Core {
     }
 
     void GraphicsGL::postRender() {
+        // leave no engine buffers bound for whoever uses the context next
+        GLStateCache& stateCache = getStateCache();
+        stateCache.bindBuffer(GL_ARRAY_BUFFER, 0);
+        stateCache.bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
         if (!this->sharedRenderState) {
             this->restoreState();
         }
@@ -117,13 +204,8 @@ namespace Core {
     }
 
     void GraphicsGL::activateShader(WeakPointer<Shader> shader) {
-        UInt64 newShaderID = shader->getObjectID();
-        Bool newShader = lastActivatedShaderID != newShaderID;
-        Bool shouldActivate = newShader || !hasAnyShaderBeenActivated;
         Graphics::activateShader(shader);
-        if (shouldActivate) {
-            glUseProgram(shader->getProgram());
-        }
+        getStateCache().useProgram(shader->getProgram());
     }
 
     std::shared_ptr<AttributeArrayGPUStorage> GraphicsGL::createGPUStorage(UInt32 size, UInt32 componentCount, AttributeType type, Bool normalize) {
@@ -146,18 +228,34 @@ namespace Core {
         return spIndexBuffer;
     }
 
+    std::shared_ptr<MatrixBuffer> GraphicsGL::createMatrixBuffer(UInt32 capacity) {
+        MatrixBufferGL* matrixBufferPtr = new (std::nothrow) MatrixBufferGL(capacity);
+        if (matrixBufferPtr == nullptr) {
+            throw AllocationException("GraphicsGL::createMatrixBuffer() -> Unable to allocate matrix buffer.");
+        }
+        std::shared_ptr<MatrixBufferGL> spMatrixBuffer(matrixBufferPtr);
+        return spMatrixBuffer;
+    }
+
     void GraphicsGL::drawBoundVertexBuffer(UInt32 vertexCount, PrimitiveType primitiveType) {
         GLenum glPrimitiveType = getGLPrimitiveType(primitiveType);
-        glPolygonMode(GL_FRONT_AND_BACK, getGLRenderStyle(this->renderStyle));
+        getStateCache().setPolygonMode(GL_FRONT_AND_BACK, getGLRenderStyle(this->renderStyle));
         glDrawArrays(glPrimitiveType, 0, vertexCount);
     }
 
     void GraphicsGL::drawBoundVertexBuffer(UInt32 vertexCount, WeakPointer<IndexBuffer> indices, PrimitiveType primitiveType) {
         GLenum glPrimitiveType = getGLPrimitiveType(primitiveType);
-        glPolygonMode(GL_FRONT_AND_BACK, getGLRenderStyle(this->renderStyle));
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indices->getBufferID());
+        GLStateCache& stateCache = getStateCache();
+        stateCache.setPolygonMode(GL_FRONT_AND_BACK, getGLRenderStyle(this->renderStyle));
+        // the binding is left in place, so consecutive draws from the same index buffer don't rebind it
+        stateCache.bindBuffer(GL_ELEMENT_ARRAY_BUFFER, indices->getBufferID());
         glDrawElements(glPrimitiveType, vertexCount, GL_UNSIGNED_INT, (void*)(0));
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    }
+
+    void GraphicsGL::drawBoundVertexBufferInstanced(UInt32 vertexCount, UInt32 instanceCount, PrimitiveType primitiveType) {
+        GLenum glPrimitiveType = getGLPrimitiveType(primitiveType);
+        getStateCache().setPolygonMode(GL_FRONT_AND_BACK, getGLRenderStyle(this->renderStyle));
+        glDrawArraysInstanced(glPrimitiveType, 0, vertexCount, instanceCount);
     }
 
     ShaderManager& GraphicsGL::getShaderManager() {
@@ -165,22 +263,22 @@ namespace Core {
     }
 
     void GraphicsGL::setBlendingEnabled(Bool enabled) {
-        if (enabled) glEnable(GL_BLEND);
-        else glDisable(GL_BLEND);
+        getStateCache().setCapability(GL_BLEND, enabled);
     }
 
     void GraphicsGL::setBlendingEquation(RenderState::BlendingEquation equation) {
-        glBlendEquation(getGLBlendingEquation(equation));
+        getStateCache().setBlendEquation(getGLBlendingEquation(equation));
     }
 
     void GraphicsGL::setBlendingFactors(RenderState::BlendingFactor source, RenderState::BlendingFactor dest) {
-        glBlendFunc(getGLBlendingFactor(source), getGLBlendingFactor(dest));
+        getStateCache().setBlendFunction(getGLBlendingFactor(source), getGLBlendingFactor(dest),
+                                         getGLBlendingFactor(source), getGLBlendingFactor(dest));
     }
 
     void GraphicsGL::setBlendingFactors(RenderState::BlendingFactor source, RenderState::BlendingFactor sourceAlpha,
                                         RenderState::BlendingFactor dest, RenderState::BlendingFactor destAlpha) {
-        glBlendFuncSeparate(getGLBlendingFactor(source), getGLBlendingFactor(dest),
-                            getGLBlendingFactor(sourceAlpha), getGLBlendingFactor(destAlpha));
+        getStateCache().setBlendFunction(getGLBlendingFactor(source), getGLBlendingFactor(dest),
+                                         getGLBlendingFactor(sourceAlpha), getGLBlendingFactor(destAlpha));
     }
 
     WeakPointer<RenderTarget2D> GraphicsGL::createRenderTarget2D(Bool hasColor, Bool hasDepth, Bool enableStencilBuffer,
@@ -219,16 +317,11 @@ namespace Core {
     }
 
     void GraphicsGL::setColorWriteEnabled(Bool enabled) {
-        if (enabled) {
-            glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
-        }
-        else {
-            glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
-        }
+        getStateCache().setColorMask(enabled, enabled, enabled, enabled);
     }
 
     void GraphicsGL::setClearColor(Color color) {
-        glClearColor(color.r, color.g, color.b, color.a);
+        getStateCache().setClearColor(color.r, color.g, color.b, color.a);
     }
 
     void GraphicsGL::clearActiveRenderTarget(Bool colorBuffer, Bool depthBuffer, Bool stencilBuffer) {
@@ -237,9 +330,10 @@ namespace Core {
         if (depthBuffer) mask |= GL_DEPTH_BUFFER_BIT;
         if (stencilBuffer) mask |= GL_STENCIL_BUFFER_BIT;
 
-        if (colorBuffer) glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
-        if (depthBuffer) glDepthMask(GL_TRUE);
-        if (stencilBuffer) glStencilMask(0xFF);
+        GLStateCache& stateCache = getStateCache();
+        if (colorBuffer) stateCache.setColorMask(true, true, true, true);
+        if (depthBuffer) stateCache.setDepthMask(true);
+        if (stencilBuffer) stateCache.setStencilMask(0xFF);
 
         glClear(mask);
     }
@@ -281,7 +375,7 @@ namespace Core {
             if (currentRenderTargetGL != nullptr && currentRenderTargetGL->getFBOID() == renderTargetGL->getFBOID())return true;
         }
 
-        glBindFramebuffer(GL_FRAMEBUFFER, renderTargetGL->getFBOID());
+        getStateCache().bindFramebuffer(GL_FRAMEBUFFER, renderTargetGL->getFBOID());
         this->currentRenderTarget = target;
 
         return true;
@@ -349,7 +443,7 @@ namespace Core {
     }
 
     void GraphicsGL::setViewport(UInt32 hOffset, UInt32 vOffset, UInt32 viewPortWidth, UInt32 viewPortHeight) {
-        glViewport(hOffset, vOffset, viewPortWidth, viewPortHeight);
+        getStateCache().setViewport(hOffset, vOffset, viewPortWidth, viewPortHeight);
         this->_viewport.set(hOffset, vOffset, viewPortWidth, viewPortHeight);
     }
 
@@ -358,66 +452,50 @@ namespace Core {
     }
 
     void GraphicsGL::setDepthWriteEnabled(Bool enabled) {
-        if (enabled) {
-            glDepthMask(GL_TRUE);
-        }
-        else {
-            glDepthMask(GL_FALSE);
-        }
+        getStateCache().setDepthMask(enabled);
     }
 
     void GraphicsGL::setDepthTestEnabled(Bool enabled) {
-        if (enabled) glEnable(GL_DEPTH_TEST);
-        else glDisable (GL_DEPTH_TEST);
+        getStateCache().setCapability(GL_DEPTH_TEST, enabled);
     }
 
     void GraphicsGL::setDepthFunction(RenderState::DepthFunction function) {
-        glDepthFunc(getGLDepthFunction(function));
+        getStateCache().setDepthFunction(getGLDepthFunction(function));
     }
 
     void GraphicsGL::setStencilTestEnabled(Bool enabled) {
-        if (enabled) {
-            glEnable(GL_STENCIL_TEST);
-        }
-        else {
-            glDisable(GL_STENCIL_TEST);
-        }
+        getStateCache().setCapability(GL_STENCIL_TEST, enabled);
     }
 
     void GraphicsGL::setStencilWriteMask(UInt32 mask) {
-        glStencilMask((GLuint)mask);
+        getStateCache().setStencilMask((GLuint)mask);
     }
 
     void GraphicsGL::setStencilFunction(RenderState::StencilFunction function, Int16 value, UInt16 mask) {
-        glStencilFunc(getGLStencilFunction(function), (GLint)value, (GLuint)mask);
+        getStateCache().setStencilFunction(getGLStencilFunction(function), (GLint)value, (GLuint)mask);
     }
 
     void GraphicsGL::setStencilOperation(RenderState::StencilAction sFail, RenderState::StencilAction dpFail, RenderState::StencilAction dpPass) {
-        glStencilOp(getGLStencilAction(sFail), getGLStencilAction(dpFail), getGLStencilAction(dpPass));
+        getStateCache().setStencilOperation(getGLStencilAction(sFail), getGLStencilAction(dpFail), getGLStencilAction(dpPass));
     }
 
     void GraphicsGL::setFaceCullingEnabled(Bool enabled) {
-        if (enabled) {
-            glEnable(GL_CULL_FACE);
-        }
-        else {
-            glDisable(GL_CULL_FACE);
-        }
+        getStateCache().setCapability(GL_CULL_FACE, enabled);
     }
 
     void GraphicsGL::setCullFace(RenderState::CullFace face) {
         switch(face) {
             case RenderState::CullFace::Front:
-                glCullFace(GL_FRONT);
+                getStateCache().setCullFace(GL_FRONT);
             break;
             case RenderState::CullFace::Back:
-                glCullFace(GL_BACK);
+                getStateCache().setCullFace(GL_BACK);
             break;
         }
     }
 
     void GraphicsGL::setRenderLineSize(Real size) {
-        glLineWidth(size);
+        getStateCache().setLineWidth(size);
     }
 
     void GraphicsGL::saveState() {
@@ -434,21 +512,36 @@ namespace Core {
     }
 
     void GraphicsGL::restoreState() {
-        glFrontFace(this->_stateFrontFace);
-        glCullFace(this->_stateCullFaceMode);
-        if (this->_stateCullFaceEnabled) glEnable(GL_CULL_FACE);
-        else glDisable(GL_CULL_FACE);
-        if (this->_stateDepthTestEnabled) glEnable(GL_DEPTH_TEST);
-        else glDisable(GL_DEPTH_TEST);
-        glDepthMask(this->_stateDepthMask);
-        glDepthFunc(this->_stateDepthFunc);
-        if (this->_stateBlendEnabled) glEnable(GL_BLEND);
-        else glDisable(GL_BLEND);
-        if (this->_stateLineSmoothEnabled) glEnable(GL_LINE_SMOOTH);
-        else glDisable(GL_LINE_SMOOTH);
-        glLineWidth(this->_stateLineWidth);
-        glPolygonMode(GL_FRONT, this->_statePolygonMode[0]);
-        glPolygonMode(GL_BACK, this->_statePolygonMode[1]);
+        GLStateCache& stateCache = getStateCache();
+        stateCache.setFrontFace(this->_stateFrontFace);
+        stateCache.setCullFace(this->_stateCullFaceMode);
+        stateCache.setCapability(GL_CULL_FACE, this->_stateCullFaceEnabled == GL_TRUE);
+        stateCache.setCapability(GL_DEPTH_TEST, this->_stateDepthTestEnabled == GL_TRUE);
+        stateCache.setDepthMask(this->_stateDepthMask == GL_TRUE);
+        stateCache.setDepthFunction(this->_stateDepthFunc);
+        stateCache.setCapability(GL_BLEND, this->_stateBlendEnabled == GL_TRUE);
+        stateCache.setCapability(GL_LINE_SMOOTH, this->_stateLineSmoothEnabled == GL_TRUE);
+        stateCache.setLineWidth(this->_stateLineWidth);
+        stateCache.setPolygonMode(GL_FRONT, this->_statePolygonMode[0]);
+        stateCache.setPolygonMode(GL_BACK, this->_statePolygonMode[1]);
+    }
+
+    /*
+     * The GL state shadowed for the engine. There is one GL context, so the cache is shared by the GL objects
+     * (shaders, textures, buffers and render targets), which bind through it as well.
+     */
+    GLStateCache& GraphicsGL::getStateCache() {
+        static GLStateCache stateCache;
+        return stateCache;
+    }
+
+    /*
+     * Linked program binaries saved by earlier runs, shared by all shaders for the same reason as the
+     * state cache.
+     */
+    GLProgramBinaryCache& GraphicsGL::getProgramBinaryCache() {
+        static GLProgramBinaryCache programBinaryCache;
+        return programBinaryCache;
     }
 
     void GraphicsGL::lowLevelBlit(WeakPointer<RenderTarget> source, WeakPointer<RenderTarget> destination, Int16 cubeFace, Bool includeColor, Bool includeDepth) {
@@ -457,8 +550,9 @@ namespace Core {
         Vector2u srcSize = source->getSize();
         Vector2u destSize = destination->getSize();
 
-        glBindFramebuffer(GL_READ_FRAMEBUFFER, srcID);
-        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, destID);
+        GLStateCache& stateCache = getStateCache();
+        stateCache.bindFramebuffer(GL_READ_FRAMEBUFFER, srcID);
+        stateCache.bindFramebuffer(GL_DRAW_FRAMEBUFFER, destID);
         if (includeColor && cubeFace >= 0) {
             glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, getGLCubeTarget((CubeTextureSide)cubeFace), destination->getColorTexture()->getTextureID(), 0);
 
@@ -578,6 +672,14 @@ namespace Core {
                 return GL_UNSIGNED_INT;
             case AttributeType::Int:
                 return GL_INT;
+            case AttributeType::UnsignedByte:
+                return GL_UNSIGNED_BYTE;
+            case AttributeType::UnsignedShort:
+                return GL_UNSIGNED_SHORT;
+            case AttributeType::HalfFloat:
+                return GL_HALF_FLOAT;
+            case AttributeType::Int2_10_10_10:
+                return GL_INT_2_10_10_10_REV;
             default:
                 break;
         }
@@ -796,16 +898,17 @@ namespace Core {
 
     void GraphicsGL::setupRenderState() {
         // TODO: Move these state calls to a place where they are not called every frame
-        glFrontFace(GL_CW);
-        glCullFace(GL_BACK);
-        glEnable(GL_CULL_FACE);
-        glEnable(GL_DEPTH_TEST);
-        glDepthMask(GL_TRUE);
-        glDepthFunc(GL_LEQUAL);
-        glDisable(GL_BLEND);
-
-        glLineWidth(1.5);
-        glEnable(GL_LINE_SMOOTH);
+        GLStateCache& stateCache = getStateCache();
+        stateCache.setFrontFace(GL_CW);
+        stateCache.setCullFace(GL_BACK);
+        stateCache.setCapability(GL_CULL_FACE, true);
+        stateCache.setCapability(GL_DEPTH_TEST, true);
+        stateCache.setDepthMask(true);
+        stateCache.setDepthFunction(GL_LEQUAL);
+        stateCache.setCapability(GL_BLEND, false);
+
+        stateCache.setLineWidth(1.5);
+        stateCache.setCapability(GL_LINE_SMOOTH, true);
         glHint(GL_LINE_SMOOTH_HINT, GL_NICEST);
     }
 }
\ No newline at end of file
@@ -9,6 +9,8 @@
 #include "../common/gl.h"
 #include "../geometry/AttributeType.h"
 #include "AttributeArrayGPUStorageGL.h"
+#include "GLProgramBinaryCache.h"
+#include "GLStateCache.h"
 #include "IndexBufferGL.h"
 #include "ShaderManagerGL.h"
 
@@ -53,6 +55,7 @@ namespace Core {
 
         void drawBoundVertexBuffer(UInt32 vertexCount, PrimitiveType primitiveType = PrimitiveType::Triangles) override;
         void drawBoundVertexBuffer(UInt32 vertexCount, WeakPointer<IndexBuffer> indices, PrimitiveType primitiveType = PrimitiveType::Triangles) override;
+        void drawBoundVertexBufferInstanced(UInt32 vertexCount, UInt32 instanceCount, PrimitiveType primitiveType = PrimitiveType::Triangles) override;
 
         ShaderManager& getShaderManager() override;
 
@@ -101,6 +104,9 @@ namespace Core {
 
         void lowLevelBlit(WeakPointer<RenderTarget> source, WeakPointer<RenderTarget> destination, Int16 cubeFace, Bool includeColor, Bool includeDepth) override;
 
+        static GLStateCache& getStateCache();
+        static GLProgramBinaryCache& getProgramBinaryCache();
+
         static GLint getGLDepthFunction(RenderState::DepthFunction function);
         static GLenum getGLCubeTarget(CubeTextureSide side);
         static GLuint convertAttributeType(AttributeType type);
@@ -119,6 +125,7 @@ namespace Core {
 
         std::shared_ptr<AttributeArrayGPUStorage> createGPUStorage(UInt32 size, UInt32 componentCount, AttributeType type, Bool normalize) override;
         std::shared_ptr<IndexBuffer> createIndexBuffer(UInt32 size) override;
+        std::shared_ptr<MatrixBuffer> createMatrixBuffer(UInt32 capacity) override;
 
     private:
         GraphicsGL(GLVersion version);
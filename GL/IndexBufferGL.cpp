@@ -1,4 +1,5 @@
 #include "IndexBufferGL.h"
+#include "GraphicsGL.h"
 #include "../common/Exception.h"
 
 namespace Core {
@@ -18,6 +19,7 @@ namespace Core {
     void IndexBufferGL::destroy() {
         if (this->bufferID > 0) {
             glDeleteBuffers(1, &this->bufferID);
+            GraphicsGL::getStateCache().bufferDeleted(this->bufferID);
             this->bufferID = 0;
         }
     }
@@ -28,15 +30,30 @@ namespace Core {
         if (!this->bufferID) {
             throw AllocationException("IndexBufferGL::initIndices() -> Unable to generate index buffer.");
         }
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, this->bufferID);
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+        GLStateCache& stateCache = GraphicsGL::getStateCache();
+        stateCache.bindBuffer(GL_ELEMENT_ARRAY_BUFFER, this->bufferID);
+        stateCache.bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
     }
 
     void IndexBufferGL::setIndices(UInt32* indices) {
         IndexBuffer::setIndices(indices);
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, this->bufferID);
+        GLStateCache& stateCache = GraphicsGL::getStateCache();
+        stateCache.bindBuffer(GL_ELEMENT_ARRAY_BUFFER, this->bufferID);
         glBufferData(GL_ELEMENT_ARRAY_BUFFER, this->size * sizeof(UInt32), indices, GL_DYNAMIC_DRAW);
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+        stateCache.bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    }
+
+    /*
+     * The buffer is orphaned before the partial upload, so that indices that change every frame don't stall on
+     * draws still reading the previous contents.
+     */
+    void IndexBufferGL::setIndices(const UInt32* indices, UInt32 count) {
+        IndexBuffer::setIndices(indices, count);
+        GLStateCache& stateCache = GraphicsGL::getStateCache();
+        stateCache.bindBuffer(GL_ELEMENT_ARRAY_BUFFER, this->bufferID);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, this->size * sizeof(UInt32), nullptr, GL_STREAM_DRAW);
+        glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, count * sizeof(UInt32), indices);
+        stateCache.bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
     }
 
 }
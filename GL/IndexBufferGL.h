@@ -11,6 +11,7 @@ namespace Core {
         ~IndexBufferGL() override;
         Int32 getBufferID() const;
         void setIndices(UInt32 * indices) override;
+        void setIndices(const UInt32 * indices, UInt32 count) override;
         void initIndices() override;
         UInt32 getSize();
     private:
@@ -0,0 +1,66 @@
+#include "MatrixBufferGL.h"
+#include "GraphicsGL.h"
+#include "../common/Exception.h"
+
+namespace Core {
+
+    MatrixBufferGL::MatrixBufferGL(UInt32 capacity): MatrixBuffer(capacity), bufferID(0), textureID(0) {
+        this->init();
+    }
+
+    MatrixBufferGL::~MatrixBufferGL() {
+        this->destroy();
+    }
+
+    void MatrixBufferGL::init() {
+        glGenBuffers(1, &this->bufferID);
+        if (!this->bufferID) {
+            throw AllocationException("MatrixBufferGL::init() -> Unable to generate matrix buffer.");
+        }
+        GLStateCache& stateCache = GraphicsGL::getStateCache();
+        stateCache.bindBuffer(GL_TEXTURE_BUFFER, this->bufferID);
+        glBufferData(GL_TEXTURE_BUFFER, this->capacity * 16 * sizeof(Real), nullptr, GL_DYNAMIC_DRAW);
+        stateCache.bindBuffer(GL_TEXTURE_BUFFER, 0);
+
+        glGenTextures(1, &this->textureID);
+        if (!this->textureID) {
+            this->destroy();
+            throw AllocationException("MatrixBufferGL::init() -> Unable to generate matrix buffer texture.");
+        }
+        // each matrix is four RGBA texels, one per column
+        stateCache.bindTexture(GL_TEXTURE_BUFFER, this->textureID);
+        glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, this->bufferID);
+        stateCache.bindTexture(GL_TEXTURE_BUFFER, 0);
+    }
+
+    void MatrixBufferGL::destroy() {
+        if (this->textureID > 0) {
+            glDeleteTextures(1, &this->textureID);
+            GraphicsGL::getStateCache().textureDeleted(this->textureID);
+            this->textureID = 0;
+        }
+        if (this->bufferID > 0) {
+            glDeleteBuffers(1, &this->bufferID);
+            GraphicsGL::getStateCache().bufferDeleted(this->bufferID);
+            this->bufferID = 0;
+        }
+    }
+
+    void MatrixBufferGL::setMatrices(const Real * matrices, UInt32 count) {
+        if (count > this->capacity) {
+            throw OutOfRangeException("MatrixBufferGL::setMatrices() -> 'count' exceeds the buffer capacity.");
+        }
+        GLStateCache& stateCache = GraphicsGL::getStateCache();
+        stateCache.bindBuffer(GL_TEXTURE_BUFFER, this->bufferID);
+        // orphan the previous contents so that the upload doesn't wait on draws still reading them
+        glBufferData(GL_TEXTURE_BUFFER, this->capacity * 16 * sizeof(Real), nullptr, GL_DYNAMIC_DRAW);
+        glBufferSubData(GL_TEXTURE_BUFFER, 0, count * 16 * sizeof(Real), matrices);
+        stateCache.bindBuffer(GL_TEXTURE_BUFFER, 0);
+    }
+
+    void MatrixBufferGL::sendToActiveShader(UInt32 samplerSlot, UInt32 uniformLocation) {
+        GraphicsGL::getStateCache().bindTexture(samplerSlot, GL_TEXTURE_BUFFER, this->textureID);
+        glUniform1i(uniformLocation, samplerSlot);
+    }
+
+}
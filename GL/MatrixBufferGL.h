@@ -0,0 +1,21 @@
+#pragma once
+
+#include "../render/MatrixBuffer.h"
+#include "../common/gl.h"
+
+namespace Core {
+
+    class MatrixBufferGL final: public MatrixBuffer {
+    public:
+        MatrixBufferGL(UInt32 capacity);
+        ~MatrixBufferGL() override;
+        void setMatrices(const Real * matrices, UInt32 count) override;
+        void sendToActiveShader(UInt32 samplerSlot, UInt32 uniformLocation) override;
+    private:
+        void init();
+        void destroy();
+        GLuint bufferID;
+        GLuint textureID;
+    };
+
+}
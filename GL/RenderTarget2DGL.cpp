@@ -56,7 +56,7 @@ namespace Core {
 
     Bool RenderTarget2DGL::addColorTexture(TextureAttributes attributes) {
         if (this->activeColorTextures < RenderTarget::MaxRenderTargetOutputTargets - 1) {
-            glBindFramebuffer(GL_FRAMEBUFFER, this->fboID);
+            GraphicsGL::getStateCache().bindFramebuffer(GL_FRAMEBUFFER, this->fboID);
             this->colorTextureAttributes[this->activeColorTextures] = attributes;
             this->mipLevel[this->activeColorTextures] = 0;
             this->colorBufferIsTexture[this->activeColorTextures] = true;
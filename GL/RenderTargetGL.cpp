@@ -1,4 +1,5 @@
 #include "RenderTargetGL.h"
+#include "GraphicsGL.h"
 
 namespace Core {
 
@@ -32,6 +33,7 @@ namespace Core {
         // destroy the FBO
         if (this->fboID > 0) {
             glDeleteFramebuffers(1, &this->fboID);
+            GraphicsGL::getStateCache().framebufferDeleted(this->fboID);
             this->fboID = 0;
         }
     }
@@ -46,7 +48,7 @@ namespace Core {
             throw RenderTargetException("RenderTargetGL::initFramebuffer -> Unable to create frame buffer object.");
         }
 
-        glBindFramebuffer(GL_FRAMEBUFFER, this->fboID);
+        GraphicsGL::getStateCache().bindFramebuffer(GL_FRAMEBUFFER, this->fboID);
         
     }
 
@@ -72,7 +74,7 @@ namespace Core {
             throw RenderTargetException("RenderTargetCubeGL::init -> Framebuffer is incomplete!.");
         }
 
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        GraphicsGL::getStateCache().bindFramebuffer(GL_FRAMEBUFFER, 0);
     }
 
     void RenderTargetGL::initDepthStencilBufferCombo(UInt32 sizeX, UInt32 sizeY) {
@@ -1,10 +1,12 @@
 #include "ShaderGL.h"
+#include "GraphicsGL.h"
 
 #include <stdlib.h>
 #include <string.h>
 
 #include "../common/debug.h"
 #include "../util/String.h"
+#include "../Engine.h"
 
 namespace Core {
 
@@ -24,6 +26,10 @@ namespace Core {
     }
 
     ShaderGL::~ShaderGL() {
+        for (UInt32 i = 0; i < 3; i++) {
+            if (this->pendingShaders[i]) glDeleteShader(this->pendingShaders[i]);
+        }
+        if (this->pendingProgram) glDeleteProgram(this->pendingProgram);
         if (this->glProgram) {
             glDeleteProgram(this->glProgram);
             this->glProgram = 0;
@@ -41,7 +47,85 @@ namespace Core {
         return program ? true : false;
     }
 
+    /*
+     * With parallel shader compilation the stages are compiled and the program linked without asking GL
+     * for the results, which lets the driver finish the work on its own threads; finishBuild() collects
+     * them. Without it the shader is built right away.
+     */
+    Bool ShaderGL::beginBuild() {
+        if (this->ready || this->buildPending) return true;
+        if (!Engine::instance()->getGraphicsSystem()->supportsParallelShaderCompile()) return this->build();
+
+        const std::string* geometry = this->hasGeometryShader ? &this->geometrySource : nullptr;
+        GLProgramBinaryCache& programBinaryCache = GraphicsGL::getProgramBinaryCache();
+        if (programBinaryCache.isEnabled()) {
+            this->pendingSourceHash = GLProgramBinaryCache::hashSources(this->vertexSource, geometry, this->fragmentSource);
+            GLuint program = programBinaryCache.loadProgram(this->pendingSourceHash);
+            if (program) {
+                this->ready = true;
+                this->glProgram = program;
+                return true;
+            }
+        }
+
+        this->pendingShaders[0] = this->compileShader(ShaderType::Vertex, this->vertexSource);
+        if (geometry != nullptr) this->pendingShaders[1] = this->compileShader(ShaderType::Geometry, *geometry);
+        this->pendingShaders[2] = this->compileShader(ShaderType::Fragment, this->fragmentSource);
+        this->pendingProgram = glCreateProgram();
+        if (!this->pendingProgram) checkGlError("glCreateProgram");
+        for (UInt32 i = 0; i < 3; i++) {
+            if (this->pendingShaders[i]) glAttachShader(this->pendingProgram, this->pendingShaders[i]);
+        }
+        programBinaryCache.prepareProgram(this->pendingProgram);
+        glLinkProgram(this->pendingProgram);
+        this->buildPending = true;
+        return true;
+    }
+
+    Bool ShaderGL::isBuildComplete() {
+        if (!this->buildPending) return true;
+        GLint complete = GL_FALSE;
+        glGetProgramiv(this->pendingProgram, GL_COMPLETION_STATUS_KHR, &complete);
+        return complete == GL_TRUE;
+    }
+
+    Bool ShaderGL::finishBuild() {
+        if (!this->buildPending) return this->ready;
+        this->buildPending = false;
+        GLuint program = this->pendingProgram;
+        GLuint shaders[3] = {this->pendingShaders[0], this->pendingShaders[1], this->pendingShaders[2]};
+        this->pendingProgram = 0;
+        this->pendingShaders[0] = this->pendingShaders[1] = this->pendingShaders[2] = 0;
+
+        const ShaderType types[3] = {ShaderType::Vertex, ShaderType::Geometry, ShaderType::Fragment};
+        const std::string* sources[3] = {&this->vertexSource, &this->geometrySource, &this->fragmentSource};
+        try {
+            for (UInt32 i = 0; i < 3; i++) {
+                GLuint shader = shaders[i];
+                shaders[i] = 0;
+                if (shader) {
+                    this->checkShaderCompiled(shader, types[i], *sources[i]);
+                    glDeleteShader(shader);
+                }
+            }
+        } catch (...) {
+            for (UInt32 i = 0; i < 3; i++) {
+                if (shaders[i]) glDeleteShader(shaders[i]);
+            }
+            glDeleteProgram(program);
+            throw;
+        }
+        this->checkProgramLinked(program);
+
+        GLProgramBinaryCache& programBinaryCache = GraphicsGL::getProgramBinaryCache();
+        if (programBinaryCache.isEnabled()) programBinaryCache.storeProgram(this->pendingSourceHash, program);
+        this->ready = true;
+        this->glProgram = program;
+        return true;
+    }
+
     Int32 ShaderGL::getUniformLocation(const std::string &var) const {
+        if (!this->ready) return -1;
         return (Int32)glGetUniformLocation(this->glProgram, var.c_str());
     }
 
@@ -50,6 +134,7 @@ namespace Core {
     }
 
     Int32 ShaderGL::getAttributeLocation(const std::string &var) const {
+        if (!this->ready) return -1;
         return (Int32)glGetAttribLocation(this->glProgram, var.c_str());
     }
 
@@ -58,6 +143,7 @@ namespace Core {
     }
 
     Int32 ShaderGL::getUniformLocation(const char var[]) const {
+        if (!this->ready) return -1;
         return (Int32)glGetUniformLocation(this->glProgram, var);
     }
 
@@ -66,6 +152,7 @@ namespace Core {
     }
 
     Int32 ShaderGL::getAttributeLocation(const char var[]) const {
+        if (!this->ready) return -1;
         return (Int32)glGetAttribLocation(this->glProgram, var);
     }
 
@@ -91,19 +178,13 @@ namespace Core {
 
 
     void ShaderGL::setTexture2D(UInt32 slot, UInt32 textureID) {
-        static UInt32 slots[] = {GL_TEXTURE0, GL_TEXTURE1, GL_TEXTURE2, GL_TEXTURE3, GL_TEXTURE4, GL_TEXTURE5,
-                                 GL_TEXTURE6, GL_TEXTURE7, GL_TEXTURE8, GL_TEXTURE9, GL_TEXTURE10, GL_TEXTURE11,
-                                 GL_TEXTURE12, GL_TEXTURE13, GL_TEXTURE14, GL_TEXTURE15, GL_TEXTURE16, GL_TEXTURE17,
-                                 GL_TEXTURE18, GL_TEXTURE19, GL_TEXTURE20, GL_TEXTURE21, GL_TEXTURE22, GL_TEXTURE23,
-                                 GL_TEXTURE24, GL_TEXTURE25, GL_TEXTURE26, GL_TEXTURE27, GL_TEXTURE28, GL_TEXTURE29,
-                                 GL_TEXTURE30, GL_TEXTURE31};
         if (slot >= 31) {
             std::cerr << "slot: " << slot << std::endl;
             throw Shader::ShaderVariableException("ShaderGL::setTexture2D() value for [slot] is too high.");
         }
-        glActiveTexture(slots[slot]);
-        glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
-        glBindTexture(GL_TEXTURE_2D, textureID);
+        GLStateCache& stateCache = GraphicsGL::getStateCache();
+        stateCache.bindTexture(slot, GL_TEXTURE_CUBE_MAP, 0);
+        stateCache.bindTexture(slot, GL_TEXTURE_2D, textureID);
     }
 
     void ShaderGL::setTexture2D(UInt32 samplerSlot, UInt32 uniformLocation, UInt32 textureID) {
@@ -112,20 +193,13 @@ namespace Core {
     }
 
     void ShaderGL::setTextureCube(UInt32 slot, UInt32 textureID) {
-        static UInt32 slots[] = {GL_TEXTURE0, GL_TEXTURE1, GL_TEXTURE2, GL_TEXTURE3, GL_TEXTURE4, GL_TEXTURE5,
-                                 GL_TEXTURE6, GL_TEXTURE7, GL_TEXTURE8, GL_TEXTURE9, GL_TEXTURE10, GL_TEXTURE11,
-                                 GL_TEXTURE12, GL_TEXTURE13, GL_TEXTURE14, GL_TEXTURE15, GL_TEXTURE16, GL_TEXTURE17,
-                                 GL_TEXTURE18, GL_TEXTURE19, GL_TEXTURE20, GL_TEXTURE21, GL_TEXTURE22, GL_TEXTURE23,
-                                 GL_TEXTURE24, GL_TEXTURE25, GL_TEXTURE26, GL_TEXTURE27, GL_TEXTURE28, GL_TEXTURE29,
-                                 GL_TEXTURE30, GL_TEXTURE31};
-
         if (slot >= 31) {
             std::cerr << "slot: " << slot << std::endl;
             throw Shader::ShaderVariableException("ShaderGL::setTextureCube() value for [slot] is too high.");
         }
-        glActiveTexture(slots[slot]);
-        glBindTexture(GL_TEXTURE_2D, 0);
-        glBindTexture(GL_TEXTURE_CUBE_MAP, textureID);
+        GLStateCache& stateCache = GraphicsGL::getStateCache();
+        stateCache.bindTexture(slot, GL_TEXTURE_2D, 0);
+        stateCache.bindTexture(slot, GL_TEXTURE_CUBE_MAP, textureID);
     }
 
     void ShaderGL::setTextureCube(UInt32 samplerSlot, UInt32 uniformLocation, UInt32 textureID) {
@@ -189,6 +263,16 @@ namespace Core {
     }
 
     UInt32 ShaderGL::createShader(ShaderType shaderType, const std::string &src) {
+        GLuint shader = this->compileShader(shaderType, src);
+        if (!shader) return 0;
+        this->checkShaderCompiled(shader, shaderType, src);
+        return shader;
+    }
+
+    /*
+     * Start compiling [src] without waiting for the result.
+     */
+    GLuint ShaderGL::compileShader(ShaderType shaderType, const std::string &src) {
         GLuint shader = glCreateShader(convertShaderType(shaderType));
         if (!shader) {
             ShaderGL::checkGlError("glCreateShader");
@@ -196,9 +280,12 @@ namespace Core {
         }
         const char *srcPtr = src.c_str();
         glShaderSource(shader, 1, &srcPtr, NULL);
+        glCompileShader(shader);
+        return shader;
+    }
 
+    void ShaderGL::checkShaderCompiled(GLuint shader, ShaderType shaderType, const std::string &src) {
         GLint compiled = GL_FALSE;
-        glCompileShader(shader);
         glGetShaderiv(shader, GL_COMPILE_STATUS, &compiled);
         if (!compiled) {
             GLint infoLogLen = 0;
@@ -219,9 +306,30 @@ namespace Core {
             msg += String::addLineNumbers(src);
             msg += "\n\n";            
             throw ShaderCompilationException(msg);
-            return 0;
         }
-        return shader;
+    }
+
+    void ShaderGL::checkProgramLinked(GLuint program) {
+        static char errorString[128];
+        GLint linked = GL_FALSE;
+        glGetProgramiv(program, GL_LINK_STATUS, &linked);
+        if (!linked) {
+            GLint infoLogLen = 0;
+            glGetProgramiv(program, GL_INFO_LOG_LENGTH, &infoLogLen);
+            if (infoLogLen) {
+                GLchar *infoLog = (GLchar *)malloc(infoLogLen);
+                if (infoLog) {
+                    glGetProgramInfoLog(program, infoLogLen, NULL, infoLog);
+                    sprintf(errorString, "Could not link program:\n%s\n", infoLog);
+                    free(infoLog);
+                }
+            }
+            else {
+                sprintf(errorString, "Could not link program");
+            }
+            glDeleteProgram(program);
+            throw ShaderCompilationException(errorString);
+        }
     }
 
     UInt32 ShaderGL::createProgram(const std::string &vertex, const std::string &fragment) {
@@ -233,13 +341,23 @@ namespace Core {
     }
 
     UInt32 ShaderGL::createProgramInternal(const std::string &vertex, const std::string &fragment, const std::string* geometry) {
-        static char errorString[128];
         this->ready = false;
         GLuint vtxShader = 0;
         GLuint geoShader = 0;
         GLuint fragShader = 0;
         GLuint program = 0;
-        GLint linked = GL_FALSE;
+        GLProgramBinaryCache& programBinaryCache = GraphicsGL::getProgramBinaryCache();
+        UInt64 sourceHash = 0;
+
+        if (programBinaryCache.isEnabled()) {
+            sourceHash = GLProgramBinaryCache::hashSources(vertex, geometry, fragment);
+            program = programBinaryCache.loadProgram(sourceHash);
+            if (program) {
+                this->ready = true;
+                this->glProgram = program;
+                return program;
+            }
+        }
 
         vtxShader = createShader(ShaderType::Vertex, vertex);
         if (!vtxShader) goto exit;
@@ -268,27 +386,19 @@ namespace Core {
         if (geoShader) glAttachShader(program, geoShader);
         glAttachShader(program, fragShader);
 
+        programBinaryCache.prepareProgram(program);
         glLinkProgram(program);
-        glGetProgramiv(program, GL_LINK_STATUS, &linked);
-        if (!linked) {
-            GLint infoLogLen = 0;
-            glGetProgramiv(program, GL_INFO_LOG_LENGTH, &infoLogLen);
-            if (infoLogLen) {
-                GLchar *infoLog = (GLchar *)malloc(infoLogLen);
-                if (infoLog) {
-                    glGetProgramInfoLog(program, infoLogLen, NULL, infoLog);
-                    sprintf(errorString, "Could not link program:\n%s\n", infoLog);
-                    free(infoLog);
-                }
-            }
-            else {
-                sprintf(errorString, "Could not link program");
-            }
-            glDeleteProgram(program);
-            program = 0;
-            throw ShaderCompilationException(errorString);
+        try {
+            this->checkProgramLinked(program);
+        } catch (...) {
+            if (vtxShader) glDeleteShader(vtxShader);
+            if (geoShader) glDeleteShader(geoShader);
+            if (fragShader) glDeleteShader(fragShader);
+            throw;
         }
 
+        if (programBinaryCache.isEnabled()) programBinaryCache.storeProgram(sourceHash, program);
+
         this->ready = true;
         this->glProgram = program;
     exit:
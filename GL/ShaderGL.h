@@ -19,6 +19,9 @@ namespace Core {
 
         Bool isReady() const;
         Bool build() override;
+        Bool beginBuild() override;
+        Bool isBuildComplete() override;
+        Bool finishBuild() override;
         UInt32 getProgram() const override;
         Int32 getUniformLocation(const std::string& var) const override;
         Int32 getUniformLocation(const std::string& var, UInt32 index) const override;
@@ -56,10 +59,19 @@ namespace Core {
         static Bool checkGlError(const char* funcName);
         GLenum convertShaderType(ShaderType shaderType);
         UInt32 createShader(ShaderType shaderType, const std::string& src) override;
+        GLuint compileShader(ShaderType shaderType, const std::string& src);
+        void checkShaderCompiled(GLuint shader, ShaderType shaderType, const std::string& src);
+        void checkProgramLinked(GLuint program);
         UInt32 createProgram(const std::string& vertex, const std::string& fragment) override;
         UInt32 createProgram(const std::string& vertex, const std::string& geometry, const std::string& fragment) override;
         UInt32 createProgramInternal(const std::string& vertex, const std::string& fragment, const std::string* geometry = nullptr);
 
-        GLuint glProgram;
+        GLuint glProgram = 0;
+
+        // a build started by beginBuild() that the driver is still working on
+        Bool buildPending = false;
+        GLuint pendingProgram = 0;
+        GLuint pendingShaders[3] = {0, 0, 0};
+        UInt64 pendingSourceHash = 0;
     };
 }
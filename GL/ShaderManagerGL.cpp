@@ -31,7 +31,6 @@ const std::string SSAO_MAP = _un(Core::StandardUniform::SSAOMap);
 const std::string SSAO_ENABLED = _un(Core::StandardUniform::SSAOEnabled);
 const std::string DEPTH_OUTPUT_OVERRIDE = _un(Core::StandardUniform::DepthOutputOverride);
 
-const std::string MAX_BONES = std::to_string(Core::Constants::MaxBones);
 const std::string MAX_CASCADES = std::to_string(Core::Constants::MaxDirectionalCascades);
 const std::string MAX_LIGHTS = std::to_string(Core::Constants::MaxShaderLights);
 const std::string MAX_POINT_LIGHTS = std::to_string(Core::Constants::MaxShaderPointLights);
@@ -87,12 +86,38 @@ const std::string PROJECTION_MATRIX_DEF = "uniform mat4 " + PROJECTION_MATRIX +
 const std::string CAMERA_POSITION_DEF = "uniform vec4 " + CAMERA_POSITION + ";\n";
 const std::string TEXTURE0_DEF = "uniform sampler2D " + TEXTURE0 + ";\n";
 const std::string DEPTH_TEXTURE_DEF = "uniform sampler2D " + DEPTH_TEXTURE + ";\n";
-const std::string BONES_DEF = "uniform mat4 " + BONES + "[" + MAX_BONES + "];\n";
+const std::string BONES_DEF = "uniform samplerBuffer " + BONES + ";\n";
 const std::string SKINNING_ENABLED_DEF = "uniform int " + SKINNING_ENABLED + ";\n";
 const std::string SSAO_MAP_DEF = "uniform sampler2D " + SSAO_MAP + ";\n";
 const std::string SSAO_ENABLED_DEF = "uniform int " + SSAO_ENABLED + ";\n";
 const std::string DEPTH_OUTPUT_OVERRIDE_DEF = "uniform int " + DEPTH_OUTPUT_OVERRIDE + ";\n";
 
+// Location of the lower left corner of [sequenceElement] in the atlas frame set [atlasTiles], shared by the
+// particle shaders that expand sprites in the geometry and in the vertex stage
+const std::string PARTICLE_ATLAS_UV_FUNCTION =
+    "void getUV(in int sequenceElement, in int sequenceNumber, in vec4 atlasTiles, out vec2 uv) { \n"
+    "   float atlasTileWidth = atlasTiles.z; \n"
+    "   float atlasTileHeight = atlasTiles.w; \n"
+    "   float atlasTileX = atlasTiles.x; \n"
+    "   float atlasTileY = atlasTiles.y; \n"
+    "   int firstRowSections = int((1.0 - atlasTileX) / atlasTileWidth); \n"
+    "   int maxRowSections = int(1.0 / atlasTileWidth); \n"
+
+    "   float firstRowX = atlasTileX + atlasTileWidth * float(sequenceElement); \n"
+    "   float firstRowY = 1.0 - (atlasTileY + atlasTileHeight); \n"
+
+    "   int nRowSequenceElement = sequenceElement - firstRowSections; \n"
+    "   float SNOverHS = float(nRowSequenceElement) / float(maxRowSections);\n"
+    "   int nRowYTile = int(SNOverHS);\n"
+    "   int nRowXTile = int((SNOverHS - float(nRowYTile)) * float(maxRowSections));\n"
+    "   float nRowX = float(nRowXTile) * atlasTileWidth;\n"
+    "   float nRowY = 1.0 - ((float(nRowYTile) + 1.0) * (atlasTileHeight) + atlasTileY + atlasTileHeight);\n"
+
+    "   float nRow = step(float(firstRowSections), float(sequenceElement)); \n"
+    "   uv.x = nRow * nRowX + (1.0 - nRow) * firstRowX; \n"
+    "   uv.y = nRow * nRowY + (1.0 - nRow) * firstRowY; \n"
+    "} \n";
+
 // ------------------------------------
 // Single-pass lighting definitions
 // ------------------------------------
@@ -204,6 +229,9 @@ namespace Core {
         this->setShaderSource(ShaderType::Geometry, "ParticleStandard", ShaderManagerGL::ParticleStandard_geometry);
         this->setShaderSource(ShaderType::Fragment, "ParticleStandard", ShaderManagerGL::ParticleStandard_fragment);
 
+        this->setShaderSource(ShaderType::Vertex, "ParticleInstanced", ShaderManagerGL::ParticleInstanced_vertex);
+        this->setShaderSource(ShaderType::Fragment, "ParticleInstanced", ShaderManagerGL::ParticleStandard_fragment);
+
         this->setShaderSource(ShaderType::Vertex, "Outline", ShaderManagerGL::Outline_vertex);
         this->setShaderSource(ShaderType::Geometry, "Outline", ShaderManagerGL::Outline_geometry);
         this->setShaderSource(ShaderType::Fragment, "Outline", ShaderManagerGL::Outline_fragment);
@@ -513,28 +541,7 @@ namespace Core {
             "   uv.y = nRow * nRowY + (1.0 - nRow) * firstRowY; \n"
             "} \n"*/
 
-            "void getUV(in int sequenceElement, in int sequenceNumber, in vec4 atlasTiles, out vec2 uv) { \n"
-            "   float atlasTileWidth = atlasTiles.z; \n"
-            "   float atlasTileHeight = atlasTiles.w; \n"
-            "   float atlasTileX = atlasTiles.x; \n"
-            "   float atlasTileY = atlasTiles.y; \n"
-            "   int firstRowSections = int((1.0 - atlasTileX) / atlasTileWidth); \n"
-            "   int maxRowSections = int(1.0 / atlasTileWidth); \n"
-
-            "   float firstRowX = atlasTileX + atlasTileWidth * float(sequenceElement); \n"
-            "   float firstRowY = 1.0 - (atlasTileY + atlasTileHeight); \n"
-
-            "   int nRowSequenceElement = sequenceElement - firstRowSections; \n"
-            "   float SNOverHS = float(nRowSequenceElement) / float(maxRowSections);\n"
-            "   int nRowYTile = int(SNOverHS);\n"
-            "   int nRowXTile = int((SNOverHS - float(nRowYTile)) * float(maxRowSections));\n"
-            "   float nRowX = float(nRowXTile) * atlasTileWidth;\n"
-            "   float nRowY = 1.0 - ((float(nRowYTile) + 1.0) * (atlasTileHeight) + atlasTileY + atlasTileHeight);\n"
-
-            "   float nRow = step(float(firstRowSections), float(sequenceElement)); \n"
-            "   uv.x = nRow * nRowX + (1.0 - nRow) * firstRowX; \n"
-            "   uv.y = nRow * nRowY + (1.0 - nRow) * firstRowY; \n"
-            "} \n"
+            + PARTICLE_ATLAS_UV_FUNCTION +
 
             "void main()\n"
             "{\n"
@@ -639,6 +646,52 @@ namespace Core {
 
             "}\n";
 
+        this->ParticleInstanced_vertex =
+            "#version 400\n"
+            "precision highp float;\n"
+            "const int MAX_ATLAS_FRAME_SETS = 16; \n"
+            "uniform vec4 atlasFrameSet[MAX_ATLAS_FRAME_SETS]; \n"
+            "uniform int interpolateAtlasFrames; \n"
+            + PROJECTION_MATRIX_DEF
+            + VIEW_MATRIX_DEF +
+            "in vec2 quadCorner;\n"
+            "in vec4 worldPosition;\n"
+            "in float rotation;\n"
+            "in vec2 size;\n"
+            "in vec4 sequenceElement;\n"
+            "in vec4 color;\n"
+            "out vec2 vUV1;\n"
+            "out vec2 vUV2;\n"
+            "out vec4 vFragColor;\n"
+            "out float vSequenceElementT; \n"
+            + PARTICLE_ATLAS_UV_FUNCTION +
+            "void main()\n"
+            "{\n"
+            "   int sequenceNumber = int(sequenceElement.y);\n"
+            "   int sequenceStart = int(sequenceElement.z);\n"
+            "   int sequenceLength = int(sequenceElement.w);\n"
+            "   vec4 atlasTiles = atlasFrameSet[sequenceNumber]; \n"
+
+            "   vec2 uv1; \n"
+            "   vec2 uv2; \n"
+            "   vSequenceElementT = sequenceElement.x - float(int(sequenceElement.x)); \n"
+            "   int firstSequenceElement = int(sequenceElement.x); \n"
+            "   int secondSequenceElement = clamp(firstSequenceElement + 1, sequenceStart, sequenceStart + sequenceLength - 1); \n"
+            "   getUV(firstSequenceElement, sequenceNumber, atlasTiles, uv1); \n"
+            "   uv2 = uv1; \n"
+            "   if (interpolateAtlasFrames == 1 && firstSequenceElement != secondSequenceElement) getUV(secondSequenceElement, sequenceNumber, atlasTiles, uv2); \n"
+
+            // quadCorner is one of (-1, -1), (-1, 1), (1, -1) and (1, 1), mapped to the corners of the atlas tile
+            "   vec2 tileOffset = (quadCorner * 0.5 + 0.5) * atlasTiles.zw; \n"
+            "   vUV1 = uv1 + tileOffset;\n"
+            "   vUV2 = uv2 + tileOffset;\n"
+            "   vFragColor = color; \n"
+
+            "   mat2 rotMat = mat2(cos(rotation), -sin(rotation), sin(rotation), cos(rotation)) * mat2(size.x, 0.0, 0.0, size.y);\n"
+            "   vec4 viewPosition = " + VIEW_MATRIX + " * worldPosition;\n"
+            "   gl_Position = " + PROJECTION_MATRIX + " * (vec4(rotMat * quadCorner, 0.0, 0.0) + viewPosition);\n"
+            "}\n";
+
         this->ParticleStandard_fragment =
             "#version 400\n"
             "precision highp float;\n"
@@ -1987,10 +2040,10 @@ namespace Core {
             "} \n";
 
         std::string BONE_TRANSFORM_DEF = 
-            "    mat4 boneTransform = " + BONES + "[" + BONE_INDEX + ".x] * " + BONE_WEIGHT + ".x;\n"
-            "    boneTransform += " + BONES + "[" + BONE_INDEX + ".y] * " + BONE_WEIGHT + ".y;\n"
-            "    boneTransform += " + BONES + "[" + BONE_INDEX + ".z] * " + BONE_WEIGHT + ".z; \n"
-            "    boneTransform += " + BONES + "[" + BONE_INDEX + ".w] * " + BONE_WEIGHT + ".w; \n";
+            "    mat4 boneTransform = getBoneMatrix(" + BONE_INDEX + ".x) * " + BONE_WEIGHT + ".x;\n"
+            "    boneTransform += getBoneMatrix(" + BONE_INDEX + ".y) * " + BONE_WEIGHT + ".y;\n"
+            "    boneTransform += getBoneMatrix(" + BONE_INDEX + ".z) * " + BONE_WEIGHT + ".z; \n"
+            "    boneTransform += getBoneMatrix(" + BONE_INDEX + ".w) * " + BONE_WEIGHT + ".w; \n";
 
         this->VertexSkinning_vertex =  
             SKINNING_ENABLED_DEF
@@ -1998,6 +2051,13 @@ namespace Core {
             + BONE_WEIGHT_DEF
             + BONE_INDEX_DEF +
 
+            // each bone matrix is stored as four texels, one per column
+            "mat4 getBoneMatrix(int bone) {\n"
+            "    int texel = bone * 4;\n"
+            "    return mat4(texelFetch(" + BONES + ", texel), texelFetch(" + BONES + ", texel + 1),\n"
+            "                texelFetch(" + BONES + ", texel + 2), texelFetch(" + BONES + ", texel + 3));\n"
+            "}\n"
+
             "void calculateSkinnedPositionAndNormals(inout vec4 skinnedPosition, inout vec4 skinnedNormal, inout vec4 skinnedFaceNormal) {\n"
             "    if (" + SKINNING_ENABLED + " == 1) { \n"
             +        BONE_TRANSFORM_DEF +
@@ -33,6 +33,7 @@ namespace Core {
         std::string ParticleStandard_vertex;
         std::string ParticleStandard_geometry;
         std::string ParticleStandard_fragment;
+        std::string ParticleInstanced_vertex;
 
         std::string Outline_vertex;
         std::string Outline_geometry;
@@ -7,12 +7,15 @@
 namespace Core {
 
     Texture2DGL::Texture2DGL(const TextureAttributes& attributes): Texture2D(attributes) {
-
+        this->streamWidth = 0;
+        this->streamHeight = 0;
+        this->firstResidentMipLevel = 0;
     }
 
     Texture2DGL::~Texture2DGL() {
         if (this->textureId > 0) {
             glDeleteTextures(1, &this->textureId);
+            GraphicsGL::getStateCache().textureDeleted(this->textureId);
         }
     }
 
@@ -59,19 +62,88 @@ namespace Core {
     void Texture2DGL::buildFromData(Byte* data, UInt32 width, UInt32 height) {
         this->setupTexture(data, width, height);
     }
+
+    void Texture2DGL::buildFromMipLevels(Byte** levels, UInt32 levelCount, UInt32 width, UInt32 height) {
+        if (levelCount == 0) {
+            throw InvalidArgumentException("Texture2DGL::buildFromMipLevels() -> 'levelCount' must be greater than zero.");
+        }
+        this->setupTexture(levels, levelCount, width, height, false);
+    }
+
+    void Texture2DGL::buildStreamable(UInt32 width, UInt32 height) {
+        if (width == 0 || height == 0) {
+            throw InvalidArgumentException("Texture2DGL::buildStreamable() -> Texture dimensions must be non-zero.");
+        }
+        this->setupTexture(nullptr, 0, width, height, false);
+        this->streamWidth = width;
+        this->streamHeight = height;
+
+        UInt32 lastLevel = 0;
+        for (UInt32 size = width > height ? width : height; size > 1; size >>= 1) lastLevel++;
+        this->firstResidentMipLevel = lastLevel + 1;
+
+        // nothing is sampled until the coarsest level has been uploaded
+        GLStateCache& stateCache = GraphicsGL::getStateCache();
+        stateCache.bindTexture(GL_TEXTURE_2D, this->getTextureID());
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, lastLevel);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, lastLevel);
+        stateCache.bindTexture(GL_TEXTURE_2D, 0);
+    }
+
+    void Texture2DGL::uploadMipLevel(UInt32 level, const Byte* data) {
+        UInt32 size = this->streamWidth > this->streamHeight ? this->streamWidth : this->streamHeight;
+        if (size == 0 || level >= 32 || (size >> level) == 0) {
+            throw InvalidArgumentException("Texture2DGL::uploadMipLevel() -> Invalid mip level.");
+        }
+        WeakPointer<Graphics> graphics = Engine::instance()->getGraphicsSystem();
+        WeakPointer<GraphicsGL> graphicsGL =  WeakPointer<Graphics>::dynamicPointerCast<GraphicsGL>(graphics);
+        UInt32 levelWidth = this->streamWidth >> level > 0 ? this->streamWidth >> level : 1;
+        UInt32 levelHeight = this->streamHeight >> level > 0 ? this->streamHeight >> level : 1;
+
+        // only this level is transferred; the texture object and the other levels are left alone
+        GLStateCache& stateCache = GraphicsGL::getStateCache();
+        stateCache.bindTexture(GL_TEXTURE_2D, this->getTextureID());
+        glTexImage2D(GL_TEXTURE_2D, level, graphicsGL->getGLTextureFormat(attributes.Format), levelWidth, levelHeight, 0,
+                     graphicsGL->getGLPixelFormat(attributes.Format), graphicsGL->getGLPixelType(attributes.Format), data);
+        stateCache.bindTexture(GL_TEXTURE_2D, 0);
+    }
+
+    void Texture2DGL::setFirstResidentMipLevel(UInt32 level) {
+        if (this->streamWidth == 0) {
+            throw InvalidArgumentException("Texture2DGL::setFirstResidentMipLevel() -> Texture is not streamable.");
+        }
+        WeakPointer<Graphics> graphics = Engine::instance()->getGraphicsSystem();
+        WeakPointer<GraphicsGL> graphicsGL =  WeakPointer<Graphics>::dynamicPointerCast<GraphicsGL>(graphics);
+        GLStateCache& stateCache = GraphicsGL::getStateCache();
+        stateCache.bindTexture(GL_TEXTURE_2D, this->getTextureID());
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, level);
+
+        // redefining the dropped levels as empty frees their storage without recreating the texture
+        for (UInt32 i = this->firstResidentMipLevel; i < level; i++) {
+            glTexImage2D(GL_TEXTURE_2D, i, graphicsGL->getGLTextureFormat(attributes.Format), 0, 0, 0,
+                         graphicsGL->getGLPixelFormat(attributes.Format), graphicsGL->getGLPixelType(attributes.Format), nullptr);
+        }
+        stateCache.bindTexture(GL_TEXTURE_2D, 0);
+        this->firstResidentMipLevel = level;
+    }
       
     void Texture2DGL::buildEmpty(UInt32 width, UInt32 height) {
         this->setupTexture(nullptr, width, height);
     }
 
     void Texture2DGL::updateMipMaps() {
-        glBindTexture(GL_TEXTURE_2D, this->getTextureID());
+        GLStateCache& stateCache = GraphicsGL::getStateCache();
+        stateCache.bindTexture(GL_TEXTURE_2D, this->getTextureID());
         glGenerateMipmap(GL_TEXTURE_2D);
-        glBindTexture(GL_TEXTURE_2D, 0);
+        stateCache.bindTexture(GL_TEXTURE_2D, 0);
     }
 
 
     void Texture2DGL::setupTexture(Byte* data, UInt32 width, UInt32 height) {
+        this->setupTexture(&data, 1, width, height, true);
+    }
+
+    void Texture2DGL::setupTexture(Byte** levels, UInt32 levelCount, UInt32 width, UInt32 height, Bool generateMipMaps) {
         WeakPointer<Graphics> graphics = Engine::instance()->getGraphicsSystem();
         WeakPointer<GraphicsGL> graphicsGL =  WeakPointer<Graphics>::dynamicPointerCast<GraphicsGL>(graphics);
 
@@ -82,7 +154,8 @@ namespace Core {
         if (!tex) {
             throw AllocationException("Texture2DGL::setupTexture -> Unable to generate texture");
         }
-        glBindTexture(GL_TEXTURE_2D, tex);
+        GLStateCache& stateCache = GraphicsGL::getStateCache();
+        stateCache.bindTexture(GL_TEXTURE_2D, tex);
 
         GLenum textureFormat = graphicsGL->getGLTextureFormat(attributes.Format);
         GLenum pixelFormat = graphicsGL->getGLPixelFormat(attributes.Format);
@@ -100,7 +173,11 @@ namespace Core {
 #endif
         }
         else {
-            glTexImage2D(GL_TEXTURE_2D, 0, textureFormat, width, height, 0, pixelFormat, pixelType, data);
+            for (UInt32 i = 0; i < levelCount; i++) {
+                UInt32 levelWidth = width >> i > 0 ? width >> i : 1;
+                UInt32 levelHeight = height >> i > 0 ? height >> i : 1;
+                glTexImage2D(GL_TEXTURE_2D, i, textureFormat, levelWidth, levelHeight, 0, pixelFormat, pixelType, levels[i]);
+            }
         }
 
                 // set the wrap mode
@@ -146,14 +223,28 @@ namespace Core {
             glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
         }
 
-        if (attributes.MipLevels > 1) {
+        if (!generateMipMaps) {
+            // the supplied levels are the whole chain; don't let GL sample levels that were never uploaded
+            if (levelCount > 0) glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levelCount - 1);
+            if (attributes.MipLevels > 1) {
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_ANISOTROPY_EXT, attributes.MipLevels - 1);
+            }
+        }
+        else if (attributes.MipLevels > 1) {
             glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, attributes.MipLevels - 1);
             glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_ANISOTROPY_EXT, attributes.MipLevels - 1);
             glGenerateMipmap(GL_TEXTURE_2D);
         }
        
-        glBindTexture(GL_TEXTURE_2D, 0);
+        stateCache.bindTexture(GL_TEXTURE_2D, 0);
+        if (this->textureId > 0) {
+            GLuint oldTex = this->textureId;
+            glDeleteTextures(1, &oldTex);
+            stateCache.textureDeleted(oldTex);
+        }
         this->textureId = (Int32)tex;
+        this->streamWidth = 0;
+        this->streamHeight = 0;
     }
     
 };
@@ -21,11 +21,21 @@ namespace Core {
         void buildFromImage(WeakPointer<HDRImage> imageData) override;
         void buildFromImage(WeakPointer<HDRImage> imageData, UInt32 resizeWidth, UInt32 resizeHeight) override;
         void buildFromData(Byte* data, UInt32 width, UInt32 height) override;
+        void buildFromMipLevels(Byte** levels, UInt32 levelCount, UInt32 width, UInt32 height) override;
+        void buildStreamable(UInt32 width, UInt32 height) override;
+        void uploadMipLevel(UInt32 level, const Byte* data) override;
+        void setFirstResidentMipLevel(UInt32 level) override;
         void buildEmpty(UInt32 width, UInt32 height) override;
         void updateMipMaps() override;
 
     protected:
         Texture2DGL(const TextureAttributes& attributes);
         void setupTexture(Byte* data, UInt32 width, UInt32 height);
+        void setupTexture(Byte** levels, UInt32 levelCount, UInt32 width, UInt32 height, Bool generateMipMaps);
+
+        // dimensions of level 0 and the finest resident level of a streamable texture
+        UInt32 streamWidth;
+        UInt32 streamHeight;
+        UInt32 firstResidentMipLevel;
     };
 }
@@ -5,6 +5,7 @@
 #include "image/CubeTexture.h"
 #include "material/Shader.h"
 #include "material/Material.h"
+#include "material/ShaderManager.h"
 #include "render/Renderer.h"
 #include "render/MeshRenderer.h"
 #include "render/Object3DRenderer.h"
@@ -23,12 +24,17 @@ namespace Core {
     Graphics::Graphics(): sharedRenderState(false) {
         this->hasAnyShaderBeenActivated = false;
         this->lastActivatedShaderID = 0;
+        this->geometryShadersSupported = true;
+        this->instancingSupported = false;
+        this->parallelShaderCompileSupported = false;
     }
 
     Graphics::~Graphics() {
     }
 
     void Graphics::init() {
+        this->getShaderManager().setLazyCompilation(Engine::isLazyShaderCompilationEnabled());
+
         TextureAttributes texAttributes;
         texAttributes.FilterMode = TextureFilter::Point;
         texAttributes.MipLevels = 0;
@@ -56,6 +62,22 @@ namespace Core {
         this->sharedRenderState = shared;
     }
 
+    Bool Graphics::supportsGeometryShaders() const {
+        return this->geometryShadersSupported;
+    }
+
+    Bool Graphics::supportsInstancing() const {
+        return this->instancingSupported;
+    }
+
+    /*
+     * Whether shader builds can run in the background, so that ShaderManager::update() can poll them
+     * instead of waiting for each one.
+     */
+    Bool Graphics::supportsParallelShaderCompile() const {
+        return this->parallelShaderCompileSupported;
+    }
+
     void Graphics::setRenderSize(UInt32 width, UInt32 height, Bool updateViewport) {
         this->updateDefaultRenderTargetSize(Vector2u(width, height));
         if (updateViewport) {
@@ -78,6 +100,7 @@ namespace Core {
     }
 
     void Graphics::blit(WeakPointer<RenderTarget> source, WeakPointer<RenderTarget> destination, Int16 cubeFace, WeakPointer<Material> material, Bool includeDepth) {
+        material->prepareShader(true);
         UInt32 samplerSlot = 0;
         Int32 texture0Loc = material->getShaderLocation(StandardUniform::Texture0);
         if (texture0Loc >= 0) {
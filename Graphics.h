@@ -24,6 +24,7 @@ namespace Core {
     class Shader;
     class AttributeArrayGPUStorage;
     class IndexBuffer;
+    class MatrixBuffer;
     class Renderer;
     class Scene;
     class ShaderManager;
@@ -48,6 +49,9 @@ namespace Core {
         WeakPointer<CubeTexture> getPlaceHolderCubeTexture();
 
         void setSharedRenderState(Bool shared);
+        Bool supportsGeometryShaders() const;
+        Bool supportsInstancing() const;
+        Bool supportsParallelShaderCompile() const;
 
         virtual WeakPointer<Renderer> getRenderer() = 0;
         virtual void preRender() = 0;
@@ -69,6 +73,7 @@ namespace Core {
 
         virtual void drawBoundVertexBuffer(UInt32 vertexCount, PrimitiveType primitiveType = PrimitiveType::Triangles) = 0;
         virtual void drawBoundVertexBuffer(UInt32 vertexCount, WeakPointer<IndexBuffer> indices, PrimitiveType primitiveType = PrimitiveType::Triangles) = 0;
+        virtual void drawBoundVertexBufferInstanced(UInt32 vertexCount, UInt32 instanceCount, PrimitiveType primitiveType = PrimitiveType::Triangles) = 0;
 
         virtual ShaderManager& getShaderManager() = 0;
 
@@ -126,6 +131,7 @@ namespace Core {
 
         virtual std::shared_ptr<AttributeArrayGPUStorage> createGPUStorage(UInt32 size, UInt32 componentCount, AttributeType type, Bool normalize) = 0;
         virtual std::shared_ptr<IndexBuffer> createIndexBuffer(UInt32 size) = 0;
+        virtual std::shared_ptr<MatrixBuffer> createMatrixBuffer(UInt32 capacity) = 0;
         void addCoreObjectReference(std::shared_ptr<CoreObject>, CoreObjectReferenceManager::OwnerType ownerType);
 
         CoreObjectReferenceManager objectManager;
@@ -133,5 +139,9 @@ namespace Core {
         WeakPointer<Texture2D> placeHolderTexture2D;
         WeakPointer<CubeTexture> placeHolderCubeTexture;
         Bool sharedRenderState;
+        // set by the backend during init() from what the device reports
+        Bool geometryShadersSupported;
+        Bool instancingSupported;
+        Bool parallelShaderCompileSupported;
     };
 }
\ No newline at end of file
@@ -0,0 +1,40 @@
+#include "AttributeArrayGPUStorageNull.h"
+#include "GraphicsNull.h"
+
+namespace Core {
+
+    AttributeArrayGPUStorageNull::AttributeArrayGPUStorageNull(UInt32 size, UInt32 componentCount):
+        size(size), componentCount(componentCount) {
+        this->bufferID = GraphicsNull::generateObjectName();
+    }
+
+    AttributeArrayGPUStorageNull::~AttributeArrayGPUStorageNull() {
+    }
+
+    Int32 AttributeArrayGPUStorageNull::getBufferID() const {
+        return this->bufferID;
+    }
+
+    void AttributeArrayGPUStorageNull::enableAndSendToActiveShader(UInt32 location) {
+        GraphicsNull::getCommandLog().record(GraphicsCommandType::BindVertexAttribute, 0, location, this->bufferID, this->componentCount, 0);
+    }
+
+    void AttributeArrayGPUStorageNull::bind() {
+    }
+
+    void AttributeArrayGPUStorageNull::enableAndSendElementToActiveShader(UInt32 location, UInt32 componentCount, AttributeType type,
+                                                                          Bool normalize, UInt32 stride, UInt32 offset) {
+        GraphicsNull::getCommandLog().record(GraphicsCommandType::BindVertexAttribute, 0, location, this->bufferID, componentCount, offset);
+    }
+
+    void AttributeArrayGPUStorageNull::disable(UInt32 location) {
+    }
+
+    void AttributeArrayGPUStorageNull::setDivisor(UInt32 location, UInt32 divisor) {
+        GraphicsNull::getCommandLog().record(GraphicsCommandType::SetAttributeDivisor, 0, location, this->bufferID, divisor);
+    }
+
+    void AttributeArrayGPUStorageNull::updateBufferData(void * data) {
+        GraphicsNull::getCommandLog().record(GraphicsCommandType::Upload, (UInt8)GraphicsResourceKind::VertexBuffer, this->bufferID, this->size);
+    }
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "../geometry/AttributeArrayGPUStorage.h"
+#include "../common/types.h"
+
+namespace Core {
+
+    class AttributeArrayGPUStorageNull final: public AttributeArrayGPUStorage {
+    public:
+        AttributeArrayGPUStorageNull(UInt32 size, UInt32 componentCount);
+        ~AttributeArrayGPUStorageNull() override;
+
+        Int32 getBufferID() const override;
+        void enableAndSendToActiveShader(UInt32 location) override;
+        void bind() override;
+        void enableAndSendElementToActiveShader(UInt32 location, UInt32 componentCount, AttributeType type,
+                                                Bool normalize, UInt32 stride, UInt32 offset) override;
+        void disable(UInt32 location) override;
+        void setDivisor(UInt32 location, UInt32 divisor) override;
+        void updateBufferData(void * data) override;
+
+    private:
+        UInt32 size;
+        UInt32 componentCount;
+        UInt32 bufferID;
+    };
+}
@@ -0,0 +1,47 @@
+#include "CubeTextureNull.h"
+#include "GraphicsNull.h"
+#include "../common/Exception.h"
+
+namespace Core {
+
+    CubeTextureNull::CubeTextureNull(const TextureAttributes& attributes): CubeTexture(attributes) {
+
+    }
+
+    CubeTextureNull::~CubeTextureNull() {
+
+    }
+
+    void CubeTextureNull::buildFromImages(WeakPointer<StandardImage> front, WeakPointer<StandardImage> back,
+                                          WeakPointer<StandardImage> top, WeakPointer<StandardImage> bottom,
+                                          WeakPointer<StandardImage> left, WeakPointer<StandardImage> right) {
+        if (this->attributes.Format != TextureFormat::RGBA8) {
+            throw TextureException("CubeTextureNull::build() -> Textures built with StandardImage must have type RGBA8.");
+        }
+        this->setupTexture(front->getWidth(), front->getHeight(), true);
+    }
+
+    void CubeTextureNull::buildFromImages(WeakPointer<HDRImage> front, WeakPointer<HDRImage> back,
+                                          WeakPointer<HDRImage> top, WeakPointer<HDRImage> bottom,
+                                          WeakPointer<HDRImage> left, WeakPointer<HDRImage> right) {
+        if (this->attributes.Format != TextureFormat::RGBA16F && this->attributes.Format != TextureFormat::RGBA32F) {
+            throw TextureException("CubeTextureNull::build() -> Textures built with HDRImage must have type RGBA16F or RGBA32F.");
+        }
+        this->setupTexture(front->getWidth(), front->getHeight(), true);
+    }
+
+    void CubeTextureNull::buildEmpty(UInt32 width, UInt32 height) {
+        this->setupTexture(width, height, false);
+    }
+
+    void CubeTextureNull::updateMipMaps() {
+    }
+
+    void CubeTextureNull::setupTexture(UInt32 width, UInt32 height, Bool hasData) {
+        // like the GL textures, every build replaces the texture object
+        this->textureId = GraphicsNull::generateObjectName();
+        UInt32 byteCount = hasData ? 6 * GraphicsNull::getTextureByteCount(this->attributes.Format, width, height, 1) : 0;
+        GraphicsNull::getCommandLog().record(GraphicsCommandType::Upload, (UInt8)GraphicsResourceKind::CubeTexture,
+                                             this->textureId, byteCount, width, height);
+    }
+}
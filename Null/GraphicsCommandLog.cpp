@@ -0,0 +1,196 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "GraphicsCommandLog.h"
+#include "../common/Exception.h"
+
+namespace Core {
+
+    static const UInt32 GraphicsCommandLogMagic = 0x444D4347; // "GCMD"
+    static const UInt32 GraphicsCommandLogVersion = 1;
+    // type, detail, two bytes of padding and four values
+    static const UInt32 GraphicsCommandRecordSize = 20;
+
+    GraphicsCommandLog::Counters::Counters() {
+        for (UInt32 i = 0; i < (UInt32)GraphicsCommandType::_Count; i++) this->commandCounts[i] = 0;
+        this->vertexCount = 0;
+        this->instanceCount = 0;
+        this->uploadedBytes = 0;
+    }
+
+    UInt32 GraphicsCommandLog::Counters::getCommandCount(GraphicsCommandType type) const {
+        return this->commandCounts[(UInt32)type];
+    }
+
+    UInt32 GraphicsCommandLog::Counters::getDrawCallCount() const {
+        return this->getCommandCount(GraphicsCommandType::Draw) + this->getCommandCount(GraphicsCommandType::DrawIndexed) +
+               this->getCommandCount(GraphicsCommandType::DrawInstanced);
+    }
+
+    GraphicsCommandLog::GraphicsCommandLog() {
+        this->recordingEnabled = true;
+    }
+
+    /*
+     * Turn storing of the commands on or off. The counters are kept up to date either way.
+     */
+    void GraphicsCommandLog::setRecordingEnabled(Bool enabled) {
+        this->recordingEnabled = enabled;
+    }
+
+    Bool GraphicsCommandLog::isRecordingEnabled() const {
+        return this->recordingEnabled;
+    }
+
+    void GraphicsCommandLog::record(GraphicsCommandType type, UInt8 detail, UInt32 value0, UInt32 value1, UInt32 value2, UInt32 value3) {
+        GraphicsCommand command;
+        command.type = type;
+        command.detail = detail;
+        command.values[0] = value0;
+        command.values[1] = value1;
+        command.values[2] = value2;
+        command.values[3] = value3;
+        this->record(command);
+    }
+
+    void GraphicsCommandLog::record(const GraphicsCommand& command) {
+        this->counters.commandCounts[(UInt32)command.type]++;
+        switch (command.type) {
+            case GraphicsCommandType::Draw:
+            case GraphicsCommandType::DrawIndexed:
+                this->counters.vertexCount += command.values[0];
+                this->counters.instanceCount++;
+            break;
+            case GraphicsCommandType::DrawInstanced:
+                this->counters.vertexCount += (UInt64)command.values[0] * command.values[2];
+                this->counters.instanceCount += command.values[2];
+            break;
+            case GraphicsCommandType::Upload:
+                this->counters.uploadedBytes += command.values[1];
+            break;
+            default:
+            break;
+        }
+        if (this->recordingEnabled) this->commands.push_back(command);
+    }
+
+    void GraphicsCommandLog::recordState(GraphicsStateType state, UInt32 value0, UInt32 value1, UInt32 value2, UInt32 value3) {
+        this->record(GraphicsCommandType::SetState, (UInt8)state, value0, value1, value2, value3);
+    }
+
+    void GraphicsCommandLog::clear() {
+        this->commands.clear();
+        this->counters = Counters();
+    }
+
+    UInt32 GraphicsCommandLog::getCommandCount() const {
+        return (UInt32)this->commands.size();
+    }
+
+    const GraphicsCommand& GraphicsCommandLog::getCommand(UInt32 index) const {
+        if (index >= this->commands.size()) {
+            throw OutOfRangeException("GraphicsCommandLog::getCommand() -> 'index' is out of range.");
+        }
+        return this->commands[index];
+    }
+
+    const GraphicsCommandLog::Counters& GraphicsCommandLog::getCounters() const {
+        return this->counters;
+    }
+
+    void GraphicsCommandLog::replay(ReplayCallback callback) const {
+        this->replay(callback, 0, this->getCommandCount());
+    }
+
+    /*
+     * Pass [count] recorded commands, starting at [first], to [callback] in the order they were recorded.
+     */
+    void GraphicsCommandLog::replay(ReplayCallback callback, UInt32 first, UInt32 count) const {
+        if (first > this->commands.size() || count > this->commands.size() - first) {
+            throw OutOfRangeException("GraphicsCommandLog::replay() -> Range is out of bounds.");
+        }
+        for (UInt32 i = first; i < first + count; i++) {
+            callback(this->commands[i]);
+        }
+    }
+
+    /*
+     * Write the recorded commands to [path], so that they can be loaded and replayed elsewhere.
+     */
+    Bool GraphicsCommandLog::save(const std::string& path) const {
+        std::vector<Byte> buffer;
+        buffer.reserve(12 + this->commands.size() * GraphicsCommandRecordSize);
+        auto append = [&buffer](const void* data, UInt32 size) {
+            const Byte* bytes = (const Byte*)data;
+            buffer.insert(buffer.end(), bytes, bytes + size);
+        };
+        UInt32 count = (UInt32)this->commands.size();
+        append(&GraphicsCommandLogMagic, sizeof(UInt32));
+        append(&GraphicsCommandLogVersion, sizeof(UInt32));
+        append(&count, sizeof(UInt32));
+        for (const GraphicsCommand& command : this->commands) {
+            Byte header[4] = {(Byte)command.type, command.detail, 0, 0};
+            append(header, 4);
+            append(command.values, sizeof(UInt32) * 4);
+        }
+
+        FILE* file = fopen(path.c_str(), "wb");
+        if (file == nullptr) return false;
+        Bool success = fwrite(buffer.data(), 1, buffer.size(), file) == buffer.size();
+        return fclose(file) == 0 && success;
+    }
+
+    /*
+     * Replace the log with the commands saved to [path]. The counters are rebuilt from the loaded commands.
+     * Returns false, leaving the log unchanged, if the file can't be read or isn't a valid command log.
+     */
+    Bool GraphicsCommandLog::load(const std::string& path) {
+        FILE* file = fopen(path.c_str(), "rb");
+        if (file == nullptr) return false;
+        UInt32 header[3];
+        Bool success = fread(header, sizeof(UInt32), 3, file) == 3 &&
+                       header[0] == GraphicsCommandLogMagic && header[1] == GraphicsCommandLogVersion;
+        // the record count must fit in the rest of the file before anything is allocated for it
+        long dataStart = success ? ftell(file) : -1;
+        success = dataStart >= 0 && fseek(file, 0, SEEK_END) == 0;
+        long fileSize = success ? ftell(file) : -1;
+        success = fileSize >= dataStart && fseek(file, dataStart, SEEK_SET) == 0 &&
+                  (UInt64)header[2] <= (UInt64)(fileSize - dataStart) / GraphicsCommandRecordSize;
+        std::vector<Byte> buffer;
+        if (success) {
+            buffer.resize((size_t)header[2] * GraphicsCommandRecordSize);
+            success = fread(buffer.data(), 1, buffer.size(), file) == buffer.size();
+        }
+        fclose(file);
+        if (!success) return false;
+
+        std::vector<GraphicsCommand> loaded(header[2]);
+        for (UInt32 i = 0; i < header[2]; i++) {
+            const Byte* record = buffer.data() + (size_t)i * GraphicsCommandRecordSize;
+            if (record[0] >= (Byte)GraphicsCommandType::_Count) return false;
+            loaded[i].type = (GraphicsCommandType)record[0];
+            loaded[i].detail = record[1];
+            memcpy(loaded[i].values, record + 4, sizeof(UInt32) * 4);
+        }
+
+        Bool recording = this->recordingEnabled;
+        this->clear();
+        this->recordingEnabled = true;
+        this->commands.reserve(loaded.size());
+        for (const GraphicsCommand& command : loaded) this->record(command);
+        this->recordingEnabled = recording;
+        return true;
+    }
+
+    UInt32 GraphicsCommandLog::getRealBits(Real value) {
+        UInt32 bits = 0;
+        memcpy(&bits, &value, sizeof(UInt32));
+        return bits;
+    }
+
+    Real GraphicsCommandLog::getReal(UInt32 bits) {
+        Real value = 0.0f;
+        memcpy(&value, &bits, sizeof(UInt32));
+        return value;
+    }
+}
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "../common/types.h"
+
+namespace Core {
+
+    enum class GraphicsCommandType : UInt8 {
+        BeginFrame = 0,
+        EndFrame = 1,
+        // values: vertex count, primitive type
+        Draw = 2,
+        // values: index count, primitive type, index buffer
+        DrawIndexed = 3,
+        // values: vertex count, primitive type, instance count
+        DrawInstanced = 4,
+        // detail: GraphicsStateType; values: the new state
+        SetState = 5,
+        // values: horizontal offset, vertical offset, width, height
+        SetViewport = 6,
+        // values: GraphicsCommandLog::ClearColor | ClearDepth | ClearStencil
+        Clear = 7,
+        // values: program
+        ActivateShader = 8,
+        // values: location, component count
+        SetUniform = 9,
+        // detail: GraphicsResourceKind; values: sampler slot, texture
+        BindTexture = 10,
+        // values: location, buffer, component count, byte offset
+        BindVertexAttribute = 11,
+        // detail: GraphicsResourceKind; values: resource, byte count, width, height
+        Upload = 12,
+        // values: render target, mip level, cube side + 1 (0 for the whole target)
+        ActivateRenderTarget = 13,
+        // values: source render target, destination render target, cube face + 1 (0 for none), color | depth << 1
+        Blit = 14,
+        // values: program
+        BuildShader = 15,
+        // values: location, buffer, divisor
+        SetAttributeDivisor = 16,
+        _Count = 17
+    };
+
+    enum class GraphicsStateType : UInt8 {
+        None = 0,
+        Blending = 1,
+        BlendingEquation = 2,
+        BlendingFactors = 3,
+        ColorWrite = 4,
+        ClearColor = 5,
+        RenderStyle = 6,
+        DepthWrite = 7,
+        DepthTest = 8,
+        DepthFunction = 9,
+        StencilTest = 10,
+        StencilWriteMask = 11,
+        StencilFunction = 12,
+        StencilOperation = 13,
+        FaceCulling = 14,
+        CullFace = 15,
+        LineSize = 16
+    };
+
+    enum class GraphicsResourceKind : UInt8 {
+        None = 0,
+        VertexBuffer = 1,
+        IndexBuffer = 2,
+        MatrixBuffer = 3,
+        Texture2D = 4,
+        CubeTexture = 5
+    };
+
+    // One recorded call into the graphics system. Real values (clear color, line size) are stored as their
+    // bit patterns.
+    class GraphicsCommand {
+    public:
+        GraphicsCommandType type;
+        UInt8 detail;
+        UInt32 values[4];
+    };
+
+    // The command stream recorded by GraphicsNull, together with running totals over it. Storing the commands
+    // themselves can be turned off when only the totals are of interest (e.g. when benchmarking the CPU side
+    // of rendering over many frames).
+    class GraphicsCommandLog final {
+    public:
+        typedef std::function<void(const GraphicsCommand&)> ReplayCallback;
+
+        static const UInt32 ClearColor = 1;
+        static const UInt32 ClearDepth = 2;
+        static const UInt32 ClearStencil = 4;
+
+        class Counters {
+        public:
+            Counters();
+            UInt32 getCommandCount(GraphicsCommandType type) const;
+            UInt32 getDrawCallCount() const;
+
+            UInt32 commandCounts[(UInt32)GraphicsCommandType::_Count];
+            // vertices (or indices) submitted, over all instances
+            UInt64 vertexCount;
+            UInt64 instanceCount;
+            UInt64 uploadedBytes;
+        };
+
+        GraphicsCommandLog();
+
+        void setRecordingEnabled(Bool enabled);
+        Bool isRecordingEnabled() const;
+        void record(GraphicsCommandType type, UInt8 detail, UInt32 value0 = 0, UInt32 value1 = 0, UInt32 value2 = 0, UInt32 value3 = 0);
+        void record(const GraphicsCommand& command);
+        void recordState(GraphicsStateType state, UInt32 value0, UInt32 value1 = 0, UInt32 value2 = 0, UInt32 value3 = 0);
+        void clear();
+
+        UInt32 getCommandCount() const;
+        const GraphicsCommand& getCommand(UInt32 index) const;
+        const Counters& getCounters() const;
+        void replay(ReplayCallback callback) const;
+        void replay(ReplayCallback callback, UInt32 first, UInt32 count) const;
+        Bool save(const std::string& path) const;
+        Bool load(const std::string& path);
+
+        static UInt32 getRealBits(Real value);
+        static Real getReal(UInt32 bits);
+
+    private:
+        Bool recordingEnabled;
+        std::vector<GraphicsCommand> commands;
+        Counters counters;
+    };
+}
@@ -0,0 +1,428 @@
+#include "../common/Exception.h"
+#include "../Engine.h"
+#include "GraphicsNull.h"
+#include "AttributeArrayGPUStorageNull.h"
+#include "CubeTextureNull.h"
+#include "IndexBufferNull.h"
+#include "MatrixBufferNull.h"
+#include "RendererNull.h"
+#include "ShaderNull.h"
+#include "Texture2DNull.h"
+#include "RenderTarget2DNull.h"
+#include "RenderTargetCubeNull.h"
+
+namespace Core {
+
+    GraphicsNull::GraphicsNull() {
+        this->renderStyle = RenderStyle::Fill;
+    }
+
+    GraphicsNull::~GraphicsNull() {
+    }
+
+    void GraphicsNull::init() {
+        Graphics::init();
+
+        // nothing is executed, so every feature the renderer can make use of is reported as present
+        this->geometryShadersSupported = true;
+        this->instancingSupported = true;
+        this->parallelShaderCompileSupported = true;
+        this->defaultRenderTarget = this->createDefaultRenderTarget();
+        this->currentRenderTarget = this->defaultRenderTarget;
+        this->shaderDirectory.init();
+        const std::string& preprocessedShaderPath = Engine::getPreprocessedShaderPath();
+        if (preprocessedShaderPath.size() > 0) this->shaderDirectory.loadPreprocessedSources(preprocessedShaderPath);
+
+        this->renderer = this->createRenderer();
+    }
+
+    WeakPointer<Renderer> GraphicsNull::getRenderer() {
+        return std::static_pointer_cast<Renderer>(this->renderer);
+    }
+
+    void GraphicsNull::preRender() {
+        getCommandLog().record(GraphicsCommandType::BeginFrame, 0);
+    }
+
+    void GraphicsNull::postRender() {
+        getCommandLog().record(GraphicsCommandType::EndFrame, 0);
+    }
+
+    WeakPointer<Texture2D> GraphicsNull::createTexture2D(const TextureAttributes& attributes) {
+        Texture2DNull* newTexturePtr = new(std::nothrow) Texture2DNull(attributes);
+        if (newTexturePtr == nullptr) {
+            throw AllocationException("GraphicsNull::createTexture2D -> Unable to allocate new Texture2DNull");
+        }
+        std::shared_ptr<Texture2DNull> newTexture = std::shared_ptr<Texture2DNull>(newTexturePtr);
+        this->addCoreObjectReference(newTexture, CoreObjectReferenceManager::OwnerType::Single);
+        return std::static_pointer_cast<Texture2D>(newTexture);
+    }
+
+    WeakPointer<CubeTexture> GraphicsNull::createCubeTexture(const TextureAttributes& attributes) {
+        CubeTextureNull* newTexturePtr = new(std::nothrow) CubeTextureNull(attributes);
+        if (newTexturePtr == nullptr) {
+            throw AllocationException("GraphicsNull::createCubeTexture -> Unable to allocate new CubeTextureNull");
+        }
+        std::shared_ptr<CubeTextureNull> newTexture = std::shared_ptr<CubeTextureNull>(newTexturePtr);
+        this->addCoreObjectReference(newTexture, CoreObjectReferenceManager::OwnerType::Single);
+        return std::static_pointer_cast<CubeTexture>(newTexture);
+    }
+
+    WeakPointer<Shader> GraphicsNull::createShader(const std::string& vertex, const std::string& fragment) {
+        ShaderNull* shaderPtr = new(std::nothrow) ShaderNull(vertex, fragment);
+        return this->addShader(shaderPtr);
+    }
+
+    WeakPointer<Shader> GraphicsNull::createShader(const std::string& vertex, const std::string& geometry, const std::string& fragment) {
+        ShaderNull* shaderPtr = new(std::nothrow) ShaderNull(vertex, geometry, fragment);
+        return this->addShader(shaderPtr);
+    }
+
+    WeakPointer<Shader> GraphicsNull::createShader(const char vertex[], const char fragment[]) {
+        ShaderNull* shaderPtr = new(std::nothrow) ShaderNull(vertex, fragment);
+        return this->addShader(shaderPtr);
+    }
+
+    WeakPointer<Shader> GraphicsNull::createShader(const char vertex[], const char geometry[], const char fragment[]) {
+        ShaderNull* shaderPtr = new(std::nothrow) ShaderNull(vertex, geometry, fragment);
+        return this->addShader(shaderPtr);
+    }
+
+    WeakPointer<Shader> GraphicsNull::addShader(ShaderNull* shaderPtr) {
+        if (shaderPtr == nullptr) {
+            throw AllocationException("GraphicsNull::addShader -> Could not allocate new shader.");
+        }
+        std::shared_ptr<ShaderNull> spShaderNull(shaderPtr);
+        this->addCoreObjectReference(spShaderNull, CoreObjectReferenceManager::OwnerType::Single);
+        std::shared_ptr<Shader> spShader = std::static_pointer_cast<Shader>(spShaderNull);
+        return spShader;
+    }
+
+    void GraphicsNull::activateShader(WeakPointer<Shader> shader) {
+        Graphics::activateShader(shader);
+        getCommandLog().record(GraphicsCommandType::ActivateShader, 0, shader->getProgram());
+    }
+
+    std::shared_ptr<AttributeArrayGPUStorage> GraphicsNull::createGPUStorage(UInt32 size, UInt32 componentCount, AttributeType type, Bool normalize) {
+        AttributeArrayGPUStorageNull* gpuStoragePtr = new (std::nothrow) AttributeArrayGPUStorageNull(size, componentCount);
+        if (gpuStoragePtr == nullptr) {
+            throw AllocationException("GraphicsNull::createGPUStorage() -> Unable to allocate gpu buffer.");
+        }
+        std::shared_ptr<AttributeArrayGPUStorageNull> spGpuStorage(gpuStoragePtr);
+        return spGpuStorage;
+    }
+
+    std::shared_ptr<IndexBuffer> GraphicsNull::createIndexBuffer(UInt32 size) {
+        IndexBufferNull* indexBufferPtr = new (std::nothrow) IndexBufferNull(size);
+        if (indexBufferPtr == nullptr) {
+            throw AllocationException("GraphicsNull::createIndexBuffer() -> Unable to allocate index buffer.");
+        }
+        indexBufferPtr->initIndices();
+        std::shared_ptr<IndexBufferNull> spIndexBuffer(indexBufferPtr);
+        return spIndexBuffer;
+    }
+
+    std::shared_ptr<MatrixBuffer> GraphicsNull::createMatrixBuffer(UInt32 capacity) {
+        MatrixBufferNull* matrixBufferPtr = new (std::nothrow) MatrixBufferNull(capacity);
+        if (matrixBufferPtr == nullptr) {
+            throw AllocationException("GraphicsNull::createMatrixBuffer() -> Unable to allocate matrix buffer.");
+        }
+        std::shared_ptr<MatrixBufferNull> spMatrixBuffer(matrixBufferPtr);
+        return spMatrixBuffer;
+    }
+
+    void GraphicsNull::drawBoundVertexBuffer(UInt32 vertexCount, PrimitiveType primitiveType) {
+        getCommandLog().record(GraphicsCommandType::Draw, 0, vertexCount, (UInt32)primitiveType);
+    }
+
+    void GraphicsNull::drawBoundVertexBuffer(UInt32 vertexCount, WeakPointer<IndexBuffer> indices, PrimitiveType primitiveType) {
+        getCommandLog().record(GraphicsCommandType::DrawIndexed, 0, vertexCount, (UInt32)primitiveType, (UInt32)indices->getBufferID());
+    }
+
+    void GraphicsNull::drawBoundVertexBufferInstanced(UInt32 vertexCount, UInt32 instanceCount, PrimitiveType primitiveType) {
+        getCommandLog().record(GraphicsCommandType::DrawInstanced, 0, vertexCount, (UInt32)primitiveType, instanceCount);
+    }
+
+    ShaderManager& GraphicsNull::getShaderManager() {
+        return this->shaderDirectory;
+    }
+
+    void GraphicsNull::setBlendingEnabled(Bool enabled) {
+        getCommandLog().recordState(GraphicsStateType::Blending, enabled ? 1 : 0);
+    }
+
+    void GraphicsNull::setBlendingEquation(RenderState::BlendingEquation equation) {
+        getCommandLog().recordState(GraphicsStateType::BlendingEquation, (UInt32)equation);
+    }
+
+    void GraphicsNull::setBlendingFactors(RenderState::BlendingFactor source, RenderState::BlendingFactor dest) {
+        getCommandLog().recordState(GraphicsStateType::BlendingFactors, (UInt32)source, (UInt32)dest, (UInt32)source, (UInt32)dest);
+    }
+
+    void GraphicsNull::setBlendingFactors(RenderState::BlendingFactor source, RenderState::BlendingFactor sourceAlpha,
+                                          RenderState::BlendingFactor dest, RenderState::BlendingFactor destAlpha) {
+        getCommandLog().recordState(GraphicsStateType::BlendingFactors, (UInt32)source, (UInt32)dest, (UInt32)sourceAlpha, (UInt32)destAlpha);
+    }
+
+    WeakPointer<RenderTarget2D> GraphicsNull::createRenderTarget2D(Bool hasColor, Bool hasDepth, Bool enableStencilBuffer,
+                                                                   const TextureAttributes& colorTextureAttributes,
+                                                                   const TextureAttributes& depthTextureAttributes,
+                                                                   const Vector2u& size) {
+
+        RenderTarget2DNull* renderTargetPtr = new(std::nothrow) RenderTarget2DNull(hasColor, hasDepth, enableStencilBuffer,
+                                                                                   colorTextureAttributes, depthTextureAttributes, size);
+        if (renderTargetPtr == nullptr) {
+            throw AllocationException("GraphicsNull::createRenderTarget2D -> Unable to allocate render target.");
+        }
+        std::shared_ptr<RenderTarget2DNull> target(renderTargetPtr);
+        target->init();
+        this->addCoreObjectReference(target, CoreObjectReferenceManager::OwnerType::Single);
+
+        WeakPointer<RenderTarget2DNull> weakPtr = target;
+        return weakPtr;
+    }
+
+    WeakPointer<RenderTargetCube> GraphicsNull::createRenderTargetCube(Bool hasColor, Bool hasDepth, Bool enableStencilBuffer,
+                                                                       const TextureAttributes& colorTextureAttributes,
+                                                                       const TextureAttributes& depthTextureAttributes, const Vector2u& size) {
+
+        RenderTargetCubeNull* renderTargetPtr = new(std::nothrow) RenderTargetCubeNull(hasColor, hasDepth, enableStencilBuffer,
+                                                                                       colorTextureAttributes, depthTextureAttributes, size);
+        if (renderTargetPtr == nullptr) {
+            throw AllocationException("GraphicsNull::createRenderTargetCube -> Unable to allocate render target.");
+        }
+        std::shared_ptr<RenderTargetCubeNull> target(renderTargetPtr);
+        target->init();
+        this->addCoreObjectReference(target, CoreObjectReferenceManager::OwnerType::Single);
+
+        WeakPointer<RenderTargetCubeNull> weakPtr = target;
+        return weakPtr;
+    }
+
+    void GraphicsNull::setColorWriteEnabled(Bool enabled) {
+        getCommandLog().recordState(GraphicsStateType::ColorWrite, enabled ? 1 : 0);
+    }
+
+    void GraphicsNull::setClearColor(Color color) {
+        getCommandLog().recordState(GraphicsStateType::ClearColor, GraphicsCommandLog::getRealBits(color.r), GraphicsCommandLog::getRealBits(color.g),
+                                    GraphicsCommandLog::getRealBits(color.b), GraphicsCommandLog::getRealBits(color.a));
+    }
+
+    void GraphicsNull::clearActiveRenderTarget(Bool colorBuffer, Bool depthBuffer, Bool stencilBuffer) {
+        UInt32 mask = 0;
+        if (colorBuffer) mask |= GraphicsCommandLog::ClearColor;
+        if (depthBuffer) mask |= GraphicsCommandLog::ClearDepth;
+        if (stencilBuffer) mask |= GraphicsCommandLog::ClearStencil;
+        getCommandLog().record(GraphicsCommandType::Clear, 0, mask);
+    }
+
+    void GraphicsNull::setDefaultRenderTargetToCurrent() {
+    }
+
+    WeakPointer<RenderTarget> GraphicsNull::getDefaultRenderTarget() {
+        return this->defaultRenderTarget;
+    }
+
+    WeakPointer<RenderTarget> GraphicsNull::getCurrentRenderTarget() {
+        return this->currentRenderTarget;
+    }
+
+    Bool GraphicsNull::activateRenderTarget(WeakPointer<RenderTarget> target) {
+        if (!target.isValid()) {
+            throw NullPointerException("GraphicsNull::activateRenderTarget -> 'target' is not valid.");
+        }
+
+        UInt32 targetName = getTargetName(target);
+        // prevent activating the currently active target.
+        if (this->currentRenderTarget.isValid() && getTargetName(this->currentRenderTarget) == targetName) return true;
+
+        getCommandLog().record(GraphicsCommandType::ActivateRenderTarget, 0, targetName);
+        this->currentRenderTarget = target;
+
+        return true;
+    }
+
+    Bool GraphicsNull::activateRenderTarget2DMipLevel(UInt32 mipLevel) {
+        if (this->currentRenderTarget.isValid()) {
+            RenderTarget2DNull * currentTarget2DNull = dynamic_cast<RenderTarget2DNull *>(this->currentRenderTarget.get());
+            if (currentTarget2DNull == nullptr) {
+                throw Exception("GraphicsNull::activateRenderTarget2DMipLevel -> Current render target is not a valid null render target.");
+            }
+
+            for (UInt32 i = 0; i < currentTarget2DNull->getColorTextureCount(); i++) {
+                if (currentTarget2DNull->getColorTexture(i).isValid()) {
+                    getCommandLog().record(GraphicsCommandType::ActivateRenderTarget, 0, currentTarget2DNull->getTargetName(), mipLevel);
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        return false;
+    }
+
+    Bool GraphicsNull::activateCubeRenderTargetSide(CubeTextureSide side, UInt32 mipLevel) {
+        if (this->currentRenderTarget.isValid()) {
+            RenderTargetCubeNull * currentTargetCubeNull = dynamic_cast<RenderTargetCubeNull *>(this->currentRenderTarget.get());
+            if (currentTargetCubeNull == nullptr) {
+                throw Exception("GraphicsNull::activateCubeRenderTargetSide -> Current render target is not a valid null render target.");
+            }
+
+            getCommandLog().record(GraphicsCommandType::ActivateRenderTarget, 0, currentTargetCubeNull->getTargetName(), mipLevel, (UInt32)side + 1);
+            return true;
+        }
+
+        return false;
+    }
+
+    void GraphicsNull::updateDefaultRenderTargetSize(Vector2u size) {
+        this->defaultRenderTarget->size = size;
+    }
+
+    void GraphicsNull::updateDefaultRenderTargetViewport(Vector4u viewport) {
+        this->defaultRenderTarget->viewport = viewport;
+    }
+
+    Vector4u GraphicsNull::getViewport() {
+        return this->_viewport;
+    }
+
+    void GraphicsNull::setViewport(UInt32 hOffset, UInt32 vOffset, UInt32 viewPortWidth, UInt32 viewPortHeight) {
+        getCommandLog().record(GraphicsCommandType::SetViewport, 0, hOffset, vOffset, viewPortWidth, viewPortHeight);
+        this->_viewport.set(hOffset, vOffset, viewPortWidth, viewPortHeight);
+    }
+
+    void GraphicsNull::setRenderStyle(RenderStyle style) {
+        getCommandLog().recordState(GraphicsStateType::RenderStyle, (UInt32)style);
+        this->renderStyle = style;
+    }
+
+    void GraphicsNull::setDepthWriteEnabled(Bool enabled) {
+        getCommandLog().recordState(GraphicsStateType::DepthWrite, enabled ? 1 : 0);
+    }
+
+    void GraphicsNull::setDepthTestEnabled(Bool enabled) {
+        getCommandLog().recordState(GraphicsStateType::DepthTest, enabled ? 1 : 0);
+    }
+
+    void GraphicsNull::setDepthFunction(RenderState::DepthFunction function) {
+        getCommandLog().recordState(GraphicsStateType::DepthFunction, (UInt32)function);
+    }
+
+    void GraphicsNull::setStencilTestEnabled(Bool enabled) {
+        getCommandLog().recordState(GraphicsStateType::StencilTest, enabled ? 1 : 0);
+    }
+
+    void GraphicsNull::setStencilWriteMask(UInt32 mask) {
+        getCommandLog().recordState(GraphicsStateType::StencilWriteMask, mask);
+    }
+
+    void GraphicsNull::setStencilFunction(RenderState::StencilFunction function, Int16 value, UInt16 mask) {
+        getCommandLog().recordState(GraphicsStateType::StencilFunction, (UInt32)function, (UInt32)(Int32)value, mask);
+    }
+
+    void GraphicsNull::setStencilOperation(RenderState::StencilAction sFail, RenderState::StencilAction dpFail, RenderState::StencilAction dpPass) {
+        getCommandLog().recordState(GraphicsStateType::StencilOperation, (UInt32)sFail, (UInt32)dpFail, (UInt32)dpPass);
+    }
+
+    void GraphicsNull::setFaceCullingEnabled(Bool enabled) {
+        getCommandLog().recordState(GraphicsStateType::FaceCulling, enabled ? 1 : 0);
+    }
+
+    void GraphicsNull::setCullFace(RenderState::CullFace face) {
+        getCommandLog().recordState(GraphicsStateType::CullFace, (UInt32)face);
+    }
+
+    void GraphicsNull::setRenderLineSize(Real size) {
+        getCommandLog().recordState(GraphicsStateType::LineSize, GraphicsCommandLog::getRealBits(size));
+    }
+
+    void GraphicsNull::saveState() {
+    }
+
+    void GraphicsNull::restoreState() {
+    }
+
+    void GraphicsNull::lowLevelBlit(WeakPointer<RenderTarget> source, WeakPointer<RenderTarget> destination, Int16 cubeFace, Bool includeColor, Bool includeDepth) {
+        UInt32 buffers = (includeColor ? 1 : 0) | (includeDepth ? 2 : 0);
+        UInt32 face = cubeFace >= 0 ? (UInt32)cubeFace + 1 : 0;
+        getCommandLog().record(GraphicsCommandType::Blit, 0, getTargetName(source), getTargetName(destination), face, buffers);
+    }
+
+    /*
+     * The commands recorded for the engine. Like the GL state cache, the log is shared with the objects the
+     * graphics system creates (textures, buffers and shaders), which record their own uploads and binds.
+     */
+    GraphicsCommandLog& GraphicsNull::getCommandLog() {
+        static GraphicsCommandLog commandLog;
+        return commandLog;
+    }
+
+    /*
+     * Hand out a unique, non-zero name for a texture, buffer, program or render target, the way GL would.
+     */
+    UInt32 GraphicsNull::generateObjectName() {
+        static UInt32 nextName = 1;
+        return nextName++;
+    }
+
+    /*
+     * Number of bytes an upload of [mipLevels] levels of a [width] x [height] texture in [format] would transfer.
+     */
+    UInt32 GraphicsNull::getTextureByteCount(TextureFormat format, UInt32 width, UInt32 height, UInt32 mipLevels) {
+        UInt32 bytesPerPixel = 4;
+        switch (format) {
+            case TextureFormat::RGBA16F:
+                bytesPerPixel = 8;
+            break;
+            case TextureFormat::RGBA32F:
+                bytesPerPixel = 16;
+            break;
+            case TextureFormat::DEPTH16:
+                bytesPerPixel = 2;
+            break;
+            default:
+            break;
+        }
+        UInt32 byteCount = 0;
+        for (UInt32 i = 0; i < mipLevels; i++) {
+            UInt32 levelWidth = width >> i > 0 ? width >> i : 1;
+            UInt32 levelHeight = height >> i > 0 ? height >> i : 1;
+            byteCount += levelWidth * levelHeight * bytesPerPixel;
+        }
+        return byteCount;
+    }
+
+    UInt32 GraphicsNull::getTargetName(WeakPointer<RenderTarget> target) {
+        RenderTargetNull * renderTargetNull = dynamic_cast<RenderTargetNull *>(target.get());
+        if (renderTargetNull == nullptr) {
+            throw InvalidArgumentException("GraphicsNull::getTargetName -> Render target is not a valid null render target.");
+        }
+        return renderTargetNull->getTargetName();
+    }
+
+    std::shared_ptr<RendererNull> GraphicsNull::createRenderer() {
+        RendererNull* renderPtr = new(std::nothrow) RendererNull();
+        if (renderPtr == nullptr) {
+            throw AllocationException("GraphicsNull::createRenderer -> Unable to allocate renderer.");
+        }
+        std::shared_ptr<RendererNull> renderer(renderPtr);
+        renderer->init();
+        return renderer;
+    }
+
+    std::shared_ptr<RenderTarget2DNull> GraphicsNull::createDefaultRenderTarget() {
+        TextureAttributes colorAttributes;
+        TextureAttributes depthAttributes;
+        Vector2u renderSize(1024, 1024);
+        RenderTarget2DNull* defaultTargetPtr = new(std::nothrow) RenderTarget2DNull(false, false, false, colorAttributes,
+                                                                                    depthAttributes, renderSize, 0);
+        if (defaultTargetPtr == nullptr) {
+            throw AllocationException("GraphicsNull::createDefaultRenderTarget -> Unable to allocate default render target.");
+        }
+        std::shared_ptr<RenderTarget2DNull> defaultTarget(defaultTargetPtr);
+        this->addCoreObjectReference(defaultTarget, CoreObjectReferenceManager::OwnerType::Single);
+        defaultTarget->setHDRIncapableOverride(true);
+        return defaultTarget;
+    }
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <memory>
+
+#include "../util/PersistentWeakPointer.h"
+#include "../base/CoreObjectReferenceManager.h"
+#include "../Graphics.h"
+#include "../GL/ShaderManagerGL.h"
+#include "GraphicsCommandLog.h"
+
+namespace Core {
+
+    // forward declarations
+    class Engine;
+    class RendererNull;
+    class ShaderNull;
+    class RenderTarget2DNull;
+
+    // A graphics system that executes no GPU work. Every draw, state change, upload, texture bind and render
+    // target switch is appended to a command log instead, which makes it possible to run (and time) the CPU
+    // side of rendering without a GL context, and to inspect or replay what a frame would have submitted.
+    // Shader sources come from the GL shader manager; GLSL is parsed only far enough to resolve the uniform
+    // and attribute locations that the shaders declare.
+    class GraphicsNull final : public Graphics {
+        friend class Engine;
+
+    public:
+        ~GraphicsNull() override;
+        void init() override;
+        WeakPointer<Renderer> getRenderer() override;
+        void preRender() override;
+        void postRender() override;
+
+        void setViewport(UInt32 hOffset, UInt32 vOffset, UInt32 viewPortWidth, UInt32 viewPortHeight) override;
+        Vector4u getViewport() override;
+
+        WeakPointer<Texture2D> createTexture2D(const TextureAttributes& attributes) override;
+        WeakPointer<CubeTexture> createCubeTexture(const TextureAttributes& attributes) override;
+
+        WeakPointer<Shader> createShader(const std::string& vertex, const std::string& fragment) override;
+        WeakPointer<Shader> createShader(const std::string& vertex, const std::string& geometry, const std::string& fragment) override;
+        WeakPointer<Shader> createShader(const char vertex[], const char fragment[]) override;
+        WeakPointer<Shader> createShader(const char vertex[], const char geometry[], const char fragment[]) override;
+        void activateShader(WeakPointer<Shader> shader) override;
+
+        void drawBoundVertexBuffer(UInt32 vertexCount, PrimitiveType primitiveType = PrimitiveType::Triangles) override;
+        void drawBoundVertexBuffer(UInt32 vertexCount, WeakPointer<IndexBuffer> indices, PrimitiveType primitiveType = PrimitiveType::Triangles) override;
+        void drawBoundVertexBufferInstanced(UInt32 vertexCount, UInt32 instanceCount, PrimitiveType primitiveType = PrimitiveType::Triangles) override;
+
+        ShaderManager& getShaderManager() override;
+
+        void setBlendingEnabled(Bool enabled) override;
+        void setBlendingEquation(RenderState::BlendingEquation) override;
+        void setBlendingFactors(RenderState::BlendingFactor source, RenderState::BlendingFactor dest) override;
+        void setBlendingFactors(RenderState::BlendingFactor source, RenderState::BlendingFactor sourceAlpha,
+                                RenderState::BlendingFactor dest, RenderState::BlendingFactor destAlpha) override;
+
+        WeakPointer<RenderTarget2D> createRenderTarget2D(Bool hasColor, Bool hasDepth, Bool enableStencilBuffer,
+                                                         const TextureAttributes& colorTextureAttributes,
+                                                         const TextureAttributes& depthTextureAttributes, const Vector2u& size) override;
+        WeakPointer<RenderTargetCube> createRenderTargetCube(Bool hasColor, Bool hasDepth, Bool enableStencilBuffer,
+                                                             const TextureAttributes& colorTextureAttributes,
+                                                             const TextureAttributes& depthTextureAttributes, const Vector2u& size) override;
+
+        void setColorWriteEnabled(Bool enabled) override;
+        void setClearColor(Color color) override;
+        void clearActiveRenderTarget(Bool colorBuffer, Bool depthBuffer, Bool stencilBuffer) override;
+        void setDefaultRenderTargetToCurrent() override;
+        WeakPointer<RenderTarget> getDefaultRenderTarget() override;
+        WeakPointer<RenderTarget> getCurrentRenderTarget() override;
+        void updateDefaultRenderTargetSize(Vector2u size) override;
+        void updateDefaultRenderTargetViewport(Vector4u viewport) override;
+        Bool activateRenderTarget(WeakPointer<RenderTarget> target) override;
+        Bool activateRenderTarget2DMipLevel(UInt32 mipLevel) override;
+        Bool activateCubeRenderTargetSide(CubeTextureSide side, UInt32 mipLevel) override;
+        void setRenderStyle(RenderStyle style) override;
+
+        void setDepthWriteEnabled(Bool enabled) override;
+        void setDepthTestEnabled(Bool enabled) override;
+        void setDepthFunction(RenderState::DepthFunction function) override;
+
+        void setStencilTestEnabled(Bool enabled) override;
+        void setStencilWriteMask(UInt32 mask) override;
+        void setStencilFunction(RenderState::StencilFunction function, Int16 value, UInt16 mask) override;
+        void setStencilOperation(RenderState::StencilAction sFail, RenderState::StencilAction dpFail, RenderState::StencilAction dpPass) override;
+
+        void setFaceCullingEnabled(Bool enabled) override;
+        void setCullFace(RenderState::CullFace face) override;
+
+        void setRenderLineSize(Real size) override;
+
+        void saveState() override;
+        void restoreState() override;
+
+        void lowLevelBlit(WeakPointer<RenderTarget> source, WeakPointer<RenderTarget> destination, Int16 cubeFace, Bool includeColor, Bool includeDepth) override;
+
+        static GraphicsCommandLog& getCommandLog();
+        static UInt32 generateObjectName();
+        static UInt32 getTextureByteCount(TextureFormat format, UInt32 width, UInt32 height, UInt32 mipLevels);
+
+    protected:
+
+        std::shared_ptr<AttributeArrayGPUStorage> createGPUStorage(UInt32 size, UInt32 componentCount, AttributeType type, Bool normalize) override;
+        std::shared_ptr<IndexBuffer> createIndexBuffer(UInt32 size) override;
+        std::shared_ptr<MatrixBuffer> createMatrixBuffer(UInt32 capacity) override;
+
+    private:
+        GraphicsNull();
+        std::shared_ptr<RendererNull> createRenderer();
+        std::shared_ptr<RenderTarget2DNull> createDefaultRenderTarget();
+        WeakPointer<Shader> addShader(ShaderNull* shaderPtr);
+        static UInt32 getTargetName(WeakPointer<RenderTarget> target);
+
+        std::shared_ptr<RendererNull> renderer;
+
+        PersistentWeakPointer<RenderTarget2DNull> defaultRenderTarget;
+        PersistentWeakPointer<RenderTarget> currentRenderTarget;
+        ShaderManagerGL shaderDirectory;
+        RenderStyle renderStyle;
+
+        Vector4u _viewport;
+    };
+}
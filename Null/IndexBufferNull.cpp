@@ -0,0 +1,34 @@
+#include "IndexBufferNull.h"
+#include "GraphicsNull.h"
+
+namespace Core {
+
+    IndexBufferNull::IndexBufferNull(UInt32 size): IndexBuffer(size), bufferID(0) {
+
+    }
+
+    IndexBufferNull::~IndexBufferNull() {
+
+    }
+
+    Int32 IndexBufferNull::getBufferID() const {
+        return this->bufferID;
+    }
+
+    void IndexBufferNull::initIndices() {
+        this->bufferID = GraphicsNull::generateObjectName();
+    }
+
+    void IndexBufferNull::setIndices(UInt32* indices) {
+        IndexBuffer::setIndices(indices);
+        GraphicsNull::getCommandLog().record(GraphicsCommandType::Upload, (UInt8)GraphicsResourceKind::IndexBuffer,
+                                             this->bufferID, this->size * sizeof(UInt32));
+    }
+
+    void IndexBufferNull::setIndices(const UInt32* indices, UInt32 count) {
+        IndexBuffer::setIndices(indices, count);
+        GraphicsNull::getCommandLog().record(GraphicsCommandType::Upload, (UInt8)GraphicsResourceKind::IndexBuffer,
+                                             this->bufferID, count * sizeof(UInt32));
+    }
+
+}
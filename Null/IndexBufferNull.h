@@ -0,0 +1,19 @@
+#pragma once
+
+#include "../geometry/IndexBuffer.h"
+
+namespace Core {
+
+    class IndexBufferNull final: public IndexBuffer {
+    public:
+        IndexBufferNull(UInt32 size);
+        ~IndexBufferNull() override;
+        Int32 getBufferID() const override;
+        void setIndices(UInt32 * indices) override;
+        void setIndices(const UInt32 * indices, UInt32 count) override;
+        void initIndices() override;
+    private:
+        UInt32 bufferID;
+    };
+
+}
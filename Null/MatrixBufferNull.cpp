@@ -0,0 +1,30 @@
+#include "MatrixBufferNull.h"
+#include "GraphicsNull.h"
+#include "../common/Exception.h"
+
+namespace Core {
+
+    MatrixBufferNull::MatrixBufferNull(UInt32 capacity): MatrixBuffer(capacity) {
+        this->bufferID = GraphicsNull::generateObjectName();
+        this->textureID = GraphicsNull::generateObjectName();
+    }
+
+    MatrixBufferNull::~MatrixBufferNull() {
+
+    }
+
+    void MatrixBufferNull::setMatrices(const Real * matrices, UInt32 count) {
+        if (count > this->capacity) {
+            throw OutOfRangeException("MatrixBufferNull::setMatrices() -> 'count' exceeds the buffer capacity.");
+        }
+        GraphicsNull::getCommandLog().record(GraphicsCommandType::Upload, (UInt8)GraphicsResourceKind::MatrixBuffer,
+                                             this->bufferID, count * 16 * sizeof(Real));
+    }
+
+    void MatrixBufferNull::sendToActiveShader(UInt32 samplerSlot, UInt32 uniformLocation) {
+        GraphicsCommandLog& commandLog = GraphicsNull::getCommandLog();
+        commandLog.record(GraphicsCommandType::BindTexture, (UInt8)GraphicsResourceKind::MatrixBuffer, samplerSlot, this->textureID);
+        commandLog.record(GraphicsCommandType::SetUniform, 0, uniformLocation, 1);
+    }
+
+}
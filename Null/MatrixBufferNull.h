@@ -0,0 +1,18 @@
+#pragma once
+
+#include "../render/MatrixBuffer.h"
+
+namespace Core {
+
+    class MatrixBufferNull final: public MatrixBuffer {
+    public:
+        MatrixBufferNull(UInt32 capacity);
+        ~MatrixBufferNull() override;
+        void setMatrices(const Real * matrices, UInt32 count) override;
+        void sendToActiveShader(UInt32 samplerSlot, UInt32 uniformLocation) override;
+    private:
+        UInt32 bufferID;
+        UInt32 textureID;
+    };
+
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "../render/RenderTarget2D.h"
+#include "../common/Exception.h"
+#include "RenderTargetNull.h"
+
+namespace Core {
+
+    // forward declarations
+    class TextureAttributes;
+    class GraphicsNull;
+
+    class RenderTarget2DNull final : public RenderTarget2D, public RenderTargetNull {
+        friend class GraphicsNull;
+    public:
+        ~RenderTarget2DNull() override;
+        Bool init() override;
+        Bool addColorTexture(TextureAttributes attributes) override;
+        void destroyColorBuffer(UInt32 index = 0) override;
+        void destroyDepthBuffer() override;
+
+    protected:
+
+        RenderTarget2DNull(Bool hasColor, Bool hasDepth, Bool enableStencilBuffer,
+                           const TextureAttributes& colorTextureAttributes,
+                           const TextureAttributes& depthTextureAttributes, Vector2u size,
+                           UInt32 initialTargetName = 0);
+        Bool initColorTexture(UInt32 index);
+    };
+}
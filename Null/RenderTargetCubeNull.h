@@ -0,0 +1,29 @@
+#pragma once
+
+#include "../render/RenderTargetCube.h"
+#include "../common/Exception.h"
+#include "RenderTargetNull.h"
+
+namespace Core {
+
+    // forward declarations
+    class TextureAttributes;
+    class GraphicsNull;
+
+    class RenderTargetCubeNull final : public RenderTargetCube, public RenderTargetNull {
+        friend class GraphicsNull;
+    public:
+        ~RenderTargetCubeNull() override;
+        Bool init() override;
+        Bool addColorTexture(TextureAttributes attributes) override;
+        void destroyColorBuffer(UInt32 index = 0) override;
+        void destroyDepthBuffer() override;
+
+    private:
+
+        RenderTargetCubeNull(Bool hasColor, Bool hasDepth, Bool enableStencilBuffer,
+                             const TextureAttributes& colorTextureAttributes,
+                             const TextureAttributes& depthTextureAttributes, Vector2u size);
+        Bool initColorTexture(UInt32 index);
+    };
+}
@@ -0,0 +1,22 @@
+#include "RenderTargetNull.h"
+#include "GraphicsNull.h"
+
+namespace Core {
+
+    RenderTargetNull::RenderTargetNull(UInt32 initialTargetName): targetName(initialTargetName) {
+
+    }
+
+    RenderTargetNull::~RenderTargetNull() {
+
+    }
+
+    UInt32 RenderTargetNull::getTargetName() const {
+        return this->targetName;
+    }
+
+    void RenderTargetNull::initTarget() {
+        this->targetName = GraphicsNull::generateObjectName();
+    }
+
+}
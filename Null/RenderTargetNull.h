@@ -0,0 +1,20 @@
+#pragma once
+
+#include "../common/types.h"
+
+namespace Core {
+
+    // Stands in for the framebuffer object of RenderTargetGL: a name that identifies the target in the
+    // command log. The default render target has name 0.
+    class RenderTargetNull {
+    public:
+        RenderTargetNull(UInt32 initialTargetName = 0);
+        virtual ~RenderTargetNull();
+        UInt32 getTargetName() const;
+
+    protected:
+        void initTarget();
+
+        UInt32 targetName;
+    };
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include "../render/Renderer.h"
+
+namespace Core {
+
+    // forward declaration
+    class GraphicsNull;
+
+    class RendererNull final : public Renderer {
+        friend class GraphicsNull;
+
+    public:
+        ~RendererNull() override;
+        Bool init() override;
+
+    private:
+        RendererNull();
+    };
+}
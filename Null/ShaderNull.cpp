@@ -0,0 +1,339 @@
+#include <vector>
+
+#include "ShaderNull.h"
+#include "GraphicsNull.h"
+
+namespace Core {
+
+    // the number of isBuildComplete() polls a build started with beginBuild() takes
+    static UInt32 buildLatency = 0;
+
+    static Bool isIdentifierChar(char c) {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+    }
+
+    /*
+     * Split a GLSL statement into identifiers (and numbers) and single-character symbols.
+     */
+    static void tokenize(const std::string& statement, std::vector<std::string>& tokens) {
+        size_t i = 0;
+        while (i < statement.size()) {
+            char c = statement[i];
+            if (isIdentifierChar(c)) {
+                size_t start = i;
+                while (i < statement.size() && isIdentifierChar(statement[i])) i++;
+                tokens.push_back(statement.substr(start, i - start));
+            }
+            else {
+                if (c != ' ' && c != '\t' && c != '\n' && c != '\r') tokens.push_back(std::string(1, c));
+                i++;
+            }
+        }
+    }
+
+    static Bool isQualifier(const std::string& token) {
+        return token == "lowp" || token == "mediump" || token == "highp" || token == "flat" || token == "smooth" ||
+               token == "noperspective" || token == "centroid" || token == "invariant" || token == "const";
+    }
+
+    /*
+     * Collect the names declared by one global-scope statement such as "layout(location = 0) in vec3 a, b[2]"
+     * into [uniforms] or [inputs] (either may be null to ignore that kind of declaration).
+     */
+    static void parseStatement(const std::string& statement, std::unordered_set<std::string>* uniforms,
+                               std::unordered_set<std::string>* inputs) {
+        std::vector<std::string> tokens;
+        tokenize(statement, tokens);
+
+        std::unordered_set<std::string>* declared = nullptr;
+        Bool storageFound = false;
+        size_t t = 0;
+        Int32 parenDepth = 0;
+        for (; t < tokens.size() && !storageFound; t++) {
+            const std::string& token = tokens[t];
+            if (token == "(") parenDepth++;
+            else if (token == ")") parenDepth--;
+            else if (parenDepth == 0 && token == "uniform") {
+                declared = uniforms;
+                storageFound = true;
+            }
+            else if (parenDepth == 0 && (token == "in" || token == "attribute")) {
+                declared = inputs;
+                storageFound = true;
+            }
+        }
+        if (declared == nullptr) return;
+
+        while (t < tokens.size() && isQualifier(tokens[t])) t++;
+        // the type, which may be an array type
+        t++;
+        while (t < tokens.size() && tokens[t] == "[") {
+            while (t < tokens.size() && tokens[t] != "]") t++;
+            t++;
+        }
+
+        while (t < tokens.size()) {
+            if (isIdentifierChar(tokens[t][0])) declared->insert(tokens[t]);
+            // skip array sizes and initializers up to the next declarator
+            Int32 depth = 0;
+            for (t++; t < tokens.size(); t++) {
+                const std::string& token = tokens[t];
+                if (token == "(" || token == "[") depth++;
+                else if (token == ")" || token == "]") depth--;
+                else if (token == "," && depth == 0) break;
+            }
+            t++;
+        }
+    }
+
+    ShaderNull::ShaderNull(const std::string &vertex, const std::string &fragment) : Shader(vertex, fragment), program(0), buildPending(false), pendingPolls(0) {
+    }
+
+    ShaderNull::ShaderNull(const char vertex[], const char fragment[]) : Shader(vertex, fragment), program(0), buildPending(false), pendingPolls(0) {
+    }
+
+    ShaderNull::ShaderNull(const std::string &vertex, const std::string &geometry, const std::string &fragment) :
+        Shader(vertex, geometry, fragment), program(0), buildPending(false), pendingPolls(0) {
+    }
+
+    ShaderNull::ShaderNull(const char vertex[], const char geometry[], const char fragment[]) :
+        Shader(vertex, geometry, fragment), program(0), buildPending(false), pendingPolls(0) {
+    }
+
+    ShaderNull::~ShaderNull() {
+    }
+
+    Bool ShaderNull::build() {
+        if (this->hasGeometryShader) {
+            this->createProgram(this->vertexSource, this->geometrySource, this->fragmentSource);
+        }
+        else {
+            this->createProgram(this->vertexSource, this->fragmentSource);
+        }
+        GraphicsNull::getCommandLog().record(GraphicsCommandType::BuildShader, 0, this->program);
+        return true;
+    }
+
+    Bool ShaderNull::beginBuild() {
+        if (this->ready || this->buildPending) return true;
+        if (buildLatency == 0) return this->build();
+        this->buildPending = true;
+        this->pendingPolls = 0;
+        return true;
+    }
+
+    Bool ShaderNull::isBuildComplete() {
+        if (!this->buildPending) return true;
+        this->pendingPolls++;
+        return this->pendingPolls >= buildLatency;
+    }
+
+    Bool ShaderNull::finishBuild() {
+        if (!this->buildPending) return this->ready;
+        this->buildPending = false;
+        return this->build();
+    }
+
+    /*
+     * Make builds started with beginBuild() report completion only after [polls] calls to isBuildComplete().
+     * With the default of zero they complete immediately.
+     */
+    void ShaderNull::setBuildLatency(UInt32 polls) {
+        buildLatency = polls;
+    }
+
+    UInt32 ShaderNull::getBuildLatency() {
+        return buildLatency;
+    }
+
+    UInt32 ShaderNull::createShader(ShaderType shaderType, const std::string& src) {
+        parseDeclarations(src, shaderType == ShaderType::Vertex, this->uniforms, this->attributes);
+        return GraphicsNull::generateObjectName();
+    }
+
+    UInt32 ShaderNull::createProgram(const std::string& vertex, const std::string& fragment) {
+        this->uniforms.clear();
+        this->attributes.clear();
+        this->locations.clear();
+        this->createShader(ShaderType::Vertex, vertex);
+        this->createShader(ShaderType::Fragment, fragment);
+        this->program = GraphicsNull::generateObjectName();
+        this->ready = true;
+        return this->program;
+    }
+
+    UInt32 ShaderNull::createProgram(const std::string& vertex, const std::string& geometry, const std::string& fragment) {
+        this->createProgram(vertex, fragment);
+        this->createShader(ShaderType::Geometry, geometry);
+        return this->program;
+    }
+
+    /*
+     * Scan [source] for global-scope uniform declarations, and for input declarations as well if [includeInputs]
+     * is set. Comments, preprocessor lines and the bodies of functions, structs and blocks are skipped; both
+     * branches of conditional compilation are scanned.
+     */
+    void ShaderNull::parseDeclarations(const std::string& source, Bool includeInputs,
+                                       std::unordered_set<std::string>& uniforms, std::unordered_set<std::string>& inputs) {
+        std::string statement;
+        UInt32 braceDepth = 0;
+        Bool lineStart = true;
+        size_t i = 0;
+        while (i < source.size()) {
+            char c = source[i];
+            char next = i + 1 < source.size() ? source[i + 1] : '\0';
+            if (c == '/' && next == '/') {
+                while (i < source.size() && source[i] != '\n') i++;
+                continue;
+            }
+            if (c == '/' && next == '*') {
+                size_t end = source.find("*/", i + 2);
+                i = end == std::string::npos ? source.size() : end + 2;
+                statement += ' ';
+                continue;
+            }
+            if (c == '#' && lineStart) {
+                while (i < source.size() && source[i] != '\n') i++;
+                continue;
+            }
+
+            if (c == '\n') lineStart = true;
+            else if (c != ' ' && c != '\t' && c != '\r') lineStart = false;
+
+            if (c == '{') {
+                // a function, struct or block body; what preceded it was not a plain declaration
+                if (braceDepth == 0) statement.clear();
+                braceDepth++;
+            }
+            else if (c == '}') {
+                if (braceDepth > 0) braceDepth--;
+            }
+            else if (braceDepth == 0) {
+                if (c == ';') {
+                    parseStatement(statement, &uniforms, includeInputs ? &inputs : nullptr);
+                    statement.clear();
+                }
+                else {
+                    statement += c;
+                }
+            }
+            i++;
+        }
+    }
+
+    Int32 ShaderNull::getLocation(const std::string& var, const std::unordered_set<std::string>& declared) const {
+        size_t nameLength = 0;
+        while (nameLength < var.size() && isIdentifierChar(var[nameLength])) nameLength++;
+        if (declared.find(var.substr(0, nameLength)) == declared.end()) return -1;
+
+        auto result = this->locations.find(var);
+        if (result != this->locations.end()) return result->second;
+        Int32 location = (Int32)this->locations.size();
+        this->locations[var] = location;
+        return location;
+    }
+
+    Int32 ShaderNull::getUniformLocation(const std::string &var) const {
+        return this->getLocation(var, this->uniforms);
+    }
+
+    Int32 ShaderNull::getUniformLocation(const std::string &var, UInt32 index) const {
+        return this->getUniformLocation(var + "[" + std::to_string(index) + "]");
+    }
+
+    Int32 ShaderNull::getAttributeLocation(const std::string &var) const {
+        return this->getLocation(var, this->attributes);
+    }
+
+    Int32 ShaderNull::getAttributeLocation(const std::string &var, UInt32 index) const {
+        return this->getAttributeLocation(var + "[" + std::to_string(index) + "]");
+    }
+
+    Int32 ShaderNull::getUniformLocation(const char var[]) const {
+        return this->getUniformLocation(std::string(var));
+    }
+
+    Int32 ShaderNull::getUniformLocation(const char var[], UInt32 index) const {
+        return this->getUniformLocation(std::string(var), index);
+    }
+
+    Int32 ShaderNull::getAttributeLocation(const char var[]) const {
+        return this->getAttributeLocation(std::string(var));
+    }
+
+    Int32 ShaderNull::getAttributeLocation(const char var[], UInt32 index) const {
+        return this->getAttributeLocation(std::string(var), index);
+    }
+
+    Int32 ShaderNull::getUniformLocation(StandardUniform uniform) const {
+        return this->getUniformLocation(StandardUniforms::getUniformName(uniform));
+    }
+
+    Int32 ShaderNull::getUniformLocation(StandardUniform uniform, UInt32 index) const {
+        return this->getUniformLocation(StandardUniforms::getUniformName(uniform), index);
+    }
+
+    Int32 ShaderNull::getAttributeLocation(StandardAttribute attribute) const {
+        return this->getAttributeLocation(StandardAttributes::getAttributeName(attribute));
+    }
+
+    Int32 ShaderNull::getAttributeLocation(StandardAttribute attribute, UInt32 index) const {
+        return this->getAttributeLocation(StandardAttributes::getAttributeName(attribute), index);
+    }
+
+    void ShaderNull::setTexture2D(UInt32 slot, UInt32 textureID) {
+        if (slot >= 31) {
+            throw Shader::ShaderVariableException("ShaderNull::setTexture2D() value for [slot] is too high.");
+        }
+        GraphicsNull::getCommandLog().record(GraphicsCommandType::BindTexture, (UInt8)GraphicsResourceKind::Texture2D, slot, textureID);
+    }
+
+    void ShaderNull::setTexture2D(UInt32 samplerSlot, UInt32 uniformLocation, UInt32 textureID) {
+        this->setTexture2D(samplerSlot, textureID);
+        this->setUniform1i(uniformLocation, samplerSlot);
+    }
+
+    void ShaderNull::setTextureCube(UInt32 slot, UInt32 textureID) {
+        if (slot >= 31) {
+            throw Shader::ShaderVariableException("ShaderNull::setTextureCube() value for [slot] is too high.");
+        }
+        GraphicsNull::getCommandLog().record(GraphicsCommandType::BindTexture, (UInt8)GraphicsResourceKind::CubeTexture, slot, textureID);
+    }
+
+    void ShaderNull::setTextureCube(UInt32 samplerSlot, UInt32 uniformLocation, UInt32 textureID) {
+        this->setTextureCube(samplerSlot, textureID);
+        this->setUniform1i(uniformLocation, samplerSlot);
+    }
+
+    void ShaderNull::setUniform1i(UInt32 location, Int32 val) {
+        GraphicsNull::getCommandLog().record(GraphicsCommandType::SetUniform, 0, location, 1);
+    }
+
+    void ShaderNull::setUniform1f(UInt32 location, Real val) {
+        GraphicsNull::getCommandLog().record(GraphicsCommandType::SetUniform, 0, location, 1);
+    }
+
+    void ShaderNull::setUniform2f(UInt32 location, Real x, Real y) {
+        GraphicsNull::getCommandLog().record(GraphicsCommandType::SetUniform, 0, location, 2);
+    }
+
+    void ShaderNull::setUniform3f(UInt32 location, Real x, Real y, Real z) {
+        GraphicsNull::getCommandLog().record(GraphicsCommandType::SetUniform, 0, location, 3);
+    }
+
+    void ShaderNull::setUniform4f(UInt32 location, Real x, Real y, Real z, Real w) {
+        GraphicsNull::getCommandLog().record(GraphicsCommandType::SetUniform, 0, location, 4);
+    }
+
+    void ShaderNull::setUniformMatrix4(UInt32 location, const Real *data) {
+        GraphicsNull::getCommandLog().record(GraphicsCommandType::SetUniform, 0, location, 16);
+    }
+
+    void ShaderNull::setUniformMatrix4(UInt32 location, const Matrix4x4 &matrix) {
+        GraphicsNull::getCommandLog().record(GraphicsCommandType::SetUniform, 0, location, 16);
+    }
+
+    UInt32 ShaderNull::getProgram() const {
+        return this->program;
+    }
+}
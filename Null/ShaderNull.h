@@ -0,0 +1,82 @@
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "../common/types.h"
+#include "../material/Shader.h"
+
+namespace Core {
+
+    // forward declarations
+    class GraphicsNull;
+
+    // A shader that is never compiled. build() scans the sources for the uniforms (in every stage) and the
+    // vertex inputs they declare at global scope; a location lookup succeeds for declared names only, so code
+    // that branches on whether a shader has a given variable takes the same path it would with GL. Unlike a
+    // GL linker, nothing is dropped for being unused. Builds started with beginBuild() can be made to take a
+    // number of polls to complete, to stand in for a driver that compiles in the background.
+    class ShaderNull final : public Shader {
+        friend class GraphicsNull;
+
+    public:
+        ~ShaderNull() override;
+
+        Bool build() override;
+        Bool beginBuild() override;
+        Bool isBuildComplete() override;
+        Bool finishBuild() override;
+        UInt32 getProgram() const override;
+        Int32 getUniformLocation(const std::string& var) const override;
+        Int32 getUniformLocation(const std::string& var, UInt32 index) const override;
+        Int32 getAttributeLocation(const std::string& var) const override;
+        Int32 getAttributeLocation(const std::string& var, UInt32 index) const override;
+        Int32 getUniformLocation(const char var[]) const override;
+        Int32 getUniformLocation(const char var[], UInt32 index) const override;
+        Int32 getAttributeLocation(const char var[]) const override;
+        Int32 getAttributeLocation(const char var[], UInt32 index) const override;
+        Int32 getUniformLocation(StandardUniform uniform) const override;
+        Int32 getUniformLocation(StandardUniform uniform, UInt32 index) const override;
+        Int32 getAttributeLocation(StandardAttribute attribute) const override;
+        Int32 getAttributeLocation(StandardAttribute attribute, UInt32 index) const override;
+
+        void setTexture2D(UInt32 samplerSlot, UInt32 textureID) override;
+        void setTexture2D(UInt32 samplerSlot, UInt32 uniformLocation, UInt32 textureID) override;
+        void setTextureCube(UInt32 samplerSlot, UInt32 textureID) override;
+        void setTextureCube(UInt32 samplerSlot, UInt32 uniformLocation, UInt32 textureID) override;
+        void setUniform1i(UInt32 location, Int32 val) override;
+        void setUniform1f(UInt32 location, Real val) override;
+        void setUniform2f(UInt32 location, Real x, Real y) override;
+        void setUniform3f(UInt32 location, Real x, Real y, Real z) override;
+        void setUniform4f(UInt32 location, Real x, Real y, Real z, Real w) override;
+        void setUniformMatrix4(UInt32 location, const Real* data) override;
+        void setUniformMatrix4(UInt32 location, const Matrix4x4& data) override;
+
+        static void setBuildLatency(UInt32 polls);
+        static UInt32 getBuildLatency();
+        static void parseDeclarations(const std::string& source, Bool includeInputs,
+                                      std::unordered_set<std::string>& uniforms, std::unordered_set<std::string>& inputs);
+
+    protected:
+        ShaderNull(const std::string& vertex, const std::string& fragment);
+        ShaderNull(const std::string& vertex, const std::string& geometry, const std::string& fragment);
+        ShaderNull(const char vertex[], const char fragment[]);
+        ShaderNull(const char vertex[], const char geometry[], const char fragment[]);
+
+        UInt32 createShader(ShaderType shaderType, const std::string& src) override;
+        UInt32 createProgram(const std::string& vertex, const std::string& fragment) override;
+        UInt32 createProgram(const std::string& vertex, const std::string& geometry, const std::string& fragment) override;
+
+    private:
+        Int32 getLocation(const std::string& var, const std::unordered_set<std::string>& declared) const;
+
+        UInt32 program;
+        Bool buildPending;
+        UInt32 pendingPolls;
+        std::unordered_set<std::string> uniforms;
+        std::unordered_set<std::string> attributes;
+        // locations are handed out on first lookup, so they are stable for the life of the shader
+        mutable std::unordered_map<std::string, Int32> locations;
+    };
+}
@@ -0,0 +1,105 @@
+#include "Texture2DNull.h"
+#include "GraphicsNull.h"
+#include "../common/Exception.h"
+#include "../image/RawImage.h"
+
+namespace Core {
+
+    Texture2DNull::Texture2DNull(const TextureAttributes& attributes): Texture2D(attributes) {
+        this->streamWidth = 0;
+        this->streamHeight = 0;
+    }
+
+    Texture2DNull::~Texture2DNull() {
+
+    }
+
+    void Texture2DNull::buildFromImage(WeakPointer<StandardImage> imageData) {
+        if (this->attributes.Format != TextureFormat::RGBA8) {
+            throw TextureException("Texture2DNull::build() -> Textures built with StandardImage must have type RGBA8.");
+        }
+        this->buildFromImage(imageData, imageData->getWidth(), imageData->getHeight());
+    }
+
+    void Texture2DNull::buildFromImage(WeakPointer<StandardImage> imageData, UInt32 resizeWidth, UInt32 resizeHeight) {
+        if (this->attributes.Format != TextureFormat::RGBA8) {
+            throw TextureException("Texture2DNull::build() -> Textures built with StandardImage must have type RGBA8.");
+        }
+        this->setupTexture(1, imageData->getWidth(), imageData->getHeight(), true);
+    }
+
+    void Texture2DNull::buildFromImage(WeakPointer<HDRImage> imageData) {
+        if (this->attributes.Format != TextureFormat::RGBA16F && this->attributes.Format != TextureFormat::RGBA32F) {
+            throw TextureException("Texture2DNull::build() -> Textures built with HDRImage must have type RGBA16F or RGBA32F.");
+        }
+        this->buildFromImage(imageData, imageData->getWidth(), imageData->getHeight());
+    }
+
+    void Texture2DNull::buildFromImage(WeakPointer<HDRImage> imageData, UInt32 resizeWidth, UInt32 resizeHeight) {
+        if (this->attributes.Format != TextureFormat::RGBA16F && this->attributes.Format != TextureFormat::RGBA32F) {
+            throw TextureException("Texture2DNull::build() -> Textures built with HDRImage must have type RGBA16F or RGBA32F.");
+        }
+        this->setupTexture(1, imageData->getWidth(), imageData->getHeight(), true);
+    }
+
+    void Texture2DNull::buildFromData(Byte* data, UInt32 width, UInt32 height) {
+        this->setupTexture(1, width, height, data != nullptr);
+    }
+
+    void Texture2DNull::buildFromMipLevels(Byte** levels, UInt32 levelCount, UInt32 width, UInt32 height) {
+        if (levelCount == 0) {
+            throw InvalidArgumentException("Texture2DNull::buildFromMipLevels() -> 'levelCount' must be greater than zero.");
+        }
+        this->setupTexture(levelCount, width, height, true);
+    }
+
+    void Texture2DNull::buildStreamable(UInt32 width, UInt32 height) {
+        if (width == 0 || height == 0) {
+            throw InvalidArgumentException("Texture2DNull::buildStreamable() -> Texture dimensions must be non-zero.");
+        }
+        this->setupTexture(1, width, height, false);
+        this->streamWidth = width;
+        this->streamHeight = height;
+    }
+
+    // Logged as an upload to the existing texture object, of that one level's bytes.
+    void Texture2DNull::uploadMipLevel(UInt32 level, const Byte* data) {
+        UInt32 size = this->streamWidth > this->streamHeight ? this->streamWidth : this->streamHeight;
+        if (size == 0 || level >= 32 || (size >> level) == 0) {
+            throw InvalidArgumentException("Texture2DNull::uploadMipLevel() -> Invalid mip level.");
+        }
+        UInt32 levelWidth = this->streamWidth >> level > 0 ? this->streamWidth >> level : 1;
+        UInt32 levelHeight = this->streamHeight >> level > 0 ? this->streamHeight >> level : 1;
+        UInt32 byteCount = GraphicsNull::getTextureByteCount(this->attributes.Format, levelWidth, levelHeight, 1);
+        GraphicsNull::getCommandLog().record(GraphicsCommandType::Upload, (UInt8)GraphicsResourceKind::Texture2D,
+                                             this->textureId, byteCount, levelWidth, levelHeight);
+    }
+
+    void Texture2DNull::setFirstResidentMipLevel(UInt32 level) {
+        if (this->streamWidth == 0) {
+            throw InvalidArgumentException("Texture2DNull::setFirstResidentMipLevel() -> Texture is not streamable.");
+        }
+    }
+
+    void Texture2DNull::buildEmpty(UInt32 width, UInt32 height) {
+        this->setupTexture(1, width, height, false);
+    }
+
+    void Texture2DNull::updateMipMaps() {
+    }
+
+    /*
+     * Log the upload that Texture2DGL would make. Mip levels that GL generates itself never cross the bus, so
+     * only supplied levels are counted, and storage allocated without data counts zero bytes.
+     */
+    void Texture2DNull::setupTexture(UInt32 levelCount, UInt32 width, UInt32 height, Bool hasData) {
+        // like the GL textures, every build replaces the texture object
+        this->textureId = GraphicsNull::generateObjectName();
+        this->streamWidth = 0;
+        this->streamHeight = 0;
+        UInt32 byteCount = hasData ? GraphicsNull::getTextureByteCount(this->attributes.Format, width, height, levelCount) : 0;
+        GraphicsNull::getCommandLog().record(GraphicsCommandType::Upload, (UInt8)GraphicsResourceKind::Texture2D,
+                                             this->textureId, byteCount, width, height);
+    }
+
+};
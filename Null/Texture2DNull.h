@@ -0,0 +1,37 @@
+#pragma once
+
+#include <memory>
+
+#include "../image/Texture2D.h"
+
+namespace Core {
+
+    // forward declaration
+    class GraphicsNull;
+
+    class Texture2DNull final : public Texture2D {
+        friend class GraphicsNull;
+
+    public:
+        ~Texture2DNull() override;
+
+        void buildFromImage(WeakPointer<StandardImage> imageData) override;
+        void buildFromImage(WeakPointer<StandardImage> imageData, UInt32 resizeWidth, UInt32 resizeHeight) override;
+        void buildFromImage(WeakPointer<HDRImage> imageData) override;
+        void buildFromImage(WeakPointer<HDRImage> imageData, UInt32 resizeWidth, UInt32 resizeHeight) override;
+        void buildFromData(Byte* data, UInt32 width, UInt32 height) override;
+        void buildFromMipLevels(Byte** levels, UInt32 levelCount, UInt32 width, UInt32 height) override;
+        void buildStreamable(UInt32 width, UInt32 height) override;
+        void uploadMipLevel(UInt32 level, const Byte* data) override;
+        void setFirstResidentMipLevel(UInt32 level) override;
+        void buildEmpty(UInt32 width, UInt32 height) override;
+        void updateMipMaps() override;
+
+    protected:
+        Texture2DNull(const TextureAttributes& attributes);
+        void setupTexture(UInt32 levelCount, UInt32 width, UInt32 height, Bool hasData);
+
+        UInt32 streamWidth;
+        UInt32 streamHeight;
+    };
+}
@@ -55,6 +55,8 @@ namespace Core {
 			channelNames = nullptr;
 		}
 
+		// the tracks refer to the compressed key frames in [keyFrames]
+		this->tracks = AnimationTracks();
 		channelCount = 0;
 	}
 
@@ -108,6 +110,18 @@ namespace Core {
 		return keyFrames + nodeIndex;
 	}
 
+	/*
+	 * Retrieve the key frames of all channels laid out for sampling. They are built from the key frame sets
+	 * the first time this is called (when the animation is first played), which also releases the per-key
+	 * objects of the uncompressed key frame sets, so key frames must be complete by then.
+	 */
+	const AnimationTracks& Animation::getTracks() {
+		if (!this->tracks.isBuilt()) {
+			this->tracks.build(this->keyFrames, this->channelCount);
+		}
+		return this->tracks;
+	}
+
 	const std::string * Animation::getChannelName(UInt32 index) const {
 		if (index >= channelCount) {
 			throw OutOfRangeException("Animation::getChannelName -> 'index' is out of range.");
@@ -16,6 +16,7 @@
 #include "../Engine.h"
 #include "../base/CoreObject.h"
 #include "KeyFrameSet.h"
+#include "AnimationTracks.h"
 #include "../geometry/Vector3.h"
 #include "../math/Quaternion.h"
 #include "../math/Matrix4x4.h"
@@ -38,6 +39,7 @@ namespace Core {
 		void clipEnds(Real startOffsetTicks, Real earlyEndTicks);
 		UInt32 getChannelCount() const;
 		KeyFrameSet * getKeyFrameSet(UInt32 nodeIndex);
+		const AnimationTracks& getTracks();
 		const std::string * getChannelName(UInt32 index) const;
 		void setChannelName(UInt32 index, const std::string& name);
 		Real getTicksPerSecond() const;
@@ -53,6 +55,9 @@ namespace Core {
 		// A KeyFrameSet for each node in the target skeleton
 		KeyFrameSet * keyFrames;
 
+		// the key frames of all channels laid out for sampling, built from [keyFrames] on first use
+		AnimationTracks tracks;
+
 		// the channel name of each key frame set, used in animation targeting
 		// 1:1 correspondence with [keyFrames]
 		std::string * channelNames;
@@ -0,0 +1,313 @@
+#include <vector>
+
+#include "AnimationCompressor.h"
+#include "Animation.h"
+#include "KeyFrameSet.h"
+#include "CompressedKeyFrames.h"
+#include "../math/Math.h"
+#include "../math/Quaternion.h"
+#include "../common/Exception.h"
+
+namespace Core {
+
+	// the uncompressed keys of one track; values are stored as x, y, z, w
+	class SourceTrack {
+	public:
+		std::vector<Real> times;
+		std::vector<Real> values;
+	};
+
+	// error of [source] when reconstructed by interpolating from [first] to [last] by [t]
+	typedef Real (*KeyErrorFunction)(const Real* source, const Real* first, const Real* last, Real t);
+
+	static Real vectorError(const Real* source, const Real* first, const Real* last, Real t) {
+		Real distanceSquared = 0.0f;
+		for (UInt32 i = 0; i < 3; i++) {
+			Real delta = first[i] + (last[i] - first[i]) * t - source[i];
+			distanceSquared += delta * delta;
+		}
+		return Math::squareRoot(distanceSquared);
+	}
+
+	static Real rotationError(const Real* source, const Real* first, const Real* last, Real t) {
+		Quaternion a(first[0], first[1], first[2], first[3]);
+		Quaternion b(last[0], last[1], last[2], last[3]);
+		Quaternion reconstructed = Quaternion::slerp(a, b, t);
+		Real r[4] = {reconstructed.x(), reconstructed.y(), reconstructed.z(), reconstructed.w()};
+
+		Real dot = 0.0f;
+		for (UInt32 i = 0; i < 4; i++) dot += r[i] * source[i];
+		Real sign = dot < 0.0f ? -1.0f : 1.0f;
+
+		// the chord between two unit quaternions is 2 * sin(angle / 4), which unlike the
+		// dot product keeps its precision for small angles
+		Real chordSquared = 0.0f;
+		for (UInt32 i = 0; i < 4; i++) {
+			Real delta = r[i] * sign - source[i];
+			chordSquared += delta * delta;
+		}
+		return 4.0f * Math::aSin(Math::min(1.0f, Math::squareRoot(chordSquared) * 0.5f));
+	}
+
+	static Real getSegmentProgress(const std::vector<Real>& times, UInt32 first, UInt32 last, UInt32 key) {
+		Real delta = times[last] - times[first];
+		return delta > 0.0f ? (times[key] - times[first]) / delta : 1.0f;
+	}
+
+	/*
+	 * Greedily extend each segment for as long as every source key it spans can be reconstructed
+	 * from its two (decoded) end keys within [tolerance]. [keys] receives the indices of the kept keys.
+	 */
+	static void selectKeys(const SourceTrack& source, const std::vector<Real>& decoded, KeyErrorFunction error, Real tolerance, std::vector<UInt32>& keys) {
+		UInt32 count = (UInt32)source.times.size();
+		keys.clear();
+		if (count == 0) return;
+
+		keys.push_back(0);
+		UInt32 anchor = 0;
+		for (UInt32 candidate = 2; candidate < count; candidate++) {
+			for (UInt32 k = anchor + 1; k < candidate; k++) {
+				Real t = getSegmentProgress(source.times, anchor, candidate, k);
+				if (error(&source.values[k * 4], &decoded[anchor * 4], &decoded[candidate * 4], t) > tolerance) {
+					anchor = candidate - 1;
+					keys.push_back(anchor);
+					break;
+				}
+			}
+		}
+		if (count > 1) keys.push_back(count - 1);
+	}
+
+	/*
+	 * Largest error of any source key when reconstructed from the decoded keys [keys].
+	 */
+	static Real measureError(const SourceTrack& source, const std::vector<Real>& decoded, KeyErrorFunction error, const std::vector<UInt32>& keys) {
+		Real maxError = 0.0f;
+		if (keys.size() == 1) {
+			for (UInt32 k = 0; k < source.times.size(); k++) {
+				maxError = Math::max(maxError, error(&source.values[k * 4], &decoded[0], &decoded[0], 0.0f));
+			}
+			return maxError;
+		}
+
+		for (UInt32 s = 0; s + 1 < keys.size(); s++) {
+			UInt32 first = keys[s];
+			UInt32 last = keys[s + 1];
+			for (UInt32 k = first; k <= last; k++) {
+				Real t = getSegmentProgress(source.times, first, last, k);
+				maxError = Math::max(maxError, error(&source.values[k * 4], &decoded[first * 4], &decoded[last * 4], t));
+			}
+		}
+		return maxError;
+	}
+
+	static Bool isConstant(const SourceTrack& source, KeyErrorFunction error, Real tolerance) {
+		for (UInt32 k = 1; k < source.times.size(); k++) {
+			if (error(&source.values[k * 4], &source.values[0], &source.values[0], 0.0f) > tolerance) return false;
+		}
+		return true;
+	}
+
+	static void storeConstant(const SourceTrack& source, CompressedKeyFrames& track) {
+		track.Constant = true;
+		track.Times.push_back(source.times[0]);
+		for (UInt32 i = 0; i < 4; i++) track.ConstantValue[i] = source.values[i];
+	}
+
+	static void storeUncompressed(const SourceTrack& source, CompressedKeyFrames& track) {
+		track.Uncompressed = true;
+		track.Times = source.times;
+		track.UncompressedValues.reserve(source.times.size() * 3);
+		for (UInt32 k = 0; k < source.times.size(); k++) {
+			for (UInt32 i = 0; i < 3; i++) track.UncompressedValues.push_back(source.values[k * 4 + i]);
+		}
+	}
+
+	static void storeKeys(const SourceTrack& source, const std::vector<UInt16>& quantized, const std::vector<UInt32>& keys, CompressedKeyFrames& track) {
+		track.Times.reserve(keys.size());
+		track.Values.reserve(keys.size() * 3);
+		for (UInt32 key : keys) {
+			track.Times.push_back(source.times[key]);
+			for (UInt32 i = 0; i < 3; i++) track.Values.push_back(quantized[key * 3 + i]);
+		}
+	}
+
+	static Real compressVectorTrack(const SourceTrack& source, Real tolerance, CompressedKeyFrames& track) {
+		track.clear();
+		UInt32 count = (UInt32)source.times.size();
+		if (count == 0) return 0.0f;
+
+		std::vector<UInt32> keys;
+		if (isConstant(source, vectorError, tolerance)) {
+			storeConstant(source, track);
+			keys.push_back(0);
+			return measureError(source, source.values, vectorError, keys);
+		}
+
+		Real maximum[3];
+		for (UInt32 i = 0; i < 3; i++) {
+			track.Minimum[i] = maximum[i] = source.values[i];
+		}
+		for (UInt32 k = 1; k < count; k++) {
+			for (UInt32 i = 0; i < 3; i++) {
+				track.Minimum[i] = Math::min(track.Minimum[i], source.values[k * 4 + i]);
+				maximum[i] = Math::max(maximum[i], source.values[k * 4 + i]);
+			}
+		}
+		for (UInt32 i = 0; i < 3; i++) track.Extent[i] = maximum[i] - track.Minimum[i];
+
+		// rounding to 16 bits can be off by half a step on each axis; if that alone exceeds the tolerance
+		// over this track's range, quantizing cannot reproduce it and the keys are kept as they are
+		Real quantizationErrorSquared = 0.0f;
+		for (UInt32 i = 0; i < 3; i++) {
+			Real halfStep = track.Extent[i] / 65535.0f * 0.5f;
+			quantizationErrorSquared += halfStep * halfStep;
+		}
+		if (Math::squareRoot(quantizationErrorSquared) > tolerance) {
+			storeUncompressed(source, track);
+			return 0.0f;
+		}
+
+		std::vector<UInt16> quantized(count * 3);
+		std::vector<Real> decoded(count * 4, 0.0f);
+		for (UInt32 k = 0; k < count; k++) {
+			CompressedKeyFrames::encodeVector(&source.values[k * 4], track.Minimum, track.Extent, &quantized[k * 3]);
+			CompressedKeyFrames::decodeVector(&quantized[k * 3], track.Minimum, track.Extent, &decoded[k * 4]);
+		}
+
+		selectKeys(source, decoded, vectorError, tolerance, keys);
+		storeKeys(source, quantized, keys, track);
+		return measureError(source, decoded, vectorError, keys);
+	}
+
+	static Real compressRotationTrack(SourceTrack& source, Real tolerance, CompressedKeyFrames& track) {
+		track.clear();
+		UInt32 count = (UInt32)source.times.size();
+		if (count == 0) return 0.0f;
+
+		for (UInt32 k = 0; k < count; k++) {
+			Quaternion rotation(source.values[k * 4], source.values[k * 4 + 1], source.values[k * 4 + 2], source.values[k * 4 + 3]);
+			rotation.normalize();
+			source.values[k * 4] = rotation.x();
+			source.values[k * 4 + 1] = rotation.y();
+			source.values[k * 4 + 2] = rotation.z();
+			source.values[k * 4 + 3] = rotation.w();
+		}
+
+		std::vector<UInt32> keys;
+		if (isConstant(source, rotationError, tolerance)) {
+			storeConstant(source, track);
+			keys.push_back(0);
+			return measureError(source, source.values, rotationError, keys);
+		}
+
+		std::vector<UInt16> quantized(count * 3);
+		std::vector<Real> decoded(count * 4);
+		for (UInt32 k = 0; k < count; k++) {
+			Quaternion rotation(source.values[k * 4], source.values[k * 4 + 1], source.values[k * 4 + 2], source.values[k * 4 + 3]);
+			CompressedKeyFrames::encodeRotation(rotation, &quantized[k * 3]);
+			CompressedKeyFrames::decodeRotation(&quantized[k * 3], rotation);
+			decoded[k * 4] = rotation.x();
+			decoded[k * 4 + 1] = rotation.y();
+			decoded[k * 4 + 2] = rotation.z();
+			decoded[k * 4 + 3] = rotation.w();
+		}
+
+		selectKeys(source, decoded, rotationError, tolerance, keys);
+		storeKeys(source, quantized, keys, track);
+		return measureError(source, decoded, rotationError, keys);
+	}
+
+	static void addTrackStatistics(AnimationCompressor::Statistics& statistics, UInt32 sourceKeyCount, UInt32 sourceSize, const CompressedKeyFrames& track) {
+		statistics.trackCount++;
+		if (track.Constant) statistics.constantTrackCount++;
+		if (track.Uncompressed) statistics.uncompressedTrackCount++;
+		statistics.sourceKeyCount += sourceKeyCount;
+		statistics.keyCount += track.getKeyCount();
+		statistics.sourceSize += sourceSize;
+		statistics.size += track.getSize();
+	}
+
+	Real AnimationCompressor::Statistics::getCompressionRatio() const {
+		if (this->size == 0) return 1.0f;
+		return (Real)this->sourceSize / (Real)this->size;
+	}
+
+	void AnimationCompressor::Statistics::add(const Statistics& other) {
+		this->trackCount += other.trackCount;
+		this->constantTrackCount += other.constantTrackCount;
+		this->uncompressedTrackCount += other.uncompressedTrackCount;
+		this->sourceKeyCount += other.sourceKeyCount;
+		this->keyCount += other.keyCount;
+		this->sourceSize += other.sourceSize;
+		this->size += other.size;
+		this->maxTranslationError = Math::max(this->maxTranslationError, other.maxTranslationError);
+		this->maxScaleError = Math::max(this->maxScaleError, other.maxScaleError);
+		this->maxRotationError = Math::max(this->maxRotationError, other.maxRotationError);
+	}
+
+	AnimationCompressor::Statistics AnimationCompressor::compress(WeakPointer<Animation> animation, const Settings& settings) {
+		if (!animation.isValid()) {
+			throw InvalidReferenceException("AnimationCompressor::compress -> 'animation' is invalid.");
+		}
+
+		Statistics statistics;
+		for (UInt32 n = 0; n < animation->getChannelCount(); n++) {
+			KeyFrameSet * keyFrameSet = animation->getKeyFrameSet(n);
+			if (keyFrameSet != nullptr && keyFrameSet->Used) {
+				statistics.add(compress(*keyFrameSet, settings));
+			}
+		}
+		return statistics;
+	}
+
+	AnimationCompressor::Statistics AnimationCompressor::compress(KeyFrameSet& keyFrameSet, const Settings& settings) {
+		Statistics statistics;
+		if (keyFrameSet.Compressed) return statistics;
+
+		SourceTrack translations;
+		translations.times.reserve(keyFrameSet.TranslationKeyFrames.size());
+		translations.values.reserve(keyFrameSet.TranslationKeyFrames.size() * 4);
+		for (const TranslationKeyFrame& keyFrame : keyFrameSet.TranslationKeyFrames) {
+			translations.times.push_back(keyFrame.RealTime);
+			translations.values.insert(translations.values.end(), {keyFrame.Translation.x, keyFrame.Translation.y, keyFrame.Translation.z, 0.0f});
+		}
+
+		SourceTrack scales;
+		scales.times.reserve(keyFrameSet.ScaleKeyFrames.size());
+		scales.values.reserve(keyFrameSet.ScaleKeyFrames.size() * 4);
+		for (const ScaleKeyFrame& keyFrame : keyFrameSet.ScaleKeyFrames) {
+			scales.times.push_back(keyFrame.RealTime);
+			scales.values.insert(scales.values.end(), {keyFrame.Scale.x, keyFrame.Scale.y, keyFrame.Scale.z, 0.0f});
+		}
+
+		SourceTrack rotations;
+		rotations.times.reserve(keyFrameSet.RotationKeyFrames.size());
+		rotations.values.reserve(keyFrameSet.RotationKeyFrames.size() * 4);
+		for (const RotationKeyFrame& keyFrame : keyFrameSet.RotationKeyFrames) {
+			rotations.times.push_back(keyFrame.RealTime);
+			rotations.values.insert(rotations.values.end(), {keyFrame.Rotation.x(), keyFrame.Rotation.y(), keyFrame.Rotation.z(), keyFrame.Rotation.w()});
+		}
+
+		statistics.maxTranslationError = compressVectorTrack(translations, settings.translationTolerance, keyFrameSet.CompressedTranslations);
+		statistics.maxScaleError = compressVectorTrack(scales, settings.scaleTolerance, keyFrameSet.CompressedScales);
+		statistics.maxRotationError = compressRotationTrack(rotations, settings.rotationTolerance, keyFrameSet.CompressedRotations);
+
+		addTrackStatistics(statistics, (UInt32)keyFrameSet.TranslationKeyFrames.size(),
+		                   (UInt32)(sizeof(std::vector<TranslationKeyFrame>) + keyFrameSet.TranslationKeyFrames.capacity() * sizeof(TranslationKeyFrame)),
+		                   keyFrameSet.CompressedTranslations);
+		addTrackStatistics(statistics, (UInt32)keyFrameSet.ScaleKeyFrames.size(),
+		                   (UInt32)(sizeof(std::vector<ScaleKeyFrame>) + keyFrameSet.ScaleKeyFrames.capacity() * sizeof(ScaleKeyFrame)),
+		                   keyFrameSet.CompressedScales);
+		addTrackStatistics(statistics, (UInt32)keyFrameSet.RotationKeyFrames.size(),
+		                   (UInt32)(sizeof(std::vector<RotationKeyFrame>) + keyFrameSet.RotationKeyFrames.capacity() * sizeof(RotationKeyFrame)),
+		                   keyFrameSet.CompressedRotations);
+
+		std::vector<TranslationKeyFrame>().swap(keyFrameSet.TranslationKeyFrames);
+		std::vector<ScaleKeyFrame>().swap(keyFrameSet.ScaleKeyFrames);
+		std::vector<RotationKeyFrame>().swap(keyFrameSet.RotationKeyFrames);
+		keyFrameSet.Compressed = true;
+
+		return statistics;
+	}
+}
@@ -0,0 +1,90 @@
+/*********************************************
+*
+* class: AnimationCompressor
+*
+* Import-time compression of Animation key frames. Each translation, scale and rotation track of
+* every channel is compressed on its own:
+*
+*   - a track whose keys all lie within tolerance of its first key is stored as that single value,
+*   - every other track is quantized (see CompressedKeyFrames) and then reduced to the keys that
+*     are needed to reproduce all source keys within tolerance when interpolating linearly (or
+*     spherically for rotations) between the remaining ones, the way AnimationPlayer does,
+*   - a translation or scale track whose range is so wide that the 16-bit quantization error alone
+*     exceeds tolerance keeps all of its keys at full precision.
+*
+* Errors are measured against the decoded values, so the quantization error is included in the
+* tolerance. The first and last key of each track are always kept.
+*
+***********************************************/
+
+#pragma once
+
+#include "../common/types.h"
+#include "../util/WeakPointer.h"
+
+namespace Core {
+
+	//forward declarations
+	class Animation;
+	class KeyFrameSet;
+
+	class AnimationCompressor final {
+	public:
+
+		class Settings {
+		public:
+			Settings() {
+				this->translationTolerance = 0.0005f;
+				this->scaleTolerance = 0.0001f;
+				this->rotationTolerance = 0.0005f;
+			}
+
+			// largest distance allowed between a source translation key and its reconstruction
+			Real translationTolerance;
+			// largest distance allowed between a source scale key and its reconstruction
+			Real scaleTolerance;
+			// largest angle (in radians) allowed between a source rotation key and its reconstruction
+			Real rotationTolerance;
+		};
+
+		class Statistics {
+		public:
+			Statistics() {
+				this->trackCount = 0;
+				this->constantTrackCount = 0;
+				this->uncompressedTrackCount = 0;
+				this->sourceKeyCount = 0;
+				this->keyCount = 0;
+				this->sourceSize = 0;
+				this->size = 0;
+				this->maxTranslationError = 0.0f;
+				this->maxScaleError = 0.0f;
+				this->maxRotationError = 0.0f;
+			}
+
+			// size of the source key frames relative to the compressed tracks
+			Real getCompressionRatio() const;
+			void add(const Statistics& other);
+
+			UInt32 trackCount;
+			UInt32 constantTrackCount;
+			UInt32 uncompressedTrackCount;
+			UInt32 sourceKeyCount;
+			UInt32 keyCount;
+			// sizes in bytes
+			UInt32 sourceSize;
+			UInt32 size;
+			// largest reconstruction error of any source key
+			Real maxTranslationError;
+			Real maxScaleError;
+			Real maxRotationError;
+		};
+
+		// Compress every used channel of [animation] in place. The uncompressed key frames are released.
+		static Statistics compress(WeakPointer<Animation> animation, const Settings& settings);
+		static Statistics compress(KeyFrameSet& keyFrameSet, const Settings& settings);
+
+	private:
+		AnimationCompressor();
+	};
+}
@@ -0,0 +1,122 @@
+#include <algorithm>
+
+#include "AnimationLODScheduler.h"
+#include "../math/Math.h"
+
+namespace Core {
+
+	AnimationLODScheduler::PlayerState::PlayerState() {
+		this->nodeCount = 0;
+		this->visibilityReported = false;
+		this->lastReportFrame = 0;
+		this->lastVisibleFrame = 0;
+		this->cameraDistance = 0.0f;
+		this->mode = UpdateMode::Full;
+		this->updateInterval = 1;
+		this->framesSinceEvaluation = 0;
+		this->evaluate = true;
+		this->resetPose = true;
+		this->blendFactor = 1.0f;
+		this->evaluatedMode = UpdateMode::Frozen;
+	}
+
+	AnimationLODScheduler::AnimationLODScheduler() {
+	}
+
+	AnimationLODScheduler::~AnimationLODScheduler() {
+	}
+
+	void AnimationLODScheduler::setSettings(const Settings& settings) {
+		this->settings = settings;
+	}
+
+	const AnimationLODScheduler::Settings& AnimationLODScheduler::getSettings() const {
+		return this->settings;
+	}
+
+	/*
+	 * Record that the player owning [state] was drawn (or culled, if [visible] is false) in a view
+	 * [cameraDistance] away during [frame]. With several views in a frame, the closest one counts.
+	 */
+	void AnimationLODScheduler::reportVisibility(PlayerState& state, Real cameraDistance, Bool visible, UInt64 frame) const {
+		if (!state.visibilityReported || state.lastReportFrame != frame) {
+			state.cameraDistance = cameraDistance;
+		} else {
+			state.cameraDistance = Math::min(state.cameraDistance, cameraDistance);
+		}
+
+		state.visibilityReported = true;
+		state.lastReportFrame = frame;
+		if (visible) state.lastVisibleFrame = frame;
+	}
+
+	UInt32 AnimationLODScheduler::getUpdateInterval(Real cameraDistance) const {
+		if (cameraDistance <= this->settings.fullRateDistance || this->settings.intervalDistance <= 0.0f) return 1;
+
+		Real steps = (cameraDistance - this->settings.fullRateDistance) / this->settings.intervalDistance;
+		UInt32 maxInterval = Math::max(this->settings.maxUpdateInterval, 1u);
+		if (steps >= (Real)maxInterval) return maxInterval;
+		return Math::min(2 + (UInt32)steps, maxInterval);
+	}
+
+	/*
+	 * Decide the update mode of each player in [players] for [frame], and which of them are evaluated.
+	 * Returns the number of node evaluations scheduled.
+	 */
+	UInt32 AnimationLODScheduler::schedule(const std::vector<PlayerState*>& players, UInt64 frame) {
+		this->candidates.clear();
+
+		for (PlayerState * state : players) {
+			if (!this->settings.enabled || !state->visibilityReported) {
+				state->mode = UpdateMode::Full;
+				state->updateInterval = 1;
+			} else if (frame > state->lastVisibleFrame + this->settings.visibilityTimeout) {
+				state->mode = this->settings.offscreenMode;
+				state->updateInterval = 1;
+			} else {
+				state->mode = UpdateMode::Full;
+				state->updateInterval = this->getUpdateInterval(state->cameraDistance);
+			}
+
+			state->resetPose = state->mode == UpdateMode::Full && state->evaluatedMode != UpdateMode::Full;
+			state->evaluate = false;
+			if (state->framesSinceEvaluation < 0xFFFFFFFF) state->framesSinceEvaluation++;
+
+			if (state->mode == UpdateMode::Frozen) continue;
+			if (state->resetPose || state->framesSinceEvaluation >= state->updateInterval) {
+				this->candidates.push_back(state);
+			}
+		}
+
+		// the most overdue players are served first, closer ones before further ones
+		std::sort(this->candidates.begin(), this->candidates.end(), [](const PlayerState * a, const PlayerState * b) {
+			UInt64 urgencyA = (UInt64)a->framesSinceEvaluation * b->updateInterval;
+			UInt64 urgencyB = (UInt64)b->framesSinceEvaluation * a->updateInterval;
+			if (urgencyA != urgencyB) return urgencyA > urgencyB;
+			return a->cameraDistance < b->cameraDistance;
+		});
+
+		UInt32 evaluations = 0;
+		UInt32 budget = this->settings.enabled ? this->settings.boneEvaluationBudget : 0;
+		for (PlayerState * state : this->candidates) {
+			UInt32 cost = state->mode == UpdateMode::RootOnly ? 1 : state->nodeCount;
+			// the first player is always evaluated, so that a budget smaller than one skeleton doesn't stall everything
+			if (budget > 0 && evaluations > 0 && evaluations + cost > budget) continue;
+
+			state->evaluate = true;
+			state->framesSinceEvaluation = 0;
+			state->evaluatedMode = state->mode;
+			evaluations += cost;
+		}
+
+		for (PlayerState * state : players) {
+			if (state->mode != UpdateMode::Full || state->updateInterval <= 1 || (state->resetPose && state->evaluate)) {
+				state->blendFactor = 1.0f;
+			} else {
+				state->blendFactor = Math::min(1.0f, (Real)(state->framesSinceEvaluation + 1) / (Real)state->updateInterval);
+			}
+		}
+
+		return evaluations;
+	}
+}
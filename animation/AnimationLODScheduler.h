@@ -0,0 +1,110 @@
+/*********************************************
+*
+* class: AnimationLODScheduler
+*
+* Decides, once per frame, how much work each AnimationPlayer does (animation LOD):
+*
+*   - players that were visible recently and are close to the camera are evaluated every frame,
+*   - players further away are evaluated every few frames, and in between the player blends from
+*     the previously evaluated pose towards the last one,
+*   - players that have not been visible for a while are either frozen or only update their root
+*     node (so that root motion carries on).
+*
+* Animation progress always advances, so a player that comes back into view resumes at the right
+* point. An optional budget limits the number of node (bone) evaluations per frame; players that
+* are due are then served in order of how overdue they are.
+*
+* The scheduler only operates on PlayerState records, so it can be driven headlessly by reporting
+* synthetic distances and visibility.
+*
+***********************************************/
+
+#pragma once
+
+#include <vector>
+
+#include "../common/types.h"
+
+namespace Core {
+
+	class AnimationLODScheduler final {
+	public:
+
+		enum class UpdateMode {
+			Full = 0,
+			RootOnly = 1,
+			Frozen = 2
+		};
+
+		class Settings {
+		public:
+			Settings() {
+				this->enabled = false;
+				this->fullRateDistance = 20.0f;
+				this->intervalDistance = 20.0f;
+				this->maxUpdateInterval = 4;
+				this->offscreenMode = UpdateMode::RootOnly;
+				this->visibilityTimeout = 2;
+				this->boneEvaluationBudget = 0;
+			}
+
+			// when disabled every player is evaluated in full every frame
+			Bool enabled;
+			// players closer to the camera than this are evaluated every frame
+			Real fullRateDistance;
+			// beyond [fullRateDistance], every [intervalDistance] adds one frame to a player's update interval
+			Real intervalDistance;
+			UInt32 maxUpdateInterval;
+			// what players that are not visible do: RootOnly or Frozen
+			UpdateMode offscreenMode;
+			// number of frames without a visible report after which a player is considered off-screen
+			UInt32 visibilityTimeout;
+			// maximum number of node evaluations per frame, 0 for no limit
+			UInt32 boneEvaluationBudget;
+		};
+
+		class PlayerState {
+		public:
+			PlayerState();
+
+			// number of nodes evaluated by a full update
+			UInt32 nodeCount;
+
+			// visibility and distance, see reportVisibility()
+			Bool visibilityReported;
+			UInt64 lastReportFrame;
+			UInt64 lastVisibleFrame;
+			Real cameraDistance;
+
+			// the decision made by the last call to schedule()
+			UpdateMode mode;
+			UInt32 updateInterval;
+			UInt32 framesSinceEvaluation;
+			// evaluate the animations this frame
+			Bool evaluate;
+			// the previously evaluated pose is stale (or there is none), so a new pose must not be blended with it
+			Bool resetPose;
+			// how far to blend from the previously evaluated pose to the latest one (1 = latest pose)
+			Real blendFactor;
+
+		private:
+			friend class AnimationLODScheduler;
+			// mode at the time of the last evaluation
+			UpdateMode evaluatedMode;
+		};
+
+		AnimationLODScheduler();
+		~AnimationLODScheduler();
+
+		void setSettings(const Settings& settings);
+		const Settings& getSettings() const;
+
+		void reportVisibility(PlayerState& state, Real cameraDistance, Bool visible, UInt64 frame) const;
+		UInt32 getUpdateInterval(Real cameraDistance) const;
+		UInt32 schedule(const std::vector<PlayerState*>& players, UInt64 frame);
+
+	private:
+		Settings settings;
+		std::vector<PlayerState*> candidates;
+	};
+}
@@ -21,6 +21,8 @@ namespace Core {
 	* Default constructor
 	*/
 	AnimationManager::AnimationManager() {
+		this->frameIndex = 0;
+		this->lastBoneEvaluationCount = 0;
 	}
 
 	/*
@@ -78,6 +80,19 @@ namespace Core {
 	 * Loop through each active AnimationPlayer and drive its playback.
 	 */
 	void AnimationManager::update() {
+		this->frameIndex++;
+
+		// let the scheduler decide how much work each player does this frame
+		this->scheduledPlayers.clear();
+		for (std::unordered_map<UInt64, std::shared_ptr<AnimationPlayer>>::iterator iter = this->activePlayers.begin(); iter != activePlayers.end(); ++iter) {
+			AnimationPlayer * player = iter->second.get();
+			if (player != nullptr) {
+				player->lodState.nodeCount = player->target->getNodeCount();
+				this->scheduledPlayers.push_back(&player->lodState);
+			}
+		}
+		this->lastBoneEvaluationCount = this->lodScheduler.schedule(this->scheduledPlayers, this->frameIndex);
+
 		for (std::unordered_map<UInt64, std::shared_ptr<AnimationPlayer>>::iterator iter = this->activePlayers.begin(); iter != activePlayers.end(); ++iter) {
 			WeakPointer<AnimationPlayer> player = iter->second;
 			if (player.isValid()) {
@@ -86,6 +101,44 @@ namespace Core {
 		}
 	}
 
+	/*
+	 * Configure the animation LOD policy (see AnimationLODScheduler). It is disabled by default.
+	 */
+	void AnimationManager::setLODSettings(const AnimationLODScheduler::Settings& settings) {
+		this->lodScheduler.setSettings(settings);
+	}
+
+	const AnimationLODScheduler::Settings& AnimationManager::getLODSettings() const {
+		return this->lodScheduler.getSettings();
+	}
+
+	Bool AnimationManager::isLODEnabled() const {
+		return this->lodScheduler.getSettings().enabled;
+	}
+
+	/*
+	 * Report that the skeleton [target] was [visible] in a view [cameraDistance] away during the current
+	 * frame. The renderer reports every skinned mesh it draws; the reports drive the update rate of the
+	 * skeleton's AnimationPlayer from the next frame on.
+	 */
+	void AnimationManager::reportVisibility(WeakPointer<Skeleton> target, Real cameraDistance, Bool visible) {
+		if (!target.isValid()) {
+			throw InvalidReferenceException("AnimationManager::reportVisibility -> Target is not valid.");
+		}
+
+		std::unordered_map<UInt64, std::shared_ptr<AnimationPlayer>>::iterator result = this->activePlayers.find(target->getObjectID());
+		if (result != this->activePlayers.end() && result->second) {
+			this->lodScheduler.reportVisibility(result->second->lodState, cameraDistance, visible, this->frameIndex);
+		}
+	}
+
+	/*
+	 * Number of node evaluations the scheduler allotted in the last call to update().
+	 */
+	UInt32 AnimationManager::getLastBoneEvaluationCount() const {
+		return this->lastBoneEvaluationCount;
+	}
+
 	WeakPointer<Animation> AnimationManager::createAnimation(Real durationTicks, Real ticksPerSecond) {
 		Animation * animationPtr = new(std::nothrow) Animation(durationTicks, ticksPerSecond);
 		if (animationPtr == nullptr) {
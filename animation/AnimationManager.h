@@ -12,10 +12,12 @@
 #pragma once
 
 #include <unordered_map>
+#include <vector>
 
 #include "../Engine.h"
 #include "../common/types.h"
 #include "../base/CoreObject.h"
+#include "AnimationLODScheduler.h"
 
 namespace Core {
 
@@ -39,6 +41,11 @@ namespace Core {
 		WeakPointer<Animation> createAnimation(Real durationTicks, Real ticksPerSecond);
 		WeakPointer<AnimationPlayer> retrieveOrCreateAnimationPlayer(WeakPointer<Skeleton> target);
 		WeakPointer<AnimationInstance> createAnimationInstance(WeakPointer<Skeleton> target, WeakPointer<Animation> animation);
+		void setLODSettings(const AnimationLODScheduler::Settings& settings);
+		const AnimationLODScheduler::Settings& getLODSettings() const;
+		Bool isLODEnabled() const;
+		void reportVisibility(WeakPointer<Skeleton> target, Real cameraDistance, Bool visible);
+		UInt32 getLastBoneEvaluationCount() const;
 
 	private:
 
@@ -48,5 +55,11 @@ namespace Core {
 		// map object IDs of Skeleton objects to their assign animation player
 		std::unordered_map<UInt64, std::shared_ptr<AnimationPlayer>> activePlayers;
 		std::vector<std::shared_ptr<AnimationInstance>> instances;
+		// decides how often each player is evaluated (animation LOD)
+		AnimationLODScheduler lodScheduler;
+		std::vector<AnimationLODScheduler::PlayerState*> scheduledPlayers;
+		// incremented by every call to update()
+		UInt64 frameIndex;
+		UInt32 lastBoneEvaluationCount;
 	};
 }
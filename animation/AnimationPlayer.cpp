@@ -30,6 +30,8 @@ namespace Core {
 		this->target = target;
 		this->animationCount = 0;
 		this->playingAnimationsCount = 0;
+		this->rootNodeIndex = 0;
+		this->targetPoseApplied = false;
 	}
 
 	/*
@@ -136,167 +138,171 @@ namespace Core {
 	 * Update the positions of all nodes of the target Skeleton object based on the progress of all
 	 * active animations.
 	 *
-	 * This method loops through each node in the target skeleton [target], and for each node it calculates
-	 * the interpolated translation, rotation, and scale for that node for each active animation. It combines
-	 * those transformations based on the weight of each active animation stored in member [weights] and
-	 * applies the final transformation to the node.
+	 * How much work is done depends on the decision the AnimationLODScheduler made for this player in
+	 * [lodState]: a frozen player leaves its nodes untouched, a root-only player updates just [rootNodeIndex]
+	 * and a player updated at a reduced rate evaluates its animations every few frames, blending from the
+	 * previously evaluated pose towards the latest one in between.
 	 */
 	void AnimationPlayer::applyActiveAnimations() {
-		Vector3r translation;
-		Vector3r scale;
-		Quaternion rotation;
+		if (this->lodState.mode == AnimationLODScheduler::UpdateMode::Frozen) return;
 
-		// storage for aggregate translation, rotation, and scale
-		Vector3r agTranslation;
-		Vector3r agScale;
-		Quaternion agRotation;
-
-		Quaternion temp;
-
-		// temp use Matrices
-		Matrix4x4 rotMatrix;
-		Matrix4x4 matrix;
-
-		// keep track of the number of playing animations seen as we loop through all registered animations
-		UInt32 playingAnimationsSeen = 0;
-
-		// loop through each node in the target Skeleton object, and calculate the position based on
-		// weighted average of positions returned from each active animation
-		for (UInt32 node = 0; node < target->getNodeCount(); node++) {
-			agScale.set(0, 0, 0);
-			agTranslation.set(0, 0, 0);
-			agRotation = Quaternion::Identity;
-
-			playingAnimationsSeen = 0;
-			Real agWeight = 0;
+		UInt32 nodeCount = target->getNodeCount();
+		if (this->lodState.mode == AnimationLODScheduler::UpdateMode::RootOnly) {
+			if (this->lodState.evaluate && this->rootNodeIndex < nodeCount) {
+				this->evaluatePose(this->blendedPose, this->rootNodeIndex, this->rootNodeIndex + 1);
+				if (this->blendedPose.animated) this->applyPose(this->blendedPose, this->rootNodeIndex, this->rootNodeIndex + 1);
+			}
+			return;
+		}
 
-			// get the Skeleton node corresponding to the current node index
-			Skeleton::SkeletonNode * targetNode = target->getNodeFromList(node);
+		if (this->lodState.evaluate) {
+			std::swap(this->previousPose, this->targetPose);
+			Bool previousValid = this->previousPose.getNodeCount() == nodeCount;
+			this->evaluatePose(this->targetPose, 0, nodeCount);
+			if (this->lodState.resetPose || !previousValid) this->previousPose = this->targetPose;
+		} else if (this->lodState.resetPose || this->targetPose.getNodeCount() != nodeCount) {
+			// waiting for a fresh pose, keep the nodes where they are
+			return;
+		}
 
-			// loop through all registered animations
-			for (Int32 i = (Int32)registeredAnimations.size() - 1; i >= 0; i--) {
-				WeakPointer<AnimationInstance> instance = this->registeredAnimations[i];
+		Real blendFactor = this->lodState.blendFactor;
+		if (!this->lodState.evaluate && blendFactor >= 1.0f && this->targetPoseApplied) return;
+		if (!this->targetPose.animated) return;
 
-				// include this animation only if it is playing
-				if (instance.isValid() && instance->playing) {
+		if (blendFactor >= 1.0f || !this->previousPose.animated) {
+			this->applyPose(this->targetPose, 0, nodeCount);
+		} else {
+			this->blendedPose.resize(nodeCount);
+			this->blendedPose.blend(this->previousPose, this->targetPose, blendFactor, 0, nodeCount);
+			this->applyPose(this->blendedPose, 0, nodeCount);
+		}
+		this->targetPoseApplied = blendFactor >= 1.0f;
+	}
 
-					// if this node does not have an animation channel for it in the current animation, then ignore
-					Int32 mappedChannel = instance->getChannelMappingForTargetNode(node);
+	/*
+	 * Calculate the interpolated translation, rotation, and scale of nodes [firstNode] to [lastNode] (exclusive)
+	 * for each active animation and combine them based on the weight of each active animation stored in member
+	 * [weights]. [pose].animated is false if no animation contributed.
+	 */
+	void AnimationPlayer::evaluatePose(PoseBuffer& pose, UInt32 firstNode, UInt32 lastNode) {
+		UInt32 nodeCount = target->getNodeCount();
+		pose.resize(nodeCount);
 
-					// retrieve this animation's weight
-					Real weight = this->animationWeights[i];
+		// keep track of the number of playing animations seen as we loop through all registered animations
+		UInt32 playingAnimationsSeen = 0;
+		Real agWeight = 0;
 
-					// if this animation's weight is 0, then ignore it
-					if (weight <= 0)continue;
+		// loop through all registered animations
+		for (Int32 i = (Int32)registeredAnimations.size() - 1; i >= 0; i--) {
+			WeakPointer<AnimationInstance> instance = this->registeredAnimations[i];
 
-					// calculate aggregate (sum of weights up until this point)
-					agWeight += weight;
+			// include this animation only if it is playing
+			if (!instance.isValid() || !instance->playing) continue;
 
-					// calculate the translation, rotation, and scale for this animation at the current node
-					if (mappedChannel >= 0) {
-						this->calculateInterpolatedValues(instance, mappedChannel, translation, rotation, scale);
-					}
+			// retrieve this animation's weight, if it is 0 then ignore this animation
+			Real weight = this->animationWeights[i];
+			if (weight <= 0)continue;
 
-					// if there is no channel in the current animation for this node, use the
-					// default transformation values for this node
-					else {
-						translation = targetNode->InitialTranslation;
-						rotation = targetNode->InitialRotation;
-						scale = targetNode->InitialScale;
-					}
+			// calculate aggregate (sum of weights up until this point)
+			agWeight += weight;
 
-					// if the number of active animations is 1, indicated by playingAnimationsCount == 1, and its
-					// weight is 1, then we simply use the results from CalculateInterpolatedValues() and apply those
-					// to the current node
-					if (this->playingAnimationsCount == 1 && weight == 1) {
-						agTranslation = translation;
-						agScale = scale;
-						agRotation = rotation;
-					}
-					// we have to apply weights across 1 or more animations
-					else {
-
-						// apply weight to each transformation
-						translation.scale(weight);
-						scale.scale(weight);
-						rotation.set(rotation.x() * weight, rotation.y() * weight, rotation.z() * weight, rotation.w() * weight);
-
-						// if this is the first active animation encountered, set the aggregate translation, rotation and scale
-						if (playingAnimationsSeen == 0) {
-							agTranslation = translation;
-							agScale = scale;
-							agRotation = rotation;
-						}
-						// this is not the first active animation encountered, so we additively combine the translation
-						// and scale into their aggregate counterparts. we use spherical interpolation to combine the
-						// rotation for this animation into the aggregate rotation.
-						else {
-							agTranslation = translation + agTranslation;
-							agScale = scale + agScale;
+			// if the number of active animations is 1, indicated by playingAnimationsCount == 1, and its
+			// weight is 1, then we simply use the sampled pose as is
+			if (this->playingAnimationsCount == 1 && weight == 1) {
+				this->sampleAnimation(instance.get(), pose, firstNode, lastNode);
+			}
+			// we have to apply weights across 1 or more animations
+			else {
+				this->samplePose.resize(nodeCount);
+				this->sampleAnimation(instance.get(), this->samplePose, firstNode, lastNode);
+
+				// if this is the first active animation encountered, set the aggregate pose, otherwise
+				// additively combine it into the aggregate pose
+				if (playingAnimationsSeen == 0) pose.setWeighted(this->samplePose, weight, firstNode, lastNode);
+				else pose.addWeighted(this->samplePose, weight, weight / agWeight, firstNode, lastNode);
+			}
 
-							if (agWeight != 0)temp = Quaternion::slerp(agRotation, rotation, weight / agWeight);
-							else temp = rotation;
+			playingAnimationsSeen++;
+		}
 
-							agRotation = temp;
-						}
-					}
+		pose.weight = agWeight;
+		pose.animated = playingAnimationsSeen > 0;
+	}
 
-					playingAnimationsSeen++;
-				}
+	/*
+	 * Sample [instance] at its current progress for nodes [firstNode] to [lastNode] (exclusive) and store the
+	 * result in [pose]. Nodes without a channel in the animation get their initial transformation values.
+	 */
+	void AnimationPlayer::sampleAnimation(AnimationInstance * instance, PoseBuffer& pose, UInt32 firstNode, UInt32 lastNode) {
+		const AnimationTracks& tracks = instance->sourceAnimation->getTracks();
+		Bool hasStartOffset = instance->startOffset > 0;
+
+		Real translation[3];
+		Real rotation[4];
+		Real scale[3];
+		UInt32 keyHints[3];
+
+		for (UInt32 node = firstNode; node < lastNode; node++) {
+			Int32 channel = instance->nodeToChannelMap[node];
+
+			Bool sampled = false;
+			if (channel >= 0) {
+				// the key indices found in the previous update are where the search for the current keys starts
+				AnimationInstance::FrameState& frameState = instance->frameStates[node];
+				keyHints[0] = frameState.TranslationKeyIndex;
+				keyHints[1] = frameState.RotationKeyIndex;
+				keyHints[2] = frameState.ScaleKeyIndex;
+				sampled = tracks.sample((UInt32)channel, instance->progress, instance->duration, hasStartOffset, keyHints, translation, rotation, scale);
+				frameState.TranslationKeyIndex = keyHints[0];
+				frameState.RotationKeyIndex = keyHints[1];
+				frameState.ScaleKeyIndex = keyHints[2];
 			}
 
-			// only apply transformations if they were actually calculated
-			if (playingAnimationsSeen > 0) {
-
-				matrix.setIdentity();
-				// apply interpolated scale
-				matrix.scale(agScale.x, agScale.y, agScale.z);
-				// apply interpolated rotation
-				agRotation.normalize();
-				rotMatrix = agRotation.rotationMatrix();
-
-				matrix.preMultiply(rotMatrix);
-				// apply interpolated translation
-				matrix.preTranslate(agTranslation.x, agTranslation.y, agTranslation.z);
-
-				// if the agWeight for some reason is less than one, compensate by using
-				// the initial transformation values for the node
-				if (agWeight < .99) {
-					Matrix4x4 temp = targetNode->InitialTransform;
-					temp.multiplyByScalar(((Real)1.0 - agWeight));
-					matrix.add(temp);
-				}
-
-				if (targetNode->hasTarget()) {
-					// get the local transform of the target of this node and apply
-					// [matrix], which contains the interpolated scale, rotation, and translation
-					Matrix4x4& localTransform = targetNode->getLocalTransform();
-					localTransform.copy(matrix);
-				}
+			if (!sampled) {
+				Skeleton::SkeletonNode * targetNode = target->getNodeFromList(node);
+				translation[0] = targetNode->InitialTranslation.x;
+				translation[1] = targetNode->InitialTranslation.y;
+				translation[2] = targetNode->InitialTranslation.z;
+				rotation[0] = targetNode->InitialRotation.x();
+				rotation[1] = targetNode->InitialRotation.y();
+				rotation[2] = targetNode->InitialRotation.z();
+				rotation[3] = targetNode->InitialRotation.w();
+				scale[0] = targetNode->InitialScale.x;
+				scale[1] = targetNode->InitialScale.y;
+				scale[2] = targetNode->InitialScale.z;
 			}
+
+			pose.setNode(node, translation, rotation, scale);
 		}
 	}
 
 	/*
-	 * Use the current progress of [instance] to find the two closest key frames in the KeyFrameSet specified by [channel].
-	 * Then interpolate between those two key frames based on where the progress of [instance] lies between them, and store the
-	 * interpolated translation, rotation, and scale values in [translation], [rotation], and [scale].
+	 * Build the local transformations of nodes [firstNode] to [lastNode] (exclusive) from the scale, rotation,
+	 * and translation in [pose].
 	 */
-	void AnimationPlayer::calculateInterpolatedValues(WeakPointer<AnimationInstance> instance, UInt32 channel, Vector3r& translation, Quaternion& rotation, Vector3r& scale) const
-	{
-		Animation * animationPtr = const_cast<Animation *>(instance->sourceAnimation.get());
-		KeyFrameSet * frameSet = animationPtr->getKeyFrameSet(channel);
-		if (frameSet == nullptr) {
-			throw NullPointerException("AnimationPlayer::calculateInterpolatedValues -> 'frameSet' is null.");
-		}
-
-		// make sure it's an active KeyFrameSet
-		if (frameSet != nullptr && frameSet->Used) {
-			// for each of translation, scale, and rotation, find the two respective key frames between which
-			// instance->Progress lies, and interpolate between them based on instance->Progress.
-			this->calculateInterpolatedTranslation(instance, *frameSet, translation);
-			this->calculateInterpolatedScale(instance, *frameSet, scale);
-			this->calculateInterpolatedRotation(instance, *frameSet, rotation);
+	void AnimationPlayer::applyPose(const PoseBuffer& pose, UInt32 firstNode, UInt32 lastNode) {
+		this->localMatrices.resize((lastNode - firstNode) * 16);
+		pose.composeMatrices(this->localMatrices.data(), firstNode, lastNode);
+
+		Matrix4x4 matrix;
+		for (UInt32 node = firstNode; node < lastNode; node++) {
+			Skeleton::SkeletonNode * targetNode = target->getNodeFromList(node);
+			if (!targetNode->hasTarget()) continue;
+
+			matrix.copy(&this->localMatrices[(node - firstNode) * 16]);
+
+			// if the aggregate weight for some reason is less than one, compensate by using
+			// the initial transformation values for the node
+			if (pose.weight < .99) {
+				Matrix4x4 temp = targetNode->InitialTransform;
+				temp.multiplyByScalar(((Real)1.0 - pose.weight));
+				matrix.add(temp);
+			}
+
+			// get the local transform of the target of this node and apply [matrix],
+			// which contains the interpolated scale, rotation, and translation
+			Matrix4x4& localTransform = targetNode->getLocalTransform();
+			localTransform.copy(matrix);
 		}
 	}
 
@@ -349,218 +355,6 @@ namespace Core {
 		}
 	}
 
-	/*
-	 * Use the value of instance->progress to find the two closest translation key frames in [keyFrameSet]. Then interpolate between the translation
-	 * values in those two key frames based on where instance->progress lies between them, and store the result in [vector].
-	 */
-	void AnimationPlayer::calculateInterpolatedTranslation(WeakPointer<AnimationInstance> instance, const KeyFrameSet& keyFrameSet, Vector3r& vector) const {
-		if (!instance.isValid()) {
-			throw InvalidReferenceException("AnimationPlayer::calculateInterpolatedTranslation -> 'instance' is invalid.");
-		}
-
-		UInt32 frameCount = (UInt32)keyFrameSet.TranslationKeyFrames.size();
-		if (frameCount == 0) {
-			throw Exception("AnimationPlayer::calculateInterpolatedTranslation -> Key frame count is zero.");
-		}
-
-		UInt32 previousIndex, nextIndex;
-		Real interFrameProgress;
-		Bool foundFrames = this->calculateInterpolation(instance, keyFrameSet, previousIndex, nextIndex, interFrameProgress, TransformationCompnent::Translation);
-
-		// did we successfully find 2 frames between which to interpolate?
-		if (foundFrames) {
-			const TranslationKeyFrame& nextFrame = keyFrameSet.TranslationKeyFrames[nextIndex];
-			const TranslationKeyFrame& previousFrame = keyFrameSet.TranslationKeyFrames[previousIndex];
-
-			vector.x = ((nextFrame.Translation.x - previousFrame.Translation.x) * interFrameProgress) + previousFrame.Translation.x;
-			vector.y = ((nextFrame.Translation.y - previousFrame.Translation.y) * interFrameProgress) + previousFrame.Translation.y;
-			vector.z = ((nextFrame.Translation.z - previousFrame.Translation.z) * interFrameProgress) + previousFrame.Translation.z;
-
-		} else { //we did not find 2 frames, so set translation equal to the first frame
-			const TranslationKeyFrame& firstFrame = keyFrameSet.TranslationKeyFrames[0];
-			vector.set(firstFrame.Translation.x, firstFrame.Translation.y, firstFrame.Translation.y);
-		}
-	}
-
-	/*
-	 * Use the value of instance->progress to find the two closest scale key frames in [keyFrameSet]. Then interpolate between the scale
-	 * values in those two key frames based on where instance->progress lies between them, and store the result in [vector].
-	 */
-	void AnimationPlayer::calculateInterpolatedScale(WeakPointer<AnimationInstance> instance, const KeyFrameSet& keyFrameSet, Vector3r& vector) const {
-		
-		if (!instance.isValid()) {
-			throw InvalidReferenceException("AnimationPlayer::calculateInterpolatedScale -> 'instance' is invalid.");
-		}
-
-		UInt32 frameCount = (UInt32)keyFrameSet.ScaleKeyFrames.size();
-		if (frameCount == 0) {
-			throw Exception("AnimationPlayer::calculateInterpolatedScale -> Key frame count is zero.");
-		}
-
-		UInt32 previousIndex, nextIndex;
-		Real interFrameProgress;
-		Bool foundFrames = calculateInterpolation(instance, keyFrameSet, previousIndex, nextIndex, interFrameProgress, TransformationCompnent::Scale);
-
-		// did we successfully find 2 frames between which to interpolate?
-		if (foundFrames) {
-			const ScaleKeyFrame& nextFrame = keyFrameSet.ScaleKeyFrames[nextIndex];
-			const ScaleKeyFrame& previousFrame = keyFrameSet.ScaleKeyFrames[previousIndex];
-
-			// perform interpolation
-			vector.x = ((nextFrame.Scale.x - previousFrame.Scale.x) * interFrameProgress) + previousFrame.Scale.x;
-			vector.y = ((nextFrame.Scale.y - previousFrame.Scale.y) * interFrameProgress) + previousFrame.Scale.y;
-			vector.z = ((nextFrame.Scale.z - previousFrame.Scale.z) * interFrameProgress) + previousFrame.Scale.z;
-		} else {//we did not find 2 frames, so set scale equal to the first frame
-			const ScaleKeyFrame& firstFrame = keyFrameSet.ScaleKeyFrames[0];
-			vector.set(firstFrame.Scale.x, firstFrame.Scale.y, firstFrame.Scale.y);
-		}
-	}
-
-	/*
-	 * Use the value of instance->progress to find the two closest rotation key frames in [keyFrameSet]. Then interpolate between the rotation
-	 * values in those two key frames based on where instance->progress lies between them, and store the result in [rotation].
-	 */
-	void AnimationPlayer::calculateInterpolatedRotation(WeakPointer<AnimationInstance> instance, const KeyFrameSet& keyFrameSet, Quaternion& rotation) const {
-		
-		if (!instance.isValid()) {
-			throw InvalidReferenceException("AnimationPlayer::calculateInterpolatedRotation -> 'instance' is invalid.");
-		}
-
-		UInt32 frameCount = (UInt32)keyFrameSet.RotationKeyFrames.size();
-		if (frameCount == 0) {
-			throw Exception("AnimationPlayer::calculateInterpolatedRotation -> Key frame count is zero.");
-		}
-
-		UInt32 previousIndex, nextIndex;
-		Real interFrameProgress;
-		Bool foundFrames = this->calculateInterpolation(instance, keyFrameSet, previousIndex, nextIndex, interFrameProgress, TransformationCompnent::Rotation);
-
-		// did we successfully find 2 frames between which to interpolate?
-		if (foundFrames) {
-			const RotationKeyFrame& nextFrame = keyFrameSet.RotationKeyFrames[nextIndex];
-			const RotationKeyFrame& previousFrame = keyFrameSet.RotationKeyFrames[previousIndex];
-
-			// perform spherical interpolation between the two Quaternions
-			Quaternion a(previousFrame.Rotation.x(), previousFrame.Rotation.y(), previousFrame.Rotation.z(), previousFrame.Rotation.w());
-			Quaternion b(nextFrame.Rotation.x(), nextFrame.Rotation.y(), nextFrame.Rotation.z(), nextFrame.Rotation.w());
-			Quaternion quatOut = Quaternion::slerp(a, b, interFrameProgress);
-			rotation.set(quatOut.x(), quatOut.y(), quatOut.z(), quatOut.w());
-
-		} else {//we did not find 2 frames, so set rotation equal to the first frame
-			const RotationKeyFrame& firstFrame = keyFrameSet.RotationKeyFrames[0];
-			rotation.set(firstFrame.Rotation.x(), firstFrame.Rotation.y(), firstFrame.Rotation.z(), firstFrame.Rotation.w());
-		}
-	}
-
-	/*
-	 * This method uses the value of instance->progress to find the two closest key frames in [keyFrameSet], of the type specified by [component]
-	 * and then stores the indices of those key frames in [previousIndex] and [nextIndex]. Then it uses instance->progress to determine how far from [lastIndex]
-	 * to [nextIndex] the animation currently is, and stores that value in [interFrameProgress] (range: 0 to 1).
-	 */
-	Bool AnimationPlayer::calculateInterpolation(WeakPointer<AnimationInstance> instance, const KeyFrameSet& keyFrameSet, UInt32& previousIndex, UInt32& nextIndex, Real& interFrameProgress, TransformationCompnent component) const {
-		if (!instance.isValid()) {
-			throw InvalidReferenceException("AnimationPlayer::calculateInterpolation -> 'instance' is invalid.");
-		}
-
-		UInt32 frameCount = 0;
-		Real progress = instance->progress;
-		Real duration = instance->duration;
-
-		// get the correct frame count, which depends on [component]
-		if (component == TransformationCompnent::Translation)frameCount = (UInt32)keyFrameSet.TranslationKeyFrames.size();
-		else if (component == TransformationCompnent::Rotation)frameCount = (UInt32)keyFrameSet.RotationKeyFrames.size();
-		else if (component == TransformationCompnent::Scale)frameCount = (UInt32)keyFrameSet.ScaleKeyFrames.size();
-		else return false;
-
-		// loop through each key frame
-		for (UInt32 f = 0; f < frameCount; f++) {
-
-			KeyFrame * previousFrame = nullptr;
-			KeyFrame * nextFrame = nullptr;
-
-			// get the correct time stamp for this frame, which depends on [component]
-			Real keyRealTime = this->getKeyFrameTime(component, f, keyFrameSet);
-
-			// if the RealTime value for this key frame is greater than [progress], then the previous key frame and the current key frame
-			// are the frames we want
-			if (keyRealTime > progress || f == frameCount - 1) {
-				previousIndex = 0;
-				if (f > 0)previousIndex = f - 1;
-				nextIndex = f;
-
-				// flag that indicates we need to interpolate from the last frame to the first frame
-				Bool overShoot = false;
-
-				// if f==frameCount-1 and keyRealTime <= progress, then we have reached the last frame and progress has moved
-				// beyond it. this means we need to interpolate between the last frame and the first frame (for smoothed animation looping).
-				if (f == frameCount - 1 && keyRealTime <= progress)
-				{
-					previousIndex = f;
-					nextIndex = 0;
-
-					// if the start offset for this animation is > 0, then we can't assume the
-					// next frame will be at index 0. in this case we must loop through each
-					// frame to find which one has a timestamp greater than StartOffset.
-					if (instance->startOffset > 0) {
-						for (UInt32 ff = 0; ff < frameCount; ff++) {
-							// get the correct time stamp for for frame [ff], which depends on [component]
-							Real nextKeyRealTime = this->getKeyFrameTime(component, ff, keyFrameSet);
-							if (nextKeyRealTime > instance->startOffset || ff == frameCount - 1) {
-								nextIndex = ff;
-							}
-						}
-					}
-					overShoot = true;
-				}
-
-				// get pointers to the previous frame and the next frame
-				if (component == TransformationCompnent::Translation) {
-					const TranslationKeyFrame& nextTranslationFrame = keyFrameSet.TranslationKeyFrames[nextIndex];
-					const TranslationKeyFrame& lastTranslationFrame = keyFrameSet.TranslationKeyFrames[previousIndex];
-					nextFrame = const_cast<TranslationKeyFrame *>(&nextTranslationFrame);
-					previousFrame = const_cast<TranslationKeyFrame *>(&lastTranslationFrame);
-				} else if (component == TransformationCompnent::Rotation) {
-					const RotationKeyFrame& nextRotationFrame = keyFrameSet.RotationKeyFrames[nextIndex];
-					const RotationKeyFrame& lastRotationFrame = keyFrameSet.RotationKeyFrames[previousIndex];
-					nextFrame = const_cast<RotationKeyFrame *>(&nextRotationFrame);
-					previousFrame = const_cast<RotationKeyFrame *>(&lastRotationFrame);
-				} else if (component == TransformationCompnent::Scale) {
-					const ScaleKeyFrame& nextScaleFrame = keyFrameSet.ScaleKeyFrames[nextIndex];
-					const ScaleKeyFrame& lastScaleFrame = keyFrameSet.ScaleKeyFrames[previousIndex];
-					nextFrame = const_cast<ScaleKeyFrame *>(&nextScaleFrame);
-					previousFrame = const_cast<ScaleKeyFrame *>(&lastScaleFrame);
-				}
-
-				// calculate local progress between [previous] and [nextFrame]
-				Real interFrameTimeDelta = nextFrame->RealTime - previousFrame->RealTime;
-				if (overShoot)  interFrameTimeDelta = duration - previousFrame->RealTime;
-
-				Real interFrameElapsed = progress - previousFrame->RealTime;
-				interFrameProgress = 1;
-				if (interFrameTimeDelta > 0)interFrameProgress = interFrameElapsed / interFrameTimeDelta;
-
-				return true;
-			}
-		}
-
-		return false;
-	}
-
-	/*
-	 * Get the key frame time for the frame at [frameIndex] for the desired transformation component [transformationComponent].
-	 */
-	Real AnimationPlayer::getKeyFrameTime(TransformationCompnent transformationComponent, Int32 frameIndex, const KeyFrameSet& keyFrameSet) const {
-		Real keyFrameTime = 0;
-		if (transformationComponent == TransformationCompnent::Translation)
-			keyFrameTime = keyFrameSet.TranslationKeyFrames[frameIndex].RealTime;
-		else if (transformationComponent == TransformationCompnent::Rotation)
-			keyFrameTime = keyFrameSet.RotationKeyFrames[frameIndex].RealTime;
-		else if (transformationComponent == TransformationCompnent::Scale)
-			keyFrameTime = keyFrameSet.ScaleKeyFrames[frameIndex].RealTime;
-
-		return keyFrameTime;
-	}
-
 	/*
 	 * Add an Animation object [animation] to this player. The Animation must be compatible with
 	 * the existing target of this player.
@@ -587,6 +381,9 @@ namespace Core {
 				throw Exception("AnimationPlayer::createAnimationInstance -> Unable to initialize animation instance.");
 			}
 
+			// lay out the key frames for sampling now rather than on the first update
+			animation->getTracks();
+
 			this->registeredAnimations.push_back(instance);
 			this->animationWeights.push_back(0);
 			this->crossFadeTargets.push_back(false);
@@ -870,6 +667,23 @@ namespace Core {
 	}
 
 
+	/*
+	 * Set the node that keeps being updated when this player is restricted to root-only updates
+	 * (see AnimationLODScheduler), typically the node that carries root motion. Defaults to the
+	 * first node of the target skeleton.
+	 */
+	void AnimationPlayer::setRootNode(const std::string& name) {
+		Int32 nodeIndex = this->target->getNodeMapping(name);
+		if (nodeIndex < 0) {
+			throw InvalidArgumentException("AnimationPlayer::setRootNode -> Target has no node with that name.");
+		}
+		this->rootNodeIndex = (UInt32)nodeIndex;
+	}
+
+	const AnimationLODScheduler::PlayerState& AnimationPlayer::getLODState() const {
+		return this->lodState;
+	}
+
 	void AnimationPlayer::setPlaybackMode(WeakPointer<Animation> target, PlaybackMode playbackMode) {
 		if (this->animationIndexMap.find(target->getObjectID()) != this->animationIndexMap.end()) {
 			UInt32 targetIndex = this->animationIndexMap[target->getObjectID()];
@@ -20,6 +20,8 @@
 #include "../geometry/Vector3.h"
 #include "../math/Quaternion.h"
 #include "KeyFrameSet.h"
+#include "AnimationLODScheduler.h"
+#include "PoseBuffer.h"
 
 namespace Core {
 	//forward declarations
@@ -58,6 +60,8 @@ namespace Core {
 		void crossFade(WeakPointer<Animation> target, Real duration);
 		void crossFade(WeakPointer<Animation> target, Real duration, Bool queued);
 		void setPlaybackMode(WeakPointer<Animation> target, PlaybackMode playbackMode);
+		void setRootNode(const std::string& name);
+		const AnimationLODScheduler::PlayerState& getLODState() const;
 
 	private:
 
@@ -77,6 +81,18 @@ namespace Core {
 		std::vector<Bool> crossFadeTargets;
 		// number of animations currently playing
 		Int32 playingAnimationsCount;
+		// update policy for this player, maintained by the AnimationManager's AnimationLODScheduler
+		AnimationLODScheduler::PlayerState lodState;
+		// the node that is still updated when the scheduler restricts this player to root-only updates
+		UInt32 rootNodeIndex;
+		// the two most recently evaluated poses, blended between when the player is updated at a reduced rate
+		PoseBuffer previousPose;
+		PoseBuffer targetPose;
+		Bool targetPoseApplied;
+		// scratch buffers: the pose of a single animation, the blended pose and the composed local transformations
+		PoseBuffer samplePose;
+		PoseBuffer blendedPose;
+		std::vector<Real> localMatrices;
 
 		AnimationPlayer(WeakPointer<Skeleton> target);
 
@@ -88,14 +104,11 @@ namespace Core {
 		void updateBlendingOperations();
 		void checkWeights();
 		void applyActiveAnimations();
+		void evaluatePose(PoseBuffer& pose, UInt32 firstNode, UInt32 lastNode);
+		void sampleAnimation(AnimationInstance * instance, PoseBuffer& pose, UInt32 firstNode, UInt32 lastNode);
+		void applyPose(const PoseBuffer& pose, UInt32 firstNode, UInt32 lastNode);
 		void updateAnimationsProgress();
 		void updateAnimationInstanceProgress(WeakPointer<AnimationInstance> instance) const;
-		void calculateInterpolatedValues(WeakPointer<AnimationInstance> instance, UInt32 channel, Vector3r& translation, Quaternion& rotation, Vector3r& scale) const;
-		void calculateInterpolatedTranslation(WeakPointer<AnimationInstance> instance, const KeyFrameSet& keyFrameSet, Vector3r& vector) const;
-		void calculateInterpolatedScale(WeakPointer<AnimationInstance> instance, const KeyFrameSet& keyFrameSet, Vector3r& vector) const;
-		void calculateInterpolatedRotation(WeakPointer<AnimationInstance> instance, const KeyFrameSet& keyFrameSet, Quaternion& rotation) const;
-		Bool calculateInterpolation(WeakPointer<AnimationInstance> instance, const KeyFrameSet& keyFrameSet, UInt32& lastIndex, UInt32& nextIndex, Real& interFrameProgress, TransformationCompnent component) const;
-		Real getKeyFrameTime(TransformationCompnent transformationComponent, Int32 frameIndex, const KeyFrameSet& keyFrameSet) const;
 
 		void setSpeed(UInt32 animationIndex, Real speedFactor);
 		void play(UInt32 animationIndex);
@@ -0,0 +1,208 @@
+#include <algorithm>
+
+#include "AnimationTracks.h"
+#include "KeyFrameSet.h"
+#include "CompressedKeyFrames.h"
+#include "../geometry/Vector3.h"
+#include "../math/Quaternion.h"
+#include "../common/Exception.h"
+
+namespace Core {
+
+	/*
+	 * Find the two keys in [times] between which [time] lies, and how far from [previous] to [next] it is.
+	 * A time beyond the last key interpolates from the last key back to the first over the remainder of
+	 * [duration] (for smoothly looping animations), or holds the last key if the animation has a start offset.
+	 * [hint] is the result of the previous search and is checked first.
+	 */
+	static void findKeys(const Real * times, UInt32 count, Real time, Real duration, Bool hasStartOffset,
+	                     UInt32& hint, UInt32& previous, UInt32& next, Real& progress) {
+		UInt32 f = hint;
+		if (f >= count || times[f] <= time || (f > 0 && times[f - 1] > time)) {
+			f = (UInt32)(std::upper_bound(times, times + count, time) - times);
+			if (f == count) f = count - 1;
+		}
+		hint = f;
+
+		Bool overShoot = false;
+		if (f == count - 1 && times[f] <= time) {
+			previous = f;
+			next = hasStartOffset ? count - 1 : 0;
+			overShoot = true;
+		} else {
+			previous = f > 0 ? f - 1 : 0;
+			next = f;
+		}
+
+		Real delta = overShoot ? duration - times[previous] : times[next] - times[previous];
+		progress = 1;
+		if (delta > 0) progress = (time - times[previous]) / delta;
+	}
+
+	static void sampleVector(const AnimationTracks::Track& track, const std::vector<Real>& times, const std::vector<Real>& values,
+	                         Real time, Real duration, Bool hasStartOffset, UInt32& hint, Real * out) {
+		UInt32 previous, next;
+		Real progress;
+		if (track.compressed != nullptr) {
+			findKeys(track.compressed->Times.data(), track.keyCount, time, duration, hasStartOffset, hint, previous, next, progress);
+			Vector3r a, b;
+			track.compressed->getVector(previous, a);
+			track.compressed->getVector(next, b);
+			out[0] = ((b.x - a.x) * progress) + a.x;
+			out[1] = ((b.y - a.y) * progress) + a.y;
+			out[2] = ((b.z - a.z) * progress) + a.z;
+			return;
+		}
+
+		findKeys(&times[track.firstKey], track.keyCount, time, duration, hasStartOffset, hint, previous, next, progress);
+		const Real * a = &values[(track.firstKey + previous) * 3];
+		const Real * b = &values[(track.firstKey + next) * 3];
+		out[0] = ((b[0] - a[0]) * progress) + a[0];
+		out[1] = ((b[1] - a[1]) * progress) + a[1];
+		out[2] = ((b[2] - a[2]) * progress) + a[2];
+	}
+
+	static void sampleRotation(const AnimationTracks::Track& track, const std::vector<Real>& times, const std::vector<Real>& values,
+	                           Real time, Real duration, Bool hasStartOffset, UInt32& hint, Real * out) {
+		UInt32 previous, next;
+		Real progress;
+		Quaternion a, b;
+		if (track.compressed != nullptr) {
+			findKeys(track.compressed->Times.data(), track.keyCount, time, duration, hasStartOffset, hint, previous, next, progress);
+			track.compressed->getRotation(previous, a);
+			track.compressed->getRotation(next, b);
+		} else {
+			findKeys(&times[track.firstKey], track.keyCount, time, duration, hasStartOffset, hint, previous, next, progress);
+			const Real * pa = &values[(track.firstKey + previous) * 4];
+			const Real * pb = &values[(track.firstKey + next) * 4];
+			a.set(pa[0], pa[1], pa[2], pa[3]);
+			b.set(pb[0], pb[1], pb[2], pb[3]);
+		}
+
+		// perform spherical interpolation between the two Quaternions
+		Quaternion result = Quaternion::slerp(a, b, progress);
+		out[0] = result.x();
+		out[1] = result.y();
+		out[2] = result.z();
+		out[3] = result.w();
+	}
+
+	AnimationTracks::AnimationTracks() {
+		this->built = false;
+	}
+
+	AnimationTracks::~AnimationTracks() {
+	}
+
+	/*
+	 * Gather the key frames of [keyFrameSets] into contiguous arrays. The per-key objects of the key frame
+	 * sets are released afterwards; compressed key frame sets are referenced, not copied.
+	 */
+	void AnimationTracks::build(KeyFrameSet * keyFrameSets, UInt32 channelCount) {
+		UInt32 translationKeyCount = 0, rotationKeyCount = 0, scaleKeyCount = 0;
+		for (UInt32 c = 0; c < channelCount; c++) {
+			translationKeyCount += (UInt32)keyFrameSets[c].TranslationKeyFrames.size();
+			rotationKeyCount += (UInt32)keyFrameSets[c].RotationKeyFrames.size();
+			scaleKeyCount += (UInt32)keyFrameSets[c].ScaleKeyFrames.size();
+		}
+
+		this->channelUsed.assign(channelCount, false);
+		this->translationTracks.resize(channelCount);
+		this->rotationTracks.resize(channelCount);
+		this->scaleTracks.resize(channelCount);
+		this->translationTimes.clear();
+		this->translationTimes.reserve(translationKeyCount);
+		this->translations.clear();
+		this->translations.reserve(translationKeyCount * 3);
+		this->rotationTimes.clear();
+		this->rotationTimes.reserve(rotationKeyCount);
+		this->rotations.clear();
+		this->rotations.reserve(rotationKeyCount * 4);
+		this->scaleTimes.clear();
+		this->scaleTimes.reserve(scaleKeyCount);
+		this->scales.clear();
+		this->scales.reserve(scaleKeyCount * 3);
+
+		for (UInt32 c = 0; c < channelCount; c++) {
+			KeyFrameSet& keyFrameSet = keyFrameSets[c];
+			this->channelUsed[c] = keyFrameSet.Used;
+
+			Track& translationTrack = this->translationTracks[c];
+			Track& rotationTrack = this->rotationTracks[c];
+			Track& scaleTrack = this->scaleTracks[c];
+
+			if (keyFrameSet.Compressed) {
+				translationTrack = {0, keyFrameSet.CompressedTranslations.getKeyCount(), &keyFrameSet.CompressedTranslations};
+				rotationTrack = {0, keyFrameSet.CompressedRotations.getKeyCount(), &keyFrameSet.CompressedRotations};
+				scaleTrack = {0, keyFrameSet.CompressedScales.getKeyCount(), &keyFrameSet.CompressedScales};
+				continue;
+			}
+
+			translationTrack = {(UInt32)this->translationTimes.size(), (UInt32)keyFrameSet.TranslationKeyFrames.size(), nullptr};
+			for (const TranslationKeyFrame& keyFrame : keyFrameSet.TranslationKeyFrames) {
+				this->translationTimes.push_back(keyFrame.RealTime);
+				this->translations.insert(this->translations.end(), {keyFrame.Translation.x, keyFrame.Translation.y, keyFrame.Translation.z});
+			}
+
+			rotationTrack = {(UInt32)this->rotationTimes.size(), (UInt32)keyFrameSet.RotationKeyFrames.size(), nullptr};
+			for (const RotationKeyFrame& keyFrame : keyFrameSet.RotationKeyFrames) {
+				this->rotationTimes.push_back(keyFrame.RealTime);
+				this->rotations.insert(this->rotations.end(), {keyFrame.Rotation.x(), keyFrame.Rotation.y(), keyFrame.Rotation.z(), keyFrame.Rotation.w()});
+			}
+
+			scaleTrack = {(UInt32)this->scaleTimes.size(), (UInt32)keyFrameSet.ScaleKeyFrames.size(), nullptr};
+			for (const ScaleKeyFrame& keyFrame : keyFrameSet.ScaleKeyFrames) {
+				this->scaleTimes.push_back(keyFrame.RealTime);
+				this->scales.insert(this->scales.end(), {keyFrame.Scale.x, keyFrame.Scale.y, keyFrame.Scale.z});
+			}
+
+			std::vector<TranslationKeyFrame>().swap(keyFrameSet.TranslationKeyFrames);
+			std::vector<RotationKeyFrame>().swap(keyFrameSet.RotationKeyFrames);
+			std::vector<ScaleKeyFrame>().swap(keyFrameSet.ScaleKeyFrames);
+		}
+
+		this->built = true;
+	}
+
+	Bool AnimationTracks::isBuilt() const {
+		return this->built;
+	}
+
+	UInt32 AnimationTracks::getChannelCount() const {
+		return (UInt32)this->channelUsed.size();
+	}
+
+	/*
+	 * Size in bytes of the uncompressed key frame data.
+	 */
+	UInt32 AnimationTracks::getSize() const {
+		return (UInt32)((this->translationTimes.size() + this->translations.size() + this->rotationTimes.size() + this->rotations.size() +
+		                 this->scaleTimes.size() + this->scales.size()) * sizeof(Real) +
+		                (this->translationTracks.size() + this->rotationTracks.size() + this->scaleTracks.size()) * sizeof(Track));
+	}
+
+	/*
+	 * Sample [channel] at [time] seconds into an animation of [duration] seconds, writing the interpolated
+	 * translation (x, y, z), rotation (x, y, z, w) and scale (x, y, z). [keyHints] holds one search hint for
+	 * each of the three components and is updated. Returns false if the channel is not used.
+	 */
+	Bool AnimationTracks::sample(UInt32 channel, Real time, Real duration, Bool hasStartOffset, UInt32 * keyHints,
+	                             Real * translation, Real * rotation, Real * scale) const {
+		if (channel >= this->channelUsed.size()) {
+			throw OutOfRangeException("AnimationTracks::sample -> 'channel' is out of range.");
+		}
+		if (!this->channelUsed[channel]) return false;
+
+		const Track& translationTrack = this->translationTracks[channel];
+		const Track& rotationTrack = this->rotationTracks[channel];
+		const Track& scaleTrack = this->scaleTracks[channel];
+		if (translationTrack.keyCount == 0 || rotationTrack.keyCount == 0 || scaleTrack.keyCount == 0) {
+			throw Exception("AnimationTracks::sample -> Key frame count is zero.");
+		}
+
+		sampleVector(translationTrack, this->translationTimes, this->translations, time, duration, hasStartOffset, keyHints[0], translation);
+		sampleRotation(rotationTrack, this->rotationTimes, this->rotations, time, duration, hasStartOffset, keyHints[1], rotation);
+		sampleVector(scaleTrack, this->scaleTimes, this->scales, time, duration, hasStartOffset, keyHints[2], scale);
+		return true;
+	}
+}
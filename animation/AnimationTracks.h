@@ -0,0 +1,64 @@
+/*********************************************
+*
+* class: AnimationTracks
+*
+* The key frames of all channels of an Animation, laid out for sampling: the times and values of
+* each component (translation, rotation, scale) of every channel are stored back to back in
+* contiguous arrays, with one small Track record per channel locating its keys. Channels whose
+* KeyFrameSet has been compressed (see AnimationCompressor) are sampled from their compressed
+* tracks instead.
+*
+***********************************************/
+
+#pragma once
+
+#include <vector>
+
+#include "../common/types.h"
+
+namespace Core {
+
+	//forward declarations
+	class KeyFrameSet;
+	class CompressedKeyFrames;
+
+	class AnimationTracks final {
+	public:
+
+		class Track {
+		public:
+			// first key in the component's time and value arrays
+			UInt32 firstKey;
+			UInt32 keyCount;
+			// set if the track is sampled from compressed key frames
+			const CompressedKeyFrames * compressed;
+		};
+
+		AnimationTracks();
+		~AnimationTracks();
+
+		void build(KeyFrameSet * keyFrameSets, UInt32 channelCount);
+		Bool isBuilt() const;
+		UInt32 getChannelCount() const;
+		UInt32 getSize() const;
+		Bool sample(UInt32 channel, Real time, Real duration, Bool hasStartOffset, UInt32 * keyHints,
+		            Real * translation, Real * rotation, Real * scale) const;
+
+	private:
+		Bool built;
+		// whether the KeyFrameSet of each channel is used
+		std::vector<Bool> channelUsed;
+		std::vector<Track> translationTracks;
+		std::vector<Track> rotationTracks;
+		std::vector<Track> scaleTracks;
+		std::vector<Real> translationTimes;
+		// three values per key
+		std::vector<Real> translations;
+		std::vector<Real> rotationTimes;
+		// four values per key (x, y, z, w)
+		std::vector<Real> rotations;
+		std::vector<Real> scaleTimes;
+		// three values per key
+		std::vector<Real> scales;
+	};
+}
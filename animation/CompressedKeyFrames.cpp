@@ -0,0 +1,146 @@
+#include "CompressedKeyFrames.h"
+#include "../math/Math.h"
+#include "../common/Exception.h"
+
+namespace Core {
+
+	static const Real VectorScale = 65535.0f;
+	static const Real RotationScale = 32767.0f;
+	static const Real RotationRange = 1.41421356f;
+	static const UInt16 RotationMask = 0x7FFF;
+
+	/*
+	* Default constructor.
+	*/
+	CompressedKeyFrames::CompressedKeyFrames() {
+		this->clear();
+	}
+
+	/*
+	 * Destructor.
+	 */
+	CompressedKeyFrames::~CompressedKeyFrames() {
+	}
+
+	UInt32 CompressedKeyFrames::getKeyCount() const {
+		return (UInt32)this->Times.size();
+	}
+
+	/*
+	 * Size in bytes of this track, including its key storage.
+	 */
+	UInt32 CompressedKeyFrames::getSize() const {
+		return (UInt32)(sizeof(CompressedKeyFrames) + this->Times.capacity() * sizeof(Real) + this->Values.capacity() * sizeof(UInt16) +
+		                this->UncompressedValues.capacity() * sizeof(Real));
+	}
+
+	void CompressedKeyFrames::clear() {
+		this->Constant = false;
+		this->Uncompressed = false;
+		std::vector<Real>().swap(this->Times);
+		std::vector<UInt16>().swap(this->Values);
+		std::vector<Real>().swap(this->UncompressedValues);
+		for (UInt32 i = 0; i < 3; i++) {
+			this->Minimum[i] = 0.0f;
+			this->Extent[i] = 0.0f;
+			this->ConstantValue[i] = 0.0f;
+		}
+		this->ConstantValue[3] = 1.0f;
+	}
+
+	/*
+	 * Decode the vector key at [index] into [vector].
+	 */
+	void CompressedKeyFrames::getVector(UInt32 index, Vector3r& vector) const {
+		if (index >= this->getKeyCount()) {
+			throw OutOfRangeException("CompressedKeyFrames::getVector -> 'index' is out of range.");
+		}
+
+		if (this->Constant) {
+			vector.set(this->ConstantValue[0], this->ConstantValue[1], this->ConstantValue[2]);
+			return;
+		}
+
+		if (this->Uncompressed) {
+			const Real * values = &this->UncompressedValues[index * 3];
+			vector.set(values[0], values[1], values[2]);
+			return;
+		}
+
+		Real decoded[3];
+		decodeVector(&this->Values[index * 3], this->Minimum, this->Extent, decoded);
+		vector.set(decoded[0], decoded[1], decoded[2]);
+	}
+
+	/*
+	 * Decode the rotation key at [index] into [rotation].
+	 */
+	void CompressedKeyFrames::getRotation(UInt32 index, Quaternion& rotation) const {
+		if (index >= this->getKeyCount()) {
+			throw OutOfRangeException("CompressedKeyFrames::getRotation -> 'index' is out of range.");
+		}
+
+		if (this->Constant) {
+			rotation.set(this->ConstantValue[0], this->ConstantValue[1], this->ConstantValue[2], this->ConstantValue[3]);
+			return;
+		}
+
+		decodeRotation(&this->Values[index * 3], rotation);
+	}
+
+	void CompressedKeyFrames::encodeVector(const Real* vector, const Real* minimum, const Real* extent, UInt16* values) {
+		for (UInt32 i = 0; i < 3; i++) {
+			Real normalized = extent[i] > 0.0f ? (vector[i] - minimum[i]) / extent[i] : 0.0f;
+			normalized = Math::max(0.0f, Math::min(1.0f, normalized));
+			values[i] = (UInt16)Math::round(normalized * VectorScale);
+		}
+	}
+
+	void CompressedKeyFrames::decodeVector(const UInt16* values, const Real* minimum, const Real* extent, Real* vector) {
+		for (UInt32 i = 0; i < 3; i++) {
+			vector[i] = minimum[i] + (Real)values[i] / VectorScale * extent[i];
+		}
+	}
+
+	void CompressedKeyFrames::encodeRotation(const Quaternion& rotation, UInt16* values) {
+		Real components[4] = {rotation.x(), rotation.y(), rotation.z(), rotation.w()};
+		Real lengthSquared = 0.0f;
+		UInt32 largest = 0;
+		for (UInt32 i = 0; i < 4; i++) {
+			lengthSquared += components[i] * components[i];
+			if (Math::abs(components[i]) > Math::abs(components[largest])) largest = i;
+		}
+
+		// q and -q are the same rotation, so the dropped component can always be made positive
+		Real scale = lengthSquared > 0.0f ? Math::inverseSquareRoot(lengthSquared) : 1.0f;
+		if (components[largest] < 0.0f) scale = -scale;
+
+		// the remaining components are at most 1/sqrt(2) in magnitude
+		UInt32 v = 0;
+		for (UInt32 i = 0; i < 4; i++) {
+			if (i == largest) continue;
+			Real normalized = Math::max(-1.0f, Math::min(1.0f, components[i] * scale * RotationRange));
+			values[v++] = (UInt16)Math::round((normalized * 0.5f + 0.5f) * RotationScale);
+		}
+
+		values[0] |= (UInt16)((largest & 1) << 15);
+		values[1] |= (UInt16)((largest >> 1) << 15);
+	}
+
+	void CompressedKeyFrames::decodeRotation(const UInt16* values, Quaternion& rotation) {
+		UInt32 largest = (values[0] >> 15) | ((values[1] >> 15) << 1);
+
+		Real components[4];
+		Real sumSquared = 0.0f;
+		UInt32 v = 0;
+		for (UInt32 i = 0; i < 4; i++) {
+			if (i == largest) continue;
+			Real normalized = (Real)(values[v++] & RotationMask) / RotationScale * 2.0f - 1.0f;
+			components[i] = normalized / RotationRange;
+			sumSquared += components[i] * components[i];
+		}
+		components[largest] = Math::squareRoot(Math::max(0.0f, 1.0f - sumSquared));
+
+		rotation.set(components[0], components[1], components[2], components[3]);
+	}
+}
@@ -0,0 +1,60 @@
+/*********************************************
+*
+* class: CompressedKeyFrames
+*
+* This class stores one compressed key frame track (translation, scale or rotation) of a single
+* node, as produced by AnimationCompressor.
+*
+* Every key is stored as three 16-bit values. Vector keys are quantized over the range
+* [Minimum, Minimum + Extent] of their track. Rotation keys use the smallest-three encoding: the
+* largest component of the quaternion is dropped (and made positive), the remaining three are
+* stored with 15 bits each and the index of the dropped component goes in the top bits of the
+* first two values. A constant track stores a single key in [ConstantValue] at full precision.
+* A vector track whose range is too wide for 16-bit quantization to meet its tolerance keeps all
+* of its keys at full precision in [UncompressedValues].
+*
+***********************************************/
+
+#pragma once
+
+#include <vector>
+
+#include "../common/types.h"
+#include "../geometry/Vector3.h"
+#include "../math/Quaternion.h"
+
+namespace Core {
+
+	class CompressedKeyFrames final {
+	public:
+
+		// every key of the source track was within tolerance of [ConstantValue]
+		Bool Constant;
+		// the time of each key, in seconds
+		std::vector<Real> Times;
+		// three quantized values per key; empty for a constant or uncompressed track
+		std::vector<UInt16> Values;
+		// the keys are stored unquantized, three values per key in [UncompressedValues]
+		Bool Uncompressed;
+		std::vector<Real> UncompressedValues;
+		// quantization range of a vector track
+		Real Minimum[3];
+		Real Extent[3];
+		// the value of a constant track: x, y, z (and w for rotations)
+		Real ConstantValue[4];
+
+		CompressedKeyFrames();
+		~CompressedKeyFrames();
+
+		UInt32 getKeyCount() const;
+		UInt32 getSize() const;
+		void clear();
+		void getVector(UInt32 index, Vector3r& vector) const;
+		void getRotation(UInt32 index, Quaternion& rotation) const;
+
+		static void encodeVector(const Real* vector, const Real* minimum, const Real* extent, UInt16* values);
+		static void decodeVector(const UInt16* values, const Real* minimum, const Real* extent, Real* vector);
+		static void encodeRotation(const Quaternion& rotation, UInt16* values);
+		static void decodeRotation(const UInt16* values, Quaternion& rotation);
+	};
+}
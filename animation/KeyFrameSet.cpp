@@ -7,6 +7,7 @@ namespace Core {
 	*/
 	KeyFrameSet::KeyFrameSet() {
 		Used = false;
+		Compressed = false;
 	}
 
 	/*
@@ -16,6 +16,7 @@
 #include "TranslationKeyFrame.h"
 #include "ScaleKeyFrame.h"
 #include "RotationKeyFrame.h"
+#include "CompressedKeyFrames.h"
 #include "../common/types.h"
 
 namespace Core {
@@ -32,6 +33,13 @@ namespace Core {
 		// key frames with rotation transformations
 		std::vector<RotationKeyFrame> RotationKeyFrames;
 
+		// when set, the key frame vectors above are empty and the key frames are stored in the
+		// compressed tracks below (see AnimationCompressor)
+		Bool Compressed;
+		CompressedKeyFrames CompressedTranslations;
+		CompressedKeyFrames CompressedScales;
+		CompressedKeyFrames CompressedRotations;
+
 		KeyFrameSet();
 		~KeyFrameSet();
 	};
@@ -0,0 +1,155 @@
+#include "PoseBuffer.h"
+#include "../math/Math.h"
+#include "../math/Quaternion.h"
+
+namespace Core {
+
+	PoseBuffer::PoseBuffer() {
+		this->weight = 0.0f;
+		this->animated = false;
+	}
+
+	PoseBuffer::~PoseBuffer() {
+	}
+
+	void PoseBuffer::resize(UInt32 nodeCount) {
+		this->translationX.resize(nodeCount);
+		this->translationY.resize(nodeCount);
+		this->translationZ.resize(nodeCount);
+		this->rotationX.resize(nodeCount);
+		this->rotationY.resize(nodeCount);
+		this->rotationZ.resize(nodeCount);
+		this->rotationW.resize(nodeCount);
+		this->scaleX.resize(nodeCount);
+		this->scaleY.resize(nodeCount);
+		this->scaleZ.resize(nodeCount);
+	}
+
+	UInt32 PoseBuffer::getNodeCount() const {
+		return (UInt32)this->translationX.size();
+	}
+
+	void PoseBuffer::setNode(UInt32 node, const Real * translation, const Real * rotation, const Real * scale) {
+		this->translationX[node] = translation[0];
+		this->translationY[node] = translation[1];
+		this->translationZ[node] = translation[2];
+		this->rotationX[node] = rotation[0];
+		this->rotationY[node] = rotation[1];
+		this->rotationZ[node] = rotation[2];
+		this->rotationW[node] = rotation[3];
+		this->scaleX[node] = scale[0];
+		this->scaleY[node] = scale[1];
+		this->scaleZ[node] = scale[2];
+	}
+
+	/*
+	 * Set nodes [firstNode] to [lastNode] (exclusive) to [source] scaled by [weight].
+	 */
+	void PoseBuffer::setWeighted(const PoseBuffer& source, Real weight, UInt32 firstNode, UInt32 lastNode) {
+		for (UInt32 n = firstNode; n < lastNode; n++) {
+			this->translationX[n] = source.translationX[n] * weight;
+			this->translationY[n] = source.translationY[n] * weight;
+			this->translationZ[n] = source.translationZ[n] * weight;
+			this->rotationX[n] = source.rotationX[n] * weight;
+			this->rotationY[n] = source.rotationY[n] * weight;
+			this->rotationZ[n] = source.rotationZ[n] * weight;
+			this->rotationW[n] = source.rotationW[n] * weight;
+			this->scaleX[n] = source.scaleX[n] * weight;
+			this->scaleY[n] = source.scaleY[n] * weight;
+			this->scaleZ[n] = source.scaleZ[n] * weight;
+		}
+	}
+
+	/*
+	 * Additively combine [source] scaled by [weight] into nodes [firstNode] to [lastNode] (exclusive). The
+	 * rotations can't be added, so the weighted source rotation is spherically interpolated into the
+	 * aggregate rotation by [rotationBlend].
+	 */
+	void PoseBuffer::addWeighted(const PoseBuffer& source, Real weight, Real rotationBlend, UInt32 firstNode, UInt32 lastNode) {
+		for (UInt32 n = firstNode; n < lastNode; n++) {
+			this->translationX[n] += source.translationX[n] * weight;
+			this->translationY[n] += source.translationY[n] * weight;
+			this->translationZ[n] += source.translationZ[n] * weight;
+			this->scaleX[n] += source.scaleX[n] * weight;
+			this->scaleY[n] += source.scaleY[n] * weight;
+			this->scaleZ[n] += source.scaleZ[n] * weight;
+		}
+
+		for (UInt32 n = firstNode; n < lastNode; n++) {
+			Quaternion aggregate(this->rotationX[n], this->rotationY[n], this->rotationZ[n], this->rotationW[n]);
+			Quaternion rotation(source.rotationX[n] * weight, source.rotationY[n] * weight, source.rotationZ[n] * weight, source.rotationW[n] * weight);
+			Quaternion result = Quaternion::slerp(aggregate, rotation, rotationBlend);
+			this->rotationX[n] = result.x();
+			this->rotationY[n] = result.y();
+			this->rotationZ[n] = result.z();
+			this->rotationW[n] = result.w();
+		}
+	}
+
+	/*
+	 * Interpolate nodes [firstNode] to [lastNode] (exclusive) from [from] to [to] by [factor].
+	 */
+	void PoseBuffer::blend(const PoseBuffer& from, const PoseBuffer& to, Real factor, UInt32 firstNode, UInt32 lastNode) {
+		for (UInt32 n = firstNode; n < lastNode; n++) {
+			this->translationX[n] = from.translationX[n] + (to.translationX[n] - from.translationX[n]) * factor;
+			this->translationY[n] = from.translationY[n] + (to.translationY[n] - from.translationY[n]) * factor;
+			this->translationZ[n] = from.translationZ[n] + (to.translationZ[n] - from.translationZ[n]) * factor;
+			this->scaleX[n] = from.scaleX[n] + (to.scaleX[n] - from.scaleX[n]) * factor;
+			this->scaleY[n] = from.scaleY[n] + (to.scaleY[n] - from.scaleY[n]) * factor;
+			this->scaleZ[n] = from.scaleZ[n] + (to.scaleZ[n] - from.scaleZ[n]) * factor;
+		}
+
+		for (UInt32 n = firstNode; n < lastNode; n++) {
+			Quaternion a(from.rotationX[n], from.rotationY[n], from.rotationZ[n], from.rotationW[n]);
+			Quaternion b(to.rotationX[n], to.rotationY[n], to.rotationZ[n], to.rotationW[n]);
+			Quaternion result = Quaternion::slerp(a, b, factor);
+			this->rotationX[n] = result.x();
+			this->rotationY[n] = result.y();
+			this->rotationZ[n] = result.z();
+			this->rotationW[n] = result.w();
+		}
+
+		this->weight = from.weight + (to.weight - from.weight) * factor;
+		this->animated = from.animated && to.animated;
+	}
+
+	/*
+	 * Write the local transformation (translation * rotation * scale) of nodes [firstNode] to [lastNode]
+	 * (exclusive) to [matrices], 16 values per node in column-major order, starting at node [firstNode].
+	 * Rotations are normalized first.
+	 */
+	void PoseBuffer::composeMatrices(Real * matrices, UInt32 firstNode, UInt32 lastNode) const {
+		for (UInt32 n = firstNode; n < lastNode; n++) {
+			Real x = this->rotationX[n], y = this->rotationY[n], z = this->rotationZ[n], w = this->rotationW[n];
+			Real lengthSquared = x * x + y * y + z * z + w * w;
+			Real inverseLength = lengthSquared > 0.0f ? 1.0f / Math::squareRoot(lengthSquared) : 1.0f;
+			x *= inverseLength;
+			y *= inverseLength;
+			z *= inverseLength;
+			w *= inverseLength;
+
+			Real sx = this->scaleX[n], sy = this->scaleY[n], sz = this->scaleZ[n];
+			Real * m = matrices + (n - firstNode) * 16;
+
+			m[0] = (1 - 2 * y * y - 2 * z * z) * sx;
+			m[1] = (2 * x * y + 2 * z * w) * sx;
+			m[2] = (2 * x * z - 2 * y * w) * sx;
+			m[3] = 0;
+
+			m[4] = (2 * x * y - 2 * z * w) * sy;
+			m[5] = (1 - 2 * x * x - 2 * z * z) * sy;
+			m[6] = (2 * y * z + 2 * x * w) * sy;
+			m[7] = 0;
+
+			m[8] = (2 * x * z + 2 * y * w) * sz;
+			m[9] = (2 * y * z - 2 * x * w) * sz;
+			m[10] = (1 - 2 * x * x - 2 * y * y) * sz;
+			m[11] = 0;
+
+			m[12] = this->translationX[n];
+			m[13] = this->translationY[n];
+			m[14] = this->translationZ[n];
+			m[15] = 1;
+		}
+	}
+}
@@ -0,0 +1,48 @@
+/*********************************************
+*
+* class: PoseBuffer
+*
+* The local pose (translation, rotation and scale) of every node of a skeleton, one array per
+* component, so that sampling, blending and matrix composition are each a single loop over the
+* nodes.
+*
+***********************************************/
+
+#pragma once
+
+#include <vector>
+
+#include "../common/types.h"
+
+namespace Core {
+
+	class PoseBuffer final {
+	public:
+
+		PoseBuffer();
+		~PoseBuffer();
+
+		void resize(UInt32 nodeCount);
+		UInt32 getNodeCount() const;
+		void setNode(UInt32 node, const Real * translation, const Real * rotation, const Real * scale);
+		void setWeighted(const PoseBuffer& source, Real weight, UInt32 firstNode, UInt32 lastNode);
+		void addWeighted(const PoseBuffer& source, Real weight, Real rotationBlend, UInt32 firstNode, UInt32 lastNode);
+		void blend(const PoseBuffer& from, const PoseBuffer& to, Real factor, UInt32 firstNode, UInt32 lastNode);
+		void composeMatrices(Real * matrices, UInt32 firstNode, UInt32 lastNode) const;
+
+		std::vector<Real> translationX;
+		std::vector<Real> translationY;
+		std::vector<Real> translationZ;
+		std::vector<Real> rotationX;
+		std::vector<Real> rotationY;
+		std::vector<Real> rotationZ;
+		std::vector<Real> rotationW;
+		std::vector<Real> scaleX;
+		std::vector<Real> scaleY;
+		std::vector<Real> scaleZ;
+		// combined weight of the animations that make up this pose; the same for every node
+		Real weight;
+		// false if no animation contributed to this pose
+		Bool animated;
+	};
+}
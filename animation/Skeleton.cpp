@@ -1,5 +1,6 @@
 #include "Skeleton.h"
 #include "Bone.h"
+#include "SkinningPalette.h"
 #include "../util/Tree.h"
 
 namespace Core {
@@ -9,12 +10,17 @@ namespace Core {
     Skeleton::Skeleton(UInt32 boneCount) {
         this->boneCount = boneCount;
         this->bones = nullptr;
+        this->skinningPalette = nullptr;
     }
     /*
      * Destructor.
      */
     Skeleton::~Skeleton() {
         this->destroy();
+        if (this->skinningPalette != nullptr) {
+            delete this->skinningPalette;
+            this->skinningPalette = nullptr;
+        }
     }
 
     /*
@@ -28,6 +34,7 @@ namespace Core {
             this->bones = nullptr;
         }
         this->boneNameMap.clear();
+        if (this->skinningPalette != nullptr) this->skinningPalette->invalidate();
 
         // delete all SkeletonNode objects by traversing the node hierarchy and
         // using a visitor to invoke the callback below, which performsm the delete.
@@ -164,6 +171,7 @@ namespace Core {
      */
     void Skeleton::addNodeToList(Skeleton::SkeletonNode * node) {
        this->nodeList.push_back(node);
+       if (this->skinningPalette != nullptr) this->skinningPalette->invalidate();
     }
 
     /*
@@ -191,6 +199,20 @@ namespace Core {
                 }
             }
         }
+        if (this->skinningPalette != nullptr) this->skinningPalette->invalidate();
+    }
+
+    /*
+     * Get the skinning matrices of this skeleton.
+     */
+    SkinningPalette& Skeleton::getSkinningPalette() {
+        if (this->skinningPalette == nullptr) {
+            this->skinningPalette = new(std::nothrow) SkinningPalette();
+            if (this->skinningPalette == nullptr) {
+                throw AllocationException("Skeleton::getSkinningPalette -> Could not allocate skinning palette.");
+            }
+        }
+        return *this->skinningPalette;
     }
 
     /*
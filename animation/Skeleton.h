@@ -37,6 +37,7 @@ namespace Core {
     //forward declarations
     class Bone;
     class Transform;
+    class SkinningPalette;
 
     class Skeleton final: public CoreObject {
 
@@ -57,7 +58,6 @@ namespace Core {
             Vector3r InitialTranslation;
             Vector3r InitialScale;
             Quaternion InitialRotation;
-            Matrix4x4 TempRenderTransformation;
 
             SkeletonNode(Int32 boneIndex, const std::string& name) {
                 this->BoneIndex = boneIndex;
@@ -91,6 +91,8 @@ namespace Core {
 
         void overrideBonesFrom(WeakPointer<const Skeleton> skeleton, Bool takeOffset, Bool takeNode);
         void overrideBonesFrom(const Skeleton * skeleton, Bool takeOffset, Bool takeNode);
+
+        SkinningPalette& getSkinningPalette();
     
     private:
         
@@ -110,6 +112,9 @@ namespace Core {
         // contains transformation hierarchy structure
         Tree<SkeletonNode*> skeleton;
 
+        // skinning matrices shared by all meshes bound to this skeleton, created on first use
+        SkinningPalette * skinningPalette;
+
         Skeleton(UInt32 boneCount);
 
         void destroy();
@@ -0,0 +1,137 @@
+#include <string.h>
+
+#include "SkinningPalette.h"
+#include "Bone.h"
+#include "../Engine.h"
+#include "../render/MatrixBuffer.h"
+#include "../math/Math.h"
+
+namespace Core {
+
+    SkinningPalette::SkinningPalette() {
+        this->frame = 0;
+        this->valid = false;
+        this->uploaded = false;
+    }
+
+    SkinningPalette::~SkinningPalette() {
+        if (this->gpuBuffer.isValid()) {
+            Engine::safeReleaseObject(this->gpuBuffer);
+        }
+    }
+
+    /*
+     * Find the node and offset matrix of every bone in [skeleton] in a single walk of its node list,
+     * so that computing the palette is a linear pass over the bones.
+     */
+    void SkinningPalette::gatherBones(Skeleton& skeleton) {
+        UInt32 boneCount = skeleton.getBoneCount();
+        std::vector<Skeleton::SkeletonNode *> boneNodes(boneCount, nullptr);
+        std::vector<const Matrix4x4 *> boneOffsets(boneCount);
+        for (UInt32 b = 0; b < boneCount; b++) {
+            boneOffsets[b] = &skeleton.getBone(b)->OffsetMatrix;
+        }
+        for (UInt32 n = 0; n < skeleton.getNodeCount(); n++) {
+            Skeleton::SkeletonNode * node = skeleton.getNodeFromList(n);
+            if (node != nullptr && node->BoneIndex >= 0 && (UInt32)node->BoneIndex < boneCount) {
+                boneNodes[node->BoneIndex] = node;
+            }
+        }
+        this->setBones(boneNodes, boneOffsets);
+    }
+
+    /*
+     * Use [boneNodes] and [boneOffsets] (one entry per bone, a null node for a bone that isn't attached
+     * to one) as the bones of the palette. update() gathers them from its skeleton when needed.
+     */
+    void SkinningPalette::setBones(const std::vector<Skeleton::SkeletonNode *>& boneNodes, const std::vector<const Matrix4x4 *>& boneOffsets) {
+        if (boneNodes.size() != boneOffsets.size()) {
+            throw InvalidArgumentException("SkinningPalette::setBones -> Bone node and offset counts differ.");
+        }
+        this->boneNodes = boneNodes;
+        this->boneOffsets = boneOffsets;
+        this->matrices.resize(boneNodes.size() * 16);
+        this->valid = false;
+    }
+
+    /*
+     * Bring the palette up to date for [skeleton] rendered under an object whose inverse world
+     * transformation is [rootTransformInverse]. Nothing is recomputed if that was already done
+     * during [frame]. Returns true if the palette was recomputed.
+     */
+    Bool SkinningPalette::update(Skeleton& skeleton, const Matrix4x4& rootTransformInverse, UInt64 frame) {
+        if (this->boneNodes.size() != skeleton.getBoneCount()) this->gatherBones(skeleton);
+
+        if (this->valid && this->frame == frame &&
+            memcmp(this->rootTransformInverse.getConstData(), rootTransformInverse.getConstData(), sizeof(Real) * 16) == 0) {
+            return false;
+        }
+
+        this->compute(rootTransformInverse, 0, this->getBoneCount());
+        this->rootTransformInverse.copy(rootTransformInverse);
+        this->frame = frame;
+        this->valid = true;
+        this->uploaded = false;
+        return true;
+    }
+
+    /*
+     * Compute the skinning matrices of bones [firstBone] to [lastBone] (exclusive). Bones are independent
+     * of each other, so disjoint ranges may be computed concurrently. A bone without a node gets the
+     * identity matrix.
+     */
+    void SkinningPalette::compute(const Matrix4x4& rootTransformInverse, UInt32 firstBone, UInt32 lastBone) {
+        static const Real identity[] = {1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1};
+        if (lastBone > this->getBoneCount()) {
+            throw OutOfRangeException("SkinningPalette::compute -> 'lastBone' is out of range.");
+        }
+
+        Real boneTransform[16];
+        for (UInt32 b = firstBone; b < lastBone; b++) {
+            Real * out = &this->matrices[b * 16];
+            Skeleton::SkeletonNode * node = this->boneNodes[b];
+            if (node == nullptr) {
+                memcpy(out, identity, sizeof(identity));
+                continue;
+            }
+            Matrix4x4::multiplyMM(node->getFullTransform().getConstData(), this->boneOffsets[b]->getConstData(), boneTransform);
+            Matrix4x4::multiplyMM(rootTransformInverse.getConstData(), boneTransform, out);
+        }
+    }
+
+    /*
+     * Force the bones to be gathered again and the palette to be recomputed on the next update, for
+     * when the skeleton's nodes or bones have changed.
+     */
+    void SkinningPalette::invalidate() {
+        this->boneNodes.clear();
+        this->boneOffsets.clear();
+        this->valid = false;
+    }
+
+    UInt32 SkinningPalette::getBoneCount() const {
+        return (UInt32)this->boneNodes.size();
+    }
+
+    const Real * SkinningPalette::getMatrices() const {
+        return this->matrices.data();
+    }
+
+    /*
+     * Bind the palette to the sampler at [uniformLocation] of the active shader, using texture unit
+     * [samplerSlot]. The GPU copy is only refreshed if the palette changed since it was last sent.
+     */
+    void SkinningPalette::sendToActiveShader(UInt32 samplerSlot, UInt32 uniformLocation) {
+        UInt32 boneCount = this->getBoneCount();
+        if (!this->gpuBuffer.isValid() || this->gpuBuffer->getCapacity() < boneCount) {
+            if (this->gpuBuffer.isValid()) Engine::safeReleaseObject(this->gpuBuffer);
+            this->gpuBuffer = Engine::instance()->createMatrixBuffer(Math::max(boneCount, 1u));
+            this->uploaded = false;
+        }
+        if (!this->uploaded) {
+            this->gpuBuffer->setMatrices(this->matrices.data(), boneCount);
+            this->uploaded = true;
+        }
+        this->gpuBuffer->sendToActiveShader(samplerSlot, uniformLocation);
+    }
+}
@@ -0,0 +1,58 @@
+/*********************************************
+*
+* class: SkinningPalette
+*
+* The skinning matrices of a Skeleton, stored contiguously in bone order: for each bone, the
+* transformation from model space into bone space (the bone's offset matrix), then through the
+* bone's current full transformation, and finally into the local space of the object being
+* rendered. The palette is computed at most once per frame and shared by every mesh bound to
+* the skeleton, and is uploaded to the GPU as a single MatrixBuffer.
+*
+***********************************************/
+
+#pragma once
+
+#include <vector>
+
+#include "../common/types.h"
+#include "../math/Matrix4x4.h"
+#include "../util/PersistentWeakPointer.h"
+#include "Skeleton.h"
+
+namespace Core {
+
+    //forward declarations
+    class MatrixBuffer;
+
+    class SkinningPalette final {
+    public:
+
+        SkinningPalette();
+        ~SkinningPalette();
+
+        Bool update(Skeleton& skeleton, const Matrix4x4& rootTransformInverse, UInt64 frame);
+        void setBones(const std::vector<Skeleton::SkeletonNode *>& boneNodes, const std::vector<const Matrix4x4 *>& boneOffsets);
+        void compute(const Matrix4x4& rootTransformInverse, UInt32 firstBone, UInt32 lastBone);
+        void invalidate();
+        UInt32 getBoneCount() const;
+        const Real * getMatrices() const;
+        void sendToActiveShader(UInt32 samplerSlot, UInt32 uniformLocation);
+
+    private:
+        // the node of each bone, or nullptr if the bone isn't attached to one
+        std::vector<Skeleton::SkeletonNode *> boneNodes;
+        // offset matrix of each bone
+        std::vector<const Matrix4x4 *> boneOffsets;
+        // 16 values per bone, column-major
+        std::vector<Real> matrices;
+        // the root transformation and frame the palette was last computed for
+        Matrix4x4 rootTransformInverse;
+        UInt64 frame;
+        Bool valid;
+        // the GPU copy of [matrices], re-uploaded when [uploaded] is false
+        PersistentWeakPointer<MatrixBuffer> gpuBuffer;
+        Bool uploaded;
+
+        void gatherBones(Skeleton& skeleton);
+    };
+}
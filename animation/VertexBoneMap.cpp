@@ -15,6 +15,8 @@ namespace Core {
         this->vertexCount = vertexCount;
         this->uniqueVertexCount = uVertexCount;
         this->mappingDescriptors = nullptr;
+        this->weightFormat = AttributeFormat::Native;
+        this->indexFormat = AttributeFormat::Native;
     }
 
     /*
@@ -82,6 +84,8 @@ namespace Core {
         } catch(...) {
             throw AllocationException("VertexBoneMap::buildAttributeArray() -> Unable to allocate array.");
         }
+        this->boneWeights->setGPUFormat(this->weightFormat);
+        this->boneIndices->setGPUFormat(this->indexFormat);
 
         Real* boneWeightsDataArray = new (std::nothrow) Real[this->vertexCount * Constants::MaxBonesPerVertex];
         if (boneWeightsDataArray == nullptr) {
@@ -123,6 +127,30 @@ namespace Core {
         return this->boneIndices;
     }
 
+    void VertexBoneMap::setWeightFormat(AttributeFormat format) {
+        if (!AttributeFormats::isSupported(format, 4, true)) {
+            throw InvalidArgumentException("VertexBoneMap::setWeightFormat() -> Format is not supported for bone weights.");
+        }
+        this->weightFormat = format;
+        if (this->boneWeights) this->boneWeights->setGPUFormat(format);
+    }
+
+    AttributeFormat VertexBoneMap::getWeightFormat() const {
+        return this->weightFormat;
+    }
+
+    void VertexBoneMap::setIndexFormat(AttributeFormat format) {
+        if (!AttributeFormats::isSupported(format, 4, false)) {
+            throw InvalidArgumentException("VertexBoneMap::setIndexFormat() -> Format is not supported for bone indices.");
+        }
+        this->indexFormat = format;
+        if (this->boneIndices) this->boneIndices->setGPUFormat(format);
+    }
+
+    AttributeFormat VertexBoneMap::getIndexFormat() const {
+        return this->indexFormat;
+    }
+
     /*
      * Update the bone indices in this map to match that of [skeleton]
      */
@@ -20,6 +20,7 @@
 #include "../common/assert.h"
 #include "../common/Constants.h"
 #include "../geometry/Vector4.h"
+#include "../geometry/AttributeFormat.h"
 
 namespace Core {
 
@@ -75,6 +76,12 @@ namespace Core {
         WeakPointer<AttributeArray<Vector4rs>> getWeights();
         WeakPointer<AttributeArray<Vector4is>> getIndices();
 
+        // GPU packing of the bone weights (e.g. AttributeFormat::UNorm8Weights) and indices (AttributeFormat::UInt8 or UInt16)
+        void setWeightFormat(AttributeFormat format);
+        AttributeFormat getWeightFormat() const;
+        void setIndexFormat(AttributeFormat format);
+        AttributeFormat getIndexFormat() const;
+
     protected:
 
         VertexBoneMap(UInt32 vertexCount, UInt32 uVertexCount);
@@ -91,6 +98,8 @@ namespace Core {
 
         std::shared_ptr<AttributeArray<Vector4rs>> boneWeights;
         std::shared_ptr<AttributeArray<Vector4is>> boneIndices;
+        AttributeFormat weightFormat;
+        AttributeFormat indexFormat;
 
         void destroy();
         //VertexBoneMap * fullClone();
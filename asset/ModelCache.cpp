@@ -0,0 +1,389 @@
+#include <stdio.h>
+#include <string.h>
+#include <fstream>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "ModelCache.h"
+
+namespace Core {
+
+    static const UInt32 ModelCacheMagic = 0x434D3343;
+    static const UInt64 ModelCacheAlignment = 16;
+    static const UInt64 FNVOffsetBasis = 14695981039346656037ULL;
+    static const UInt64 FNVPrime = 1099511628211ULL;
+
+    enum class ModelCacheContent {
+        Model = 1,
+        Animation = 2
+    };
+
+    class ModelCache::MappedFile {
+    public:
+        MappedFile() {
+            this->data = nullptr;
+            this->size = 0;
+            this->mapped = false;
+        }
+
+        ~MappedFile() {
+#if !defined(_WIN32)
+            if (this->mapped) munmap((void*)this->data, this->size);
+#endif
+        }
+
+        Bool open(const std::string& path) {
+#if !defined(_WIN32)
+            int fd = ::open(path.c_str(), O_RDONLY);
+            if (fd < 0) return false;
+            struct stat fileStat;
+            if (fstat(fd, &fileStat) != 0 || fileStat.st_size <= 0) {
+                close(fd);
+                return false;
+            }
+            void* mapping = mmap(nullptr, (size_t)fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            close(fd);
+            if (mapping == MAP_FAILED) return false;
+            this->data = (const Byte*)mapping;
+            this->size = (UInt64)fileStat.st_size;
+            this->mapped = true;
+            return true;
+#else
+            std::ifstream file(path.c_str(), std::ios::binary | std::ios::ate);
+            if (!file) return false;
+            std::streamoff fileSize = file.tellg();
+            if (fileSize <= 0) return false;
+            this->buffer.resize((size_t)fileSize);
+            file.seekg(0);
+            if (!file.read((char*)this->buffer.data(), fileSize)) return false;
+            this->data = this->buffer.data();
+            this->size = (UInt64)fileSize;
+            return true;
+#endif
+        }
+
+        const Byte* data;
+        UInt64 size;
+
+    private:
+        Bool mapped;
+        std::vector<Byte> buffer;
+    };
+
+    class ModelCacheWriter {
+    public:
+        template <typename T>
+        void write(const T& value) {
+            this->append(&value, sizeof(T));
+        }
+
+        void writeString(const std::string& value) {
+            this->write<UInt32>((UInt32)value.size());
+            this->append(value.data(), value.size());
+        }
+
+        void writeMatrix(const Real* matrix) {
+            this->append(matrix, sizeof(Real) * 16);
+        }
+
+        // blocks start on an aligned offset so that mapped data can be used in place
+        void writeBlock(const void* data, UInt64 size) {
+            this->write<UInt64>(size);
+            while (this->buffer.size() % ModelCacheAlignment != 0) this->buffer.push_back(0);
+            if (size > 0) this->append(data, size);
+        }
+
+        void writeHeader(ModelCacheContent content, UInt64 key) {
+            this->write<UInt32>(ModelCacheMagic);
+            this->write<UInt32>((UInt32)ModelCache::Version);
+            this->write<UInt32>((UInt32)content);
+            this->write<UInt32>((UInt32)sizeof(Real));
+            this->write<UInt32>((UInt32)Constants::MaxBonesPerVertex);
+            this->write<UInt32>(0);
+            this->write<UInt64>(key);
+        }
+
+        // write to a temporary file first so a reader never sees a partially written cache entry
+        Bool save(const std::string& path) {
+            std::string tempPath = path + ".tmp";
+            FILE* file = fopen(tempPath.c_str(), "wb");
+            if (file == nullptr) return false;
+            Bool success = fwrite(this->buffer.data(), 1, this->buffer.size(), file) == this->buffer.size();
+            success = fclose(file) == 0 && success;
+            if (success) success = rename(tempPath.c_str(), path.c_str()) == 0;
+            if (!success) remove(tempPath.c_str());
+            return success;
+        }
+
+    private:
+        void append(const void* data, UInt64 size) {
+            const Byte* bytes = (const Byte*)data;
+            this->buffer.insert(this->buffer.end(), bytes, bytes + size);
+        }
+
+        std::vector<Byte> buffer;
+    };
+
+    class ModelCacheReader {
+    public:
+        ModelCacheReader(const Byte* data, UInt64 size) {
+            this->data = data;
+            this->size = size;
+            this->offset = 0;
+        }
+
+        template <typename T>
+        Bool read(T& value) {
+            if (this->size - this->offset < sizeof(T)) return false;
+            memcpy(&value, this->data + this->offset, sizeof(T));
+            this->offset += sizeof(T);
+            return true;
+        }
+
+        Bool readString(std::string& value) {
+            UInt32 length;
+            if (!this->read(length) || this->size - this->offset < length) return false;
+            value.assign((const char*)(this->data + this->offset), length);
+            this->offset += length;
+            return true;
+        }
+
+        Bool readMatrix(Real* matrix) {
+            if (this->size - this->offset < sizeof(Real) * 16) return false;
+            memcpy(matrix, this->data + this->offset, sizeof(Real) * 16);
+            this->offset += sizeof(Real) * 16;
+            return true;
+        }
+
+        Bool readBlock(const Byte*& block, UInt64& blockSize) {
+            if (!this->read(blockSize)) return false;
+            UInt64 padding = (ModelCacheAlignment - this->offset % ModelCacheAlignment) % ModelCacheAlignment;
+            if (this->size - this->offset < padding) return false;
+            this->offset += padding;
+            if (this->size - this->offset < blockSize) return false;
+            block = blockSize > 0 ? this->data + this->offset : nullptr;
+            this->offset += blockSize;
+            return true;
+        }
+
+        template <typename T>
+        Bool readArray(const T*& array, UInt32 count) {
+            const Byte* block;
+            UInt64 blockSize;
+            if (!this->readBlock(block, blockSize) || blockSize != (UInt64)count * sizeof(T)) return false;
+            array = (const T*)block;
+            return true;
+        }
+
+        template <typename T>
+        Bool readVector(std::vector<T>& vector) {
+            const Byte* block;
+            UInt64 blockSize;
+            if (!this->readBlock(block, blockSize) || blockSize % sizeof(T) != 0) return false;
+            vector.resize((size_t)(blockSize / sizeof(T)));
+            if (blockSize > 0) memcpy(vector.data(), block, (size_t)blockSize);
+            return true;
+        }
+
+        Bool readHeader(ModelCacheContent content, UInt64 key) {
+            UInt32 magic, version, contentType, realSize, maxBonesPerVertex, reserved;
+            UInt64 storedKey;
+            if (!this->read(magic) || !this->read(version) || !this->read(contentType) || !this->read(realSize) ||
+                !this->read(maxBonesPerVertex) || !this->read(reserved) || !this->read(storedKey)) return false;
+            return magic == ModelCacheMagic && version == ModelCache::Version && contentType == (UInt32)content &&
+                   realSize == sizeof(Real) && maxBonesPerVertex == Constants::MaxBonesPerVertex && storedKey == key;
+        }
+
+    private:
+        const Byte* data;
+        UInt64 size;
+        UInt64 offset;
+    };
+
+    UInt64 ModelCache::hashBytes(const void* data, UInt64 size, UInt64 hash) {
+        const Byte* bytes = (const Byte*)data;
+        for (UInt64 i = 0; i < size; i++) {
+            hash ^= bytes[i];
+            hash *= FNVPrime;
+        }
+        return hash;
+    }
+
+    Bool ModelCache::hashFile(const std::string& path, UInt64& hash) {
+        MappedFile file;
+        if (!file.open(path)) return false;
+        hash = hashBytes(file.data, file.size, FNVOffsetBasis);
+        return true;
+    }
+
+    std::string ModelCache::getCacheFileName(UInt64 key) {
+        char name[32];
+        snprintf(name, sizeof(name), "%016llx.cmc", (unsigned long long)key);
+        return std::string(name);
+    }
+
+    Bool ModelCache::readModel(const std::string& path, UInt64 key, ModelData& data) {
+        std::shared_ptr<MappedFile> file = std::make_shared<MappedFile>();
+        if (!file->open(path)) return false;
+        ModelCacheReader reader(file->data, file->size);
+        if (!reader.readHeader(ModelCacheContent::Model, key)) return false;
+
+        UInt32 count;
+        if (!reader.read(count)) return false;
+        data.materials.resize(count);
+        for (MaterialRecord& material : data.materials) {
+            if (!reader.read(material.characteristics) || !reader.readString(material.albedoMapPath) ||
+                !reader.readString(material.normalMapPath) || !reader.readString(material.roughnessMapPath) ||
+                !reader.readString(material.opacityMapPath)) return false;
+        }
+
+        if (!reader.read(count)) return false;
+        data.meshes.resize(count);
+        for (MeshRecord& mesh : data.meshes) {
+            UInt32 attributeCount;
+            if (!reader.readString(mesh.name) || !reader.read(mesh.vertexCount) ||
+                !reader.read(mesh.enabledAttributes) || !reader.read(attributeCount)) return false;
+            mesh.attributes.resize(attributeCount);
+            for (AttributeRecord& attribute : mesh.attributes) {
+                UInt64 byteSize;
+                if (!reader.read(attribute.attribute) || !reader.readBlock(attribute.data, byteSize)) return false;
+                attribute.byteSize = (UInt32)byteSize;
+            }
+            if (!reader.read(mesh.indexCount) || !reader.readArray(mesh.indices, mesh.indexCount)) return false;
+            if (!reader.read(mesh.boneMapVertexCount) || !reader.read(mesh.boneMapUniqueVertexCount) ||
+                !reader.readArray(mesh.boneMapVertices, mesh.boneMapVertexCount)) return false;
+        }
+
+        if (!reader.read(count)) return false;
+        data.nodes.resize(count);
+        for (UInt32 n = 0; n < count; n++) {
+            NodeRecord& node = data.nodes[n];
+            UInt8 meshContainer;
+            UInt32 meshCount;
+            if (!reader.readString(node.name) || !reader.read(node.parentIndex) || !reader.readMatrix(node.localMatrix) ||
+                !reader.read(meshContainer) || !reader.read(node.materialIndex) || !reader.read(meshCount)) return false;
+            if (node.parentIndex >= (Int32)n || node.materialIndex >= (Int32)data.materials.size()) return false;
+            node.meshContainer = meshContainer != 0;
+            node.meshIndices.resize(meshCount);
+            for (UInt32& meshIndex : node.meshIndices) {
+                if (!reader.read(meshIndex) || meshIndex >= data.meshes.size()) return false;
+            }
+        }
+
+        if (!reader.read(count)) return false;
+        data.bones.resize(count);
+        for (BoneRecord& bone : data.bones) {
+            if (!reader.readString(bone.name) || !reader.readMatrix(bone.offsetMatrix)) return false;
+        }
+
+        if (!reader.read(count)) return false;
+        data.skeletonNodes.resize(count);
+        for (SkeletonNodeRecord& node : data.skeletonNodes) {
+            if (!reader.readString(node.name) || !reader.read(node.boneIndex) || !reader.read(node.targetNodeIndex) ||
+                !reader.readMatrix(node.initialTransform)) return false;
+            if (node.boneIndex >= (Int32)data.bones.size() || node.targetNodeIndex >= (Int32)data.nodes.size()) return false;
+        }
+
+        data.source = file;
+        return true;
+    }
+
+    Bool ModelCache::writeModel(const std::string& path, UInt64 key, const ModelData& data) {
+        ModelCacheWriter writer;
+        writer.writeHeader(ModelCacheContent::Model, key);
+
+        writer.write<UInt32>((UInt32)data.materials.size());
+        for (const MaterialRecord& material : data.materials) {
+            writer.write(material.characteristics);
+            writer.writeString(material.albedoMapPath);
+            writer.writeString(material.normalMapPath);
+            writer.writeString(material.roughnessMapPath);
+            writer.writeString(material.opacityMapPath);
+        }
+
+        writer.write<UInt32>((UInt32)data.meshes.size());
+        for (const MeshRecord& mesh : data.meshes) {
+            writer.writeString(mesh.name);
+            writer.write(mesh.vertexCount);
+            writer.write(mesh.enabledAttributes);
+            writer.write<UInt32>((UInt32)mesh.attributes.size());
+            for (const AttributeRecord& attribute : mesh.attributes) {
+                writer.write(attribute.attribute);
+                writer.writeBlock(attribute.data, attribute.byteSize);
+            }
+            writer.write(mesh.indexCount);
+            writer.writeBlock(mesh.indices, (UInt64)mesh.indexCount * sizeof(UInt32));
+            writer.write(mesh.boneMapVertexCount);
+            writer.write(mesh.boneMapUniqueVertexCount);
+            writer.writeBlock(mesh.boneMapVertices, (UInt64)mesh.boneMapVertexCount * sizeof(BoneMapVertexRecord));
+        }
+
+        writer.write<UInt32>((UInt32)data.nodes.size());
+        for (const NodeRecord& node : data.nodes) {
+            writer.writeString(node.name);
+            writer.write(node.parentIndex);
+            writer.writeMatrix(node.localMatrix);
+            writer.write<UInt8>(node.meshContainer ? 1 : 0);
+            writer.write(node.materialIndex);
+            writer.write<UInt32>((UInt32)node.meshIndices.size());
+            for (UInt32 meshIndex : node.meshIndices) writer.write(meshIndex);
+        }
+
+        writer.write<UInt32>((UInt32)data.bones.size());
+        for (const BoneRecord& bone : data.bones) {
+            writer.writeString(bone.name);
+            writer.writeMatrix(bone.offsetMatrix);
+        }
+
+        writer.write<UInt32>((UInt32)data.skeletonNodes.size());
+        for (const SkeletonNodeRecord& node : data.skeletonNodes) {
+            writer.writeString(node.name);
+            writer.write(node.boneIndex);
+            writer.write(node.targetNodeIndex);
+            writer.writeMatrix(node.initialTransform);
+        }
+
+        return writer.save(path);
+    }
+
+    Bool ModelCache::readAnimation(const std::string& path, UInt64 key, AnimationData& data) {
+        MappedFile file;
+        if (!file.open(path)) return false;
+        ModelCacheReader reader(file.data, file.size);
+        if (!reader.readHeader(ModelCacheContent::Animation, key)) return false;
+
+        UInt32 count;
+        if (!reader.read(data.durationTicks) || !reader.read(data.ticksPerSecond) || !reader.read(count)) return false;
+        data.channels.resize(count);
+        for (ChannelRecord& channel : data.channels) {
+            UInt8 used;
+            if (!reader.readString(channel.name) || !reader.read(used) || !reader.readVector(channel.translationKeyFrames) ||
+                !reader.readVector(channel.scaleKeyFrames) || !reader.readVector(channel.rotationKeyFrames)) return false;
+            channel.used = used != 0;
+        }
+        return true;
+    }
+
+    Bool ModelCache::writeAnimation(const std::string& path, UInt64 key, const AnimationData& data) {
+        ModelCacheWriter writer;
+        writer.writeHeader(ModelCacheContent::Animation, key);
+
+        writer.write(data.durationTicks);
+        writer.write(data.ticksPerSecond);
+        writer.write<UInt32>((UInt32)data.channels.size());
+        for (const ChannelRecord& channel : data.channels) {
+            writer.writeString(channel.name);
+            writer.write<UInt8>(channel.used ? 1 : 0);
+            writer.writeBlock(channel.translationKeyFrames.data(), channel.translationKeyFrames.size() * sizeof(KeyFrameRecord));
+            writer.writeBlock(channel.scaleKeyFrames.data(), channel.scaleKeyFrames.size() * sizeof(KeyFrameRecord));
+            writer.writeBlock(channel.rotationKeyFrames.data(), channel.rotationKeyFrames.size() * sizeof(KeyFrameRecord));
+        }
+
+        return writer.save(path);
+    }
+}
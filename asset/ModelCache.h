@@ -0,0 +1,142 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+
+#include "../common/types.h"
+#include "../common/Constants.h"
+
+namespace Core {
+
+    // Versioned binary cache for the fully processed output of ModelLoader. A cache file is keyed by a hash
+    // of the source asset and the import options, so a stale entry is simply never looked up again. Arrays
+    // are stored as 16-byte aligned blocks, and the reader maps the file into memory and hands out pointers
+    // into the mapping, so vertex data is copied exactly once: from the file straight into engine storage.
+    //
+    // The records below describe engine objects in plain terms; building them from (and turning them back
+    // into) scene objects is the job of ModelLoader.
+    class ModelCache {
+    public:
+        static const UInt32 Version = 1;
+
+        class MappedFile;
+
+        class MaterialRecord {
+        public:
+            UInt64 characteristics;
+            std::string albedoMapPath;
+            std::string normalMapPath;
+            std::string roughnessMapPath;
+            std::string opacityMapPath;
+        };
+
+        class AttributeRecord {
+        public:
+            UInt32 attribute;
+            UInt32 byteSize;
+            const Byte* data;
+        };
+
+        class BoneMapVertexRecord {
+        public:
+            UInt32 uniqueVertexIndex;
+            UInt32 boneCount;
+            UInt32 boneIndex[Constants::MaxBonesPerVertex];
+            Real weight[Constants::MaxBonesPerVertex];
+        };
+
+        class MeshRecord {
+        public:
+            std::string name;
+            UInt32 vertexCount;
+            UInt32 enabledAttributes;
+            std::vector<AttributeRecord> attributes;
+            UInt32 indexCount;
+            const UInt32* indices;
+            UInt32 boneMapVertexCount;
+            UInt32 boneMapUniqueVertexCount;
+            const BoneMapVertexRecord* boneMapVertices;
+
+            // backing storage for data that has no other home while a cache file is being written
+            std::vector<UInt32> indexStorage;
+            std::vector<BoneMapVertexRecord> boneMapStorage;
+        };
+
+        // Nodes are stored in pre-order, so a node's parent always precedes it. Mesh container nodes
+        // carry the meshes they render and the index of their material.
+        class NodeRecord {
+        public:
+            std::string name;
+            Int32 parentIndex;
+            Real localMatrix[16];
+            Bool meshContainer;
+            Int32 materialIndex;
+            std::vector<UInt32> meshIndices;
+        };
+
+        class BoneRecord {
+        public:
+            std::string name;
+            Real offsetMatrix[16];
+        };
+
+        class SkeletonNodeRecord {
+        public:
+            std::string name;
+            Int32 boneIndex;
+            Int32 targetNodeIndex;
+            Real initialTransform[16];
+        };
+
+        class ModelData {
+        public:
+            std::vector<MaterialRecord> materials;
+            std::vector<MeshRecord> meshes;
+            std::vector<NodeRecord> nodes;
+            std::vector<BoneRecord> bones;
+            std::vector<SkeletonNodeRecord> skeletonNodes;
+
+            // keeps the pointers in [meshes] valid for data that was read from a cache file
+            std::shared_ptr<MappedFile> source;
+        };
+
+        class KeyFrameRecord {
+        public:
+            Real normalizedTime;
+            Real realTime;
+            Real realTimeTicks;
+            Real value[4];
+        };
+
+        class ChannelRecord {
+        public:
+            std::string name;
+            Bool used;
+            std::vector<KeyFrameRecord> translationKeyFrames;
+            std::vector<KeyFrameRecord> scaleKeyFrames;
+            std::vector<KeyFrameRecord> rotationKeyFrames;
+        };
+
+        class AnimationData {
+        public:
+            Real durationTicks;
+            Real ticksPerSecond;
+            std::vector<ChannelRecord> channels;
+        };
+
+        static UInt64 hashBytes(const void* data, UInt64 size, UInt64 hash);
+        static Bool hashFile(const std::string& path, UInt64& hash);
+        static std::string getCacheFileName(UInt64 key);
+
+        // Readers return false when the file is missing, was written for a different key or format
+        // version, or is truncated; the caller is expected to fall back to a full import.
+        static Bool readModel(const std::string& path, UInt64 key, ModelData& data);
+        static Bool writeModel(const std::string& path, UInt64 key, const ModelData& data);
+        static Bool readAnimation(const std::string& path, UInt64 key, AnimationData& data);
+        static Bool writeAnimation(const std::string& path, UInt64 key, const AnimationData& data);
+
+    private:
+        ModelCache();
+    };
+}
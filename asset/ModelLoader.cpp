@@ -1,6 +1,7 @@
 #include <bitset>
 #include <fstream>
 #include <queue>
+#include <string.h>
 
 #include "assimp/DefaultLogger.hpp"
 #include "assimp/Importer.hpp"
@@ -31,18 +32,132 @@
 #include "../animation/Animation.h"
 #include "../animation/AnimationManager.h"
 #include "../geometry/Mesh.h"
+#include "../geometry/IndexBuffer.h"
+#include "../geometry/MeshOptimizer.h"
+#include "../common/debug.h"
 #include "ModelLoader.h"
 
 namespace Core {
     static std::shared_ptr<Assimp::Importer> importer = nullptr;
 
+    // tags the kind of cache entry, so a model and an animation loaded from the same file never share a key
+    enum class ModelCacheEntryType {
+        Model = 1,
+        Animation = 2
+    };
+
+    static void setupSkeletonNode(Skeleton::SkeletonNode * node, WeakPointer<Object3D> object3D, const Matrix4x4& mat) {
+        node->InitialTransform = mat;
+
+        Vector3r scale;
+        Vector3r translation;
+        Quaternion rotation;
+
+        // set the initial transformation properties
+        mat.decompose(translation, rotation, scale);
+        node->InitialTranslation = translation;
+        node->InitialRotation = rotation;
+        node->InitialScale = scale;
+
+        // if this skeleton node has a SceneObject target, then set it to [sceneObject]
+        Object3DSkeletonNode *soskNode = dynamic_cast<Object3DSkeletonNode*>(node);
+        if (soskNode != nullptr) {
+            soskNode->Target = object3D;
+        }
+    }
+
+    template <typename T>
+    static void captureAttribute(WeakPointer<AttributeArray<T>> array, StandardAttribute attribute, ModelCache::MeshRecord& record) {
+        if (!array.isValid()) return;
+        ModelCache::AttributeRecord attributeRecord;
+        attributeRecord.attribute = (UInt32)attribute;
+        attributeRecord.byteSize = array->getSize();
+        attributeRecord.data = (const Byte*)array->getStorage();
+        record.attributes.push_back(attributeRecord);
+    }
+
+    template <typename T>
+    static void storeCachedAttribute(WeakPointer<AttributeArray<T>> array, const ModelCache::AttributeRecord& record) {
+        if (!array.isValid() || array->getSize() != record.byteSize) {
+            throw ModelLoader::ModelLoaderException("ModelLoader::buildModelFromCache -> Cached attribute does not match mesh.");
+        }
+        array->store((const typename T::ComponentType*)record.data);
+    }
+
+    template <typename T>
+    static UInt32 getAttributeStride() {
+        return T::ComponentCount * sizeof(typename T::ComponentType);
+    }
+
+    // Size in bytes of one vertex's worth of [attribute] as Mesh stores it, or 0 if it is never cached.
+    static UInt32 getCachedAttributeStride(StandardAttribute attribute) {
+        switch (attribute) {
+            case StandardAttribute::Position:
+                return getAttributeStride<Point3rs>();
+            case StandardAttribute::Color:
+                return getAttributeStride<ColorS>();
+            case StandardAttribute::AlbedoUV:
+            case StandardAttribute::NormalUV:
+                return getAttributeStride<Vector2rs>();
+            case StandardAttribute::Normal:
+            case StandardAttribute::AveragedNormal:
+            case StandardAttribute::Tangent:
+            case StandardAttribute::FaceNormal:
+                return getAttributeStride<Vector3rs>();
+            default:
+                return 0;
+        }
+    }
+
     ModelLoader::ModelLoader() {
         this->fallbackTexturePathSet = false;
+        this->optimizeMeshes = false;
+        this->compressVertexAttributes = false;
+        this->compressAnimations = false;
     }
 
     ModelLoader::~ModelLoader() {
     }
 
+    /**
+     * Enable the binary model cache by pointing it at a writable directory. Models and animations that have
+     * been loaded once are then rebuilt from their processed form on subsequent loads, skipping Assimp. An
+     * empty [path] disables the cache.
+     */
+    void ModelLoader::setModelCacheDirectory(const std::string& path) {
+        this->modelCacheDirectory = path;
+    }
+
+    /**
+     * When enabled, imported meshes are welded into indexed meshes and reordered for the post-transform
+     * vertex cache, for overdraw and for vertex fetch (see MeshOptimizer).
+     */
+    void ModelLoader::setOptimizeMeshes(Bool optimizeMeshes) {
+        this->optimizeMeshes = optimizeMeshes;
+    }
+
+    /**
+     * When enabled, the GPU copies of imported vertex attributes are packed (see AttributeFormat): normals and
+     * tangents as 10:10:10:2, texture coordinates as half floats, colors and bone weights as 8-bit normalized
+     * values and bone indices as 16-bit integers. The CPU copies keep full precision.
+     */
+    void ModelLoader::setCompressVertexAttributes(Bool compressVertexAttributes) {
+        this->compressVertexAttributes = compressVertexAttributes;
+    }
+
+    /**
+     * When enabled, loaded animations are compressed (see AnimationCompressor): constant tracks are reduced
+     * to a single value, keys that can be reconstructed by interpolation are removed and the remaining keys
+     * are quantized. The model cache keeps the uncompressed key frames.
+     */
+    void ModelLoader::setCompressAnimations(Bool compressAnimations) {
+        this->compressAnimations = compressAnimations;
+    }
+
+    void ModelLoader::setAnimationCompressionSettings(const AnimationCompressor::Settings& settings) {
+        this->animationCompressionSettings = settings;
+    }
+
     void ModelLoader::setFallbackTexturePath(const std::string& path) {
         this->fallbackTexturePath = path;
         this->fallbackTexturePathSet = true;
@@ -106,12 +221,43 @@ namespace Core {
         std::shared_ptr<FileSystem> fileSystem = FileSystem::getInstance();
         std::string fixedModelPath = fileSystem->fixupPathForLocalFilesystem(modelPath);
 
+        // if the model was processed before with the same options, rebuild it from the cache and skip Assimp
+        std::vector<UInt64> cacheOptions = this->getModelCacheOptions(importScale, smoothingThreshold, preserveFBXPivots, preferPhysicalMaterial);
+        UInt64 cacheKey = 0;
+        std::string cacheFilePath;
+        Bool useCache = this->getCacheEntry(fixedModelPath, cacheOptions, cacheKey, cacheFilePath);
+        if (useCache) {
+            ModelCache::ModelData cachedModel;
+            // an entry that does not describe valid meshes is ignored, and rewritten by the import below
+            if (ModelCache::readModel(cacheFilePath, cacheKey, cachedModel) && ModelLoader::validateCachedModel(cachedModel)) {
+                WeakPointer<Object3D> result = this->buildModelFromCache(cachedModel, smoothingThreshold);
+                result->setActive(true);
+                return result;
+            }
+        }
+
         // the global Assimp scene object
         const aiScene* scene = this->loadAIScene(fixedModelPath, preserveFBXPivots);
 
         if (scene) {
             // the model has been loaded from disk into Assimp data structures, now convert to engine-native structures
+            this->importedMaterials.clear();
+            this->optimizationBefore = MeshOptimizer::Statistics();
+            this->optimizationAfter = MeshOptimizer::Statistics();
             WeakPointer<Object3D> result = processModelScene(fixedModelPath, *scene, importScale, smoothingThreshold, castShadows, receiveShadows, preferPhysicalMaterial);
+            if (this->optimizeMeshes && this->optimizationBefore.triangleCount > 0) {
+                Debug::PrintMessage("ModelLoader::loadModel() -> Optimized '%s': ACMR %.3f -> %.3f, ATVR %.3f -> %.3f\n", fixedModelPath.c_str(),
+                                    this->optimizationBefore.getACMR(), this->optimizationAfter.getACMR(),
+                                    this->optimizationBefore.getATVR(), this->optimizationAfter.getATVR());
+            }
+            if (useCache) {
+                // a model that cannot be described by the cache format is simply not cached
+                ModelCache::ModelData processedModel;
+                if (this->captureModel(result, processedModel)) {
+                    ModelCache::writeModel(cacheFilePath, cacheKey, processedModel);
+                }
+            }
+            this->importedMaterials.clear();
             result->setActive(true);
             return result;
         } else {
@@ -251,23 +397,44 @@ namespace Core {
                         objName = tempMeshNames.front();
                         convertedMesh->setName(objName);
                         tempMeshNames.pop();
-                        meshContainer->addRenderable(convertedMesh);
 
+                        WeakPointer<VertexBoneMap> vertexBoneMap;
                         if (hasSkeleton) {
                             // if the transformation matrix for this scene object has an inverted scale, we need to process the
                             // vertex bone map in reverse order.
                             Bool reverseVertexOrder = this->hasOddReflections(mat);
-                            WeakPointer<VertexBoneMap> vertexBoneMap = Engine::instance()->createVertexBoneMap(originalMesh->mNumVertices, originalMesh->mNumVertices);
+                            vertexBoneMap = Engine::instance()->createVertexBoneMap(originalMesh->mNumVertices, originalMesh->mNumVertices);
                             
                             Bool vertexBoneMapHasBones = this->setupVertexBoneMapMappingsFromAIMesh(skeleton, *originalMesh, vertexBoneMap);
                             if (vertexBoneMapHasBones) {
                                 if (!convertedMesh->isIndexed()) {
                                     vertexBoneMap = this->expandIndexBoneMapping(vertexBoneMap, *originalMesh, reverseVertexOrder);
                                 }
-                                vertexBoneMap->buildAttributeArray();
-                                meshContainer->addVertexBoneMap(convertedMesh->getObjectID(), vertexBoneMap);
+                            }
+                            else {
+                                Engine::safeReleaseObject(vertexBoneMap);
+                                vertexBoneMap = WeakPointer<VertexBoneMap>();
                             }
                         }
+
+                        // the optimizer replaces the mesh and its vertex bone map with reordered copies
+                        if (this->optimizeMeshes) {
+                            MeshOptimizer::Result optimized = MeshOptimizer::optimizeMesh(convertedMesh, vertexBoneMap, MeshOptimizer::Settings());
+                            convertedMesh = optimized.mesh;
+                            vertexBoneMap = optimized.vertexBoneMap;
+                            this->optimizationBefore.add(optimized.before);
+                            this->optimizationAfter.add(optimized.after);
+                        }
+
+                        if (this->compressVertexAttributes) {
+                            setCompressedAttributeFormats(convertedMesh, vertexBoneMap);
+                        }
+
+                        meshContainer->addRenderable(convertedMesh);
+                        if (vertexBoneMap.isValid()) {
+                            vertexBoneMap->buildAttributeArray();
+                            meshContainer->addVertexBoneMap(convertedMesh->getObjectID(), vertexBoneMap);
+                        }
                         addedCount++;
                     }
                     meshContainerObj->setName(objName);
@@ -310,23 +477,7 @@ namespace Core {
         if (nodeMapping >= 0) {
             Skeleton::SkeletonNode * node = skeleton->getNodeFromList(nodeMapping);
             if (node != nullptr) {
-                node->InitialTransform = mat;
-
-                Vector3r scale;
-                Vector3r translation;
-                Quaternion rotation;
-
-                // set the initial transformation properties
-                mat.decompose(translation, rotation, scale);
-                node->InitialTranslation = translation;
-                node->InitialRotation = rotation;
-                node->InitialScale = scale;
-
-                // if this skeleton node has a SceneObject target, then set it to [sceneObject]
-                Object3DSkeletonNode *soskNode = dynamic_cast<Object3DSkeletonNode*>(node);
-                if (soskNode != nullptr) {
-                    soskNode->Target = object3D;
-                }
+                setupSkeletonNode(node, object3D, mat);
             }
         }
     }
@@ -661,6 +812,11 @@ namespace Core {
                             throw ModelLoaderException("ModelLoader::ProcessMaterials -> Could not set up diffuse texture.");
                         }
                     }
+
+                    if (this->modelCacheDirectory.size() > 0) {
+                        this->recordImportedMaterial(matchingMaterial, shaderMaterialChacteristics, diffuseTexture, normalTexture,
+                                                     roughnessGlossTexture, opacityTexture);
+                    }
                 }
             }
 
@@ -785,12 +941,7 @@ namespace Core {
         std::string texPath = fileSystem->fixupPathForLocalFilesystem(std::string(aiTexturePath.data));
         std::string fullTextureFilePath = fileSystem->concatenatePaths(modelDirectory, texPath);
 
-        TextureAttributes texAttributes;
-        texAttributes.FilterMode = filter;
-        texAttributes.MipLevels = mipLevel;
-        texAttributes.WrapMode = TextureWrap::Mirror;
-        texAttributes.Format = TextureFormat::RGBA8;
-
+        TextureAttributes texAttributes = ModelLoader::getModelTextureAttributes(filter, mipLevel);
         Bool gammaCompress = (textureType == aiTextureType_DIFFUSE);
 
         // check if the file specified by the full path in the Assimp material exists
@@ -827,6 +978,13 @@ namespace Core {
         if (this->textureCache.find(path) != this->textureCache.end()) {
             return this->textureCache[path];
         } else {
+            TextureStreamer& textureStreamer = Engine::instance()->getTextureStreamer();
+            if (textureStreamer.isEnabled() && textureAttributes.Format == TextureFormat::RGBA8) {
+                WeakPointer<Texture2D> texture = textureStreamer.loadTexture(path, textureAttributes, gammaCompress);
+                this->textureCache[path] = texture;
+                return texture;
+            }
+
             std::shared_ptr<StandardImage> textureImage = ImageLoader::loadImageU(path.c_str(), false, gammaCompress);
             WeakPointer<Texture2D> texture = Engine::instance()->getGraphicsSystem()->createTexture2D(textureAttributes);
             this->textureCache[path] = texture;
@@ -1244,6 +1402,19 @@ namespace Core {
      *
      */
     WeakPointer<Animation> ModelLoader::loadAnimation(const std::string& filePath, Bool addLoopPadding, Bool preserveFBXPivots) {
+        std::vector<UInt64> cacheOptions = {(UInt64)ModelCacheEntryType::Animation, addLoopPadding ? 1ULL : 0ULL, preserveFBXPivots ? 1ULL : 0ULL};
+        UInt64 cacheKey = 0;
+        std::string cacheFilePath;
+        Bool useCache = this->getCacheEntry(filePath, cacheOptions, cacheKey, cacheFilePath);
+        if (useCache) {
+            ModelCache::AnimationData cachedAnimation;
+            if (ModelCache::readAnimation(cacheFilePath, cacheKey, cachedAnimation)) {
+                WeakPointer<Animation> animation = this->buildAnimationFromCache(cachedAnimation);
+                this->compressAnimation(animation, filePath);
+                return animation;
+            }
+        }
+
        this->initImporter();
 
         const aiScene * scene = this->loadAIScene(filePath, preserveFBXPivots);
@@ -1260,10 +1431,27 @@ namespace Core {
         if(!animation.isValid()) {
             throw ModelLoaderException("ModelLoader::loadAnimation -> Unable to load Animation.");
         }
+
+        if (useCache) {
+            ModelCache::AnimationData processedAnimation;
+            this->captureAnimation(animation, processedAnimation);
+            ModelCache::writeAnimation(cacheFilePath, cacheKey, processedAnimation);
+        }
+
+        this->compressAnimation(animation, filePath);
       
         return animation;
     }
 
+    void ModelLoader::compressAnimation(WeakPointer<Animation> animation, const std::string& filePath) const {
+        if (!this->compressAnimations) return;
+
+        AnimationCompressor::Statistics statistics = AnimationCompressor::compress(animation, this->animationCompressionSettings);
+        Debug::PrintMessage("ModelLoader::loadAnimation() -> Compressed '%s': %u -> %u keys (%u constant tracks), ratio %.2f, max error %f / %f / %f\n",
+                            filePath.c_str(), statistics.sourceKeyCount, statistics.keyCount, statistics.constantTrackCount, statistics.getCompressionRatio(),
+                            statistics.maxTranslationError, statistics.maxScaleError, statistics.maxRotationError);
+    }
+
     void ModelLoader::traverseScene(const aiScene& scene, SceneTraverseOrder traverseOrder, std::function<Bool(const aiNode&)> callback) const {
         if (scene.mRootNode != nullptr) {
             const aiNode& sceneRef = (const aiNode&)(*(scene.mRootNode));
@@ -1284,6 +1472,516 @@ namespace Core {
         }
     }
 
+    /**
+     * Check that the meshes in [data] can be rebuilt safely: every attribute must be one that Mesh stores
+     * and hold exactly one element per vertex, every index must refer to an existing vertex, and a vertex
+     * bone map must cover every vertex with in-range unique vertex indices and bone counts. The cache
+     * reader only checks that the file is well-formed, so this guards against entries written by a build
+     * with a different vertex layout.
+     */
+    Bool ModelLoader::validateCachedModel(const ModelCache::ModelData& data) {
+        for (const ModelCache::MeshRecord& mesh : data.meshes) {
+            for (const ModelCache::AttributeRecord& attribute : mesh.attributes) {
+                if (attribute.attribute >= (UInt32)StandardAttribute::_Count) return false;
+                UInt32 stride = getCachedAttributeStride((StandardAttribute)attribute.attribute);
+                if (stride == 0 || (UInt64)attribute.byteSize != (UInt64)mesh.vertexCount * stride) return false;
+                if (attribute.byteSize > 0 && attribute.data == nullptr) return false;
+            }
+            if (mesh.indexCount > 0 && mesh.indices == nullptr) return false;
+            for (UInt32 i = 0; i < mesh.indexCount; i++) {
+                if (mesh.indices[i] >= mesh.vertexCount) return false;
+            }
+
+            // a vertex bone map holds one descriptor per mesh vertex, each pointing at a vertex of the source mesh
+            if (mesh.boneMapVertexCount > 0) {
+                if (mesh.boneMapVertexCount != mesh.vertexCount || mesh.boneMapVertices == nullptr) return false;
+                for (UInt32 v = 0; v < mesh.boneMapVertexCount; v++) {
+                    const ModelCache::BoneMapVertexRecord& vertex = mesh.boneMapVertices[v];
+                    if (vertex.uniqueVertexIndex >= mesh.boneMapUniqueVertexCount) return false;
+                    if (vertex.boneCount > Constants::MaxBonesPerVertex) return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    /**
+     * The path of the cache file that loadModel() reads and writes for [filePath] with these options, or an
+     * empty string if the cache is disabled or the file cannot be read.
+     */
+    std::string ModelLoader::getModelCacheFilePath(const std::string& filePath, Real importScale, UInt32 smoothingThreshold,
+                                                   Bool preserveFBXPivots, Bool preferPhysicalMaterial) const {
+        std::shared_ptr<FileSystem> fileSystem = FileSystem::getInstance();
+        std::vector<UInt64> cacheOptions = this->getModelCacheOptions(importScale, smoothingThreshold, preserveFBXPivots, preferPhysicalMaterial);
+        UInt64 cacheKey = 0;
+        std::string cacheFilePath;
+        if (!this->getCacheEntry(fileSystem->fixupPathForLocalFilesystem(filePath), cacheOptions, cacheKey, cacheFilePath)) return std::string();
+        return cacheFilePath;
+    }
+
+    std::vector<UInt64> ModelLoader::getModelCacheOptions(Real importScale, UInt32 smoothingThreshold, Bool preserveFBXPivots, Bool preferPhysicalMaterial) const {
+        UInt64 importScaleBits = 0;
+        memcpy(&importScaleBits, &importScale, sizeof(Real));
+        return {(UInt64)ModelCacheEntryType::Model, importScaleBits, smoothingThreshold,
+                preserveFBXPivots ? 1ULL : 0ULL, preferPhysicalMaterial ? 1ULL : 0ULL,
+                this->optimizeMeshes ? 1ULL : 0ULL};
+    }
+
+    /**
+     * Compute the cache key for the file at [filePath] loaded with [options], and the path of the
+     * cache file that belongs to it. Returns false if the cache is disabled or the file cannot be read.
+     */
+    Bool ModelLoader::getCacheEntry(const std::string& filePath, const std::vector<UInt64>& options, UInt64& key, std::string& cacheFilePath) const {
+        if (this->modelCacheDirectory.size() == 0) return false;
+        if (!ModelCache::hashFile(filePath, key)) return false;
+        key = ModelCache::hashBytes(options.data(), options.size() * sizeof(UInt64), key);
+
+        std::shared_ptr<FileSystem> fileSystem = FileSystem::getInstance();
+        std::string cacheDirectory = fileSystem->fixupPathForLocalFilesystem(this->modelCacheDirectory);
+        cacheFilePath = fileSystem->concatenatePaths(cacheDirectory, ModelCache::getCacheFileName(key));
+        return true;
+    }
+
+    /**
+     * Rebuild a model from its cached form. Objects are created in the same order and with the same
+     * properties as the Assimp import path produces them, but vertex data is stored as-is instead of being
+     * converted, and normals and tangents are not recalculated because the cache already holds the results.
+     */
+    WeakPointer<Object3D> ModelLoader::buildModelFromCache(const ModelCache::ModelData& data, UInt32 smoothingThreshold) const {
+        if (data.nodes.size() == 0) {
+            throw ModelLoaderException("ModelLoader::buildModelFromCache -> Cached model has no nodes.");
+        }
+
+        MaterialLibrary& materialLibrary = Engine::instance()->getMaterialLibrary();
+        TextureAttributes texAttributes = ModelLoader::getModelTextureAttributes(TextureFilter::TriLinear, Core::Constants::DefaultMaxMipLevels);
+        std::vector<WeakPointer<Material>> materials;
+        for (const ModelCache::MaterialRecord& record : data.materials) {
+            if (!materialLibrary.hasMaterial(record.characteristics)) {
+                std::string msg = "Could not find loaded material for: ";
+                msg += std::bitset<64>(record.characteristics).to_string();
+                throw ModelLoaderException(msg);
+            }
+            WeakPointer<Material> material = materialLibrary.getMaterial(record.characteristics)->clone();
+
+            WeakPointer<Texture> albedoMap, normalMap, roughnessGlossMap, opacityMap;
+            if (record.albedoMapPath.size() > 0) albedoMap = this->loadTexture(record.albedoMapPath, texAttributes, true);
+            if (record.normalMapPath.size() > 0) normalMap = this->loadTexture(record.normalMapPath, texAttributes, false);
+            if (record.roughnessMapPath.size() > 0) roughnessGlossMap = this->loadTexture(record.roughnessMapPath, texAttributes, false);
+            if (record.opacityMapPath.size() > 0) opacityMap = this->loadTexture(record.opacityMapPath, texAttributes, false);
+            this->setTexturesOnMaterial(material, albedoMap, normalMap, roughnessGlossMap, opacityMap);
+            materials.push_back(material);
+        }
+
+        WeakPointer<Skeleton> skeleton;
+        if (data.bones.size() > 0) {
+            skeleton = Engine::instance()->createSkeleton((UInt32)data.bones.size(), true);
+            if (!skeleton.isValid()) {
+                throw AllocationException("ModelLoader::buildModelFromCache -> Could not allocate skeleton.");
+            }
+
+            for (UInt32 b = 0; b < data.bones.size(); b++) {
+                const ModelCache::BoneRecord& record = data.bones[b];
+                skeleton->mapBone(record.name, b);
+                Bone * bone = skeleton->getBone(b);
+                bone->Name = record.name;
+                bone->ID = b;
+                bone->OffsetMatrix.copy(record.offsetMatrix);
+            }
+
+            // same flat layout that createAndMapNodeHierarchy() produces: every node hangs off the root
+            Tree<Skeleton::SkeletonNode*>::TreeNode * rootNode = nullptr;
+            for (const ModelCache::SkeletonNodeRecord& record : data.skeletonNodes) {
+                Object3DSkeletonNode * skeletonNode = new(std::nothrow) Object3DSkeletonNode(WeakPointer<Object3D>::nullPtr(), record.boneIndex, record.name);
+                if (skeletonNode == nullptr) {
+                    throw AllocationException("ModelLoader::buildModelFromCache -> Could not allocate skeleton node.");
+                }
+                if (rootNode == nullptr) {
+                    rootNode = skeleton->createRoot(skeletonNode);
+                    if (rootNode == nullptr) throw Exception("ModelLoader::buildModelFromCache -> Could not create skeleton root node.");
+                }
+                else if (skeleton->addChild(rootNode, skeletonNode) == nullptr) {
+                    throw Exception("ModelLoader::buildModelFromCache -> Could not create skeleton child node.");
+                }
+
+                std::string nodeName = record.name;
+                skeleton->mapNode(nodeName, skeleton->getNodeCount());
+                skeleton->addNodeToList(skeletonNode);
+                if (record.boneIndex >= 0) {
+                    skeleton->getBone(record.boneIndex)->Node = skeletonNode;
+                }
+            }
+        }
+
+        std::vector<WeakPointer<Mesh>> meshes;
+        for (const ModelCache::MeshRecord& record : data.meshes) {
+            WeakPointer<Mesh> mesh = Engine::instance()->createMesh(record.vertexCount, record.indexCount);
+            if (!mesh.isValid()) {
+                throw ModelLoaderException("ModelLoader::buildModelFromCache -> Could not create mesh.");
+            }
+
+            for (const ModelCache::AttributeRecord& attribute : record.attributes) {
+                switch ((StandardAttribute)attribute.attribute) {
+                    case StandardAttribute::Position:
+                        mesh->initVertexPositions();
+                        storeCachedAttribute(mesh->getVertexPositions(), attribute);
+                        break;
+                    case StandardAttribute::Color:
+                        mesh->initVertexColors();
+                        storeCachedAttribute(mesh->getVertexColors(), attribute);
+                        break;
+                    case StandardAttribute::AlbedoUV:
+                        mesh->initVertexAlbedoUVs();
+                        storeCachedAttribute(mesh->getVertexAlbedoUVs(), attribute);
+                        break;
+                    case StandardAttribute::NormalUV:
+                        mesh->initVertexNormalUVs();
+                        storeCachedAttribute(mesh->getVertexNormalUVs(), attribute);
+                        break;
+                    case StandardAttribute::Normal:
+                        mesh->initVertexNormals();
+                        storeCachedAttribute(mesh->getVertexNormals(), attribute);
+                        break;
+                    case StandardAttribute::AveragedNormal:
+                        if (!mesh->getVertexAveragedNormals().isValid()) mesh->initVertexNormals();
+                        storeCachedAttribute(mesh->getVertexAveragedNormals(), attribute);
+                        break;
+                    case StandardAttribute::Tangent:
+                        mesh->initVertexTangents();
+                        storeCachedAttribute(mesh->getVertexTangents(), attribute);
+                        break;
+                    case StandardAttribute::FaceNormal:
+                        mesh->initVertexFaceNormals();
+                        storeCachedAttribute(mesh->getVertexFaceNormals(), attribute);
+                        break;
+                    default:
+                        throw ModelLoaderException("ModelLoader::buildModelFromCache -> Unsupported cached attribute.");
+                }
+            }
+
+            for (UInt32 a = 0; a < (UInt32)StandardAttribute::_Count; a++) {
+                if (StandardAttributes::hasAttribute(record.enabledAttributes, (StandardAttribute)a)) {
+                    mesh->enableAttribute((StandardAttribute)a);
+                }
+            }
+
+            if (record.indexCount > 0) {
+                mesh->getIndexBuffer()->setIndices(const_cast<UInt32*>(record.indices));
+            }
+
+            mesh->setName(record.name);
+            mesh->setNormalsSmoothingThreshold((Real)smoothingThreshold);
+            mesh->setCalculateNormals(false);
+            mesh->setCalculateTangents(false);
+            mesh->setCalculateBounds(true);
+            mesh->update();
+            meshes.push_back(mesh);
+        }
+
+        std::vector<WeakPointer<Object3D>> objects;
+        for (const ModelCache::NodeRecord& record : data.nodes) {
+            WeakPointer<Object3D> object = Engine::instance()->createObject3D();
+            if (!object.isValid()) {
+                throw ModelLoaderException("ModelLoader::buildModelFromCache -> Could not create scene object.");
+            }
+            object->setName(record.name);
+            object->getTransform().getLocalMatrix().copy(record.localMatrix);
+
+            if (record.meshContainer) {
+                WeakPointer<MeshContainer> meshContainer = Engine::instance()->createRenderableContainer<MeshContainer, Mesh>(object);
+                if (!meshContainer.isValid() || record.materialIndex < 0) {
+                    throw ModelLoaderException("ModelLoader::buildModelFromCache -> Could not create mesh container.");
+                }
+
+                for (UInt32 meshIndex : record.meshIndices) {
+                    const ModelCache::MeshRecord& meshRecord = data.meshes[meshIndex];
+                    WeakPointer<Mesh> mesh = meshes[meshIndex];
+                    if (this->compressVertexAttributes) {
+                        setCompressedAttributeFormats(mesh, WeakPointer<VertexBoneMap>());
+                    }
+                    meshContainer->addRenderable(mesh);
+
+                    if (skeleton.isValid() && meshRecord.boneMapVertexCount > 0) {
+                        WeakPointer<VertexBoneMap> vertexBoneMap = Engine::instance()->createVertexBoneMap(meshRecord.boneMapVertexCount,
+                                                                                                           meshRecord.boneMapUniqueVertexCount);
+                        for (UInt32 v = 0; v < meshRecord.boneMapVertexCount; v++) {
+                            const ModelCache::BoneMapVertexRecord& source = meshRecord.boneMapVertices[v];
+                            VertexBoneMap::VertexMappingDescriptor * desc = vertexBoneMap->getDescriptor(v);
+                            desc->UniqueVertexIndex = source.uniqueVertexIndex;
+                            desc->BoneCount = source.boneCount;
+                            for (UInt32 b = 0; b < source.boneCount && b < Constants::MaxBonesPerVertex; b++) {
+                                if (source.boneIndex[b] >= skeleton->getBoneCount()) {
+                                    throw ModelLoaderException("ModelLoader::buildModelFromCache -> Cached bone index is out of range.");
+                                }
+                                desc->BoneIndex[b] = source.boneIndex[b];
+                                desc->Weight[b] = source.weight[b];
+                                desc->Name[b] = skeleton->getBone(source.boneIndex[b])->Name;
+                            }
+                        }
+                        if (this->compressVertexAttributes) {
+                            setCompressedAttributeFormats(WeakPointer<Mesh>(), vertexBoneMap);
+                        }
+                        vertexBoneMap->buildAttributeArray();
+                        meshContainer->addVertexBoneMap(mesh->getObjectID(), vertexBoneMap);
+                    }
+                }
+
+                Engine::instance()->createRenderer<MeshRenderer, Mesh>(materials[record.materialIndex], object);
+                if (skeleton.isValid()) {
+                    Engine::instance()->addOwner(skeleton);
+                    meshContainer->setSkeleton(skeleton);
+                }
+            }
+
+            if (record.parentIndex >= 0) objects[record.parentIndex]->addChild(object);
+            objects.push_back(object);
+        }
+
+        if (skeleton.isValid()) {
+            for (UInt32 n = 0; n < data.skeletonNodes.size(); n++) {
+                const ModelCache::SkeletonNodeRecord& record = data.skeletonNodes[n];
+                WeakPointer<Object3D> target = record.targetNodeIndex >= 0 ? objects[record.targetNodeIndex] : WeakPointer<Object3D>::nullPtr();
+                Matrix4x4 initialTransform;
+                initialTransform.copy(record.initialTransform);
+                setupSkeletonNode(skeleton->getNodeFromList(n), target, initialTransform);
+            }
+        }
+
+        return objects[0];
+    }
+
+    /**
+     * Describe the model rooted at [root], as produced by processModelScene(), in cache records. Returns
+     * false if the model contains anything the cache format does not cover.
+     */
+    Bool ModelLoader::captureModel(WeakPointer<Object3D> root, ModelCache::ModelData& data) const {
+        std::unordered_map<UInt64, Int32> nodeIndices;
+        WeakPointer<Skeleton> skeleton;
+        if (!this->captureModelNode(root, -1, data, nodeIndices, skeleton)) return false;
+
+        // the backing vectors no longer move once all meshes have been added
+        for (ModelCache::MeshRecord& mesh : data.meshes) {
+            mesh.indices = mesh.indexStorage.size() > 0 ? mesh.indexStorage.data() : nullptr;
+            mesh.boneMapVertices = mesh.boneMapStorage.size() > 0 ? mesh.boneMapStorage.data() : nullptr;
+        }
+
+        if (skeleton.isValid()) {
+            for (UInt32 b = 0; b < skeleton->getBoneCount(); b++) {
+                Bone * bone = skeleton->getBone(b);
+                ModelCache::BoneRecord record;
+                record.name = bone->Name;
+                memcpy(record.offsetMatrix, bone->OffsetMatrix.getConstData(), sizeof(Real) * 16);
+                data.bones.push_back(record);
+            }
+
+            for (UInt32 n = 0; n < skeleton->getNodeCount(); n++) {
+                Skeleton::SkeletonNode * node = skeleton->getNodeFromList(n);
+                ModelCache::SkeletonNodeRecord record;
+                record.name = node->Name;
+                record.boneIndex = node->BoneIndex;
+                record.targetNodeIndex = -1;
+                memcpy(record.initialTransform, node->InitialTransform.getConstData(), sizeof(Real) * 16);
+                Object3DSkeletonNode * objectNode = dynamic_cast<Object3DSkeletonNode*>(node);
+                if (objectNode == nullptr) return false;
+                if (objectNode->Target.isValid()) {
+                    auto nodeIndex = nodeIndices.find(objectNode->Target->getObjectID());
+                    if (nodeIndex == nodeIndices.end()) return false;
+                    record.targetNodeIndex = nodeIndex->second;
+                }
+                data.skeletonNodes.push_back(record);
+            }
+        }
+
+        return true;
+    }
+
+    Bool ModelLoader::captureModelNode(WeakPointer<Object3D> object, Int32 parentIndex, ModelCache::ModelData& data,
+                                       std::unordered_map<UInt64, Int32>& nodeIndices, WeakPointer<Skeleton>& skeleton) const {
+        Int32 nodeIndex = (Int32)data.nodes.size();
+        nodeIndices[object->getObjectID()] = nodeIndex;
+        data.nodes.push_back(ModelCache::NodeRecord());
+        ModelCache::NodeRecord& node = data.nodes.back();
+        node.name = object->getName();
+        node.parentIndex = parentIndex;
+        memcpy(node.localMatrix, object->getTransform().getLocalMatrix().getConstData(), sizeof(Real) * 16);
+        node.meshContainer = false;
+        node.materialIndex = -1;
+
+        WeakPointer<MeshContainer> meshContainer = object->getMeshContainer();
+        if (meshContainer.isValid()) {
+            WeakPointer<MeshRenderer> meshRenderer = object->getMeshRenderer();
+            if (!meshRenderer.isValid() || !meshRenderer->getMaterial().isValid()) return false;
+            auto material = this->importedMaterials.find(meshRenderer->getMaterial()->getObjectID());
+            if (material == this->importedMaterials.end()) return false;
+            node.meshContainer = true;
+            node.materialIndex = (Int32)data.materials.size();
+            data.materials.push_back(material->second);
+
+            if (meshContainer->getSkeleton().isValid()) skeleton = meshContainer->getSkeleton();
+
+            for (UInt32 i = 0; i < meshContainer->getBaseRenderableCount(); i++) {
+                WeakPointer<Mesh> mesh = meshContainer->getRenderable(i);
+                ModelCache::MeshRecord record;
+                record.name = mesh->getName();
+                record.vertexCount = mesh->getVertexCount();
+                record.enabledAttributes = StandardAttributes::createAttributeSet();
+                for (UInt32 a = 0; a < (UInt32)StandardAttribute::_Count; a++) {
+                    if (mesh->isAttributeEnabled((StandardAttribute)a)) {
+                        StandardAttributes::addAttribute(&record.enabledAttributes, (StandardAttribute)a);
+                    }
+                }
+
+                captureAttribute(mesh->getVertexPositions(), StandardAttribute::Position, record);
+                captureAttribute(mesh->getVertexColors(), StandardAttribute::Color, record);
+                captureAttribute(mesh->getVertexAlbedoUVs(), StandardAttribute::AlbedoUV, record);
+                captureAttribute(mesh->getVertexNormalUVs(), StandardAttribute::NormalUV, record);
+                captureAttribute(mesh->getVertexNormals(), StandardAttribute::Normal, record);
+                captureAttribute(mesh->getVertexAveragedNormals(), StandardAttribute::AveragedNormal, record);
+                captureAttribute(mesh->getVertexTangents(), StandardAttribute::Tangent, record);
+                captureAttribute(mesh->getVertexFaceNormals(), StandardAttribute::FaceNormal, record);
+
+                record.indexCount = mesh->isIndexed() ? mesh->getIndexCount() : 0;
+                for (UInt32 idx = 0; idx < record.indexCount; idx++) {
+                    record.indexStorage.push_back(mesh->getIndexBuffer()->getIndex(idx));
+                }
+
+                record.boneMapVertexCount = 0;
+                record.boneMapUniqueVertexCount = 0;
+                if (meshContainer->hasVertexBoneMap(mesh->getObjectID())) {
+                    WeakPointer<VertexBoneMap> vertexBoneMap = meshContainer->getVertexBoneMap(mesh->getObjectID());
+                    record.boneMapVertexCount = vertexBoneMap->getVertexCount();
+                    record.boneMapUniqueVertexCount = vertexBoneMap->getUniqueVertexCount();
+                    record.boneMapStorage.resize(record.boneMapVertexCount);
+                    for (UInt32 v = 0; v < record.boneMapVertexCount; v++) {
+                        VertexBoneMap::VertexMappingDescriptor * desc = vertexBoneMap->getDescriptor(v);
+                        ModelCache::BoneMapVertexRecord& dest = record.boneMapStorage[v];
+                        dest.uniqueVertexIndex = desc->UniqueVertexIndex;
+                        dest.boneCount = desc->BoneCount;
+                        memcpy(dest.boneIndex, desc->BoneIndex, sizeof(UInt32) * Constants::MaxBonesPerVertex);
+                        memcpy(dest.weight, desc->Weight, sizeof(Real) * Constants::MaxBonesPerVertex);
+                    }
+                }
+
+                node.meshIndices.push_back((UInt32)data.meshes.size());
+                data.meshes.push_back(std::move(record));
+            }
+        }
+
+        for (UInt32 i = 0; i < object->childCount(); i++) {
+            if (!this->captureModelNode(object->getChild(i), nodeIndex, data, nodeIndices, skeleton)) return false;
+        }
+
+        return true;
+    }
+
+    WeakPointer<Animation> ModelLoader::buildAnimationFromCache(const ModelCache::AnimationData& data) const {
+        WeakPointer<Animation> animation = Engine::instance()->getAnimationManager()->createAnimation(data.durationTicks, data.ticksPerSecond);
+        if (!animation.isValid()) {
+            throw ModelLoaderException("ModelLoader::buildAnimationFromCache -> Unable to create Animation.");
+        }
+        if (!animation->init((UInt32)data.channels.size())) {
+            throw ModelLoaderException("ModelLoader::buildAnimationFromCache -> Unable to initialize Animation.");
+        }
+
+        for (UInt32 n = 0; n < data.channels.size(); n++) {
+            const ModelCache::ChannelRecord& channel = data.channels[n];
+            animation->setChannelName(n, channel.name);
+            KeyFrameSet * keyFrameSet = animation->getKeyFrameSet(n);
+            if (keyFrameSet == nullptr) {
+                throw ModelLoaderException(std::string("ModelLoader::buildAnimationFromCache -> nullptr KeyFrameSet encountered for: ") + channel.name);
+            }
+            keyFrameSet->Used = channel.used;
+
+            keyFrameSet->TranslationKeyFrames.reserve(channel.translationKeyFrames.size());
+            for (const ModelCache::KeyFrameRecord& record : channel.translationKeyFrames) {
+                TranslationKeyFrame keyFrame;
+                keyFrame.NormalizedTime = record.normalizedTime;
+                keyFrame.RealTime = record.realTime;
+                keyFrame.RealTimeTicks = record.realTimeTicks;
+                keyFrame.Translation.set(record.value[0], record.value[1], record.value[2]);
+                keyFrameSet->TranslationKeyFrames.push_back(keyFrame);
+            }
+
+            keyFrameSet->ScaleKeyFrames.reserve(channel.scaleKeyFrames.size());
+            for (const ModelCache::KeyFrameRecord& record : channel.scaleKeyFrames) {
+                ScaleKeyFrame keyFrame;
+                keyFrame.NormalizedTime = record.normalizedTime;
+                keyFrame.RealTime = record.realTime;
+                keyFrame.RealTimeTicks = record.realTimeTicks;
+                keyFrame.Scale.set(record.value[0], record.value[1], record.value[2]);
+                keyFrameSet->ScaleKeyFrames.push_back(keyFrame);
+            }
+
+            keyFrameSet->RotationKeyFrames.reserve(channel.rotationKeyFrames.size());
+            for (const ModelCache::KeyFrameRecord& record : channel.rotationKeyFrames) {
+                RotationKeyFrame keyFrame;
+                keyFrame.NormalizedTime = record.normalizedTime;
+                keyFrame.RealTime = record.realTime;
+                keyFrame.RealTimeTicks = record.realTimeTicks;
+                keyFrame.Rotation.set(record.value[0], record.value[1], record.value[2], record.value[3]);
+                keyFrameSet->RotationKeyFrames.push_back(keyFrame);
+            }
+        }
+
+        return animation;
+    }
+
+    void ModelLoader::captureAnimation(WeakPointer<Animation> animation, ModelCache::AnimationData& data) const {
+        data.durationTicks = animation->getDurationTicks();
+        data.ticksPerSecond = animation->getTicksPerSecond();
+        data.channels.resize(animation->getChannelCount());
+        for (UInt32 n = 0; n < animation->getChannelCount(); n++) {
+            ModelCache::ChannelRecord& channel = data.channels[n];
+            const std::string * channelName = animation->getChannelName(n);
+            if (channelName != nullptr) channel.name = *channelName;
+            KeyFrameSet * keyFrameSet = animation->getKeyFrameSet(n);
+            channel.used = keyFrameSet->Used;
+
+            for (const TranslationKeyFrame& keyFrame : keyFrameSet->TranslationKeyFrames) {
+                ModelCache::KeyFrameRecord record = {keyFrame.NormalizedTime, keyFrame.RealTime, keyFrame.RealTimeTicks,
+                                                     {keyFrame.Translation.x, keyFrame.Translation.y, keyFrame.Translation.z, 0.0f}};
+                channel.translationKeyFrames.push_back(record);
+            }
+            for (const ScaleKeyFrame& keyFrame : keyFrameSet->ScaleKeyFrames) {
+                ModelCache::KeyFrameRecord record = {keyFrame.NormalizedTime, keyFrame.RealTime, keyFrame.RealTimeTicks,
+                                                     {keyFrame.Scale.x, keyFrame.Scale.y, keyFrame.Scale.z, 0.0f}};
+                channel.scaleKeyFrames.push_back(record);
+            }
+            for (const RotationKeyFrame& keyFrame : keyFrameSet->RotationKeyFrames) {
+                ModelCache::KeyFrameRecord record = {keyFrame.NormalizedTime, keyFrame.RealTime, keyFrame.RealTimeTicks,
+                                                     {keyFrame.Rotation.x(), keyFrame.Rotation.y(), keyFrame.Rotation.z(), keyFrame.Rotation.w()}};
+                channel.rotationKeyFrames.push_back(record);
+            }
+        }
+    }
+
+    void ModelLoader::recordImportedMaterial(WeakPointer<Material> material, LongMask shaderMaterialChacteristics, WeakPointer<Texture> albedoMap,
+                                             WeakPointer<Texture> normalMap, WeakPointer<Texture> roughnessGlossMap, WeakPointer<Texture> opacityMap) const {
+        ModelCache::MaterialRecord record;
+        record.characteristics = shaderMaterialChacteristics;
+        record.albedoMapPath = this->getCachedTexturePath(albedoMap);
+        record.normalMapPath = this->getCachedTexturePath(normalMap);
+        record.roughnessMapPath = this->getCachedTexturePath(roughnessGlossMap);
+        record.opacityMapPath = this->getCachedTexturePath(opacityMap);
+        this->importedMaterials[material->getObjectID()] = record;
+    }
+
+    std::string ModelLoader::getCachedTexturePath(WeakPointer<Texture> texture) const {
+        if (!texture.isValid()) return std::string();
+        for (auto& entry : this->textureCache) {
+            if (entry.second.get() == texture.get()) return entry.first;
+        }
+        return std::string();
+    }
+
+    TextureAttributes ModelLoader::getModelTextureAttributes(TextureFilter filter, UInt32 mipLevel) {
+        TextureAttributes texAttributes;
+        texAttributes.FilterMode = filter;
+        texAttributes.MipLevels = mipLevel;
+        texAttributes.WrapMode = TextureWrap::Mirror;
+        texAttributes.Format = TextureFormat::RGBA8;
+        return texAttributes;
+    }
+
     /*
      * Determine if [mat] has an odd number of reflections.
      */
@@ -1293,6 +1991,23 @@ namespace Core {
         return false;
     }
 
+    void ModelLoader::setCompressedAttributeFormats(WeakPointer<Mesh> mesh, WeakPointer<VertexBoneMap> vertexBoneMap) {
+        if (mesh.isValid()) {
+            mesh->setAttributeFormat(StandardAttribute::Normal, AttributeFormat::SNorm10_10_10_2);
+            mesh->setAttributeFormat(StandardAttribute::AveragedNormal, AttributeFormat::SNorm10_10_10_2);
+            mesh->setAttributeFormat(StandardAttribute::FaceNormal, AttributeFormat::SNorm10_10_10_2);
+            mesh->setAttributeFormat(StandardAttribute::Tangent, AttributeFormat::SNorm10_10_10_2);
+            mesh->setAttributeFormat(StandardAttribute::Color, AttributeFormat::UNorm8);
+            mesh->setAttributeFormat(StandardAttribute::AlbedoUV, AttributeFormat::HalfFloat);
+            mesh->setAttributeFormat(StandardAttribute::NormalUV, AttributeFormat::HalfFloat);
+        }
+        // 16-bit indices stay valid if the map is later bound to a skeleton with more than 256 bones
+        if (vertexBoneMap.isValid()) {
+            vertexBoneMap->setWeightFormat(AttributeFormat::UNorm8Weights);
+            vertexBoneMap->setIndexFormat(AttributeFormat::UInt16);
+        }
+    }
+
     void ModelLoader::convertAssimpMatrix(const aiMatrix4x4& source, Matrix4x4& dest) {
         Real data[16];
 
@@ -20,12 +20,16 @@
 #include "../material/StandardUniforms.h"
 #include "../material/StandardAttributes.h"
 #include "../math/Matrix4x4.h"
+#include "../geometry/MeshOptimizer.h"
+#include "../animation/AnimationCompressor.h"
+#include "ModelCache.h"
 
 namespace Core {
 
     // forward declarations
     class Object3D;
     class Texture;
+    class Texture2D;
     class Material;
     class Engine;
     class Mesh;
@@ -46,10 +50,19 @@ namespace Core {
         ModelLoader();
         virtual ~ModelLoader();
         void setFallbackTexturePath(const std::string& path);
+        void setModelCacheDirectory(const std::string& path);
+        void setOptimizeMeshes(Bool optimizeMeshes);
+        void setCompressVertexAttributes(Bool compressVertexAttributes);
+        void setCompressAnimations(Bool compressAnimations);
+        void setAnimationCompressionSettings(const AnimationCompressor::Settings& settings);
         WeakPointer<Object3D> loadModel(const std::string& filePath, Real importScale, UInt32 smoothingThreshold, 
                                         Bool castShadows, Bool receiveShadows, Bool preserveFBXPivots, Bool preferPhysicalMaterial);
         WeakPointer<Animation> loadAnimation(const std::string& filePath, Bool addLoopPadding, Bool preserveFBXPivots);
 
+        std::string getModelCacheFilePath(const std::string& filePath, Real importScale, UInt32 smoothingThreshold,
+                                          Bool preserveFBXPivots, Bool preferPhysicalMaterial) const;
+        static Bool validateCachedModel(const ModelCache::ModelData& data);
+
     private:
 
 #ifdef CORE_USE_PRIVATE_INCLUDES
@@ -131,10 +144,25 @@ namespace Core {
         UInt32 countBones(const aiScene& scene) const;
         Bool createAndMapNodeHierarchy(WeakPointer<Skeleton> skeleton, const aiScene& scene) const;
         WeakPointer<Animation> loadAnimation(aiAnimation& animation, Bool addLoopPadding) const;
+        void compressAnimation(WeakPointer<Animation> animation, const std::string& filePath) const;
         void traverseScene(const aiScene& scene, SceneTraverseOrder traverseOrder, std::function<Bool(const aiNode&)> callback) const;
         void preOrderTraverseScene(const aiScene& scene, const aiNode& node, std::function<Bool(const aiNode&)> callback) const;
 
+        std::vector<UInt64> getModelCacheOptions(Real importScale, UInt32 smoothingThreshold, Bool preserveFBXPivots, Bool preferPhysicalMaterial) const;
+        Bool getCacheEntry(const std::string& filePath, const std::vector<UInt64>& options, UInt64& key, std::string& cacheFilePath) const;
+        WeakPointer<Object3D> buildModelFromCache(const ModelCache::ModelData& data, UInt32 smoothingThreshold) const;
+        Bool captureModel(WeakPointer<Object3D> root, ModelCache::ModelData& data) const;
+        Bool captureModelNode(WeakPointer<Object3D> object, Int32 parentIndex, ModelCache::ModelData& data,
+                              std::unordered_map<UInt64, Int32>& nodeIndices, WeakPointer<Skeleton>& skeleton) const;
+        WeakPointer<Animation> buildAnimationFromCache(const ModelCache::AnimationData& data) const;
+        void captureAnimation(WeakPointer<Animation> animation, ModelCache::AnimationData& data) const;
+        void recordImportedMaterial(WeakPointer<Material> material, LongMask shaderMaterialChacteristics, WeakPointer<Texture> albedoMap,
+                                    WeakPointer<Texture> normalMap, WeakPointer<Texture> roughnessGlossMap, WeakPointer<Texture> opacityMap) const;
+        std::string getCachedTexturePath(WeakPointer<Texture> texture) const;
+        static TextureAttributes getModelTextureAttributes(TextureFilter filter, UInt32 mipLevel);
+
         static Bool hasOddReflections(Matrix4x4& mat);      
+        static void setCompressedAttributeFormats(WeakPointer<Mesh> mesh, WeakPointer<VertexBoneMap> vertexBoneMap);
         static void convertAssimpMatrix(const aiMatrix4x4& source, Matrix4x4& dest);                  
 #endif
 
@@ -142,5 +170,13 @@ namespace Core {
         Bool fallbackTexturePathSet;
         std::string fallbackTexturePath;
         mutable std::unordered_map<std::string, WeakPointer<Texture2D>> textureCache;
+        std::string modelCacheDirectory;
+        mutable std::unordered_map<UInt64, ModelCache::MaterialRecord> importedMaterials;
+        Bool optimizeMeshes;
+        Bool compressVertexAttributes;
+        Bool compressAnimations;
+        AnimationCompressor::Settings animationCompressionSettings;
+        mutable MeshOptimizer::Statistics optimizationBefore;
+        mutable MeshOptimizer::Statistics optimizationAfter;
     };
 }
\ No newline at end of file
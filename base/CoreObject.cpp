@@ -7,14 +7,36 @@ namespace Core {
 
     CoreObject::CoreObject() {
         this->objectID = _cur_id++;
+#ifdef __CORE_WEAK_POINTER_USE_HANDLES
+        this->objectHandle = ObjectHandleTable::acquire();
+#endif
+    }
+
+    // Copies keep the object ID but must never share a handle, since each copy has its own lifetime.
+    CoreObject::CoreObject(const CoreObject& other) {
+        this->objectID = other.objectID;
+#ifdef __CORE_WEAK_POINTER_USE_HANDLES
+        this->objectHandle = ObjectHandleTable::acquire();
+#endif
+    }
+
+    CoreObject& CoreObject::operator =(const CoreObject& other) {
+        this->objectID = other.objectID;
+        return *this;
     }
 
     CoreObject::~CoreObject() {
-        
+#ifdef __CORE_WEAK_POINTER_USE_HANDLES
+        ObjectHandleTable::release(this->objectHandle);
+#endif
     }
 
     UInt64 CoreObject::getObjectID() const {
         return this->objectID;
     }
 
+    const ObjectHandle& CoreObject::getObjectHandle() const {
+        return this->objectHandle;
+    }
+
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../common/types.h"
+#include "../util/ObjectHandleTable.h"
 
 namespace Core {
 
@@ -13,11 +14,15 @@ namespace Core {
         
     public:
         UInt64 getObjectID() const;
+        const ObjectHandle& getObjectHandle() const;
         virtual ~CoreObject();
 
     protected:
         CoreObject();
+        CoreObject(const CoreObject& other);
+        CoreObject& operator =(const CoreObject& other);
         UInt64 objectID;
+        ObjectHandle objectHandle;
     };
 
 }
\ No newline at end of file
@@ -20,7 +20,7 @@ namespace Core {
     }
 
     void CoreObjectReferenceManager::removeReference(WeakPointer<CoreObject> object) {
-        const UInt32 objectID = object->getObjectID();
+        const UInt64 objectID = object->getObjectID();
         std::unordered_map<UInt64, UInt32>::const_iterator loc = this->referenceCounts.find(objectID);
         if (loc != this->referenceCounts.end()) {
             UInt32& referenceCount = this->referenceCounts[objectID];
@@ -29,7 +29,16 @@ namespace Core {
             }
             referenceCount--;
             if (referenceCount == 0) {
-                this->references.erase(this->references.begin() + this->referenceIndex[objectID]);
+                // move the last reference into the freed slot, so the stored index of every other object stays
+                // valid; the removed object is destroyed on return, since its destructor may release others
+                UInt32 index = this->referenceIndex[objectID];
+                std::shared_ptr<CoreObject> removed = this->references[index];
+                if (index + 1 < this->references.size()) {
+                    this->references[index] = this->references.back();
+                    this->referenceIndex[this->references[index]->getObjectID()] = index;
+                }
+                this->references.pop_back();
+                this->referenceIndex.erase(objectID);
             }
         } else {
             throw Exception("CoreObjectReferenceManager::removeReference() -> 'object' not present.");
@@ -0,0 +1,126 @@
+#include <cmath>
+#include <vector>
+
+#include "Benchmark.h"
+#include "../animation/AnimationTracks.h"
+#include "../animation/KeyFrameSet.h"
+#include "../animation/PoseBuffer.h"
+#include "../math/Matrix4x4.h"
+#include "../math/Quaternion.h"
+
+using namespace Core;
+
+static const UInt32 NodeCount = 100;
+static const UInt32 KeyCount = 60;
+static const Real FrameTime = 1.0f / 30.0f;
+static const Real Duration = (Real)(KeyCount - 1) * FrameTime;
+
+static void buildKeyFrameSets(std::vector<KeyFrameSet>& keyFrameSets) {
+    keyFrameSets.resize(NodeCount);
+    for (UInt32 n = 0; n < NodeCount; n++) {
+        KeyFrameSet& keyFrameSet = keyFrameSets[n];
+        keyFrameSet.Used = true;
+        for (UInt32 k = 0; k < KeyCount; k++) {
+            Real time = (Real)k * FrameTime;
+            Real phase = time / Duration * 6.2831853f + (Real)n * 0.1f;
+            keyFrameSet.TranslationKeyFrames.push_back(TranslationKeyFrame(time / Duration, time, time,
+                                                                           Vector3r(std::sin(phase), std::cos(phase), (Real)n * 0.01f)));
+            keyFrameSet.RotationKeyFrames.push_back(RotationKeyFrame(time / Duration, time, time, Quaternion::fromAngleAxis(phase, 0.0f, 1.0f, 0.0f)));
+            keyFrameSet.ScaleKeyFrames.push_back(ScaleKeyFrame(time / Duration, time, time, Vector3r(1.0f, 1.0f, 1.0f)));
+        }
+    }
+}
+
+// The sampling that AnimationTracks replaced: a linear search through each component's key frame objects,
+// then one Matrix4x4 composition per node. Kept here only as the benchmark baseline.
+template <typename KeyFrameType>
+static Bool findKeyFrames(const std::vector<KeyFrameType>& keyFrames, Real progress, UInt32& previous, UInt32& next, Real& interFrameProgress) {
+    UInt32 frameCount = (UInt32)keyFrames.size();
+    for (UInt32 f = 0; f < frameCount; f++) {
+        Real keyRealTime = keyFrames[f].RealTime;
+        if (keyRealTime > progress || f == frameCount - 1) {
+            previous = f > 0 ? f - 1 : 0;
+            next = f;
+            Bool overShoot = false;
+            if (f == frameCount - 1 && keyRealTime <= progress) {
+                previous = f;
+                next = 0;
+                overShoot = true;
+            }
+            Real delta = overShoot ? Duration - keyFrames[previous].RealTime : keyFrames[next].RealTime - keyFrames[previous].RealTime;
+            interFrameProgress = delta > 0 ? (progress - keyFrames[previous].RealTime) / delta : 1;
+            return true;
+        }
+    }
+    return false;
+}
+
+static void sampleKeyFrameObjects(const std::vector<KeyFrameSet>& keyFrameSets, Real progress, std::vector<Matrix4x4>& matrices) {
+    for (UInt32 n = 0; n < NodeCount; n++) {
+        const KeyFrameSet& keyFrameSet = keyFrameSets[n];
+        UInt32 previous, next;
+        Real t;
+
+        Vector3r translation;
+        findKeyFrames(keyFrameSet.TranslationKeyFrames, progress, previous, next, t);
+        const Vector3r& ta = keyFrameSet.TranslationKeyFrames[previous].Translation;
+        const Vector3r& tb = keyFrameSet.TranslationKeyFrames[next].Translation;
+        translation.set(ta.x + (tb.x - ta.x) * t, ta.y + (tb.y - ta.y) * t, ta.z + (tb.z - ta.z) * t);
+
+        Vector3r scale;
+        findKeyFrames(keyFrameSet.ScaleKeyFrames, progress, previous, next, t);
+        const Vector3r& sa = keyFrameSet.ScaleKeyFrames[previous].Scale;
+        const Vector3r& sb = keyFrameSet.ScaleKeyFrames[next].Scale;
+        scale.set(sa.x + (sb.x - sa.x) * t, sa.y + (sb.y - sa.y) * t, sa.z + (sb.z - sa.z) * t);
+
+        findKeyFrames(keyFrameSet.RotationKeyFrames, progress, previous, next, t);
+        Quaternion rotation = Quaternion::slerp(keyFrameSet.RotationKeyFrames[previous].Rotation, keyFrameSet.RotationKeyFrames[next].Rotation, t);
+        rotation.normalize();
+
+        Matrix4x4& matrix = matrices[n];
+        matrix.setIdentity();
+        matrix.scale(scale.x, scale.y, scale.z);
+        matrix.preMultiply(rotation.rotationMatrix());
+        matrix.preTranslate(translation.x, translation.y, translation.z);
+    }
+}
+
+int main(int argc, char** argv) {
+    const UInt32 iterations = 20000;
+
+    std::vector<KeyFrameSet> keyFrameSets;
+    buildKeyFrameSets(keyFrameSets);
+    std::vector<Matrix4x4> objectMatrices(NodeCount);
+    Real progress = 0.0f;
+    Real objectTime = Benchmark::run("key frame objects, 100-bone pose", iterations, [&]() {
+        progress = std::fmod(progress + 1.0f / 60.0f, Duration);
+        sampleKeyFrameObjects(keyFrameSets, progress, objectMatrices);
+        Benchmark::sink += (UInt64)objectMatrices[NodeCount - 1].getConstData()[12];
+    });
+
+    // AnimationTracks::build() releases the key frame objects, so it gets its own copy
+    std::vector<KeyFrameSet> trackKeyFrameSets;
+    buildKeyFrameSets(trackKeyFrameSets);
+    AnimationTracks tracks;
+    tracks.build(trackKeyFrameSets.data(), NodeCount);
+    PoseBuffer pose;
+    pose.resize(NodeCount);
+    std::vector<UInt32> keyHints(NodeCount * 3, 0);
+    std::vector<Real> trackMatrices(NodeCount * 16);
+    progress = 0.0f;
+    Real trackTime = Benchmark::run("contiguous tracks, 100-bone pose", iterations, [&]() {
+        progress = std::fmod(progress + 1.0f / 60.0f, Duration);
+        Real translation[3], rotation[4], scale[3];
+        for (UInt32 n = 0; n < NodeCount; n++) {
+            tracks.sample(n, progress, Duration, false, &keyHints[n * 3], translation, rotation, scale);
+            pose.setNode(n, translation, rotation, scale);
+        }
+        pose.composeMatrices(trackMatrices.data(), 0, NodeCount);
+        Benchmark::sink += (UInt64)trackMatrices[(NodeCount - 1) * 16 + 12];
+    });
+
+    printf("%-48s %14.2f us\n", "key frame objects, per 100-bone pose", objectTime / 1000.0f);
+    printf("%-48s %14.2f us\n", "contiguous tracks, per 100-bone pose", trackTime / 1000.0f);
+    Benchmark::printComparison("key frame objects vs contiguous tracks", objectTime, trackTime);
+    return 0;
+}
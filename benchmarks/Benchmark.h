@@ -0,0 +1,32 @@
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+
+#include "../common/types.h"
+
+namespace Core {
+
+    namespace Benchmark {
+
+        // Written to by benchmarks so that the compiler cannot discard the measured work.
+        static volatile UInt64 sink = 0;
+
+        // Runs [function] [iterations] times (after one untimed warm-up call) and prints the
+        // average time per iteration. Returns the average in nanoseconds.
+        template <typename Function>
+        Real run(const char* name, UInt32 iterations, Function function) {
+            function();
+            auto start = std::chrono::high_resolution_clock::now();
+            for (UInt32 i = 0; i < iterations; i++) function();
+            auto end = std::chrono::high_resolution_clock::now();
+            Real nanoseconds = (Real)std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count() / (Real)iterations;
+            printf("%-48s %14.2f ns/iter\n", name, nanoseconds);
+            return nanoseconds;
+        }
+
+        inline void printComparison(const char* name, Real baseline, Real optimized) {
+            printf("%-48s %14.2fx\n", name, optimized > 0.0f ? baseline / optimized : 0.0f);
+        }
+    }
+}
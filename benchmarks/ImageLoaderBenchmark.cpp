@@ -0,0 +1,118 @@
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Benchmark.h"
+#include "../image/ImageLoader.h"
+#include "../image/RawImage.h"
+#include "../image/STBImage.h"
+#include "../math/Math.h"
+
+using namespace Core;
+
+// ImageLoader::loadImageU() as it was before decoding straight into the destination: DevIL converts
+// the image in place, every element is copied with setElement(), and gamma is applied per element.
+static std::shared_ptr<StandardImage> loadImageUPrevious(const std::string& path, Bool reverseOrigin, Bool shouldGammaCompress) {
+    ilOriginFunc(reverseOrigin ? IL_ORIGIN_UPPER_LEFT : IL_ORIGIN_LOWER_LEFT);
+    ILuint imageIds[1];
+    ilGenImages(1, imageIds);
+    ilBindImage(imageIds[0]);
+    std::shared_ptr<StandardImage> image;
+    if (ilLoadImage(path.c_str()) && ilConvertImage(IL_RGBA, IL_UNSIGNED_BYTE)) {
+        UInt32 width = ilGetInteger(IL_IMAGE_WIDTH);
+        UInt32 height = ilGetInteger(IL_IMAGE_HEIGHT);
+        const ILubyte* data = ilGetData();
+        image = std::make_shared<StandardImage>(width, height);
+        image->init();
+        for (UInt32 i = 0; i < width * height * 4; i++) image->setElement(i, (Byte)data[i]);
+    }
+    ilDeleteImages(1, imageIds);
+    ilOriginFunc(IL_ORIGIN_LOWER_LEFT);
+
+    if (image && shouldGammaCompress) {
+        for (UInt32 i = 0; i < image->getWidth() * image->getHeight() * 4; i++) {
+            if ((i + 1) % 4 == 0) continue;
+            Real compressed = Math::pow(((Real)image->getElement(i)) / 255.0f, 2.22f);
+            image->setElement(i, Math::clamp((Byte)(compressed * 255.0f), (Byte)0, (Byte)255));
+        }
+    }
+    return image;
+}
+
+// ImageLoader::loadImageHDR() as it was: stb_image decodes RGB, which is expanded to RGBA element by element.
+static std::shared_ptr<HDRImage> loadImageHDRPrevious(const std::string& path, Bool invertY, Bool shouldGammaCompress) {
+    stbi_set_flip_vertically_on_load(invertY);
+    int width = 0, height = 0, components = 0;
+    float* data = stbi_loadf(path.c_str(), &width, &height, &components, 0);
+    if (!data) return std::shared_ptr<HDRImage>();
+    std::shared_ptr<HDRImage> image = std::make_shared<HDRImage>(width, height);
+    image->init();
+    for (UInt32 i = 0; i < (UInt32)width * (UInt32)height; i++) {
+        image->setElement(i * 4, data[i * 3]);
+        image->setElement(i * 4 + 1, data[i * 3 + 1]);
+        image->setElement(i * 4 + 2, data[i * 3 + 2]);
+        image->setElement(i * 4 + 3, 1.0f);
+    }
+    stbi_image_free(data);
+    if (shouldGammaCompress) {
+        Real* imageData = image->getImageData();
+        for (UInt32 i = 0; i < (UInt32)width * (UInt32)height * 4; i++) imageData[i] = Math::pow(imageData[i], 2.22f);
+    }
+    return image;
+}
+
+static Bool isHDR(const std::string& path) {
+    return ImageLoader::getFileExtension(path) == ".hdr";
+}
+
+// Times the previous and current loaders on [path] and prints the decode throughput of both.
+static void benchmarkFile(const std::string& path, UInt32 iterations) {
+    Bool hdr = isHDR(path);
+    UInt32 width = 0, height = 0;
+    if (hdr) {
+        std::shared_ptr<HDRImage> image = ImageLoader::loadImageHDR(path, true, false);
+        width = image->getWidth();
+        height = image->getHeight();
+    }
+    else {
+        std::shared_ptr<StandardImage> image = ImageLoader::loadImageU(path, true, false);
+        width = image->getWidth();
+        height = image->getHeight();
+    }
+
+    std::string name = path.substr(path.find_last_of("/\\") + 1);
+    printf("%s (%ux%u)\n", name.c_str(), width, height);
+    for (UInt32 gamma = 0; gamma < 2; gamma++) {
+        Bool shouldGammaCompress = gamma != 0;
+        std::string suffix = shouldGammaCompress ? " + gamma" : "";
+        Real previousTime = Benchmark::run(("  previous" + suffix).c_str(), iterations, [&]() {
+            if (hdr) Benchmark::sink += loadImageHDRPrevious(path, true, shouldGammaCompress)->getWidth();
+            else Benchmark::sink += loadImageUPrevious(path, true, shouldGammaCompress)->getWidth();
+        });
+        Real currentTime = Benchmark::run(("  ImageLoader" + suffix).c_str(), iterations, [&]() {
+            if (hdr) Benchmark::sink += ImageLoader::loadImageHDR(path, true, shouldGammaCompress)->getWidth();
+            else Benchmark::sink += ImageLoader::loadImageU(path, true, shouldGammaCompress)->getWidth();
+        });
+        Real megapixels = (Real)width * (Real)height / 1000000.0f;
+        printf("  %-46s %8.1f -> %8.1f Mpixel/s\n", "throughput", megapixels / (previousTime / 1e9f), megapixels / (currentTime / 1e9f));
+        Benchmark::printComparison(("  previous vs current" + suffix).c_str(), previousTime, currentTime);
+    }
+}
+
+// Usage: ImageLoaderBenchmark [image...]. Without arguments the PNG, JPEG and HDR images in
+// benchmarks/corpus are used.
+int main(int argc, char** argv) {
+    const UInt32 iterations = 200;
+    std::vector<std::string> paths;
+    for (int i = 1; i < argc; i++) paths.push_back(argv[i]);
+    if (paths.size() == 0) {
+        std::string corpus = CORE_BENCHMARK_CORPUS_DIR;
+        paths.push_back(corpus + "/pattern_256.png");
+        paths.push_back(corpus + "/pattern_256.jpg");
+        paths.push_back(corpus + "/sky_128.hdr");
+    }
+
+    // the first load initializes DevIL, which the previous path relies on
+    for (const std::string& path : paths) benchmarkFile(path, iterations);
+    return 0;
+}
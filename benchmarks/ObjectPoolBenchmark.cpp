@@ -0,0 +1,136 @@
+#include <unordered_map>
+#include <vector>
+
+#include "Benchmark.h"
+#include "../util/ObjectPool.h"
+
+using namespace Core;
+
+// The ObjectPool implementation that the slab pool replaced: free locations in a vector and
+// object-to-location bookkeeping in hash maps. Kept here only as the benchmark baseline.
+template <typename T> class HashMapObjectPool final {
+public:
+    HashMapObjectPool(UInt32 initialCapacity) {
+        this->capacity = 0;
+        this->size = 0;
+        this->increaseCapacity(initialCapacity);
+    }
+
+    ~HashMapObjectPool() {
+        for (UInt32 i = 0; i < this->objects.size(); i++) delete[] this->objects[i];
+    }
+
+    T& acquireObject() {
+        if (this->size >= this->capacity) this->increaseCapacity(this->capacity * 2);
+        UInt32 nextFreeLocation = this->nextFreeLocations.back();
+        StorageDesc storageDesc = this->storageMap[nextFreeLocation];
+        this->nextFreeLocations.pop_back();
+        this->size++;
+        return this->objects[storageDesc.array][storageDesc.index];
+    }
+
+    void returnObject(const T& object) {
+        if (this->objectLocations.find(&object) != this->objectLocations.end()) {
+            this->nextFreeLocations.push_back(this->objectLocations[&object]);
+            this->size--;
+        }
+    }
+
+    // As it was, this also forgets which location every object is at, so objects can't be returned
+    // individually afterwards.
+    void returnAll() {
+        this->objectLocations.clear();
+        this->size = 0;
+        this->nextFreeLocations.clear();
+        for (UInt32 i = 0; i < this->capacity; i++) this->nextFreeLocations.push_back(i);
+    }
+
+private:
+    class StorageDesc {
+    public:
+        UInt32 array;
+        UInt32 index;
+    };
+
+    void increaseCapacity(UInt32 newCapacity) {
+        UInt32 capacityDelta = newCapacity - this->capacity;
+        T* temp = new T[capacityDelta];
+        UInt32 nextArray = (UInt32)this->objects.size();
+        this->objects.push_back(temp);
+        for (UInt32 i = 0; i < capacityDelta; i++) {
+            this->storageMap[i + this->capacity] = {nextArray, i};
+            this->objectLocations[&temp[i]] = i + this->capacity;
+        }
+        for (UInt32 i = this->capacity; i < newCapacity; i++) this->nextFreeLocations.push_back(i);
+        this->capacity = newCapacity;
+    }
+
+    UInt32 size;
+    UInt32 capacity;
+    std::vector<T*> objects;
+    std::unordered_map<UInt32, StorageDesc> storageMap;
+    std::unordered_map<const T*, UInt32> objectLocations;
+    std::vector<UInt32> nextFreeLocations;
+};
+
+class PooledItem {
+public:
+    UInt64 id = 0;
+    Real values[6];
+};
+
+template <typename Pool>
+void acquireAndReturn(Pool& pool, std::vector<PooledItem*>& items, UInt32 count) {
+    items.clear();
+    for (UInt32 i = 0; i < count; i++) {
+        PooledItem& item = pool.acquireObject();
+        item.id = i;
+        items.push_back(&item);
+    }
+    UInt64 sum = 0;
+    for (auto item : items) {
+        sum += item->id;
+        pool.returnObject(*item);
+    }
+    Benchmark::sink += sum;
+}
+
+int main(int argc, char** argv) {
+    const UInt32 itemCount = 4096;
+    const UInt32 iterations = 1000;
+    std::vector<PooledItem*> items;
+    items.reserve(itemCount);
+
+    HashMapObjectPool<PooledItem> hashMapPool(itemCount);
+    HashMapObjectPool<PooledItem> hashMapReturnAllPool(itemCount);
+    ObjectPool<PooledItem> slabPool(itemCount);
+    ObjectPool<PooledItem> lockedSlabPool(itemCount, true);
+
+    Real hashMapTime = Benchmark::run("hash-map pool acquire + return (x4096)", iterations, [&]() {
+        acquireAndReturn(hashMapPool, items, itemCount);
+    });
+
+    Real slabTime = Benchmark::run("slab pool acquire + return (x4096)", iterations, [&]() {
+        acquireAndReturn(slabPool, items, itemCount);
+    });
+
+    Real lockedSlabTime = Benchmark::run("thread-safe slab pool acquire + return (x4096)", iterations, [&]() {
+        acquireAndReturn(lockedSlabPool, items, itemCount);
+    });
+
+    Real hashMapReturnAllTime = Benchmark::run("hash-map pool acquire + returnAll() (x4096)", iterations, [&]() {
+        for (UInt32 i = 0; i < itemCount; i++) hashMapReturnAllPool.acquireObject().id = i;
+        hashMapReturnAllPool.returnAll();
+    });
+
+    Real returnAllTime = Benchmark::run("slab pool acquire + returnAll() (x4096)", iterations, [&]() {
+        for (UInt32 i = 0; i < itemCount; i++) slabPool.acquireObject().id = i;
+        slabPool.returnAll();
+    });
+
+    Benchmark::printComparison("hash-map vs slab pool", hashMapTime, slabTime);
+    Benchmark::printComparison("hash-map vs thread-safe slab pool", hashMapTime, lockedSlabTime);
+    Benchmark::printComparison("hash-map vs slab pool returnAll()", hashMapReturnAllTime, returnAllTime);
+
+    return 0;
+}
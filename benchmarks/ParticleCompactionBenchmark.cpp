@@ -0,0 +1,139 @@
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include "Benchmark.h"
+#include "../Engine.h"
+#include "../math/Math.h"
+#include "../particles/ParticleState.h"
+#include "../particles/util/RandomStream.h"
+
+using namespace Core;
+
+static const UInt32 ParticleCount = 20000;
+
+// Every particle gets a unique id in its rotational speed, and a lifetime that ends this frame for about
+// [deathRate] of them.
+static void buildParticles(ParticleStateAttributeArray& particles, Real deathRate) {
+    RandomStream random(0xC0FFEEull);
+    Real* lifetimes = particles.getLifetimes()->getAttributes();
+    Real* ages = particles.getAges()->getAttributes();
+    Real* ids = particles.getRotationalSpeeds()->getAttributes();
+    for (UInt32 i = 0; i < ParticleCount; i++) {
+        ages[i] = 1.0f;
+        lifetimes[i] = random.nextReal(1.0f, 0.0f) < deathRate ? 0.5f : 2.0f;
+        ids[i] = (Real)i;
+    }
+}
+
+// Snapshot of the attribute arrays that the removal touches, restored before every iteration.
+class ParticleSnapshot {
+public:
+    void save(ParticleStateAttributeArray& particles) {
+        this->lifetimes.assign(particles.getLifetimes()->getAttributes(), particles.getLifetimes()->getAttributes() + ParticleCount);
+        this->ids.assign(particles.getRotationalSpeeds()->getAttributes(), particles.getRotationalSpeeds()->getAttributes() + ParticleCount);
+    }
+
+    void restore(ParticleStateAttributeArray& particles) const {
+        memcpy(particles.getLifetimes()->getAttributes(), this->lifetimes.data(), ParticleCount * sizeof(Real));
+        memcpy(particles.getRotationalSpeeds()->getAttributes(), this->ids.data(), ParticleCount * sizeof(Real));
+    }
+
+    std::vector<Real> lifetimes;
+    std::vector<Real> ids;
+};
+
+// The removal that ParticleStateAttributeArray::removeStates() replaced: each particle is swap-removed with
+// copyState() as soon as it is found dead. Kept here only as the benchmark baseline.
+static UInt32 swapRemove(ParticleStateAttributeArray& particles) {
+    const Real* ages = particles.getAges()->getAttributes();
+    const Real* lifetimes = particles.getLifetimes()->getAttributes();
+    UInt32 activeCount = ParticleCount;
+    UInt32 i = 0;
+    while (i < activeCount) {
+        if (ages[i] >= lifetimes[i]) {
+            if (i < activeCount - 1) particles.copyState(activeCount - 1, i);
+            activeCount--;
+            continue;
+        }
+        i++;
+    }
+    return activeCount;
+}
+
+static UInt32 batchRemove(ParticleStateAttributeArray& particles, std::vector<UInt32>& deadIndices, std::vector<UInt32>& moveSources, Bool parallel) {
+    const Real* ages = particles.getAges()->getAttributes();
+    const Real* lifetimes = particles.getLifetimes()->getAttributes();
+    UInt32 deadCount = 0;
+    for (UInt32 i = 0; i < ParticleCount; i++) {
+        if (ages[i] >= lifetimes[i]) deadIndices[deadCount++] = i;
+    }
+    // as in ParticleSystem, frames without deaths skip the compaction
+    if (deadCount == 0) return ParticleCount;
+    return particles.removeStates(deadIndices.data(), deadCount, ParticleCount, moveSources.data(), parallel);
+}
+
+static std::vector<Real> getSortedIds(ParticleStateAttributeArray& particles, UInt32 activeCount) {
+    const Real* ids = particles.getRotationalSpeeds()->getAttributes();
+    std::vector<Real> sorted(ids, ids + activeCount);
+    std::sort(sorted.begin(), sorted.end());
+    return sorted;
+}
+
+int main(int argc, char** argv) {
+    Engine::setGraphicsBackend(GraphicsBackend::Null);
+    const UInt32 iterations = 500;
+    const Real deathRates[] = {0.0f, 0.01f, 0.1f, 0.5f, 0.9f};
+    ParticleStateAttributeArray particles;
+    particles.setParticleCount(ParticleCount);
+    std::vector<UInt32> deadIndices(ParticleCount);
+    std::vector<UInt32> moveSources(ParticleCount);
+    ParticleSnapshot snapshot;
+    UInt32 mismatches = 0;
+    char name[64];
+
+    for (Real deathRate : deathRates) {
+        buildParticles(particles, deathRate);
+        snapshot.save(particles);
+        UInt32 percent = (UInt32)(deathRate * 100.0f + 0.5f);
+
+        snprintf(name, sizeof(name), "snapshot restore alone, %u%% dying", percent);
+        Real restoreTime = Benchmark::run(name, iterations, [&]() {
+            snapshot.restore(particles);
+            Benchmark::sink += (UInt64)particles.getLifetimes()->getAttributes()[0];
+        });
+
+        UInt32 swapCount = 0;
+        snprintf(name, sizeof(name), "per-particle swap removal, %u%% dying", percent);
+        Real swapTime = Benchmark::run(name, iterations, [&]() {
+            snapshot.restore(particles);
+            swapCount = swapRemove(particles);
+            Benchmark::sink += swapCount;
+        });
+        std::vector<Real> swapIds = getSortedIds(particles, swapCount);
+
+        UInt32 batchCount = 0;
+        snprintf(name, sizeof(name), "batched removal, %u%% dying", percent);
+        Real batchTime = Benchmark::run(name, iterations, [&]() {
+            snapshot.restore(particles);
+            batchCount = batchRemove(particles, deadIndices, moveSources, false);
+            Benchmark::sink += batchCount;
+        });
+        if (batchCount != swapCount || getSortedIds(particles, batchCount) != swapIds) mismatches++;
+
+        snprintf(name, sizeof(name), "parallel batched removal, %u%% dying", percent);
+        Benchmark::run(name, iterations, [&]() {
+            snapshot.restore(particles);
+            batchCount = batchRemove(particles, deadIndices, moveSources, true);
+            Benchmark::sink += batchCount;
+        });
+        if (batchCount != swapCount || getSortedIds(particles, batchCount) != swapIds) mismatches++;
+
+        snprintf(name, sizeof(name), "swap vs batched removal, %u%% dying", percent);
+        Benchmark::printComparison(name, Math::max(swapTime - restoreTime, 1.0f), Math::max(batchTime - restoreTime, 1.0f));
+    }
+
+    // both removals must leave the same particles alive
+    printf("%-48s %14u\n", "surviving particle set mismatches", mismatches);
+    return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,136 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "Benchmark.h"
+#include "../math/Math.h"
+#include "../math/Matrix4x4.h"
+#include "../particles/renderer/ParticleDepthSorter.h"
+#include "../particles/util/RandomStream.h"
+
+using namespace Core;
+
+static const UInt32 ParticleCount = 100000;
+static const UInt32 Stride = 4;
+
+// Back to front ordering by comparison sort of the exact view depths into an index buffer, the obvious
+// alternative to the quantized radix sort. Kept here only as the benchmark baseline.
+static void comparisonSort(const Real* positions, UInt32 count, const Matrix4x4& viewMatrix, std::vector<Real>& depths, std::vector<UInt32>& indices) {
+    const Real* m = viewMatrix.getConstData();
+    depths.resize(count);
+    indices.resize(count);
+    for (UInt32 i = 0; i < count; i++) {
+        const Real* p = positions + i * Stride;
+        depths[i] = m[2] * p[0] + m[6] * p[1] + m[10] * p[2] + m[14];
+        indices[i] = i;
+    }
+    const Real* depthData = depths.data();
+    std::sort(indices.begin(), indices.end(), [depthData](UInt32 a, UInt32 b) {
+        return depthData[a] < depthData[b];
+    });
+}
+
+// A cloud of particles spread over a 100 unit box in front of the camera.
+static void buildParticles(std::vector<Real>& positions) {
+    const Real range[] = {100.0f, 100.0f, 100.0f};
+    const Real offset[] = {-50.0f, -50.0f, -150.0f};
+    positions.resize(ParticleCount * Stride);
+    RandomStream random(0x5EEDull);
+    random.fillBox(positions.data(), ParticleCount, Stride, range, offset);
+}
+
+// Move every particle up to [distance] along Z, as one frame of simulation does.
+static void moveParticles(std::vector<Real>& positions, Real distance, RandomStream& random) {
+    for (UInt32 i = 0; i < ParticleCount; i++) positions[i * Stride + 2] += random.nextReal(distance * 2.0f, -distance);
+}
+
+static Real getDepth(const Real* positions, UInt32 index, const Matrix4x4& viewMatrix) {
+    const Real* m = viewMatrix.getConstData();
+    const Real* p = positions + index * Stride;
+    return m[2] * p[0] + m[6] * p[1] + m[10] * p[2] + m[14];
+}
+
+// Returns the number of places where [order] is not back to front by more than one key step, and checks that it
+// holds every particle exactly once.
+static UInt32 countOrderErrors(const std::vector<Real>& positions, const UInt32* order, const Matrix4x4& viewMatrix) {
+    std::vector<Bool> seen(ParticleCount, false);
+    Real minDepth = getDepth(positions.data(), 0, viewMatrix), maxDepth = minDepth;
+    for (UInt32 i = 0; i < ParticleCount; i++) {
+        Real depth = getDepth(positions.data(), i, viewMatrix);
+        minDepth = std::min(minDepth, depth);
+        maxDepth = std::max(maxDepth, depth);
+    }
+    Real keyStep = (maxDepth - minDepth) / 65535.0f;
+
+    UInt32 errors = 0;
+    for (UInt32 i = 0; i < ParticleCount; i++) {
+        if (order[i] >= ParticleCount || seen[order[i]]) {
+            errors++;
+            continue;
+        }
+        seen[order[i]] = true;
+        if (i > 0 && getDepth(positions.data(), order[i - 1], viewMatrix) > getDepth(positions.data(), order[i], viewMatrix) + keyStep) errors++;
+    }
+    return errors;
+}
+
+int main(int argc, char** argv) {
+    const UInt32 iterations = 50;
+    std::vector<Real> positions;
+    buildParticles(positions);
+    Matrix4x4 viewMatrix;
+    viewMatrix.setIdentity();
+    viewMatrix.makeRotation(0.0f, 1.0f, 0.0f, 0.3f);
+    viewMatrix.preTranslate(2.0f, -1.0f, -5.0f);
+
+    std::vector<Real> depths;
+    std::vector<UInt32> indices;
+    Real comparisonTime = Benchmark::run("comparison sort, 100k particles", iterations, [&]() {
+        comparisonSort(positions.data(), ParticleCount, viewMatrix, depths, indices);
+        Benchmark::sink += indices[0];
+    });
+
+    ParticleDepthSorter sorter;
+    const UInt32* order = nullptr;
+    Real radixTime = Benchmark::run("radix sort, 100k particles", iterations, [&]() {
+        order = sorter.sort(positions.data(), Stride, ParticleCount, viewMatrix);
+        Benchmark::sink += order[0];
+    });
+    UInt32 radixErrors = countOrderErrors(positions, order, viewMatrix);
+
+    // the incremental repair is measured on particles that settle (moving less than a key step, 0.0015 units, per
+    // frame) and on particles that drift (moving several key steps per frame, which makes it fall back to full sorts)
+    const Real distances[] = {0.0002f, 0.01f};
+    const char* names[] = {"settling", "drifting"};
+    UInt32 incrementalErrors = 0;
+    char name[64];
+    sorter.setIncremental(true);
+    RandomStream random(0xD21F7ull);
+    for (UInt32 d = 0; d < 2; d++) {
+        UInt32 incrementalSorts = 0;
+        snprintf(name, sizeof(name), "incremental radix sort, 100k %s particles", names[d]);
+        Real incrementalTime = Benchmark::run(name, iterations, [&]() {
+            moveParticles(positions, distances[d], random);
+            order = sorter.sort(positions.data(), Stride, ParticleCount, viewMatrix);
+            if (sorter.getLastSortWasIncremental()) incrementalSorts++;
+            Benchmark::sink += order[0];
+        });
+        incrementalErrors += countOrderErrors(positions, order, viewMatrix);
+
+        Real moveTime = Benchmark::run("particle movement alone", iterations, [&]() {
+            moveParticles(positions, distances[d], random);
+            Benchmark::sink += (UInt64)positions[2];
+        });
+
+        snprintf(name, sizeof(name), "comparison vs incremental sort, %s", names[d]);
+        Benchmark::printComparison(name, comparisonTime, Math::max(incrementalTime - moveTime, 1.0f));
+        snprintf(name, sizeof(name), "incremental sorts, %s", names[d]);
+        printf("%-48s %14u / %u\n", name, incrementalSorts, iterations + 1);
+    }
+
+    Benchmark::printComparison("comparison vs radix sort", comparisonTime, radixTime);
+    printf("%-48s %14u\n", "radix sort order errors", radixErrors);
+    printf("%-48s %14u\n", "incremental sort order errors", incrementalErrors);
+    return radixErrors == 0 && incrementalErrors == 0 ? 0 : 1;
+}
@@ -0,0 +1,75 @@
+#include <cmath>
+#include <unordered_map>
+#include <vector>
+
+#include "Benchmark.h"
+#include "../geometry/Mesh.h"
+#include "../geometry/Vector3.h"
+
+using namespace Core;
+
+// The vertex cross map that the cell grid grouping replaced: one heap-allocated member list per position,
+// found through a hash map keyed with Vector3Base::Eq. Kept here only as the benchmark baseline.
+static UInt32 hashMapGroupEqualPositions(const std::vector<Point3r>& positions) {
+    std::unordered_map<Point3r, std::vector<UInt32>*, Vector3Base<Real>::Hasher, Vector3Base<Real>::Eq> vertexGroups;
+    std::vector<std::vector<UInt32>*> vertexCrossMap(positions.size());
+    for (UInt32 v = 0; v < positions.size(); v++) {
+        std::vector<UInt32>*& list = vertexGroups[positions[v]];
+        if (list == nullptr) list = new std::vector<UInt32>();
+        list->push_back(v);
+        vertexCrossMap[v] = list;
+    }
+    UInt32 groupCount = (UInt32)vertexGroups.size();
+    for (auto& group : vertexGroups) delete group.second;
+    return groupCount;
+}
+
+// An unindexed triangle soup over a bumpy [size] x [size] grid, so each interior position is shared by six vertices.
+static void buildTriangleSoup(UInt32 size, std::vector<Point3r>& positions) {
+    auto gridPoint = [size](UInt32 x, UInt32 y) -> Point3r {
+        Real fx = (Real)x / (Real)size * 10.0f;
+        Real fy = (Real)y / (Real)size * 10.0f;
+        return Point3r(fx, std::sin(fx * 3.0f) * std::cos(fy * 2.0f), fy);
+    };
+    positions.clear();
+    for (UInt32 y = 0; y < size; y++) {
+        for (UInt32 x = 0; x < size; x++) {
+            positions.push_back(gridPoint(x, y));
+            positions.push_back(gridPoint(x + 1, y));
+            positions.push_back(gridPoint(x, y + 1));
+            positions.push_back(gridPoint(x + 1, y));
+            positions.push_back(gridPoint(x + 1, y + 1));
+            positions.push_back(gridPoint(x, y + 1));
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    const UInt32 sizes[] = {32, 128, 512};
+    const UInt32 iterations[] = {200, 20, 3};
+    std::vector<Point3r> positions;
+    std::vector<UInt32> groupStarts;
+    std::vector<UInt32> groupMembers;
+    char name[64];
+
+    for (UInt32 s = 0; s < 3; s++) {
+        buildTriangleSoup(sizes[s], positions);
+        UInt32 vertexCount = (UInt32)positions.size();
+
+        snprintf(name, sizeof(name), "hash-map cross map (%u vertices)", vertexCount);
+        Real hashMapTime = Benchmark::run(name, iterations[s], [&]() {
+            Benchmark::sink += hashMapGroupEqualPositions(positions);
+        });
+
+        snprintf(name, sizeof(name), "cell grid cross map (%u vertices)", vertexCount);
+        Real cellGridTime = Benchmark::run(name, iterations[s], [&]() {
+            Mesh::groupEqualPositions(positions.data(), vertexCount, groupStarts, groupMembers);
+            Benchmark::sink += groupStarts.size();
+        });
+
+        snprintf(name, sizeof(name), "hash-map vs cell grid (%u vertices)", vertexCount);
+        Benchmark::printComparison(name, hashMapTime, cellGridTime);
+    }
+
+    return 0;
+}
@@ -0,0 +1,99 @@
+#include <memory>
+#include <vector>
+
+#include "Benchmark.h"
+#include "../base/CoreObject.h"
+#include "../util/WeakPointer.h"
+
+using namespace Core;
+
+class BenchmarkObject : public CoreObject {
+public:
+    UInt32 value = 1;
+};
+
+// WeakPointer as it was before handles: the same members, the owner_before() validity check, and
+// a dereference that resolves the raw pointer lazily. Kept as the baseline for both benchmarks.
+template <typename T>
+class PreviousWeakPointer : public std::weak_ptr<T> {
+public:
+    PreviousWeakPointer(const std::shared_ptr<T>& ptr) : std::weak_ptr<T>(ptr), _ptr(nullptr), _cacheShared(true), _cachedSharedSet(false) {
+    }
+
+    T* operator ->() {
+        if (!this->_ptr) {
+            std::shared_ptr<T> temp = this->lock();
+            if (!temp) throw WeakPointerAssertionFailure("Tried to use null weak pointer (1st try).");
+            this->_ptr = temp.get();
+        }
+        if (!this->_ptr) throw WeakPointerAssertionFailure("Tried to use null weak pointer (2nd try).");
+        if (!this->isValid()) throw WeakPointerAssertionFailure("Tried to use invalid weak pointer.");
+        return this->_ptr;
+    }
+
+    Bool isValid() const {
+        using wt = std::weak_ptr<T>;
+        return this->owner_before(wt{}) || wt{}.owner_before(*this);
+    }
+
+private:
+    mutable T * _ptr;
+    Bool _cacheShared;
+    mutable Bool _cachedSharedSet;
+    mutable std::shared_ptr<T> _cachedShared;
+};
+
+int main(int argc, char** argv) {
+    const UInt32 objectCount = 1024;
+    const UInt32 iterations = 20000;
+
+    std::vector<std::shared_ptr<BenchmarkObject>> objects;
+    std::vector<PreviousWeakPointer<BenchmarkObject>> previousPointers;
+    std::vector<WeakPointer<BenchmarkObject>> weakPointers;
+    for (UInt32 i = 0; i < objectCount; i++) {
+        objects.push_back(std::make_shared<BenchmarkObject>());
+        previousPointers.push_back(PreviousWeakPointer<BenchmarkObject>(objects.back()));
+        weakPointers.push_back(WeakPointer<BenchmarkObject>(objects.back()));
+    }
+#ifdef __CORE_WEAK_POINTER_USE_HANDLES
+    printf("Handles enabled, %u bytes per WeakPointer (previously %u)\n", (UInt32)sizeof(WeakPointer<BenchmarkObject>), (UInt32)sizeof(PreviousWeakPointer<BenchmarkObject>));
+#else
+    printf("Handles disabled, %u bytes per WeakPointer (previously %u)\n", (UInt32)sizeof(WeakPointer<BenchmarkObject>), (UInt32)sizeof(PreviousWeakPointer<BenchmarkObject>));
+#endif
+
+    Real previousIsValidTime = Benchmark::run("previous isValid() (x1024)", iterations, [&]() {
+        UInt64 count = 0;
+        for (auto& ptr : previousPointers) count += ptr.isValid() ? 1 : 0;
+        Benchmark::sink += count;
+    });
+
+    Real isValidTime = Benchmark::run("WeakPointer::isValid() (x1024)", iterations, [&]() {
+        UInt64 count = 0;
+        for (auto& ptr : weakPointers) count += ptr.isValid() ? 1 : 0;
+        Benchmark::sink += count;
+    });
+
+    Real previousDereferenceTime = Benchmark::run("previous dereference (x1024)", iterations, [&]() {
+        UInt64 sum = 0;
+        for (auto& ptr : previousPointers) sum += ptr->value;
+        Benchmark::sink += sum;
+    });
+
+    Real dereferenceTime = Benchmark::run("WeakPointer dereference (x1024)", iterations, [&]() {
+        UInt64 sum = 0;
+        for (auto& ptr : weakPointers) sum += ptr->value;
+        Benchmark::sink += sum;
+    });
+
+    Benchmark::run("CoreObject construct + destroy (x1024)", iterations, [&]() {
+        for (UInt32 i = 0; i < objectCount; i++) {
+            BenchmarkObject object;
+            Benchmark::sink += object.value;
+        }
+    });
+
+    Benchmark::printComparison("previous vs current isValid()", previousIsValidTime, isValidTime);
+    Benchmark::printComparison("previous vs current dereference", previousDereferenceTime, dereferenceTime);
+
+    return 0;
+}
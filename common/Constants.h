@@ -13,7 +13,6 @@ namespace Core {
         static const UInt32 MaxIBLLODLevels = 6;
         static const UInt32 DefaultMaxMipLevels = 4;
         static const UInt32 MaxBonesPerVertex = 4;
-        static const UInt32 MaxBones = 128;
         static const UInt32 SSAOSamples = 64;
         static const UInt32 MaxAtlasFrameSets = 16;
         #ifdef CORE_USE_PRIVATE_INCLUDES
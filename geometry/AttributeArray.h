@@ -2,6 +2,8 @@
 
 #include <string.h>
 #include <new>
+#include <vector>
+#include <type_traits>
 
 #include "../Engine.h"
 #include "../util/WeakPointer.h"
@@ -11,6 +13,7 @@
 #include "../Graphics.h"
 #include "../geometry/AttributeType.h"
 #include "AttributeArrayGPUStorage.h"
+#include "AttributeFormat.h"
 
 namespace Core {
 
@@ -49,6 +52,7 @@ namespace Core {
             this->gpuAttributeType = AttributeType::Float;
             this->normalizeGPUData = false;
             this->autoAllocateGPUSorage = false;
+            this->gpuFormat = AttributeFormat::Native;
             allocate();
         }
 
@@ -56,6 +60,7 @@ namespace Core {
             this->gpuAttributeType = gpuAttributeType;
             this->normalizeGPUData = normalizeGPUData;
             this->autoAllocateGPUSorage = true;
+            this->gpuFormat = AttributeFormat::Native;
             allocate();
         }
 
@@ -95,6 +100,17 @@ namespace Core {
             this->attributes[destIndex] = this->attributes[srcIndex];
         }
 
+        // Copy attribute srcIndices[i] to destIndices[i] for each i in [first, last), directly between the component
+        // storage. Unlike copyAttribute() the indices are not range checked.
+        void copyAttributes(const UInt32* srcIndices, const UInt32* destIndices, UInt32 first, UInt32 last) {
+            typename T::ComponentType* storage = this->storage;
+            for (UInt32 i = first; i < last; i++) {
+                typename T::ComponentType* dest = storage + destIndices[i] * T::ComponentCount;
+                const typename T::ComponentType* src = storage + srcIndices[i] * T::ComponentCount;
+                for (UInt32 c = 0; c < T::ComponentCount; c++) dest[c] = src[c];
+            }
+        }
+
         void store(const typename T::ComponentType* data) {
             memcpy(this->storage, data, this->getSize());
             this->updateGPUStorageData();
@@ -108,8 +124,57 @@ namespace Core {
 
         void updateGPUStorageData() {
             if (this->gpuStorage) {
-                this->gpuStorage->updateBufferData((void *)this->storage);
+                if (this->gpuFormat == AttributeFormat::Native) {
+                    this->gpuStorage->updateBufferData((void *)this->storage);
+                }
+                else {
+                    std::vector<Byte> packed(this->getGPUSize());
+                    AttributeFormats::pack(this->gpuFormat, this->storage, T::ComponentCount, this->attributeCount, packed.data());
+                    this->gpuStorage->updateBufferData((void *)packed.data());
+                }
+            }
+        }
+
+        // Pack the GPU copy of this array in [format]; the CPU copy is not affected. GPU storage owned by the
+        // array is re-created in the new layout.
+        void setGPUFormat(AttributeFormat format) {
+            if (!AttributeFormats::isSupported(format, T::ComponentCount, std::is_floating_point<typename T::ComponentType>::value)) {
+                throw InvalidArgumentException("AttributeArray::setGPUFormat() -> Format is not supported for this attribute type.");
             }
+            if (format == this->gpuFormat) return;
+            this->gpuFormat = format;
+            if (this->autoAllocateGPUSorage || this->gpuStorage.isValid()) this->allocateGPUStorage();
+        }
+
+        AttributeFormat getGPUFormat() const {
+            return this->gpuFormat;
+        }
+
+        AttributeType getGPUAttributeType() const {
+            return AttributeFormats::getAttributeType(this->gpuFormat, this->gpuAttributeType);
+        }
+
+        UInt32 getGPUComponentCount() const {
+            return AttributeFormats::getComponentCount(this->gpuFormat, T::ComponentCount);
+        }
+
+        Bool shouldNormalizeGPUData() const {
+            return AttributeFormats::isNormalized(this->gpuFormat, this->normalizeGPUData);
+        }
+
+        // size in bytes of one attribute in the GPU copy
+        UInt32 getGPUAttributeSize() const {
+            return AttributeFormats::getAttributeSize(this->gpuFormat, T::ComponentCount, sizeof(typename T::ComponentType));
+        }
+
+        UInt32 getGPUSize() const {
+            return this->attributeCount * this->getGPUAttributeSize();
+        }
+
+        void allocateGPUStorage() {
+            WeakPointer<AttributeArrayGPUStorage> gpuStorage =
+            Engine::instance()->createGPUStorage(this->getGPUSize(), this->getGPUComponentCount(), this->getGPUAttributeType(), this->shouldNormalizeGPUData());
+            this->setGPUStorage(gpuStorage);
         }
 
         class iterator {
@@ -164,6 +229,7 @@ namespace Core {
         AttributeType gpuAttributeType;
         Bool normalizeGPUData;
         Bool autoAllocateGPUSorage;
+        AttributeFormat gpuFormat;
         typename T::ComponentType* storage;
         T* attributes;
 
@@ -188,12 +254,6 @@ namespace Core {
             if (this->autoAllocateGPUSorage) this->allocateGPUStorage();
         }
 
-        void allocateGPUStorage() {
-            WeakPointer<AttributeArrayGPUStorage> gpuStorage =
-            Engine::instance()->createGPUStorage(this->getSize(), T::ComponentCount, this->gpuAttributeType, this->normalizeGPUData);
-            this->setGPUStorage(gpuStorage);
-        }
-
         void deallocate() {
             if (this->attributes != nullptr) {
                 for (UInt32 i = 0; i < this->attributeCount; i++) {
@@ -203,7 +263,7 @@ namespace Core {
                 this->attributes = nullptr;
             }
             if (this->storage != nullptr) {
-                delete this->storage;
+                delete[] this->storage;
                 this->storage = nullptr;
             }
             this->deallocateGPUStorage();
@@ -266,6 +326,12 @@ namespace Core {
             this->attributes[destIndex] = this->attributes[srcIndex];
         }
 
+        // See AttributeArray::copyAttributes().
+        void copyAttributes(const UInt32* srcIndices, const UInt32* destIndices, UInt32 first, UInt32 last) {
+            T* attributes = this->attributes;
+            for (UInt32 i = first; i < last; i++) attributes[destIndices[i]] = attributes[srcIndices[i]];
+        }
+
         void store(const T* data) {
             memcpy(this->attributes, data, this->getSize());
             this->updateGPUStorageData();
@@ -350,7 +416,7 @@ namespace Core {
 
         void deallocate() {
             if (this->attributes != nullptr) {
-                delete this->attributes;
+                delete[] this->attributes;
                 this->attributes = nullptr;
             }
             this->deallocateGPUStorage();
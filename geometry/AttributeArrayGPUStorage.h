@@ -2,6 +2,7 @@
 
 #include "../common/types.h"
 #include "../base/CoreObject.h"
+#include "AttributeType.h"
 
 namespace Core {
 
@@ -11,7 +12,14 @@ namespace Core {
         virtual ~AttributeArrayGPUStorage() = 0;
         virtual Int32 getBufferID() const = 0;
         virtual void enableAndSendToActiveShader(UInt32 location) = 0;
+        // make this the buffer that enableAndSendElementToActiveShader() reads from
+        virtual void bind() = 0;
+        // send one element of the bound interleaved buffer: [componentCount] values of [type] at [offset] bytes into each [stride] byte vertex
+        virtual void enableAndSendElementToActiveShader(UInt32 location, UInt32 componentCount, AttributeType type,
+                                                        Bool normalize, UInt32 stride, UInt32 offset) = 0;
         virtual void disable(UInt32 location) = 0;
+        // advance the attribute at [location] once every [divisor] instances instead of once per vertex (0 restores per vertex)
+        virtual void setDivisor(UInt32 location, UInt32 divisor) = 0;
         virtual void updateBufferData(void * data) = 0;
     };
 }
@@ -0,0 +1,236 @@
+#include <string.h>
+#include <cmath>
+
+#include "AttributeFormat.h"
+#include "../common/Exception.h"
+
+namespace Core {
+
+    Bool AttributeFormats::isSupported(AttributeFormat format, UInt32 componentCount, Bool floatComponents) {
+        switch (format) {
+            case AttributeFormat::Native:
+                return true;
+            case AttributeFormat::HalfFloat:
+                return floatComponents && componentCount % 2 == 0;
+            case AttributeFormat::UNorm8:
+            case AttributeFormat::UNorm8Weights:
+                return floatComponents && componentCount % 4 == 0;
+            case AttributeFormat::SNorm10_10_10_2:
+                return floatComponents && (componentCount == 3 || componentCount == 4);
+            case AttributeFormat::UInt8:
+                return !floatComponents && componentCount % 4 == 0;
+            case AttributeFormat::UInt16:
+                return !floatComponents && componentCount % 2 == 0;
+        }
+        return false;
+    }
+
+    AttributeType AttributeFormats::getAttributeType(AttributeFormat format, AttributeType nativeType) {
+        switch (format) {
+            case AttributeFormat::HalfFloat:
+                return AttributeType::HalfFloat;
+            case AttributeFormat::UNorm8:
+            case AttributeFormat::UNorm8Weights:
+            case AttributeFormat::UInt8:
+                return AttributeType::UnsignedByte;
+            case AttributeFormat::SNorm10_10_10_2:
+                return AttributeType::Int2_10_10_10;
+            case AttributeFormat::UInt16:
+                return AttributeType::UnsignedShort;
+            default:
+                break;
+        }
+        return nativeType;
+    }
+
+    UInt32 AttributeFormats::getComponentCount(AttributeFormat format, UInt32 componentCount) {
+        return format == AttributeFormat::SNorm10_10_10_2 ? 4 : componentCount;
+    }
+
+    Bool AttributeFormats::isNormalized(AttributeFormat format, Bool nativeNormalize) {
+        switch (format) {
+            case AttributeFormat::Native:
+                return nativeNormalize;
+            case AttributeFormat::UNorm8:
+            case AttributeFormat::UNorm8Weights:
+            case AttributeFormat::SNorm10_10_10_2:
+                return true;
+            default:
+                break;
+        }
+        return false;
+    }
+
+    UInt32 AttributeFormats::getAttributeSize(AttributeFormat format, UInt32 componentCount, UInt32 nativeComponentSize) {
+        switch (format) {
+            case AttributeFormat::HalfFloat:
+            case AttributeFormat::UInt16:
+                return componentCount * 2;
+            case AttributeFormat::UNorm8:
+            case AttributeFormat::UNorm8Weights:
+            case AttributeFormat::UInt8:
+                return componentCount;
+            case AttributeFormat::SNorm10_10_10_2:
+                return 4;
+            default:
+                break;
+        }
+        return componentCount * nativeComponentSize;
+    }
+
+    static UInt32 quantizeUNorm(Real value, UInt32 maxValue) {
+        if (!(value > 0.0f)) return 0;
+        if (value >= 1.0f) return maxValue;
+        return (UInt32)(value * (Real)maxValue + 0.5f);
+    }
+
+    static UInt32 quantizeSNorm10(Real value) {
+        if (!(value > -1.0f)) value = -1.0f;
+        if (value > 1.0f) value = 1.0f;
+        Int32 quantized = (Int32)std::floor(value * 511.0f + 0.5f);
+        return (UInt32)quantized & 0x3FF;
+    }
+
+    void AttributeFormats::pack(AttributeFormat format, const Real* source, UInt32 componentCount, UInt32 attributeCount, Byte* destination) {
+        if (!isSupported(format, componentCount, true)) {
+            throw InvalidArgumentException("AttributeFormats::pack() -> Format is not supported for this attribute.");
+        }
+
+        if (format == AttributeFormat::Native) {
+            memcpy(destination, source, attributeCount * componentCount * sizeof(Real));
+        }
+        else if (format == AttributeFormat::HalfFloat) {
+            UInt16* dest = reinterpret_cast<UInt16*>(destination);
+            for (UInt32 i = 0; i < attributeCount * componentCount; i++) dest[i] = floatToHalf(source[i]);
+        }
+        else if (format == AttributeFormat::UNorm8) {
+            for (UInt32 i = 0; i < attributeCount * componentCount; i++) destination[i] = (Byte)quantizeUNorm(source[i], 255);
+        }
+        else if (format == AttributeFormat::UNorm8Weights) {
+            for (UInt32 a = 0; a < attributeCount; a++) {
+                const Real* weights = source + a * componentCount;
+                Byte* dest = destination + a * componentCount;
+                Int32 sum = 0;
+                UInt32 largest = 0;
+                for (UInt32 c = 0; c < componentCount; c++) {
+                    dest[c] = (Byte)quantizeUNorm(weights[c], 255);
+                    sum += dest[c];
+                    if (dest[c] > dest[largest]) largest = c;
+                }
+                // rounding each weight separately can leave the sum a few steps off, which would scale the
+                // skinned vertex; the largest weight absorbs the difference
+                if (sum > 0) {
+                    Int32 adjusted = (Int32)dest[largest] + 255 - sum;
+                    dest[largest] = (Byte)(adjusted < 0 ? 0 : (adjusted > 255 ? 255 : adjusted));
+                }
+            }
+        }
+        else if (format == AttributeFormat::SNorm10_10_10_2) {
+            UInt32* dest = reinterpret_cast<UInt32*>(destination);
+            for (UInt32 a = 0; a < attributeCount; a++) {
+                const Real* vector = source + a * componentCount;
+                // a three component vector gets w = 1, the value GL supplies for a missing fourth component,
+                // so shaders see the same vector as for float data
+                Int32 w = componentCount == 4 ? (vector[3] > 0.5f ? 1 : (vector[3] < -0.5f ? -1 : 0)) : 1;
+                dest[a] = quantizeSNorm10(vector[0]) | (quantizeSNorm10(vector[1]) << 10) | (quantizeSNorm10(vector[2]) << 20) |
+                          (((UInt32)w & 0x3) << 30);
+            }
+        }
+    }
+
+    void AttributeFormats::pack(AttributeFormat format, const Int32* source, UInt32 componentCount, UInt32 attributeCount, Byte* destination) {
+        if (!isSupported(format, componentCount, false)) {
+            throw InvalidArgumentException("AttributeFormats::pack() -> Format is not supported for this attribute.");
+        }
+
+        if (format == AttributeFormat::Native) {
+            memcpy(destination, source, attributeCount * componentCount * sizeof(Int32));
+        }
+        else if (format == AttributeFormat::UInt8) {
+            for (UInt32 i = 0; i < attributeCount * componentCount; i++) {
+                Int32 value = source[i];
+                destination[i] = (Byte)(value < 0 ? 0 : (value > 0xFF ? 0xFF : value));
+            }
+        }
+        else if (format == AttributeFormat::UInt16) {
+            UInt16* dest = reinterpret_cast<UInt16*>(destination);
+            for (UInt32 i = 0; i < attributeCount * componentCount; i++) {
+                Int32 value = source[i];
+                dest[i] = (UInt16)(value < 0 ? 0 : (value > 0xFFFF ? 0xFFFF : value));
+            }
+        }
+    }
+
+    /*
+     * Convert [value] to an IEEE 754 half precision float, rounding to nearest even. Values too large for a half
+     * become infinity, values too small become (signed) zero or a denormal.
+     */
+    UInt16 AttributeFormats::floatToHalf(Real value) {
+        float single = (float)value;
+        UInt32 bits;
+        memcpy(&bits, &single, sizeof(UInt32));
+
+        UInt32 sign = (bits >> 16) & 0x8000;
+        Int32 exponent = (Int32)((bits >> 23) & 0xFF);
+        UInt32 mantissa = bits & 0x7FFFFF;
+
+        // infinity and NaN; NaN keeps a non-zero mantissa
+        if (exponent == 0xFF) {
+            return (UInt16)(sign | 0x7C00 | (mantissa ? 0x200 | (mantissa >> 13) : 0));
+        }
+
+        Int32 halfExponent = exponent - 127 + 15;
+        if (halfExponent >= 0x1F) {
+            return (UInt16)(sign | 0x7C00);
+        }
+        if (halfExponent <= 0) {
+            // denormal (or zero): shift the mantissa, including its implicit leading bit, into place
+            if (halfExponent < -10) return (UInt16)sign;
+            mantissa |= 0x800000;
+            UInt32 shift = (UInt32)(14 - halfExponent);
+            UInt32 half = mantissa >> shift;
+            UInt32 remainder = mantissa & ((1u << shift) - 1);
+            UInt32 halfway = 1u << (shift - 1);
+            if (remainder > halfway || (remainder == halfway && (half & 1))) half++;
+            return (UInt16)(sign | half);
+        }
+
+        UInt32 half = ((UInt32)halfExponent << 10) | (mantissa >> 13);
+        UInt32 remainder = mantissa & 0x1FFF;
+        // a carry out of the mantissa correctly bumps the exponent, up to infinity
+        if (remainder > 0x1000 || (remainder == 0x1000 && (half & 1))) half++;
+        return (UInt16)(sign | half);
+    }
+
+    Real AttributeFormats::halfToFloat(UInt16 value) {
+        UInt32 sign = ((UInt32)value & 0x8000) << 16;
+        UInt32 exponent = ((UInt32)value >> 10) & 0x1F;
+        UInt32 mantissa = (UInt32)value & 0x3FF;
+
+        UInt32 bits;
+        if (exponent == 0x1F) {
+            bits = sign | 0x7F800000 | (mantissa << 13);
+        }
+        else if (exponent == 0) {
+            if (mantissa == 0) {
+                bits = sign;
+            }
+            else {
+                // normalize the denormal
+                Int32 e = -1;
+                do {
+                    e++;
+                    mantissa <<= 1;
+                } while ((mantissa & 0x400) == 0);
+                bits = sign | ((UInt32)(127 - 15 - e) << 23) | ((mantissa & 0x3FF) << 13);
+            }
+        }
+        else {
+            bits = sign | ((exponent - 15 + 127) << 23) | (mantissa << 13);
+        }
+
+        float single;
+        memcpy(&single, &bits, sizeof(float));
+        return (Real)single;
+    }
+}
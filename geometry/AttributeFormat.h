@@ -0,0 +1,49 @@
+#pragma once
+
+#include "../common/types.h"
+#include "AttributeType.h"
+
+namespace Core {
+
+    // Layout in which an attribute array is uploaded to the GPU. Only the GPU copy is packed: the CPU copy keeps
+    // the attribute's own type, so code that reads or edits attributes is unaffected by the choice of format.
+    enum class AttributeFormat {
+        // the attribute's own component type, unchanged
+        Native = 0,
+        // 16-bit floats, e.g. for texture coordinates
+        HalfFloat = 1,
+        // 8-bit unsigned normalized, for values in [0, 1] such as colors
+        UNorm8 = 2,
+        // like UNorm8, but the components of each attribute are adjusted to add up to exactly 1, for bone weights
+        UNorm8Weights = 3,
+        // signed normalized 10:10:10:2, for unit vectors such as normals and tangents
+        SNorm10_10_10_2 = 4,
+        // 8-bit and 16-bit unsigned integers, e.g. for bone indices
+        UInt8 = 5,
+        UInt16 = 6
+    };
+
+    class AttributeFormats {
+    public:
+        // Can [componentCount] components of a float ([floatComponents] = true) or integer type be packed in [format]?
+        // Packed attributes must occupy a multiple of four bytes so they stay aligned in vertex buffers.
+        static Bool isSupported(AttributeFormat format, UInt32 componentCount, Bool floatComponents);
+
+        // GPU layout of an attribute with [componentCount] components of [nativeType] that is packed in [format]
+        static AttributeType getAttributeType(AttributeFormat format, AttributeType nativeType);
+        static UInt32 getComponentCount(AttributeFormat format, UInt32 componentCount);
+        static Bool isNormalized(AttributeFormat format, Bool nativeNormalize);
+        static UInt32 getAttributeSize(AttributeFormat format, UInt32 componentCount, UInt32 nativeComponentSize);
+
+        // Pack [attributeCount] attributes of [componentCount] components each from [source] into [destination],
+        // which must hold getAttributeSize() bytes per attribute. Values outside the range of [format] are clamped.
+        static void pack(AttributeFormat format, const Real* source, UInt32 componentCount, UInt32 attributeCount, Byte* destination);
+        static void pack(AttributeFormat format, const Int32* source, UInt32 componentCount, UInt32 attributeCount, Byte* destination);
+
+        static UInt16 floatToHalf(Real value);
+        static Real halfToFloat(UInt16 value);
+
+    private:
+        AttributeFormats();
+    };
+}
@@ -5,7 +5,12 @@ namespace Core {
     enum class AttributeType {
         UnsignedInt = 0,
         Int = 1,
-        Float = 2
+        Float = 2,
+        UnsignedByte = 3,
+        UnsignedShort = 4,
+        HalfFloat = 5,
+        // signed 10:10:10:2 packed into 32 bits, always four components
+        Int2_10_10_10 = 6
     };
 
-}
\ No newline at end of file
+}
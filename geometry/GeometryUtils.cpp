@@ -2,8 +2,10 @@
 
 #include "GeometryUtils.h"
 #include "../Engine.h"
+#include "../animation/VertexBoneMap.h"
 #include "../geometry/IndexBuffer.h"
 #include "../geometry/Mesh.h"
+#include "../geometry/MeshOptimizer.h"
 #include "../math/Math.h"
 #include "../material/StandardAttributes.h"
 #include "../render/MeshRenderer.h"
@@ -97,7 +99,7 @@ namespace Core {
 
         gridPlane->getIndexBuffer()->setIndices(indices.data());
 
-        return gridPlane;
+        return optimizeMesh(gridPlane);
     }
     
     WeakPointer<Mesh> GeometryUtils::buildBoxMesh(Real length, Real height, Real depth, Color color) {
@@ -200,7 +202,7 @@ namespace Core {
 
         boxMesh->calculateBoundingBox();
 
-        return boxMesh;
+        return optimizeMesh(boxMesh);
     }
 
     WeakPointer<Mesh> GeometryUtils::buildArrowMesh(Real baseLength, Real baseRadius,
@@ -369,17 +371,15 @@ namespace Core {
         arrowMesh->calculateBoundingBox();
         arrowMesh->calculateNormals(75.0f * Core::Math::DegreesToRads);
 
-        return arrowMesh;
+        return optimizeMesh(arrowMesh);
     }
 
-    WeakPointer<Mesh> GeometryUtils::buildSphereMesh(Real radius, UInt32 subdivisions, Color color) {
+    // unindexed sphere triangles, four components per vertex; usable without a graphics context
+    void GeometryUtils::buildSpherePositions(Real radius, UInt32 subdivisions, std::vector<Real>& positions) {
+        positions.clear();
         UInt32 hSubdivisions = subdivisions;
         UInt32 vSubdivisions = subdivisions / 4;
 
-        std::vector<Real> positions;
-        std::vector<Real> normals;
-        std::vector<Real> colors;
-
         Real halfPI = Math::PI / 2.0f;
         Real deltaTheta = Math::TwoPI / (Real)hSubdivisions;
         Real deltaPhi = halfPI / (Real)vSubdivisions;
@@ -505,6 +505,13 @@ namespace Core {
                 }       
             }
         }
+    }
+
+    WeakPointer<Mesh> GeometryUtils::buildSphereMesh(Real radius, UInt32 subdivisions, Color color) {
+        std::vector<Real> positions;
+        std::vector<Real> normals;
+        std::vector<Real> colors;
+        GeometryUtils::buildSpherePositions(radius, subdivisions, positions);
 
         for (UInt32 i = 0; i < positions.size(); i+=4) {
             Real x = positions[i];
@@ -555,7 +562,7 @@ namespace Core {
         sphereMesh->calculateBoundingBox();
         sphereMesh->calculateNormals(85.0f * Core::Math::DegreesToRads);
 
-        return sphereMesh;
+        return optimizeMesh(sphereMesh);
     }
 
     WeakPointer<Mesh> GeometryUtils::buildTorusMesh(Real radius, Real tubeRadius, UInt32 subdivisions, UInt32 tubeSubdivisions, Color color) {
@@ -658,7 +665,7 @@ namespace Core {
         torusMesh->calculateBoundingBox();
         torusMesh->calculateNormals(85.0f * Core::Math::DegreesToRads);
 
-        return torusMesh;
+        return optimizeMesh(torusMesh);
 
     }
 
@@ -679,6 +686,14 @@ namespace Core {
         end.set(finalEndX, finalEndY, finalEndZ);
     }
 
+    /**
+     * Index [mesh] and reorder it for the vertex cache, overdraw and vertex fetch. The builders above emit
+     * plain triangle lists, so this is where they get the same treatment as imported meshes.
+     */
+    WeakPointer<Mesh> GeometryUtils::optimizeMesh(WeakPointer<Mesh> mesh) {
+        return MeshOptimizer::optimizeMesh(mesh, WeakPointer<VertexBoneMap>(), MeshOptimizer::Settings()).mesh;
+    }
+
     WeakPointer<Object3D> GeometryUtils::buildMeshContainerObject(WeakPointer<Mesh> mesh, WeakPointer<Material> material, const std::string& name) {
         WeakPointer<Engine> engine = Engine::instance();
         WeakPointer<Object3D> obj(engine->createObject3D());
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <vector>
+
 #include "../common/types.h"
 #include "../util/WeakPointer.h"
 #include "../color/Color.h"
@@ -20,9 +22,11 @@ namespace Core {
                                                 Real coneLength, Real coneRadius,
                                                 UInt32 subdivisions, Color color);
         static WeakPointer<Mesh> buildSphereMesh(Real radius, UInt32 subdivisions, Color color);
+        static void buildSpherePositions(Real radius, UInt32 subdivisions, std::vector<Real>& positions);
         static WeakPointer<Mesh> buildTorusMesh(Real radius, Real tubeRadius, UInt32 subdivisions, UInt32 tubeSubdivisions, Color color);
         static WeakPointer<Object3D> buildMeshContainerObject(WeakPointer<Mesh> mesh, WeakPointer<Material> material, const std::string& name);
     private:
+        static WeakPointer<Mesh> optimizeMesh(WeakPointer<Mesh> mesh);
         static void generateTorusSection(Real radius, Real tubeRadius, Real angle, Real tubeAngleStart,
                                          Real tubeAngleEnd, Point3r& start, Point3r& end);
     };
@@ -22,6 +22,16 @@ namespace Core {
         memcpy(this->indices, indices, sizeof(UInt32) * this->size);
     }
 
+    /*
+     * Replace the first [count] indices; the rest become undefined.
+     */
+    void IndexBuffer::setIndices(const UInt32 * indices, UInt32 count) {
+        if (count > this->size) {
+            throw OutOfRangeException("IndexBuffer::setIndices() -> 'count' is out of range.");
+        }
+        memcpy(this->indices, indices, sizeof(UInt32) * count);
+    }
+
     UInt32 IndexBuffer::getIndex(UInt32 offset) {
         return this->indices[offset];
     }
@@ -12,6 +12,7 @@ namespace Core {
         virtual Int32 getBufferID() const = 0;
         virtual void initIndices() = 0;
         virtual void setIndices(UInt32 * indices);
+        virtual void setIndices(const UInt32 * indices, UInt32 count);
         UInt32 getIndex(UInt32 offset);
         UInt32 getSize();
 
@@ -0,0 +1,54 @@
+#include "InterleavedAttributeGPUStorage.h"
+#include "InterleavedVertexBuffer.h"
+#include "../common/Exception.h"
+
+namespace Core {
+
+    InterleavedAttributeGPUStorage::InterleavedAttributeGPUStorage(std::shared_ptr<InterleavedVertexBuffer> buffer, UInt32 element):
+        buffer(buffer), element(element) {
+        if (!this->buffer) {
+            throw InvalidArgumentException("InterleavedAttributeGPUStorage::InterleavedAttributeGPUStorage() -> 'buffer' is not valid.");
+        }
+        this->buffer->getElement(element);
+    }
+
+    InterleavedAttributeGPUStorage::~InterleavedAttributeGPUStorage() {
+    }
+
+    Int32 InterleavedAttributeGPUStorage::getBufferID() const {
+        return this->buffer->getBufferID();
+    }
+
+    void InterleavedAttributeGPUStorage::enableAndSendToActiveShader(UInt32 location) {
+        this->buffer->enableAndSendElementToActiveShader(this->element, location);
+    }
+
+    void InterleavedAttributeGPUStorage::bind() {
+        this->buffer->bind();
+    }
+
+    void InterleavedAttributeGPUStorage::enableAndSendElementToActiveShader(UInt32 location, UInt32 componentCount, AttributeType type,
+                                                                            Bool normalize, UInt32 stride, UInt32 offset) {
+        throw InvalidArgumentException("InterleavedAttributeGPUStorage::enableAndSendElementToActiveShader() -> Already an interleaved element.");
+    }
+
+    void InterleavedAttributeGPUStorage::disable(UInt32 location) {
+        this->buffer->disable(location);
+    }
+
+    void InterleavedAttributeGPUStorage::setDivisor(UInt32 location, UInt32 divisor) {
+        this->buffer->setDivisor(location, divisor);
+    }
+
+    void InterleavedAttributeGPUStorage::updateBufferData(void * data) {
+        this->buffer->setElementData(this->element, data);
+    }
+
+    std::shared_ptr<InterleavedVertexBuffer> InterleavedAttributeGPUStorage::getBuffer() {
+        return this->buffer;
+    }
+
+    UInt32 InterleavedAttributeGPUStorage::getElement() const {
+        return this->element;
+    }
+}
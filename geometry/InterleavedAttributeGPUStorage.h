@@ -0,0 +1,40 @@
+#pragma once
+
+#include <memory>
+
+#include "../common/types.h"
+#include "AttributeArrayGPUStorage.h"
+
+namespace Core {
+
+    // forward declarations
+    class Engine;
+    class InterleavedVertexBuffer;
+
+    // GPU storage for one attribute array whose data lives in an element of an InterleavedVertexBuffer.
+    // Updates are scattered into the shared buffer and binding sets up the element's stride and offset.
+    class InterleavedAttributeGPUStorage final: public AttributeArrayGPUStorage {
+        friend class Engine;
+
+    public:
+        ~InterleavedAttributeGPUStorage() override;
+
+        Int32 getBufferID() const override;
+        void enableAndSendToActiveShader(UInt32 location) override;
+        void bind() override;
+        void enableAndSendElementToActiveShader(UInt32 location, UInt32 componentCount, AttributeType type,
+                                                Bool normalize, UInt32 stride, UInt32 offset) override;
+        void disable(UInt32 location) override;
+        void setDivisor(UInt32 location, UInt32 divisor) override;
+        void updateBufferData(void * data) override;
+
+        std::shared_ptr<InterleavedVertexBuffer> getBuffer();
+        UInt32 getElement() const;
+
+    private:
+        InterleavedAttributeGPUStorage(std::shared_ptr<InterleavedVertexBuffer> buffer, UInt32 element);
+
+        std::shared_ptr<InterleavedVertexBuffer> buffer;
+        UInt32 element;
+    };
+}
@@ -0,0 +1,103 @@
+#include <string.h>
+
+#include "InterleavedVertexBuffer.h"
+#include "AttributeArrayGPUStorage.h"
+#include "../Engine.h"
+#include "../common/Exception.h"
+
+namespace Core {
+
+    InterleavedVertexBuffer::InterleavedVertexBuffer(UInt32 vertexCount): vertexCount(vertexCount), stride(0), dirty(false) {
+    }
+
+    InterleavedVertexBuffer::~InterleavedVertexBuffer() {
+        if (this->gpuStorage.isValid()) {
+            Engine::safeReleaseObject(this->gpuStorage);
+        }
+    }
+
+    UInt32 InterleavedVertexBuffer::addElement(UInt32 componentCount, UInt32 size, AttributeType type, Bool normalize) {
+        if (this->gpuStorage.isValid()) {
+            throw InvalidArgumentException("InterleavedVertexBuffer::addElement() -> Cannot add elements after the buffer has been built.");
+        }
+        Element element;
+        element.componentCount = componentCount;
+        element.size = size;
+        element.type = type;
+        element.normalize = normalize;
+        element.offset = this->stride;
+        this->elements.push_back(element);
+        this->stride += size;
+        return (UInt32)this->elements.size() - 1;
+    }
+
+    void InterleavedVertexBuffer::build() {
+        UInt32 size = this->stride * this->vertexCount;
+        this->data.assign(size, 0);
+        if (this->gpuStorage.isValid()) {
+            Engine::safeReleaseObject(this->gpuStorage);
+        }
+        this->gpuStorage = Engine::instance()->createGPUStorage(size, 1, AttributeType::Float, false);
+        this->dirty = true;
+    }
+
+    const InterleavedVertexBuffer::Element& InterleavedVertexBuffer::getElement(UInt32 element) const {
+        if (element >= this->elements.size()) {
+            throw OutOfRangeException("InterleavedVertexBuffer::getElement() -> 'element' is out of range.");
+        }
+        return this->elements[element];
+    }
+
+    UInt32 InterleavedVertexBuffer::getElementCount() const {
+        return (UInt32)this->elements.size();
+    }
+
+    UInt32 InterleavedVertexBuffer::getStride() const {
+        return this->stride;
+    }
+
+    UInt32 InterleavedVertexBuffer::getVertexCount() const {
+        return this->vertexCount;
+    }
+
+    Int32 InterleavedVertexBuffer::getBufferID() const {
+        return this->gpuStorage.isValid() ? this->gpuStorage->getBufferID() : -1;
+    }
+
+    void InterleavedVertexBuffer::setElementData(UInt32 element, const void* data) {
+        const Element& desc = this->getElement(element);
+        if (this->data.size() == 0) {
+            throw InvalidArgumentException("InterleavedVertexBuffer::setElementData() -> Buffer has not been built.");
+        }
+        UInt32 elementSize = desc.size;
+        const Byte* src = static_cast<const Byte*>(data);
+        Byte* dest = this->data.data() + desc.offset;
+        for (UInt32 i = 0; i < this->vertexCount; i++) {
+            memcpy(dest, src, elementSize);
+            src += elementSize;
+            dest += this->stride;
+        }
+        this->dirty = true;
+    }
+
+    void InterleavedVertexBuffer::bind() {
+        if (this->dirty) {
+            this->gpuStorage->updateBufferData((void*)this->data.data());
+            this->dirty = false;
+        }
+        this->gpuStorage->bind();
+    }
+
+    void InterleavedVertexBuffer::enableAndSendElementToActiveShader(UInt32 element, UInt32 location) {
+        const Element& desc = this->getElement(element);
+        this->gpuStorage->enableAndSendElementToActiveShader(location, desc.componentCount, desc.type, desc.normalize, this->stride, desc.offset);
+    }
+
+    void InterleavedVertexBuffer::disable(UInt32 location) {
+        this->gpuStorage->disable(location);
+    }
+
+    void InterleavedVertexBuffer::setDivisor(UInt32 location, UInt32 divisor) {
+        this->gpuStorage->setDivisor(location, divisor);
+    }
+}
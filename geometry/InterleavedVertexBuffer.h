@@ -0,0 +1,57 @@
+#pragma once
+
+#include <vector>
+
+#include "../common/types.h"
+#include "../util/PersistentWeakPointer.h"
+#include "AttributeType.h"
+
+namespace Core {
+
+    // forward declarations
+    class AttributeArrayGPUStorage;
+
+    // A single GPU buffer holding several per-vertex attributes packed one after the other for each vertex.
+    // Elements are added in order and each is given the next free offset within the vertex; the stride is the
+    // sum of all element sizes. A CPU copy of the packed data is kept so individual elements can be updated
+    // independently, and it is uploaded the next time the buffer is bound after any element changed. The
+    // buffer is bound once with bind() before its elements are sent to the active shader.
+    class InterleavedVertexBuffer {
+    public:
+        class Element {
+        public:
+            UInt32 componentCount;
+            // bytes per vertex
+            UInt32 size;
+            AttributeType type;
+            Bool normalize;
+            UInt32 offset;
+        };
+
+        InterleavedVertexBuffer(UInt32 vertexCount);
+        ~InterleavedVertexBuffer();
+
+        UInt32 addElement(UInt32 componentCount, UInt32 size, AttributeType type, Bool normalize);
+        void build();
+
+        const Element& getElement(UInt32 element) const;
+        UInt32 getElementCount() const;
+        UInt32 getStride() const;
+        UInt32 getVertexCount() const;
+        Int32 getBufferID() const;
+
+        void setElementData(UInt32 element, const void* data);
+        void bind();
+        void enableAndSendElementToActiveShader(UInt32 element, UInt32 location);
+        void disable(UInt32 location);
+        void setDivisor(UInt32 location, UInt32 divisor);
+
+    private:
+        UInt32 vertexCount;
+        UInt32 stride;
+        Bool dirty;
+        std::vector<Element> elements;
+        std::vector<Byte> data;
+        PersistentWeakPointer<AttributeArrayGPUStorage> gpuStorage;
+    };
+}
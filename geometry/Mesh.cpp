@@ -1,3 +1,6 @@
+#include <algorithm>
+#include <cmath>
+
 #include "Mesh.h"
 #include "../common/Exception.h"
 #include "../common/types.h"
@@ -5,13 +8,28 @@
 #include "Vector3.h"
 #include "IndexBuffer.h"
 #include "IndexBuffer.h"
+#include "InterleavedVertexBuffer.h"
 #include "../math/Math.h"
 #include "../common/Constants.h"
+#include "../util/ParallelFor.h"
 
 namespace Core {
 
+    // twice the tolerance of Vector3Base::Eq: a position can only equal positions in its own cell or in the
+    // neighbouring cell on the side of the cell boundary it is closer to, on each axis
+    static const Real CrossMapCellSize = .01f;
+    static const UInt32 MinimumParallelWork = 16384;
+
+    // Map [value] to the index of its cell, biased to fit an unsigned integer. Values whose cell cannot be
+    // represented (not finite, or absurdly far from the origin) all map to Unquantizable.
+    static const UInt32 Unquantizable = 0xFFFFFFFF;
+    static UInt32 quantizeCrossMapCoordinate(Real value) {
+        Real cell = std::floor(value / CrossMapCellSize);
+        if (!(cell >= -2147483648.0f && cell < 2147483648.0f)) return Unquantizable;
+        return (UInt32)((Int64)cell + 0x80000000LL);
+    }
+
     Mesh::Mesh(UInt32 vertexCount, UInt32 indexCount): vertexCount(vertexCount), indexCount(indexCount) {
-        this->vertexCrossMap = nullptr;
         this->initialized = false;
         this->indexed = indexCount > 0 ? true : false;
         this->enabledAttributes = StandardAttributes::createAttributeSet();
@@ -19,6 +37,10 @@ namespace Core {
         this->shouldCalculateNormals = false;
         this->shouldCalculateTangents = false;
         this->shouldCalculateBounds = false;
+        this->interleaved = false;
+        for (UInt32 i = 0; i < (UInt32)StandardAttribute::_Count; i++) {
+            this->attributeFormats[i] = AttributeFormat::Native;
+        }
         initAttributes();
     }
 
@@ -76,6 +98,138 @@ namespace Core {
         return this->indexed;
     }
 
+    void Mesh::setInterleaved(Bool interleaved) {
+        if (this->interleaved == interleaved) return;
+        this->interleaved = interleaved;
+        if (interleaved) this->buildInterleavedVertexBuffer();
+        else this->releaseInterleavedVertexBuffer();
+    }
+
+    Bool Mesh::isInterleaved() const {
+        return this->interleaved;
+    }
+
+    std::shared_ptr<InterleavedVertexBuffer> Mesh::getInterleavedVertexBuffer() {
+        return this->interleavedVertexBuffer;
+    }
+
+    void Mesh::setAttributeFormat(StandardAttribute attribute, AttributeFormat format) {
+        UInt32 componentCount = 0;
+        switch (attribute) {
+            case StandardAttribute::Position:
+            case StandardAttribute::Normal:
+            case StandardAttribute::AveragedNormal:
+            case StandardAttribute::FaceNormal:
+            case StandardAttribute::Tangent:
+                componentCount = 3;
+                break;
+            case StandardAttribute::Color:
+                componentCount = 4;
+                break;
+            case StandardAttribute::AlbedoUV:
+            case StandardAttribute::NormalUV:
+                componentCount = 2;
+                break;
+            default:
+                throw InvalidArgumentException("Mesh::setAttributeFormat() -> Attribute is not stored in a mesh.");
+        }
+        if (!AttributeFormats::isSupported(format, componentCount, true)) {
+            throw InvalidArgumentException("Mesh::setAttributeFormat() -> Format is not supported for this attribute.");
+        }
+
+        this->attributeFormats[(UInt32)attribute] = format;
+        this->applyAttributeFormats();
+        if (this->interleaved) this->buildInterleavedVertexBuffer();
+    }
+
+    AttributeFormat Mesh::getAttributeFormat(StandardAttribute attribute) const {
+        if ((UInt32)attribute >= (UInt32)StandardAttribute::_Count) {
+            throw OutOfRangeException("Mesh::getAttributeFormat() -> 'attribute' is out of range.");
+        }
+        return this->attributeFormats[(UInt32)attribute];
+    }
+
+    template <typename T>
+    static void applyAttributeFormat(std::shared_ptr<AttributeArray<T>> array, AttributeFormat format) {
+        if (array) array->setGPUFormat(format);
+    }
+
+    void Mesh::applyAttributeFormats() {
+        applyAttributeFormat<Point3rs>(this->vertexPositions, this->attributeFormats[(UInt32)StandardAttribute::Position]);
+        applyAttributeFormat<Vector3rs>(this->vertexNormals, this->attributeFormats[(UInt32)StandardAttribute::Normal]);
+        applyAttributeFormat<Vector3rs>(this->vertexAveragedNormals, this->attributeFormats[(UInt32)StandardAttribute::AveragedNormal]);
+        applyAttributeFormat<Vector3rs>(this->vertexFaceNormals, this->attributeFormats[(UInt32)StandardAttribute::FaceNormal]);
+        applyAttributeFormat<Vector3rs>(this->vertexTangents, this->attributeFormats[(UInt32)StandardAttribute::Tangent]);
+        applyAttributeFormat<ColorS>(this->vertexColors, this->attributeFormats[(UInt32)StandardAttribute::Color]);
+        applyAttributeFormat<Vector2rs>(this->vertexAlbedoUVs, this->attributeFormats[(UInt32)StandardAttribute::AlbedoUV]);
+        applyAttributeFormat<Vector2rs>(this->vertexNormalUVs, this->attributeFormats[(UInt32)StandardAttribute::NormalUV]);
+    }
+
+    template <typename T>
+    static void addInterleavedElement(std::shared_ptr<InterleavedVertexBuffer> buffer, std::shared_ptr<AttributeArray<T>> array, std::vector<UInt32>& elements) {
+        if (array) {
+            elements.push_back(buffer->addElement(array->getGPUComponentCount(), array->getGPUAttributeSize(),
+                                                  array->getGPUAttributeType(), array->shouldNormalizeGPUData()));
+        }
+    }
+
+    template <typename T>
+    static void attachInterleavedElement(std::shared_ptr<InterleavedVertexBuffer> buffer, std::shared_ptr<AttributeArray<T>> array,
+                                         const std::vector<UInt32>& elements, UInt32& current) {
+        if (array) {
+            array->setGPUStorage(Engine::instance()->createInterleavedGPUStorage(buffer, elements[current]));
+            current++;
+        }
+    }
+
+    template <typename T>
+    static void detachInterleavedElement(std::shared_ptr<AttributeArray<T>> array) {
+        if (array) array->allocateGPUStorage();
+    }
+
+    // Rebuilt whenever an attribute array is (re)initialized, so the layout always covers exactly the arrays that exist.
+    // Each array keeps a view onto the shared buffer; the buffer itself goes away with the last view.
+    void Mesh::buildInterleavedVertexBuffer() {
+        std::shared_ptr<InterleavedVertexBuffer> buffer = std::make_shared<InterleavedVertexBuffer>(this->vertexCount);
+        std::vector<UInt32> elements;
+        addInterleavedElement<Point3rs>(buffer, this->vertexPositions, elements);
+        addInterleavedElement<Vector3rs>(buffer, this->vertexNormals, elements);
+        addInterleavedElement<Vector3rs>(buffer, this->vertexAveragedNormals, elements);
+        addInterleavedElement<Vector3rs>(buffer, this->vertexFaceNormals, elements);
+        addInterleavedElement<Vector3rs>(buffer, this->vertexTangents, elements);
+        addInterleavedElement<ColorS>(buffer, this->vertexColors, elements);
+        addInterleavedElement<Vector2rs>(buffer, this->vertexAlbedoUVs, elements);
+        addInterleavedElement<Vector2rs>(buffer, this->vertexNormalUVs, elements);
+        if (elements.size() == 0) {
+            this->interleavedVertexBuffer = nullptr;
+            return;
+        }
+        buffer->build();
+
+        UInt32 current = 0;
+        attachInterleavedElement<Point3rs>(buffer, this->vertexPositions, elements, current);
+        attachInterleavedElement<Vector3rs>(buffer, this->vertexNormals, elements, current);
+        attachInterleavedElement<Vector3rs>(buffer, this->vertexAveragedNormals, elements, current);
+        attachInterleavedElement<Vector3rs>(buffer, this->vertexFaceNormals, elements, current);
+        attachInterleavedElement<Vector3rs>(buffer, this->vertexTangents, elements, current);
+        attachInterleavedElement<ColorS>(buffer, this->vertexColors, elements, current);
+        attachInterleavedElement<Vector2rs>(buffer, this->vertexAlbedoUVs, elements, current);
+        attachInterleavedElement<Vector2rs>(buffer, this->vertexNormalUVs, elements, current);
+        this->interleavedVertexBuffer = buffer;
+    }
+
+    void Mesh::releaseInterleavedVertexBuffer() {
+        detachInterleavedElement<Point3rs>(this->vertexPositions);
+        detachInterleavedElement<Vector3rs>(this->vertexNormals);
+        detachInterleavedElement<Vector3rs>(this->vertexAveragedNormals);
+        detachInterleavedElement<Vector3rs>(this->vertexFaceNormals);
+        detachInterleavedElement<Vector3rs>(this->vertexTangents);
+        detachInterleavedElement<ColorS>(this->vertexColors);
+        detachInterleavedElement<Vector2rs>(this->vertexAlbedoUVs);
+        detachInterleavedElement<Vector2rs>(this->vertexNormalUVs);
+        this->interleavedVertexBuffer = nullptr;
+    }
+
     void Mesh::calculateBoundingBox() {
         Vector3r min;
         Vector3r max;
@@ -174,34 +328,54 @@ namespace Core {
     }
 
     Bool Mesh::initVertexPositions() {
-        return this->initVertexAttributes<Point3rs>(&this->vertexPositions, this->vertexCount);
+        Bool result = this->initVertexAttributes<Point3rs>(&this->vertexPositions, this->vertexCount);
+        this->applyAttributeFormats();
+        if (this->interleaved) this->buildInterleavedVertexBuffer();
+        return result;
     }
 
     Bool Mesh::initVertexNormals() {
         Bool result = true;
         result = this->initVertexAttributes<Vector3rs>(&this->vertexNormals, this->vertexCount);
         result = result && this->initVertexAttributes<Vector3rs>(&this->vertexAveragedNormals, this->vertexCount);
+        this->applyAttributeFormats();
+        if (this->interleaved) this->buildInterleavedVertexBuffer();
         return result;
     }
 
     Bool Mesh::initVertexFaceNormals() {
-        return this->initVertexAttributes<Vector3rs>(&this->vertexFaceNormals, this->vertexCount);
+        Bool result = this->initVertexAttributes<Vector3rs>(&this->vertexFaceNormals, this->vertexCount);
+        this->applyAttributeFormats();
+        if (this->interleaved) this->buildInterleavedVertexBuffer();
+        return result;
     }
 
     Bool Mesh::initVertexTangents() {
-        return this->initVertexAttributes<Vector3rs>(&this->vertexTangents, this->vertexCount);
+        Bool result = this->initVertexAttributes<Vector3rs>(&this->vertexTangents, this->vertexCount);
+        this->applyAttributeFormats();
+        if (this->interleaved) this->buildInterleavedVertexBuffer();
+        return result;
     }
 
     Bool Mesh::initVertexColors() {
-        return this->initVertexAttributes<ColorS>(&this->vertexColors, this->vertexCount);
+        Bool result = this->initVertexAttributes<ColorS>(&this->vertexColors, this->vertexCount);
+        this->applyAttributeFormats();
+        if (this->interleaved) this->buildInterleavedVertexBuffer();
+        return result;
     }
 
     Bool Mesh::initVertexAlbedoUVs() {
-        return this->initVertexAttributes<Vector2rs>(&this->vertexAlbedoUVs, this->vertexCount);
+        Bool result = this->initVertexAttributes<Vector2rs>(&this->vertexAlbedoUVs, this->vertexCount);
+        this->applyAttributeFormats();
+        if (this->interleaved) this->buildInterleavedVertexBuffer();
+        return result;
     }
 
     Bool Mesh::initVertexNormalUVs() {
-        return this->initVertexAttributes<Vector2rs>(&this->vertexNormalUVs, this->vertexCount);
+        Bool result = this->initVertexAttributes<Vector2rs>(&this->vertexNormalUVs, this->vertexCount);
+        this->applyAttributeFormats();
+        if (this->interleaved) this->buildInterleavedVertexBuffer();
+        return result;
     }
 
     Bool Mesh::initIndices() {
@@ -311,7 +485,7 @@ namespace Core {
     void Mesh::calculateNormals(Real smoothingThreshhold) {
         if (!StandardAttributes::hasAttribute(this->enabledAttributes, StandardAttribute::Normal))return;
 
-        if (this->vertexCrossMap == nullptr) {
+        if (this->vertexGroupStarts.size() == 0) {
             this->buildVertexCrossMap();
         }
 
@@ -356,96 +530,99 @@ namespace Core {
 
         // This vector is used to store the calculated average normal for all equal vertices
         // whose normals differ by an angle that is less than 'smoothingThreshhold'
-        std::vector<Vector3r> averageNormals;
+        std::vector<Vector3r> averageNormals(realVertexCount);
 
         // This vector is used to store the calculated average normal for all equal vertices
-        std::vector<Vector3r> fullAverageNormals;
+        std::vector<Vector3r> fullAverageNormals(realVertexCount);
 
         // compute the cosine of the smoothing threshhold angle
         Real cosSmoothingThreshhold = (Math::cos(smoothingThreshhold));
 
-        // loop through each vertex and lookup the associated list of
-        // normals associated with that vertex, and then calculate the
-        // average normal from that list.
-        for (UInt32 v = 0; v < realVertexCount; v++) {
-
-            UInt32 mappedIndex = v;
-            if (this->indexed) {
-                mappedIndex = indices->getIndex(mappedIndex);
-            }
-
-            // get existing normal for this vertex
-            Vector3r oNormal;
-            oNormal = vertexFaceNormals->getAttribute(mappedIndex);
-            oNormal.normalize();
+        // weak pointers resolve themselves on first use, so the threads get plain pointers
+        IndexBuffer* indexBuffer = this->indexed ? indices.get() : nullptr;
+        AttributeArray<Vector3rs>* faceNormalArray = vertexFaceNormals.get();
+
+        // loop through each group of equal vertices and calculate the average normal of each member
+        // from the normals of the group. Groups are independent, so they are split across threads;
+        // within a group the normals are summed in ascending vertex order, as they always were.
+        UInt32 groupCount = (UInt32)this->vertexGroupStarts.size() - 1;
+        parallelFor(groupCount, MinimumParallelWork, [&](UInt32 firstGroup, UInt32 lastGroup) {
+            std::vector<Vector3r> groupNormals;
+            for (UInt32 g = firstGroup; g < lastGroup; g++) {
+                UInt32 groupStart = this->vertexGroupStarts[g];
+                UInt32 groupEnd = this->vertexGroupStarts[g + 1];
+
+                groupNormals.clear();
+                Vector3r groupAvg(0, 0, 0);
+                for (UInt32 i = groupStart; i < groupEnd; i++) {
+                    UInt32 mappedSubIndex = this->vertexGroupMembers[i];
+                    if (this->indexed) {
+                        mappedSubIndex = indexBuffer->getIndex(mappedSubIndex);
+                    }
 
-            // retrieve the list of equal vertices for vertex [v]
-            std::vector<UInt32>* listPtr = vertexCrossMap[v];
-            if (listPtr == nullptr) {
-                throw Exception("Mesh::calculateNormals -> Null pointer to vertex group list.");
-            }
+                    Vector3r current = faceNormalArray->getAttribute(mappedSubIndex);
+                    current.normalize();
+                    groupNormals.push_back(current);
 
-            Vector3r avg(0, 0, 0);
-            Real divisor = 0;
-            Vector3r fullAvg(0, 0, 0);
-            Real fullDivisor = 0;
+                    groupAvg.x += current.x;
+                    groupAvg.y += current.y;
+                    groupAvg.z += current.z;
+                }
+                Real fullDivisor = (Real)(groupEnd - groupStart);
 
-            std::vector<UInt32>& list = *listPtr;
+                for (UInt32 m = groupStart; m < groupEnd; m++) {
+                    UInt32 v = this->vertexGroupMembers[m];
 
-            for (UInt32 i = 0; i < list.size(); i++) {
-                UInt32 vIndex = list[i];
+                    // existing normal for this vertex
+                    const Vector3r& oNormal = groupNormals[m - groupStart];
 
-                UInt32 mappedSubIndex = vIndex;
-                if (this->indexed) {
-                    mappedSubIndex = indices->getIndex(mappedSubIndex);
-                }
+                    Vector3r avg(0, 0, 0);
+                    Real divisor = 0;
+                    for (UInt32 i = 0; i < groupNormals.size(); i++) {
+                        const Vector3r& current = groupNormals[i];
 
-                Vector3r current = vertexFaceNormals->getAttribute(mappedSubIndex);
-                current.normalize();
+                        // calculate angle between the normal that exists for this vertex,
+                        // and the current normal in the list.
+                        Real dot = Vector3r::dot(current, oNormal);
 
-                // calculate angle between the normal that exists for this vertex,
-                // and the current normal in the list.
-                Real dot = Vector3r::dot(current, oNormal);
+                        if (dot > cosSmoothingThreshhold) {
+                            avg.x += current.x;
+                            avg.y += current.y;
+                            avg.z += current.z;
+                            divisor++;
+                        }
+                    }
 
-                if (dot > cosSmoothingThreshhold) {
-                    avg.x += current.x;
-                    avg.y += current.y;
-                    avg.z += current.z;
-                    divisor++;
+                    // if divisor <= 1, then no valid normals were found to include in the average,
+                    // so just use the existing one
+                    if (divisor <= 1) {
+                        avg.x = oNormal.x;
+                        avg.y = oNormal.y;
+                        avg.z = oNormal.z;
+                    }
+                    else {
+                        Real scaleFactor = (Real)1.0 / divisor;
+                        avg.scale(scaleFactor);
+                    }
+                    averageNormals[v] = avg;
+
+                    // if fullDivisor <= 1, then no valid normals were found to include in the average,
+                    // so just use the existing one
+                    Vector3r fullAvg;
+                    if (fullDivisor <= 1) {
+                        fullAvg.x = oNormal.x;
+                        fullAvg.y = oNormal.y;
+                        fullAvg.z = oNormal.z;
+                    }
+                    else {
+                        fullAvg = groupAvg;
+                        Real scaleFactor = (Real)1.0 / fullDivisor;
+                        fullAvg.scale(scaleFactor);
+                    }
+                    fullAverageNormals[v] = fullAvg;
                 }
-                fullAvg.x += current.x;
-                fullAvg.y += current.y;
-                fullAvg.z += current.z;
-                fullDivisor++;
-            }
-
-            // if divisor <= 1, then no valid normals were found to include in the average,
-            // so just use the existing one
-            if (divisor <= 1) {
-                avg.x = oNormal.x;
-                avg.y = oNormal.y;
-                avg.z = oNormal.z;
-            }
-            else {
-                Real scaleFactor = (Real)1.0 / divisor;
-                avg.scale(scaleFactor);
-            }
-            averageNormals.push_back(avg);
-
-            // if fullDivisor <= 1, then no valid normals were found to include in the average,
-            // so just use the existing one
-            if (fullDivisor <= 1) {
-                fullAvg.x = oNormal.x;
-                fullAvg.y = oNormal.y;
-                fullAvg.z = oNormal.z;
             }
-            else {
-                Real scaleFactor = (Real)1.0 / fullDivisor;
-                fullAvg.scale(scaleFactor);
-            }
-
-            fullAverageNormals.push_back(fullAvg);
-        }
+        });
 
         // loop through each vertex and assign the average normal
         // calculated for that vertex
@@ -525,87 +702,107 @@ namespace Core {
     void Mesh::calculateTangents(Real smoothingThreshhold) {
         if (!StandardAttributes::hasAttribute(this->enabledAttributes, StandardAttribute::Tangent)) return;
 
-        WeakPointer<AttributeArray<Vector3rs>> tangents = this->getVertexTangents();
-        WeakPointer<AttributeArray<Vector3rs>> faceNormals = this->getVertexFaceNormals();
+        if (this->vertexGroupStarts.size() == 0) {
+            this->buildVertexCrossMap();
+        }
+
+        // weak pointers resolve themselves on first use, so the threads get plain pointers
+        WeakPointer<AttributeArray<Vector3rs>> tangentsPtr = this->getVertexTangents();
+        WeakPointer<AttributeArray<Vector3rs>> faceNormalsPtr = this->getVertexFaceNormals();
+        AttributeArray<Vector3rs>* tangents = tangentsPtr.get();
+        AttributeArray<Vector3rs>* faceNormals = faceNormalsPtr.get();
 
         // loop through each triangle in this mesh's vertices
         // and calculate tangents for each
-        for (UInt32 v = 0; v < this->vertexCount - 2; v += 3) {
-            Vector3r t0, t1, t2;
-
-            this->calculateTangent(v, v + 2, v + 1, t0);
-            this->calculateTangent(v + 1, v, v + 2, t1);
-            this->calculateTangent(v + 2, v + 1, v, t2);
-
-            tangents->getAttribute(v).copy(t0);
-            tangents->getAttribute(v + 1).copy(t1);
-            tangents->getAttribute(v + 2).copy(t2);
-        }
-
-        // This vector is used to store the calculated average tangent for all equal vertices
-        std::vector<Vector3r> averageTangents;
+        UInt32 triangleCount = this->vertexCount / 3;
+        parallelFor(triangleCount, MinimumParallelWork, [&](UInt32 firstTriangle, UInt32 lastTriangle) {
+            for (UInt32 t = firstTriangle; t < lastTriangle; t++) {
+                UInt32 v = t * 3;
+                Vector3r t0, t1, t2;
+
+                this->calculateTangent(v, v + 2, v + 1, t0);
+                this->calculateTangent(v + 1, v, v + 2, t1);
+                this->calculateTangent(v + 2, v + 1, v, t2);
+
+                tangents->getAttribute(v).copy(t0);
+                tangents->getAttribute(v + 1).copy(t1);
+                tangents->getAttribute(v + 2).copy(t2);
+            }
+        });
 
-        // loop through each vertex and lookup the associated list of
-        // tangents associated with that vertex, and then calculate the
-        // average tangents from that list.
-        for (UInt32 v = 0; v < this->vertexCount; v++) {
-            // get existing normal for this vertex
-            Vector3r oNormal;
-            oNormal = faceNormals->getAttribute(v);
-            oNormal.normalize();
-
-            Vector3r oTangent;
-            oTangent = vertexTangents->getAttribute(v);
-            oTangent.normalize();
-
-            // retrieve the list of equal vertices for vertex [v]
-            std::vector<UInt32>* listPtr = vertexCrossMap[v];
-            if (listPtr == nullptr) {
-                throw Exception("Mesh::calculateTangents -> Null pointer to vertex group list.");
+        // the face normals are compared in place below, so normalize them once up front
+        // rather than every time a vertex group is visited
+        parallelFor(this->vertexCount, MinimumParallelWork, [&](UInt32 first, UInt32 last) {
+            for (UInt32 v = first; v < last; v++) {
+                faceNormals->getAttribute(v).normalize();
             }
+        });
 
-            Vector3r avg(0, 0, 0);
-            Real divisor = 0;
+        // This vector is used to store the calculated average tangent for all equal vertices
+        std::vector<Vector3r> averageTangents(this->vertexCount);
 
-            std::vector<UInt32>& list = *listPtr;
+        // compute the cosine of the smoothing threshhold angle
+        Real cosSmoothingThreshhold = (Math::cos(smoothingThreshhold));
 
-            // compute the cosine of the smoothing threshhold angle
-            Real cosSmoothingThreshhold = (Math::cos(smoothingThreshhold));
+        // loop through each group of equal vertices and calculate the average tangent
+        // of each member from the tangents of the group.
+        UInt32 groupCount = (UInt32)this->vertexGroupStarts.size() - 1;
+        parallelFor(groupCount, MinimumParallelWork, [&](UInt32 firstGroup, UInt32 lastGroup) {
+            for (UInt32 g = firstGroup; g < lastGroup; g++) {
+                UInt32 groupStart = this->vertexGroupStarts[g];
+                UInt32 groupEnd = this->vertexGroupStarts[g + 1];
+
+                for (UInt32 m = groupStart; m < groupEnd; m++) {
+                    UInt32 v = this->vertexGroupMembers[m];
+                    if (v >= this->vertexCount) continue;
+
+                    // get existing normal for this vertex
+                    Vector3r oNormal;
+                    oNormal = faceNormals->getAttribute(v);
+                    oNormal.normalize();
+
+                    Vector3r oTangent;
+                    oTangent = tangents->getAttribute(v);
+                    oTangent.normalize();
+
+                    Vector3r avg(0, 0, 0);
+                    Real divisor = 0;
+
+                    for (UInt32 i = groupStart; i < groupEnd; i++) {
+                        UInt32 vIndex = this->vertexGroupMembers[i];
+                        Vector3rs& current = faceNormals->getAttribute(vIndex);
+
+                        // calculate angle between the normal that exists for this vertex,
+                        // and the current normal in the list.
+                        Real dot = Vector3r::dot(current, oNormal);
+
+                        if (dot > cosSmoothingThreshhold) {
+                            Vector3rs& tangent = tangents->getAttribute(vIndex);
+                            avg.x += tangent.x;
+                            avg.y += tangent.y;
+                            avg.z += tangent.z;
+                            divisor++;
+                        }
+                    }
 
-            for (UInt32 i = 0; i < list.size(); i++) {
-                UInt32 vIndex = list[i];
-                Vector3rs& current = faceNormals->getAttribute(vIndex);
-                current.normalize();
+                    // if divisor < 1, then no extra tangents were found to include in the average,
+                    // so just use the original one
 
-                // calculate angle between the normal that exists for this vertex,
-                // and the current normal in the list.
-                Real dot = Vector3r::dot(current, oNormal);
+                    if (divisor <= 1) {
+                        avg.x = oTangent.x;
+                        avg.y = oTangent.y;
+                        avg.z = oTangent.z;
+                    }
+                    else {
+                        Real scaleFactor = (Real)1.0 / divisor;
+                        avg.scale(scaleFactor);
+                        //avg.Normalize();
+                    }
 
-                if (dot > cosSmoothingThreshhold) {
-                    Vector3rs& tangent = tangents->getAttribute(vIndex);
-                    avg.x += tangent.x;
-                    avg.y += tangent.y;
-                    avg.z += tangent.z;
-                    divisor++;
+                    averageTangents[v] = avg;
                 }
             }
-
-            // if divisor < 1, then no extra tangents were found to include in the average,
-            // so just use the original one
-
-            if (divisor <= 1) {
-                avg.x = oTangent.x;
-                avg.y = oTangent.y;
-                avg.z = oTangent.z;
-            }
-            else {
-                Real scaleFactor = (Real)1.0 / divisor;
-                avg.scale(scaleFactor);
-                //avg.Normalize();
-            }
-
-            averageTangents.push_back(avg);
-        }
+        });
 
         // loop through each vertex and assign the average tangent
         // calculated for that vertex
@@ -681,76 +878,210 @@ namespace Core {
     }
 
     /*
-     * Deallocate and destroy [vertexCrossMap].
+     * Deallocate and destroy the vertex cross map.
      */
     void Mesh::destroyVertexCrossMap() {
-        if (this->vertexCrossMap != nullptr) {
-            UInt32 realVertexCount = this->vertexCount;
-            if (this->indexed) {
-                realVertexCount = this->indexCount;
-            }
-
-            std::unordered_map<std::vector<UInt32>*, Bool> deleted;
-            for (UInt32 i = 0; i < realVertexCount; i++) {
-                std::vector<UInt32>* list = this->vertexCrossMap[i];
-                if (list != nullptr && !deleted[list]) {
-                    delete list;
-                    deleted[list] = true;
-                }
-            }
-
-            delete[] this->vertexCrossMap;
-            this->vertexCrossMap = nullptr;
-        }
+        std::vector<UInt32>().swap(this->vertexGroupStarts);
+        std::vector<UInt32>().swap(this->vertexGroupMembers);
     }
 
     /*
-     * Construct [vertexCrossMap]. The vertex cross map is used to group all vertices that are equal.
-     * For a given combination of x,y,z, a corresponding list exists in [vertexCrossMap] with all the indices
-     * of vertices in [vertexPositions] which have a matching value for x,y, and z.
+     * Construct the vertex cross map, which groups all vertices that are equal (see groupEqualPositions()). For an
+     * indexed mesh the "vertices" are the entries of the index buffer, as before.
      */
     Bool Mesh::buildVertexCrossMap() {
         // destroy existing cross map (if there is one).
         this->destroyVertexCrossMap();
 
-        // This map is used to link all equal vertices. Many triangles in a mesh can potentially have equal
-        // vertices, so this structure is used to store indices in [vertexPositions] for those vertices.
-        std::unordered_map<Point3r, std::vector<UInt32>*, Vector3Base<Real>::Hasher, Vector3Base<Real>::Eq> vertexGroups;
-
         UInt32 realVertexCount = this->vertexCount;
         WeakPointer<IndexBuffer> indices;
         if (this->indexed) {
             indices = this->getIndexBuffer();
             realVertexCount = this->indexCount;
         }
+        if (realVertexCount == 0) return true;
 
-        vertexCrossMap = new(std::nothrow) std::vector<UInt32>*[realVertexCount];
-        if (vertexCrossMap == nullptr) {
-            throw AllocationException("Mesh::buildVertexCrossMap -> Could not allocate vertexCrossMap.");
+        std::vector<Point3r> positions;
+        try {
+            positions.resize(realVertexCount);
+        }
+        catch(...) {
+            throw AllocationException("Mesh::buildVertexCrossMap -> Could not allocate positions.");
         }
-        
-        // loop through each vertex in the mesh and add the index in [vertexPositions] for that vertex to the
-        // appropriate vertex group.
         for (UInt32 v = 0; v < realVertexCount; v++) {
             UInt32 mappedIndex = v;
             if (this->indexed) {
                 mappedIndex = indices->getIndex(mappedIndex);
             }
+            positions[v] = this->vertexPositions->getAttribute(mappedIndex);
+        }
+
+        groupEqualPositions(positions.data(), realVertexCount, this->vertexGroupStarts, this->vertexGroupMembers);
+        return true;
+    }
 
-            Point3r point = this->vertexPositions->getAttribute(mappedIndex);
+    // Open addressing table from the key of a cell to its index. Keys are kept in the slots so that a lookup
+    // touches a single cache line.
+    class CrossMapCellTable {
+    public:
+        static const UInt32 Empty = 0xFFFFFFFF;
+
+        CrossMapCellTable(UInt32 cellCount) {
+            UInt32 tableSize = 16;
+            while (tableSize < cellCount * 2) tableSize *= 2;
+            this->mask = tableSize - 1;
+            this->slots.resize(tableSize);
+            for (Slot& slot : this->slots) slot.cell = Empty;
+        }
 
-            std::vector<UInt32>*& list = vertexGroups[point];
+        // get the cell with [key], adding it as [newCell] if there is none yet
+        UInt32 findOrInsert(const UInt32* key, UInt32 newCell) {
+            UInt32 index = hash(key) & this->mask;
+            while (this->slots[index].cell != Empty) {
+                const Slot& slot = this->slots[index];
+                if (slot.key[0] == key[0] && slot.key[1] == key[1] && slot.key[2] == key[2]) return slot.cell;
+                index = (index + 1) & this->mask;
+            }
+            Slot& slot = this->slots[index];
+            slot.key[0] = key[0];
+            slot.key[1] = key[1];
+            slot.key[2] = key[2];
+            slot.cell = newCell;
+            return newCell;
+        }
 
-            if (list == nullptr)list = new(std::nothrow) std::vector<UInt32>();
-            if (list == nullptr) {
-                throw AllocationException("Mesh::buildVertexCrossMap -> Could not allocate sub list.");
+        UInt32 find(const UInt32* key) const {
+            UInt32 index = hash(key) & this->mask;
+            while (this->slots[index].cell != Empty) {
+                const Slot& slot = this->slots[index];
+                if (slot.key[0] == key[0] && slot.key[1] == key[1] && slot.key[2] == key[2]) return slot.cell;
+                index = (index + 1) & this->mask;
             }
+            return Empty;
+        }
 
-            // add the normal at index [v] to the vertex group linked to [point]
-            list->push_back(v);
-            vertexCrossMap[v] = list;
+    private:
+        class Slot {
+        public:
+            UInt32 key[3];
+            UInt32 cell;
+        };
+
+        static UInt32 hash(const UInt32* key) {
+            UInt64 hash = (UInt64)key[0] * 0x9E3779B97F4A7C15ULL;
+            hash = (hash ^ key[1]) * 0xC2B2AE3D27D4EB4FULL;
+            hash = (hash ^ key[2]) * 0x165667B19E3779F9ULL;
+            return (UInt32)(hash >> 32);
         }
 
-        return true;
+        std::vector<Slot> slots;
+        UInt32 mask;
+    };
+
+    const UInt32 CrossMapCellTable::Empty;
+
+    /*
+     * Group the [count] entries of [positions] that are equal according to Vector3Base::Eq. The members of group g are
+     * [groupMembers][[groupStarts][g]] ... [groupMembers][[groupStarts][g + 1] - 1], in ascending order.
+     *
+     * Positions are quantized to cells twice the size of the Eq tolerance, which are found through a hash table.
+     * Walking the positions in order, each one joins the first group whose leading position it equals, looking in its
+     * own cell and, failing that, in the adjacent cells, since two equal positions can straddle a cell boundary.
+     * Otherwise it leads a new group in its cell.
+     */
+    void Mesh::groupEqualPositions(const Point3r* positions, UInt32 count, std::vector<UInt32>& groupStarts, std::vector<UInt32>& groupMembers) {
+        groupStarts.clear();
+        groupMembers.clear();
+        if (count == 0) return;
+
+        std::vector<UInt32> vertexCells;
+        try {
+            vertexCells.resize(count);
+            groupMembers.resize(count);
+        }
+        catch(...) {
+            throw AllocationException("Mesh::groupEqualPositions -> Could not allocate cell map.");
+        }
+
+        // [vertexCells] maps each position to its cell, and [cellTable] each cell's key to the cell
+        CrossMapCellTable cellTable(count);
+        UInt32 cellCount = 0;
+        for (UInt32 v = 0; v < count; v++) {
+            const Point3r& point = positions[v];
+            const UInt32 key[3] = {quantizeCrossMapCoordinate(point.x), quantizeCrossMapCoordinate(point.y), quantizeCrossMapCoordinate(point.z)};
+            vertexCells[v] = cellTable.findOrInsert(key, cellCount);
+            if (vertexCells[v] == cellCount) cellCount++;
+        }
+
+        // groups are identified by their leading (lowest) position; the leaders of each cell form a linked list
+        const UInt32 None = 0xFFFFFFFF;
+        std::vector<UInt32> cellLeaders(cellCount, None);
+        std::vector<UInt32> nextLeader(count, None);
+        std::vector<UInt32> vertexGroups(count);
+        UInt32 groupCount = 0;
+        Vector3Base<Real>::Eq equal;
+
+        auto findGroupInCell = [&](UInt32 cell, const Point3r& point) -> UInt32 {
+            UInt32 found = None;
+            for (UInt32 leader = cellLeaders[cell]; leader != None; leader = nextLeader[leader]) {
+                UInt32 group = vertexGroups[leader];
+                if (equal(positions[leader], point) && (found == None || group < found)) found = group;
+            }
+            return found;
+        };
+
+        for (UInt32 v = 0; v < count; v++) {
+            const Point3r& point = positions[v];
+            UInt32 cell = vertexCells[v];
+            // a position that is not finite equals nothing, so it is left out of the cell's leaders
+            if (!std::isfinite(point.x) || !std::isfinite(point.y) || !std::isfinite(point.z)) {
+                vertexGroups[v] = groupCount++;
+                continue;
+            }
+            UInt32 group = findGroupInCell(cell, point);
+            if (group == None) {
+                // the cells to look in along each axis: its own, and the neighbour on the near side of the
+                // boundary (both neighbours when too close to the middle of the cell to tell reliably)
+                UInt32 key[3];
+                Int32 axisOffsets[3][3];
+                UInt32 axisOffsetCounts[3];
+                const Real coordinates[3] = {point.x, point.y, point.z};
+                for (UInt32 k = 0; k < 3; k++) {
+                    key[k] = quantizeCrossMapCoordinate(coordinates[k]);
+                    axisOffsets[k][0] = 0;
+                    axisOffsetCounts[k] = 1;
+                    if (key[k] == Unquantizable) continue;
+                    Real scaled = coordinates[k] / CrossMapCellSize;
+                    Real fraction = scaled - std::floor(scaled);
+                    if (fraction < 0.51f && key[k] > 0) axisOffsets[k][axisOffsetCounts[k]++] = -1;
+                    if (fraction > 0.49f && key[k] + 1 < Unquantizable) axisOffsets[k][axisOffsetCounts[k]++] = 1;
+                }
+                for (UInt32 i = 0; i < axisOffsetCounts[0]; i++) {
+                    for (UInt32 j = 0; j < axisOffsetCounts[1]; j++) {
+                        for (UInt32 l = 0; l < axisOffsetCounts[2]; l++) {
+                            if (i == 0 && j == 0 && l == 0) continue;
+                            const UInt32 neighbourKey[3] = {key[0] + axisOffsets[0][i], key[1] + axisOffsets[1][j], key[2] + axisOffsets[2][l]};
+                            UInt32 neighbourCell = cellTable.find(neighbourKey);
+                            if (neighbourCell == CrossMapCellTable::Empty) continue;
+                            UInt32 neighbourGroup = findGroupInCell(neighbourCell, point);
+                            if (neighbourGroup != None && (group == None || neighbourGroup < group)) group = neighbourGroup;
+                        }
+                    }
+                }
+            }
+            if (group == None) {
+                group = groupCount++;
+                nextLeader[v] = cellLeaders[cell];
+                cellLeaders[cell] = v;
+            }
+            vertexGroups[v] = group;
+        }
+
+        // counting sort by group; positions are visited in ascending order, so the members of each group stay sorted
+        groupStarts.assign(groupCount + 1, 0);
+        for (UInt32 v = 0; v < count; v++) groupStarts[vertexGroups[v] + 1]++;
+        for (UInt32 g = 0; g < groupCount; g++) groupStarts[g + 1] += groupStarts[g];
+        std::vector<UInt32> groupFill(groupStarts.begin(), groupStarts.end() - 1);
+        for (UInt32 v = 0; v < count; v++) groupMembers[groupFill[vertexGroups[v]]++] = v;
     }
 }
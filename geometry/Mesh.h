@@ -22,6 +22,7 @@ namespace Core {
     class Engine;
     class Object3D;
     class IndexBuffer;
+    class InterleavedVertexBuffer;
 
     class Mesh : public BaseRenderable {
         friend class Engine;
@@ -56,6 +57,17 @@ namespace Core {
         Bool isAttributeEnabled(StandardAttribute attribute);
         Bool isIndexed();
 
+        // Pack all initialized vertex attributes into one strided GPU buffer instead of one buffer per attribute.
+        // The per-attribute arrays keep working as before; their data is scattered into the shared buffer.
+        void setInterleaved(Bool interleaved);
+        Bool isInterleaved() const;
+        std::shared_ptr<InterleavedVertexBuffer> getInterleavedVertexBuffer();
+
+        // Pack the GPU copy of [attribute] in [format] to save vertex memory and bandwidth. The CPU copy stays
+        // in full precision and arrays initialized later use the same format.
+        void setAttributeFormat(StandardAttribute attribute, AttributeFormat format);
+        AttributeFormat getAttributeFormat(StandardAttribute attribute) const;
+
         void calculateBoundingBox();
         const Box3& getBoundingBox() const;
 
@@ -75,6 +87,8 @@ namespace Core {
         void update();
         void reverseVertexAttributeWindingOrder();
 
+        static void groupEqualPositions(const Point3r* positions, UInt32 count, std::vector<UInt32>& groupStarts, std::vector<UInt32>& groupMembers);
+
     protected:
         Mesh(UInt32 vertexCount, UInt32 indexCount);
         void initAttributes();
@@ -83,6 +97,9 @@ namespace Core {
         void calculateTangent(UInt32 vertexIndex, UInt32 rightIndex, UInt32 leftIndex, Vector3r& result);
         void destroyVertexCrossMap();
         Bool buildVertexCrossMap();
+        void buildInterleavedVertexBuffer();
+        void applyAttributeFormats();
+        void releaseInterleavedVertexBuffer();
 
         template <typename T>
         Bool initVertexAttributes(std::shared_ptr<AttributeArray<T>>* attributes, UInt32 vertexCount) {          
@@ -115,8 +132,14 @@ namespace Core {
 
         PersistentWeakPointer<IndexBuffer> indexBuffer;
 
-        // maps vertices to other equal vertices
-        std::vector<UInt32>** vertexCrossMap;
+        Bool interleaved;
+        std::shared_ptr<InterleavedVertexBuffer> interleavedVertexBuffer;
+        AttributeFormat attributeFormats[(UInt32)StandardAttribute::_Count];
+
+        // groups vertices with equal positions: the members of group g are
+        // vertexGroupMembers[vertexGroupStarts[g]] ... vertexGroupMembers[vertexGroupStarts[g + 1] - 1], in ascending order
+        std::vector<UInt32> vertexGroupStarts;
+        std::vector<UInt32> vertexGroupMembers;
         Bool shouldCalculateNormals;
         Bool shouldCalculateTangents;
         Bool shouldCalculateBounds;
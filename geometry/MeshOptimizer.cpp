@@ -0,0 +1,529 @@
+#include <algorithm>
+#include <string.h>
+
+#include "MeshOptimizer.h"
+#include "Mesh.h"
+#include "IndexBuffer.h"
+#include "../Engine.h"
+#include "../animation/VertexBoneMap.h"
+#include "../common/Exception.h"
+#include "../common/Constants.h"
+#include "../math/Math.h"
+
+namespace Core {
+
+    // The skinning data that decides whether two vertices can share an index, without the bone names.
+    class BoneWeightRecord {
+    public:
+        UInt32 uniqueVertexIndex;
+        UInt32 boneCount;
+        UInt32 boneIndex[Constants::MaxBonesPerVertex];
+        Real weight[Constants::MaxBonesPerVertex];
+    };
+
+    template <typename T>
+    static void addVertexStream(WeakPointer<AttributeArray<T>> array, std::vector<MeshOptimizer::VertexStream>& streams) {
+        if (!array.isValid()) return;
+        MeshOptimizer::VertexStream stream;
+        stream.data = (const Byte*)array->getStorage();
+        stream.stride = T::ComponentCount * sizeof(typename T::ComponentType);
+        streams.push_back(stream);
+    }
+
+    template <typename T>
+    static void remapAttribute(WeakPointer<AttributeArray<T>> source, WeakPointer<AttributeArray<T>> dest, const std::vector<UInt32>& sourceVertices) {
+        if (!source.isValid() || !dest.isValid()) return;
+        const typename T::ComponentType* sourceData = source->getStorage();
+        typename T::ComponentType* destData = dest->getStorage();
+        for (UInt32 v = 0; v < sourceVertices.size(); v++) {
+            memcpy(destData + v * T::ComponentCount, sourceData + sourceVertices[v] * T::ComponentCount, sizeof(typename T::ComponentType) * T::ComponentCount);
+        }
+        dest->updateGPUStorageData();
+    }
+
+    const UInt32 MeshOptimizer::InvalidIndex;
+
+    Real MeshOptimizer::Statistics::getACMR() const {
+        return this->triangleCount > 0 ? (Real)this->transformedVertexCount / (Real)this->triangleCount : 0.0f;
+    }
+
+    Real MeshOptimizer::Statistics::getATVR() const {
+        return this->vertexCount > 0 ? (Real)this->transformedVertexCount / (Real)this->vertexCount : 0.0f;
+    }
+
+    void MeshOptimizer::Statistics::add(const Statistics& other) {
+        this->vertexCount += other.vertexCount;
+        this->triangleCount += other.triangleCount;
+        this->transformedVertexCount += other.transformedVertexCount;
+    }
+
+    MeshOptimizer::Result MeshOptimizer::optimizeMesh(WeakPointer<Mesh> mesh, WeakPointer<VertexBoneMap> vertexBoneMap, const Settings& settings) {
+        std::vector<UInt32> indices;
+        std::vector<UInt32> weldedSource;
+        weldVertices(mesh, vertexBoneMap, settings.weldFaceNormals, indices, weldedSource);
+        UInt32 indexCount = (UInt32)indices.size();
+        UInt32 weldedVertexCount = (UInt32)weldedSource.size();
+
+        Result result;
+        result.mesh = mesh;
+        result.vertexBoneMap = vertexBoneMap;
+        if (indexCount == 0) return result;
+
+        // the cache behaviour of the mesh as it was passed in, i.e. before welding
+        std::vector<UInt32> sourceIndices(indexCount);
+        for (UInt32 i = 0; i < indexCount; i++) {
+            sourceIndices[i] = mesh->isIndexed() ? mesh->getIndexBuffer()->getIndex(i) : i;
+        }
+        result.before = analyzeVertexCache(sourceIndices.data(), indexCount, mesh->getVertexCount(), settings.cacheSize);
+
+        const Real* sourcePositions = mesh->getVertexPositions()->getStorage();
+        std::vector<Real> positions(weldedVertexCount * 3);
+        for (UInt32 v = 0; v < weldedVertexCount; v++) {
+            const Real* position = sourcePositions + weldedSource[v] * Point3rs::ComponentCount;
+            positions[v * 3] = position[0];
+            positions[v * 3 + 1] = position[1];
+            positions[v * 3 + 2] = position[2];
+        }
+
+        std::vector<UInt32> optimizedIndices(indexCount);
+        std::vector<UInt32> clusters;
+        optimizeVertexCache(indices.data(), indexCount, weldedVertexCount, settings.cacheSize, optimizedIndices.data(), &clusters);
+        optimizeOverdraw(optimizedIndices.data(), indexCount, positions.data(), 3, weldedVertexCount, clusters, settings.cacheSize, settings.overdrawThreshold);
+
+        std::vector<UInt32> fetchRemap;
+        UInt32 vertexCount = optimizeVertexFetch(optimizedIndices.data(), indexCount, weldedVertexCount, fetchRemap);
+        std::vector<UInt32> sourceVertices(vertexCount);
+        for (UInt32 v = 0; v < weldedVertexCount; v++) {
+            if (fetchRemap[v] != InvalidIndex) sourceVertices[fetchRemap[v]] = weldedSource[v];
+        }
+
+        result.mesh = buildRemappedMesh(mesh, sourceVertices, optimizedIndices);
+        if (vertexBoneMap.isValid()) {
+            result.vertexBoneMap = buildRemappedVertexBoneMap(vertexBoneMap, sourceVertices);
+            Engine::safeReleaseObject(vertexBoneMap);
+        }
+        Engine::safeReleaseObject(mesh);
+
+        result.after = analyzeVertexCache(optimizedIndices.data(), indexCount, vertexCount, settings.cacheSize);
+        return result;
+    }
+
+    void MeshOptimizer::weldVertices(WeakPointer<Mesh> mesh, WeakPointer<VertexBoneMap> vertexBoneMap, Bool weldFaceNormals,
+                                     std::vector<UInt32>& indices, std::vector<UInt32>& sourceVertices) {
+        if (!mesh.isValid() || !mesh->getVertexPositions().isValid()) {
+            throw InvalidArgumentException("MeshOptimizer::weldVertices() -> 'mesh' must be valid and have vertex positions.");
+        }
+        UInt32 sourceVertexCount = mesh->getVertexCount();
+        if (vertexBoneMap.isValid() && vertexBoneMap->getVertexCount() != sourceVertexCount) {
+            throw InvalidArgumentException("MeshOptimizer::weldVertices() -> Vertex bone map does not match mesh.");
+        }
+
+        if (mesh->isIndexed()) {
+            WeakPointer<IndexBuffer> indexBuffer = mesh->getIndexBuffer();
+            indices.resize(mesh->getIndexCount());
+            for (UInt32 i = 0; i < indices.size(); i++) indices[i] = indexBuffer->getIndex(i);
+        }
+        else {
+            indices.resize(sourceVertexCount);
+            for (UInt32 i = 0; i < indices.size(); i++) indices[i] = i;
+        }
+        validateIndices(indices.data(), (UInt32)indices.size(), sourceVertexCount);
+
+        std::vector<VertexStream> streams;
+        addVertexStream(mesh->getVertexPositions(), streams);
+        addVertexStream(mesh->getVertexNormals(), streams);
+        addVertexStream(mesh->getVertexAveragedNormals(), streams);
+        addVertexStream(mesh->getVertexTangents(), streams);
+        addVertexStream(mesh->getVertexColors(), streams);
+        addVertexStream(mesh->getVertexAlbedoUVs(), streams);
+        addVertexStream(mesh->getVertexNormalUVs(), streams);
+        if (!weldFaceNormals) addVertexStream(mesh->getVertexFaceNormals(), streams);
+
+        std::vector<BoneWeightRecord> boneWeights;
+        if (vertexBoneMap.isValid()) {
+            boneWeights.resize(sourceVertexCount);
+            memset(boneWeights.data(), 0, sizeof(BoneWeightRecord) * boneWeights.size());
+            for (UInt32 v = 0; v < sourceVertexCount; v++) {
+                VertexBoneMap::VertexMappingDescriptor * desc = vertexBoneMap->getDescriptor(v);
+                boneWeights[v].uniqueVertexIndex = desc->UniqueVertexIndex;
+                boneWeights[v].boneCount = desc->BoneCount;
+                for (UInt32 b = 0; b < desc->BoneCount && b < Constants::MaxBonesPerVertex; b++) {
+                    boneWeights[v].boneIndex[b] = desc->BoneIndex[b];
+                    boneWeights[v].weight[b] = desc->Weight[b];
+                }
+            }
+            VertexStream stream;
+            stream.data = (const Byte*)boneWeights.data();
+            stream.stride = sizeof(BoneWeightRecord);
+            streams.push_back(stream);
+        }
+
+        std::vector<UInt32> weldRemap;
+        UInt32 weldedVertexCount = generateVertexRemap(streams, sourceVertexCount, weldRemap);
+        for (UInt32& index : indices) index = weldRemap[index];
+
+        // walk backwards so that each welded vertex ends up mapped to its first source vertex
+        sourceVertices.resize(weldedVertexCount);
+        for (UInt32 v = sourceVertexCount; v > 0; v--) sourceVertices[weldRemap[v - 1]] = v - 1;
+    }
+
+    WeakPointer<Mesh> MeshOptimizer::buildRemappedMesh(WeakPointer<Mesh> mesh, const std::vector<UInt32>& sourceVertices, const std::vector<UInt32>& indices) {
+        UInt32 vertexCount = (UInt32)sourceVertices.size();
+        UInt32 indexCount = (UInt32)indices.size();
+        for (UInt32 v = 0; v < vertexCount; v++) {
+            if (sourceVertices[v] >= mesh->getVertexCount()) {
+                throw OutOfRangeException("MeshOptimizer::buildRemappedMesh() -> Source vertex is out of range.");
+            }
+        }
+        validateIndices(indices.data(), indexCount, vertexCount);
+        if (indexCount == 0) {
+            throw InvalidArgumentException("MeshOptimizer::buildRemappedMesh() -> Mesh would have no triangles.");
+        }
+
+        WeakPointer<Mesh> remappedMesh = Engine::instance()->createMesh(vertexCount, indexCount);
+        if (!remappedMesh.isValid()) {
+            throw AllocationException("MeshOptimizer::buildRemappedMesh() -> Unable to create mesh.");
+        }
+        if (mesh->getVertexPositions().isValid()) remappedMesh->initVertexPositions();
+        if (mesh->getVertexNormals().isValid()) remappedMesh->initVertexNormals();
+        if (mesh->getVertexFaceNormals().isValid()) remappedMesh->initVertexFaceNormals();
+        if (mesh->getVertexTangents().isValid()) remappedMesh->initVertexTangents();
+        if (mesh->getVertexColors().isValid()) remappedMesh->initVertexColors();
+        if (mesh->getVertexAlbedoUVs().isValid()) remappedMesh->initVertexAlbedoUVs();
+        if (mesh->getVertexNormalUVs().isValid()) remappedMesh->initVertexNormalUVs();
+        for (UInt32 a = 0; a < (UInt32)StandardAttribute::_Count; a++) {
+            if (a == (UInt32)StandardAttribute::BoneIndex || a == (UInt32)StandardAttribute::BoneWeight) continue;
+            remappedMesh->setAttributeFormat((StandardAttribute)a, mesh->getAttributeFormat((StandardAttribute)a));
+        }
+        if (mesh->isInterleaved()) remappedMesh->setInterleaved(true);
+
+        remapAttribute(mesh->getVertexPositions(), remappedMesh->getVertexPositions(), sourceVertices);
+        remapAttribute(mesh->getVertexNormals(), remappedMesh->getVertexNormals(), sourceVertices);
+        remapAttribute(mesh->getVertexAveragedNormals(), remappedMesh->getVertexAveragedNormals(), sourceVertices);
+        remapAttribute(mesh->getVertexFaceNormals(), remappedMesh->getVertexFaceNormals(), sourceVertices);
+        remapAttribute(mesh->getVertexTangents(), remappedMesh->getVertexTangents(), sourceVertices);
+        remapAttribute(mesh->getVertexColors(), remappedMesh->getVertexColors(), sourceVertices);
+        remapAttribute(mesh->getVertexAlbedoUVs(), remappedMesh->getVertexAlbedoUVs(), sourceVertices);
+        remapAttribute(mesh->getVertexNormalUVs(), remappedMesh->getVertexNormalUVs(), sourceVertices);
+
+        for (UInt32 a = 0; a < (UInt32)StandardAttribute::_Count; a++) {
+            if (mesh->isAttributeEnabled((StandardAttribute)a)) remappedMesh->enableAttribute((StandardAttribute)a);
+        }
+        remappedMesh->getIndexBuffer()->setIndices(const_cast<UInt32*>(indices.data()));
+        remappedMesh->setName(mesh->getName());
+        remappedMesh->setCalculateBounds(true);
+        remappedMesh->update();
+        return remappedMesh;
+    }
+
+    WeakPointer<VertexBoneMap> MeshOptimizer::buildRemappedVertexBoneMap(WeakPointer<VertexBoneMap> vertexBoneMap, const std::vector<UInt32>& sourceVertices) {
+        UInt32 vertexCount = (UInt32)sourceVertices.size();
+        for (UInt32 v = 0; v < vertexCount; v++) {
+            if (sourceVertices[v] >= vertexBoneMap->getVertexCount()) {
+                throw OutOfRangeException("MeshOptimizer::buildRemappedVertexBoneMap() -> Source vertex is out of range.");
+            }
+        }
+
+        WeakPointer<VertexBoneMap> remappedBoneMap = Engine::instance()->createVertexBoneMap(vertexCount, vertexBoneMap->getUniqueVertexCount());
+        for (UInt32 v = 0; v < vertexCount; v++) {
+            remappedBoneMap->getDescriptor(v)->copy(vertexBoneMap->getDescriptor(sourceVertices[v]));
+        }
+        remappedBoneMap->setWeightFormat(vertexBoneMap->getWeightFormat());
+        remappedBoneMap->setIndexFormat(vertexBoneMap->getIndexFormat());
+        return remappedBoneMap;
+    }
+
+    /**
+     * Simulate a FIFO post-transform cache of [cacheSize] entries over the triangle list [indices].
+     */
+    MeshOptimizer::Statistics MeshOptimizer::analyzeVertexCache(const UInt32* indices, UInt32 indexCount, UInt32 vertexCount, UInt32 cacheSize) {
+        validateIndices(indices, indexCount, vertexCount);
+
+        Statistics stats;
+        stats.triangleCount = indexCount / 3;
+        std::vector<UInt32> timestamps(vertexCount, 0);
+        std::vector<Byte> referenced(vertexCount, 0);
+        UInt32 time = cacheSize + 1;
+        for (UInt32 i = 0; i < indexCount; i++) {
+            UInt32 vertex = indices[i];
+            if (!referenced[vertex]) {
+                referenced[vertex] = 1;
+                stats.vertexCount++;
+            }
+            if (time - timestamps[vertex] > cacheSize) {
+                timestamps[vertex] = time++;
+                stats.transformedVertexCount++;
+            }
+        }
+        return stats;
+    }
+
+    /**
+     * Assign the same index to all vertices that are bitwise identical across [streams]. [remap] receives the
+     * new index of every vertex, in order of first occurrence; the number of unique vertices is returned.
+     */
+    UInt32 MeshOptimizer::generateVertexRemap(const std::vector<VertexStream>& streams, UInt32 vertexCount, std::vector<UInt32>& remap) {
+        remap.assign(vertexCount, InvalidIndex);
+
+        auto hashVertex = [&streams](UInt32 vertex) -> UInt64 {
+            UInt64 hash = 14695981039346656037ULL;
+            for (const VertexStream& stream : streams) {
+                const Byte* data = stream.data + (UInt64)vertex * stream.stride;
+                for (UInt32 b = 0; b < stream.stride; b++) {
+                    hash ^= data[b];
+                    hash *= 1099511628211ULL;
+                }
+            }
+            return hash;
+        };
+        auto equalVertices = [&streams](UInt32 a, UInt32 b) -> Bool {
+            for (const VertexStream& stream : streams) {
+                if (memcmp(stream.data + (UInt64)a * stream.stride, stream.data + (UInt64)b * stream.stride, stream.stride) != 0) return false;
+            }
+            return true;
+        };
+
+        // open addressing with linear probing, kept at most half full
+        UInt32 tableSize = 16;
+        while (tableSize < vertexCount * 2) tableSize *= 2;
+        std::vector<UInt32> table(tableSize, InvalidIndex);
+
+        UInt32 uniqueCount = 0;
+        for (UInt32 v = 0; v < vertexCount; v++) {
+            UInt32 slot = (UInt32)(hashVertex(v) & (tableSize - 1));
+            while (table[slot] != InvalidIndex && !equalVertices(table[slot], v)) {
+                slot = (slot + 1) & (tableSize - 1);
+            }
+            if (table[slot] == InvalidIndex) {
+                table[slot] = v;
+                remap[v] = uniqueCount++;
+            }
+            else {
+                remap[v] = remap[table[slot]];
+            }
+        }
+        return uniqueCount;
+    }
+
+    /**
+     * Reorder the triangles in [indices] for vertex cache locality using Tipsify (Sander, Nehab & Barczak,
+     * "Fast Triangle Reordering for Vertex Locality and Reduced Overdraw"). The result is written to
+     * [destination]. If [clusters] is not null, it receives the first triangle of each run that Tipsify
+     * produced without a cache flush; those runs are the hard cluster boundaries used by optimizeOverdraw().
+     */
+    void MeshOptimizer::optimizeVertexCache(const UInt32* indices, UInt32 indexCount, UInt32 vertexCount, UInt32 cacheSize,
+                                            UInt32* destination, std::vector<UInt32>* clusters) {
+        validateIndices(indices, indexCount, vertexCount);
+        UInt32 triangleCount = indexCount / 3;
+        if (clusters != nullptr) clusters->clear();
+        if (triangleCount == 0) return;
+
+        // triangles adjacent to each vertex, and the number of those that have not been emitted yet
+        std::vector<UInt32> liveTriangles(vertexCount, 0);
+        for (UInt32 i = 0; i < indexCount; i++) liveTriangles[indices[i]]++;
+        std::vector<UInt32> adjacencyOffsets(vertexCount + 1, 0);
+        for (UInt32 v = 0; v < vertexCount; v++) adjacencyOffsets[v + 1] = adjacencyOffsets[v] + liveTriangles[v];
+        std::vector<UInt32> adjacency(indexCount);
+        std::vector<UInt32> adjacencyFill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+        for (UInt32 i = 0; i < indexCount; i++) adjacency[adjacencyFill[indices[i]]++] = i / 3;
+
+        std::vector<UInt32> timestamps(vertexCount, 0);
+        std::vector<Byte> emitted(triangleCount, 0);
+        std::vector<UInt32> deadEnd;
+        std::vector<UInt32> candidates;
+        deadEnd.reserve(indexCount);
+        UInt32 time = cacheSize + 1;
+        UInt32 cursor = 0;
+        UInt32 outputTriangle = 0;
+
+        UInt32 fanningVertex = indices[0];
+        if (clusters != nullptr) clusters->push_back(0);
+        while (fanningVertex != InvalidIndex) {
+            candidates.clear();
+            for (UInt32 a = adjacencyOffsets[fanningVertex]; a < adjacencyOffsets[fanningVertex + 1]; a++) {
+                UInt32 triangle = adjacency[a];
+                if (emitted[triangle]) continue;
+                for (UInt32 k = 0; k < 3; k++) {
+                    UInt32 vertex = indices[triangle * 3 + k];
+                    destination[outputTriangle * 3 + k] = vertex;
+                    deadEnd.push_back(vertex);
+                    candidates.push_back(vertex);
+                    liveTriangles[vertex]--;
+                    if (time - timestamps[vertex] > cacheSize) timestamps[vertex] = time++;
+                }
+                emitted[triangle] = 1;
+                outputTriangle++;
+            }
+
+            // prefer the candidate that will still be in the cache after its remaining triangles are emitted
+            UInt32 nextVertex = InvalidIndex;
+            Int32 bestPriority = -1;
+            for (UInt32 vertex : candidates) {
+                if (liveTriangles[vertex] == 0) continue;
+                Int32 priority = 0;
+                if (time - timestamps[vertex] + 2 * liveTriangles[vertex] <= cacheSize) priority = (Int32)(time - timestamps[vertex]);
+                if (priority > bestPriority) {
+                    bestPriority = priority;
+                    nextVertex = vertex;
+                }
+            }
+
+            if (nextVertex == InvalidIndex) {
+                if (clusters != nullptr && outputTriangle < triangleCount) clusters->push_back(outputTriangle);
+                while (deadEnd.size() > 0 && nextVertex == InvalidIndex) {
+                    UInt32 vertex = deadEnd.back();
+                    deadEnd.pop_back();
+                    if (liveTriangles[vertex] > 0) nextVertex = vertex;
+                }
+                while (cursor < vertexCount && nextVertex == InvalidIndex) {
+                    if (liveTriangles[cursor] > 0) nextVertex = cursor;
+                    cursor++;
+                }
+            }
+            fanningVertex = nextVertex;
+        }
+    }
+
+    /**
+     * Split the hard [clusters] of a vertex cache optimized triangle list into smaller clusters wherever that
+     * costs at most [threshold] times the cluster's cache miss ratio, then draw the clusters in order of how far
+     * they face away from the mesh centre. Clusters on the outside of the mesh go first and occlude the rest.
+     */
+    void MeshOptimizer::optimizeOverdraw(UInt32* indices, UInt32 indexCount, const Real* positions, UInt32 positionStride, UInt32 vertexCount,
+                                         const std::vector<UInt32>& clusters, UInt32 cacheSize, Real threshold) {
+        validateIndices(indices, indexCount, vertexCount);
+        UInt32 triangleCount = indexCount / 3;
+        if (triangleCount == 0) return;
+
+        std::vector<UInt32> timestamps(vertexCount, 0);
+        UInt32 time = cacheSize + 1;
+        auto countMisses = [&](UInt32 triangle) -> UInt32 {
+            UInt32 misses = 0;
+            for (UInt32 k = 0; k < 3; k++) {
+                UInt32 vertex = indices[triangle * 3 + k];
+                if (time - timestamps[vertex] > cacheSize) {
+                    timestamps[vertex] = time++;
+                    misses++;
+                }
+            }
+            return misses;
+        };
+
+        std::vector<UInt32> softClusters;
+        std::vector<UInt32> hardClusters = clusters;
+        if (hardClusters.size() == 0 || hardClusters[0] != 0) hardClusters.insert(hardClusters.begin(), 0);
+        for (UInt32 c = 0; c < hardClusters.size(); c++) {
+            UInt32 start = hardClusters[c];
+            UInt32 end = c + 1 < hardClusters.size() ? hardClusters[c + 1] : triangleCount;
+            if (start >= end) continue;
+
+            time += cacheSize + 1;
+            UInt32 clusterMisses = 0;
+            for (UInt32 t = start; t < end; t++) clusterMisses += countMisses(t);
+            Real clusterThreshold = threshold * (Real)clusterMisses / (Real)(end - start);
+
+            time += cacheSize + 1;
+            softClusters.push_back(start);
+            UInt32 softStart = start;
+            UInt32 misses = 0;
+            for (UInt32 t = start; t < end; t++) {
+                misses += countMisses(t);
+                if (t + 1 < end && (Real)misses / (Real)(t - softStart + 1) <= clusterThreshold) {
+                    softClusters.push_back(t + 1);
+                    softStart = t + 1;
+                    misses = 0;
+                    time += cacheSize + 1;
+                }
+            }
+        }
+
+        auto getPosition = [positions, positionStride, indices](UInt32 index, UInt32 component) -> Real {
+            return positions[indices[index] * positionStride + component];
+        };
+
+        Real meshCentroid[3] = {0.0f, 0.0f, 0.0f};
+        for (UInt32 i = 0; i < indexCount; i++) {
+            for (UInt32 k = 0; k < 3; k++) meshCentroid[k] += getPosition(i, k);
+        }
+        for (UInt32 k = 0; k < 3; k++) meshCentroid[k] /= (Real)indexCount;
+
+        std::vector<Real> sortKeys(softClusters.size());
+        for (UInt32 c = 0; c < softClusters.size(); c++) {
+            UInt32 start = softClusters[c];
+            UInt32 end = c + 1 < softClusters.size() ? softClusters[c + 1] : triangleCount;
+
+            // area weighted centroid and normal of the cluster; the normal uses the engine's front face winding
+            Real centroid[3] = {0.0f, 0.0f, 0.0f};
+            Real normal[3] = {0.0f, 0.0f, 0.0f};
+            Real totalArea = 0.0f;
+            for (UInt32 t = start; t < end; t++) {
+                Real a[3], b[3], cross[3];
+                for (UInt32 k = 0; k < 3; k++) {
+                    a[k] = getPosition(t * 3 + 2, k) - getPosition(t * 3, k);
+                    b[k] = getPosition(t * 3 + 1, k) - getPosition(t * 3, k);
+                }
+                cross[0] = a[1] * b[2] - a[2] * b[1];
+                cross[1] = a[2] * b[0] - a[0] * b[2];
+                cross[2] = a[0] * b[1] - a[1] * b[0];
+                Real area = Math::squareRoot(cross[0] * cross[0] + cross[1] * cross[1] + cross[2] * cross[2]);
+                for (UInt32 k = 0; k < 3; k++) {
+                    centroid[k] += area * (getPosition(t * 3, k) + getPosition(t * 3 + 1, k) + getPosition(t * 3 + 2, k)) / 3.0f;
+                    normal[k] += cross[k];
+                }
+                totalArea += area;
+            }
+
+            Real normalLength = Math::squareRoot(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+            Real key = 0.0f;
+            if (totalArea > 0.0f && normalLength > 0.0f) {
+                for (UInt32 k = 0; k < 3; k++) {
+                    key += (centroid[k] / totalArea - meshCentroid[k]) * normal[k] / normalLength;
+                }
+            }
+            sortKeys[c] = key;
+        }
+
+        std::vector<UInt32> order(softClusters.size());
+        for (UInt32 c = 0; c < order.size(); c++) order[c] = c;
+        std::stable_sort(order.begin(), order.end(), [&sortKeys](UInt32 a, UInt32 b) {
+            return sortKeys[a] > sortKeys[b];
+        });
+
+        std::vector<UInt32> source(indices, indices + indexCount);
+        UInt32 offset = 0;
+        for (UInt32 c : order) {
+            UInt32 start = softClusters[c];
+            UInt32 end = c + 1 < softClusters.size() ? softClusters[c + 1] : triangleCount;
+            memcpy(indices + offset, source.data() + start * 3, sizeof(UInt32) * (end - start) * 3);
+            offset += (end - start) * 3;
+        }
+    }
+
+    /**
+     * Renumber vertices in the order [indices] first references them, so vertex fetches walk memory
+     * linearly. [remap] receives the new index of each vertex (InvalidIndex for unreferenced ones), and
+     * the number of referenced vertices is returned.
+     */
+    UInt32 MeshOptimizer::optimizeVertexFetch(UInt32* indices, UInt32 indexCount, UInt32 vertexCount, std::vector<UInt32>& remap) {
+        validateIndices(indices, indexCount, vertexCount);
+        remap.assign(vertexCount, InvalidIndex);
+        UInt32 nextVertex = 0;
+        for (UInt32 i = 0; i < indexCount; i++) {
+            UInt32& mapped = remap[indices[i]];
+            if (mapped == InvalidIndex) mapped = nextVertex++;
+            indices[i] = mapped;
+        }
+        return nextVertex;
+    }
+
+    void MeshOptimizer::validateIndices(const UInt32* indices, UInt32 indexCount, UInt32 vertexCount) {
+        if (indexCount % 3 != 0) {
+            throw InvalidArgumentException("MeshOptimizer::validateIndices() -> Index count must be a multiple of 3.");
+        }
+        for (UInt32 i = 0; i < indexCount; i++) {
+            if (indices[i] >= vertexCount) {
+                throw OutOfRangeException("MeshOptimizer::validateIndices() -> Index is out of range.");
+            }
+        }
+    }
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <vector>
+
+#include "../common/types.h"
+#include "../util/WeakPointer.h"
+
+namespace Core {
+
+    // forward declarations
+    class Mesh;
+    class VertexBoneMap;
+
+    // Import-time reordering of mesh geometry for the GPU. Identical vertices are welded into an index
+    // buffer, triangles are reordered for the post-transform vertex cache (Tipsify, Sander et al. 2007),
+    // clusters of triangles are then sorted so that outward facing parts of the mesh are drawn first to
+    // reduce overdraw, and finally vertices are laid out in the order they are first referenced.
+    //
+    // The index-level functions only work on plain arrays so they can be used (and verified) without a
+    // graphics context; optimizeMesh() applies the whole pipeline to a Mesh and its VertexBoneMap.
+    class MeshOptimizer {
+    public:
+        static const UInt32 InvalidIndex = 0xFFFFFFFF;
+
+        class Settings {
+        public:
+            Settings() {
+                this->cacheSize = 16;
+                this->overdrawThreshold = 1.05f;
+                this->weldFaceNormals = false;
+            }
+
+            // size of the simulated FIFO post-transform cache
+            UInt32 cacheSize;
+            // how much the vertex cache efficiency of a cluster may degrade in exchange for finer overdraw sorting
+            Real overdrawThreshold;
+            // face normals differ for every triangle, so by default they keep vertices of neighbouring triangles
+            // from being shared. When set, vertices that differ only in their face normal are welded and keep
+            // the face normal of the first triangle that references them.
+            Bool weldFaceNormals;
+        };
+
+        class Statistics {
+        public:
+            Statistics() {
+                this->vertexCount = 0;
+                this->triangleCount = 0;
+                this->transformedVertexCount = 0;
+            }
+
+            // average cache miss ratio: vertex shader invocations per triangle
+            Real getACMR() const;
+            // average transformed vertex ratio: vertex shader invocations per vertex
+            Real getATVR() const;
+            void add(const Statistics& other);
+
+            UInt32 vertexCount;
+            UInt32 triangleCount;
+            UInt32 transformedVertexCount;
+        };
+
+        class Result {
+        public:
+            WeakPointer<Mesh> mesh;
+            WeakPointer<VertexBoneMap> vertexBoneMap;
+            Statistics before;
+            Statistics after;
+        };
+
+        // One per-vertex input to vertex welding; [stride] bytes per vertex are compared.
+        class VertexStream {
+        public:
+            const Byte* data;
+            UInt32 stride;
+        };
+
+        // Build an optimized copy of [mesh] (and of [vertexBoneMap], if valid). The source objects are released.
+        static Result optimizeMesh(WeakPointer<Mesh> mesh, WeakPointer<VertexBoneMap> vertexBoneMap, const Settings& settings);
+
+        // Weld the vertices of [mesh] (and [vertexBoneMap], if valid) that are bitwise identical. [indices] receives the mesh's
+        // triangles in welded vertex space and [sourceVertices] the first source vertex of each welded vertex.
+        static void weldVertices(WeakPointer<Mesh> mesh, WeakPointer<VertexBoneMap> vertexBoneMap, Bool weldFaceNormals,
+                                 std::vector<UInt32>& indices, std::vector<UInt32>& sourceVertices);
+        // Build an indexed copy of [mesh] whose vertex i is a copy of source vertex [sourceVertices][i].
+        static WeakPointer<Mesh> buildRemappedMesh(WeakPointer<Mesh> mesh, const std::vector<UInt32>& sourceVertices, const std::vector<UInt32>& indices);
+        static WeakPointer<VertexBoneMap> buildRemappedVertexBoneMap(WeakPointer<VertexBoneMap> vertexBoneMap, const std::vector<UInt32>& sourceVertices);
+
+        static Statistics analyzeVertexCache(const UInt32* indices, UInt32 indexCount, UInt32 vertexCount, UInt32 cacheSize);
+        static UInt32 generateVertexRemap(const std::vector<VertexStream>& streams, UInt32 vertexCount, std::vector<UInt32>& remap);
+        static void optimizeVertexCache(const UInt32* indices, UInt32 indexCount, UInt32 vertexCount, UInt32 cacheSize,
+                                        UInt32* destination, std::vector<UInt32>* clusters);
+        static void optimizeOverdraw(UInt32* indices, UInt32 indexCount, const Real* positions, UInt32 positionStride, UInt32 vertexCount,
+                                     const std::vector<UInt32>& clusters, UInt32 cacheSize, Real threshold);
+        static UInt32 optimizeVertexFetch(UInt32* indices, UInt32 indexCount, UInt32 vertexCount, std::vector<UInt32>& remap);
+
+    private:
+        MeshOptimizer();
+        static void validateIndices(const UInt32* indices, UInt32 indexCount, UInt32 vertexCount);
+    };
+}
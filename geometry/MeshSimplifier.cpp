@@ -0,0 +1,460 @@
+#include <algorithm>
+#include <float.h>
+#include <math.h>
+#include <string.h>
+
+#include "MeshSimplifier.h"
+#include "MeshOptimizer.h"
+#include "Mesh.h"
+#include "../Engine.h"
+#include "../animation/VertexBoneMap.h"
+#include "../common/Exception.h"
+#include "../math/Math.h"
+
+namespace Core {
+
+    // edges along borders and seams get a perpendicular plane quadric of this relative weight,
+    // so collapses that would pull them out of shape are expensive
+    static const double SimplifierBoundaryWeight = 10.0;
+
+    enum class SimplifierVertexKind {
+        // interior vertex with a single set of attributes; may collapse into any neighbour
+        Manifold = 0,
+        // vertex on an open border; may only collapse along the border
+        Border = 1,
+        // one of two vertices sharing a position; collapses along the seam together with its partner
+        Seam = 2,
+        // never removed
+        Locked = 3
+    };
+
+    // symmetric 4x4 error quadric, accumulated in double precision
+    class SimplifierQuadric {
+    public:
+        SimplifierQuadric() {
+            memset(this->q, 0, sizeof(this->q));
+            this->weight = 0.0;
+        }
+
+        void addPlane(double a, double b, double c, double d, double w) {
+            this->q[0] += a * a * w;
+            this->q[1] += b * b * w;
+            this->q[2] += c * c * w;
+            this->q[3] += a * b * w;
+            this->q[4] += a * c * w;
+            this->q[5] += b * c * w;
+            this->q[6] += a * d * w;
+            this->q[7] += b * d * w;
+            this->q[8] += c * d * w;
+            this->q[9] += d * d * w;
+            this->weight += w;
+        }
+
+        void add(const SimplifierQuadric& other) {
+            for (UInt32 i = 0; i < 10; i++) this->q[i] += other.q[i];
+            this->weight += other.weight;
+        }
+
+        // weighted mean of the squared distances from [point] to the accumulated planes
+        double evaluate(const double* point) const {
+            double x = point[0], y = point[1], z = point[2];
+            double r = this->q[0] * x * x + this->q[1] * y * y + this->q[2] * z * z +
+                       2.0 * (this->q[3] * x * y + this->q[4] * x * z + this->q[5] * y * z) +
+                       2.0 * (this->q[6] * x + this->q[7] * y + this->q[8] * z) + this->q[9];
+            return this->weight > 0.0 ? fabs(r) / this->weight : 0.0;
+        }
+
+        double q[10];
+        double weight;
+    };
+
+    class SimplifierCollapse {
+    public:
+        UInt32 from;
+        UInt32 to;
+        double error;
+    };
+
+    static void cross(const double* a, const double* b, double* result) {
+        result[0] = a[1] * b[2] - a[2] * b[1];
+        result[1] = a[2] * b[0] - a[0] * b[2];
+        result[2] = a[0] * b[1] - a[1] * b[0];
+    }
+
+    static double dot(const double* a, const double* b) {
+        return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+    }
+
+    static void triangleNormal(const double* p0, const double* p1, const double* p2, double* result) {
+        double e0[3] = {p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2]};
+        double e1[3] = {p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2]};
+        cross(e0, e1, result);
+    }
+
+    // Triangles adjacent to each node, where a node is either a vertex ([map] is null) or a position.
+    class SimplifierAdjacency {
+    public:
+        void build(const UInt32* indices, UInt32 indexCount, const UInt32* map, UInt32 nodeCount) {
+            this->indices = indices;
+            this->map = map;
+            this->offsets.assign(nodeCount + 1, 0);
+            for (UInt32 i = 0; i < indexCount; i++) this->offsets[this->getNode(i) + 1]++;
+            for (UInt32 n = 0; n < nodeCount; n++) this->offsets[n + 1] += this->offsets[n];
+            this->triangles.resize(indexCount);
+            std::vector<UInt32> fill(this->offsets.begin(), this->offsets.end() - 1);
+            for (UInt32 i = 0; i < indexCount; i++) this->triangles[fill[this->getNode(i)]++] = i / 3;
+        }
+
+        UInt32 getNode(UInt32 index) const {
+            return this->map != nullptr ? this->map[this->indices[index]] : this->indices[index];
+        }
+
+        UInt32 getTriangleCount(UInt32 node) const {
+            return this->offsets[node + 1] - this->offsets[node];
+        }
+
+        // find the corner of [triangle] that belongs to [node]
+        UInt32 getCorner(UInt32 triangle, UInt32 node) const {
+            for (UInt32 k = 0; k < 3; k++) {
+                if (this->getNode(triangle * 3 + k) == node) return k;
+            }
+            return 0;
+        }
+
+        // true if some triangle has the directed edge [a] -> [b]
+        Bool hasEdge(UInt32 a, UInt32 b) const {
+            for (UInt32 t = this->offsets[a]; t < this->offsets[a + 1]; t++) {
+                UInt32 triangle = this->triangles[t];
+                UInt32 corner = this->getCorner(triangle, a);
+                if (this->getNode(triangle * 3 + (corner + 1) % 3) == b) return true;
+            }
+            return false;
+        }
+
+        // count the edges leaving and entering [node] that have no twin in the opposite direction
+        void countOpenEdges(UInt32 node, UInt32& outgoing, UInt32& incoming) const {
+            outgoing = 0;
+            incoming = 0;
+            for (UInt32 t = this->offsets[node]; t < this->offsets[node + 1]; t++) {
+                UInt32 triangle = this->triangles[t];
+                UInt32 corner = this->getCorner(triangle, node);
+                UInt32 next = this->getNode(triangle * 3 + (corner + 1) % 3);
+                UInt32 previous = this->getNode(triangle * 3 + (corner + 2) % 3);
+                if (!this->hasEdge(next, node)) outgoing++;
+                if (!this->hasEdge(node, previous)) incoming++;
+            }
+        }
+
+        const UInt32* indices;
+        const UInt32* map;
+        std::vector<UInt32> offsets;
+        std::vector<UInt32> triangles;
+    };
+
+    std::vector<MeshSimplifier::LODLevel> MeshSimplifier::buildLODChain(WeakPointer<Mesh> mesh, WeakPointer<VertexBoneMap> vertexBoneMap, const Settings& settings) {
+        std::vector<LODLevel> levels;
+        std::vector<UInt32> indices;
+        std::vector<UInt32> sourceVertices;
+        MeshOptimizer::weldVertices(mesh, vertexBoneMap, true, indices, sourceVertices);
+        UInt32 indexCount = (UInt32)indices.size();
+        UInt32 vertexCount = (UInt32)sourceVertices.size();
+        if (indexCount == 0) return levels;
+
+        const Real* sourcePositions = mesh->getVertexPositions()->getStorage();
+        std::vector<Real> positions(vertexCount * 3);
+        for (UInt32 v = 0; v < vertexCount; v++) {
+            const Real* position = sourcePositions + sourceVertices[v] * Point3rs::ComponentCount;
+            positions[v * 3] = position[0];
+            positions[v * 3 + 1] = position[1];
+            positions[v * 3 + 2] = position[2];
+        }
+
+        // every level is simplified from the full mesh, so its error is measured against the source
+        std::vector<UInt32> simplified(indexCount);
+        UInt32 previousIndexCount = indexCount;
+        Real previousScreenSize = FLT_MAX;
+        Real targetRatio = 1.0f;
+        for (UInt32 l = 0; l < settings.levelCount; l++) {
+            targetRatio *= settings.reductionRatio;
+            UInt32 targetIndexCount = (UInt32)((Real)(indexCount / 3) * targetRatio) * 3;
+            Real error = 0.0f;
+            UInt32 simplifiedCount = simplify(simplified.data(), indices.data(), indexCount, positions.data(), 3, vertexCount,
+                                              targetIndexCount, settings.maxError, &error);
+
+            // once simplification stalls, further levels would look the same as the last one
+            if (simplifiedCount == 0 || (UInt64)simplifiedCount * 10 > (UInt64)previousIndexCount * 9) break;
+
+            std::vector<UInt32> levelIndices(simplifiedCount);
+            MeshOptimizer::optimizeVertexCache(simplified.data(), simplifiedCount, vertexCount, MeshOptimizer::Settings().cacheSize, levelIndices.data(), nullptr);
+            std::vector<UInt32> fetchRemap;
+            UInt32 levelVertexCount = MeshOptimizer::optimizeVertexFetch(levelIndices.data(), simplifiedCount, vertexCount, fetchRemap);
+            std::vector<UInt32> levelSourceVertices(levelVertexCount);
+            for (UInt32 v = 0; v < vertexCount; v++) {
+                if (fetchRemap[v] != MeshOptimizer::InvalidIndex) levelSourceVertices[fetchRemap[v]] = sourceVertices[v];
+            }
+
+            LODLevel level;
+            level.mesh = MeshOptimizer::buildRemappedMesh(mesh, levelSourceVertices, levelIndices);
+            if (vertexBoneMap.isValid()) {
+                level.vertexBoneMap = MeshOptimizer::buildRemappedVertexBoneMap(vertexBoneMap, levelSourceVertices);
+            }
+            level.error = error;
+
+            // the error is relative to the mesh extent, which never exceeds the bounding sphere's projected
+            // size, so at [screenSize] the level deviates by at most [maxScreenError] pixels
+            Real screenSize = error > 0.0f ? settings.maxScreenError / error : FLT_MAX;
+            level.screenSize = screenSize < previousScreenSize ? screenSize : previousScreenSize;
+            previousScreenSize = level.screenSize;
+
+            levels.push_back(level);
+            previousIndexCount = simplifiedCount;
+        }
+        return levels;
+    }
+
+    UInt32 MeshSimplifier::simplify(UInt32* destination, const UInt32* indices, UInt32 indexCount, const Real* positions, UInt32 positionStride,
+                                    UInt32 vertexCount, UInt32 targetIndexCount, Real targetError, Real* resultError) {
+        if (indexCount % 3 != 0) {
+            throw InvalidArgumentException("MeshSimplifier::simplify() -> Index count must be a multiple of 3.");
+        }
+        for (UInt32 i = 0; i < indexCount; i++) {
+            if (indices[i] >= vertexCount) throw OutOfRangeException("MeshSimplifier::simplify() -> Index is out of range.");
+        }
+        if (resultError != nullptr) *resultError = 0.0f;
+        if (destination != indices) memmove(destination, indices, sizeof(UInt32) * indexCount);
+        if (indexCount <= targetIndexCount) return indexCount;
+
+        // positions are normalized to the unit cube so that errors are relative to the mesh extent
+        double minimum[3] = {DBL_MAX, DBL_MAX, DBL_MAX};
+        double maximum[3] = {-DBL_MAX, -DBL_MAX, -DBL_MAX};
+        for (UInt32 v = 0; v < vertexCount; v++) {
+            for (UInt32 k = 0; k < 3; k++) {
+                double value = positions[v * positionStride + k];
+                if (value < minimum[k]) minimum[k] = value;
+                if (value > maximum[k]) maximum[k] = value;
+            }
+        }
+        double extent = 0.0;
+        for (UInt32 k = 0; k < 3; k++) extent = maximum[k] - minimum[k] > extent ? maximum[k] - minimum[k] : extent;
+        if (extent <= 0.0) extent = 1.0;
+        std::vector<double> points(vertexCount * 3);
+        std::vector<Real> exactPositions(vertexCount * 3);
+        for (UInt32 v = 0; v < vertexCount; v++) {
+            for (UInt32 k = 0; k < 3; k++) {
+                exactPositions[v * 3 + k] = positions[v * positionStride + k];
+                points[v * 3 + k] = (positions[v * positionStride + k] - minimum[k]) / extent;
+            }
+        }
+
+        // vertices that share a position are wedges of the same corner
+        std::vector<MeshOptimizer::VertexStream> positionStreams(1);
+        positionStreams[0].data = (const Byte*)exactPositions.data();
+        positionStreams[0].stride = sizeof(Real) * 3;
+        std::vector<UInt32> positionRemap;
+        UInt32 positionCount = MeshOptimizer::generateVertexRemap(positionStreams, vertexCount, positionRemap);
+
+        auto removeDegenerateTriangles = [&positionRemap](UInt32* triangleIndices, UInt32 count) -> UInt32 {
+            UInt32 written = 0;
+            for (UInt32 i = 0; i < count; i += 3) {
+                UInt32 a = triangleIndices[i], b = triangleIndices[i + 1], c = triangleIndices[i + 2];
+                if (positionRemap[a] == positionRemap[b] || positionRemap[b] == positionRemap[c] || positionRemap[a] == positionRemap[c]) continue;
+                triangleIndices[written++] = a;
+                triangleIndices[written++] = b;
+                triangleIndices[written++] = c;
+            }
+            return written;
+        };
+        UInt32 currentIndexCount = removeDegenerateTriangles(destination, indexCount);
+
+        SimplifierAdjacency vertexAdjacency;
+        SimplifierAdjacency positionAdjacency;
+        vertexAdjacency.build(destination, currentIndexCount, nullptr, vertexCount);
+
+        // face planes weighted by area, plus perpendicular planes along every border and seam edge
+        std::vector<SimplifierQuadric> quadrics(positionCount);
+        for (UInt32 i = 0; i < currentIndexCount; i += 3) {
+            const double* p[3] = {&points[destination[i] * 3], &points[destination[i + 1] * 3], &points[destination[i + 2] * 3]};
+            double normal[3];
+            triangleNormal(p[0], p[1], p[2], normal);
+            double length = sqrt(dot(normal, normal));
+            if (length <= 0.0) continue;
+            for (UInt32 k = 0; k < 3; k++) normal[k] /= length;
+            double d = -dot(normal, p[0]);
+            for (UInt32 k = 0; k < 3; k++) {
+                quadrics[positionRemap[destination[i + k]]].addPlane(normal[0], normal[1], normal[2], d, length * 0.5);
+            }
+
+            for (UInt32 k = 0; k < 3; k++) {
+                UInt32 a = destination[i + k];
+                UInt32 b = destination[i + (k + 1) % 3];
+                if (vertexAdjacency.hasEdge(b, a)) continue;
+                const double* pa = p[k];
+                const double* pb = p[(k + 1) % 3];
+                double edge[3] = {pb[0] - pa[0], pb[1] - pa[1], pb[2] - pa[2]};
+                double edgePlane[3];
+                cross(edge, normal, edgePlane);
+                double edgePlaneLength = sqrt(dot(edgePlane, edgePlane));
+                if (edgePlaneLength <= 0.0) continue;
+                for (UInt32 c = 0; c < 3; c++) edgePlane[c] /= edgePlaneLength;
+                double edgeD = -dot(edgePlane, pa);
+                double weight = dot(edge, edge) * SimplifierBoundaryWeight;
+                quadrics[positionRemap[a]].addPlane(edgePlane[0], edgePlane[1], edgePlane[2], edgeD, weight);
+                quadrics[positionRemap[b]].addPlane(edgePlane[0], edgePlane[1], edgePlane[2], edgeD, weight);
+            }
+        }
+
+        std::vector<SimplifierVertexKind> kinds(vertexCount);
+        std::vector<UInt32> otherWedge(vertexCount);
+        std::vector<UInt32> wedgeCounts(positionCount);
+        std::vector<UInt32> firstWedge(positionCount);
+        std::vector<UInt32> collapseRemap(vertexCount);
+        std::vector<Byte> touched(positionCount);
+        std::vector<SimplifierCollapse> collapses;
+        double errorLimit = (double)targetError * (double)targetError;
+        double maxError = 0.0;
+
+        // triangles whose normal would turn by more than ~75 degrees reject the collapse
+        auto collapseFlipsTriangles = [&](UInt32 from, UInt32 to) -> Bool {
+            UInt32 toPosition = positionRemap[to];
+            for (UInt32 t = vertexAdjacency.offsets[from]; t < vertexAdjacency.offsets[from + 1]; t++) {
+                UInt32 triangle = vertexAdjacency.triangles[t];
+                const double* before[3];
+                const double* after[3];
+                Bool degenerate = false;
+                for (UInt32 k = 0; k < 3; k++) {
+                    UInt32 vertex = destination[triangle * 3 + k];
+                    if (positionRemap[vertex] == toPosition) degenerate = true;
+                    before[k] = &points[vertex * 3];
+                    after[k] = vertex == from ? &points[to * 3] : before[k];
+                }
+                if (degenerate) continue;
+                double normalBefore[3];
+                double normalAfter[3];
+                triangleNormal(before[0], before[1], before[2], normalBefore);
+                triangleNormal(after[0], after[1], after[2], normalAfter);
+                double lengthBefore = sqrt(dot(normalBefore, normalBefore));
+                double lengthAfter = sqrt(dot(normalAfter, normalAfter));
+                if (lengthBefore <= 0.0) continue;
+                if (lengthAfter <= 0.0 || dot(normalBefore, normalAfter) < 0.25 * lengthBefore * lengthAfter) return true;
+            }
+            return false;
+        };
+
+        auto addCollapse = [&](UInt32 from, UInt32 to) {
+            SimplifierVertexKind fromKind = kinds[from];
+            SimplifierVertexKind toKind = kinds[to];
+            UInt32 fromPosition = positionRemap[from];
+            UInt32 toPosition = positionRemap[to];
+            if (fromKind == SimplifierVertexKind::Locked || fromPosition == toPosition) return;
+            if (fromKind == SimplifierVertexKind::Border) {
+                if (toKind != SimplifierVertexKind::Border && toKind != SimplifierVertexKind::Locked) return;
+                if (positionAdjacency.hasEdge(fromPosition, toPosition) && positionAdjacency.hasEdge(toPosition, fromPosition)) return;
+            }
+            else if (fromKind == SimplifierVertexKind::Seam) {
+                if (toKind != SimplifierVertexKind::Seam) return;
+                if (vertexAdjacency.hasEdge(from, to) && vertexAdjacency.hasEdge(to, from)) return;
+                UInt32 fromPartner = otherWedge[from];
+                UInt32 toPartner = otherWedge[to];
+                if (!vertexAdjacency.hasEdge(fromPartner, toPartner) && !vertexAdjacency.hasEdge(toPartner, fromPartner)) return;
+            }
+            SimplifierCollapse collapse;
+            collapse.from = from;
+            collapse.to = to;
+            collapse.error = quadrics[fromPosition].evaluate(&points[to * 3]);
+            if (collapse.error <= errorLimit) collapses.push_back(collapse);
+        };
+
+        while (currentIndexCount > targetIndexCount) {
+            vertexAdjacency.build(destination, currentIndexCount, nullptr, vertexCount);
+            positionAdjacency.build(destination, currentIndexCount, positionRemap.data(), positionCount);
+
+            std::fill(wedgeCounts.begin(), wedgeCounts.end(), 0);
+            std::fill(firstWedge.begin(), firstWedge.end(), MeshOptimizer::InvalidIndex);
+            std::fill(otherWedge.begin(), otherWedge.end(), MeshOptimizer::InvalidIndex);
+            for (UInt32 v = 0; v < vertexCount; v++) {
+                if (vertexAdjacency.getTriangleCount(v) == 0) continue;
+                UInt32 position = positionRemap[v];
+                wedgeCounts[position]++;
+                if (firstWedge[position] == MeshOptimizer::InvalidIndex) {
+                    firstWedge[position] = v;
+                }
+                else {
+                    otherWedge[v] = firstWedge[position];
+                    otherWedge[firstWedge[position]] = v;
+                }
+            }
+
+            for (UInt32 v = 0; v < vertexCount; v++) {
+                kinds[v] = SimplifierVertexKind::Locked;
+                if (vertexAdjacency.getTriangleCount(v) == 0) continue;
+                UInt32 position = positionRemap[v];
+                UInt32 positionOut, positionIn, vertexOut, vertexIn;
+                positionAdjacency.countOpenEdges(position, positionOut, positionIn);
+                vertexAdjacency.countOpenEdges(v, vertexOut, vertexIn);
+                if (wedgeCounts[position] == 1 && vertexOut == positionOut && vertexIn == positionIn) {
+                    if (positionOut == 0 && positionIn == 0) kinds[v] = SimplifierVertexKind::Manifold;
+                    else if (positionOut == 1 && positionIn == 1) kinds[v] = SimplifierVertexKind::Border;
+                }
+                else if (wedgeCounts[position] == 2 && positionOut == 0 && positionIn == 0) {
+                    UInt32 partnerOut, partnerIn;
+                    vertexAdjacency.countOpenEdges(otherWedge[v], partnerOut, partnerIn);
+                    if (vertexOut == 1 && vertexIn == 1 && partnerOut == 1 && partnerIn == 1) kinds[v] = SimplifierVertexKind::Seam;
+                }
+            }
+
+            collapses.clear();
+            for (UInt32 i = 0; i < currentIndexCount; i += 3) {
+                for (UInt32 k = 0; k < 3; k++) {
+                    UInt32 a = destination[i + k];
+                    UInt32 b = destination[i + (k + 1) % 3];
+                    addCollapse(a, b);
+                    addCollapse(b, a);
+                }
+            }
+            std::sort(collapses.begin(), collapses.end(), [](const SimplifierCollapse& a, const SimplifierCollapse& b) {
+                return a.error < b.error;
+            });
+
+            for (UInt32 v = 0; v < vertexCount; v++) collapseRemap[v] = v;
+            std::fill(touched.begin(), touched.end(), 0);
+            UInt32 trianglesToRemove = (currentIndexCount - targetIndexCount + 2) / 3;
+            UInt32 removedTriangles = 0;
+            UInt32 performed = 0;
+            for (const SimplifierCollapse& collapse : collapses) {
+                UInt32 fromPosition = positionRemap[collapse.from];
+                UInt32 toPosition = positionRemap[collapse.to];
+                if (touched[fromPosition] || touched[toPosition]) continue;
+                Bool seam = kinds[collapse.from] == SimplifierVertexKind::Seam;
+                if (collapseFlipsTriangles(collapse.from, collapse.to)) continue;
+                if (seam && collapseFlipsTriangles(otherWedge[collapse.from], otherWedge[collapse.to])) continue;
+
+                // every triangle that changes contains [fromPosition], so locking its one-ring for the rest of
+                // the pass keeps the flip test above valid for all collapses made in this pass
+                for (UInt32 t = positionAdjacency.offsets[fromPosition]; t < positionAdjacency.offsets[fromPosition + 1]; t++) {
+                    UInt32 triangle = positionAdjacency.triangles[t];
+                    Bool removed = false;
+                    for (UInt32 k = 0; k < 3; k++) {
+                        UInt32 position = positionRemap[destination[triangle * 3 + k]];
+                        touched[position] = 1;
+                        if (position == toPosition) removed = true;
+                    }
+                    if (removed) removedTriangles++;
+                }
+
+                collapseRemap[collapse.from] = collapse.to;
+                if (seam) collapseRemap[otherWedge[collapse.from]] = otherWedge[collapse.to];
+                quadrics[toPosition].add(quadrics[fromPosition]);
+                if (collapse.error > maxError) maxError = collapse.error;
+                performed++;
+                if (removedTriangles >= trianglesToRemove) break;
+            }
+            if (performed == 0) break;
+
+            for (UInt32 i = 0; i < currentIndexCount; i++) destination[i] = collapseRemap[destination[i]];
+            currentIndexCount = removeDegenerateTriangles(destination, currentIndexCount);
+        }
+
+        if (resultError != nullptr) *resultError = (Real)sqrt(maxError);
+        return currentIndexCount;
+    }
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <vector>
+
+#include "../common/types.h"
+#include "../util/WeakPointer.h"
+
+namespace Core {
+
+    // forward declarations
+    class Mesh;
+    class VertexBoneMap;
+
+    // Quadric error edge-collapse simplification (Garland & Heckbert 1997) for building mesh LOD chains.
+    //
+    // Collapses are half-edge collapses: a vertex is merged into one of its neighbours and takes on that
+    // neighbour's attributes, so no attribute is ever interpolated. Vertices that share a position but differ
+    // in any attribute (UV, normal, tangent, color or skin weights) form a seam; a seam vertex may only
+    // collapse along the seam, together with its partner on the other side, so seams stay closed. Open
+    // borders are likewise only shortened along the border, and anything more complicated is locked.
+    class MeshSimplifier {
+    public:
+        class Settings {
+        public:
+            Settings() {
+                this->levelCount = 3;
+                this->reductionRatio = 0.5f;
+                this->maxError = 0.05f;
+                this->maxScreenError = 1.0f;
+            }
+
+            // number of LOD levels generated in addition to the source mesh
+            UInt32 levelCount;
+            // triangle count of each level relative to the previous one
+            Real reductionRatio;
+            // largest deviation allowed for any level, relative to the size of the mesh
+            Real maxError;
+            // deviation in pixels at which a level is considered indistinguishable from the source mesh;
+            // used to derive the screen size at which each level is switched in
+            Real maxScreenError;
+        };
+
+        class LODLevel {
+        public:
+            WeakPointer<Mesh> mesh;
+            WeakPointer<VertexBoneMap> vertexBoneMap;
+            // deviation from the source mesh, relative to its size
+            Real error;
+            // projected size (in pixels) below which this level should be drawn
+            Real screenSize;
+        };
+
+        // Build up to [settings].levelCount simplified copies of [mesh], coarsest last. A level is only added if
+        // it reduces the triangle count noticeably within [settings].maxError. Face normals are taken from the
+        // first triangle that references a vertex. The source objects are not modified or released.
+        static std::vector<LODLevel> buildLODChain(WeakPointer<Mesh> mesh, WeakPointer<VertexBoneMap> vertexBoneMap, const Settings& settings);
+
+        // Simplify the triangle list [indices] to at most [targetIndexCount] indices without exceeding
+        // [targetError] (relative to the mesh extent), writing the result to [destination] and returning its
+        // index count. [indices] must reference welded vertices, i.e. two vertices with the same position are
+        // expected to differ in some other attribute.
+        static UInt32 simplify(UInt32* destination, const UInt32* indices, UInt32 indexCount, const Real* positions, UInt32 positionStride,
+                               UInt32 vertexCount, UInt32 targetIndexCount, Real targetError, Real* resultError);
+
+    private:
+        MeshSimplifier();
+    };
+}
@@ -1,4 +1,6 @@
 #include <IL/il.h>
+#include <cstring>
+#include <vector>
 
 #include "ImageLoader.h"
 #include "RawImage.h"
@@ -9,6 +11,10 @@
 namespace Core {
 
     Bool ImageLoader::initialized = false;
+    std::mutex ImageLoader::loaderMutex;
+
+    // RawImage stores its size in bytes as a UInt32.
+    static const UInt64 MaxImageSizeBytes = 0xFFFFFFFFull;
 
     Bool ImageLoader::initialize() {
         if (!ImageLoader::initialized) {
@@ -27,6 +33,31 @@ namespace Core {
     }
 
     std::shared_ptr<StandardImage> ImageLoader::loadImageU(const std::string& fullPath, Bool reverseOrigin, Bool shouldGammaCompress) {
+        std::shared_ptr<StandardImage> rawImage;
+        UInt32 width = 0, height = 0;
+        Bool loaded = loadImageU(fullPath, reverseOrigin, shouldGammaCompress, nullptr, 0, width, height,
+                                 [&rawImage](UInt32 width, UInt32 height) -> Byte* {
+            StandardImage * rawImagePtr = new(std::nothrow) StandardImage(width, height);
+            if (rawImagePtr == nullptr) throw ImageLoaderException("ImageLoader::loadImageU -> Could not allocate StandardImage.");
+            rawImage = std::shared_ptr<StandardImage>(rawImagePtr);
+            Bool initSuccess = rawImage->init();
+            if (!initSuccess) {
+                throw ImageLoaderException("ImageLoader::loadImageU -> Could not init StandardImage.");
+            }
+            return rawImage->getImageData();
+        });
+        if (!loaded) throw ImageLoaderException("ImageLoader::loadImageU -> Could not decode image.");
+        return rawImage;
+    }
+
+    Bool ImageLoader::loadImageU(const std::string& fullPath, Bool reverseOrigin, Bool shouldGammaCompress,
+                                 Byte* dest, UInt32 destSizeBytes, UInt32& width, UInt32& height) {
+        return loadImageU(fullPath, reverseOrigin, shouldGammaCompress, dest, destSizeBytes, width, height, nullptr);
+    }
+
+    Bool ImageLoader::loadImageU(const std::string& fullPath, Bool reverseOrigin, Bool shouldGammaCompress, Byte* dest, UInt32 destSizeBytes,
+                                 UInt32& width, UInt32& height, std::function<Byte*(UInt32, UInt32)> allocateDest) {
+        std::lock_guard<std::mutex> lock(ImageLoader::loaderMutex);
         Bool initializeSuccess = initialize();
 
         if (!initializeSuccess) {
@@ -42,20 +73,10 @@ namespace Core {
         ILuint imageIds[1];
         ilGenImages(1, imageIds); // Generation of numTextures image names
         ilBindImage(imageIds[0]); // Binding of DevIL image name
-        std::shared_ptr<StandardImage> rawImage;
 
         ILboolean success = ilLoadImage(fullPath.c_str());
 
-        if (success) {
-            // Convert every color component into unsigned byte.If your image contains
-            // alpha channel you can replace IL_RGB with IL_RGBA
-            success = ilConvertImage(IL_RGBA, IL_UNSIGNED_BYTE);
-            if (!success) {
-                ilDeleteImages(1, imageIds);
-                throw ImageLoaderException("ImageLoader::LoadImage -> Couldn't convert image");
-            }
-            rawImage = getStandardImageFromILData(ilGetData(), ilGetInteger(IL_IMAGE_WIDTH), ilGetInteger(IL_IMAGE_HEIGHT));
-        } else {
+        if (!success) {
             ILenum i = ilGetError();
             std::string msg = "ImageLoader::LoadImage -> Couldn't load image: ";
             msg += fullPath.c_str();
@@ -64,21 +85,78 @@ namespace Core {
                 msg += std::string("Is DevIL configured to load extension: ") + extension + std::string(" ?");
             }
             ilDeleteImages(1, imageIds);
+            if (reverseOrigin) ilOriginFunc(IL_ORIGIN_LOWER_LEFT);
             throw ImageLoaderException(msg);
         }
 
-        // Because we have already copied image data into texture data we can release memory used by image.
+        width = ilGetInteger(IL_IMAGE_WIDTH);
+        height = ilGetInteger(IL_IMAGE_HEIGHT);
+        UInt64 requiredSizeBytes64 = (UInt64)width * (UInt64)height * 4;
+        if (requiredSizeBytes64 > MaxImageSizeBytes) {
+            ilDeleteImages(1, imageIds);
+            if (reverseOrigin) ilOriginFunc(IL_ORIGIN_LOWER_LEFT);
+            throw ImageLoaderException("ImageLoader::LoadImage -> Image is too large: " + fullPath);
+        }
+        UInt32 requiredSizeBytes = (UInt32)requiredSizeBytes64;
+        if (allocateDest) {
+            try {
+                dest = allocateDest(width, height);
+            } catch(...) {
+                ilDeleteImages(1, imageIds);
+                if (reverseOrigin) ilOriginFunc(IL_ORIGIN_LOWER_LEFT);
+                throw;
+            }
+            destSizeBytes = requiredSizeBytes;
+        }
+
+        Bool copied = false;
+        if (dest != nullptr && destSizeBytes >= requiredSizeBytes) {
+            // Let DevIL convert directly into the destination as RGBA bytes, rather than converting
+            // the image in place and then copying it out a second time.
+            copied = ilCopyPixels(0, 0, 0, width, height, 1, IL_RGBA, IL_UNSIGNED_BYTE, dest) > 0;
+            if (!copied) {
+                ilDeleteImages(1, imageIds);
+                if (reverseOrigin) ilOriginFunc(IL_ORIGIN_LOWER_LEFT);
+                throw ImageLoaderException("ImageLoader::LoadImage -> Couldn't convert image");
+            }
+        }
+
         ilDeleteImages(1, imageIds);
 
         if (reverseOrigin) {
             ilOriginFunc(IL_ORIGIN_LOWER_LEFT);
         }
 
-        if (shouldGammaCompress) gammaCompress(rawImage);
-        return rawImage;
+        if (copied && shouldGammaCompress) gammaCompress(dest, width * height);
+        return copied;
     }
 
     std::shared_ptr<HDRImage> ImageLoader::loadImageHDR(const std::string& fullPath, bool invertY, Bool shouldGammaCompress) {
+        std::shared_ptr<HDRImage> hdrImage;
+        UInt32 width = 0, height = 0;
+        Bool loaded = loadImageHDR(fullPath, invertY, shouldGammaCompress, nullptr, 0, width, height,
+                                   [&hdrImage](UInt32 width, UInt32 height) -> Real* {
+            HDRImage * hdrImagePtr = new(std::nothrow) HDRImage(width, height);
+            if (hdrImagePtr == nullptr) throw ImageLoaderException("ImageLoader::loadImageHDR -> Could not allocate HDRImage.");
+            hdrImage = std::shared_ptr<HDRImage>(hdrImagePtr);
+            Bool initSuccess = hdrImage->init();
+            if (!initSuccess) {
+                throw ImageLoaderException("ImageLoader::loadImageHDR -> Could not init HDRImage.");
+            }
+            return hdrImage->getImageData();
+        });
+        if (!loaded) throw ImageLoaderException("ImageLoader::loadImageHDR -> Could not decode HDRImage.");
+        return hdrImage;
+    }
+
+    Bool ImageLoader::loadImageHDR(const std::string& fullPath, Bool invertY, Bool shouldGammaCompress,
+                                   Real* dest, UInt32 destSizeElements, UInt32& width, UInt32& height) {
+        return loadImageHDR(fullPath, invertY, shouldGammaCompress, dest, destSizeElements, width, height, nullptr);
+    }
+
+    Bool ImageLoader::loadImageHDR(const std::string& fullPath, Bool invertY, Bool shouldGammaCompress, Real* dest, UInt32 destSizeElements,
+                                   UInt32& width, UInt32& height, std::function<Real*(UInt32, UInt32)> allocateDest) {
+        std::lock_guard<std::mutex> lock(ImageLoader::loaderMutex);
         Bool initializeSuccess = initialize();
 
         if (!initializeSuccess) {
@@ -87,8 +165,9 @@ namespace Core {
 
         stbi_set_flip_vertically_on_load(invertY);
 
-        int width, height, nrComponents;
-        float *hdr_data = stbi_loadf(fullPath.c_str(), &width, &height, &nrComponents, 0);
+        // Have stb_image expand to RGBA while it decodes (alpha = 1.0), so the result can be copied in one block.
+        int imageWidth, imageHeight, nrComponents;
+        float *hdr_data = stbi_loadf(fullPath.c_str(), &imageWidth, &imageHeight, &nrComponents, 4);
 
         if (hdr_data == NULL) {
             std::string msg("ImageLoader::loadImageHDR -> Could not load HDRImage: ");
@@ -96,68 +175,63 @@ namespace Core {
             throw ImageLoaderException(msg);
         }
 
-        HDRImage * hdrImagePtr = new(std::nothrow) HDRImage(width, height);
-        if (hdrImagePtr == nullptr) throw ImageLoaderException("ImageLoader::loadImageHDR -> Could not allocate HDRImage.");
-
-        std::shared_ptr<HDRImage> hdrImage(hdrImagePtr);
-        Bool initSuccess = hdrImage->init();
-        if (!initSuccess) {
-            throw ImageLoaderException("ImageLoader::loadImageHDR -> Could not init HDRImage.");
+        width = (UInt32)imageWidth;
+        height = (UInt32)imageHeight;
+        UInt64 requiredSizeElements64 = (UInt64)width * (UInt64)height * 4;
+        if (requiredSizeElements64 * sizeof(Real) > MaxImageSizeBytes) {
+            stbi_image_free(hdr_data);
+            throw ImageLoaderException("ImageLoader::loadImageHDR -> Image is too large: " + fullPath);
         }
-        for (UInt32 i = 0; i < (UInt32)width * (UInt32)height; i++) {
-            UInt32 baseIndex = i * 4;
-            UInt32 baseHDRIndex = i * 3;
-            hdrImage->setElement(baseIndex, hdr_data[baseHDRIndex]);
-            hdrImage->setElement(baseIndex + 1, hdr_data[baseHDRIndex + 1]);
-            hdrImage->setElement(baseIndex + 2, hdr_data[baseHDRIndex + 2]);
-            hdrImage->setElement(baseIndex + 3, 1.0f);
+        UInt32 requiredSizeElements = (UInt32)requiredSizeElements64;
+        if (allocateDest) {
+            try {
+                dest = allocateDest(width, height);
+            } catch(...) {
+                stbi_image_free(hdr_data);
+                throw;
+            }
+            destSizeElements = requiredSizeElements;
         }
 
-        if (shouldGammaCompress) gammaCompress(hdrImage);
-        return hdrImage;
-    }
-
-    std::shared_ptr<StandardImage> ImageLoader::getStandardImageFromILData(const ILubyte * data, UInt32 width, UInt32 height) {
-        if (data == nullptr) throw ImageLoaderException("ImageLoader::getStandardImageFromILData -> 'data' is null.");
-
-        StandardImage * rawImagePtr = new(std::nothrow) StandardImage(width, height);
-        if (rawImagePtr == nullptr) throw ImageLoaderException("ImageLoader::getStandardImageFromILData -> Could not allocate StandardImage.");
-
-        std::shared_ptr<StandardImage> rawImage(rawImagePtr);
-
-        Bool initSuccess = rawImage->init();
-        if (!initSuccess) {
-            throw ImageLoaderException("ImageLoader::getStandardImageFromILData -> Could not init StandardImage.");
+        Bool copied = false;
+        if (dest != nullptr && destSizeElements >= requiredSizeElements) {
+            memcpy(dest, hdr_data, (size_t)requiredSizeElements * sizeof(Real));
+            copied = true;
         }
+        stbi_image_free(hdr_data);
 
-        for (UInt32 i = 0; i < width * height * 4; i++) {
-            rawImage->setElement(i, (Byte)data[i]);
-        }
+        if (copied && shouldGammaCompress) gammaCompress(dest, width * height);
+        return copied;
+    }
 
-        return rawImage;
+    // Gamma curve for every possible 8-bit value, computed with exactly the same arithmetic as
+    // the per-element conversion it replaces so that results are bit-identical.
+    const Byte* ImageLoader::getGammaCompressTable() {
+        static const std::vector<Byte> table = []() {
+            std::vector<Byte> values(256);
+            for (UInt32 i = 0; i < 256; i++) {
+                Real normalized = ((Real)i) / 255.0f;
+                Real compressed = Math::pow(normalized, 2.22f);
+                values[i] = Math::clamp((Byte)(compressed * 255.0f), (Byte)0, (Byte)255);
+            }
+            return values;
+        }();
+        return table.data();
     }
 
-    void ImageLoader::gammaCompress(std::shared_ptr<StandardImage> image) {
-        UInt32 width = image->getWidth();
-        UInt32 height = image->getHeight();
-
-        for (UInt32 i = 0; i < width * height * 4; i++) {
-            if ((i + 1) % 4 == 0) continue;
-            Byte val = image->getElement(i);
-            Real normalized = ((Real)val) / 255.0f;
-            Real compressed = Math::pow(normalized, 2.22f);
-            val = Math::clamp((Byte)(compressed * 255.0f), (Byte)0, (Byte)255);
-            image->setElement(i, val);
+    void ImageLoader::gammaCompress(Byte* data, UInt32 pixelCount) {
+        const Byte* table = getGammaCompressTable();
+        for (UInt32 i = 0; i < pixelCount; i++) {
+            Byte* pixel = data + i * 4;
+            pixel[0] = table[pixel[0]];
+            pixel[1] = table[pixel[1]];
+            pixel[2] = table[pixel[2]];
         }
     }
 
-    void ImageLoader::gammaCompress(std::shared_ptr<HDRImage> image) {
-        UInt32 width = image->getWidth();
-        UInt32 height = image->getHeight();
-        Real * imageData = image->getImageData();
-        for (UInt32 i = 0; i < width * height * 4; i++) {
-            Real val = imageData[i];
-            imageData[i] = Math::pow(val, 2.22f);
+    void ImageLoader::gammaCompress(Real* data, UInt32 pixelCount) {
+        for (UInt32 i = 0; i < pixelCount * 4; i++) {
+            data[i] = Math::pow(data[i], 2.22f);
         }
     }
 
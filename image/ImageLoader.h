@@ -2,6 +2,8 @@
 
 #include <string>
 #include <memory>
+#include <functional>
+#include <mutex>
 
 #ifdef CORE_USE_PRIVATE_INCLUDES
 #include <IL/il.h>
@@ -29,17 +31,29 @@ namespace Core {
 
         static std::shared_ptr<StandardImage> loadImageU(const std::string& fullPath, Bool reverseOrigin, Bool shouldGammaCompress);
         static std::shared_ptr<HDRImage> loadImageHDR(const std::string& fullPath, Bool reverseOrigin, Bool shouldGammaCompress);
+
+        // Decode straight into a caller-provided RGBA buffer. 'width' and 'height' always receive the
+        // dimensions of the image; false is returned (and nothing is written) if the buffer is too small.
+        static Bool loadImageU(const std::string& fullPath, Bool reverseOrigin, Bool shouldGammaCompress,
+                               Byte* dest, UInt32 destSizeBytes, UInt32& width, UInt32& height);
+        static Bool loadImageHDR(const std::string& fullPath, Bool reverseOrigin, Bool shouldGammaCompress,
+                                 Real* dest, UInt32 destSizeElements, UInt32& width, UInt32& height);
+
         static std::string getFileExtension(const std::string& filePath);
     
     private:
         static Bool initialized;
+        // DevIL and the stb_image flip setting are global state, so decoding is serialized.
+        static std::mutex loaderMutex;
         static Bool initialize();
-#ifdef CORE_USE_PRIVATE_INCLUDES
-        static std::shared_ptr<StandardImage> getStandardImageFromILData(const ILubyte * data, UInt32 width, UInt32 height);
-
-        static void gammaCompress(std::shared_ptr<StandardImage> image);
-        static void gammaCompress(std::shared_ptr<HDRImage> image);
-#endif
+        static Bool loadImageU(const std::string& fullPath, Bool reverseOrigin, Bool shouldGammaCompress, Byte* dest, UInt32 destSizeBytes,
+                               UInt32& width, UInt32& height, std::function<Byte*(UInt32, UInt32)> allocateDest);
+        static Bool loadImageHDR(const std::string& fullPath, Bool invertY, Bool shouldGammaCompress, Real* dest, UInt32 destSizeElements,
+                                 UInt32& width, UInt32& height, std::function<Real*(UInt32, UInt32)> allocateDest);
+        static const Byte* getGammaCompressTable();
+
+        static void gammaCompress(Byte* data, UInt32 pixelCount);
+        static void gammaCompress(Real* data, UInt32 pixelCount);
     };
 
 }
@@ -16,6 +16,16 @@ namespace Core {
         virtual void buildFromImage(WeakPointer<HDRImage> imageData) = 0;
         virtual void buildFromImage(WeakPointer<HDRImage> imageData, UInt32 resizeWidth, UInt32 resizeHeight) = 0;
         virtual void buildFromData(Byte* data, UInt32 width, UInt32 height) = 0;
+        // (Re)build from a complete, precomputed mip chain: 'levels[0]' is 'width' x 'height' and each
+        // following level halves both dimensions (clamped to 1). Any previous contents are released.
+        virtual void buildFromMipLevels(Byte** levels, UInt32 levelCount, UInt32 width, UInt32 height) = 0;
+
+        // Streaming: (re)build as a 'width' x 'height' texture with no resident levels, then make levels
+        // resident one at a time. Levels are addressed by their index in the full chain, and only the levels
+        // from the one passed to setFirstResidentMipLevel() down to 1x1 are sampled; finer levels are released.
+        virtual void buildStreamable(UInt32 width, UInt32 height) = 0;
+        virtual void uploadMipLevel(UInt32 level, const Byte* data) = 0;
+        virtual void setFirstResidentMipLevel(UInt32 level) = 0;
 
     protected:
         Texture2D(const TextureAttributes& attributes);
@@ -0,0 +1,274 @@
+#include <algorithm>
+
+#include "TextureResidencyManager.h"
+#include "../common/Exception.h"
+#include "../math/Math.h"
+
+namespace Core {
+
+    TextureResidencyManager::TextureResidencyManager(UInt64 budgetBytes) {
+        this->budgetBytes = budgetBytes;
+        this->residentBytes = 0;
+        this->pendingBytes = 0;
+        this->textureCount = 0;
+        this->pendingLoadCount = 0;
+        this->maxPendingLoads = 4;
+        this->frame = 0;
+        this->loadRequestCount = 0;
+        this->evictionCount = 0;
+    }
+
+    TextureResidencyManager::StreamID TextureResidencyManager::registerTexture(UInt32 width, UInt32 height, UInt32 bytesPerTexel, UInt32 baselineMipLevel) {
+        if (width == 0 || height == 0) {
+            throw InvalidArgumentException("TextureResidencyManager::registerTexture() -> Texture dimensions must be non-zero.");
+        }
+
+        StreamID id;
+        if (this->freeIDs.size() > 0) {
+            id = this->freeIDs.back();
+            this->freeIDs.pop_back();
+        }
+        else {
+            id = (StreamID)this->textures.size();
+            this->textures.push_back(TextureRecord());
+        }
+
+        TextureRecord& record = this->textures[id];
+        record.registered = true;
+        record.width = width;
+        record.height = height;
+        record.bytesPerTexel = bytesPerTexel;
+        record.baselineMipLevel = Math::min(baselineMipLevel, calcMipLevelCount(width, height) - 1);
+        record.residentMipLevel = record.baselineMipLevel;
+        record.pendingMipLevel = record.baselineMipLevel;
+        record.loadPending = false;
+        record.screenSize = 0.0f;
+        record.lastUsedFrame = this->frame;
+
+        this->residentBytes += this->getResidentBytes(record, record.residentMipLevel);
+        this->textureCount++;
+        return id;
+    }
+
+    void TextureResidencyManager::unregisterTexture(StreamID id) {
+        TextureRecord& record = this->getRecord(id);
+        if (record.loadPending) this->cancelLoad(id);
+        this->residentBytes -= this->getResidentBytes(record, record.residentMipLevel);
+        record.registered = false;
+        this->freeIDs.push_back(id);
+        this->textureCount--;
+    }
+
+    Bool TextureResidencyManager::isRegistered(StreamID id) const {
+        return id < this->textures.size() && this->textures[id].registered;
+    }
+
+    void TextureResidencyManager::setBudget(UInt64 budgetBytes) {
+        this->budgetBytes = budgetBytes;
+    }
+
+    UInt64 TextureResidencyManager::getBudget() const {
+        return this->budgetBytes;
+    }
+
+    void TextureResidencyManager::setMaxPendingLoads(UInt32 maxPendingLoads) {
+        this->maxPendingLoads = maxPendingLoads > 0 ? maxPendingLoads : 1;
+    }
+
+    void TextureResidencyManager::reportScreenSize(StreamID id, Real screenSize) {
+        TextureRecord& record = this->getRecord(id);
+        record.screenSize = Math::max(record.screenSize, screenSize);
+        record.lastUsedFrame = this->frame;
+    }
+
+    void TextureResidencyManager::update(std::vector<Request>& requests) {
+        // Free memory first if the budget was lowered below what is currently resident.
+        while (this->residentBytes + this->pendingBytes > this->budgetBytes) {
+            if (!this->evictLeastRecentlyUsed(requests, InvalidStreamID)) break;
+        }
+
+        this->loadCandidates.clear();
+        for (StreamID id = 0; id < this->textures.size(); id++) {
+            TextureRecord& record = this->textures[id];
+            if (!record.registered || record.loadPending || record.screenSize <= 0.0f) continue;
+            UInt32 desiredMipLevel = calcDesiredMipLevel(record.width, record.height, record.screenSize);
+            if (desiredMipLevel < record.residentMipLevel) this->loadCandidates.push_back(id);
+        }
+
+        // The largest textures on screen benefit the most from extra resolution, so they get budget first.
+        std::sort(this->loadCandidates.begin(), this->loadCandidates.end(), [this](StreamID a, StreamID b) {
+            return this->textures[a].screenSize > this->textures[b].screenSize;
+        });
+
+        for (StreamID id : this->loadCandidates) {
+            if (this->pendingLoadCount >= this->maxPendingLoads) break;
+            TextureRecord& record = this->textures[id];
+            UInt64 currentBytes = this->getResidentBytes(record, record.residentMipLevel);
+            UInt32 mipLevel = calcDesiredMipLevel(record.width, record.height, record.screenSize);
+
+            // Make room by evicting textures that were not used this frame; if that is not enough,
+            // settle for a coarser level than the one requested.
+            while (mipLevel < record.residentMipLevel) {
+                UInt64 cost = this->getResidentBytes(record, mipLevel) - currentBytes;
+                if (this->residentBytes + this->pendingBytes + cost <= this->budgetBytes) break;
+                if (!this->evictLeastRecentlyUsed(requests, id)) mipLevel++;
+            }
+            if (mipLevel >= record.residentMipLevel) continue;
+
+            this->pendingBytes += this->getResidentBytes(record, mipLevel) - currentBytes;
+            this->pendingLoadCount++;
+            this->loadRequestCount++;
+            record.loadPending = true;
+            record.pendingMipLevel = mipLevel;
+
+            Request request;
+            request.id = id;
+            request.mipLevel = mipLevel;
+            request.type = RequestType::Load;
+            requests.push_back(request);
+        }
+
+        for (TextureRecord& record : this->textures) {
+            record.screenSize = 0.0f;
+        }
+        this->frame++;
+    }
+
+    void TextureResidencyManager::completeLoad(StreamID id, UInt32 mipLevel) {
+        TextureRecord& record = this->getRecord(id);
+        if (!record.loadPending) return;
+        UInt64 pendingCost = this->getResidentBytes(record, record.pendingMipLevel) - this->getResidentBytes(record, record.residentMipLevel);
+        this->pendingBytes -= pendingCost;
+        this->pendingLoadCount--;
+        record.loadPending = false;
+
+        if (mipLevel < record.residentMipLevel) {
+            this->residentBytes -= this->getResidentBytes(record, record.residentMipLevel);
+            record.residentMipLevel = mipLevel;
+            this->residentBytes += this->getResidentBytes(record, record.residentMipLevel);
+        }
+        record.pendingMipLevel = record.residentMipLevel;
+    }
+
+    void TextureResidencyManager::cancelLoad(StreamID id) {
+        this->completeLoad(id, this->getRecord(id).residentMipLevel);
+    }
+
+    UInt32 TextureResidencyManager::getResidentMipLevel(StreamID id) const {
+        return this->getRecord(id).residentMipLevel;
+    }
+
+    UInt32 TextureResidencyManager::getBaselineMipLevel(StreamID id) const {
+        return this->getRecord(id).baselineMipLevel;
+    }
+
+    Bool TextureResidencyManager::isLoadPending(StreamID id) const {
+        return this->getRecord(id).loadPending;
+    }
+
+    UInt64 TextureResidencyManager::getFrame() const {
+        return this->frame;
+    }
+
+    TextureResidencyManager::Statistics TextureResidencyManager::getStatistics() const {
+        Statistics stats;
+        stats.budgetBytes = this->budgetBytes;
+        stats.residentBytes = this->residentBytes;
+        stats.pendingBytes = this->pendingBytes;
+        stats.textureCount = this->textureCount;
+        stats.pendingLoadCount = this->pendingLoadCount;
+        stats.loadRequestCount = this->loadRequestCount;
+        stats.evictionCount = this->evictionCount;
+        return stats;
+    }
+
+    UInt32 TextureResidencyManager::calcMipLevelCount(UInt32 width, UInt32 height) {
+        UInt32 size = Math::max(width, height);
+        UInt32 levels = 1;
+        while (size > 1) {
+            size >>= 1;
+            levels++;
+        }
+        return levels;
+    }
+
+    UInt32 TextureResidencyManager::calcBaselineMipLevel(UInt32 width, UInt32 height, UInt32 maxBaselineSize) {
+        UInt32 size = Math::max(width, height);
+        UInt32 level = 0;
+        while (size > maxBaselineSize && size > 1) {
+            size >>= 1;
+            level++;
+        }
+        return level;
+    }
+
+    UInt32 TextureResidencyManager::calcDesiredMipLevel(UInt32 width, UInt32 height, Real screenSize) {
+        UInt32 size = Math::max(width, height);
+        UInt32 level = 0;
+        while (size > 1 && (Real)(size >> 1) >= screenSize) {
+            size >>= 1;
+            level++;
+        }
+        return level;
+    }
+
+    UInt64 TextureResidencyManager::calcResidentBytes(UInt32 width, UInt32 height, UInt32 bytesPerTexel, UInt32 mipLevel) {
+        UInt64 bytes = 0;
+        UInt32 levelWidth = Math::max(width >> Math::min(mipLevel, (UInt32)31), (UInt32)1);
+        UInt32 levelHeight = Math::max(height >> Math::min(mipLevel, (UInt32)31), (UInt32)1);
+        while (true) {
+            bytes += (UInt64)levelWidth * (UInt64)levelHeight * (UInt64)bytesPerTexel;
+            if (levelWidth == 1 && levelHeight == 1) break;
+            levelWidth = Math::max(levelWidth >> 1, (UInt32)1);
+            levelHeight = Math::max(levelHeight >> 1, (UInt32)1);
+        }
+        return bytes;
+    }
+
+    TextureResidencyManager::TextureRecord& TextureResidencyManager::getRecord(StreamID id) {
+        if (!this->isRegistered(id)) {
+            throw OutOfRangeException("TextureResidencyManager::getRecord() -> Invalid stream ID.");
+        }
+        return this->textures[id];
+    }
+
+    const TextureResidencyManager::TextureRecord& TextureResidencyManager::getRecord(StreamID id) const {
+        if (!this->isRegistered(id)) {
+            throw OutOfRangeException("TextureResidencyManager::getRecord() -> Invalid stream ID.");
+        }
+        return this->textures[id];
+    }
+
+    UInt64 TextureResidencyManager::getResidentBytes(const TextureRecord& record, UInt32 mipLevel) const {
+        return calcResidentBytes(record.width, record.height, record.bytesPerTexel, mipLevel);
+    }
+
+    // Drop the least recently used texture that is above its baseline and was not drawn this frame.
+    Bool TextureResidencyManager::evictLeastRecentlyUsed(std::vector<Request>& requests, StreamID exclude) {
+        StreamID victim = InvalidStreamID;
+        for (StreamID id = 0; id < this->textures.size(); id++) {
+            const TextureRecord& record = this->textures[id];
+            if (!record.registered || id == exclude || record.loadPending) continue;
+            if (record.residentMipLevel >= record.baselineMipLevel || record.lastUsedFrame >= this->frame) continue;
+            if (victim == InvalidStreamID || record.lastUsedFrame < this->textures[victim].lastUsedFrame) victim = id;
+        }
+        if (victim == InvalidStreamID) return false;
+        this->evict(victim, requests);
+        return true;
+    }
+
+    void TextureResidencyManager::evict(StreamID id, std::vector<Request>& requests) {
+        TextureRecord& record = this->textures[id];
+        this->residentBytes -= this->getResidentBytes(record, record.residentMipLevel);
+        record.residentMipLevel = record.baselineMipLevel;
+        record.pendingMipLevel = record.baselineMipLevel;
+        this->residentBytes += this->getResidentBytes(record, record.residentMipLevel);
+        this->evictionCount++;
+
+        Request request;
+        request.id = id;
+        request.mipLevel = record.residentMipLevel;
+        request.type = RequestType::Evict;
+        requests.push_back(request);
+    }
+}
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <vector>
+
+#include "../common/types.h"
+
+namespace Core {
+
+    // Decides which mip level of each streamed texture should be resident, given the on-screen size
+    // of the textures reported during rendering and a fixed memory budget. It has no dependency on
+    // the graphics system: callers carry out the requests it produces and report back when loads
+    // complete, so the policy can be driven entirely by a simulated budget.
+    //
+    // Mip levels are numbered as in OpenGL: level 0 is full resolution, higher levels are smaller.
+    // Every texture always keeps its baseline level (and everything coarser) resident; levels finer
+    // than the baseline are streamed in on demand and dropped back to the baseline on eviction.
+    class TextureResidencyManager {
+    public:
+        typedef UInt32 StreamID;
+        static const StreamID InvalidStreamID = 0xFFFFFFFF;
+
+        enum class RequestType {
+            Load = 0,
+            Evict = 1
+        };
+
+        class Request {
+        public:
+            StreamID id;
+            UInt32 mipLevel;
+            RequestType type;
+        };
+
+        class Statistics {
+        public:
+            Statistics() {
+                this->budgetBytes = 0;
+                this->residentBytes = 0;
+                this->pendingBytes = 0;
+                this->textureCount = 0;
+                this->pendingLoadCount = 0;
+                this->loadRequestCount = 0;
+                this->evictionCount = 0;
+            }
+
+            UInt64 budgetBytes;
+            UInt64 residentBytes;
+            UInt64 pendingBytes;
+            UInt32 textureCount;
+            UInt32 pendingLoadCount;
+            UInt64 loadRequestCount;
+            UInt64 evictionCount;
+        };
+
+        TextureResidencyManager(UInt64 budgetBytes);
+
+        StreamID registerTexture(UInt32 width, UInt32 height, UInt32 bytesPerTexel, UInt32 baselineMipLevel);
+        void unregisterTexture(StreamID id);
+        Bool isRegistered(StreamID id) const;
+
+        void setBudget(UInt64 budgetBytes);
+        UInt64 getBudget() const;
+        void setMaxPendingLoads(UInt32 maxPendingLoads);
+
+        // Record that the texture was drawn this frame covering roughly 'screenSize' pixels along
+        // its longest edge. Multiple reports in the same frame keep the largest size.
+        void reportScreenSize(StreamID id, Real screenSize);
+
+        // Advance one frame and append the resulting work to 'requests'. Evictions take effect
+        // immediately; loads reserve budget until completeLoad() or cancelLoad() is called.
+        void update(std::vector<Request>& requests);
+        void completeLoad(StreamID id, UInt32 mipLevel);
+        void cancelLoad(StreamID id);
+
+        UInt32 getResidentMipLevel(StreamID id) const;
+        UInt32 getBaselineMipLevel(StreamID id) const;
+        Bool isLoadPending(StreamID id) const;
+        UInt64 getFrame() const;
+        Statistics getStatistics() const;
+
+        static UInt32 calcMipLevelCount(UInt32 width, UInt32 height);
+        static UInt32 calcBaselineMipLevel(UInt32 width, UInt32 height, UInt32 maxBaselineSize);
+        static UInt32 calcDesiredMipLevel(UInt32 width, UInt32 height, Real screenSize);
+        static UInt64 calcResidentBytes(UInt32 width, UInt32 height, UInt32 bytesPerTexel, UInt32 mipLevel);
+
+    private:
+        class TextureRecord {
+        public:
+            Bool registered;
+            UInt32 width;
+            UInt32 height;
+            UInt32 bytesPerTexel;
+            UInt32 baselineMipLevel;
+            UInt32 residentMipLevel;
+            UInt32 pendingMipLevel;
+            Bool loadPending;
+            Real screenSize;
+            UInt64 lastUsedFrame;
+        };
+
+        TextureRecord& getRecord(StreamID id);
+        const TextureRecord& getRecord(StreamID id) const;
+        UInt64 getResidentBytes(const TextureRecord& record, UInt32 mipLevel) const;
+        Bool evictLeastRecentlyUsed(std::vector<Request>& requests, StreamID exclude);
+        void evict(StreamID id, std::vector<Request>& requests);
+
+        std::vector<TextureRecord> textures;
+        std::vector<StreamID> freeIDs;
+        std::vector<StreamID> loadCandidates;
+        UInt64 budgetBytes;
+        UInt64 residentBytes;
+        UInt64 pendingBytes;
+        UInt32 textureCount;
+        UInt32 pendingLoadCount;
+        UInt32 maxPendingLoads;
+        UInt64 frame;
+        UInt64 loadRequestCount;
+        UInt64 evictionCount;
+    };
+}
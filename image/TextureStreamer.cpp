@@ -0,0 +1,348 @@
+#include <string.h>
+
+#include "TextureStreamer.h"
+#include "Texture.h"
+#include "Texture2D.h"
+#include "TextureUtils.h"
+#include "ImageLoader.h"
+#include "RawImage.h"
+#include "../Engine.h"
+#include "../common/Exception.h"
+
+namespace Core {
+
+    TextureStreamer::TextureStreamer(): residencyManager(256 * 1024 * 1024) {
+        this->enabled = false;
+        this->baselineSize = 64;
+        this->maxUploadBytesPerFrame = 4 * 1024 * 1024;
+        this->frameUploadBytes = 0;
+        this->decodedBytes = 0;
+        this->nextSerial = 1;
+        this->workerRunning = false;
+    }
+
+    TextureStreamer::~TextureStreamer() {
+        this->stopWorker();
+    }
+
+    void TextureStreamer::setEnabled(Bool enabled) {
+        this->enabled = enabled;
+    }
+
+    Bool TextureStreamer::isEnabled() const {
+        return this->enabled;
+    }
+
+    void TextureStreamer::setBudget(UInt64 budgetBytes) {
+        this->residencyManager.setBudget(budgetBytes);
+    }
+
+    void TextureStreamer::setBaselineSize(UInt32 baselineSize) {
+        this->baselineSize = baselineSize > 0 ? baselineSize : 1;
+    }
+
+    // A level larger than the limit is still uploaded, on a frame of its own.
+    void TextureStreamer::setMaxUploadBytesPerFrame(UInt64 maxUploadBytes) {
+        this->maxUploadBytesPerFrame = maxUploadBytes;
+    }
+
+    WeakPointer<Texture2D> TextureStreamer::loadTexture(const std::string& path, const TextureAttributes& attributes, Bool gammaCompress) {
+        if (attributes.Format != TextureFormat::RGBA8) {
+            throw InvalidArgumentException("TextureStreamer::loadTexture() -> Only RGBA8 textures can be streamed.");
+        }
+
+        WeakPointer<Texture2D> texture = Engine::instance()->createTexture2D(attributes);
+        if (!texture.isValid()) {
+            throw AllocationException("TextureStreamer::loadTexture() -> Unable to create texture.");
+        }
+
+        // the texture is usable right away; the decoded image replaces the placeholder in update()
+        Byte placeholder[4] = {128, 128, 128, 255};
+        Byte* placeholderLevels[1] = {placeholder};
+        texture->buildFromMipLevels(placeholderLevels, 1, 1, 1);
+
+        UInt64 serial = this->nextSerial++;
+        PendingTexture& pendingTexture = this->pendingTextures[serial];
+        pendingTexture.texture = texture;
+        pendingTexture.objectID = texture->getObjectID();
+        pendingTexture.path = path;
+        pendingTexture.gammaCompress = gammaCompress;
+
+        DecodeJob job;
+        job.serial = serial;
+        job.id = TextureResidencyManager::InvalidStreamID;
+        job.path = path;
+        job.gammaCompress = gammaCompress;
+        job.firstLevel = 0;
+        job.endLevel = 0;
+        job.baselineSize = this->baselineSize;
+        this->queueJob(job);
+        return texture;
+    }
+
+    void TextureStreamer::reportScreenSize(WeakPointer<Texture> texture, Real screenSize) {
+        if (!texture.isValid()) return;
+        auto result = this->streamIDsByObject.find(texture->getObjectID());
+        if (result == this->streamIDsByObject.end()) return;
+        this->residencyManager.reportScreenSize(result->second, screenSize);
+    }
+
+    void TextureStreamer::update() {
+        if (this->streamedTextures.size() == 0 && this->pendingTextures.size() == 0) return;
+        this->frameUploadBytes = 0;
+
+        {
+            std::lock_guard<std::mutex> lock(this->queueMutex);
+            this->completedResults.swap(this->finishedResults);
+        }
+        for (DecodeResult& result : this->completedResults) {
+            if (result.id == TextureResidencyManager::InvalidStreamID) this->applyResult(result);
+            else this->applyLoadResult(result);
+        }
+        this->completedResults.clear();
+
+        std::vector<TextureResidencyManager::StreamID> releasedIDs;
+        for (auto& entry : this->streamedTextures) {
+            if (!entry.second.texture.isValid()) releasedIDs.push_back(entry.first);
+        }
+        for (TextureResidencyManager::StreamID id : releasedIDs) {
+            this->releaseTexture(id);
+        }
+
+        // loads that were decoded earlier keep uploading even when streaming has since been turned off
+        this->uploadPendingLevels();
+        if (!this->enabled) return;
+
+        this->requests.clear();
+        this->residencyManager.update(this->requests);
+
+        for (TextureResidencyManager::Request& request : this->requests) {
+            StreamedTexture& streamedTexture = this->streamedTextures[request.id];
+            if (request.type == TextureResidencyManager::RequestType::Evict) {
+                streamedTexture.texture->setFirstResidentMipLevel(streamedTexture.baselineMipLevel);
+                streamedTexture.residentMipLevel = streamedTexture.baselineMipLevel;
+            }
+            else {
+                // only the levels above those already resident are decoded and kept
+                streamedTexture.loadPending = true;
+                streamedTexture.loadMipLevel = request.mipLevel;
+                streamedTexture.loadSerial = this->nextSerial++;
+
+                DecodeJob job;
+                job.serial = streamedTexture.loadSerial;
+                job.id = request.id;
+                job.path = streamedTexture.path;
+                job.gammaCompress = streamedTexture.gammaCompress;
+                job.firstLevel = request.mipLevel;
+                job.endLevel = streamedTexture.residentMipLevel;
+                job.baselineSize = this->baselineSize;
+                this->queueJob(job);
+            }
+        }
+    }
+
+    TextureResidencyManager::Statistics TextureStreamer::getStatistics() const {
+        return this->residencyManager.getStatistics();
+    }
+
+    UInt64 TextureStreamer::getDecodedBytes() const {
+        return this->decodedBytes;
+    }
+
+    const Byte* TextureStreamer::MipChain::getLevel(UInt32 level) const {
+        return this->data.data() + this->levelOffsets[level - this->firstLevel];
+    }
+
+    void TextureStreamer::buildMipChain(const Byte* source, UInt32 width, UInt32 height, UInt32 firstLevel, UInt32 endLevel, MipChain& chain) {
+        UInt32 levelCount = TextureResidencyManager::calcMipLevelCount(width, height);
+        chain.width = width;
+        chain.height = height;
+        chain.endLevel = endLevel < levelCount ? endLevel : levelCount;
+        chain.firstLevel = firstLevel < chain.endLevel ? firstLevel : chain.endLevel;
+        chain.levelOffsets.clear();
+        UInt32 totalBytes = 0;
+        for (UInt32 i = chain.firstLevel; i < chain.endLevel; i++) {
+            chain.levelOffsets.push_back(totalBytes);
+            totalBytes += calcMipLevelBytes(chain, i);
+        }
+        chain.data.resize(totalBytes);
+        if (chain.firstLevel == 0 && chain.endLevel > 0) memcpy(chain.data.data(), source, width * height * 4);
+
+        // levels finer than the first kept one only pass through two scratch buffers
+        std::vector<Byte> scratch[2];
+        const Byte* current = source;
+        UInt32 levelWidth = width, levelHeight = height;
+        for (UInt32 i = 1; i < chain.endLevel; i++) {
+            Byte* dest;
+            if (i >= chain.firstLevel) {
+                dest = chain.data.data() + chain.levelOffsets[i - chain.firstLevel];
+            }
+            else {
+                scratch[i & 1].resize(calcMipLevelBytes(chain, i));
+                dest = scratch[i & 1].data();
+            }
+            TextureUtils::downsampleRGBA8(current, levelWidth, levelHeight, dest);
+            current = dest;
+            levelWidth = levelWidth > 1 ? levelWidth / 2 : 1;
+            levelHeight = levelHeight > 1 ? levelHeight / 2 : 1;
+        }
+    }
+
+    UInt32 TextureStreamer::calcMipLevelBytes(const MipChain& chain, UInt32 level) {
+        UInt32 levelWidth = chain.width >> level > 0 ? chain.width >> level : 1;
+        UInt32 levelHeight = chain.height >> level > 0 ? chain.height >> level : 1;
+        return levelWidth * levelHeight * 4;
+    }
+
+    void TextureStreamer::queueJob(const DecodeJob& job) {
+        this->startWorker();
+        {
+            std::lock_guard<std::mutex> lock(this->queueMutex);
+            this->pendingJobs.push_back(job);
+        }
+        this->queueCondition.notify_one();
+    }
+
+    void TextureStreamer::startWorker() {
+        if (this->workerRunning) return;
+        this->workerRunning = true;
+        this->worker = std::thread(&TextureStreamer::runWorker, this);
+    }
+
+    void TextureStreamer::stopWorker() {
+        if (!this->workerRunning) return;
+        {
+            std::lock_guard<std::mutex> lock(this->queueMutex);
+            this->workerRunning = false;
+        }
+        this->queueCondition.notify_all();
+        this->worker.join();
+    }
+
+    void TextureStreamer::runWorker() {
+        while (true) {
+            DecodeJob job;
+            {
+                std::unique_lock<std::mutex> lock(this->queueMutex);
+                this->queueCondition.wait(lock, [this]() {
+                    return !this->workerRunning || this->pendingJobs.size() > 0;
+                });
+                if (!this->workerRunning) return;
+                job = this->pendingJobs.front();
+                this->pendingJobs.pop_front();
+            }
+
+            DecodeResult result;
+            result.serial = job.serial;
+            result.id = job.id;
+            result.success = false;
+            try {
+                std::shared_ptr<StandardImage> image = ImageLoader::loadImageU(job.path, false, job.gammaCompress);
+                UInt32 width = image->getWidth(), height = image->getHeight();
+                if (job.id == TextureResidencyManager::InvalidStreamID) {
+                    UInt32 baselineMipLevel = TextureResidencyManager::calcBaselineMipLevel(width, height, job.baselineSize);
+                    buildMipChain(image->getImageBytes(), width, height, baselineMipLevel, TextureResidencyManager::calcMipLevelCount(width, height), result.chain);
+                }
+                else {
+                    buildMipChain(image->getImageBytes(), width, height, job.firstLevel, job.endLevel, result.chain);
+                }
+                result.success = true;
+            }
+            catch(...) {
+                // reported back as a failed decode; the texture keeps what it has
+            }
+
+            std::lock_guard<std::mutex> lock(this->queueMutex);
+            this->finishedResults.push_back(std::move(result));
+        }
+    }
+
+    // Registers a texture whose first decode finished and uploads its baseline levels, which are not kept.
+    void TextureStreamer::applyResult(DecodeResult& result) {
+        auto entry = this->pendingTextures.find(result.serial);
+        if (entry == this->pendingTextures.end()) return;
+        PendingTexture pendingTexture = entry->second;
+        this->pendingTextures.erase(entry);
+        if (!result.success || !pendingTexture.texture.isValid()) return;
+
+        MipChain& chain = result.chain;
+        TextureResidencyManager::StreamID id = this->residencyManager.registerTexture(chain.width, chain.height, 4, chain.firstLevel);
+
+        StreamedTexture& streamedTexture = this->streamedTextures[id];
+        streamedTexture.texture = pendingTexture.texture;
+        streamedTexture.objectID = pendingTexture.objectID;
+        streamedTexture.path = pendingTexture.path;
+        streamedTexture.gammaCompress = pendingTexture.gammaCompress;
+        streamedTexture.baselineMipLevel = chain.firstLevel;
+        streamedTexture.residentMipLevel = chain.firstLevel;
+        streamedTexture.loadMipLevel = chain.firstLevel;
+        streamedTexture.loadPending = false;
+        streamedTexture.loadSerial = 0;
+        streamedTexture.loadChain = MipChain();
+        this->streamIDsByObject[streamedTexture.objectID] = id;
+
+        streamedTexture.texture->buildStreamable(chain.width, chain.height);
+        for (UInt32 level = chain.endLevel; level > chain.firstLevel; level--) {
+            streamedTexture.texture->uploadMipLevel(level - 1, chain.getLevel(level - 1));
+            this->frameUploadBytes += calcMipLevelBytes(chain, level - 1);
+        }
+        streamedTexture.texture->setFirstResidentMipLevel(chain.firstLevel);
+    }
+
+    void TextureStreamer::applyLoadResult(DecodeResult& result) {
+        auto entry = this->streamedTextures.find(result.id);
+        // the texture may have been released, and its stream ID reused, since the load was requested
+        if (entry == this->streamedTextures.end() || !entry->second.loadPending || entry->second.loadSerial != result.serial) return;
+        StreamedTexture& streamedTexture = entry->second;
+        if (!result.success) {
+            this->finishLoad(streamedTexture, result.id, false);
+            return;
+        }
+        streamedTexture.loadChain = std::move(result.chain);
+        this->decodedBytes += streamedTexture.loadChain.data.size();
+        this->uploadQueue.push_back(result.id);
+    }
+
+    // Uploads decoded levels coarsest first, one level at a time, until this frame's upload limit is reached.
+    // Each level is sampled as soon as it is uploaded; the load completes with its last level.
+    void TextureStreamer::uploadPendingLevels() {
+        while (this->uploadQueue.size() > 0) {
+            TextureResidencyManager::StreamID id = this->uploadQueue.front();
+            auto entry = this->streamedTextures.find(id);
+            if (entry == this->streamedTextures.end() || !entry->second.loadPending || entry->second.loadChain.data.size() == 0) {
+                this->uploadQueue.pop_front();
+                continue;
+            }
+
+            StreamedTexture& streamedTexture = entry->second;
+            while (streamedTexture.residentMipLevel > streamedTexture.loadMipLevel) {
+                UInt32 level = streamedTexture.residentMipLevel - 1;
+                UInt32 levelBytes = calcMipLevelBytes(streamedTexture.loadChain, level);
+                if (this->frameUploadBytes > 0 && this->frameUploadBytes + levelBytes > this->maxUploadBytesPerFrame) return;
+                streamedTexture.texture->uploadMipLevel(level, streamedTexture.loadChain.getLevel(level));
+                streamedTexture.texture->setFirstResidentMipLevel(level);
+                streamedTexture.residentMipLevel = level;
+                this->frameUploadBytes += levelBytes;
+            }
+            this->finishLoad(streamedTexture, id, true);
+            this->uploadQueue.pop_front();
+        }
+    }
+
+    void TextureStreamer::finishLoad(StreamedTexture& streamedTexture, TextureResidencyManager::StreamID id, Bool success) {
+        this->decodedBytes -= streamedTexture.loadChain.data.size();
+        streamedTexture.loadChain = MipChain();
+        streamedTexture.loadPending = false;
+        if (success) this->residencyManager.completeLoad(id, streamedTexture.loadMipLevel);
+        else this->residencyManager.cancelLoad(id);
+    }
+
+    void TextureStreamer::releaseTexture(TextureResidencyManager::StreamID id) {
+        auto entry = this->streamedTextures.find(id);
+        if (entry == this->streamedTextures.end()) return;
+        this->decodedBytes -= entry->second.loadChain.data.size();
+        this->streamIDsByObject.erase(entry->second.objectID);
+        this->streamedTextures.erase(entry);
+        this->residencyManager.unregisterTexture(id);
+    }
+}
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <unordered_map>
+
+#include "../common/types.h"
+#include "../util/WeakPointer.h"
+#include "../util/PersistentWeakPointer.h"
+#include "TextureAttr.h"
+#include "TextureResidencyManager.h"
+
+namespace Core {
+
+    // forward declarations
+    class Texture;
+    class Texture2D;
+
+    // Streams the mip levels of 2D textures under a global memory budget. Images are decoded on a background
+    // thread; until the first decode finishes the texture holds a 1x1 placeholder. After that only the levels
+    // from a small baseline down to 1x1 are kept in memory and resident. When the renderer reports that a
+    // texture covers enough of the screen, the image is decoded again for just the finer levels it needs,
+    // which are uploaded one level at a time, coarsest first, under a per-frame upload limit, and freed once
+    // uploaded. When the budget runs out, least recently used textures drop back to their baseline.
+    class TextureStreamer {
+    public:
+        TextureStreamer();
+        ~TextureStreamer();
+
+        void setEnabled(Bool enabled);
+        Bool isEnabled() const;
+        void setBudget(UInt64 budgetBytes);
+        void setBaselineSize(UInt32 baselineSize);
+        void setMaxUploadBytesPerFrame(UInt64 maxUploadBytes);
+
+        WeakPointer<Texture2D> loadTexture(const std::string& path, const TextureAttributes& attributes, Bool gammaCompress);
+        void reportScreenSize(WeakPointer<Texture> texture, Real screenSize);
+        void update();
+
+        TextureResidencyManager::Statistics getStatistics() const;
+        // bytes of decoded levels currently held in memory
+        UInt64 getDecodedBytes() const;
+
+    private:
+        // Contiguous RGBA8 mip levels, from 'firstLevel' of a 'width' x 'height' image down to (but not
+        // including) 'endLevel'.
+        class MipChain {
+        public:
+            const Byte* getLevel(UInt32 level) const;
+
+            UInt32 width;
+            UInt32 height;
+            UInt32 firstLevel;
+            UInt32 endLevel;
+            std::vector<Byte> data;
+            std::vector<UInt32> levelOffsets;
+        };
+
+        class StreamedTexture {
+        public:
+            PersistentWeakPointer<Texture2D> texture;
+            UInt64 objectID;
+            std::string path;
+            Bool gammaCompress;
+            UInt32 baselineMipLevel;
+            // finest level uploaded to the texture, which may be ahead of the residency manager's while
+            // a load is being uploaded
+            UInt32 residentMipLevel;
+            UInt32 loadMipLevel;
+            Bool loadPending;
+            UInt64 loadSerial;
+            // the levels of the pending load, once decoded
+            MipChain loadChain;
+        };
+
+        // A texture whose image is still being decoded by the worker.
+        class PendingTexture {
+        public:
+            PersistentWeakPointer<Texture2D> texture;
+            UInt64 objectID;
+            std::string path;
+            Bool gammaCompress;
+        };
+
+        // Decodes 'path' and keeps levels 'firstLevel' up to 'endLevel'. The first decode of a texture has
+        // no stream ID yet, and keeps the levels from the baseline for 'baselineSize' down to 1x1.
+        class DecodeJob {
+        public:
+            UInt64 serial;
+            TextureResidencyManager::StreamID id;
+            std::string path;
+            Bool gammaCompress;
+            UInt32 firstLevel;
+            UInt32 endLevel;
+            UInt32 baselineSize;
+        };
+
+        class DecodeResult {
+        public:
+            UInt64 serial;
+            TextureResidencyManager::StreamID id;
+            Bool success;
+            MipChain chain;
+        };
+
+        static void buildMipChain(const Byte* source, UInt32 width, UInt32 height, UInt32 firstLevel, UInt32 endLevel, MipChain& chain);
+        static UInt32 calcMipLevelBytes(const MipChain& chain, UInt32 level);
+        void queueJob(const DecodeJob& job);
+        void startWorker();
+        void stopWorker();
+        void runWorker();
+        void applyResult(DecodeResult& result);
+        void applyLoadResult(DecodeResult& result);
+        void uploadPendingLevels();
+        void finishLoad(StreamedTexture& streamedTexture, TextureResidencyManager::StreamID id, Bool success);
+        void releaseTexture(TextureResidencyManager::StreamID id);
+
+        Bool enabled;
+        UInt32 baselineSize;
+        UInt64 maxUploadBytesPerFrame;
+        UInt64 frameUploadBytes;
+        UInt64 decodedBytes;
+        UInt64 nextSerial;
+        TextureResidencyManager residencyManager;
+        std::unordered_map<UInt64, PendingTexture> pendingTextures;
+        std::unordered_map<TextureResidencyManager::StreamID, StreamedTexture> streamedTextures;
+        std::unordered_map<UInt64, TextureResidencyManager::StreamID> streamIDsByObject;
+        std::vector<TextureResidencyManager::Request> requests;
+        std::vector<DecodeResult> completedResults;
+        // decoded loads waiting for their levels to be uploaded, oldest first
+        std::deque<TextureResidencyManager::StreamID> uploadQueue;
+
+        std::thread worker;
+        Bool workerRunning;
+        std::mutex queueMutex;
+        std::condition_variable queueCondition;
+        std::deque<DecodeJob> pendingJobs;
+        std::vector<DecodeResult> finishedResults;
+    };
+}
@@ -73,4 +73,24 @@ namespace Core {
         return cubeMap;
     }
 
-}
\ No newline at end of file
+    void TextureUtils::downsampleRGBA8(const Byte* source, UInt32 width, UInt32 height, Byte* dest) {
+        UInt32 destWidth = width > 1 ? width / 2 : 1;
+        UInt32 destHeight = height > 1 ? height / 2 : 1;
+        UInt32 xStep = width > 1 ? 1 : 0;
+        UInt32 yStep = height > 1 ? width : 0;
+        for (UInt32 y = 0; y < destHeight; y++) {
+            const Byte* sourceRow = source + (y * (height > 1 ? 2 : 1)) * width * 4;
+            Byte* destRow = dest + y * destWidth * 4;
+            for (UInt32 x = 0; x < destWidth; x++) {
+                const Byte* p00 = sourceRow + x * (width > 1 ? 2 : 1) * 4;
+                const Byte* p01 = p00 + xStep * 4;
+                const Byte* p10 = p00 + yStep * 4;
+                const Byte* p11 = p10 + xStep * 4;
+                for (UInt32 c = 0; c < 4; c++) {
+                    destRow[x * 4 + c] = (Byte)(((UInt32)p00[c] + (UInt32)p01[c] + (UInt32)p10[c] + (UInt32)p11[c] + 2) / 4);
+                }
+            }
+        }
+    }
+
+}
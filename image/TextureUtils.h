@@ -12,5 +12,9 @@ namespace Core {
     public:
         static WeakPointer<CubeTexture> loadFromEquirectangularImage(const std::string& filePath, Bool isHDR, float yRotation = 0.0f);
 
+        // 2x2 box filter from an RGBA8 image into the next mip level, which must hold
+        // max(width / 2, 1) x max(height / 2, 1) pixels.
+        static void downsampleRGBA8(const Byte* source, UInt32 width, UInt32 height, Byte* dest);
+
     };
 }
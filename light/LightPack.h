@@ -2,6 +2,7 @@
 
 #include <vector>
 #include "../util/WeakPointer.h"
+#include "../util/FrameArena.h"
 #include "../light/Light.h"
 #include "../light/ShadowLight.h"
 #include "../light/DirectionalLight.h"
@@ -22,12 +23,27 @@ namespace Core {
 
     public:
 
+        typedef std::vector<WeakPointer<Light>, FrameArenaAllocator<WeakPointer<Light>>> LightList;
+        typedef std::vector<WeakPointer<DirectionalLight>, FrameArenaAllocator<WeakPointer<DirectionalLight>>> DirectionalLightList;
+        typedef std::vector<WeakPointer<PointLight>, FrameArenaAllocator<WeakPointer<PointLight>>> PointLightList;
+        typedef std::vector<WeakPointer<AmbientLight>, FrameArenaAllocator<WeakPointer<AmbientLight>>> AmbientLightList;
+        typedef std::vector<WeakPointer<AmbientIBLLight>, FrameArenaAllocator<WeakPointer<AmbientIBLLight>>> AmbientIBLLightList;
+        typedef std::vector<WeakPointer<ShadowLight>, FrameArenaAllocator<WeakPointer<ShadowLight>>> ShadowLightList;
+
+        // A light pack built for a single frame can keep its lists in that frame's arena, in which
+        // case it has to be created in the same arena (see ViewFrameContext::createLightPack()).
+        LightPack(FrameArena* arena = nullptr):
+            directionalLights(arena), pointLights(arena), ambientLights(arena), ambientIBLLights(arena),
+            shadowLights(arena), nonIBLLights(arena), lights(arena) {
+        }
+
         void clear() {
             this->directionalLights.resize(0);
             this->pointLights.resize(0);
             this->ambientLights.resize(0);
             this->ambientIBLLights.resize(0);
             this->shadowLights.resize(0);
+            this->nonIBLLights.resize(0);
             this->lights.resize(0);
         }
 
@@ -42,7 +58,7 @@ namespace Core {
             return this->lights[index];
         }
 
-        const std::vector<WeakPointer<Light>>& getLights() const {
+        const LightList& getLights() const {
             return this->lights;
         }
 
@@ -53,7 +69,7 @@ namespace Core {
             return this->shadowLights[index];
         }
 
-        const std::vector<WeakPointer<Light>>& getNonIBLLights() const {
+        const LightList& getNonIBLLights() const {
             return this->nonIBLLights;
         }
 
@@ -64,7 +80,7 @@ namespace Core {
             return this->directionalLights[index];
         }
 
-        const std::vector<WeakPointer<DirectionalLight>>& getDirectionalLights() const {
+        const DirectionalLightList& getDirectionalLights() const {
             return this->directionalLights;
         }
 
@@ -75,7 +91,7 @@ namespace Core {
             this->nonIBLLights.push_back(light);
         }
 
-        const std::vector<WeakPointer<PointLight>>& getPointLights() const {
+        const PointLightList& getPointLights() const {
             return this->pointLights;
         }
 
@@ -119,13 +135,13 @@ namespace Core {
         }
 
     private:
-        std::vector<WeakPointer<DirectionalLight>> directionalLights;
-        std::vector<WeakPointer<PointLight>> pointLights;
-        std::vector<WeakPointer<AmbientLight>> ambientLights;
-        std::vector<WeakPointer<AmbientIBLLight>> ambientIBLLights;
-        std::vector<WeakPointer<ShadowLight>> shadowLights;
-        std::vector<WeakPointer<Light>> nonIBLLights;
-        std::vector<WeakPointer<Light>> lights;
+        DirectionalLightList directionalLights;
+        PointLightList pointLights;
+        AmbientLightList ambientLights;
+        AmbientIBLLightList ambientIBLLights;
+        ShadowLightList shadowLights;
+        LightList nonIBLLights;
+        LightList lights;
     };
 
 }
\ No newline at end of file
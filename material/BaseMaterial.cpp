@@ -24,7 +24,7 @@ namespace Core {
         this->cameraPositionLocation = -1;
 
         this->skinningEnabledLocation = -1;
-        for (UInt32 i = 0; i < Constants::MaxBones; i++) this->bonesLocation[i] = -1;
+        this->bonesLocation = -1;
         this->boneIndexLocation = -1;
         this->boneWeightLocation = -1;
         this->ssaoEnabledLocation = -1;
@@ -74,7 +74,7 @@ namespace Core {
             case StandardUniform::SkinningEnabled:
                 return this->skinningEnabledLocation;
             case StandardUniform::Bones:
-                return this->bonesLocation[offset];
+                return this->bonesLocation;
             case StandardUniform::SSAOMap:
                 return this->ssaoMapLocation;
             case StandardUniform::SSAOEnabled:
@@ -103,9 +103,7 @@ namespace Core {
             baseMaterial->boneIndexLocation = this->boneIndexLocation;
             baseMaterial->boneWeightLocation = this->boneWeightLocation;
             baseMaterial->skinningEnabledLocation = this->skinningEnabledLocation;
-            for (UInt32 i = 0; i < Constants::MaxBones; i++) {
-                baseMaterial->bonesLocation[i] = this->bonesLocation[i];
-            }
+            baseMaterial->bonesLocation = this->bonesLocation;
             baseMaterial->ssaoMapLocation = this->ssaoMapLocation;
             baseMaterial->ssaoEnabledLocation = this->ssaoEnabledLocation;
         } else {
@@ -129,10 +127,9 @@ namespace Core {
         this->boneIndexLocation = this->shader->getAttributeLocation(StandardAttribute::BoneIndex);
         this->boneWeightLocation = this->shader->getAttributeLocation(StandardAttribute::BoneWeight);
         this->skinningEnabledLocation = this->shader->getUniformLocation(StandardUniform::SkinningEnabled);
-        for (UInt32 i = 0; i < Constants::MaxBones; i++) {
-          this->bonesLocation[i] = this->shader->getUniformLocation(StandardUniform::Bones, i);
-        }
+        this->bonesLocation = this->shader->getUniformLocation(StandardUniform::Bones);
         this->ssaoMapLocation = this->shader->getUniformLocation(StandardUniform::SSAOMap);
         this->ssaoEnabledLocation = this->shader->getUniformLocation(StandardUniform::SSAOEnabled);
+        this->shaderVarLocationsBound = this->shader->isReady();
     }
 }
\ No newline at end of file
@@ -40,7 +40,7 @@ namespace Core {
         Int32 ssaoEnabledLocation;
 
         Int32 skinningEnabledLocation;
-        Int32 bonesLocation[Constants::MaxBones];
+        Int32 bonesLocation;
         Int32 boneIndexLocation;
         Int32 boneWeightLocation;
     };
@@ -2,6 +2,7 @@
 #include "../material/Shader.h"
 #include "StandardAttributes.h"
 #include "../image/Texture.h"
+#include "../image/TextureStreamer.h"
 #include "../Engine.h"
 #include "../Graphics.h"
 #include "../material/ShaderManager.h"
@@ -119,4 +120,9 @@ namespace Core {
     UInt32 BasicTexturedLitMaterial::textureCount() {
         return 1;
     }
+
+    void BasicTexturedLitMaterial::reportTextureScreenSize(TextureStreamer& textureStreamer, Real screenSize) {
+        if (this->albedoMapEnabled) textureStreamer.reportScreenSize(this->albedoMap, screenSize);
+        if (this->normalMapEnabled) textureStreamer.reportScreenSize(this->normalMap, screenSize);
+    }
 }
\ No newline at end of file
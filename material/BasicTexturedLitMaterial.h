@@ -23,6 +23,7 @@ namespace Core {
         virtual WeakPointer<Material> clone() override;
         virtual void bindShaderVarLocations() override;
         virtual UInt32 textureCount() override;
+        virtual void reportTextureScreenSize(TextureStreamer& textureStreamer, Real screenSize) override;
 
         void setAlbedoMapEnabled(Bool enabled);
         void setAlbedoMap(WeakPointer<Texture> albedoMap);
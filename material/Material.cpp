@@ -4,6 +4,7 @@
 #include "Material.h"
 #include "Shader.h"
 #include "../Graphics.h"
+#include "ShaderManager.h"
 #include "../render/EngineRenderQueue.h"
 #include "../common/debug.h"
 
@@ -16,6 +17,7 @@ namespace Core {
         this->renderPath = RenderPath::Forward;
         this->renderQueueID = (UInt16)EngineRenderQueue::Geometry;
         this->ready = false;
+        this->shaderVarLocationsBound = false;
         this->customDepthOutput = false;
         this->customDepthOutputCopyOverrideMaterialState = false;
         this->customDepthOutputStateCopyExcludeFaceCulling = false;
@@ -39,6 +41,25 @@ namespace Core {
 
     }
 
+    void Material::bindShaderVarLocations() {
+
+    }
+
+    /*
+     * Make sure the shader is built, and its variable locations bound, before drawing with this material.
+     * If [wait] is false and the shader is still compiling, returns false so that the caller can draw
+     * something else in the meantime.
+     */
+    Bool Material::prepareShader(Bool wait) {
+        if (this->shaderVarLocationsBound || !this->shader.isValid()) return true;
+        WeakPointer<Graphics> graphics = Engine::instance()->getGraphicsSystem();
+        if (!graphics->getShaderManager().requestShader(this->shader, wait)) return false;
+        graphics->activateShader(this->shader);
+        this->bindShaderVarLocations();
+        this->shaderVarLocationsBound = true;
+        return true;
+    }
+
     Bool Material::getColorWriteEnabled() const {
         return this->materialState.colorWriteEnabled;
     }
@@ -265,6 +286,7 @@ namespace Core {
     void Material::copyTo(WeakPointer<Material> target) {
         target->ready = this->ready;
         target->shader = this->shader;
+        target->shaderVarLocationsBound = this->shaderVarLocationsBound;
         target->lit = this->lit;
         target->physical = this->physical;
         target->skinningEnabled = this->skinningEnabled;
@@ -328,6 +350,10 @@ namespace Core {
         return WeakPointer<Texture>::nullPtr();
     }
 
+    void Material::reportTextureScreenSize(TextureStreamer& textureStreamer, Real screenSize) {
+
+    }
+
     MaterialState Material::getState() const {
         return this->materialState;
     }
@@ -15,6 +15,7 @@ namespace Core {
     class Shader;
     class Graphics;
     class Texture;
+    class TextureStreamer;
 
     class Material : public CoreObject {
     public:
@@ -27,7 +28,9 @@ namespace Core {
         virtual Int32 getShaderLocation(StandardAttribute attribute, UInt32 offset = 0) = 0;
         virtual Int32 getShaderLocation(StandardUniform uniform, UInt32 offset = 0) = 0;
         virtual void sendCustomUniformsToShader();
+        virtual void bindShaderVarLocations();
         virtual WeakPointer<Material> clone() = 0;
+        Bool prepareShader(Bool wait);
         virtual UInt32 textureCount();
 
         Bool getColorWriteEnabled() const;
@@ -97,6 +100,7 @@ namespace Core {
 
         virtual Bool hasOpacityMap() const;
         virtual WeakPointer<Texture> getOpacityMap();
+        virtual void reportTextureScreenSize(TextureStreamer& textureStreamer, Real screenSize);
 
         MaterialState getState() const;
         void setState(MaterialState state);
@@ -108,6 +112,8 @@ namespace Core {
         void setShader(WeakPointer<Shader> shader);
 
         PersistentWeakPointer<Shader> shader;
+        // set once the shader variable locations have been looked up in a built shader
+        Bool shaderVarLocationsBound;
 
     private:
         Bool ready;
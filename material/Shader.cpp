@@ -38,4 +38,24 @@ namespace Core {
     Bool Shader::isReady() const {
         return this->ready;
     }
+
+    /*
+     * Start building the shader. A backend that can build in the background returns before the build is
+     * done; isBuildComplete() then reports when finishBuild() can collect the result without waiting. The
+     * default builds right away.
+     */
+    Bool Shader::beginBuild() {
+        return this->build();
+    }
+
+    Bool Shader::isBuildComplete() {
+        return true;
+    }
+
+    /*
+     * Wait for a build started by beginBuild() and return whether it succeeded.
+     */
+    Bool Shader::finishBuild() {
+        return this->ready;
+    }
 }
\ No newline at end of file
@@ -36,6 +36,9 @@ namespace Core {
         Bool isReady() const;
 
         virtual Bool build() = 0;
+        virtual Bool beginBuild();
+        virtual Bool isBuildComplete();
+        virtual Bool finishBuild();
         virtual UInt32 getProgram() const = 0;
         virtual Int32 getUniformLocation(const std::string& var) const = 0;
         virtual Int32 getUniformLocation(const std::string& var, UInt32 index) const = 0;
@@ -1,5 +1,8 @@
+#include <algorithm>
 #include <regex>
 #include <sstream>
+#include <stdio.h>
+#include <string.h>
 
 #include "ShaderManager.h"
 #include "../util/String.h"
@@ -13,11 +16,19 @@ static const Core::UInt32 ASCII_Z = 90;
 static const Core::UInt32 ASCII_a = 97;
 static const Core::UInt32 ASCII_z = 122;
 
+static const Core::UInt32 PREPROCESSED_MAGIC = 0x45525053; // "SPRE"
+static const Core::UInt32 PREPROCESSED_VERSION = 1;
+
 namespace Core {
 
     const std::string ShaderManager::INCLUDE_PARAMS_PATTERN(".*");
     const std::string ShaderManager::INCLUDE_VAL_PATTERN(std::string("\"[0-9a-zA-Z]+(\\(") + INCLUDE_PARAMS_PATTERN + std::string("\\)){0,1}\""));
 
+    ShaderManager::ShaderManager() {
+        this->lazyCompilation = false;
+        this->warmupBuildsPerUpdate = 2;
+    }
+
     ShaderManager::~ShaderManager() {
         for(std::unordered_map<std::string, ShaderManager::Entry>::const_iterator iter = this->entries.begin(); iter != this->entries.end(); ++iter) {
             std::pair<std::string, ShaderManager::Entry> key = *iter;
@@ -30,6 +41,8 @@ namespace Core {
     }
 
     void ShaderManager::setShaderSource(ShaderType type, const std::string& name, const char shaderSrc[]) {
+        // any change can reach other programs through their includes
+        this->preprocessedEntries.clear();
         Entry& entry = this->entries[name];
         switch (type) {
             case ShaderType::Vertex:
@@ -47,7 +60,13 @@ namespace Core {
         }
     }
 
+    /*
+     * Returns the preprocessed source of [name] when one has been loaded, and expands the registered source
+     * otherwise.
+     */
     std::string ShaderManager::getShaderSource(ShaderType type, const std::string& name) {
+        std::string source;
+        if (this->getPreprocessedSource(type, name, source)) return source;
         IncludeParameterCollection params;
         return this->getShaderSource(type, name, params);
     }
@@ -78,6 +97,26 @@ namespace Core {
         throw ShaderManagerException(std::string("Could not locate requested shader source ") + name);
     }
 
+    /*
+     * Whether a source was registered for [type] of [name] itself, not counting the base source that
+     * getShaderSource() falls back to.
+     */
+    Bool ShaderManager::hasShaderSource(ShaderType type, const std::string& name) const {
+        auto iter = this->entries.find(name);
+        if (iter == this->entries.end()) return false;
+        switch (type) {
+            case ShaderType::Vertex:
+                return iter->second.vertexSource.size() > 0;
+            case ShaderType::Geometry:
+                return iter->second.geometrySource.size() > 0;
+            case ShaderType::Fragment:
+                return iter->second.fragmentSource.size() > 0;
+            case ShaderType::Base:
+                return iter->second.baseSource.size() > 0;
+        }
+        return false;
+    }
+
     WeakPointer<Shader> ShaderManager::getShader(const std::string& name) {
         if (this->entries.find(name) != this->entries.end()) {
             Entry& entry = this->entries[name];
@@ -99,7 +138,8 @@ namespace Core {
                     shader = Engine::instance()->getGraphicsSystem()->createShader(vertexSrc, geometrySrc, fragmentSrc);
                 }
 
-                Bool success = shader->build();
+                // in lazy mode the shader is built on first use, by requestShader() or the warmup queue
+                Bool success = this->lazyCompilation || shader->build();
                 if (success) {
                     entry.shader = shader;
                 } else {
@@ -114,6 +154,335 @@ namespace Core {
         throw ShaderManagerException(std::string("Could not locate requested shader ") + name);
     }
 
+    /*
+     * In lazy mode getShader() creates shaders without building them, so that only the programs that are
+     * actually drawn with (or warmed up) are ever compiled.
+     */
+    void ShaderManager::setLazyCompilation(Bool lazy) {
+        this->lazyCompilation = lazy;
+    }
+
+    Bool ShaderManager::isLazyCompilation() const {
+        return this->lazyCompilation;
+    }
+
+    /*
+     * Called when [name] is about to be drawn with. Starts building the shader if that hasn't happened yet;
+     * returns true once it is ready. With [wait] set the build is always finished before returning, otherwise
+     * false is returned while the driver is still compiling it.
+     */
+    Bool ShaderManager::requestShader(const std::string& name, Bool wait) {
+        this->getShader(name);
+        return this->prepareEntry(name, this->entries[name], wait);
+    }
+
+    Bool ShaderManager::requestShader(const char name[], Bool wait) {
+        return this->requestShader(std::string(name), wait);
+    }
+
+    Bool ShaderManager::requestShader(WeakPointer<Shader> shader, Bool wait) {
+        if (!shader.isValid()) return false;
+        std::string name;
+        if (this->findShaderName(shader, name)) return this->prepareEntry(name, this->entries[name], wait);
+
+        // not one of ours (e.g. built from source by a material)
+        if (shader->isReady()) return true;
+        if (!shader->beginBuild()) return false;
+        if (!wait && !shader->isBuildComplete()) return false;
+        return shader->finishBuild();
+    }
+
+    /*
+     * Queue [name] to be built by update() ahead of its first use. Returns false if there's no such shader.
+     */
+    Bool ShaderManager::enqueueWarmup(const std::string& name) {
+        auto iter = this->entries.find(name);
+        if (iter == this->entries.end()) return false;
+        const Entry& entry = iter->second;
+        if (entry.building || (entry.shader.isValid() && entry.shader->isReady())) return true;
+        if (std::find(this->warmupQueue.begin(), this->warmupQueue.end(), name) == this->warmupQueue.end()) {
+            this->warmupQueue.push_back(name);
+        }
+        return true;
+    }
+
+    Bool ShaderManager::enqueueWarmup(const char name[]) {
+        return this->enqueueWarmup(std::string(name));
+    }
+
+    Bool ShaderManager::enqueueWarmup(WeakPointer<Shader> shader) {
+        std::string name;
+        if (!shader.isValid() || !this->findShaderName(shader, name)) return false;
+        return this->enqueueWarmup(name);
+    }
+
+    void ShaderManager::setWarmupBuildsPerUpdate(UInt32 builds) {
+        this->warmupBuildsPerUpdate = builds;
+    }
+
+    UInt32 ShaderManager::getWarmupBuildsPerUpdate() const {
+        return this->warmupBuildsPerUpdate;
+    }
+
+    /*
+     * Called once per frame: finishes the builds the driver has completed and starts at most
+     * [warmupBuildsPerUpdate] of the queued warmup builds. Without parallel compilation each of those
+     * builds happens right here, so the budget also bounds how long a frame can stall on them.
+     */
+    void ShaderManager::update() {
+        for (auto iter = this->pendingBuilds.begin(); iter != this->pendingBuilds.end();) {
+            Entry& entry = this->entries[*iter];
+            if (!entry.building) {
+                iter = this->pendingBuilds.erase(iter);
+            }
+            else if (entry.shader->isBuildComplete()) {
+                std::string name = *iter;
+                iter = this->pendingBuilds.erase(iter);
+                this->finishEntryBuild(name, entry);
+            }
+            else {
+                ++iter;
+            }
+        }
+
+        UInt32 started = 0;
+        while (started < this->warmupBuildsPerUpdate && this->warmupQueue.size() > 0) {
+            std::string name = this->warmupQueue.front();
+            this->warmupQueue.pop_front();
+            WeakPointer<Shader> shader = this->getShader(name);
+            Entry& entry = this->entries[name];
+            if (entry.building || shader->isReady()) continue;
+            this->beginEntryBuild(name, entry);
+            started++;
+        }
+    }
+
+    UInt32 ShaderManager::getWarmupQueueLength() const {
+        return (UInt32)this->warmupQueue.size();
+    }
+
+    UInt32 ShaderManager::getPendingBuildCount() const {
+        UInt32 count = 0;
+        for (const std::string& name : this->pendingBuilds) {
+            if (this->entries.at(name).building) count++;
+        }
+        return count;
+    }
+
+    /*
+     * The shaders that have been drawn with (through requestShader()), in the order they were first asked for.
+     */
+    const std::vector<std::string>& ShaderManager::getRequestedShaderNames() const {
+        return this->requestedNames;
+    }
+
+    Bool ShaderManager::findShaderName(WeakPointer<Shader> shader, std::string& name) const {
+        for (auto iter = this->entries.begin(); iter != this->entries.end(); ++iter) {
+            if (iter->second.shader.isValid() && iter->second.shader.get() == shader.get()) {
+                name = iter->first;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    Bool ShaderManager::prepareEntry(const std::string& name, Entry& entry, Bool wait) {
+        if (!entry.requested) {
+            entry.requested = true;
+            this->requestedNames.push_back(name);
+        }
+        if (entry.shader->isReady()) return true;
+        if (!entry.building) this->beginEntryBuild(name, entry);
+        if (entry.shader->isReady()) return true;
+        if (!wait && !entry.shader->isBuildComplete()) return false;
+        this->finishEntryBuild(name, entry);
+        return true;
+    }
+
+    void ShaderManager::beginEntryBuild(const std::string& name, Entry& entry) {
+        if (!entry.shader->beginBuild()) {
+            throw ShaderManagerException(std::string("Unable to build shader: ") + name);
+        }
+        // without parallel compilation the build completes inside beginBuild()
+        if (!entry.shader->isReady()) {
+            entry.building = true;
+            this->pendingBuilds.push_back(name);
+        }
+    }
+
+    void ShaderManager::finishEntryBuild(const std::string& name, Entry& entry) {
+        entry.building = false;
+        if (!entry.shader->finishBuild()) {
+            throw ShaderManagerException(std::string("Unable to build shader: ") + name);
+        }
+    }
+
+    /*
+     * The names of the entries that getShader() can build, i.e. that have both a vertex and a fragment
+     * source, in sorted order.
+     */
+    std::vector<std::string> ShaderManager::getProgramNames() const {
+        std::vector<std::string> names;
+        for (auto& iter : this->entries) {
+            if (iter.second.vertexSource.size() > 0 && iter.second.fragmentSource.size() > 0) names.push_back(iter.first);
+        }
+        std::sort(names.begin(), names.end());
+        return names;
+    }
+
+    /*
+     * FNV-1a hash over every registered source, visited in name order. A preprocessed source file is only
+     * accepted when it was written for the same hash.
+     */
+    UInt64 ShaderManager::getSourceHash() const {
+        UInt64 hash = 14695981039346656037ULL;
+        auto hashString = [&hash](const std::string& value) {
+            // the terminator keeps adjacent strings from running into each other
+            for (size_t i = 0; i <= value.size(); i++) {
+                hash ^= (Byte)value.c_str()[i];
+                hash *= 1099511628211ULL;
+            }
+        };
+        std::vector<std::string> names;
+        for (auto& iter : this->entries) names.push_back(iter.first);
+        std::sort(names.begin(), names.end());
+        for (const std::string& name : names) {
+            const Entry& entry = this->entries.at(name);
+            hashString(name);
+            hashString(entry.baseSource);
+            hashString(entry.vertexSource);
+            hashString(entry.geometrySource);
+            hashString(entry.fragmentSource);
+        }
+        return hash;
+    }
+
+    /*
+     * Expand the sources of every program and write them to [path], so that a later run can skip the
+     * include and parameter expansion (see loadPreprocessedSources()).
+     */
+    Bool ShaderManager::savePreprocessedSources(const std::string& path) {
+        std::vector<Byte> buffer;
+        auto append = [&buffer](const void* data, UInt32 size) {
+            const Byte* bytes = (const Byte*)data;
+            buffer.insert(buffer.end(), bytes, bytes + size);
+        };
+        auto appendString = [&append](const std::string& value) {
+            UInt32 length = (UInt32)value.size();
+            append(&length, sizeof(UInt32));
+            append(value.data(), length);
+        };
+
+        std::vector<std::string> names = this->getProgramNames();
+        UInt64 sourceHash = this->getSourceHash();
+        UInt32 count = (UInt32)names.size();
+        append(&PREPROCESSED_MAGIC, sizeof(UInt32));
+        append(&PREPROCESSED_VERSION, sizeof(UInt32));
+        append(&sourceHash, sizeof(UInt64));
+        append(&count, sizeof(UInt32));
+        for (const std::string& name : names) {
+            IncludeParameterCollection params;
+            const Entry& entry = this->entries[name];
+            appendString(name);
+            appendString(this->getShaderSource(ShaderType::Vertex, name, params));
+            appendString(entry.geometrySource.size() > 0 ? this->getShaderSource(ShaderType::Geometry, name, params) : std::string());
+            appendString(this->getShaderSource(ShaderType::Fragment, name, params));
+        }
+
+        std::string tempPath = path + ".tmp";
+        FILE* file = fopen(tempPath.c_str(), "wb");
+        if (file == nullptr) return false;
+        Bool success = fwrite(buffer.data(), 1, buffer.size(), file) == buffer.size();
+        success = fclose(file) == 0 && success;
+        if (success) success = rename(tempPath.c_str(), path.c_str()) == 0;
+        if (!success) remove(tempPath.c_str());
+        return success;
+    }
+
+    /*
+     * Use the expanded sources saved to [path] in place of the runtime expansion. Returns false, and keeps
+     * expanding at runtime, if the file is missing or damaged, or was written from different sources.
+     */
+    Bool ShaderManager::loadPreprocessedSources(const std::string& path) {
+        FILE* file = fopen(path.c_str(), "rb");
+        if (file == nullptr) return false;
+        std::vector<Byte> buffer;
+        Bool success = fseek(file, 0, SEEK_END) == 0;
+        long size = success ? ftell(file) : -1;
+        if (size >= 0 && fseek(file, 0, SEEK_SET) == 0) {
+            buffer.resize((size_t)size);
+            success = fread(buffer.data(), 1, buffer.size(), file) == buffer.size();
+        } else {
+            success = false;
+        }
+        fclose(file);
+        if (!success) return false;
+
+        size_t offset = 0;
+        auto read = [&buffer, &offset](void* value, size_t size) -> Bool {
+            if (buffer.size() - offset < size) return false;
+            memcpy(value, buffer.data() + offset, size);
+            offset += size;
+            return true;
+        };
+        auto readString = [&buffer, &offset, &read](std::string& value) -> Bool {
+            UInt32 length;
+            if (!read(&length, sizeof(UInt32)) || buffer.size() - offset < length) return false;
+            value.assign((const char*)buffer.data() + offset, length);
+            offset += length;
+            return true;
+        };
+
+        UInt32 magic, version, count;
+        UInt64 sourceHash;
+        if (!read(&magic, sizeof(UInt32)) || !read(&version, sizeof(UInt32)) || !read(&sourceHash, sizeof(UInt64)) ||
+            !read(&count, sizeof(UInt32))) return false;
+        if (magic != PREPROCESSED_MAGIC || version != PREPROCESSED_VERSION || sourceHash != this->getSourceHash()) return false;
+
+        std::unordered_map<std::string, PreprocessedEntry> loaded;
+        for (UInt32 i = 0; i < count; i++) {
+            std::string name;
+            PreprocessedEntry entry;
+            if (!readString(name) || !readString(entry.vertexSource) || !readString(entry.geometrySource) ||
+                !readString(entry.fragmentSource)) return false;
+            loaded[name] = entry;
+        }
+        this->preprocessedEntries = loaded;
+        return true;
+    }
+
+    /*
+     * Copy the loaded preprocessed source for [type] of [name] into [source], without falling back to the
+     * runtime expansion. Returns false if there is none.
+     */
+    Bool ShaderManager::getPreprocessedSource(ShaderType type, const std::string& name, std::string& source) const {
+        auto preprocessed = this->preprocessedEntries.find(name);
+        if (preprocessed == this->preprocessedEntries.end()) return false;
+        const PreprocessedEntry& entry = preprocessed->second;
+        switch (type) {
+            case ShaderType::Vertex:
+                source = entry.vertexSource;
+                break;
+            case ShaderType::Geometry:
+                source = entry.geometrySource;
+                break;
+            case ShaderType::Fragment:
+                source = entry.fragmentSource;
+                break;
+            default:
+                return false;
+        }
+        return source.size() > 0;
+    }
+
+    Bool ShaderManager::hasPreprocessedSources() const {
+        return this->preprocessedEntries.size() > 0;
+    }
+
+    void ShaderManager::clearPreprocessedSources() {
+        this->preprocessedEntries.clear();
+    }
+
     std::string ShaderManager::processShaderSource(ShaderType type, const std::string& src, const IncludeParameterCollection& params) {
         std::istringstream iss(src);
         std::string result;
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <deque>
 #include <unordered_map>
 #include <vector>
 
@@ -47,26 +48,77 @@ namespace Core {
 
         class Entry {
         public:
-            Entry() {}
+            Entry(): building(false), requested(false) {}
 
             PersistentWeakPointer<Shader> shader;
+            // a build has been started with Shader::beginBuild() and not yet finished
+            Bool building;
+            // the shader has been asked for by something that is about to draw with it
+            Bool requested;
             std::string baseSource;
             std::string vertexSource;
             std::string geometrySource;
             std::string fragmentSource;
         };
 
+        // The fully expanded sources of one shader program, as saved by savePreprocessedSources()
+        class PreprocessedEntry {
+        public:
+            PreprocessedEntry() {}
+
+            std::string vertexSource;
+            std::string geometrySource;
+            std::string fragmentSource;
+        };
+
+        ShaderManager();
         virtual ~ShaderManager();
         void setShaderSource(ShaderType type, const std::string& name, const std::string& shaderSrc);
         void setShaderSource(ShaderType type, const std::string& name, const char shaderSrc[]);
         std::string getShaderSource(ShaderType type, const std::string& name);
         std::string getShaderSource(ShaderType type, const std::string& name, const IncludeParameterCollection& params);
+        Bool hasShaderSource(ShaderType type, const std::string& name) const;
         WeakPointer<Shader> getShader(const std::string& name);
 
+        void setLazyCompilation(Bool lazy);
+        Bool isLazyCompilation() const;
+        Bool requestShader(const std::string& name, Bool wait);
+        Bool requestShader(const char name[], Bool wait);
+        Bool requestShader(WeakPointer<Shader> shader, Bool wait);
+        Bool enqueueWarmup(const std::string& name);
+        Bool enqueueWarmup(const char name[]);
+        Bool enqueueWarmup(WeakPointer<Shader> shader);
+        void setWarmupBuildsPerUpdate(UInt32 builds);
+        UInt32 getWarmupBuildsPerUpdate() const;
+        void update();
+        UInt32 getWarmupQueueLength() const;
+        UInt32 getPendingBuildCount() const;
+        const std::vector<std::string>& getRequestedShaderNames() const;
+
+        std::vector<std::string> getProgramNames() const;
+        UInt64 getSourceHash() const;
+        Bool savePreprocessedSources(const std::string& path);
+        Bool loadPreprocessedSources(const std::string& path);
+        Bool getPreprocessedSource(ShaderType type, const std::string& name, std::string& source) const;
+        Bool hasPreprocessedSources() const;
+        void clearPreprocessedSources();
+
     protected:
         static const std::string INCLUDE_VAL_PATTERN;
         static const std::string INCLUDE_PARAMS_PATTERN;
         std::unordered_map<std::string, Entry> entries;
+        std::unordered_map<std::string, PreprocessedEntry> preprocessedEntries;
+
+        Bool lazyCompilation;
+        UInt32 warmupBuildsPerUpdate;
+        std::deque<std::string> warmupQueue;
+        std::vector<std::string> pendingBuilds;
+        std::vector<std::string> requestedNames;
+
+        Bool findShaderName(WeakPointer<Shader> shader, std::string& name) const;
+        Bool prepareEntry(const std::string& name, Entry& entry, Bool wait);
+        void beginEntryBuild(const std::string& name, Entry& entry);
+        void finishEntryBuild(const std::string& name, Entry& entry);
 
         std::string processShaderSource(ShaderType type, const std::string& src, const IncludeParameterCollection& params);
         std::string processIncludeDirective(ShaderType type, const std::string& includeLine, const IncludeParameterCollection& params);
@@ -5,6 +5,7 @@
 #include "../image/Texture.h"
 #include "../image/Texture2D.h"
 #include "../image/CubeTexture.h"
+#include "../image/TextureStreamer.h"
 #include "../Engine.h"
 #include "../Graphics.h"
 #include "../material/ShaderManager.h"
@@ -144,6 +145,14 @@ namespace Core {
         return this->opacityMap;
     }
 
+    void StandardPhysicalMaterial::reportTextureScreenSize(TextureStreamer& textureStreamer, Real screenSize) {
+        if (this->albedoMapEnabled) textureStreamer.reportScreenSize(this->albedoMap, screenSize);
+        if (this->normalMapEnabled) textureStreamer.reportScreenSize(this->normalMap, screenSize);
+        if (this->roughnessMapEnabled) textureStreamer.reportScreenSize(this->roughnessMap, screenSize);
+        if (this->metallicMapEnabled) textureStreamer.reportScreenSize(this->metallicMap, screenSize);
+        if (this->opacityMapEnabled) textureStreamer.reportScreenSize(this->opacityMap, screenSize);
+    }
+
     void StandardPhysicalMaterial::setOpacityChannelRedEnabled(Bool enabled) {
         this->opacityChannelRed = enabled;
     }
@@ -44,6 +44,7 @@ namespace Core {
         void setOpacityMapEnabled(Bool enabled);
         virtual Bool hasOpacityMap() const override;
         virtual WeakPointer<Texture> getOpacityMap() override;
+        virtual void reportTextureScreenSize(TextureStreamer& textureStreamer, Real screenSize) override;
         void setOpacityChannelRedEnabled(Bool enabled);
         void setOpacityChannelAlphaEnabled(Bool enabled);
         void setDiscardMask(Byte mask);
@@ -0,0 +1,60 @@
+#include "ParticleEmissionRecording.h"
+#include "../common/Exception.h"
+
+namespace Core {
+
+    ParticleEmissionRecording::ParticleEmissionRecording() {
+        this->clear();
+    }
+
+    void ParticleEmissionRecording::clear() {
+        this->randomSeed = 0;
+        this->emissionCount = 0;
+        this->initialState.clear();
+        this->steps.clear();
+        this->frames.clear();
+        this->frameFirstStep = 0;
+    }
+
+    void ParticleEmissionRecording::addStep(Real timeDelta, UInt32 emitCount, const Point3r& origin) {
+        Step step;
+        step.timeDelta = timeDelta;
+        step.emitCount = emitCount;
+        step.origin = origin;
+        this->steps.push_back(step);
+    }
+
+    /*
+     * Close the current frame, which holds the steps added since the previous call.
+     */
+    void ParticleEmissionRecording::endFrame(Real leftoverTime) {
+        Frame frame;
+        frame.firstStep = this->frameFirstStep;
+        frame.stepCount = (UInt32)this->steps.size() - this->frameFirstStep;
+        frame.leftoverTime = leftoverTime;
+        this->frames.push_back(frame);
+        this->frameFirstStep = (UInt32)this->steps.size();
+    }
+
+    UInt32 ParticleEmissionRecording::getStepCount() const {
+        return (UInt32)this->steps.size();
+    }
+
+    const ParticleEmissionRecording::Step& ParticleEmissionRecording::getStep(UInt32 index) const {
+        if (index >= this->steps.size()) {
+            throw OutOfRangeException("ParticleEmissionRecording::getStep() -> 'index' is out of range.");
+        }
+        return this->steps[index];
+    }
+
+    UInt32 ParticleEmissionRecording::getFrameCount() const {
+        return (UInt32)this->frames.size();
+    }
+
+    const ParticleEmissionRecording::Frame& ParticleEmissionRecording::getFrame(UInt32 index) const {
+        if (index >= this->frames.size()) {
+            throw OutOfRangeException("ParticleEmissionRecording::getFrame() -> 'index' is out of range.");
+        }
+        return this->frames[index];
+    }
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <vector>
+
+#include "../common/types.h"
+#include "../geometry/Vector3.h"
+#include "ParticleSystemSnapShot.h"
+
+namespace Core {
+
+    // The input a particle system's simulation depends on, recorded so that a run can be reproduced exactly: the
+    // state and random seed the recording started from, then for every simulation step its length, the number of
+    // particles the emitter produced and the origin they were emitted at. Steps are grouped into the frames
+    // (calls to ParticleSystem::update()) that ran them.
+    class ParticleEmissionRecording {
+    public:
+        class Step {
+        public:
+            Real timeDelta;
+            UInt32 emitCount;
+            Point3r origin;
+        };
+
+        class Frame {
+        public:
+            UInt32 firstStep;
+            UInt32 stepCount;
+            // simulation time carried over to the next frame, which drives render interpolation
+            Real leftoverTime;
+        };
+
+        ParticleEmissionRecording();
+
+        void clear();
+        void addStep(Real timeDelta, UInt32 emitCount, const Point3r& origin);
+        void endFrame(Real leftoverTime);
+        UInt32 getStepCount() const;
+        const Step& getStep(UInt32 index) const;
+        UInt32 getFrameCount() const;
+        const Frame& getFrame(UInt32 index) const;
+
+        UInt64 randomSeed;
+        UInt64 emissionCount;
+        ParticleSystemSnapShot initialState;
+
+    private:
+        std::vector<Step> steps;
+        std::vector<Frame> frames;
+        UInt32 frameFirstStep;
+    };
+}
@@ -36,6 +36,16 @@ namespace Core {
             return 0;
         }
 
+        // advance the emitter's clock by [timeDelta] as if it had emitted normally, without emitting anything
+        virtual void skip(Real timeDelta) {
+            this->internalUpdate(timeDelta);
+        }
+
+        virtual Bool isEmitting() const {
+            return this->age >= this->emissionRelativeStartTime &&
+                    (this->emissionDuration == 0.0f || (this->timeActive <= emissionDuration));
+        }
+
         Real emissionRelativeStartTime;
         Real emissionDuration;
 
@@ -86,6 +96,22 @@ namespace Core {
             return 0;
         }
 
+        virtual void skip(Real timeDelta) override {
+            if (this->internalUpdate(timeDelta)) {
+                this->timeSinceLastBurst += timeDelta;
+                if (this->waitTimetBetweenBursts <= 0.0f) return;
+                UInt32 bursts = (UInt32)Math::min(this->timeSinceLastBurst / this->waitTimetBetweenBursts, (Real)0xFFFFFFF);
+                if (this->maxBursts != 0) bursts = Math::min(bursts, this->maxBursts - Math::min(this->burstCount, this->maxBursts));
+                this->timeSinceLastBurst -= this->waitTimetBetweenBursts * (Real)bursts;
+                this->burstCount += bursts;
+                this->updateEmitCount(bursts * this->burstSize);
+            }
+        }
+
+        virtual Bool isEmitting() const override {
+            return ParticleEmitter::isEmitting() && (this->maxBursts == 0 || this->burstCount < this->maxBursts);
+        }
+
         UInt32 burstSize;
         UInt32 maxBursts;
         Real waitTimetBetweenBursts;
@@ -123,6 +149,12 @@ namespace Core {
             return 0;
         }
 
+        virtual void skip(Real timeDelta) override {
+            if (this->internalUpdate(timeDelta)) {
+                this->emitCount = Math::max(this->emitCount, (UInt32)(this->emissionRate * this->timeActive));
+            }
+        }
+
         Real emissionRate;
     };
 
@@ -7,6 +7,7 @@
 #include "../color/Color.h"
 #include "../geometry/AttributeArray.h"
 #include "../geometry/AttributeType.h"
+#include "../util/ParallelFor.h"
 
 namespace Core {
 
@@ -108,6 +109,72 @@ namespace Core {
 
             this->initialSizes->copyAttribute(srcIndex, destIndex);
             this->initialColors->copyAttribute(srcIndex, destIndex);
+            this->previousPositions->copyAttribute(srcIndex, destIndex);
+        }
+
+        /*
+         * Copy particle srcIndices[i] to destIndices[i] for each of the [count] pairs, in one pass over each attribute
+         * array. No particle may be both a source and a destination. Large batches are split across threads when
+         * [parallel] is set.
+         */
+        void copyStates(const UInt32* srcIndices, const UInt32* destIndices, UInt32 count, Bool parallel) {
+            if (count == 0) return;
+            for (UInt32 i = 0; i < count; i++) {
+                if (srcIndices[i] >= this->particleCount || destIndices[i] >= this->particleCount) {
+                    throw OutOfRangeException("ParticleStateAttributeArray::copyStates() -> Index is out of range.");
+                }
+            }
+
+            auto copyRange = [=](UInt32 first, UInt32 last) {
+                this->progressTypes->copyAttributes(srcIndices, destIndices, first, last);
+                this->lifetimes->copyAttributes(srcIndices, destIndices, first, last);
+                this->ages->copyAttributes(srcIndices, destIndices, first, last);
+                this->sequenceElements->copyAttributes(srcIndices, destIndices, first, last);
+                this->positions->copyAttributes(srcIndices, destIndices, first, last);
+                this->velocities->copyAttributes(srcIndices, destIndices, first, last);
+                this->accelerations->copyAttributes(srcIndices, destIndices, first, last);
+                this->normals->copyAttributes(srcIndices, destIndices, first, last);
+                this->rotations->copyAttributes(srcIndices, destIndices, first, last);
+                this->rotationalSpeeds->copyAttributes(srcIndices, destIndices, first, last);
+                this->sizes->copyAttributes(srcIndices, destIndices, first, last);
+                this->colors->copyAttributes(srcIndices, destIndices, first, last);
+
+                this->initialSizes->copyAttributes(srcIndices, destIndices, first, last);
+                this->initialColors->copyAttributes(srcIndices, destIndices, first, last);
+                this->previousPositions->copyAttributes(srcIndices, destIndices, first, last);
+            };
+            if (parallel) parallelFor(count, MinimumParallelCopy, copyRange);
+            else copyRange(0, count);
+        }
+
+        /*
+         * Remove the [deadCount] particles listed in ascending order in [deadIndices] from the first [activeCount]
+         * particles, and return the number left. Each dead particle that lies below the new count is replaced by a
+         * survivor from above it, taken from the end, so at most min(dead, surviving) particles are moved, all in
+         * one copyStates() batch. The order of the survivors is not preserved. [moveSources] needs room for
+         * [deadCount] indices.
+         */
+        UInt32 removeStates(const UInt32* deadIndices, UInt32 deadCount, UInt32 activeCount, UInt32* moveSources, Bool parallel) {
+            if (deadCount > activeCount || activeCount > this->particleCount) {
+                throw OutOfRangeException("ParticleStateAttributeArray::removeStates() -> Count is out of range.");
+            }
+            UInt32 newActiveCount = activeCount - deadCount;
+
+            UInt32 moveCount = 0;
+            UInt32 source = activeCount;
+            UInt32 lastDead = deadCount;
+            while (moveCount < deadCount && deadIndices[moveCount] < newActiveCount) {
+                // next survivor from the end, skipping the dead at the tail
+                source--;
+                while (lastDead > 0 && deadIndices[lastDead - 1] == source) {
+                    lastDead--;
+                    source--;
+                }
+                moveSources[moveCount++] = source;
+            }
+
+            if (moveCount > 0) this->copyStates(moveSources, deadIndices, moveCount, parallel);
+            return newActiveCount;
         }
 
         ParticleStatePtr& getStatePtr(UInt32 index) {
@@ -117,11 +184,26 @@ namespace Core {
             return this->particleStatePointers.get()[index];
         }
 
+        std::shared_ptr<ScalarAttributeArray<Real>> getLifetimes() {return this->lifetimes;}
+        std::shared_ptr<ScalarAttributeArray<Real>> getAges() {return this->ages;}
         std::shared_ptr<AttributeArray<Point3rs>> getPositions() {return this->positions;}
         std::shared_ptr<AttributeArray<Vector2rs>> getSizes() {return this->sizes;}
         std::shared_ptr<ScalarAttributeArray<Real>> getRotations() {return this->rotations;}
+        std::shared_ptr<ScalarAttributeArray<Real>> getRotationalSpeeds() {return this->rotationalSpeeds;}
         std::shared_ptr<AttributeArray<Vector4rs>> getSequenceElements() {return this->sequenceElements;}
         std::shared_ptr<AttributeArray<ColorS>> getColors() {return this->colors;}
+        std::shared_ptr<AttributeArray<Point3rs>> getPreviousPositions() {return this->previousPositions;}
+
+        // Remember the current positions of particles [first] to [last] (exclusive) as their previous positions.
+        void storePreviousPositions(UInt32 first, UInt32 last) {
+            if (first >= last) return;
+            if (last > this->particleCount) {
+                throw OutOfRangeException("ParticleStateAttributeArray::storePreviousPositions() -> 'last' is out of range.");
+            }
+            UInt32 componentCount = this->positions->getComponentCount();
+            memcpy(this->previousPositions->getStorage() + first * componentCount, this->positions->getStorage() + first * componentCount,
+                   (last - first) * componentCount * sizeof(Real));
+        }
 
     protected:
 
@@ -141,12 +223,14 @@ namespace Core {
 
             this->initialSizes = std::make_shared<AttributeArray<Vector2rs>>(particleCount, AttributeType::Float, false);
             this->initialColors = std::make_shared<AttributeArray<ColorS>>(particleCount, AttributeType::Float, false);
+            // CPU only, for interpolating render positions between simulation steps
+            this->previousPositions = std::make_shared<AttributeArray<Point3rs>>(particleCount);
 
             ParticleStatePtr* particleStatePointers = new(std::nothrow) ParticleStatePtr[particleCount];
             if (particleStatePointers == nullptr) {
                 throw AllocationException("ParticleStateAttributeArray::allocate -> Unable to allocate particle state pointer array");
             }
-            this->particleStatePointers = std::shared_ptr<ParticleStatePtr>(particleStatePointers);
+            this->particleStatePointers = std::shared_ptr<ParticleStatePtr>(particleStatePointers, std::default_delete<ParticleStatePtr[]>());
             for (UInt32 i = 0; i < particleCount; i++) {
                 this->bindStatePtr(i, this->particleStatePointers.get()[i]);
             }
@@ -155,6 +239,8 @@ namespace Core {
         void deallocate() override {
         }
 
+        static const UInt32 MinimumParallelCopy = 4096;
+
         void bindStatePtr(UInt32 index, ParticleStatePtr& ptr) {
             ptr.progressType = &this->progressTypes->getAttribute(index);
             ptr.lifetime = &this->lifetimes->getAttribute(index);
@@ -189,5 +275,6 @@ namespace Core {
 
         std::shared_ptr<AttributeArray<Vector2rs>> initialSizes;
         std::shared_ptr<AttributeArray<ColorS>> initialColors;
+        std::shared_ptr<AttributeArray<Point3rs>> previousPositions;
     };
 }
\ No newline at end of file
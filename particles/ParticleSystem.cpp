@@ -1,16 +1,95 @@
+#include <limits>
+
 #include "ParticleSystem.h"
 #include "ParticleSequenceGroup.h"
+#include "../util/ParallelFor.h"
+#include "../scene/Object3D.h"
 
 namespace Core {
 
+    // Particles are initialized in blocks of this size, each with its own random stream, so the result doesn't
+    // depend on how the blocks are spread over threads.
+    static const UInt32 InitializationBlockSize = 256;
+    // each thread gets at least this many blocks, so emissions of fewer than 2 * 16 * 256 particles stay on the calling thread
+    static const UInt32 MinimumParallelBlocks = 16;
+    static const RealDouble FixedStepTolerance = 0.001;
+
+    // Running bounds of particle positions, padded by the largest distance from a particle's center to the corner
+    // of its sprite.
+    class ParticleBoundsBuilder {
+    public:
+        ParticleBoundsBuilder() {
+            this->min[0] = this->min[1] = this->min[2] = std::numeric_limits<Real>::max();
+            this->max[0] = this->max[1] = this->max[2] = -std::numeric_limits<Real>::max();
+            this->maxExtentSquared = 0.0f;
+            this->empty = true;
+        }
+
+        void add(const Real* position, const Real* size) {
+            for (UInt32 c = 0; c < 3; c++) {
+                if (position[c] < this->min[c]) this->min[c] = position[c];
+                if (position[c] > this->max[c]) this->max[c] = position[c];
+            }
+            Real extentSquared = size[0] * size[0] + size[1] * size[1];
+            if (extentSquared > this->maxExtentSquared) this->maxExtentSquared = extentSquared;
+            this->empty = false;
+        }
+
+        Bool build(Box3& bounds) const {
+            if (this->empty) return false;
+            Real extent = Math::squareRoot(this->maxExtentSquared);
+            bounds.setMin(this->min[0] - extent, this->min[1] - extent, this->min[2] - extent);
+            bounds.setMax(this->max[0] + extent, this->max[1] + extent, this->max[2] + extent);
+            return true;
+        }
+
+    private:
+        Real min[3];
+        Real max[3];
+        Real maxExtentSquared;
+        Bool empty;
+    };
+
+    ParticleSystem::OffscreenSettings::OffscreenSettings() {
+        this->policy = OffscreenPolicy::Simulate;
+        this->visibilityTimeout = 2;
+        this->reducedRateInterval = 4;
+        this->fastForwardLimit = 2.0f;
+        this->fastForwardStep = 1.0f / 15.0f;
+    }
+
+    ParticleSystem::TimestepSettings::TimestepSettings() {
+        this->fixed = false;
+        this->stepSize = 1.0f / 60.0f;
+        this->maxSubsteps = 4;
+        this->interpolate = true;
+    }
+
     ParticleSystem::ParticleSystem(WeakPointer<Object3D> owner, UInt32 maximumActiveParticles): Object3DComponent(owner) {
         this->systemState = SystemState::NotStarted;
         this->maximumActiveParticles = maximumActiveParticles;
         this->activeParticleCount = 0;
         this->emitterInitialized = false;
         this->simulateInWorldSpace = false;
+        this->parallelInitialization = false;
+        this->parallelCompaction = false;
+        this->randomSeed = RandomStream::nextDefaultSeed();
+        this->emissionCount = 0;
+        this->boundsValid = false;
+        this->visibilityReported = false;
+        this->lastVisibleFrame = 0;
+        this->offscreen = false;
+        this->skippedTime = 0.0f;
+        this->framesSinceUpdate = 0;
+        this->simulatedTime = 0.0f;
+        this->steadyStateCaptured = false;
+        this->timeAccumulator = 0.0;
+        this->renderPositionsValid = false;
+        this->replayFrameIndex = 0;
 
         this->particleStates.setParticleCount(maximumActiveParticles);
+        this->deadParticleIndices.resize(maximumActiveParticles);
+        this->moveSourceIndices.resize(maximumActiveParticles);
 
         ParticleSequenceGroup* sequencesPtr = new(std::nothrow) ParticleSequenceGroup();
         if (sequencesPtr == nullptr) {
@@ -23,10 +102,172 @@ namespace Core {
     }
 
     void ParticleSystem::update(Real timeDelta) {
-        if (this->emitterInitialized && this->systemState == SystemState::Running) {
-            UInt32 particlesToEmit = this->particleEmitter->update(timeDelta);
-            if (particlesToEmit > 0) this->activateParticles(particlesToEmit);
-            this->advanceActiveParticles(timeDelta);
+        if (this->replayRecording) {
+            this->replayFrame();
+            return;
+        }
+        this->advance(timeDelta, this->timestepSettings.maxSubsteps);
+        this->endFrame();
+    }
+
+    /*
+     * Advance the system by [timeDelta] during [frame], applying the off-screen policy according to the
+     * visibility reported by the renderer.
+     */
+    void ParticleSystem::update(Real timeDelta, UInt64 frame) {
+        if (this->replayRecording) {
+            this->replayFrame();
+            return;
+        }
+        this->updateVisible(timeDelta, frame);
+        this->endFrame();
+    }
+
+    void ParticleSystem::updateVisible(Real timeDelta, UInt64 frame) {
+        OffscreenPolicy policy = this->offscreenSettings.policy;
+        Bool offscreen = policy != OffscreenPolicy::Simulate && this->visibilityReported &&
+                         frame > this->lastVisibleFrame + this->offscreenSettings.visibilityTimeout;
+
+        if (!offscreen) {
+            if (this->offscreen) {
+                this->offscreen = false;
+                if (policy == OffscreenPolicy::FastForward) this->fastForward(this->skippedTime);
+                else if (policy == OffscreenPolicy::ReducedRate && this->skippedTime > 0.0f) this->advance(this->skippedTime, 0);
+                this->skippedTime = 0.0f;
+            }
+            this->advance(timeDelta, this->timestepSettings.maxSubsteps);
+            return;
+        }
+
+        if (!this->offscreen) {
+            this->offscreen = true;
+            this->skippedTime = 0.0f;
+            this->framesSinceUpdate = 0;
+        }
+
+        switch (policy) {
+            case OffscreenPolicy::ReducedRate:
+                this->skippedTime += timeDelta;
+                this->framesSinceUpdate++;
+                if (this->framesSinceUpdate >= Math::max(this->offscreenSettings.reducedRateInterval, 1u)) {
+                    this->advance(this->skippedTime, 0);
+                    this->skippedTime = 0.0f;
+                    this->framesSinceUpdate = 0;
+                }
+                break;
+            case OffscreenPolicy::FastForward:
+                this->skippedTime += timeDelta;
+                break;
+            default:
+                break;
+        }
+    }
+
+    /*
+     * Simulate [timeDelta] seconds: as a single step, or under a fixed timestep as however many whole steps fit
+     * in the accumulated time, but no more than [maxSteps] (if non-zero).
+     */
+    void ParticleSystem::advance(Real timeDelta, UInt32 maxSteps) {
+        if (!this->emitterInitialized || this->systemState != SystemState::Running) return;
+
+        if (!this->timestepSettings.fixed || this->timestepSettings.stepSize <= 0.0f) {
+            this->simulateStep(timeDelta, nullptr);
+            return;
+        }
+
+        RealDouble stepSize = this->timestepSettings.stepSize;
+        this->timeAccumulator += timeDelta;
+        // time within a small fraction of a step counts as the whole step, so that rounding in the frame times
+        // doesn't leave a frame one step short
+        UInt32 stepCount = (UInt32)((this->timeAccumulator + stepSize * FixedStepTolerance) / stepSize);
+        if (maxSteps > 0 && stepCount > maxSteps) {
+            this->timeAccumulator -= (stepCount - maxSteps) * stepSize;
+            stepCount = maxSteps;
+        }
+        for (UInt32 i = 0; i < stepCount; i++) {
+            this->simulateStep(this->timestepSettings.stepSize, nullptr);
+        }
+        this->timeAccumulator = Math::max(this->timeAccumulator - stepCount * stepSize, (RealDouble)0.0);
+    }
+
+    /*
+     * Run one simulation step of [timeDelta] seconds. The emitter is always advanced, but when [replayedStep] is
+     * given, the number of particles emitted and their origin are taken from it instead.
+     */
+    void ParticleSystem::simulateStep(Real timeDelta, const ParticleEmissionRecording::Step* replayedStep) {
+        UInt32 particlesToEmit = this->particleEmitter->update(timeDelta);
+        Point3r origin = this->getOwnerWorldPosition();
+        if (replayedStep != nullptr) {
+            particlesToEmit = replayedStep->emitCount;
+            origin = replayedStep->origin;
+        }
+        if (this->recording) this->recording->addStep(timeDelta, particlesToEmit, origin);
+
+        Bool interpolating = this->isInterpolating();
+        if (interpolating) this->particleStates.storePreviousPositions(0, this->activeParticleCount);
+        if (particlesToEmit > 0) {
+            UInt32 firstNewParticle = this->activeParticleCount;
+            this->activateParticles(particlesToEmit, origin);
+            if (interpolating) this->particleStates.storePreviousPositions(firstNewParticle, this->activeParticleCount);
+        }
+        this->advanceActiveParticles(timeDelta);
+
+        if (this->offscreenSettings.policy == OffscreenPolicy::FastForward && !this->steadyStateCaptured) {
+            this->simulatedTime += timeDelta;
+            if (this->simulatedTime >= this->offscreenSettings.fastForwardLimit) {
+                this->captureSnapShot(this->steadyStateSnapShot);
+                this->steadyStateCaptured = true;
+            }
+        }
+    }
+
+    void ParticleSystem::endFrame() {
+        if (this->recording) this->recording->endFrame((Real)this->timeAccumulator);
+        this->renderPositionsValid = false;
+    }
+
+    void ParticleSystem::replayFrame() {
+        const ParticleEmissionRecording& recording = *this->replayRecording.get();
+        if (this->replayFrameIndex >= recording.getFrameCount()) {
+            this->stopReplay();
+            return;
+        }
+
+        const ParticleEmissionRecording::Frame& frame = recording.getFrame(this->replayFrameIndex++);
+        for (UInt32 i = frame.firstStep; i < frame.firstStep + frame.stepCount; i++) {
+            const ParticleEmissionRecording::Step& step = recording.getStep(i);
+            this->simulateStep(step.timeDelta, &step);
+        }
+        this->timeAccumulator = frame.leftoverTime;
+        this->renderPositionsValid = false;
+        if (this->replayFrameIndex >= recording.getFrameCount()) this->stopReplay();
+    }
+
+    /*
+     * Catch up on [skippedTime] in steps of the fast-forward step. Only the last fast-forward limit seconds
+     * are simulated, the emitter's clock is moved over the rest without emitting. If that rest alone is
+     * enough for the system to have turned over, and it is still emitting, the steady state captured earlier
+     * is restored instead of simulating at all (except while recording, which only captures steps).
+     */
+    void ParticleSystem::fastForward(Real skippedTime) {
+        if (!this->emitterInitialized || this->systemState != SystemState::Running || skippedTime <= 0.0f) return;
+
+        Real limit = Math::max(this->offscreenSettings.fastForwardLimit, 0.0f);
+        if (skippedTime > limit) {
+            this->particleEmitter->skip(skippedTime - limit);
+            skippedTime = limit;
+            if (this->steadyStateCaptured && this->particleEmitter->isEmitting() && !this->recording) {
+                this->particleEmitter->skip(skippedTime);
+                this->restoreSnapShot(this->steadyStateSnapShot);
+                return;
+            }
+        }
+
+        Real step = this->offscreenSettings.fastForwardStep > 0.0f ? this->offscreenSettings.fastForwardStep : skippedTime;
+        while (skippedTime > 0.0f) {
+            Real timeDelta = Math::min(step, skippedTime);
+            this->advance(timeDelta, 0);
+            skippedTime -= timeDelta;
         }
     }
 
@@ -48,40 +289,80 @@ namespace Core {
 
     }
 
-    void ParticleSystem::activateParticles(UInt32 particleCount) { 
+    void ParticleSystem::activateParticles(UInt32 particleCount, const Point3r& worldPosition) {
+        UInt32 firstParticle = this->activeParticleCount;
         UInt32 newActiveParticleCount = Math::clamp(this->activeParticleCount + particleCount, (UInt32)0, this->maximumActiveParticles);
-        for (UInt32 i = this->activeParticleCount; i < newActiveParticleCount; i++) {
-            this->activateParticle(i);
-        }
+        if (newActiveParticleCount <= firstParticle) return;
+
+        UInt64 emission = this->emissionCount++;
+        UInt32 blockCount = (newActiveParticleCount - firstParticle + InitializationBlockSize - 1) / InitializationBlockSize;
+        auto initializeBlocks = [&](UInt32 firstBlock, UInt32 lastBlock) {
+            RandomStream random(this->randomSeed);
+            for (UInt32 b = firstBlock; b < lastBlock; b++) {
+                UInt32 first = firstParticle + b * InitializationBlockSize;
+                UInt32 count = Math::min(InitializationBlockSize, newActiveParticleCount - first);
+                random.seed(this->randomSeed, (emission << 32) | b);
+                this->initializeParticles(random, first, count, worldPosition);
+            }
+        };
+
+        if (this->parallelInitialization) parallelFor(blockCount, MinimumParallelBlocks, initializeBlocks);
+        else initializeBlocks(0, blockCount);
         this->activeParticleCount = newActiveParticleCount;
     }
 
-    void ParticleSystem::activateParticle(UInt32 index) {
-        ParticleStatePtr statePtr = this->particleStates.getStatePtr(index);
-        *statePtr.age = 0.0f;
+    void ParticleSystem::initializeParticles(RandomStream& random, UInt32 first, UInt32 count, const Point3r& worldPosition) {
+        Real* ages = this->particleStates.getAges()->getAttributes();
+        for (UInt32 i = first; i < first + count; i++) ages[i] = 0.0f;
         for (UInt32 i = 0; i < this->particleStateInitializers.size(); i++) {
-            std::shared_ptr<ParticleStateInitializer> particleStateInitializer = this->particleStateInitializers[i];
-            particleStateInitializer->initializeState(statePtr);
+            this->particleStateInitializers[i]->initializeStates(random, this->particleStates, first, count);
+        }
+        if (this->simulateInWorldSpace) {
+            for (UInt32 i = first; i < first + count; i++) {
+                this->particleStates.getStatePtr(i).position->add(worldPosition.x, worldPosition.y, worldPosition.z);
+            }
         }
-        Point3r worldPosition = this->owner->getTransform().getWorldPosition();
-        if (this->simulateInWorldSpace) statePtr.position->add(worldPosition.x, worldPosition.y, worldPosition.z);
     }
 
     void ParticleSystem::advanceActiveParticles(Real timeDelta) {
-        UInt32 i = 0;
-        while (i < this->activeParticleCount) {
-            Bool particleIsActive = this->advanceActiveParticle(i, timeDelta); 
+        const Real* positions = this->particleStates.getPositions()->getStorage();
+        const Real* sizes = this->particleStates.getSizes()->getStorage();
+        ParticleBoundsBuilder boundsBuilder;
+
+        // Advance every particle, only noting which ones die. The dead are removed afterwards in one batch (see
+        // ParticleStateAttributeArray::removeStates()) instead of moving a particle into each slot as it is vacated.
+        // the particles may also be drawn anywhere between their previous and current positions
+        const Real* previousPositions = this->isInterpolating() ? this->particleStates.getPreviousPositions()->getStorage() : nullptr;
+        UInt32* deadParticles = this->deadParticleIndices.data();
+        UInt32 deadCount = 0;
+        for (UInt32 i = 0; i < this->activeParticleCount; i++) {
+            Bool particleIsActive = this->advanceActiveParticle(i, timeDelta);
             if (!particleIsActive) {
-                if (i < this->activeParticleCount - 1) {
-                    this->copyParticleInArray(this->activeParticleCount - 1, i);
-                }
-                this->activeParticleCount--; 
+                deadParticles[deadCount++] = i;
                 continue;
             }
-            i++;
+            boundsBuilder.add(positions + i * 4, sizes + i * 2);
+            if (previousPositions != nullptr) boundsBuilder.add(previousPositions + i * 4, sizes + i * 2);
+        }
+        this->boundsValid = boundsBuilder.build(this->bounds);
+
+        // nothing to compact on frames where no particle died
+        if (deadCount > 0) {
+            this->activeParticleCount = this->particleStates.removeStates(deadParticles, deadCount, this->activeParticleCount,
+                                                                          this->moveSourceIndices.data(), this->parallelCompaction);
         }
     }
 
+    void ParticleSystem::computeBounds() {
+        const Real* positions = this->particleStates.getPositions()->getStorage();
+        const Real* sizes = this->particleStates.getSizes()->getStorage();
+        ParticleBoundsBuilder boundsBuilder;
+        for (UInt32 i = 0; i < this->activeParticleCount; i++) {
+            boundsBuilder.add(positions + i * 4, sizes + i * 2);
+        }
+        this->boundsValid = boundsBuilder.build(this->bounds);
+    }
+
     Bool ParticleSystem::advanceActiveParticle(UInt32 index, Real timeDelta) {
         ParticleStatePtr statePtr = this->particleStates.getStatePtr(index);
         for (UInt32 i = 0; i < this->particleStateOperators.size(); i++) {
@@ -95,10 +376,6 @@ namespace Core {
         return true;
     }
 
-    void ParticleSystem::copyParticleInArray(UInt32 srcIndex, UInt32 destIndex) {
-        this->particleStates.copyState(srcIndex, destIndex);
-    }
-
     ParticleSystem::SystemState ParticleSystem::getSystemState() {
         return this->systemState;
     }
@@ -159,4 +436,233 @@ namespace Core {
     WeakPointer<ParticleSequenceGroup> ParticleSystem::getParticleSequences() {
         return this->particleSequences;
     }
+
+    UInt64 ParticleSystem::getRandomSeed() {
+        return this->randomSeed;
+    }
+
+    /*
+     * Seed the random numbers drawn by the initializers. Two systems with the same seed, setup and
+     * emission history produce the same particles.
+     */
+    void ParticleSystem::setRandomSeed(UInt64 seed) {
+        this->randomSeed = seed;
+        this->emissionCount = 0;
+    }
+
+    Bool ParticleSystem::getParallelInitialization() {
+        return this->parallelInitialization;
+    }
+
+    void ParticleSystem::setParallelInitialization(Bool parallelInitialization) {
+        this->parallelInitialization = parallelInitialization;
+    }
+
+    Bool ParticleSystem::getParallelCompaction() {
+        return this->parallelCompaction;
+    }
+
+    void ParticleSystem::setParallelCompaction(Bool parallelCompaction) {
+        this->parallelCompaction = parallelCompaction;
+    }
+
+    /*
+     * False while the system has no live particles.
+     */
+    Bool ParticleSystem::hasBounds() const {
+        return this->boundsValid;
+    }
+
+    /*
+     * Bounds of the live particles as of the last update, in world space if the system simulates in world
+     * space and in its owner's local space otherwise.
+     */
+    const Box3& ParticleSystem::getBounds() const {
+        return this->bounds;
+    }
+
+    void ParticleSystem::setOffscreenSettings(const OffscreenSettings& settings) {
+        this->offscreenSettings = settings;
+    }
+
+    const ParticleSystem::OffscreenSettings& ParticleSystem::getOffscreenSettings() const {
+        return this->offscreenSettings;
+    }
+
+    /*
+     * Record whether the system was in view of a camera during [frame].
+     */
+    void ParticleSystem::reportVisibility(Bool visible, UInt64 frame) {
+        this->visibilityReported = true;
+        if (visible && frame > this->lastVisibleFrame) this->lastVisibleFrame = frame;
+    }
+
+    Bool ParticleSystem::isOffscreen() const {
+        return this->offscreen;
+    }
+
+    void ParticleSystem::captureSnapShot(ParticleSystemSnapShot& snapShot) {
+        snapShot.clear();
+        snapShot.setOrigin(this->getOwnerWorldPosition());
+        ParticleState state;
+        for (UInt32 i = 0; i < this->activeParticleCount; i++) {
+            ParticleStatePtr& ptr = this->particleStates.getStatePtr(i);
+            state.progressType = *ptr.progressType;
+            state.lifetime = *ptr.lifetime;
+            state.age = *ptr.age;
+            state.sequenceElement.set(ptr.sequenceElement->x, ptr.sequenceElement->y, ptr.sequenceElement->z, ptr.sequenceElement->w);
+            state.position.set(ptr.position->x, ptr.position->y, ptr.position->z);
+            state.velocity.set(ptr.velocity->x, ptr.velocity->y, ptr.velocity->z);
+            state.acceleration.set(ptr.acceleration->x, ptr.acceleration->y, ptr.acceleration->z);
+            state.normal.set(ptr.normal->x, ptr.normal->y, ptr.normal->z);
+            state.rotation = *ptr.rotation;
+            state.rotationalSpeed = *ptr.rotationalSpeed;
+            state.size.set(ptr.size->x, ptr.size->y);
+            state.color.set(ptr.color->r, ptr.color->g, ptr.color->b, ptr.color->a);
+            state.initialSize.set(ptr.initialSize->x, ptr.initialSize->y);
+            state.initialColor.set(ptr.initialColor->r, ptr.initialColor->g, ptr.initialColor->b, ptr.initialColor->a);
+            snapShot.addState(state);
+        }
+    }
+
+    /*
+     * Replace the live particles with those of [snapShot]. Particles simulated in world space are moved by
+     * how far the owner has moved since the snapshot was captured.
+     */
+    void ParticleSystem::restoreSnapShot(const ParticleSystemSnapShot& snapShot) {
+        Vector3r offset;
+        if (this->simulateInWorldSpace) offset = this->getOwnerWorldPosition() - snapShot.getOrigin();
+        this->restoreStates(snapShot, offset);
+    }
+
+    void ParticleSystem::restoreStates(const ParticleSystemSnapShot& snapShot, const Vector3r& offset) {
+        UInt32 count = Math::min(snapShot.getStateCount(), this->maximumActiveParticles);
+        for (UInt32 i = 0; i < count; i++) {
+            const ParticleState& state = snapShot.getState(i);
+            ParticleStatePtr& ptr = this->particleStates.getStatePtr(i);
+            *ptr.progressType = state.progressType;
+            *ptr.lifetime = state.lifetime;
+            *ptr.age = state.age;
+            ptr.sequenceElement->set(state.sequenceElement.x, state.sequenceElement.y, state.sequenceElement.z, state.sequenceElement.w);
+            ptr.position->set(state.position.x + offset.x, state.position.y + offset.y, state.position.z + offset.z);
+            ptr.velocity->set(state.velocity.x, state.velocity.y, state.velocity.z);
+            ptr.acceleration->set(state.acceleration.x, state.acceleration.y, state.acceleration.z);
+            ptr.normal->set(state.normal.x, state.normal.y, state.normal.z);
+            *ptr.rotation = state.rotation;
+            *ptr.rotationalSpeed = state.rotationalSpeed;
+            ptr.size->set(state.size.x, state.size.y);
+            ptr.color->set(state.color.r, state.color.g, state.color.b, state.color.a);
+            ptr.initialSize->set(state.initialSize.x, state.initialSize.y);
+            ptr.initialColor->set(state.initialColor.r, state.initialColor.g, state.initialColor.b, state.initialColor.a);
+        }
+        this->activeParticleCount = count;
+        this->particleStates.storePreviousPositions(0, count);
+        this->renderPositionsValid = false;
+        this->computeBounds();
+    }
+
+    void ParticleSystem::setTimestepSettings(const TimestepSettings& settings) {
+        this->timestepSettings = settings;
+        this->timeAccumulator = 0.0;
+        this->particleStates.storePreviousPositions(0, this->activeParticleCount);
+        this->renderPositionsValid = false;
+    }
+
+    const ParticleSystem::TimestepSettings& ParticleSystem::getTimestepSettings() const {
+        return this->timestepSettings;
+    }
+
+    /*
+     * How far, from 0 to 1, the render state lies between the last two simulation steps.
+     */
+    Real ParticleSystem::getInterpolationFactor() const {
+        if (!this->isInterpolating()) return 1.0f;
+        return Math::clamp((Real)(this->timeAccumulator / this->timestepSettings.stepSize), 0.0f, 1.0f);
+    }
+
+    /*
+     * Positions to draw the active particles at: the simulated positions, or under an interpolated fixed
+     * timestep, those positions blended with the positions before the last step by the interpolation factor.
+     */
+    std::shared_ptr<AttributeArray<Point3rs>> ParticleSystem::getRenderPositions() {
+        std::shared_ptr<AttributeArray<Point3rs>> positions = this->particleStates.getPositions();
+        if (!this->isInterpolating()) return positions;
+
+        if (!this->renderPositions || this->renderPositions->getAttributeCount() != this->maximumActiveParticles) {
+            this->renderPositions = std::make_shared<AttributeArray<Point3rs>>(this->maximumActiveParticles, AttributeType::Float, false);
+            this->renderPositionsValid = false;
+        }
+        if (!this->renderPositionsValid) {
+            // blend from the end of the previous step towards the end of the last one, which is where the render
+            // state would be had the last step been cut short by the time left over
+            Real factor = this->getInterpolationFactor();
+            const Real* current = positions->getStorage();
+            const Real* previous = this->particleStates.getPreviousPositions()->getStorage();
+            Real* blended = this->renderPositions->getStorage();
+            UInt32 componentCount = positions->getComponentCount();
+            for (UInt32 i = 0; i < this->activeParticleCount * componentCount; i++) {
+                blended[i] = previous[i] + (current[i] - previous[i]) * factor;
+            }
+            this->renderPositionsValid = true;
+        }
+        return this->renderPositions;
+    }
+
+    Bool ParticleSystem::isInterpolating() const {
+        return this->timestepSettings.fixed && this->timestepSettings.interpolate && this->timestepSettings.stepSize > 0.0f;
+    }
+
+    /*
+     * Record the input of every simulation step into [recording] from now on, starting with the current state.
+     */
+    void ParticleSystem::startRecording(std::shared_ptr<ParticleEmissionRecording> recording) {
+        if (!recording) {
+            throw InvalidArgumentException("ParticleSystem::startRecording() -> 'recording' is invalid.");
+        }
+        recording->clear();
+        recording->randomSeed = this->randomSeed;
+        recording->emissionCount = this->emissionCount;
+        this->captureSnapShot(recording->initialState);
+        this->recording = recording;
+    }
+
+    void ParticleSystem::stopRecording() {
+        this->recording.reset();
+    }
+
+    Bool ParticleSystem::isRecording() const {
+        return this->recording != nullptr;
+    }
+
+    /*
+     * Return the system to the state [recording] started from and replay its steps, one recorded frame per call
+     * to update() whatever time is passed to it, until the recording runs out. The result is the same as the
+     * recorded run bit for bit, as long as the initializers and operators are the same.
+     */
+    void ParticleSystem::startReplay(std::shared_ptr<ParticleEmissionRecording> recording) {
+        if (!recording) {
+            throw InvalidArgumentException("ParticleSystem::startReplay() -> 'recording' is invalid.");
+        }
+        this->stopRecording();
+        this->randomSeed = recording->randomSeed;
+        this->emissionCount = recording->emissionCount;
+        this->restoreStates(recording->initialState, Vector3r());
+        this->timeAccumulator = 0.0;
+        this->replayRecording = recording;
+        this->replayFrameIndex = 0;
+    }
+
+    void ParticleSystem::stopReplay() {
+        this->replayRecording.reset();
+        this->replayFrameIndex = 0;
+    }
+
+    Bool ParticleSystem::isReplaying() const {
+        return this->replayRecording != nullptr;
+    }
+
+    Point3r ParticleSystem::getOwnerWorldPosition() {
+        if (!this->simulateInWorldSpace) return Point3r();
+        return this->owner->getTransform().getWorldPosition();
+    }
 }
@@ -10,6 +10,10 @@
 #include "ParticleState.h"
 #include "ParticleSequence.h"
 #include "ParticleSequenceGroup.h"
+#include "ParticleSystemSnapShot.h"
+#include "ParticleEmissionRecording.h"
+#include "../geometry/Box3.h"
+#include "util/RandomStream.h"
 #include "initializer/ParticleStateInitializer.h"
 #include "operator/ParticleStateOperator.h"
 
@@ -25,10 +29,54 @@ namespace Core {
             Done = 3
         };
 
+        // what to do while the system hasn't been seen by any camera for a while
+        enum class OffscreenPolicy {
+            // keep simulating at full rate
+            Simulate = 0,
+            // stop the system's clock until it is seen again
+            Pause = 1,
+            // simulate every few frames with the time accumulated since the last update
+            ReducedRate = 2,
+            // don't simulate, catch up on the skipped time when the system is seen again
+            FastForward = 3
+        };
+
+        class OffscreenSettings {
+        public:
+            OffscreenSettings();
+
+            OffscreenPolicy policy;
+            // frames without being seen after which the system counts as off-screen
+            UInt32 visibilityTimeout;
+            // frames between updates under ReducedRate
+            UInt32 reducedRateInterval;
+            // at most this much skipped time is simulated on re-entry under FastForward; once the system has run
+            // this long it is also assumed to have reached its steady state (see update())
+            Real fastForwardLimit;
+            // time step used while fast-forwarding
+            Real fastForwardStep;
+        };
+
+        class TimestepSettings {
+        public:
+            TimestepSettings();
+
+            // simulate in steps of exactly stepSize seconds, however the frame time is split, instead of one step
+            // per frame with the frame's time
+            Bool fixed;
+            Real stepSize;
+            // steps run by one update at most (0 for no limit); the time beyond that is dropped, so a spike in frame
+            // time slows the system down instead of making it jump
+            UInt32 maxSubsteps;
+            // render particle positions interpolated between the last two steps by the time left over
+            Bool interpolate;
+        };
+
         ParticleSystem(WeakPointer<Object3D> owner, UInt32 maximumActiveParticles);
         ~ParticleSystem();
 
         void update(Real timeDelta);
+        void update(Real timeDelta, UInt64 frame);
         void start();
         void pause();
         void stop();
@@ -74,16 +122,59 @@ namespace Core {
         void addParticleSequence(UInt32 id, UInt32 start, UInt32 length);
         WeakPointer<ParticleSequenceGroup> getParticleSequences();
 
+        UInt64 getRandomSeed();
+        void setRandomSeed(UInt64 seed);
+        Bool getParallelInitialization();
+        void setParallelInitialization(Bool parallelInitialization);
+        Bool getParallelCompaction();
+        void setParallelCompaction(Bool parallelCompaction);
+
+        Bool hasBounds() const;
+        const Box3& getBounds() const;
+        void setOffscreenSettings(const OffscreenSettings& settings);
+        const OffscreenSettings& getOffscreenSettings() const;
+        void reportVisibility(Bool visible, UInt64 frame);
+        Bool isOffscreen() const;
+        void captureSnapShot(ParticleSystemSnapShot& snapShot);
+        void restoreSnapShot(const ParticleSystemSnapShot& snapShot);
+
+        void setTimestepSettings(const TimestepSettings& settings);
+        const TimestepSettings& getTimestepSettings() const;
+        Real getInterpolationFactor() const;
+        std::shared_ptr<AttributeArray<Point3rs>> getRenderPositions();
+
+        void startRecording(std::shared_ptr<ParticleEmissionRecording> recording);
+        void stopRecording();
+        Bool isRecording() const;
+        void startReplay(std::shared_ptr<ParticleEmissionRecording> recording);
+        void stopReplay();
+        Bool isReplaying() const;
+
     private:
 
-        void activateParticles(UInt32 particleCount);
-        void activateParticle(UInt32 index);
+        void advance(Real timeDelta, UInt32 maxSteps);
+        void simulateStep(Real timeDelta, const ParticleEmissionRecording::Step* replayedStep);
+        void updateVisible(Real timeDelta, UInt64 frame);
+        void endFrame();
+        void replayFrame();
+        Bool isInterpolating() const;
+        void restoreStates(const ParticleSystemSnapShot& snapShot, const Vector3r& offset);
+        void activateParticles(UInt32 particleCount, const Point3r& worldPosition);
+        void initializeParticles(RandomStream& random, UInt32 first, UInt32 count, const Point3r& worldPosition);
         void advanceActiveParticles(Real timeDelta);
         Bool advanceActiveParticle(UInt32 index, Real timeDelta);
-        void copyParticleInArray(UInt32 srcIndex, UInt32 destIndex);
+        void fastForward(Real skippedTime);
+        void computeBounds();
+        Point3r getOwnerWorldPosition();
 
         Bool simulateInWorldSpace;
         Bool emitterInitialized;
+        // initializers may run on several threads; only safe if none of them has mutable state
+        Bool parallelInitialization;
+        Bool parallelCompaction;
+        UInt64 randomSeed;
+        // number of emissions since the seed was set, part of the random stream index of each emission
+        UInt64 emissionCount;
         SystemState systemState;
         UInt32 maximumActiveParticles;
         UInt32 activeParticleCount;
@@ -91,6 +182,40 @@ namespace Core {
         std::vector<std::shared_ptr<ParticleStateInitializer>> particleStateInitializers;
         std::vector<std::shared_ptr<ParticleStateOperator>> particleStateOperators;
         ParticleStateAttributeArray particleStates;
+        // scratch lists for removing the particles that die during an update
+        std::vector<UInt32> deadParticleIndices;
+        std::vector<UInt32> moveSourceIndices;
         std::shared_ptr<ParticleSequenceGroup> particleSequences;
+
+        // conservative bounds of the live particles in simulation space (world or owner local), including their
+        // extent; maintained by the operator sweep
+        Box3 bounds;
+        Bool boundsValid;
+
+        OffscreenSettings offscreenSettings;
+        Bool visibilityReported;
+        UInt64 lastVisibleFrame;
+        Bool offscreen;
+        // simulation time withheld while off-screen
+        Real skippedTime;
+        UInt32 framesSinceUpdate;
+        // time simulated since the system started, until it exceeds the fast-forward limit
+        Real simulatedTime;
+        // state of the system once it has been running for the fast-forward limit, restored instead of
+        // simulating when it has been off-screen for longer than that
+        ParticleSystemSnapShot steadyStateSnapShot;
+        Bool steadyStateCaptured;
+
+        TimestepSettings timestepSettings;
+        // frame time not yet simulated under a fixed timestep; kept in double precision so that frames adding up to
+        // the same total time run the same steps
+        RealDouble timeAccumulator;
+        // interpolated copy of the particle positions, recomputed at most once per update
+        std::shared_ptr<AttributeArray<Point3rs>> renderPositions;
+        Bool renderPositionsValid;
+
+        std::shared_ptr<ParticleEmissionRecording> recording;
+        std::shared_ptr<ParticleEmissionRecording> replayRecording;
+        UInt32 replayFrameIndex;
     };
 }
\ No newline at end of file
@@ -12,7 +12,7 @@ namespace Core {
 
     void ParticleSystemManager::update() {
         for(WeakPointer<ParticleSystem> particleSystem : this->particleSystems) {
-            particleSystem->update(Time::getDeltaTime());
+            particleSystem->update(Time::getDeltaTime(), Time::getFrameCount());
         }
     }
 
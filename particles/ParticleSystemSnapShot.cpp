@@ -15,4 +15,20 @@ namespace Core {
         }
         return this->particleStates[index];
     }
+
+    UInt32 ParticleSystemSnapShot::getStateCount() const {
+        return (UInt32)this->particleStates.size();
+    }
+
+    void ParticleSystemSnapShot::clear() {
+        this->particleStates.clear();
+    }
+
+    void ParticleSystemSnapShot::setOrigin(const Point3r& origin) {
+        this->origin = origin;
+    }
+
+    const Point3r& ParticleSystemSnapShot::getOrigin() const {
+        return this->origin;
+    }
 }
\ No newline at end of file
@@ -14,9 +14,17 @@ namespace Core {
 
         void addState(const ParticleState& state);
         const ParticleState& getState(UInt32 index) const;
+        UInt32 getStateCount() const;
+        void clear();
+
+        // world position of the system's owner when the states were captured; particles simulated in world
+        // space are moved along with the owner when the snapshot is restored
+        void setOrigin(const Point3r& origin);
+        const Point3r& getOrigin() const;
 
     private:
 
         std::vector<ParticleState> particleStates;
+        Point3r origin;
     };
-}
\ No newline at end of file
+}
@@ -9,8 +9,8 @@ namespace Core {
     BasicParticleStateInitializer::~BasicParticleStateInitializer() {
     }
 
-    void BasicParticleStateInitializer::initializeState(ParticleStatePtr& state) {
-        ParticleStateInitializer::initializeState(state);
+    void BasicParticleStateInitializer::initializeState(RandomStream& random, ParticleStatePtr& state) {
+        ParticleStateInitializer::initializeState(random, state);
     }
 
 }
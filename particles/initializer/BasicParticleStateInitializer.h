@@ -12,7 +12,7 @@ namespace Core {
         BasicParticleStateInitializer();
         virtual ~BasicParticleStateInitializer();
 
-        virtual void initializeState(ParticleStatePtr& state) override;
+        virtual void initializeState(RandomStream& random, ParticleStatePtr& state) override;
 
     private:
 
@@ -3,8 +3,13 @@
 
 namespace Core {
 
-    BoxPositionInitializer::BoxPositionInitializer(const Vector3r& range, const Vector3r& offset): 
-        randomGenerator(Point3r(range.x, range.y, range.z), Point3r(offset.x, offset.y, offset.z), 0.0f,  0.0f, false)  {
+    BoxPositionInitializer::BoxPositionInitializer(const Vector3r& range, const Vector3r& offset) {
+        this->range[0] = range.x;
+        this->range[1] = range.y;
+        this->range[2] = range.z;
+        this->offset[0] = offset.x;
+        this->offset[1] = offset.y;
+        this->offset[2] = offset.z;
     }
 
     BoxPositionInitializer::BoxPositionInitializer(Real rangeX, Real rangeY, Real rangeZ, Real offsetX, Real offsetY, Real offsetZ):
@@ -15,9 +20,13 @@ namespace Core {
     BoxPositionInitializer::~BoxPositionInitializer() {
     }
 
-    void BoxPositionInitializer::initializeState(ParticleStatePtr& state) {
-        Point3r position;
-        randomGenerator.generate(position);
-        *state.position = position;
+    void BoxPositionInitializer::initializeState(RandomStream& random, ParticleStatePtr& state) {
+        random.fillBox(&state.position->x, 1, 0, this->range, this->offset);
+    }
+
+    void BoxPositionInitializer::initializeStates(RandomStream& random, ParticleStateAttributeArray& states, UInt32 first, UInt32 count) {
+        std::shared_ptr<AttributeArray<Point3rs>> positions = states.getPositions();
+        UInt32 stride = positions->getComponentCount();
+        random.fillBox(positions->getStorage() + first * stride, count, stride, this->range, this->offset);
     }
 }
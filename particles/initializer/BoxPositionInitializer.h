@@ -5,7 +5,6 @@
 #include "../ParticleState.h"
 #include "ParticleStateInitializer.h"
 #include "../../geometry/Vector3.h"
-#include "../util/RandomGenerator.h"
 
 namespace Core {
 
@@ -15,10 +14,12 @@ namespace Core {
         BoxPositionInitializer(Real rangeX, Real rangeY, Real rangeZ, Real offsetX, Real offsetY, Real offsetZ);
         virtual ~BoxPositionInitializer();
 
-        virtual void initializeState(ParticleStatePtr& state) override;
+        virtual void initializeState(RandomStream& random, ParticleStatePtr& state) override;
+        virtual void initializeStates(RandomStream& random, ParticleStateAttributeArray& states, UInt32 first, UInt32 count) override;
 
     private:
 
-        RandomGenerator<Point3r> randomGenerator;
+        Real range[3];
+        Real offset[3];
     };
 }
\ No newline at end of file
@@ -10,10 +10,14 @@ namespace Core {
     LifetimeInitializer::~LifetimeInitializer() {
     }
 
-    void LifetimeInitializer::initializeState(ParticleStatePtr& state) {
+    void LifetimeInitializer::initializeState(RandomStream& random, ParticleStatePtr& state) {
         Real lifetime;
-        this->generator->generate(lifetime);
+        this->generator->generate(random, lifetime);
         *state.lifetime = lifetime;
     }
 
+    void LifetimeInitializer::initializeStates(RandomStream& random, ParticleStateAttributeArray& states, UInt32 first, UInt32 count) {
+        this->generator->generate(random, states.getLifetimes()->getAttributes() + first, count);
+    }
+
 }
@@ -9,7 +9,7 @@ namespace Core {
     ParticleStateInitializer::~ParticleStateInitializer() {
     }
 
-    void ParticleStateInitializer::initializeState(ParticleStatePtr& state) {
+    void ParticleStateInitializer::initializeState(RandomStream& random, ParticleStatePtr& state) {
         (*state.initialColor).set(1.0f, 1.0f, 1.0f, 1.0f);
         (*state.initialSize).set(1.0f, 1.0f);
 
@@ -26,4 +26,14 @@ namespace Core {
         (*state.size).copy(*state.initialSize);
         (*state.color).copy(*state.initialColor);
     }
+
+    /*
+     * Initialize the [count] particles of [states] starting at [first], drawing from [random]. Initializers that can
+     * fill whole attribute arrays at once override this; by default each particle is initialized on its own.
+     */
+    void ParticleStateInitializer::initializeStates(RandomStream& random, ParticleStateAttributeArray& states, UInt32 first, UInt32 count) {
+        for (UInt32 i = first; i < first + count; i++) {
+            this->initializeState(random, states.getStatePtr(i));
+        }
+    }
 }
@@ -4,6 +4,7 @@
 #include "../../common/types.h"
 #include "../../scene/Object3DComponent.h"
 #include "../ParticleState.h"
+#include "../util/RandomStream.h"
 
 namespace Core {
 
@@ -12,6 +13,7 @@ namespace Core {
         ParticleStateInitializer();
         virtual ~ParticleStateInitializer();
 
-        virtual void initializeState(ParticleStatePtr& state);
+        virtual void initializeState(RandomStream& random, ParticleStatePtr& state);
+        virtual void initializeStates(RandomStream& random, ParticleStateAttributeArray& states, UInt32 first, UInt32 count);
     };
 }
\ No newline at end of file
@@ -16,11 +16,11 @@ namespace Core {
     RandomVelocityInitializer::~RandomVelocityInitializer() {
     }
 
-    void RandomVelocityInitializer::initializeState(ParticleStatePtr& state) {
+    void RandomVelocityInitializer::initializeState(RandomStream& random, ParticleStatePtr& state) {
         Vector3r tempVector;
         Real speed;
-        directionGenerator.generate(tempVector);
-        speedGenerator.generate(speed);
+        directionGenerator.generate(random, tempVector);
+        speedGenerator.generate(random, speed);
         state.velocity->copy(tempVector);
         state.velocity->scale(speed);
     }
@@ -15,7 +15,7 @@ namespace Core {
         RandomVelocityInitializer(Real rangeX, Real rangeY, Real rangeZ, Real offsetX, Real offsetY, Real offsetZ, Real speedRange, Real speedOffset);
         virtual ~RandomVelocityInitializer();
 
-        virtual void initializeState(ParticleStatePtr& state) override;
+        virtual void initializeState(RandomStream& random, ParticleStatePtr& state) override;
 
     private:
 
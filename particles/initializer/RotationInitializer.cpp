@@ -10,10 +10,14 @@ namespace Core {
     RotationInitializer::~RotationInitializer() {
     }
 
-    void RotationInitializer::initializeState(ParticleStatePtr& state) {
+    void RotationInitializer::initializeState(RandomStream& random, ParticleStatePtr& state) {
         Real rotation;
-        this->generator->generate(rotation);
+        this->generator->generate(random, rotation);
         *state.rotation = rotation;
     }
 
+    void RotationInitializer::initializeStates(RandomStream& random, ParticleStateAttributeArray& states, UInt32 first, UInt32 count) {
+        this->generator->generate(random, states.getRotations()->getAttributes() + first, count);
+    }
+
 }
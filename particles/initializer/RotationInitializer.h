@@ -13,7 +13,8 @@ namespace Core {
         RotationInitializer(const Generator<Real>& generator);
         virtual ~RotationInitializer();
 
-        virtual void initializeState(ParticleStatePtr& state) override;
+        virtual void initializeState(RandomStream& random, ParticleStatePtr& state) override;
+        virtual void initializeStates(RandomStream& random, ParticleStateAttributeArray& states, UInt32 first, UInt32 count) override;
 
     private:
 
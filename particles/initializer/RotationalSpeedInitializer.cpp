@@ -10,10 +10,14 @@ namespace Core {
     RotationalSpeedInitializer::~RotationalSpeedInitializer() {
     }
 
-    void RotationalSpeedInitializer::initializeState(ParticleStatePtr& state) {
+    void RotationalSpeedInitializer::initializeState(RandomStream& random, ParticleStatePtr& state) {
         Real rotationalSpeed;
-        this->generator->generate(rotationalSpeed);
+        this->generator->generate(random, rotationalSpeed);
         *state.rotationalSpeed = rotationalSpeed;
     }
 
+    void RotationalSpeedInitializer::initializeStates(RandomStream& random, ParticleStateAttributeArray& states, UInt32 first, UInt32 count) {
+        this->generator->generate(random, states.getRotationalSpeeds()->getAttributes() + first, count);
+    }
+
 }
@@ -4,10 +4,7 @@
 
 namespace Core {
 
-    SequenceInitializer::SequenceInitializer(WeakPointer<ParticleSequenceGroup> particleSequences, Bool reverse):
-        randomDist(0.0f, (Real)particleSequences->getSequenceIDs().size())  {
-        std::random_device rd;
-        this->mt = std::mt19937(rd());
+    SequenceInitializer::SequenceInitializer(WeakPointer<ParticleSequenceGroup> particleSequences, Bool reverse) {
         this->setParticleSequences(particleSequences);
         this->reverse = reverse;
     }
@@ -19,11 +16,10 @@ namespace Core {
         this->particleSequences = particleSequences;
     }
 
-    void SequenceInitializer::initializeState(ParticleStatePtr& state) {
-        const std::vector<UInt32> sequenceIDs = this->particleSequences->getSequenceIDs();
-        Real r = this->randomDist(this->mt);
-        if (r == (Real)sequenceIDs.size()) r--;
-        UInt32 ir = (UInt32)r;
+    void SequenceInitializer::initializeState(RandomStream& random, ParticleStatePtr& state) {
+        const std::vector<UInt32>& sequenceIDs = this->particleSequences->getSequenceIDs();
+        UInt32 ir = (UInt32)(random.nextReal() * (Real)sequenceIDs.size());
+        if (ir >= sequenceIDs.size()) ir = (UInt32)sequenceIDs.size() - 1;
         UInt32 sequenceID = sequenceIDs[ir];
         WeakPointer<ParticleSequence> sequence = this->particleSequences->getSequence(sequenceID);
         Vector4rs& sequenceElement = *state.sequenceElement;
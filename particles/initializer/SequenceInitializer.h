@@ -1,7 +1,6 @@
 #pragma once
 
 #include <vector>
-#include <random>
 
 #include "../../util/PersistentWeakPointer.h"
 #include "../../common/types.h"
@@ -20,13 +19,11 @@ namespace Core {
         virtual ~SequenceInitializer();
 ;
         void setParticleSequences(WeakPointer<ParticleSequenceGroup> particleSequences);
-        virtual void initializeState(ParticleStatePtr& state) override;
+        virtual void initializeState(RandomStream& random, ParticleStatePtr& state) override;
 
     private:
 
         PersistentWeakPointer<ParticleSequenceGroup> particleSequences;
-        std::uniform_real_distribution<Real> randomDist;
-        std::mt19937 mt;
         Bool reverse;
 
     };
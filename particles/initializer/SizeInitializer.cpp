@@ -10,9 +10,9 @@ namespace Core {
     SizeInitializer::~SizeInitializer() {
     }
 
-    void SizeInitializer::initializeState(ParticleStatePtr& state) {
+    void SizeInitializer::initializeState(RandomStream& random, ParticleStatePtr& state) {
         Vector2r size;
-        this->generator->generate(size);
+        this->generator->generate(random, size);
         state.initialSize->copy(size);
         state.size->copy(size);
     }
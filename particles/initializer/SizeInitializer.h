@@ -14,7 +14,7 @@ namespace Core {
         SizeInitializer(const Generator<Vector2r>& generator);
         virtual ~SizeInitializer();
 
-        virtual void initializeState(ParticleStatePtr& state) override;
+        virtual void initializeState(RandomStream& random, ParticleStatePtr& state) override;
 
     private:
 
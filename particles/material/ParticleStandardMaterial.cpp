@@ -15,16 +15,18 @@ namespace Core {
         this->rotationLocation = -1;
         this->sequenceElementLocation = -1;
         this->colorLocation = -1;
+        this->quadCornerLocation = -1;
         this->projectionMatrixLocation = -1;
         this->viewMatrixLocation = -1;
 
         this->interpolateAtlasFrames = false;
+        this->instanced = false;
     }
 
     Bool ParticleStandardMaterial::build() {
         WeakPointer<Graphics> graphics = Engine::instance()->getGraphicsSystem();
         ShaderManager& shaderManager = graphics->getShaderManager();
-        this->shader = shaderManager.getShader("ParticleStandard");
+        this->shader = shaderManager.getShader(this->instanced ? "ParticleInstanced" : "ParticleStandard");
         graphics->activateShader(this->shader);
         this->bindShaderVarLocations();
         this->setSkinningEnabled(false);
@@ -87,6 +89,10 @@ namespace Core {
         return this->colorLocation;;
     }
 
+    Int32 ParticleStandardMaterial::getQuadCornerLocation() {
+        return this->quadCornerLocation;
+    }
+
     void ParticleStandardMaterial::copyTo(WeakPointer<Material> target) {
         WeakPointer<ParticleStandardMaterial> particleMaterial = WeakPointer<Material>::dynamicPointerCast<ParticleStandardMaterial>(target);
         if (particleMaterial.isValid()) {
@@ -105,6 +111,8 @@ namespace Core {
             particleMaterial->rotationLocation = this->rotationLocation;
             particleMaterial->sequenceElementLocation = this->sequenceElementLocation;
             particleMaterial->colorLocation = this->colorLocation;
+            particleMaterial->quadCornerLocation = this->quadCornerLocation;
+            particleMaterial->instanced = this->instanced;
         } else {
             throw InvalidArgumentException("ParticleStandardMaterial::copyTo() -> 'target must be same material.");
         }
@@ -130,6 +138,8 @@ namespace Core {
         this->rotationLocation = this->shader->getAttributeLocation("rotation");
         this->sequenceElementLocation = this->shader->getAttributeLocation("sequenceElement");
         this->colorLocation = this->shader->getAttributeLocation("color");
+        this->quadCornerLocation = this->shader->getAttributeLocation("quadCorner");
+        this->shaderVarLocationsBound = this->shader->isReady();
     }
 
     const Atlas& ParticleStandardMaterial::getAtlas() const {
@@ -147,4 +157,15 @@ namespace Core {
     void ParticleStandardMaterial::setInterpolateAtlasFrames(Bool interpolateAtlasFrames) {
         this->interpolateAtlasFrames = interpolateAtlasFrames;
     }
+
+    /*
+     * Takes effect the next time the material is built.
+     */
+    void ParticleStandardMaterial::setInstanced(Bool instanced) {
+        this->instanced = instanced;
+    }
+
+    Bool ParticleStandardMaterial::getInstanced() const {
+        return this->instanced;
+    }
 }
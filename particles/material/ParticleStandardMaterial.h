@@ -26,6 +26,7 @@ namespace Core {
         Int32 getRotationLocation();
         Int32 getSequenceElementLocation();
         Int32 getColorLocation();
+        Int32 getQuadCornerLocation();
         virtual void copyTo(WeakPointer<Material> target) override;
         virtual WeakPointer<Material> clone() override;
         void bindShaderVarLocations();
@@ -34,12 +35,16 @@ namespace Core {
         void setAtlas(const Atlas& atlas);
         void setUVOffset(Real x, Real y);
         void setInterpolateAtlasFrames(Bool interpolateAtlasFrames);
+        void setInstanced(Bool instanced);
+        Bool getInstanced() const;
 
     private:
 
         ParticleStandardMaterial();
 
         Bool interpolateAtlasFrames;
+        // expand the sprites from an instanced quad in the vertex stage instead of from points in a geometry shader
+        Bool instanced;
         Vector2r uvOffset;
         Atlas atlas;
 
@@ -52,6 +57,7 @@ namespace Core {
         Int32 rotationLocation;
         Int32 sequenceElementLocation;
         Int32 colorLocation;
+        Int32 quadCornerLocation;
         Int32 projectionMatrixLocation;
         Int32 viewMatrixLocation;
 
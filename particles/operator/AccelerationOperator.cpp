@@ -12,8 +12,12 @@ namespace Core {
 
     Bool AccelerationOperator::updateState(ParticleStatePtr& state, Real timeDelta) {
         Vector3r acceleration;
-        this->generator->generate(acceleration);
+        this->generator->generate(this->random, acceleration);
         state.acceleration->copy(acceleration);
         return true;
     }
+
+    void AccelerationOperator::setRandomSeed(UInt64 seed) {
+        this->random.seed(seed);
+    }
 }
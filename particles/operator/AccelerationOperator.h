@@ -6,6 +6,7 @@
 #include "../ParticleState.h"
 #include "../../geometry/Vector3.h"
 #include "../util/Generator.h"
+#include "../util/RandomStream.h"
 
 namespace Core {
 
@@ -15,9 +16,11 @@ namespace Core {
         virtual ~AccelerationOperator();
 
         virtual Bool updateState(ParticleStatePtr& state, Real timeDelta) override;
+        void setRandomSeed(UInt64 seed);
     
     private:
 
         std::unique_ptr<Generator<Vector3r>> generator;
+        RandomStream random;
     };
 }
\ No newline at end of file
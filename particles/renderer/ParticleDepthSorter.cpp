@@ -0,0 +1,222 @@
+#include <algorithm>
+#include <limits>
+
+#include "ParticleDepthSorter.h"
+#include "../../math/Math.h"
+#include "../../math/Matrix4x4.h"
+#include "../../util/ParallelFor.h"
+
+namespace Core {
+
+    static const UInt32 MinimumParallelSortWork = 32768;
+    static const UInt32 RadixBits = 8;
+    static const UInt32 RadixSize = 1 << RadixBits;
+    static const UInt32 KeyBits = 16;
+    static const Real MaximumKey = (Real)((1 << KeyBits) - 1);
+    // an incremental repair is abandoned for a full sort if more than 1 / MaximumRepairOutlierFraction of the
+    // particles are out of place
+    static const UInt32 MaximumRepairOutlierFraction = 8;
+    static const UInt32 MaximumRepairSpikeLength = 4;
+
+    ParticleDepthSorter::ParticleDepthSorter() {
+        this->incremental = false;
+        this->lastSortWasIncremental = false;
+        this->count = 0;
+    }
+
+    ParticleDepthSorter::~ParticleDepthSorter() {
+    }
+
+    void ParticleDepthSorter::setIncremental(Bool incremental) {
+        this->incremental = incremental;
+    }
+
+    Bool ParticleDepthSorter::getIncremental() const {
+        return this->incremental;
+    }
+
+    /*
+     * Sort the first [count] particles back to front as seen through [viewMatrix] (world to view space).
+     * [positions] holds the world position of each particle in its first three components, [stride] Reals
+     * apart. Returns the particle indices in drawing order; valid until the next call.
+     */
+    const UInt32* ParticleDepthSorter::sort(const Real* positions, UInt32 stride, UInt32 count, const Matrix4x4& viewMatrix) {
+        if (this->indices.size() < count) {
+            this->depths.resize(count);
+            this->keys.resize(count);
+            this->keyScratch.resize(count);
+            this->indices.resize(count);
+            this->indexScratch.resize(count);
+        }
+
+        this->computeKeys(positions, stride, count, viewMatrix);
+        this->lastSortWasIncremental = this->incremental && this->count > 0 && this->repairPreviousOrder(count);
+        if (!this->lastSortWasIncremental) this->radixSort(count);
+        this->count = count;
+        return this->indices.data();
+    }
+
+    const UInt32* ParticleDepthSorter::getIndices() const {
+        return this->indices.data();
+    }
+
+    UInt32 ParticleDepthSorter::getCount() const {
+        return this->count;
+    }
+
+    Bool ParticleDepthSorter::getLastSortWasIncremental() const {
+        return this->lastSortWasIncremental;
+    }
+
+    UInt32 ParticleDepthSorter::getSliceCount(UInt32 count) const {
+        UInt32 sliceCount = std::thread::hardware_concurrency();
+        if (sliceCount > count / MinimumParallelSortWork) sliceCount = count / MinimumParallelSortWork;
+        return sliceCount > 0 ? sliceCount : 1;
+    }
+
+    /*
+     * Compute the view space depth of every particle and quantize it over the depth range of the system, so that
+     * the farthest particle gets key 0 and the nearest the largest key.
+     */
+    void ParticleDepthSorter::computeKeys(const Real* positions, UInt32 stride, UInt32 count, const Matrix4x4& viewMatrix) {
+        const Real* m = viewMatrix.getConstData();
+        UInt32 sliceCount = this->getSliceCount(count);
+        UInt32 sliceSize = (count + sliceCount - 1) / sliceCount;
+        this->sliceDepthRanges.resize(sliceCount * 2);
+
+        parallelFor(sliceCount, 1, [&](UInt32 firstSlice, UInt32 lastSlice) {
+            for (UInt32 s = firstSlice; s < lastSlice; s++) {
+                UInt32 last = Math::min((s + 1) * sliceSize, count);
+                Real minDepth = std::numeric_limits<Real>::max();
+                Real maxDepth = -std::numeric_limits<Real>::max();
+                for (UInt32 i = s * sliceSize; i < last; i++) {
+                    const Real* p = positions + i * stride;
+                    // the camera looks down -Z, so the farthest particles have the smallest depth
+                    Real depth = m[2] * p[0] + m[6] * p[1] + m[10] * p[2] + m[14];
+                    this->depths[i] = depth;
+                    if (depth < minDepth) minDepth = depth;
+                    if (depth > maxDepth) maxDepth = depth;
+                }
+                this->sliceDepthRanges[s * 2] = minDepth;
+                this->sliceDepthRanges[s * 2 + 1] = maxDepth;
+            }
+        });
+
+        Real minDepth = std::numeric_limits<Real>::max();
+        Real maxDepth = -std::numeric_limits<Real>::max();
+        for (UInt32 s = 0; s < sliceCount; s++) {
+            minDepth = Math::min(minDepth, this->sliceDepthRanges[s * 2]);
+            maxDepth = Math::max(maxDepth, this->sliceDepthRanges[s * 2 + 1]);
+        }
+        Real scale = maxDepth > minDepth ? MaximumKey / (maxDepth - minDepth) : 0.0f;
+
+        parallelFor(sliceCount, 1, [&](UInt32 firstSlice, UInt32 lastSlice) {
+            UInt32 last = Math::min(lastSlice * sliceSize, count);
+            for (UInt32 i = firstSlice * sliceSize; i < last; i++) {
+                Real key = (this->depths[i] - minDepth) * scale;
+                // the negated comparison also sends NaN to the back
+                this->keys[i] = !(key > 0.0f) ? 0 : key < MaximumKey ? (UInt16)key : (UInt16)MaximumKey;
+            }
+        });
+    }
+
+    /*
+     * Least significant digit radix sort of the particle indices by key. Each pass counts the digits of every
+     * slice, turns the counts into per-slice output offsets and scatters the slices independently; the slices
+     * are consecutive and scattered in order, so every pass is stable.
+     */
+    void ParticleDepthSorter::radixSort(UInt32 count) {
+        for (UInt32 i = 0; i < count; i++) this->indices[i] = i;
+
+        UInt32 sliceCount = this->getSliceCount(count);
+        UInt32 sliceSize = (count + sliceCount - 1) / sliceCount;
+        for (UInt32 shift = 0; shift < KeyBits; shift += RadixBits) {
+            this->histograms.assign(sliceCount * RadixSize, 0);
+            parallelFor(sliceCount, 1, [&](UInt32 firstSlice, UInt32 lastSlice) {
+                for (UInt32 s = firstSlice; s < lastSlice; s++) {
+                    UInt32* histogram = &this->histograms[s * RadixSize];
+                    UInt32 last = Math::min((s + 1) * sliceSize, count);
+                    for (UInt32 i = s * sliceSize; i < last; i++) histogram[(this->keys[i] >> shift) & (RadixSize - 1)]++;
+                }
+            });
+
+            UInt32 offset = 0;
+            UInt32 usedDigits = 0;
+            for (UInt32 d = 0; d < RadixSize; d++) {
+                UInt32 digitStart = offset;
+                for (UInt32 s = 0; s < sliceCount; s++) {
+                    UInt32 digitCount = this->histograms[s * RadixSize + d];
+                    this->histograms[s * RadixSize + d] = offset;
+                    offset += digitCount;
+                }
+                if (offset > digitStart) usedDigits++;
+            }
+            // every key has the same digit, the order would not change
+            if (usedDigits <= 1) continue;
+
+            parallelFor(sliceCount, 1, [&](UInt32 firstSlice, UInt32 lastSlice) {
+                for (UInt32 s = firstSlice; s < lastSlice; s++) {
+                    UInt32* offsets = &this->histograms[s * RadixSize];
+                    UInt32 last = Math::min((s + 1) * sliceSize, count);
+                    for (UInt32 i = s * sliceSize; i < last; i++) {
+                        UInt32 position = offsets[(this->keys[i] >> shift) & (RadixSize - 1)]++;
+                        this->keyScratch[position] = this->keys[i];
+                        this->indexScratch[position] = this->indices[i];
+                    }
+                }
+            });
+            this->keys.swap(this->keyScratch);
+            this->indices.swap(this->indexScratch);
+        }
+    }
+
+    /*
+     * Bring the order of the previous sort up to date. The particles of the previous order that still exist are
+     * walked in that order; those that now break it, either as a spike above the particles that follow or as a dip
+     * below the last one kept, are set aside with the newly emitted particles. The set-aside particles are sorted and merged
+     * back in. Returns false if too many particles had to be set aside for this to beat a full sort.
+     */
+    Bool ParticleDepthSorter::repairPreviousOrder(UInt32 count) {
+        UInt32* order = this->indexScratch.data();
+        UInt32 orderCount = 0;
+        for (UInt32 i = 0; i < this->count; i++) {
+            if (this->indices[i] < count) order[orderCount++] = this->indices[i];
+        }
+
+        const UInt16* keys = this->keys.data();
+        UInt32 maximumOutliers = count / MaximumRepairOutlierFraction + 64;
+        this->outliers.clear();
+        for (UInt32 i = this->count; i < count; i++) this->outliers.push_back(i);
+        if (this->outliers.size() > maximumOutliers) return false;
+
+        UInt32 keptCount = 0;
+        for (UInt32 i = 0; i < orderCount; i++) {
+            UInt16 key = keys[order[i]];
+            UInt16 lastKey = keptCount > 0 ? keys[order[keptCount - 1]] : 0;
+            if (key < lastKey) {
+                // either this particle dipped, or the last few kept ones are a spike that wasn't recognized as such
+                UInt32 spikeLength = 0;
+                while (spikeLength < keptCount && spikeLength < MaximumRepairSpikeLength && keys[order[keptCount - spikeLength - 1]] > key) spikeLength++;
+                if (spikeLength < keptCount && keys[order[keptCount - spikeLength - 1]] > key) spikeLength = 0;
+                if (spikeLength == 0) {
+                    this->outliers.push_back(order[i]);
+                } else {
+                    for (UInt32 n = 0; n < spikeLength; n++) this->outliers.push_back(order[--keptCount]);
+                    order[keptCount++] = order[i];
+                }
+            } else if (i + 1 < orderCount && key > keys[order[i + 1]] && keys[order[i + 1]] >= lastKey) {
+                this->outliers.push_back(order[i]);
+            } else {
+                order[keptCount++] = order[i];
+            }
+            if (this->outliers.size() > maximumOutliers) return false;
+        }
+
+        auto byKey = [keys](UInt32 a, UInt32 b) {
+            return keys[a] < keys[b];
+        };
+        std::sort(this->outliers.begin(), this->outliers.end(), byKey);
+        std::merge(order, order + keptCount, this->outliers.begin(), this->outliers.end(), this->indices.begin(), byKey);
+        return true;
+    }
+}
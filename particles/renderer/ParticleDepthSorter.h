@@ -0,0 +1,51 @@
+#pragma once
+
+#include <vector>
+
+#include "../../common/types.h"
+
+namespace Core {
+
+    // forward declarations
+    class Matrix4x4;
+
+    // Orders particles back to front for alpha blending. The view space depth of each particle is quantized to a
+    // 16-bit key relative to the depth range of the system, and the keys are radix sorted (two 8-bit passes) into a
+    // list of particle indices, so the attribute arrays themselves are never permuted. Large systems are keyed and
+    // sorted on several threads. In incremental mode the order of the previous sort is repaired instead, which pays
+    // off while the camera and most particles hold still from one frame to the next; a full sort is done whenever
+    // the previous order turns out to be too far off.
+    class ParticleDepthSorter final {
+    public:
+        ParticleDepthSorter();
+        ~ParticleDepthSorter();
+
+        void setIncremental(Bool incremental);
+        Bool getIncremental() const;
+        const UInt32* sort(const Real* positions, UInt32 stride, UInt32 count, const Matrix4x4& viewMatrix);
+        const UInt32* getIndices() const;
+        UInt32 getCount() const;
+        Bool getLastSortWasIncremental() const;
+
+    private:
+        void computeKeys(const Real* positions, UInt32 stride, UInt32 count, const Matrix4x4& viewMatrix);
+        void radixSort(UInt32 count);
+        Bool repairPreviousOrder(UInt32 count);
+        UInt32 getSliceCount(UInt32 count) const;
+
+        Bool incremental;
+        Bool lastSortWasIncremental;
+        UInt32 count;
+        std::vector<Real> depths;
+        // one key per particle, then per sorted position during the radix passes
+        std::vector<UInt16> keys;
+        std::vector<UInt16> keyScratch;
+        std::vector<UInt32> indices;
+        std::vector<UInt32> indexScratch;
+        // particles set aside during an incremental repair
+        std::vector<UInt32> outliers;
+        // per slice digit counts for the parallel passes
+        std::vector<UInt32> histograms;
+        std::vector<Real> sliceDepthRanges;
+    };
+}
@@ -0,0 +1,122 @@
+#include "ParticleInstanceBuffer.h"
+#include "../ParticleState.h"
+#include "../../Engine.h"
+#include "../../geometry/AttributeArray.h"
+#include "../../geometry/AttributeArrayGPUStorage.h"
+#include "../../util/ParallelFor.h"
+#include "../../common/Exception.h"
+
+namespace Core {
+
+    static const UInt32 MinimumParallelPackWork = 16384;
+
+    ParticleInstanceBuffer::ParticleInstanceBuffer() {
+        this->count = 0;
+        this->capacity = 0;
+        this->gpuStorageCapacity = 0;
+    }
+
+    ParticleInstanceBuffer::~ParticleInstanceBuffer() {
+        if (this->gpuStorage.isValid()) {
+            Engine::safeReleaseObject(this->gpuStorage);
+        }
+    }
+
+    /*
+     * Gather the particles listed in [order] (the first [count] particles, in place, if [order] is null) from
+     * [particleStates] into consecutive instance records, taking their positions from [positions].
+     */
+    void ParticleInstanceBuffer::pack(ParticleStateAttributeArray& particleStates, AttributeArray<Point3rs>& positions,
+                                      const UInt32* order, UInt32 count) {
+        this->pack(positions.getStorage(), positions.getComponentCount(), particleStates.getSizes()->getStorage(),
+                   particleStates.getRotations()->getAttributes(), particleStates.getSequenceElements()->getStorage(),
+                   particleStates.getColors()->getStorage(), particleStates.getParticleCount(), order, count);
+    }
+
+    /*
+     * Same as above, from the raw attribute arrays of [particleCount] particles: [positions] holds a position
+     * every [positionStride] Reals, [sizes] two Reals per particle, [rotations] one, and [sequenceElements]
+     * and [colors] four each.
+     */
+    void ParticleInstanceBuffer::pack(const Real* positions, UInt32 positionStride, const Real* sizes, const Real* rotations,
+                                      const Real* sequenceElements, const Real* colors, UInt32 particleCount, const UInt32* order, UInt32 count) {
+        if (count > particleCount) {
+            throw OutOfRangeException("ParticleInstanceBuffer::pack() -> 'count' is larger than the particle count.");
+        }
+        if (particleCount != this->capacity) {
+            this->capacity = particleCount;
+            this->data.assign((size_t)particleCount * ComponentCount, 0.0f);
+        }
+
+        Real* instances = this->data.data();
+        parallelFor(count, MinimumParallelPackWork, [=](UInt32 first, UInt32 last) {
+            for (UInt32 i = first; i < last; i++) {
+                UInt32 p = order != nullptr ? order[i] : i;
+                Real* instance = instances + (size_t)i * ComponentCount;
+                const Real* position = positions + (size_t)p * positionStride;
+                instance[PositionOffset] = position[0];
+                instance[PositionOffset + 1] = position[1];
+                instance[PositionOffset + 2] = position[2];
+                instance[SizeOffset] = sizes[p * 2];
+                instance[SizeOffset + 1] = sizes[p * 2 + 1];
+                instance[RotationOffset] = rotations[p];
+                for (UInt32 c = 0; c < 4; c++) {
+                    instance[SequenceElementOffset + c] = sequenceElements[p * 4 + c];
+                    instance[ColorOffset + c] = colors[p * 4 + c];
+                }
+            }
+        });
+        this->count = count;
+    }
+
+    void ParticleInstanceBuffer::upload() {
+        if (this->capacity == 0) return;
+        UInt32 size = this->capacity * ComponentCount * sizeof(Real);
+        if (!this->gpuStorage.isValid() || this->gpuStorageCapacity != this->capacity) {
+            if (this->gpuStorage.isValid()) Engine::safeReleaseObject(this->gpuStorage);
+            this->gpuStorage = Engine::instance()->createGPUStorage(size, 1, AttributeType::Float, false);
+            this->gpuStorageCapacity = this->capacity;
+        }
+        this->gpuStorage->updateBufferData((void*)this->data.data());
+    }
+
+    const Real* ParticleInstanceBuffer::getData() const {
+        return this->data.data();
+    }
+
+    UInt32 ParticleInstanceBuffer::getCount() const {
+        return this->count;
+    }
+
+    void ParticleInstanceBuffer::enableAndSendToActiveShader(Int32 positionLocation, Int32 sizeLocation, Int32 rotationLocation,
+                                                             Int32 sequenceElementLocation, Int32 colorLocation) {
+        if (this->gpuStorage.isValid()) this->gpuStorage->bind();
+        this->sendElement(positionLocation, 3, PositionOffset);
+        this->sendElement(sizeLocation, 2, SizeOffset);
+        this->sendElement(rotationLocation, 1, RotationOffset);
+        this->sendElement(sequenceElementLocation, 4, SequenceElementOffset);
+        this->sendElement(colorLocation, 4, ColorOffset);
+    }
+
+    void ParticleInstanceBuffer::disable(Int32 positionLocation, Int32 sizeLocation, Int32 rotationLocation,
+                                         Int32 sequenceElementLocation, Int32 colorLocation) {
+        this->disableElement(positionLocation);
+        this->disableElement(sizeLocation);
+        this->disableElement(rotationLocation);
+        this->disableElement(sequenceElementLocation);
+        this->disableElement(colorLocation);
+    }
+
+    void ParticleInstanceBuffer::sendElement(Int32 location, UInt32 componentCount, UInt32 offset) {
+        if (location < 0 || !this->gpuStorage.isValid()) return;
+        this->gpuStorage->enableAndSendElementToActiveShader(location, componentCount, AttributeType::Float, false,
+                                                             ComponentCount * sizeof(Real), offset * sizeof(Real));
+        this->gpuStorage->setDivisor(location, 1);
+    }
+
+    void ParticleInstanceBuffer::disableElement(Int32 location) {
+        if (location < 0 || !this->gpuStorage.isValid()) return;
+        this->gpuStorage->setDivisor(location, 0);
+        this->gpuStorage->disable(location);
+    }
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <vector>
+
+#include "../../common/types.h"
+#include "../../util/PersistentWeakPointer.h"
+#include "../../geometry/Vector3.h"
+
+namespace Core {
+
+    // forward declarations
+    class AttributeArrayGPUStorage;
+    template <typename T> class AttributeArray;
+    class ParticleStateAttributeArray;
+
+    // Per-instance data for drawing particles as instanced quads in a given order. An instanced draw can't be
+    // reordered through an index buffer the way a point draw can, so the attributes of each particle are gathered
+    // from the particle state arrays, in drawing order, into one interleaved record of ComponentCount Reals.
+    class ParticleInstanceBuffer final {
+    public:
+        static const UInt32 PositionOffset = 0;
+        static const UInt32 SizeOffset = 3;
+        static const UInt32 RotationOffset = 5;
+        static const UInt32 SequenceElementOffset = 6;
+        static const UInt32 ColorOffset = 10;
+        static const UInt32 ComponentCount = 14;
+
+        ParticleInstanceBuffer();
+        ~ParticleInstanceBuffer();
+
+        void pack(ParticleStateAttributeArray& particleStates, AttributeArray<Point3rs>& positions, const UInt32* order, UInt32 count);
+        void pack(const Real* positions, UInt32 positionStride, const Real* sizes, const Real* rotations, const Real* sequenceElements,
+                  const Real* colors, UInt32 particleCount, const UInt32* order, UInt32 count);
+        void upload();
+        const Real* getData() const;
+        UInt32 getCount() const;
+        void enableAndSendToActiveShader(Int32 positionLocation, Int32 sizeLocation, Int32 rotationLocation,
+                                         Int32 sequenceElementLocation, Int32 colorLocation);
+        void disable(Int32 positionLocation, Int32 sizeLocation, Int32 rotationLocation,
+                     Int32 sequenceElementLocation, Int32 colorLocation);
+
+    private:
+        void sendElement(Int32 location, UInt32 componentCount, UInt32 offset);
+        void disableElement(Int32 location);
+
+        UInt32 count;
+        // number of instances the data and the GPU storage have room for
+        UInt32 capacity;
+        std::vector<Real> data;
+        PersistentWeakPointer<AttributeArrayGPUStorage> gpuStorage;
+        UInt32 gpuStorageCapacity;
+    };
+}
@@ -6,33 +6,94 @@
 #include "../../geometry/Vector2.h"
 #include "../../geometry/AttributeArray.h"
 #include "../../geometry/AttributeArrayGPUStorage.h"
+#include "../../geometry/IndexBuffer.h"
 #include "../../render/PrimitiveType.h"
 #include "../../render/RenderState.h"
 #include "../../render/EngineRenderQueue.h"
 
 namespace Core {
 
+    // two triangles spanning the unit quad, as (x, y) corners
+    static const Real QuadCorners[] = {-1.0f, -1.0f, 1.0f, -1.0f, -1.0f, 1.0f,
+                                       -1.0f, 1.0f, 1.0f, -1.0f, 1.0f, 1.0f};
+
     ParticleSystemAnimatedSpriteRenderer::ParticleSystemAnimatedSpriteRenderer(WeakPointer<Object3D> owner):
-        ParticleSystemRenderer(owner) {}
+        ParticleSystemRenderer(owner) {
+        this->depthSortEnabled = false;
+        this->spriteExpansion = SpriteExpansion::Automatic;
+        this->instanced = false;
+    }
 
     ParticleSystemAnimatedSpriteRenderer::~ParticleSystemAnimatedSpriteRenderer() {
         if (this->material.isValid()) {
             Engine::safeReleaseObject(this->material);
         }
+        if (this->sortedIndices.isValid()) {
+            Engine::safeReleaseObject(this->sortedIndices);
+        }
+        if (this->quadCorners.isValid()) {
+            Engine::safeReleaseObject(this->quadCorners);
+        }
     }
 
     Bool ParticleSystemAnimatedSpriteRenderer::init() {
         this->setCastShadows(false);
-        this->material = Engine::instance()->createMaterial<ParticleStandardMaterial>();
+        this->instanced = this->shouldUseInstancing();
+        this->material = Engine::instance()->createMaterial<ParticleStandardMaterial>(false);
+        this->material->setInstanced(this->instanced);
+        this->material->build();
         this->material->setBlendingMode(RenderState::BlendingMode::Custom);
         this->material->setSourceBlendingFactor(RenderState::BlendingFactor::SrcAlpha);
         this->material->setSourceAlphaBlendingFactor(RenderState::BlendingFactor::One);
         this->material->setDestBlendingFactor(RenderState::BlendingFactor::OneMinusSrcAlpha);
         this->material->setDestAlphaBlendingFactor(RenderState::BlendingFactor::OneMinusSrcAlpha);
         this->material->setRenderQueue(EngineRenderQueue::Transparent);
+        if (this->instanced) this->createQuadCorners();
         return this->material.isValid();
     }
 
+    /*
+     * Choose how point particles are expanded into sprites. Automatic keeps the geometry shader wherever the
+     * graphics system supports it and only draws instanced quads where it doesn't, since the instanced path
+     * repacks every particle into an instance record each frame.
+     */
+    void ParticleSystemAnimatedSpriteRenderer::setSpriteExpansion(SpriteExpansion spriteExpansion) {
+        this->spriteExpansion = spriteExpansion;
+        Bool instanced = this->shouldUseInstancing();
+        if (!this->material.isValid() || instanced == this->instanced) return;
+
+        this->instanced = instanced;
+        this->material->setInstanced(instanced);
+        this->material->build();
+        if (instanced && !this->quadCorners.isValid()) this->createQuadCorners();
+    }
+
+    ParticleSystemAnimatedSpriteRenderer::SpriteExpansion ParticleSystemAnimatedSpriteRenderer::getSpriteExpansion() const {
+        return this->spriteExpansion;
+    }
+
+    Bool ParticleSystemAnimatedSpriteRenderer::isInstanced() const {
+        return this->instanced;
+    }
+
+    Bool ParticleSystemAnimatedSpriteRenderer::shouldUseInstancing() const {
+        switch (this->spriteExpansion) {
+            case SpriteExpansion::GeometryShader:
+                return false;
+            case SpriteExpansion::InstancedQuad:
+                return true;
+            default:
+                break;
+        }
+        WeakPointer<Graphics> graphics = Engine::instance()->getGraphicsSystem();
+        return !graphics->supportsGeometryShaders() && graphics->supportsInstancing();
+    }
+
+    void ParticleSystemAnimatedSpriteRenderer::createQuadCorners() {
+        this->quadCorners = Engine::instance()->createGPUStorage(sizeof(QuadCorners), 2, AttributeType::Float, false);
+        this->quadCorners->updateBufferData((void*)QuadCorners);
+    }
+
      void ParticleSystemAnimatedSpriteRenderer::setRenderState() {
         WeakPointer<Graphics> graphics = Engine::instance()->getGraphicsSystem();
         graphics->setColorWriteEnabled(this->material->getColorWriteEnabled());
@@ -69,6 +130,21 @@ namespace Core {
         return this->material;
     }
 
+    /*
+     * Draw the particles back to front from the point of view of each camera, for correct alpha blending.
+     */
+    void ParticleSystemAnimatedSpriteRenderer::setDepthSortEnabled(Bool enabled) {
+        this->depthSortEnabled = enabled;
+    }
+
+    Bool ParticleSystemAnimatedSpriteRenderer::getDepthSortEnabled() const {
+        return this->depthSortEnabled;
+    }
+
+    ParticleDepthSorter& ParticleSystemAnimatedSpriteRenderer::getDepthSorter() {
+        return this->depthSorter;
+    }
+
     Bool ParticleSystemAnimatedSpriteRenderer::forwardRender(const ViewDescriptor& viewDescriptor, const LightPack& lightPack, Bool matchPhysicalPropertiesWithLighting) {
         return true;
     }
@@ -85,6 +161,7 @@ namespace Core {
             this->renderAttributes.setParticleCount(maxActiveParticles);
         }
 
+        this->material->prepareShader(true);
         WeakPointer<Shader> shader = this->material->getShader();
         WeakPointer<Graphics> graphics = Engine::instance()->getGraphicsSystem();
         graphics->activateShader(shader);
@@ -97,46 +174,71 @@ namespace Core {
         if (viewMatrixLoc >= 0) shader->setUniformMatrix4(viewMatrixLoc, viewDescriptor.inverseCameraTransformation);
 
         ParticleStateAttributeArray& particleStates = particleSystem->getParticleStates();
-
-        Int32 worldPositionLocation = this->material->getWorldPositionLocation();
-        WeakPointer<AttributeArray<Point3rs>> positions = particleStates.getPositions();
-        WeakPointer<AttributeArrayGPUStorage> positionsGPUStorage = positions->getGPUStorage();
-        positions->updateGPUStorageData();
-        if (positionsGPUStorage.isValid()) positionsGPUStorage->enableAndSendToActiveShader(worldPositionLocation);
-
-        Int32 sizeLocation = this->material->getSizeLocation();
+        std::shared_ptr<AttributeArray<Point3rs>> renderPositions = particleSystem->getRenderPositions();
+        WeakPointer<AttributeArray<Point3rs>> positions = renderPositions;
         WeakPointer<AttributeArray<Vector2rs>> sizes = particleStates.getSizes();
-        WeakPointer<AttributeArrayGPUStorage> sizesGPUStorage = sizes->getGPUStorage();
-        sizes->updateGPUStorageData();
-        if (sizesGPUStorage.isValid()) {
-            sizesGPUStorage->enableAndSendToActiveShader(sizeLocation);
-        }
-
-        Int32 rotationLocation = this->material->getRotationLocation();
         WeakPointer<ScalarAttributeArray<Real>> rotations = particleStates.getRotations();
-        WeakPointer<AttributeArrayGPUStorage> rotationsGPUStorage = rotations->getGPUStorage();
-        rotations->updateGPUStorageData();
-        if (rotationsGPUStorage.isValid()) rotationsGPUStorage->enableAndSendToActiveShader(rotationLocation);
-
-        Int32 sequenceElementLocation = this->material->getSequenceElementLocation();
         WeakPointer<AttributeArray<Vector4rs>> sequenceElements = particleStates.getSequenceElements();
-        WeakPointer<AttributeArrayGPUStorage> sequenceElementsGPUStorage = sequenceElements->getGPUStorage();
-        sequenceElements->updateGPUStorageData();
-        if (sequenceElementsGPUStorage.isValid()) sequenceElementsGPUStorage->enableAndSendToActiveShader(sequenceElementLocation);
-
-        Int32 colorLocation = this->material->getColorLocation();
         WeakPointer<AttributeArray<ColorS>> colors = particleStates.getColors();
-        WeakPointer<AttributeArrayGPUStorage> colorsGPUStorage = colors->getGPUStorage();
-        colors->updateGPUStorageData();
-        if (colorsGPUStorage.isValid()) colorsGPUStorage->enableAndSendToActiveShader(colorLocation);
+        WeakPointer<AttributeArrayGPUStorage> gpuStorages[] = {positions->getGPUStorage(), sizes->getGPUStorage(), rotations->getGPUStorage(),
+                                                               sequenceElements->getGPUStorage(), colors->getGPUStorage()};
+        Int32 locations[] = {this->material->getWorldPositionLocation(), this->material->getSizeLocation(), this->material->getRotationLocation(),
+                             this->material->getSequenceElementLocation(), this->material->getColorLocation()};
+        const UInt32 attributeCount = 5;
 
         this->material->sendCustomUniformsToShader();
 
-        Engine::instance()->getGraphicsSystem()->drawBoundVertexBuffer(particleSystem->getActiveParticleCount(), PrimitiveType::Points);
+        UInt32 activeParticleCount = particleSystem->getActiveParticleCount();
+        const UInt32* order = nullptr;
+        if (this->depthSortEnabled && activeParticleCount > 1) {
+            order = this->depthSorter.sort(positions->getStorage(), positions->getComponentCount(),
+                                           activeParticleCount, viewDescriptor.inverseCameraTransformation);
+        }
 
-        positionsGPUStorage->disable(worldPositionLocation);
-        sizesGPUStorage->disable(sizeLocation);
-        rotationsGPUStorage->disable(rotationLocation);
+        // sorted instances are drawn from a packed copy of the particle attributes, everything else straight from the
+        // particle state arrays (once per instance when instanced)
+        if (this->instanced && order != nullptr) {
+            this->instanceBuffer.pack(particleStates, *renderPositions, order, activeParticleCount);
+            this->instanceBuffer.upload();
+            this->instanceBuffer.enableAndSendToActiveShader(locations[0], locations[1], locations[2], locations[3], locations[4]);
+        } else {
+            positions->updateGPUStorageData();
+            sizes->updateGPUStorageData();
+            rotations->updateGPUStorageData();
+            sequenceElements->updateGPUStorageData();
+            colors->updateGPUStorageData();
+            for (UInt32 i = 0; i < attributeCount; i++) {
+                if (!gpuStorages[i].isValid() || locations[i] < 0) continue;
+                gpuStorages[i]->enableAndSendToActiveShader(locations[i]);
+                if (this->instanced) gpuStorages[i]->setDivisor(locations[i], 1);
+            }
+        }
+
+        if (this->instanced) {
+            Int32 quadCornerLocation = this->material->getQuadCornerLocation();
+            if (quadCornerLocation >= 0) this->quadCorners->enableAndSendToActiveShader(quadCornerLocation);
+            graphics->drawBoundVertexBufferInstanced(QuadVertexCount, activeParticleCount, PrimitiveType::Triangles);
+            if (quadCornerLocation >= 0) this->quadCorners->disable(quadCornerLocation);
+        } else if (order != nullptr) {
+            if (!this->sortedIndices.isValid() || this->sortedIndices->getSize() != maxActiveParticles) {
+                if (this->sortedIndices.isValid()) Engine::safeReleaseObject(this->sortedIndices);
+                this->sortedIndices = Engine::instance()->createIndexBuffer(maxActiveParticles);
+            }
+            this->sortedIndices->setIndices(order, activeParticleCount);
+            graphics->drawBoundVertexBuffer(activeParticleCount, this->sortedIndices, PrimitiveType::Points);
+        } else {
+            graphics->drawBoundVertexBuffer(activeParticleCount, PrimitiveType::Points);
+        }
+
+        if (this->instanced && order != nullptr) {
+            this->instanceBuffer.disable(locations[0], locations[1], locations[2], locations[3], locations[4]);
+        } else {
+            for (UInt32 i = 0; i < attributeCount; i++) {
+                if (!gpuStorages[i].isValid() || locations[i] < 0) continue;
+                if (this->instanced) gpuStorages[i]->setDivisor(locations[i], 0);
+                gpuStorages[i]->disable(locations[i]);
+            }
+        }
 
         return true;
     }
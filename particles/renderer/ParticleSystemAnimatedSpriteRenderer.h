@@ -4,6 +4,8 @@
 #include "../../common/types.h"
 #include "ParticleSystemRenderer.h"
 #include "../ParticleState.h"
+#include "ParticleDepthSorter.h"
+#include "ParticleInstanceBuffer.h"
 
 namespace Core {
 
@@ -12,11 +14,22 @@ namespace Core {
     class Object3D;
     class Graphics;
     class ParticleStandardMaterial;
+    class IndexBuffer;
+    class AttributeArrayGPUStorage;
 
     class ParticleSystemAnimatedSpriteRenderer final: public ParticleSystemRenderer {
         friend class Engine;
 
     public:
+        enum class SpriteExpansion {
+            // the geometry shader where it is supported, instanced quads otherwise
+            Automatic = 0,
+            // points expanded into quads in a geometry shader
+            GeometryShader = 1,
+            // a unit quad drawn once per particle, with the particle attributes advancing per instance
+            InstancedQuad = 2,
+        };
+
         ~ParticleSystemAnimatedSpriteRenderer() override;
         Bool forwardRender(const ViewDescriptor& viewDescriptor, const LightPack& lightPack, Bool matchPhysicalPropertiesWithLighting) override;
         Bool forwardRenderObject(const ViewDescriptor& viewDescriptor, WeakPointer<BaseRenderable> renderable, Bool isStatic,
@@ -29,11 +42,28 @@ namespace Core {
         virtual Bool init() override;
         void setRenderState();
         WeakPointer<ParticleStandardMaterial> getMaterial();
+        void setDepthSortEnabled(Bool enabled);
+        Bool getDepthSortEnabled() const;
+        ParticleDepthSorter& getDepthSorter();
+        void setSpriteExpansion(SpriteExpansion spriteExpansion);
+        SpriteExpansion getSpriteExpansion() const;
+        Bool isInstanced() const;
 
     protected:
         ParticleSystemAnimatedSpriteRenderer(WeakPointer<Object3D> owner);
+        Bool shouldUseInstancing() const;
+        void createQuadCorners();
+
+        static const UInt32 QuadVertexCount = 6;
 
         ParticleStateAttributeArray renderAttributes;
         PersistentWeakPointer<ParticleStandardMaterial> material;
+        Bool depthSortEnabled;
+        ParticleDepthSorter depthSorter;
+        PersistentWeakPointer<IndexBuffer> sortedIndices;
+        SpriteExpansion spriteExpansion;
+        Bool instanced;
+        PersistentWeakPointer<AttributeArrayGPUStorage> quadCorners;
+        ParticleInstanceBuffer instanceBuffer;
     };
 }
\ No newline at end of file
@@ -37,8 +37,8 @@ namespace Core {
         }
         Bool setParent = false;
         UNUSED(setParent);
+        std::shared_ptr<AttributeArray<Point3rs>> positions = particleSystem->getRenderPositions();
         for (UInt32 i = 0; i < particleSystem->getActiveParticleCount(); i++) {
-            ParticleStatePtr& particleState = particleSystem->getParticleStatePtr(i);
             WeakPointer<Object3D> meshRoot = this->pointMeshRoots[i];
             meshRoot->setActive(true);
             WeakPointer<Object3D> meshRootParent = meshRoot->getParent();
@@ -52,7 +52,7 @@ namespace Core {
                 }
             }
             setParent = true;
-            const Point3rs& pos = *particleState.position;
+            const Point3rs& pos = positions->getAttribute(i);
             meshRoot->getTransform().setLocalPosition(pos.x, pos.y, pos.z);
         }
         for (UInt32 i = particleSystem->getActiveParticleCount(); i < maxActiveParticles; i++) {
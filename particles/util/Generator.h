@@ -2,6 +2,7 @@
 
 #include "../../common/types.h"
 #include "../../math/Math.h"
+#include "RandomStream.h"
 
 namespace Core {
 
@@ -10,8 +11,13 @@ namespace Core {
     public:
         Generator(){}
         virtual ~Generator(){}
-        virtual void generate(T& out) = 0;
+        virtual void generate(RandomStream& random, T& out) = 0;
         virtual Generator<T>* clone() const = 0;
+
+        // Generate [count] consecutive values into [out].
+        virtual void generate(RandomStream& random, T* out, UInt32 count) {
+            for (UInt32 i = 0; i < count; i++) this->generate(random, out[i]);
+        }
     };
 
-}
\ No newline at end of file
+}
@@ -14,36 +14,44 @@ namespace Core {
     }
 
     template <>
-    void RandomGenerator<Real>::generate(Real& out) {
-        out = Math::random() * this->range + this->offset;
+    void RandomGenerator<Real>::generate(RandomStream& random, Real& out) {
+        out = random.nextReal(this->range, this->offset);
         if (this->normalize) out = out < 0 ? -1.0f : 1.0f;
     }
 
     template <>
-    void RandomGenerator<Vector2r>::generate(Vector2r& out) {
-        Real uniformRange = Math::random() * this->uniformRange;
-        out.set(uniformRange + Math::random() * this->range.x + this->offset.x + this->uniformOffset,
-                uniformRange + Math::random() * this->range.y + this->offset.y + this->uniformOffset);
+    void RandomGenerator<Real>::generate(RandomStream& random, Real* out, UInt32 count) {
+        random.fillUniform(out, count, 1, this->range, this->offset);
+        if (this->normalize) {
+            for (UInt32 i = 0; i < count; i++) out[i] = out[i] < 0 ? -1.0f : 1.0f;
+        }
+    }
+
+    template <>
+    void RandomGenerator<Vector2r>::generate(RandomStream& random, Vector2r& out) {
+        Real uniformRange = random.nextReal() * this->uniformRange;
+        out.set(uniformRange + random.nextReal() * this->range.x + this->offset.x + this->uniformOffset,
+                uniformRange + random.nextReal() * this->range.y + this->offset.y + this->uniformOffset);
         if (this->normalize) out.normalize();
     }
 
     template <>
-    void RandomGenerator<Vector3r>::generate(Vector3r& out) {
-        this->generateForThreeElementVector(out);
+    void RandomGenerator<Vector3r>::generate(RandomStream& random, Vector3r& out) {
+        this->generateForThreeElementVector(random, out);
     }
 
     template <>
-    void RandomGenerator<Vector3rs>::generate(Vector3rs& out) {
-        this->generateForThreeElementVector(out);
+    void RandomGenerator<Vector3rs>::generate(RandomStream& random, Vector3rs& out) {
+        this->generateForThreeElementVector(random, out);
     }
 
     template <>
-    void RandomGenerator<Point3r>::generate(Point3r& out) {
-        this->generateForThreeElementVector(out);
+    void RandomGenerator<Point3r>::generate(RandomStream& random, Point3r& out) {
+        this->generateForThreeElementVector(random, out);
     }
 
     template <>
-    void RandomGenerator<Point3rs>::generate(Point3rs& out) {
-        this->generateForThreeElementVector(out);
+    void RandomGenerator<Point3rs>::generate(RandomStream& random, Point3rs& out) {
+        this->generateForThreeElementVector(random, out);
     }
-}
\ No newline at end of file
+}
@@ -22,7 +22,10 @@ namespace Core {
         ~RandomGenerator() {
         }
 
-        void generate(T& out) override;
+        void generate(RandomStream& random, T& out) override;
+        void generate(RandomStream& random, T* out, UInt32 count) override {
+            for (UInt32 i = 0; i < count; i++) this->generate(random, out[i]);
+        }
 
         virtual Generator<T>* clone() const override {
             Generator<T>* clone = new(std::nothrow) RandomGenerator<T>(this->range, this->offset, this->uniformRange, this->uniformOffset, this->normalize);
@@ -35,11 +38,11 @@ namespace Core {
     private:
 
         template <typename V>
-        void generateForThreeElementVector(V& out) {
-            Real uniformRange = Math::random() * this->uniformRange;
-            out.set(uniformRange + Math::random() * this->range.x + this->offset.x + this->uniformOffset,
-                    uniformRange + Math::random() * this->range.y + this->offset.y + this->uniformOffset,
-                    uniformRange + Math::random() * this->range.z + this->offset.z + this->uniformOffset);
+        void generateForThreeElementVector(RandomStream& random, V& out) {
+            Real uniformRange = random.nextReal() * this->uniformRange;
+            out.set(uniformRange + random.nextReal() * this->range.x + this->offset.x + this->uniformOffset,
+                    uniformRange + random.nextReal() * this->range.y + this->offset.y + this->uniformOffset,
+                    uniformRange + random.nextReal() * this->range.z + this->offset.z + this->uniformOffset);
             if (this->normalize) out.normalize();
         }
 
@@ -50,4 +53,8 @@ namespace Core {
         Bool normalize;
     };
 
+    // scalar ranges are filled in bulk
+    template <>
+    void RandomGenerator<Real>::generate(RandomStream& random, Real* out, UInt32 count);
+
 }
\ No newline at end of file
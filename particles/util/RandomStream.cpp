@@ -0,0 +1,172 @@
+#include <atomic>
+
+#include "RandomStream.h"
+#include "../../math/Math.h"
+
+namespace Core {
+
+    static UInt64 splitMix64(UInt64& x) {
+        x += 0x9E3779B97F4A7C15ull;
+        UInt64 z = x;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    RandomStream::RandomStream(): RandomStream(RandomStream::nextDefaultSeed()) {
+    }
+
+    RandomStream::RandomStream(UInt64 seed, UInt64 stream) {
+        this->seed(seed, stream);
+    }
+
+    /*
+     * Reset the stream to the start of sequence [stream] of [seed]. The lane states are expanded from the
+     * seed and stream index with splitmix64, as recommended for the xoshiro family.
+     */
+    void RandomStream::seed(UInt64 seed, UInt64 stream) {
+        UInt64 x = stream;
+        x = seed ^ splitMix64(x);
+        for (UInt32 l = 0; l < LaneCount; l++) {
+            for (UInt32 w = 0; w < 4; w += 2) {
+                UInt64 value = splitMix64(x);
+                this->state[w][l] = (UInt32)value;
+                this->state[w + 1][l] = (UInt32)(value >> 32);
+            }
+            // the all-zero state is the one state xoshiro can't leave
+            if ((this->state[0][l] | this->state[1][l] | this->state[2][l] | this->state[3][l]) == 0) this->state[0][l] = 1;
+        }
+        this->blockIndex = LaneCount;
+    }
+
+    void RandomStream::nextBlock(UInt32* out) {
+        for (UInt32 l = 0; l < LaneCount; l++) {
+            UInt32 s0 = this->state[0][l], s1 = this->state[1][l], s2 = this->state[2][l], s3 = this->state[3][l];
+            out[l] = s0 + s3;
+            UInt32 t = s1 << 9;
+            s2 ^= s0;
+            s3 ^= s1;
+            s1 ^= s2;
+            s0 ^= s3;
+            s2 ^= t;
+            s3 = (s3 << 11) | (s3 >> 21);
+            this->state[0][l] = s0;
+            this->state[1][l] = s1;
+            this->state[2][l] = s2;
+            this->state[3][l] = s3;
+        }
+    }
+
+    /*
+     * Map [value] to [0, 1). Only the upper 24 bits are used: the lowest bits of xoshiro128+ are its weakest,
+     * and 24 bits is all a single precision Real can represent in that range.
+     */
+    Real RandomStream::toReal(UInt32 value) {
+        return (Real)(value >> 8) * (Real)(1.0 / 16777216.0);
+    }
+
+    UInt32 RandomStream::nextUInt32() {
+        if (this->blockIndex >= LaneCount) {
+            this->nextBlock(this->block);
+            this->blockIndex = 0;
+        }
+        return this->block[this->blockIndex++];
+    }
+
+    Real RandomStream::nextReal() {
+        return toReal(this->nextUInt32());
+    }
+
+    Real RandomStream::nextReal(Real range, Real offset) {
+        return toReal(this->nextUInt32()) * range + offset;
+    }
+
+    /*
+     * Write [count] values uniformly distributed over [offset, offset + range) to [out], [stride] Reals apart.
+     */
+    void RandomStream::fillUniform(Real* out, UInt32 count, UInt32 stride, Real range, Real offset) {
+        UInt32 values[LaneCount];
+        UInt32 i = 0;
+        for (; i + LaneCount <= count; i += LaneCount) {
+            this->nextBlock(values);
+            for (UInt32 l = 0; l < LaneCount; l++) out[(i + l) * stride] = toReal(values[l]) * range + offset;
+        }
+        for (; i < count; i++) out[i * stride] = this->nextReal(range, offset);
+    }
+
+    /*
+     * Write [count] points uniformly distributed in the box [offset, offset + range) to [out], three components
+     * per point and [stride] Reals from one point to the next.
+     */
+    void RandomStream::fillBox(Real* out, UInt32 count, UInt32 stride, const Real* range, const Real* offset) {
+        UInt32 x[LaneCount], y[LaneCount], z[LaneCount];
+        UInt32 i = 0;
+        for (; i + LaneCount <= count; i += LaneCount) {
+            this->nextBlock(x);
+            this->nextBlock(y);
+            this->nextBlock(z);
+            for (UInt32 l = 0; l < LaneCount; l++) {
+                Real* point = out + (i + l) * stride;
+                point[0] = toReal(x[l]) * range[0] + offset[0];
+                point[1] = toReal(y[l]) * range[1] + offset[1];
+                point[2] = toReal(z[l]) * range[2] + offset[2];
+            }
+        }
+        for (; i < count; i++) {
+            Real* point = out + i * stride;
+            point[0] = this->nextReal(range[0], offset[0]);
+            point[1] = this->nextReal(range[1], offset[1]);
+            point[2] = this->nextReal(range[2], offset[2]);
+        }
+    }
+
+    static void spherePoint(Real theta, Real phi, Real radius, const Real* scale, const Real* offset, Real* out) {
+        Real phiX = Math::cos(phi) * radius;
+        out[0] = Math::cos(theta) * phiX * scale[0] + offset[0];
+        out[1] = Math::sin(phi) * radius * scale[1] + offset[1];
+        out[2] = -Math::sin(theta) * phiX * scale[2] + offset[2];
+    }
+
+    /*
+     * Write [count] points on spherical shells to [out], three components per point and [stride] Reals from one
+     * point to the next. The azimuth, elevation and radius of each point are uniformly distributed over their
+     * range; the point is then scaled per axis by [scale] and moved by [offset].
+     */
+    void RandomStream::fillSphere(Real* out, UInt32 count, UInt32 stride, Real rangeTheta, Real offsetTheta, Real rangePhi, Real offsetPhi,
+                                  Real rangeRadius, Real offsetRadius, const Real* scale, const Real* offset) {
+        UInt32 theta[LaneCount], phi[LaneCount], radius[LaneCount];
+        UInt32 i = 0;
+        for (; i + LaneCount <= count; i += LaneCount) {
+            this->nextBlock(theta);
+            this->nextBlock(phi);
+            this->nextBlock(radius);
+            for (UInt32 l = 0; l < LaneCount; l++) {
+                spherePoint(toReal(theta[l]) * rangeTheta + offsetTheta, toReal(phi[l]) * rangePhi + offsetPhi,
+                            toReal(radius[l]) * rangeRadius + offsetRadius, scale, offset, out + (i + l) * stride);
+            }
+        }
+        for (; i < count; i++) {
+            Real t = this->nextReal(rangeTheta, offsetTheta);
+            Real p = this->nextReal(rangePhi, offsetPhi);
+            Real r = this->nextReal(rangeRadius, offsetRadius);
+            spherePoint(t, p, r, scale, offset, out + i * stride);
+        }
+    }
+
+    /*
+     * Seeds handed out to streams that are not seeded explicitly. They follow a fixed sequence, so a
+     * program that creates its streams in the same order gets the same seeds on every run.
+     */
+    UInt64 RandomStream::nextDefaultSeed() {
+        static std::atomic<UInt64> nextSeed(0x2545F4914F6CDD1Dull);
+        return nextSeed.fetch_add(1);
+    }
+
+    /*
+     * Stream private to the calling thread, for code that has no stream of its own.
+     */
+    RandomStream& RandomStream::getThreadStream() {
+        thread_local RandomStream stream;
+        return stream;
+    }
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "../../common/types.h"
+
+namespace Core {
+
+    // Explicitly seeded pseudo-random number stream for particle simulation. Four independent xoshiro128+
+    // generators are advanced side by side, so bulk fills run as a loop the compiler can vectorize and
+    // single values are served from the last block of four. Streams created from the same seed but a
+    // different stream index are statistically independent, which allows work to be split into fixed
+    // blocks that each get their own stream: the result then does not depend on how (or whether) the
+    // blocks are distributed over threads.
+    class RandomStream final {
+    public:
+        static const UInt32 LaneCount = 4;
+
+        RandomStream();
+        RandomStream(UInt64 seed, UInt64 stream = 0);
+
+        void seed(UInt64 seed, UInt64 stream = 0);
+        UInt32 nextUInt32();
+        Real nextReal();
+        Real nextReal(Real range, Real offset);
+
+        void fillUniform(Real* out, UInt32 count, UInt32 stride, Real range, Real offset);
+        void fillBox(Real* out, UInt32 count, UInt32 stride, const Real* range, const Real* offset);
+        void fillSphere(Real* out, UInt32 count, UInt32 stride, Real rangeTheta, Real offsetTheta, Real rangePhi, Real offsetPhi,
+                        Real rangeRadius, Real offsetRadius, const Real* scale, const Real* offset);
+
+        static UInt64 nextDefaultSeed();
+        static RandomStream& getThreadStream();
+
+    private:
+        void nextBlock(UInt32* out);
+        static Real toReal(UInt32 value);
+
+        // state[word][lane]
+        UInt32 state[4][LaneCount];
+        UInt32 block[LaneCount];
+        UInt32 blockIndex;
+    };
+}
@@ -5,15 +5,15 @@
 namespace Core {
 
     template <>
-    void SphereRandomGenerator<Vector2r>::generate(Vector2r& out) {
+    void SphereRandomGenerator<Vector2r>::generate(RandomStream& random, Vector2r& out) {
         
     }
 
     template <>
-    void SphereRandomGenerator<Vector3r>::generate(Vector3r& out) {
+    void SphereRandomGenerator<Vector3r>::generate(RandomStream& random, Vector3r& out) {
         Vector3r up(0.0f, 1.0f, 0.0f);
-        Real theta = Math::random() * this->rangeTheta + this->offsetTheta;
-        Real phi = Math::random() * this->rangePhi + this->offsetPhi;
+        Real theta = random.nextReal() * this->rangeTheta + this->offsetTheta;
+        Real phi = random.nextReal() * this->rangePhi + this->offsetPhi;
         Real thetaX = Math::cos(theta);
         Real thetaY = Math::sin(theta);
         Real phiX = Math::cos(phi);
@@ -26,7 +26,7 @@ namespace Core {
 
         out.normalize();
 
-        Real radius = Math::random() * this->rangeRadius + this->offsetRadius;
+        Real radius = random.nextReal() * this->rangeRadius + this->offsetRadius;
         out.scale(radius);
 
         out.x *= this->scaleX;
@@ -37,17 +37,17 @@ namespace Core {
     }
 
     template <>
-    void SphereRandomGenerator<Vector3rs>::generate(Vector3rs& out) {
+    void SphereRandomGenerator<Vector3rs>::generate(RandomStream& random, Vector3rs& out) {
         
     }
 
     template <>
-    void SphereRandomGenerator<Point3r>::generate(Point3r& out) {
+    void SphereRandomGenerator<Point3r>::generate(RandomStream& random, Point3r& out) {
         
     }
 
     template <>
-    void SphereRandomGenerator<Point3rs>::generate(Point3rs& out) {
+    void SphereRandomGenerator<Point3rs>::generate(RandomStream& random, Point3rs& out) {
         
     }
 }
\ No newline at end of file
@@ -35,7 +35,7 @@ namespace Core {
         ~SphereRandomGenerator() {
         }
 
-        void generate(T& out) override;
+        void generate(RandomStream& random, T& out) override;
 
         virtual Generator<T>* clone() const override {
             Generator<T>* clone = new(std::nothrow) SphereRandomGenerator<T>(this->rangeTheta, this->offsetTheta, this->rangePhi, this->offsetPhi, this->rangeRadius, this->offsetRadius,
@@ -0,0 +1,15 @@
+#include "MatrixBuffer.h"
+
+namespace Core {
+
+    MatrixBuffer::MatrixBuffer(UInt32 capacity) : capacity(capacity) {
+    }
+
+    MatrixBuffer::~MatrixBuffer() {
+    }
+
+    UInt32 MatrixBuffer::getCapacity() const {
+        return this->capacity;
+    }
+
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "../common/types.h"
+#include "../base/CoreObject.h"
+
+namespace Core {
+
+    // An array of 4x4 matrices stored on the GPU and exposed to shaders as a single buffer sampler, so
+    // that it is uploaded in one call and its size is not limited by the number of uniforms.
+    class MatrixBuffer: public CoreObject {
+    public:
+        MatrixBuffer(UInt32 capacity);
+        virtual ~MatrixBuffer();
+        UInt32 getCapacity() const;
+        // upload [count] column-major matrices, 16 values each
+        virtual void setMatrices(const Real * matrices, UInt32 count) = 0;
+        virtual void sendToActiveShader(UInt32 samplerSlot, UInt32 uniformLocation) = 0;
+
+    protected:
+        UInt32 capacity;
+    };
+
+}
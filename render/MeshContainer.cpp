@@ -1,6 +1,7 @@
 
 #include "MeshContainer.h"
 #include "../animation/VertexBoneMap.h"
+#include "../util/Time.h"
 
 namespace Core {
 
@@ -9,9 +10,12 @@ namespace Core {
     }
 
     MeshContainer::~MeshContainer() {
-        for (UInt32 i = 0; i < this->vertexBoneMaps.size(); i ++) {
-            WeakPointer<VertexBoneMap> child = this->vertexBoneMaps[i];
-            Engine::safeReleaseObject(child);
+        for (auto& entry : this->lodChains) {
+            this->releaseLODChain(entry.second);
+        }
+        for (auto& entry : this->vertexBoneMaps) {
+            WeakPointer<VertexBoneMap> child = entry.second;
+            if (child.isValid()) Engine::safeReleaseObject(child);
         }
         if (this->skeleton.isValid()) Engine::safeReleaseObject(this->skeleton);
     }
@@ -41,4 +45,88 @@ namespace Core {
         return this->vertexBoneMapSet[meshID];
     }
 
-}
\ No newline at end of file
+    /**
+     * Register [lodMeshes] as the reduced levels of detail of the mesh with id [meshID], coarsest last.
+     * [switchSizes] holds the projected size (in pixels) below which each of them is drawn. The container
+     * takes ownership of the meshes, and of any vertex bone maps added for them; both are released when the
+     * chain is replaced.
+     */
+    void MeshContainer::setLODChain(UInt64 meshID, const std::vector<WeakPointer<Mesh>>& lodMeshes, const std::vector<Real>& switchSizes) {
+        if (lodMeshes.size() != switchSizes.size()) {
+            throw InvalidArgumentException("MeshContainer::setLODChain() -> Each LOD mesh needs a switch size.");
+        }
+        LODChain& lodChain = this->lodChains[meshID];
+        this->releaseLODChain(lodChain);
+        lodChain.selector.setSwitchSizes(switchSizes);
+        for (WeakPointer<Mesh> lodMesh : lodMeshes) {
+            lodChain.meshes.push_back(lodMesh);
+        }
+    }
+
+    /**
+     * Generate a LOD chain for every mesh in the container (see MeshSimplifier), including simplified
+     * copies of their vertex bone maps.
+     */
+    void MeshContainer::buildLODChains(const MeshSimplifier::Settings& settings) {
+        for (UInt32 i = 0; i < this->renderables.size(); i++) {
+            WeakPointer<Mesh> mesh = this->renderables[i];
+            WeakPointer<VertexBoneMap> vertexBoneMap;
+            if (this->hasVertexBoneMap(mesh->getObjectID())) vertexBoneMap = this->getVertexBoneMap(mesh->getObjectID());
+
+            std::vector<MeshSimplifier::LODLevel> levels = MeshSimplifier::buildLODChain(mesh, vertexBoneMap, settings);
+            if (levels.size() == 0) continue;
+            std::vector<WeakPointer<Mesh>> lodMeshes;
+            std::vector<Real> switchSizes;
+            for (MeshSimplifier::LODLevel& level : levels) {
+                lodMeshes.push_back(level.mesh);
+                switchSizes.push_back(level.screenSize);
+                if (level.vertexBoneMap.isValid()) {
+                    level.vertexBoneMap->buildAttributeArray();
+                    this->addVertexBoneMap(level.mesh->getObjectID(), level.vertexBoneMap);
+                }
+            }
+            this->setLODChain(mesh->getObjectID(), lodMeshes, switchSizes);
+        }
+    }
+
+    Bool MeshContainer::hasLODChain(UInt64 meshID) const {
+        return this->lodChains.find(meshID) != this->lodChains.end();
+    }
+
+    MeshLODSelector& MeshContainer::getLODSelector(UInt64 meshID) {
+        auto result = this->lodChains.find(meshID);
+        if (result == this->lodChains.end()) {
+            throw InvalidArgumentException("MeshContainer::getLODSelector() -> Invalid mesh id.");
+        }
+        return result->second.selector;
+    }
+
+    /**
+     * Get the level of detail of [mesh] to draw in the view identified by [viewID], where the mesh
+     * covers [screenSize] pixels. Meshes without a LOD chain are returned as they are.
+     */
+    WeakPointer<Mesh> MeshContainer::selectLOD(WeakPointer<Mesh> mesh, UInt64 viewID, Real screenSize) {
+        auto result = this->lodChains.find(mesh->getObjectID());
+        if (result == this->lodChains.end()) return mesh;
+        UInt32 level = result->second.selector.selectLevel(viewID, screenSize, Time::getFrameCount());
+        return level == 0 ? mesh : WeakPointer<Mesh>(result->second.meshes[level - 1]);
+    }
+
+    void MeshContainer::releaseLODChain(LODChain& lodChain) {
+        for (UInt32 i = 0; i < lodChain.meshes.size(); i++) {
+            WeakPointer<Mesh> lodMesh = lodChain.meshes[i];
+            if (!lodMesh.isValid()) continue;
+            UInt64 lodMeshID = lodMesh->getObjectID();
+            auto vertexBoneMap = this->vertexBoneMaps.find(lodMeshID);
+            if (vertexBoneMap != this->vertexBoneMaps.end()) {
+                WeakPointer<VertexBoneMap> child = vertexBoneMap->second;
+                if (child.isValid()) Engine::safeReleaseObject(child);
+                this->vertexBoneMaps.erase(vertexBoneMap);
+                this->vertexBoneMapSet.erase(lodMeshID);
+            }
+            Engine::safeReleaseObject(lodMesh);
+        }
+        lodChain.meshes.clear();
+    }
+
+}
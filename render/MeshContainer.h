@@ -2,11 +2,14 @@
 
 #include <memory>
 #include <unordered_map>
+#include <vector>
 
 #include "../common/types.h"
 #include "../geometry/Mesh.h"
+#include "../geometry/MeshSimplifier.h"
 #include "../animation/Skeleton.h"
 #include "RenderableContainer.h"
+#include "MeshLODSelector.h"
 
 namespace Core {
 
@@ -26,13 +29,28 @@ namespace Core {
         WeakPointer<VertexBoneMap> getVertexBoneMap(UInt64 meshID);
         Bool hasVertexBoneMap(UInt64 meshID);
 
+        void setLODChain(UInt64 meshID, const std::vector<WeakPointer<Mesh>>& lodMeshes, const std::vector<Real>& switchSizes);
+        void buildLODChains(const MeshSimplifier::Settings& settings);
+        Bool hasLODChain(UInt64 meshID) const;
+        MeshLODSelector& getLODSelector(UInt64 meshID);
+        WeakPointer<Mesh> selectLOD(WeakPointer<Mesh> mesh, UInt64 viewID, Real screenSize);
+
     protected:
         MeshContainer(WeakPointer<Object3D> owner);
 
     private:
+        class LODChain {
+        public:
+            std::vector<PersistentWeakPointer<Mesh>> meshes;
+            MeshLODSelector selector;
+        };
+
+        void releaseLODChain(LODChain& lodChain);
+
         PersistentWeakPointer<Skeleton> skeleton;
         std::unordered_map<UInt64, PersistentWeakPointer<VertexBoneMap>> vertexBoneMaps;
         std::unordered_map<UInt64, Bool> vertexBoneMapSet;
+        std::unordered_map<UInt64, LODChain> lodChains;
     };
 
 }
@@ -0,0 +1,89 @@
+#include "MeshLODSelector.h"
+#include "../common/Exception.h"
+
+namespace Core {
+
+    const UInt64 MeshLODSelector::StaleViewFrames;
+
+    MeshLODSelector::MeshLODSelector() {
+        this->hysteresis = 0.1f;
+        this->lastEvictionFrame = 0;
+    }
+
+    /**
+     * Set the projected sizes (in pixels) at which each level after the first is switched in. The sizes
+     * must not increase from one level to the next.
+     */
+    void MeshLODSelector::setSwitchSizes(const std::vector<Real>& switchSizes) {
+        for (UInt32 i = 1; i < switchSizes.size(); i++) {
+            if (switchSizes[i] > switchSizes[i - 1]) {
+                throw InvalidArgumentException("MeshLODSelector::setSwitchSizes() -> Switch sizes must not increase.");
+            }
+        }
+        this->switchSizes = switchSizes;
+        this->viewLevels.clear();
+    }
+
+    const std::vector<Real>& MeshLODSelector::getSwitchSizes() const {
+        return this->switchSizes;
+    }
+
+    void MeshLODSelector::setHysteresis(Real hysteresis) {
+        if (hysteresis < 0.0f || hysteresis >= 1.0f) {
+            throw InvalidArgumentException("MeshLODSelector::setHysteresis() -> Hysteresis must be in [0, 1).");
+        }
+        this->hysteresis = hysteresis;
+    }
+
+    Real MeshLODSelector::getHysteresis() const {
+        return this->hysteresis;
+    }
+
+    UInt32 MeshLODSelector::getLevelCount() const {
+        return (UInt32)this->switchSizes.size() + 1;
+    }
+
+    /**
+     * Select the level to draw in the view identified by [viewID] during [frame], where the mesh covers
+     * [screenSize] pixels.
+     */
+    UInt32 MeshLODSelector::selectLevel(UInt64 viewID, Real screenSize, UInt64 frame) {
+        if (frame >= this->lastEvictionFrame + StaleViewFrames) this->evictStaleViews(frame);
+
+        auto result = this->viewLevels.find(viewID);
+        if (result == this->viewLevels.end()) {
+            ViewLevel& viewLevel = this->viewLevels[viewID];
+            viewLevel.level = this->getLevelForScreenSize(screenSize);
+            viewLevel.lastFrame = frame;
+            return viewLevel.level;
+        }
+
+        result->second.lastFrame = frame;
+        UInt32& level = result->second.level;
+        while (level < this->switchSizes.size() && screenSize < this->switchSizes[level] * (1.0f - this->hysteresis)) {
+            level++;
+        }
+        while (level > 0 && screenSize > this->switchSizes[level - 1] * (1.0f + this->hysteresis)) {
+            level--;
+        }
+        return level;
+    }
+
+    UInt32 MeshLODSelector::getLevelForScreenSize(Real screenSize) const {
+        UInt32 level = 0;
+        while (level < this->switchSizes.size() && screenSize < this->switchSizes[level]) level++;
+        return level;
+    }
+
+    UInt32 MeshLODSelector::getTrackedViewCount() const {
+        return (UInt32)this->viewLevels.size();
+    }
+
+    void MeshLODSelector::evictStaleViews(UInt64 frame) {
+        for (auto itr = this->viewLevels.begin(); itr != this->viewLevels.end();) {
+            if (itr->second.lastFrame + StaleViewFrames < frame) itr = this->viewLevels.erase(itr);
+            else ++itr;
+        }
+        this->lastEvictionFrame = frame;
+    }
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <vector>
+#include <unordered_map>
+
+#include "../common/types.h"
+
+namespace Core {
+
+    // Picks a level of detail from the projected size of a mesh. Level 0 is the full mesh; level i + 1 is
+    // chosen once the projected size drops below the i-th switch size. To keep meshes hovering around a
+    // switch size from popping back and forth, the level in use for a view only changes once the size has
+    // moved past the switch size by the hysteresis fraction. Views that have not selected a level for
+    // StaleViewFrames frames are forgotten, so transient view IDs do not accumulate.
+    class MeshLODSelector {
+    public:
+        static const UInt64 StaleViewFrames = 120;
+
+        MeshLODSelector();
+
+        void setSwitchSizes(const std::vector<Real>& switchSizes);
+        const std::vector<Real>& getSwitchSizes() const;
+        void setHysteresis(Real hysteresis);
+        Real getHysteresis() const;
+        UInt32 getLevelCount() const;
+
+        UInt32 selectLevel(UInt64 viewID, Real screenSize, UInt64 frame);
+        UInt32 getLevelForScreenSize(Real screenSize) const;
+        UInt32 getTrackedViewCount() const;
+
+    private:
+        class ViewLevel {
+        public:
+            UInt32 level;
+            UInt64 lastFrame;
+        };
+
+        void evictStaleViews(UInt64 frame);
+
+        std::vector<Real> switchSizes;
+        Real hysteresis;
+        UInt64 lastEvictionFrame;
+        std::unordered_map<UInt64, ViewLevel> viewLevels;
+    };
+}
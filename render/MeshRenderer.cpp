@@ -4,6 +4,7 @@
 #include "../geometry/AttributeArray.h"
 #include "../geometry/AttributeArrayGPUStorage.h"
 #include "../geometry/Mesh.h"
+#include "../geometry/InterleavedVertexBuffer.h"
 #include "../image/Texture.h"
 #include "../image/Texture2D.h"
 #include "../light/AmbientIBLLight.h"
@@ -18,6 +19,8 @@
 #include "../animation/VertexBoneMap.h"
 #include "../animation/Bone.h"
 #include "../animation/Object3DSkeletonNode.h"
+#include "../animation/SkinningPalette.h"
+#include "../util/Time.h"
 #include "RenderException.h"
 #include "RenderPath.h"
 #include "DepthOutputOverride.h"
@@ -41,25 +44,15 @@ namespace Core {
 
     void MeshRenderer::preProcess() {
         WeakPointer<MeshContainer> meshContainer = this->owner->getMeshContainer();
-        if (meshContainer.isValid()) {
-            Matrix4x4 rootTransformInverse = this->owner->getTransform().getWorldMatrix();
-            rootTransformInverse.invert();
-
-            Matrix4x4 temp;
+        if (meshContainer.isValid() && this->material->getShaderLocation(StandardUniform::Bones) >= 0) {
             WeakPointer<Skeleton> skeleton = meshContainer->getSkeleton();
             if (skeleton.isValid()) {
-                for(UInt32 i = 0; i < skeleton->getNodeCount(); i++) {
-                    Skeleton::SkeletonNode * node = skeleton->getNodeFromList(i);
-                    if (node->BoneIndex >= 0) {
-                        Int32 bonesLocation = material->getShaderLocation(StandardUniform::Bones, node->BoneIndex);
-                        if (bonesLocation >= 0) {
-                            temp.copy(skeleton->getBone(node->BoneIndex)->OffsetMatrix);
-                            temp.preMultiply(node->getFullTransform());
-                            temp.preMultiply(rootTransformInverse);
-                            node->TempRenderTransformation.copy(temp);
-                        }
-                    }
-                }
+                Matrix4x4 rootTransformInverse = this->owner->getTransform().getWorldMatrix();
+                rootTransformInverse.invert();
+
+                // the palette is shared by all meshes bound to the skeleton, so only the first one to
+                // get here in a given frame computes it
+                skeleton->getSkinningPalette().update(*skeleton.get(), rootTransformInverse, Time::getFrameCount());
             }
         }
     }
@@ -94,9 +87,13 @@ namespace Core {
         }
     }
 
-    void MeshRenderer::setSkinningVars(WeakPointer<Mesh> mesh, WeakPointer<Material> material, WeakPointer<Shader> shader) {
+    void MeshRenderer::setSkinningVars(WeakPointer<Mesh> mesh, WeakPointer<Material> material, WeakPointer<Shader> shader, UInt32& textureSlot) {
         Int32 skinningEnabledLocation = material->getShaderLocation(StandardUniform::SkinningEnabled);
+        Int32 bonesLocation = material->getShaderLocation(StandardUniform::Bones);
         if (skinningEnabledLocation >= 0) shader->setUniform1i(skinningEnabledLocation, 0.0);
+
+        // the bone sampler always gets its own texture unit, since samplers of different types must not share one
+        Bool bonesSent = false;
         if (material->isSkinningEnabled()) {
             WeakPointer<MeshContainer> meshContainer = this->owner->getMeshContainer();
             if (meshContainer.isValid() && meshContainer->hasVertexBoneMap(mesh->getObjectID())) {
@@ -106,17 +103,16 @@ namespace Core {
                 this->checkAndSetShaderAttribute(mesh, material, StandardAttribute::BoneWeight, StandardAttribute::BoneWeight, vertexBoneMap->getWeights(), true);
 
                 WeakPointer<Skeleton> skeleton = meshContainer->getSkeleton();
-                for(UInt32 i = 0; i < skeleton->getNodeCount(); i++) {
-                    Skeleton::SkeletonNode * node = skeleton->getNodeFromList(i);
-                    if (node->BoneIndex >= 0) {
-                        Int32 bonesLocation = material->getShaderLocation(StandardUniform::Bones, node->BoneIndex);
-                        if (bonesLocation >= 0) {
-                            shader->setUniformMatrix4(bonesLocation, node->TempRenderTransformation);
-                        }
-                    }
+                if (bonesLocation >= 0 && skeleton.isValid()) {
+                    skeleton->getSkinningPalette().sendToActiveShader(textureSlot, bonesLocation);
+                    bonesSent = true;
                 }
             }
         }
+        if (bonesLocation >= 0) {
+            if (!bonesSent) shader->setUniform1i(bonesLocation, textureSlot);
+            textureSlot++;
+        }
     }
 
      Bool MeshRenderer::forwardRenderObject(const ViewDescriptor& viewDescriptor, WeakPointer<BaseRenderable> renderable, Bool isStatic,
@@ -132,6 +128,13 @@ namespace Core {
     Bool MeshRenderer::forwardRenderMesh(const ViewDescriptor& viewDescriptor, WeakPointer<Mesh> mesh, Bool isStatic,
                                          Int32 layer, const LightPack& lightPack, Bool matchPhysicalPropertiesWithLighting) {
 
+        WeakPointer<MeshContainer> meshContainer = this->owner->getMeshContainer();
+        if (meshContainer.isValid() && meshContainer->hasLODChain(mesh->getObjectID())) {
+            UInt32 viewportHeight = Engine::instance()->getGraphicsSystem()->getViewport().w;
+            Real screenSize = RenderUtils::calculateScreenSizeOfMesh(viewDescriptor, viewportHeight, mesh, this->owner);
+            mesh = meshContainer->selectLOD(mesh, viewDescriptor.viewID, screenSize);
+        }
+
         Matrix4x4 tempMatrix;
         WeakPointer<Material> material;
         Bool copiedStateFromOverrideMaterial = false;
@@ -156,6 +159,17 @@ namespace Core {
                 copiedStateFromOverrideMaterial = true;
             }
         }
+
+        // where the view allows it, draw with a stand-in while the material's shader is still being compiled
+        Bool fallbackAllowed = !usingOverrideMaterial && !renderingDepthOutput && viewDescriptor.fallbackMaterialAllowed;
+        if (!material->prepareShader(!fallbackAllowed)) {
+            material = Engine::instance()->getFallbackMaterial();
+            material->prepareShader(true);
+            savedOverrideMaterialSkinningEnabled = material->isSkinningEnabled();
+            material->setSkinningEnabled(this->material->isSkinningEnabled());
+            usingOverrideMaterial = true;
+        }
+
         WeakPointer<Shader> shader = material->getShader();
         WeakPointer<Graphics> graphics = Engine::instance()->getGraphicsSystem();
         graphics->activateShader(shader);
@@ -165,6 +179,9 @@ namespace Core {
         // send custom uniforms first so that the renderer can override if necessary.
         material->sendCustomUniformsToShader();
 
+        // every attribute of an interleaved mesh is an element of the same buffer, so it is bound once for all of them
+        std::shared_ptr<InterleavedVertexBuffer> interleavedVertexBuffer = mesh->getInterleavedVertexBuffer();
+        if (interleavedVertexBuffer) interleavedVertexBuffer->bind();
         this->checkAndSetShaderAttribute(mesh, material, StandardAttribute::Position, StandardAttribute::Position, mesh->getVertexPositions());
         this->checkAndSetShaderAttribute(mesh, material, StandardAttribute::Normal, StandardAttribute::Normal, mesh->getVertexNormals());
         this->checkAndSetShaderAttribute(mesh, material, StandardAttribute::AveragedNormal, StandardAttribute::AveragedNormal, mesh->getVertexAveragedNormals());
@@ -177,8 +194,6 @@ namespace Core {
         else
             this->checkAndSetShaderAttribute(mesh, material, StandardAttribute::AlbedoUV, StandardAttribute::NormalUV, mesh->getVertexAlbedoUVs());
 
-        this->setSkinningVars(mesh, material, shader);
-
         Int32 cameraPositionLoc = material->getShaderLocation(StandardUniform::CameraPosition);
         if (cameraPositionLoc >= 0) {
             shader->setUniform4f(cameraPositionLoc, viewDescriptor.cameraPosition.x, viewDescriptor.cameraPosition.y,
@@ -203,6 +218,8 @@ namespace Core {
 
 
         UInt32 baseTextureSlot = material->textureCount();
+        this->setSkinningVars(mesh, material, shader, baseTextureSlot);
+
         Int32 ssaoMapLoc = material->getShaderLocation(StandardUniform::SSAOMap);
         Int32 ssaoEnabledLoc = material->getShaderLocation(StandardUniform::SSAOEnabled);
         if (ssaoMapLoc >= 0) {
@@ -43,7 +43,7 @@ namespace Core {
         void disableShaderAttribute(WeakPointer<Mesh> mesh, WeakPointer<Material> material, StandardAttribute attribute,
                                     WeakPointer<AttributeArrayBase> array);
         void setRenderStateForMaterial(WeakPointer<Material> material, Bool renderingDepthOutput);
-        void setSkinningVars(WeakPointer<Mesh> mesh, WeakPointer<Material> material, WeakPointer<Shader> shader);
+        void setSkinningVars(WeakPointer<Mesh> mesh, WeakPointer<Material> material, WeakPointer<Shader> shader, UInt32& textureSlot);
         void drawMesh(WeakPointer<Mesh> mesh);
 
         void testAndSetTexture2DWithInc(WeakPointer<Shader> shader, UInt32& textureSlot, Int32 shaderVarLoc, UInt32 textureID);
@@ -27,6 +27,7 @@ namespace Core {
             this->particleSystem = WeakPointer<ParticleSystem>::nullPtr();
             this->isStatic = false;
             this->isActive = false;
+            this->isInView = true;
         }
       
         PersistentWeakPointer<BaseObject3DRenderer> renderer;
@@ -37,6 +38,8 @@ namespace Core {
         PersistentWeakPointer<ParticleSystem> particleSystem;
         Bool isStatic;
         Bool isActive;
+        // frustum test result for particle systems, updated once per view by Renderer::cullParticleSystems()
+        Bool isInView;
         Int32 layer;
     };
 }
\ No newline at end of file
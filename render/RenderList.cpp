@@ -3,7 +3,9 @@
 
 namespace Core {
 
-    RenderList::RenderList() {
+    RenderList::RenderList(FrameArena* arena) {
+        this->arena = arena;
+        this->arenaResetCount = 0;
     }
 
     UInt32 RenderList::getItemCount() const {
@@ -12,11 +14,12 @@ namespace Core {
 
     void RenderList::clear() {
         this->renderItems.clear();
-        this->renderItemPool.returnAll();
+        if (this->arena) this->discardStaleArenaItems();
+        else this->renderItemPool.returnAll();
     }
 
     void RenderList::addItem(WeakPointer<BaseObject3DRenderer> renderer, WeakPointer<BaseRenderable> renderable, Bool isStatic, Bool isActive, Int32 layer) {
-        RenderItem& renderItem = this->renderItemPool.acquireObject();
+        RenderItem& renderItem = this->acquireRenderItem();
         this->initRenderItem(renderItem, isStatic, isActive, layer);
         renderItem.renderer = renderer;
         renderItem.renderable = renderable;
@@ -24,7 +27,7 @@ namespace Core {
     }
 
     void RenderList::addMesh(WeakPointer<MeshRenderer> meshRenderer, WeakPointer<Mesh> mesh, Bool isStatic, Bool isActive, Int32 layer) {
-        RenderItem& renderItem = this->renderItemPool.acquireObject();
+        RenderItem& renderItem = this->acquireRenderItem();
         this->initRenderItem(renderItem, isStatic, isActive, layer);
         renderItem.meshRenderer = meshRenderer;
         renderItem.mesh = mesh;
@@ -32,7 +35,7 @@ namespace Core {
     }
 
     void RenderList::addParticleSystem(WeakPointer<ParticleSystemRenderer> particleSystemRenderer, WeakPointer<ParticleSystem> particleSystem, Bool isStatic, Bool isActive, Int32 layer) {
-        RenderItem& renderItem = this->renderItemPool.acquireObject();
+        RenderItem& renderItem = this->acquireRenderItem();
         this->initRenderItem(renderItem, isStatic, isActive, layer);
         renderItem.particleSystemRenderer = particleSystemRenderer;
         renderItem.particleSystem = particleSystem;
@@ -53,6 +56,31 @@ namespace Core {
         }
     }
 
+    ObjectPool<RenderItem>::Statistics RenderList::getRenderItemPoolStatistics() {
+        return this->renderItemPool.getStatistics();
+    }
+
+    RenderItem& RenderList::acquireRenderItem() {
+        if (!this->arena) return this->renderItemPool.acquireObject();
+
+        this->discardStaleArenaItems();
+        UInt32 index = this->renderItems.size();
+        if (index >= this->arenaItems.size()) {
+            RenderItem* block = this->arena->create<RenderItem>(ArenaItemBlockSize);
+            for (UInt32 i = 0; i < ArenaItemBlockSize; i++) this->arenaItems.push_back(block + i);
+        }
+        return *this->arenaItems[index];
+    }
+
+    // Items from a previous frame were destroyed when the arena was reset.
+    void RenderList::discardStaleArenaItems() {
+        UInt64 resetCount = this->arena->getResetCount();
+        if (resetCount == this->arenaResetCount) return;
+        this->renderItems.clear();
+        this->arenaItems.resize(0);
+        this->arenaResetCount = resetCount;
+    }
+
     void RenderList::initRenderItem(RenderItem& renderItem, Bool isStatic, Bool isActive, Int32 layer) {
         renderItem.meshRenderer = WeakPointer<MeshRenderer>::nullPtr();
         renderItem.renderer = WeakPointer<BaseObject3DRenderer>::nullPtr();
@@ -7,6 +7,7 @@
 #include "../util/PersistentWeakPointer.h"
 #include "../util/ObjectPool.h"
 #include "../util/SimpleObjectPool.h"
+#include "../util/FrameArena.h"
 #include "RenderItem.h"
 
 namespace Core {
@@ -23,7 +24,7 @@ namespace Core {
     class RenderList {
     public:
 
-        RenderList();
+        RenderList(FrameArena* arena = nullptr);
 
         UInt32 getItemCount() const;
         void clear();
@@ -32,13 +33,24 @@ namespace Core {
         void addParticleSystem(WeakPointer<ParticleSystemRenderer> particleSystemRenderer, WeakPointer<ParticleSystem> particleSystem, Bool isStatic, Bool isActive, Int32 layer);
         RenderItem& getRenderItem(UInt32 index);
         void setAllActive();
+        ObjectPool<RenderItem>::Statistics getRenderItemPoolStatistics();
 
     protected:
+        RenderItem& acquireRenderItem();
         void initRenderItem(RenderItem& renderItem, Bool isStatic, Bool isActive, Int32 layer);
         ObjectPool<RenderItem> renderItemPool;
         std::vector<RenderItem*> renderItems;
         UInt32 itemCount;
 
     private:
+        static const UInt32 ArenaItemBlockSize = 64;
+
+        void discardStaleArenaItems();
+
+        // A list that belongs to a frame context takes its items from the context's arena instead of
+        // [renderItemPool], and reuses them after clear() until the arena is reset.
+        FrameArena* arena;
+        UInt64 arenaResetCount;
+        std::vector<RenderItem*> arenaItems;
     };
 }
\ No newline at end of file
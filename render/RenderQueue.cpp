@@ -2,7 +2,7 @@
 
 namespace Core {
 
-    RenderQueue::RenderQueue(UInt32 id) {
+    RenderQueue::RenderQueue(UInt32 id, FrameArena* arena): RenderList(arena) {
         this->id = id;
     }
 
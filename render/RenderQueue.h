@@ -9,7 +9,7 @@ namespace Core {
     class RenderQueue: public RenderList {
     public:
 
-        RenderQueue(UInt32 id);
+        RenderQueue(UInt32 id, FrameArena* arena = nullptr);
         UInt32 getID() const;
 
     private:
@@ -1,11 +1,13 @@
 #include <algorithm>
+#include <tuple>
+#include <utility>
 
 #include "RenderQueueManager.h"
 
 namespace Core {
 
-    RenderQueueManager::RenderQueueManager() {
-
+    RenderQueueManager::RenderQueueManager(FrameArena* arena) {
+        this->arena = arena;
     }
 
     UInt32 RenderQueueManager::getRenderQueueCount() const {
@@ -39,7 +41,7 @@ namespace Core {
 
     RenderQueue& RenderQueueManager::getOrAddRenderQueue(UInt32 queueID) {
         if (this->queues.find(queueID) == this->queues.end()) {
-            this->queues.emplace(queueID, queueID);
+            this->queues.emplace(std::piecewise_construct, std::forward_as_tuple(queueID), std::forward_as_tuple(queueID, this->arena));
             RenderQueue& queue = queues.at(queueID);
             this->orderedQueues.push_back(&queue);
             Int32 testIndex = this->orderedQueues.size() - 2;
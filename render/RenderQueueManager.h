@@ -5,6 +5,7 @@
 
 #include "../common/types.h"
 #include "../util/WeakPointer.h"
+#include "../util/FrameArena.h"
 #include "RenderQueue.h"
 
 namespace Core {
@@ -19,7 +20,7 @@ namespace Core {
     class RenderQueueManager {
     public:
 
-        RenderQueueManager();
+        RenderQueueManager(FrameArena* arena = nullptr);
 
         UInt32 getRenderQueueCount() const;
         void clearAll();
@@ -34,6 +35,8 @@ namespace Core {
         RenderQueue& getOrAddRenderQueue(UInt32 queueID);
         std::unordered_map<UInt32, RenderQueue> queues;
         std::vector<RenderQueue*> orderedQueues;
+        // passed on to the queues, see RenderList
+        FrameArena* arena;
 
     private:
     };
@@ -1,7 +1,10 @@
 #include "RenderUtils.h"
 #include "../light/PointLight.h"
 #include "../geometry/Mesh.h"
+#include "../geometry/Box3.h"
+#include "../particles/ParticleSystem.h"
 #include "../math/Quaternion.h"
+#include "ViewDescriptor.h"
 
 namespace Core {
 
@@ -28,4 +31,95 @@ namespace Core {
 
         return distance <= boundingSphere.w * maxScale + radius;
     }
+
+    // Approximate on-screen diameter, in pixels, of the mesh's bounding sphere.
+    Real RenderUtils::calculateScreenSizeOfMesh(const ViewDescriptor& viewDescriptor, UInt32 viewportHeight, WeakPointer<Mesh> mesh, WeakPointer<Object3D> meshOwner) {
+        const Vector4r& boundingSphere = mesh->getBoundingSphere();
+        Vector4r center(boundingSphere.x, boundingSphere.y, boundingSphere.z, 1.0f);
+        meshOwner->getTransform().applyTransformationTo(center);
+        viewDescriptor.inverseCameraTransformation.transform(center);
+        viewDescriptor.projectionMatrix.transform(center);
+
+        Point3r pos;
+        Quaternion rot;
+        Point3r scale;
+        Matrix4x4 meshWorldMatrix = meshOwner->getTransform().getWorldMatrix();
+        meshWorldMatrix.decompose(pos, rot, scale);
+        Real maxScale = Math::max(Math::max(scale.x, scale.y), scale.z);
+
+        // for perspective projections, treat the camera being inside the bounding sphere as full-screen
+        const Real* projection = viewDescriptor.projectionMatrix.getConstData();
+        Bool isPerspective = projection[15] == 0.0f;
+        if (isPerspective && center.w <= boundingSphere.w * maxScale) return (Real)viewportHeight;
+
+        return boundingSphere.w * maxScale * projection[5] * (Real)viewportHeight / center.w;
+    }
+
+    // Test the mesh's bounding sphere against the view frustum. [cameraDistance] receives the distance from the
+    // camera to the sphere's center.
+    Bool RenderUtils::isMeshInView(const ViewDescriptor& viewDescriptor, WeakPointer<Mesh> mesh, WeakPointer<Object3D> meshOwner, Real& cameraDistance) {
+        const Vector4r& boundingSphere = mesh->getBoundingSphere();
+        Vector4r center(boundingSphere.x, boundingSphere.y, boundingSphere.z, 1.0f);
+        meshOwner->getTransform().applyTransformationTo(center);
+
+        Point3r pos;
+        Quaternion rot;
+        Point3r scale;
+        Matrix4x4 meshWorldMatrix = meshOwner->getTransform().getWorldMatrix();
+        meshWorldMatrix.decompose(pos, rot, scale);
+        Real radius = boundingSphere.w * Math::max(Math::max(scale.x, scale.y), scale.z);
+
+        return RenderUtils::isSphereInView(viewDescriptor, center, radius, cameraDistance);
+    }
+
+    // Test a sphere around the particle system's bounds against the view frustum. A system without live particles
+    // is tested where new particles will appear.
+    Bool RenderUtils::isParticleSystemInView(const ViewDescriptor& viewDescriptor, WeakPointer<ParticleSystem> particleSystem, Real& cameraDistance) {
+        WeakPointer<Object3D> owner = particleSystem->getOwner();
+        return RenderUtils::isParticleSystemInView(viewDescriptor, particleSystem->hasBounds(), particleSystem->getBounds(),
+                                                   particleSystem->getSimulateInWorldSpace(), owner->getTransform().getWorldMatrix(), cameraDistance);
+    }
+
+    /*
+     * The particle renderers draw particle positions with the view matrix only, whether or not the system simulates in
+     * world space, so [bounds] are tested as they are. Only the emission point of an empty world space system follows
+     * the owner (whose world transform is [ownerWorldMatrix]); an empty local space system emits around the origin.
+     */
+    Bool RenderUtils::isParticleSystemInView(const ViewDescriptor& viewDescriptor, Bool hasBounds, const Box3& bounds, Bool simulateInWorldSpace,
+                                             const Matrix4x4& ownerWorldMatrix, Real& cameraDistance) {
+        Vector4r center(0.0f, 0.0f, 0.0f, 1.0f);
+        Real radius = 0.0f;
+        if (hasBounds) {
+            Vector3r extent = bounds.getMax() - bounds.getMin();
+            center.set((bounds.getMin().x + bounds.getMax().x) * 0.5f, (bounds.getMin().y + bounds.getMax().y) * 0.5f,
+                       (bounds.getMin().z + bounds.getMax().z) * 0.5f, 1.0f);
+            radius = extent.magnitude() * 0.5f;
+        } else if (simulateInWorldSpace) {
+            ownerWorldMatrix.transform(center);
+        }
+
+        return RenderUtils::isSphereInView(viewDescriptor, center, radius, cameraDistance);
+    }
+
+    // Test a sphere with world space [center] against the view frustum, whose planes are taken from the rows of the
+    // projection matrix (Gribb & Hartmann). [cameraDistance] receives the distance from the camera to the center.
+    Bool RenderUtils::isSphereInView(const ViewDescriptor& viewDescriptor, const Vector4r& center, Real radius, Real& cameraDistance) {
+        Vector4r viewCenter = center;
+        viewDescriptor.inverseCameraTransformation.transform(viewCenter);
+        cameraDistance = Math::squareRoot(viewCenter.x * viewCenter.x + viewCenter.y * viewCenter.y + viewCenter.z * viewCenter.z);
+
+        const Real* projection = viewDescriptor.projectionMatrix.getConstData();
+        for (UInt32 i = 0; i < 6; i++) {
+            Real sign = (i & 1) ? -1.0f : 1.0f;
+            UInt32 row = i >> 1;
+            Real a = projection[3] + sign * projection[row];
+            Real b = projection[7] + sign * projection[4 + row];
+            Real c = projection[11] + sign * projection[8 + row];
+            Real d = projection[15] + sign * projection[12 + row];
+            Real length = Math::squareRoot(a * a + b * b + c * c);
+            if (length <= 0.0f) continue;
+            if ((a * viewCenter.x + b * viewCenter.y + c * viewCenter.z + d) / length < -radius) return false;
+        }
+        return true;
+    }
 }
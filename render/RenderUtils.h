@@ -4,6 +4,7 @@
 #include "../common/types.h"
 #include "../base/CoreObject.h"
 #include "../geometry/Vector3.h"
+#include "../geometry/Vector4.h"
 
 namespace Core {
 
@@ -11,12 +12,22 @@ namespace Core {
     class PointLight;
     class Object3D;
     class Mesh;
+    class ViewDescriptor;
+    class ParticleSystem;
+    class Box3;
+    class Matrix4x4;
 
     class RenderUtils {
     public:
 
         static Bool isPointLightInRangeOfMesh(WeakPointer<PointLight>, WeakPointer<Mesh> mesh, WeakPointer<Object3D> meshOwner);
         static Bool isPointLightInRangeOfMesh(const Point3r& pointLightPosition, Real radius, WeakPointer<Mesh> mesh, WeakPointer<Object3D> meshOwner);
+        static Real calculateScreenSizeOfMesh(const ViewDescriptor& viewDescriptor, UInt32 viewportHeight, WeakPointer<Mesh> mesh, WeakPointer<Object3D> meshOwner);
+        static Bool isMeshInView(const ViewDescriptor& viewDescriptor, WeakPointer<Mesh> mesh, WeakPointer<Object3D> meshOwner, Real& cameraDistance);
+        static Bool isParticleSystemInView(const ViewDescriptor& viewDescriptor, WeakPointer<ParticleSystem> particleSystem, Real& cameraDistance);
+        static Bool isParticleSystemInView(const ViewDescriptor& viewDescriptor, Bool hasBounds, const Box3& bounds, Bool simulateInWorldSpace,
+                                           const Matrix4x4& ownerWorldMatrix, Real& cameraDistance);
+        static Bool isSphereInView(const ViewDescriptor& viewDescriptor, const Vector4r& center, Real radius, Real& cameraDistance);
 
     };
 
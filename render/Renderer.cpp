@@ -18,11 +18,13 @@
 #include "../render/RenderableContainer.h"
 #include "../render/EngineRenderQueue.h"
 #include "../particles/renderer/ParticleSystemRenderer.h"
+#include "../particles/ParticleSystem.h"
 #include "../scene/Scene.h"
 #include "../scene/Skybox.h"
 #include "../image/TextureAttr.h"
 #include "../image/Texture.h"
 #include "../image/Texture2D.h"
+#include "../image/TextureStreamer.h"
 #include "../material/DepthOnlyMaterial.h"
 #include "../material/NormalsMaterial.h"
 #include "../material/PositionsMaterial.h"
@@ -44,14 +46,18 @@
 #include "../geometry/Mesh.h"
 #include "../util/Time.h"
 #include "../util/Profiler.h"
+#include "../animation/AnimationManager.h"
+#include "../animation/Skeleton.h"
 #include "ReflectionProbe.h"
 #include "RenderUtils.h"
+#include "MeshContainer.h"
 
 
 namespace Core {
 
     Renderer::Renderer() {
-        
+        this->activeViewFrameContextCount = 0;
+        this->frameDepth = 0;
     }
 
     Renderer::~Renderer() {
@@ -132,32 +138,20 @@ namespace Core {
 
     UInt32 profileType = 0;
     void Renderer::renderScene(WeakPointer<Object3D> rootObject, WeakPointer<Material> overrideMaterial) {
-        static std::vector<WeakPointer<Object3D>> objectList;
-        static std::vector<WeakPointer<Camera>> cameraList;
-        static std::vector<WeakPointer<Light>> lightList;
-        static std::vector<WeakPointer<Light>> nonIBLLightList;
-        static std::vector<WeakPointer<DirectionalLight>> directionalLightList;
-        static std::vector<WeakPointer<PointLight>> pointLightList;
-        static std::vector<WeakPointer<AmbientLight>> ambientLightList;
-        static std::vector<WeakPointer<AmbientIBLLight>> ambientIBLLightList;
-        static LightPack lightPack;
-        static LightPack nonIBLLightPack;
-        static std::vector<WeakPointer<ReflectionProbe>> reflectionProbeList;
-        static std::vector<WeakPointer<Object3D>> renderProbeObjects;
-        objectList.resize(0);
-        cameraList.resize(0);
-        lightList.resize(0);
-        nonIBLLightList.resize(0);
-        directionalLightList.resize(0);
-        pointLightList.resize(0);
-        ambientIBLLightList.resize(0);
-        ambientLightList.resize(0);
-        lightPack.clear();
-        nonIBLLightPack.clear();
-        reflectionProbeList.resize(0);
-        renderProbeObjects.resize(0);
-
-        
+        this->beginFrame();
+        ViewFrameContext& frameContext = this->acquireViewFrameContext();
+        std::vector<WeakPointer<Object3D>>& objectList = frameContext.objects;
+        std::vector<WeakPointer<Camera>>& cameraList = frameContext.cameras;
+        std::vector<WeakPointer<Light>>& lightList = frameContext.lights;
+        std::vector<WeakPointer<Light>>& nonIBLLightList = frameContext.nonIBLLights;
+        std::vector<WeakPointer<DirectionalLight>>& directionalLightList = frameContext.directionalLights;
+        std::vector<WeakPointer<PointLight>>& pointLightList = frameContext.pointLights;
+        std::vector<WeakPointer<AmbientLight>>& ambientLightList = frameContext.ambientLights;
+        std::vector<WeakPointer<AmbientIBLLight>>& ambientIBLLightList = frameContext.ambientIBLLights;
+        LightPack& lightPack = frameContext.createLightPack();
+        LightPack& nonIBLLightPack = frameContext.createLightPack();
+        std::vector<WeakPointer<ReflectionProbe>>& reflectionProbeList = frameContext.reflectionProbes;
+        std::vector<WeakPointer<Object3D>>& renderProbeObjects = frameContext.renderProbeObjects;
 
         WeakPointer<Graphics> graphics = Engine::instance()->getGraphicsSystem();
         this->collectSceneObjectsAndComputeTransforms(rootObject, objectList);
@@ -192,12 +186,12 @@ namespace Core {
 
         if (profileType == 1) Profiler::SingleFunction::quickSinglePassStart(40.0f);
 
-        this->renderPointLightShadowMaps(pointLightList, objectList);
+        this->renderPointLightShadowMaps(lightPack.getPointLights(), objectList);
 
         if (profileType == 1) Profiler::SingleFunction::quickSinglePassSection("Point light shadows: ");
 
         for (auto camera : cameraList) {
-            this->renderDirectionalLightShadowMaps(directionalLightList, objectList, camera);
+            this->renderDirectionalLightShadowMaps(lightPack.getDirectionalLights(), objectList, camera);
         }
 
         if (profileType == 1) Profiler::SingleFunction::quickSinglePassSection("Directional light shadows: ");
@@ -205,12 +199,58 @@ namespace Core {
         for (auto camera : cameraList) {
             WeakPointer<Material> savedOverrideMaterial = camera->getOverrideMaterial();
             if (overrideMaterial.isValid()) camera->setOverrideMaterial(overrideMaterial);
-            this->renderForCamera(camera, objectList, lightPack, true);
+            ViewFrameContext& cameraContext = this->acquireViewFrameContext();
+            // only the views the player sees can get away with a stand-in material for one or two frames
+            cameraContext.fallbackMaterialsAllowed = true;
+            this->renderForCamera(camera, objectList, cameraContext, lightPack, true);
             if (overrideMaterial.isValid()) camera->setOverrideMaterial(savedOverrideMaterial);
         }
 
         if (profileType == 1) Profiler::SingleFunction::quickSinglePassSection("Rendering scene: ");
         if (profileType == 1) Profiler::SingleFunction::quickSinglePassEnd(true);
+
+        this->endFrame();
+    }
+
+    const Renderer::FrameStatistics& Renderer::getFrameStatistics() const {
+        return this->frameStatistics;
+    }
+
+    void Renderer::beginFrame() {
+        this->frameDepth.fetch_add(1);
+    }
+
+    // Only the outermost frame releases the view contexts, since rendering a scene can
+    // recursively render other views (e.g. reflection probes) within the same frame.
+    void Renderer::endFrame() {
+        UInt32 depth = this->frameDepth.load();
+        while (depth > 0 && !this->frameDepth.compare_exchange_weak(depth, depth - 1));
+        if (depth != 1) return;
+
+        std::lock_guard<std::mutex> lock(this->viewFrameContextMutex);
+        FrameStatistics stats;
+        stats.viewCount = this->activeViewFrameContextCount;
+        for (UInt32 i = 0; i < this->viewFrameContexts.size(); i++) {
+            ViewFrameContext& context = *this->viewFrameContexts[i];
+            FrameArena::Statistics arenaStats = context.getArena().getStatistics();
+            stats.arenaFramePeakBytes += arenaStats.framePeakBytes;
+            stats.arenaPeakBytes += arenaStats.peakBytes;
+            stats.arenaSteadyStateBytes += arenaStats.steadyStateBytes;
+            stats.arenaCapacity += arenaStats.capacity;
+            if (i < this->activeViewFrameContextCount) context.reset();
+        }
+        this->frameStatistics = stats;
+        this->activeViewFrameContextCount = 0;
+    }
+
+    ViewFrameContext& Renderer::acquireViewFrameContext() {
+        std::lock_guard<std::mutex> lock(this->viewFrameContextMutex);
+        if (this->activeViewFrameContextCount >= this->viewFrameContexts.size()) {
+            this->viewFrameContexts.push_back(std::unique_ptr<ViewFrameContext>(new ViewFrameContext()));
+        }
+        ViewFrameContext& context = *this->viewFrameContexts[this->activeViewFrameContextCount];
+        this->activeViewFrameContextCount++;
+        return context;
     }
 
     void Renderer::collectSceneObjectComponents(std::vector<WeakPointer<Object3D>>& sceneObjects, std::vector<WeakPointer<Camera>>& cameraList,
@@ -244,23 +284,31 @@ namespace Core {
     }
 
     void Renderer::renderSceneBasic(WeakPointer<Object3D> rootObject, WeakPointer<Camera> camera, Bool matchPhysicalPropertiesWithLighting) {
-        static std::vector<WeakPointer<Object3D>> objectList;
-        objectList.resize(0);
+        this->beginFrame();
+        ViewFrameContext& frameContext = this->acquireViewFrameContext();
+        std::vector<WeakPointer<Object3D>>& objectList = frameContext.objects;
 
         Matrix4x4 baseTransformation;
         rootObject->getTransform().getAncestorWorldMatrix(baseTransformation);
 
         this->collectSceneObjectsAndComputeTransforms(rootObject, objectList, baseTransformation);
-        this->renderForCamera(camera, objectList, matchPhysicalPropertiesWithLighting);
+        this->renderForCamera(camera, objectList, frameContext, this->emptyLightPack, matchPhysicalPropertiesWithLighting);
+        this->endFrame();
     }
 
     void Renderer::renderForCamera(WeakPointer<Camera> camera, std::vector<WeakPointer<Object3D>>& objects, Bool matchPhysicalPropertiesWithLighting) {
-        static LightPack lightPack;
-        this->renderForCamera(camera, objects, lightPack, matchPhysicalPropertiesWithLighting);
+        this->renderForCamera(camera, objects, this->emptyLightPack, matchPhysicalPropertiesWithLighting);
     }
 
     void Renderer::renderForCamera(WeakPointer<Camera> camera, std::vector<WeakPointer<Object3D>>& objects, const LightPack& lightPack,
                                    Bool matchPhysicalPropertiesWithLighting) {
+        this->renderForCamera(camera, objects, this->acquireViewFrameContext(), lightPack, matchPhysicalPropertiesWithLighting);
+    }
+
+    // All of the views needed to render [camera] (SSAO inputs, cube faces, the final view) are rendered
+    // one after another, so they share a single frame context.
+    void Renderer::renderForCamera(WeakPointer<Camera> camera, std::vector<WeakPointer<Object3D>>& objects, ViewFrameContext& frameContext,
+                                   const LightPack& lightPack, Bool matchPhysicalPropertiesWithLighting) {
         WeakPointer<Graphics> graphics = Engine::instance()->getGraphicsSystem();
         WeakPointer<RenderTarget> nextRenderTarget = camera->getRenderTarget();
         if (!nextRenderTarget.isValid()) {
@@ -268,7 +316,7 @@ namespace Core {
         }
 
         if (nextRenderTarget->isCube()) {
-            this->renderForCubeCamera(camera, objects, lightPack, matchPhysicalPropertiesWithLighting);
+            this->renderForCubeCamera(camera, objects, frameContext, lightPack, matchPhysicalPropertiesWithLighting);
         }
         else {
 
@@ -282,35 +330,39 @@ namespace Core {
 
             WeakPointer<Texture2D> ssaoMap = WeakPointer<Texture2D>::nullPtr();
             if (camera->isSSAOEnabled()) {
-                this->renderSSAO(camera, objects);
+                this->renderSSAO(camera, objects, frameContext);
                 ssaoMap = this->ssaoBlurMap;
             }
 
-            this->renderForStandardCamera(camera, objects, lightPack, matchPhysicalPropertiesWithLighting, ssaoMap);
+            this->renderForStandardCamera(camera, objects, frameContext, lightPack, matchPhysicalPropertiesWithLighting, ssaoMap);
         }
     }
 
-    void Renderer::renderForStandardCamera(WeakPointer<Camera> camera, std::vector<WeakPointer<Object3D>>& objects, const LightPack& lightPack,
-                                           Bool matchPhysicalPropertiesWithLighting, WeakPointer<Texture2D> ssaoMap) {
-        ViewDescriptor viewDescriptor;
+    void Renderer::renderForStandardCamera(WeakPointer<Camera> camera, std::vector<WeakPointer<Object3D>>& objects, ViewFrameContext& frameContext,
+                                           const LightPack& lightPack, Bool matchPhysicalPropertiesWithLighting, WeakPointer<Texture2D> ssaoMap) {
+        ViewDescriptor& viewDescriptor = *frameContext.getArena().create<ViewDescriptor>();
         this->getViewDescriptorForCamera(camera, viewDescriptor);
         viewDescriptor.ssaoMap = ssaoMap;
         viewDescriptor.ssaoEnabled = ssaoMap.isValid();
-        this->renderForViewDescriptor(viewDescriptor, objects, lightPack, matchPhysicalPropertiesWithLighting);
+        viewDescriptor.fallbackMaterialAllowed = frameContext.fallbackMaterialsAllowed;
+        this->renderForViewDescriptor(viewDescriptor, objects, frameContext, lightPack, matchPhysicalPropertiesWithLighting);
     }
 
-    void Renderer::renderForCubeCamera(WeakPointer<Camera> camera, std::vector<WeakPointer<Object3D>>& objects,
+    void Renderer::renderForCubeCamera(WeakPointer<Camera> camera, std::vector<WeakPointer<Object3D>>& objects, ViewFrameContext& frameContext,
                                        const LightPack& lightPack, Bool matchPhysicalPropertiesWithLighting) {
-        ViewDescriptor viewDesc;
+        ViewDescriptor* faceDescriptors = frameContext.getArena().create<ViewDescriptor>(6);
         for (UInt32 i = 0; i < 6; i++) {
-            this->getViewDescriptorForCubeCamera(camera, (CubeFace)i, viewDesc);
-            this->renderForViewDescriptor(viewDesc, objects, lightPack, matchPhysicalPropertiesWithLighting);
+            this->getViewDescriptorForCubeCamera(camera, (CubeFace)i, faceDescriptors[i]);
+            faceDescriptors[i].fallbackMaterialAllowed = frameContext.fallbackMaterialsAllowed;
+        }
+        for (UInt32 i = 0; i < 6; i++) {
+            this->renderForViewDescriptor(faceDescriptors[i], objects, frameContext, lightPack, matchPhysicalPropertiesWithLighting);
         }
     }
 
-    void Renderer::renderForViewDescriptor(ViewDescriptor& viewDescriptor, std::vector<WeakPointer<Object3D>>& objectList, 
+    void Renderer::renderForViewDescriptor(ViewDescriptor& viewDescriptor, std::vector<WeakPointer<Object3D>>& objectList, ViewFrameContext& frameContext,
                                            const LightPack& lightPack, Bool matchPhysicalPropertiesWithLighting) {
-        static RenderQueueManager renderQueueManager;
+        RenderQueueManager& renderQueueManager = frameContext.renderQueueManager;
         renderQueueManager.clearAll();
 
         Int32 overrideRenderQueueID = viewDescriptor.overrideMaterial.isValid() ? viewDescriptor.overrideMaterial->getRenderQueueID() : -1;
@@ -338,12 +390,63 @@ namespace Core {
 
     void Renderer::renderRenderList(ViewDescriptor& viewDescriptor, RenderList& renderList, 
                                     const LightPack& lightPack, Bool matchPhysicalPropertiesWithLighting) {
+        this->reportTextureScreenSizes(viewDescriptor, renderList);
+        this->reportAnimationVisibility(viewDescriptor, renderList);
+        this->cullParticleSystems(viewDescriptor, renderList);
         for (UInt32 i = 0; i < renderList.getItemCount(); i++) {
             RenderItem& renderItem = renderList.getRenderItem(i);
             this->renderRenderItem(viewDescriptor, renderItem, lightPack, matchPhysicalPropertiesWithLighting);
         }
     }
 
+    void Renderer::reportTextureScreenSizes(ViewDescriptor& viewDescriptor, RenderList& renderList) {
+        TextureStreamer& textureStreamer = Engine::instance()->getTextureStreamer();
+        // passes that render with an override material (shadows, depth, etc.) don't sample the object's textures
+        if (!textureStreamer.isEnabled() || viewDescriptor.overrideMaterial.isValid()) return;
+
+        UInt32 viewportHeight = Engine::instance()->getGraphicsSystem()->getViewport().w;
+        for (UInt32 i = 0; i < renderList.getItemCount(); i++) {
+            RenderItem& renderItem = renderList.getRenderItem(i);
+            if (!renderItem.isActive || !renderItem.mesh.isValid() || !renderItem.meshRenderer.isValid()) continue;
+            WeakPointer<Material> material = renderItem.meshRenderer->getMaterial();
+            if (!material.isValid()) continue;
+            Real screenSize = RenderUtils::calculateScreenSizeOfMesh(viewDescriptor, viewportHeight, renderItem.mesh, renderItem.meshRenderer->getOwner());
+            material->reportTextureScreenSize(textureStreamer, screenSize);
+        }
+    }
+
+    void Renderer::reportAnimationVisibility(ViewDescriptor& viewDescriptor, RenderList& renderList) {
+        WeakPointer<AnimationManager> animationManager = Engine::instance()->getAnimationManager();
+        // only camera views count, shadow passes don't make a character visible
+        if (!animationManager->isLODEnabled() || viewDescriptor.shadowPass) return;
+
+        for (UInt32 i = 0; i < renderList.getItemCount(); i++) {
+            RenderItem& renderItem = renderList.getRenderItem(i);
+            if (!renderItem.isActive || !renderItem.mesh.isValid() || !renderItem.meshRenderer.isValid()) continue;
+            WeakPointer<Object3D> owner = renderItem.meshRenderer->getOwner();
+            WeakPointer<MeshContainer> meshContainer = owner->getMeshContainer();
+            if (!meshContainer.isValid()) continue;
+            WeakPointer<Skeleton> skeleton = meshContainer->getSkeleton();
+            if (!skeleton.isValid()) continue;
+            Real cameraDistance;
+            Bool visible = RenderUtils::isMeshInView(viewDescriptor, renderItem.mesh, owner, cameraDistance);
+            animationManager->reportVisibility(skeleton, cameraDistance, visible);
+        }
+    }
+
+    // Frustum test each particle system once for this view. The result decides whether the system is drawn and,
+    // as with animation, is reported to the system only for camera views.
+    void Renderer::cullParticleSystems(ViewDescriptor& viewDescriptor, RenderList& renderList) {
+        UInt64 frame = Time::getFrameCount();
+        for (UInt32 i = 0; i < renderList.getItemCount(); i++) {
+            RenderItem& renderItem = renderList.getRenderItem(i);
+            if (!renderItem.isActive || !renderItem.particleSystemRenderer.isValid() || !renderItem.particleSystem.isValid()) continue;
+            Real cameraDistance;
+            renderItem.isInView = RenderUtils::isParticleSystemInView(viewDescriptor, renderItem.particleSystem, cameraDistance);
+            if (!viewDescriptor.shadowPass) renderItem.particleSystem->reportVisibility(renderItem.isInView, frame);
+        }
+    }
+
     void Renderer::renderRenderItem(ViewDescriptor& viewDescriptor, RenderItem& renderItem, 
                                     const LightPack& lightPack, Bool matchPhysicalPropertiesWithLighting) {
         if (renderItem.isActive) {
@@ -351,6 +454,7 @@ namespace Core {
                 renderItem.meshRenderer->forwardRenderMesh(viewDescriptor, renderItem.mesh, renderItem.isStatic,
                                                            renderItem.layer, lightPack, matchPhysicalPropertiesWithLighting);
             } else if(renderItem.particleSystemRenderer.isValid()) {
+                if (!renderItem.isInView) return;
                 renderItem.particleSystemRenderer->forwardRenderParticleSystem(viewDescriptor, renderItem.particleSystem, renderItem.isStatic,
                                                                                renderItem.layer, lightPack, matchPhysicalPropertiesWithLighting);
             } else if (renderItem.renderer.isValid()) {
@@ -399,8 +503,7 @@ namespace Core {
     }
 
     void Renderer::cullRenderListForPointLight(RenderList& renderList, WeakPointer<PointLight> pointLight) {
-        static Point3r pointLightPos;
-        pointLightPos.set(0.0f, 0.0f, 0.0f);
+        Point3r pointLightPos(0.0f, 0.0f, 0.0f);
         pointLight->getOwner()->getTransform().applyTransformationTo(pointLightPos);
         for (UInt32 i = 0; i < renderList.getItemCount(); i++) {
             RenderItem& renderItem = renderList.getRenderItem(i);
@@ -418,7 +521,6 @@ namespace Core {
     }
 
     void Renderer::renderSkybox(ViewDescriptor& viewDescriptor) {
-        static LightPack lightPack;
         if (viewDescriptor.skybox != nullptr) {
             WeakPointer<BaseObject3DRenderer> renderer = viewDescriptor.skybox->getSkyboxObject()->getBaseRenderer();
             if (renderer) {
@@ -428,14 +530,13 @@ namespace Core {
                 skyboxView.inverseCameraTransformation.invert();
                 skyboxView.transposedCameraTransformation.copy(skyboxView.cameraTransformation);
                 skyboxView.transposedCameraTransformation.transpose();
-                renderer->forwardRender(skyboxView, lightPack, true);
+                renderer->forwardRender(skyboxView, this->emptyLightPack, true);
             }
         }
     }
 
     void Renderer::renderObjectDirect(WeakPointer<Object3D> object, WeakPointer<Camera> camera, Bool matchPhysicalPropertiesWithLighting) {
-        static LightPack lightPack;
-        this->renderObjectDirect(object, camera, lightPack, matchPhysicalPropertiesWithLighting);
+        this->renderObjectDirect(object, camera, this->emptyLightPack, matchPhysicalPropertiesWithLighting);
     }
 
     void Renderer::renderObjectDirect(WeakPointer<Object3D> object, WeakPointer<Camera> camera,
@@ -456,12 +557,12 @@ namespace Core {
         }
     }
 
-    void Renderer::renderDirectionalLightShadowMaps(const std::vector<WeakPointer<DirectionalLight>>& lights,
+    void Renderer::renderDirectionalLightShadowMaps(const LightPack::DirectionalLightList& lights,
                                                     std::vector<WeakPointer<Object3D>>& objects, WeakPointer<Camera> renderCamera) {
-        static std::vector<std::vector<WeakPointer<Object3D>>> toRenderDirectional;
-        static std::vector<WeakPointer<DirectionalLight>> renderLights;
-        static LightPack lightPack;
-        static RenderList renderList;
+        ViewFrameContext& frameContext = this->acquireViewFrameContext();
+        std::vector<std::vector<WeakPointer<Object3D>>>& toRenderDirectional = frameContext.shadowCasters;
+        std::vector<WeakPointer<DirectionalLight>>& renderLights = frameContext.directionalLights;
+        RenderList& renderList = frameContext.renderList;
 
         if (!this->orthoShadowMapCamera.isValid()) {
             this->orthoShadowMapCameraObject = Engine::instance()->createObject3D();
@@ -501,11 +602,12 @@ namespace Core {
                 this->depthMaterial->setCullFace(directionalLight->getCullFace());
                 std::vector<DirectionalLight::OrthoProjection>& projections = directionalLight->buildProjections(renderCamera);
                 Matrix4x4 viewTrans = directionalLight->getOwner()->getTransform().getWorldMatrix();
-                ViewDescriptor viewDesc;
+                ViewDescriptor& viewDesc = *frameContext.getArena().create<ViewDescriptor>();
                 viewDesc.indirectHDREnabled = false;
                 viewDesc.cubeFace = -1;
                 viewDesc.overrideMaterial = this->depthMaterial;
                 viewDesc.depthOutputOverride = DepthOutputOverride::Depth;
+                viewDesc.shadowPass = true;
                 std::vector<WeakPointer<Object3D>>& renderObjects = toRenderDirectional[curLight];
                 renderList.clear();
                 this->buildRenderListFromObjects(renderObjects, renderList);
@@ -516,18 +618,19 @@ namespace Core {
                     this->getViewDescriptorTransformations(viewTrans, orthoShadowMapCamera->getProjectionMatrix(),
                                                            this->orthoShadowMapCamera->getAutoClearRenderBuffers(), viewDesc);
                     viewDesc.renderTarget = directionalLight->getShadowMap(i);
-                    this->renderForViewDescriptor(viewDesc, renderList, lightPack, true);
+                    viewDesc.viewID = directionalLight->getObjectID() ^ ((UInt64)(i + 1) << 56);
+                    this->renderForViewDescriptor(viewDesc, renderList, this->emptyLightPack, true);
                 }
             }
             curLight++;
         }
     }
 
-    void Renderer::renderPointLightShadowMaps(const std::vector<WeakPointer<PointLight>>& lights, std::vector<WeakPointer<Object3D>>& objects) {
-        static std::vector<std::vector<WeakPointer<Object3D>>> toRenderPoint;
-        static std::vector<WeakPointer<PointLight>> renderLights;
-        static LightPack lightPack;
-        static RenderList renderList;
+    void Renderer::renderPointLightShadowMaps(const LightPack::PointLightList& lights, std::vector<WeakPointer<Object3D>>& objects) {
+        ViewFrameContext& frameContext = this->acquireViewFrameContext();
+        std::vector<std::vector<WeakPointer<Object3D>>>& toRenderPoint = frameContext.shadowCasters;
+        std::vector<WeakPointer<PointLight>>& renderLights = frameContext.pointLights;
+        RenderList& renderList = frameContext.renderList;
 
         if (!this->perspectiveShadowMapCamera.isValid()) {
             this->perspectiveShadowMapCameraObject = Engine::instance()->createObject3D();
@@ -581,11 +684,15 @@ namespace Core {
                 this->buildRenderListFromObjects(renderObjects, renderList);
 
                 this->cullRenderListForPointLight(renderList, pointLight);
-                ViewDescriptor viewDesc;
+                ViewDescriptor* faceDescriptors = frameContext.getArena().create<ViewDescriptor>(6);
 
                 for (UInt32 i = 0; i < 6; i++) {
+                    ViewDescriptor& viewDesc = faceDescriptors[i];
                     this->getViewDescriptorForCubeCamera(this->perspectiveShadowMapCamera, (CubeFace)i, viewDesc);
-                    this->renderForViewDescriptor(viewDesc, renderList, lightPack, true);
+                    // the shadow map camera is shared by all point lights, so identify the view by the light instead
+                    viewDesc.viewID = pointLight->getObjectID() ^ ((UInt64)(i + 1) << 56);
+                    viewDesc.shadowPass = true;
+                    this->renderForViewDescriptor(viewDesc, renderList, this->emptyLightPack, true);
                 }
             }
             curLight++;
@@ -614,30 +721,27 @@ namespace Core {
         graphics->clearActiveRenderTarget(clearColorBuffer, clearDepthBuffer, clearStencilBuffer);
     }
 
+    static std::vector<Matrix4x4> buildCubeFaceOrientations() {
+        Matrix4x4 forward, backward, up, down, left, right;
+        forward.lookAt(Vector3r::Zero, Vector3r::Backward, Vector3r::Down);
+        backward.lookAt(Vector3r::Zero, Vector3r::Forward, Vector3r::Down);
+        up.lookAt(Vector3r::Zero, Vector3r::Up, Vector3r::Backward);
+        down.lookAt(Vector3r::Zero, Vector3r::Down, Vector3r::Forward);
+        left.lookAt(Vector3r::Zero, Vector3r::Left, Vector3r::Down);
+        right.lookAt(Vector3r::Zero, Vector3r::Right, Vector3r::Down);
+        std::vector<Matrix4x4> orientations;
+        orientations.push_back(forward);
+        orientations.push_back(backward);
+        orientations.push_back(up);
+        orientations.push_back(down);
+        orientations.push_back(left);
+        orientations.push_back(right);
+        return orientations;
+    }
+
     void Renderer::getViewDescriptorForCubeCamera(WeakPointer<Camera> camera, CubeFace cubeFace, ViewDescriptor& outDescriptor) {
-        static bool initialized = false;
-        static Matrix4x4 forward;
-        static Matrix4x4 left;
-        static Matrix4x4 right;
-        static Matrix4x4 up;
-        static Matrix4x4 down;
-        static Matrix4x4 backward;
-        static std::vector<Matrix4x4> orientations;
-        if (!initialized) {
-            initialized = true;
-            forward.lookAt(Vector3r::Zero, Vector3r::Backward, Vector3r::Down);
-            backward.lookAt(Vector3r::Zero, Vector3r::Forward, Vector3r::Down);
-            up.lookAt(Vector3r::Zero, Vector3r::Up, Vector3r::Backward);
-            down.lookAt(Vector3r::Zero, Vector3r::Down, Vector3r::Forward);
-            left.lookAt(Vector3r::Zero, Vector3r::Left, Vector3r::Down);
-            right.lookAt(Vector3r::Zero, Vector3r::Right, Vector3r::Down);
-            orientations.push_back(forward);
-            orientations.push_back(backward);
-            orientations.push_back(up);
-            orientations.push_back(down);
-            orientations.push_back(left);
-            orientations.push_back(right);
-        }
+        // initialization of a function-local static is thread-safe, so cube faces can be prepared concurrently
+        static const std::vector<Matrix4x4> orientations = buildCubeFaceOrientations();
 
         WeakPointer<Graphics> graphics = Engine::instance()->getGraphicsSystem();
         ViewDescriptor baseViewDescriptor;
@@ -649,6 +753,7 @@ namespace Core {
         this->getViewDescriptorTransformations(cameraTransform, camera->getProjectionMatrix(),
                                                camera->getAutoClearRenderBuffers(), viewDescriptor);
         viewDescriptor.cubeFace = (UInt16)cubeFace;
+        viewDescriptor.viewID = camera->getObjectID() ^ ((UInt64)((UInt16)cubeFace + 1) << 56);
         viewDescriptor.overrideMaterial = camera->getOverrideMaterial();
         outDescriptor = viewDescriptor;
     }
@@ -687,6 +792,7 @@ namespace Core {
             viewDescriptor.hdrRenderTarget = WeakPointer<RenderTarget2D>::nullPtr();
             viewDescriptor.renderTarget = cameraRenderTarget;
         }
+        viewDescriptor.viewID = camera->getObjectID();
         viewDescriptor.overrideMaterial = camera->getOverrideMaterial();
         viewDescriptor.depthOutputOverride = camera->getDepthOutputOverride();
         viewDescriptor.hdrExposure = camera->getHDRExposure();
@@ -701,6 +807,7 @@ namespace Core {
         viewDescriptor.ssaoMap = WeakPointer<Texture2D>::nullPtr();
         viewDescriptor.ssaoRadius = camera->getSSAORadius();
         viewDescriptor.ssaoBias = camera->getSSAOBias();
+        viewDescriptor.fallbackMaterialAllowed = false;
        
     }
 
@@ -749,9 +856,9 @@ namespace Core {
         }
     }
 
-    void Renderer::renderReflectionProbes(std::vector<WeakPointer<ReflectionProbe>>& reflectionProbeList, std::vector<WeakPointer<Object3D>> renderProbeObjects,
+    void Renderer::renderReflectionProbes(std::vector<WeakPointer<ReflectionProbe>>& reflectionProbeList, std::vector<WeakPointer<Object3D>>& renderProbeObjects,
                                           const LightPack& lightPack, const LightPack& nonIBLLightPack) {
-        static std::vector<WeakPointer<Object3D>> emptyObjectList;
+        std::vector<WeakPointer<Object3D>> emptyObjectList;
         for (auto reflectionProbe : reflectionProbeList) {
             if (reflectionProbe->getNeedsFullUpdate() || reflectionProbe->getNeedsSpecularUpdate()) {
 
@@ -813,14 +920,14 @@ namespace Core {
         reflectionProbe->setNeedsFullUpdate(false);
     }
 
-    void Renderer::renderSSAO(WeakPointer<Camera> camera, std::vector<WeakPointer<Object3D>>& objects) {
+    void Renderer::renderSSAO(WeakPointer<Camera> camera, std::vector<WeakPointer<Object3D>>& objects, ViewFrameContext& frameContext) {
 
-        ViewDescriptor viewDescriptor;
+        ViewDescriptor& viewDescriptor = *frameContext.getArena().create<ViewDescriptor>();
         this->getViewDescriptorForCamera(camera, viewDescriptor);
 
         DepthOutputOverride saveDepthOutputOverride = viewDescriptor.depthOutputOverride;
         viewDescriptor.depthOutputOverride = DepthOutputOverride::Depth;
-        this->renderPositionsAndNormals(viewDescriptor, objects);
+        this->renderPositionsAndNormals(viewDescriptor, objects, frameContext);
         viewDescriptor.depthOutputOverride = saveDepthOutputOverride;
 
         this->ssaoMaterial->setViewPositions(this->depthPositionsRenderTarget->getColorTexture(0));
@@ -858,8 +965,7 @@ namespace Core {
         return this->ssaoBlurMap;
     }
 
-    void Renderer::renderDepthAndNormals(ViewDescriptor& viewDescriptor, std::vector<WeakPointer<Object3D>>& objects) {
-        static LightPack lightPack;
+    void Renderer::renderDepthAndNormals(ViewDescriptor& viewDescriptor, std::vector<WeakPointer<Object3D>>& objects, ViewFrameContext& frameContext) {
 
         WeakPointer<RenderTarget> saveRenderTarget = viewDescriptor.renderTarget;
         WeakPointer<RenderTarget> saveHDRRenderTarget = viewDescriptor.hdrRenderTarget;
@@ -873,7 +979,7 @@ namespace Core {
         viewDescriptor.renderTarget = this->depthNormalsRenderTarget;
         viewDescriptor.overrideMaterial = this->normalsMaterial;
 
-        this->renderForViewDescriptor(viewDescriptor, objects, lightPack, false);
+        this->renderForViewDescriptor(viewDescriptor, objects, frameContext, this->emptyLightPack, false);
        
         viewDescriptor.indirectHDREnabled = saveIndirectHDREnabled;
         viewDescriptor.hdrRenderTarget = saveHDRRenderTarget;
@@ -881,8 +987,7 @@ namespace Core {
         viewDescriptor.overrideMaterial = saveOverrideMaterial;
     }
 
-    void Renderer::renderPositionsAndNormals(ViewDescriptor& viewDescriptor, std::vector<WeakPointer<Object3D>>& objects) {
-        static LightPack lightPack;
+    void Renderer::renderPositionsAndNormals(ViewDescriptor& viewDescriptor, std::vector<WeakPointer<Object3D>>& objects, ViewFrameContext& frameContext) {
 
         WeakPointer<RenderTarget> saveRenderTarget = viewDescriptor.renderTarget;
         WeakPointer<RenderTarget> saveHDRRenderTarget = viewDescriptor.hdrRenderTarget;
@@ -896,11 +1001,11 @@ namespace Core {
 
         viewDescriptor.renderTarget = this->depthNormalsRenderTarget;
         viewDescriptor.overrideMaterial = this->normalsMaterial;
-        this->renderForViewDescriptor(viewDescriptor, objects, lightPack, false);
+        this->renderForViewDescriptor(viewDescriptor, objects, frameContext, this->emptyLightPack, false);
 
         viewDescriptor.renderTarget = this->depthPositionsRenderTarget;
         viewDescriptor.overrideMaterial = this->positionsMaterial;
-        this->renderForViewDescriptor(viewDescriptor, objects, lightPack, false);
+        this->renderForViewDescriptor(viewDescriptor, objects, frameContext, this->emptyLightPack, false);
 
         /*viewDescriptor.renderTarget = this->positionsNormalsRenderTarget;
         viewDescriptor.overrideMaterial = this->positionsNormalsMaterial;
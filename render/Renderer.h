@@ -1,6 +1,9 @@
 #pragma once
 
 #include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
 
 #include "../common/complextypes.h"
 #include "../common/debug.h"
@@ -9,6 +12,7 @@
 #include "RenderState.h"
 #include "RenderQueueManager.h"
 #include "RenderList.h"
+#include "ViewFrameContext.h"
 #include "../geometry/Vector2.h"
 #include "../geometry/Vector4.h"
 #include "../scene/Transform.h"
@@ -48,6 +52,24 @@ namespace Core {
 
     class Renderer : public CoreObject {
     public:
+
+        class FrameStatistics {
+        public:
+            FrameStatistics() {
+                this->viewCount = 0;
+                this->arenaFramePeakBytes = 0;
+                this->arenaPeakBytes = 0;
+                this->arenaSteadyStateBytes = 0;
+                this->arenaCapacity = 0;
+            }
+
+            UInt32 viewCount;
+            UInt64 arenaFramePeakBytes;
+            UInt64 arenaPeakBytes;
+            UInt64 arenaSteadyStateBytes;
+            UInt64 arenaCapacity;
+        };
+
         virtual ~Renderer();
         virtual Bool init();
         void renderScene(WeakPointer<Scene> scene, WeakPointer<Material> overrideMaterial = WeakPointer<Material>::nullPtr());
@@ -57,19 +79,25 @@ namespace Core {
         void renderObjectDirect(WeakPointer<Object3D> object, WeakPointer<Camera> camera, const LightPack& lightPack,
                                 Bool matchPhysicalPropertiesWithLighting);
         WeakPointer<Texture2D> getSSAOTexture();
+        const FrameStatistics& getFrameStatistics() const;
 
     protected:
         Renderer();
+        void beginFrame();
+        void endFrame();
+        ViewFrameContext& acquireViewFrameContext();
         void renderForCamera(WeakPointer<Camera> camera, std::vector<WeakPointer<Object3D>>& objects, 
                              Bool matchPhysicalPropertiesWithLighting);
         void renderForCamera(WeakPointer<Camera> camera, std::vector<WeakPointer<Object3D>>& objects, 
                              const LightPack& lightPack, Bool matchPhysicalPropertiesWithLighting);
-        void renderForStandardCamera(WeakPointer<Camera> camera, std::vector<WeakPointer<Object3D>>& objects, 
+        void renderForCamera(WeakPointer<Camera> camera, std::vector<WeakPointer<Object3D>>& objects, ViewFrameContext& frameContext,
+                             const LightPack& lightPack, Bool matchPhysicalPropertiesWithLighting);
+        void renderForStandardCamera(WeakPointer<Camera> camera, std::vector<WeakPointer<Object3D>>& objects, ViewFrameContext& frameContext,
                                      const LightPack& lightPack, Bool matchPhysicalPropertiesWithLighting,
                                      WeakPointer<Texture2D> ssaoMap = WeakPointer<Texture2D>::nullPtr());
-        void renderForCubeCamera(WeakPointer<Camera> camera, std::vector<WeakPointer<Object3D>>& objects, 
+        void renderForCubeCamera(WeakPointer<Camera> camera, std::vector<WeakPointer<Object3D>>& objects, ViewFrameContext& frameContext,
                                  const LightPack& lightPack, Bool matchPhysicalPropertiesWithLighting);
-        void renderForViewDescriptor(ViewDescriptor& viewDescriptor, std::vector<WeakPointer<Object3D>>& objectList, 
+        void renderForViewDescriptor(ViewDescriptor& viewDescriptor, std::vector<WeakPointer<Object3D>>& objectList, ViewFrameContext& frameContext,
                                      const LightPack& lightPack, Bool matchPhysicalPropertiesWithLighting);
         void renderForViewDescriptor(ViewDescriptor& viewDescriptor, RenderQueueManager& renderQueueManager, 
                                      const LightPack& lightPack, Bool matchPhysicalPropertiesWithLighting);
@@ -79,6 +107,9 @@ namespace Core {
                               const LightPack& lightPack, Bool matchPhysicalPropertiesWithLighting);
         void renderRenderItem(ViewDescriptor& viewDescriptor, RenderItem& renderItem, 
                               const LightPack& lightPack, Bool matchPhysicalPropertiesWithLighting);
+        void reportTextureScreenSizes(ViewDescriptor& viewDescriptor, RenderList& renderList);
+        void reportAnimationVisibility(ViewDescriptor& viewDescriptor, RenderList& renderList);
+        void cullParticleSystems(ViewDescriptor& viewDescriptor, RenderList& renderList);
         WeakPointer<RenderTarget> preRenderForViewDescriptor(ViewDescriptor& viewDescriptor);
         void postRenderForViewDescriptor(ViewDescriptor& viewDescriptor, WeakPointer<RenderTarget> currentRenderTarget);
 
@@ -87,9 +118,9 @@ namespace Core {
         void renderSkybox(ViewDescriptor& viewDescriptor);
         void renderObjectDirect(WeakPointer<Object3D> object, ViewDescriptor& viewDescriptor, const LightPack& lightPack,
                                 Bool matchPhysicalPropertiesWithLighting);
-        void renderDirectionalLightShadowMaps(const std::vector<WeakPointer<DirectionalLight>>& lightList,
+        void renderDirectionalLightShadowMaps(const LightPack::DirectionalLightList& lightList,
                                               std::vector<WeakPointer<Object3D>>& objects, WeakPointer<Camera> renderCamera);
-        void renderPointLightShadowMaps(const std::vector<WeakPointer<PointLight>>& lightList, std::vector<WeakPointer<Object3D>>& objects);
+        void renderPointLightShadowMaps(const LightPack::PointLightList& lightList, std::vector<WeakPointer<Object3D>>& objects);
         void setViewportAndMipLevelForRenderTarget(WeakPointer<RenderTarget> renderTarget, Int16 cubeFace);
         void clearActiveRenderTarget(ViewDescriptor& viewDescriptor);
         void getViewDescriptorForCubeCamera(WeakPointer<Camera> camera, CubeFace cubeFace, ViewDescriptor& outDescriptor);
@@ -106,13 +137,13 @@ namespace Core {
                                           std::vector<WeakPointer<DirectionalLight>>& directionalLightList, std::vector<WeakPointer<PointLight>>& pointLightList,
                                           std::vector<WeakPointer<AmbientLight>>& ambientLightList, std::vector<WeakPointer<AmbientIBLLight>>& ambientIBLLightList,
                                           std::vector<WeakPointer<Light>>& lightList);
-        void renderReflectionProbes(std::vector<WeakPointer<ReflectionProbe>>& reflectionProbeList, std::vector<WeakPointer<Object3D>> staticObjects,
+        void renderReflectionProbes(std::vector<WeakPointer<ReflectionProbe>>& reflectionProbeList, std::vector<WeakPointer<Object3D>>& staticObjects,
                                     const LightPack& lightPack, const LightPack& nonIBLLightPack);
         void renderReflectionProbe(WeakPointer<ReflectionProbe> reflectionProbe, Bool specularOnly,
                                    std::vector<WeakPointer<Object3D>>& renderObjects, const LightPack& lightPack);
-        void renderSSAO(WeakPointer<Camera> camera, std::vector<WeakPointer<Object3D>>& objects);
-        void renderDepthAndNormals(ViewDescriptor& viewDescriptor, std::vector<WeakPointer<Object3D>>& objects);
-        void renderPositionsAndNormals(ViewDescriptor& viewDescriptor, std::vector<WeakPointer<Object3D>>& objects);
+        void renderSSAO(WeakPointer<Camera> camera, std::vector<WeakPointer<Object3D>>& objects, ViewFrameContext& frameContext);
+        void renderDepthAndNormals(ViewDescriptor& viewDescriptor, std::vector<WeakPointer<Object3D>>& objects, ViewFrameContext& frameContext);
+        void renderPositionsAndNormals(ViewDescriptor& viewDescriptor, std::vector<WeakPointer<Object3D>>& objects, ViewFrameContext& frameContext);
         void initializeSSAO();
 
         void sortObjectsIntoRenderQueues(std::vector<WeakPointer<Object3D>>& objects, RenderQueueManager& renderQueueManager, Int32 overrideRenderQueueID=-1);
@@ -147,5 +178,13 @@ namespace Core {
         PersistentWeakPointer<SSAOBlurMaterial> ssaoBlurMaterial;
         WeakPointer<Texture2D> ssaoNoise;
         std::vector<Vector3r> ssaoKernel;
+
+        LightPack emptyLightPack;
+        std::vector<std::unique_ptr<ViewFrameContext>> viewFrameContexts;
+        UInt32 activeViewFrameContextCount;
+        // beginFrame() and endFrame() may be called from the threads that prepare views
+        std::atomic<UInt32> frameDepth;
+        std::mutex viewFrameContextMutex;
+        FrameStatistics frameStatistics;
     };
 }
@@ -18,6 +18,9 @@ namespace Core {
     class ViewDescriptor {
     public:
 
+        // identifies the camera (and cube face or shadow cascade) being rendered, so that per-view state such
+        // as LOD selection carries over from one frame to the next
+        UInt64 viewID = 0;
         Point3r cameraPosition;
         Matrix4x4 inverseCameraTransformation;
         Matrix4x4 cameraTransformation;
@@ -26,6 +29,8 @@ namespace Core {
         mutable PersistentWeakPointer<Material> overrideMaterial;
         PersistentWeakPointer<RenderTarget> renderTarget;
         PersistentWeakPointer<RenderTarget> hdrRenderTarget;
+        // renders a shadow map rather than a camera's view, so objects drawn in it are not visible on screen
+        Bool shadowPass = false;
         Int32 cubeFace = -1;
         Int32 mipLevel = 0;
         IntMask clearRenderBuffers;
@@ -39,6 +44,8 @@ namespace Core {
         Real ssaoRadius = 1.5f;
         Real ssaoBias = 0.05f;
         DepthOutputOverride depthOutputOverride = DepthOutputOverride::None;
+        // meshes whose shaders are still compiling may be drawn with Engine::getFallbackMaterial()
+        Bool fallbackMaterialAllowed = false;
     };
 
 }
\ No newline at end of file
@@ -0,0 +1,43 @@
+#include "ViewFrameContext.h"
+
+namespace Core {
+
+    ViewFrameContext::ViewFrameContext(): renderList(&this->arena), renderQueueManager(&this->arena) {
+        this->fallbackMaterialsAllowed = false;
+        this->oversizedFrames = 0;
+    }
+
+    void ViewFrameContext::reset() {
+        UInt64 capacity = this->objects.capacity();
+        Bool oversized = capacity > TrimMinCapacity && capacity > this->objects.size() * 4;
+        this->oversizedFrames = oversized ? this->oversizedFrames + 1 : 0;
+        Bool trim = this->oversizedFrames > TrimFrameDelay;
+        if (trim) this->oversizedFrames = 0;
+
+        resetVector(this->objects, trim);
+        resetVector(this->cameras, trim);
+        resetVector(this->lights, trim);
+        resetVector(this->nonIBLLights, trim);
+        resetVector(this->directionalLights, trim);
+        resetVector(this->pointLights, trim);
+        resetVector(this->ambientLights, trim);
+        resetVector(this->ambientIBLLights, trim);
+        resetVector(this->reflectionProbes, trim);
+        resetVector(this->renderProbeObjects, trim);
+        for (UInt32 i = 0; i < this->shadowCasters.size(); i++) {
+            resetVector(this->shadowCasters[i], trim);
+        }
+        this->renderList.clear();
+        this->renderQueueManager.clearAll();
+        this->fallbackMaterialsAllowed = false;
+        this->arena.reset();
+    }
+
+    FrameArena& ViewFrameContext::getArena() {
+        return this->arena;
+    }
+
+    LightPack& ViewFrameContext::createLightPack() {
+        return *this->arena.create<LightPack>(1, &this->arena);
+    }
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <vector>
+
+#include "../common/types.h"
+#include "../util/WeakPointer.h"
+#include "../util/FrameArena.h"
+#include "../light/LightPack.h"
+#include "RenderList.h"
+#include "RenderQueueManager.h"
+
+namespace Core {
+
+    // forward declarations
+    class Object3D;
+    class Camera;
+    class Light;
+    class DirectionalLight;
+    class PointLight;
+    class AmbientLight;
+    class AmbientIBLLight;
+    class ReflectionProbe;
+
+    // Scratch state used while preparing and rendering a single pass (a camera with all of its
+    // faces and SSAO inputs, or a set of shadow maps). Contexts are handed out by the Renderer for
+    // the duration of a frame, so two passes never share scratch state and can be prepared on
+    // different threads. Per-view data (view descriptors, light packs, render items) lives in the
+    // context's arena; the containers below keep their capacity from frame to frame.
+    class ViewFrameContext {
+    public:
+        ViewFrameContext();
+
+        void reset();
+        FrameArena& getArena();
+        LightPack& createLightPack();
+
+        std::vector<WeakPointer<Object3D>> objects;
+        std::vector<WeakPointer<Camera>> cameras;
+        std::vector<WeakPointer<Light>> lights;
+        std::vector<WeakPointer<Light>> nonIBLLights;
+        std::vector<WeakPointer<DirectionalLight>> directionalLights;
+        std::vector<WeakPointer<PointLight>> pointLights;
+        std::vector<WeakPointer<AmbientLight>> ambientLights;
+        std::vector<WeakPointer<AmbientIBLLight>> ambientIBLLights;
+        std::vector<WeakPointer<ReflectionProbe>> reflectionProbes;
+        std::vector<WeakPointer<Object3D>> renderProbeObjects;
+        std::vector<std::vector<WeakPointer<Object3D>>> shadowCasters;
+        RenderList renderList;
+        RenderQueueManager renderQueueManager;
+        // see ViewDescriptor::fallbackMaterialAllowed
+        Bool fallbackMaterialsAllowed;
+
+    private:
+        // a context has to be oversized for this many consecutive frames before its containers are trimmed
+        static const UInt32 TrimFrameDelay = 120;
+        static const UInt32 TrimMinCapacity = 1024;
+
+        template <typename T>
+        static void resetVector(std::vector<T>& vector, Bool trim) {
+            vector.resize(0);
+            if (trim) vector.shrink_to_fit();
+        }
+
+        FrameArena arena;
+        UInt32 oversizedFrames;
+    };
+}
@@ -0,0 +1,112 @@
+#include <cmath>
+#include <vector>
+
+#include "TestUtil.h"
+#include "../animation/AnimationCompressor.h"
+#include "../animation/KeyFrameSet.h"
+#include "../math/Math.h"
+
+using namespace Core;
+
+static const UInt32 KeyCount = 240;
+static const Real FrameTime = 1.0f / 30.0f;
+
+// Reconstruct [track] at [time] the way the player does: linearly between the two surrounding kept keys.
+static Vector3r sampleVector(const CompressedKeyFrames& track, Real time) {
+    Vector3r result;
+    UInt32 count = track.getKeyCount();
+    UInt32 next = 0;
+    while (next < count - 1 && track.Times[next] < time) next++;
+    if (next == 0 || track.Times[next] == time) {
+        track.getVector(next, result);
+        return result;
+    }
+    Vector3r a, b;
+    track.getVector(next - 1, a);
+    track.getVector(next, b);
+    Real delta = track.Times[next] - track.Times[next - 1];
+    Real t = delta > 0.0f ? (time - track.Times[next - 1]) / delta : 1.0f;
+    result.set(a.x + (b.x - a.x) * t, a.y + (b.y - a.y) * t, a.z + (b.z - a.z) * t);
+    return result;
+}
+
+static Real getTranslationError(const std::vector<TranslationKeyFrame>& source, const CompressedKeyFrames& track) {
+    Real maxError = 0.0f;
+    for (const TranslationKeyFrame& keyFrame : source) {
+        Vector3r reconstructed = sampleVector(track, keyFrame.RealTime);
+        Vector3r delta(reconstructed.x - keyFrame.Translation.x, reconstructed.y - keyFrame.Translation.y,
+                       reconstructed.z - keyFrame.Translation.z);
+        maxError = Math::max(maxError, Math::squareRoot(delta.x * delta.x + delta.y * delta.y + delta.z * delta.z));
+    }
+    return maxError;
+}
+
+// A walk cycle-like channel: smooth translation over [range], a constant scale and a slow rotation.
+static void buildKeyFrameSet(Real range, KeyFrameSet& keyFrameSet) {
+    keyFrameSet.Used = true;
+    Real duration = (Real)(KeyCount - 1) * FrameTime;
+    for (UInt32 k = 0; k < KeyCount; k++) {
+        Real time = (Real)k * FrameTime;
+        Real phase = time / duration * 6.2831853f;
+        Vector3r translation(std::sin(phase) * range * 0.5f, std::fabs(std::sin(phase * 2.0f)) * range * 0.1f, time / duration * range);
+        keyFrameSet.TranslationKeyFrames.push_back(TranslationKeyFrame(time / duration, time, time, translation));
+        keyFrameSet.ScaleKeyFrames.push_back(ScaleKeyFrame(time / duration, time, time, Vector3r(1.0f, 1.0f, 1.0f)));
+        Quaternion rotation = Quaternion::fromAngleAxis(phase * 0.25f, 0.0f, 1.0f, 0.0f);
+        keyFrameSet.RotationKeyFrames.push_back(RotationKeyFrame(time / duration, time, time, rotation));
+    }
+}
+
+static void testCompressionStaysWithinTolerance() {
+    KeyFrameSet keyFrameSet;
+    buildKeyFrameSet(2.0f, keyFrameSet);
+    std::vector<TranslationKeyFrame> source = keyFrameSet.TranslationKeyFrames;
+    AnimationCompressor::Settings settings;
+
+    AnimationCompressor::Statistics statistics = AnimationCompressor::compress(keyFrameSet, settings);
+    CORE_CHECK(keyFrameSet.Compressed);
+    CORE_CHECK(!keyFrameSet.CompressedTranslations.Uncompressed);
+    CORE_CHECK(keyFrameSet.CompressedScales.Constant);
+    CORE_CHECK_EQUAL(statistics.trackCount, 3u);
+    CORE_CHECK_EQUAL(statistics.constantTrackCount, 1u);
+    CORE_CHECK_EQUAL(statistics.uncompressedTrackCount, 0u);
+    CORE_CHECK(statistics.maxTranslationError <= settings.translationTolerance);
+    CORE_CHECK(statistics.maxRotationError <= settings.rotationTolerance);
+
+    // measured independently of the compressor's own bookkeeping
+    CORE_CHECK(getTranslationError(source, keyFrameSet.CompressedTranslations) <= settings.translationTolerance * 1.01f);
+    CORE_CHECK(keyFrameSet.CompressedTranslations.getKeyCount() < KeyCount);
+    CORE_CHECK(statistics.getCompressionRatio() > 4.0f);
+}
+
+static void testWideTrackStaysUncompressed() {
+    // a 1000 unit range quantized to 16 bits is off by up to 0.0076 per axis, far above the tolerance
+    KeyFrameSet keyFrameSet;
+    buildKeyFrameSet(1000.0f, keyFrameSet);
+    std::vector<TranslationKeyFrame> source = keyFrameSet.TranslationKeyFrames;
+    AnimationCompressor::Settings settings;
+
+    AnimationCompressor::Statistics statistics = AnimationCompressor::compress(keyFrameSet, settings);
+    const CompressedKeyFrames& translations = keyFrameSet.CompressedTranslations;
+    CORE_CHECK(translations.Uncompressed);
+    CORE_CHECK_EQUAL(statistics.uncompressedTrackCount, 1u);
+    CORE_CHECK_EQUAL(statistics.maxTranslationError, 0.0f);
+    if (!CORE_CHECK_EQUAL(translations.getKeyCount(), KeyCount)) return;
+    CORE_CHECK_EQUAL(getTranslationError(source, translations), 0.0f);
+    // the rotation and scale tracks are still compressed
+    CORE_CHECK(!keyFrameSet.CompressedRotations.Uncompressed);
+    CORE_CHECK(statistics.getCompressionRatio() > 1.0f);
+
+    // a looser tolerance lets the same track be quantized again
+    KeyFrameSet looseKeyFrameSet;
+    buildKeyFrameSet(1000.0f, looseKeyFrameSet);
+    settings.translationTolerance = 0.05f;
+    statistics = AnimationCompressor::compress(looseKeyFrameSet, settings);
+    CORE_CHECK(!looseKeyFrameSet.CompressedTranslations.Uncompressed);
+    CORE_CHECK(getTranslationError(source, looseKeyFrameSet.CompressedTranslations) <= settings.translationTolerance * 1.01f);
+}
+
+int main(int argc, char** argv) {
+    Test::run("compressed tracks stay within tolerance", testCompressionStaysWithinTolerance);
+    Test::run("tracks too wide to quantize stay uncompressed", testWideTrackStaysUncompressed);
+    return Test::result();
+}
@@ -0,0 +1,166 @@
+#include <cmath>
+#include <vector>
+
+#include "TestUtil.h"
+#include "../animation/AnimationLODScheduler.h"
+
+using namespace Core;
+
+static const UInt32 NodeCount = 60;
+
+// Players on the x axis at the given positions, with a camera moving along it.
+class Crowd {
+public:
+    std::vector<Real> positions;
+    std::vector<AnimationLODScheduler::PlayerState> states;
+    std::vector<AnimationLODScheduler::PlayerState*> players;
+
+    explicit Crowd(const std::vector<Real>& positions): positions(positions), states(positions.size()) {
+        for (AnimationLODScheduler::PlayerState& state : this->states) {
+            state.nodeCount = NodeCount;
+            this->players.push_back(&state);
+        }
+    }
+
+    // report every player to [scheduler] as seen from [cameraX], visible if it is within [viewRange] of the camera
+    void report(const AnimationLODScheduler& scheduler, Real cameraX, Real viewRange, UInt64 frame) {
+        for (UInt32 i = 0; i < this->states.size(); i++) {
+            Real distance = std::fabs(this->positions[i] - cameraX);
+            scheduler.reportVisibility(this->states[i], distance, distance <= viewRange, frame);
+        }
+    }
+};
+
+static AnimationLODScheduler::Settings getSettings() {
+    AnimationLODScheduler::Settings settings;
+    settings.enabled = true;
+    settings.fullRateDistance = 10.0f;
+    settings.intervalDistance = 10.0f;
+    settings.maxUpdateInterval = 4;
+    settings.visibilityTimeout = 2;
+    return settings;
+}
+
+static void testUpdateRateFollowsDistance() {
+    AnimationLODScheduler scheduler;
+    scheduler.setSettings(getSettings());
+    Crowd crowd({5.0f, 15.0f, 25.0f, 100.0f});
+    std::vector<UInt32> evaluations(crowd.states.size(), 0);
+    UInt32 wrongBlends = 0;
+
+    const UInt32 frames = 120;
+    for (UInt64 frame = 1; frame <= frames; frame++) {
+        crowd.report(scheduler, 0.0f, 1000.0f, frame);
+        scheduler.schedule(crowd.players, frame);
+        for (UInt32 i = 0; i < crowd.states.size(); i++) {
+            const AnimationLODScheduler::PlayerState& state = crowd.states[i];
+            CORE_CHECK(state.mode == AnimationLODScheduler::UpdateMode::Full);
+            if (state.evaluate) evaluations[i]++;
+        }
+        // after the first evaluation, the pose blends from the previous evaluation to the latest one over the interval
+        const AnimationLODScheduler::PlayerState& far = crowd.states[3];
+        if (frame > 1 && far.blendFactor != (Real)(far.framesSinceEvaluation + 1) / 4.0f) wrongBlends++;
+    }
+    CORE_CHECK_EQUAL(wrongBlends, 0u);
+
+    CORE_CHECK_EQUAL(crowd.states[0].updateInterval, 1u);
+    CORE_CHECK_EQUAL(crowd.states[1].updateInterval, 2u);
+    CORE_CHECK_EQUAL(crowd.states[2].updateInterval, 3u);
+    CORE_CHECK_EQUAL(crowd.states[3].updateInterval, 4u);
+    CORE_CHECK_EQUAL(evaluations[0], frames);
+    CORE_CHECK_EQUAL(evaluations[1], frames / 2);
+    CORE_CHECK_EQUAL(evaluations[2], frames / 3);
+    CORE_CHECK_EQUAL(evaluations[3], frames / 4);
+}
+
+static void testOffscreenPlayers() {
+    AnimationLODScheduler::Settings settings = getSettings();
+    AnimationLODScheduler scheduler;
+    scheduler.setSettings(settings);
+    Crowd crowd({5.0f, 50.0f});
+
+    // the camera starts next to the first player and only sees players within 10 units
+    UInt64 frame = 1;
+    for (; frame <= 10; frame++) {
+        crowd.report(scheduler, 0.0f, 10.0f, frame);
+        UInt32 cost = scheduler.schedule(crowd.players, frame);
+        // the second player is never visible, so only its root is updated once the timeout has passed
+        if (frame > settings.visibilityTimeout) {
+            CORE_CHECK(crowd.states[1].mode == AnimationLODScheduler::UpdateMode::RootOnly);
+            CORE_CHECK(crowd.states[1].evaluate);
+            CORE_CHECK_EQUAL(cost, NodeCount + 1);
+        }
+    }
+
+    // the camera moves to the second player: it resumes full updates with a fresh pose
+    crowd.report(scheduler, 50.0f, 10.0f, frame);
+    scheduler.schedule(crowd.players, frame);
+    CORE_CHECK(crowd.states[1].mode == AnimationLODScheduler::UpdateMode::Full);
+    CORE_CHECK(crowd.states[1].evaluate);
+    CORE_CHECK(crowd.states[1].resetPose);
+    CORE_CHECK_EQUAL(crowd.states[1].blendFactor, 1.0f);
+    // the first player stays in full mode until the timeout runs out
+    CORE_CHECK(crowd.states[0].mode == AnimationLODScheduler::UpdateMode::Full);
+    frame++;
+
+    settings.offscreenMode = AnimationLODScheduler::UpdateMode::Frozen;
+    scheduler.setSettings(settings);
+    for (UInt32 i = 0; i <= settings.visibilityTimeout; i++, frame++) {
+        crowd.report(scheduler, 50.0f, 10.0f, frame);
+        scheduler.schedule(crowd.players, frame);
+    }
+    CORE_CHECK(crowd.states[0].mode == AnimationLODScheduler::UpdateMode::Frozen);
+    CORE_CHECK(!crowd.states[0].evaluate);
+}
+
+static void testBudgetServesEveryone() {
+    AnimationLODScheduler::Settings settings = getSettings();
+    settings.fullRateDistance = 1000.0f;
+    settings.boneEvaluationBudget = NodeCount * 3;
+    AnimationLODScheduler scheduler;
+    scheduler.setSettings(settings);
+
+    std::vector<Real> positions;
+    for (UInt32 i = 0; i < 12; i++) positions.push_back((Real)i);
+    Crowd crowd(positions);
+    std::vector<UInt32> evaluations(crowd.states.size(), 0);
+    std::vector<UInt32> longestWait(crowd.states.size(), 0);
+
+    const UInt32 frames = 120;
+    for (UInt64 frame = 1; frame <= frames; frame++) {
+        crowd.report(scheduler, 0.0f, 1000.0f, frame);
+        UInt32 cost = scheduler.schedule(crowd.players, frame);
+        CORE_CHECK(cost <= settings.boneEvaluationBudget);
+        for (UInt32 i = 0; i < crowd.states.size(); i++) {
+            if (crowd.states[i].evaluate) evaluations[i]++;
+            if (crowd.states[i].framesSinceEvaluation > longestWait[i]) longestWait[i] = crowd.states[i].framesSinceEvaluation;
+        }
+    }
+
+    // twelve players sharing three evaluations per frame: each one gets its turn every four frames
+    for (UInt32 i = 0; i < crowd.states.size(); i++) {
+        CORE_CHECK_EQUAL(evaluations[i], frames / 4);
+        CORE_CHECK(longestWait[i] <= 4);
+    }
+}
+
+static void testDisabledEvaluatesEverything() {
+    AnimationLODScheduler scheduler;
+    Crowd crowd({5.0f, 500.0f});
+    for (UInt64 frame = 1; frame <= 10; frame++) {
+        crowd.report(scheduler, 0.0f, 10.0f, frame);
+        CORE_CHECK_EQUAL(scheduler.schedule(crowd.players, frame), NodeCount * 2);
+        for (const AnimationLODScheduler::PlayerState& state : crowd.states) {
+            CORE_CHECK(state.evaluate);
+            CORE_CHECK_EQUAL(state.blendFactor, 1.0f);
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    Test::run("update rate follows camera distance", testUpdateRateFollowsDistance);
+    Test::run("off-screen players update their root or freeze", testOffscreenPlayers);
+    Test::run("the evaluation budget serves every player in turn", testBudgetServesEveryone);
+    Test::run("a disabled scheduler evaluates everything", testDisabledEvaluatesEverything);
+    return Test::result();
+}
@@ -0,0 +1,179 @@
+#include <cmath>
+#include <limits>
+#include <string.h>
+#include <vector>
+
+#include "TestUtil.h"
+#include "../geometry/AttributeFormat.h"
+
+using namespace Core;
+
+static Real decodeSNorm10(UInt32 bits) {
+    Int32 value = (Int32)(bits << 22) >> 22;
+    Real decoded = (Real)value / 511.0f;
+    return decoded < -1.0f ? -1.0f : decoded;
+}
+
+static void testHalfFloatRoundTrip() {
+    // every finite half converts to a float and back unchanged
+    UInt32 mismatches = 0;
+    for (UInt32 bits = 0; bits < 0x10000; bits++) {
+        UInt16 half = (UInt16)bits;
+        if ((half & 0x7C00) == 0x7C00 && (half & 0x3FF) != 0) continue;
+        if (AttributeFormats::floatToHalf(AttributeFormats::halfToFloat(half)) != half) mismatches++;
+    }
+    CORE_CHECK_EQUAL(mismatches, 0u);
+
+    CORE_CHECK_EQUAL(AttributeFormats::floatToHalf(1.0f), (UInt16)0x3C00);
+    CORE_CHECK_EQUAL(AttributeFormats::floatToHalf(-2.0f), (UInt16)0xC000);
+    CORE_CHECK_EQUAL(AttributeFormats::floatToHalf(65504.0f), (UInt16)0x7BFF);
+    // halfway between 1 and the next half: ties go to the even mantissa
+    CORE_CHECK_EQUAL(AttributeFormats::floatToHalf(1.0f + 1.0f / 2048.0f), (UInt16)0x3C00);
+    CORE_CHECK_EQUAL(AttributeFormats::floatToHalf(1.0f + 3.0f / 2048.0f), (UInt16)0x3C02);
+    // overflow, underflow, the smallest denormal and NaN
+    CORE_CHECK_EQUAL(AttributeFormats::floatToHalf(100000.0f), (UInt16)0x7C00);
+    CORE_CHECK_EQUAL(AttributeFormats::floatToHalf(1.0e-10f), (UInt16)0x0000);
+    CORE_CHECK_EQUAL(AttributeFormats::floatToHalf(std::ldexp(1.0f, -24)), (UInt16)0x0001);
+    CORE_CHECK(std::isnan(AttributeFormats::halfToFloat(AttributeFormats::floatToHalf(std::numeric_limits<Real>::quiet_NaN()))));
+}
+
+static void testHalfFloatTextureCoordinates() {
+    // UVs in [0, 1] keep about three decimal digits
+    std::vector<Real> uvs;
+    for (UInt32 i = 0; i <= 1000; i++) uvs.push_back((Real)i / 1000.0f);
+    std::vector<Byte> packed(AttributeFormats::getAttributeSize(AttributeFormat::HalfFloat, 2, sizeof(Real)) * uvs.size() / 2);
+    AttributeFormats::pack(AttributeFormat::HalfFloat, uvs.data(), 2, (UInt32)uvs.size() / 2, packed.data());
+
+    Real maxError = 0.0f;
+    for (UInt32 i = 0; i + 1 < uvs.size(); i++) {
+        UInt16 half;
+        memcpy(&half, packed.data() + i * 2, sizeof(UInt16));
+        maxError = std::fmax(maxError, std::fabs(AttributeFormats::halfToFloat(half) - uvs[i]));
+    }
+    CORE_CHECK(maxError <= 1.0f / 2048.0f);
+}
+
+static void testSNorm10PacksUnitVectors() {
+    std::vector<Real> normals;
+    for (UInt32 i = 0; i < 500; i++) {
+        Real theta = (Real)i * 0.37f;
+        Real z = std::cos((Real)i * 0.11f);
+        Real r = std::sqrt(1.0f - z * z);
+        normals.insert(normals.end(), {r * std::cos(theta), r * std::sin(theta), z});
+    }
+    UInt32 count = (UInt32)normals.size() / 3;
+    std::vector<UInt32> packed(count);
+    AttributeFormats::pack(AttributeFormat::SNorm10_10_10_2, normals.data(), 3, count, reinterpret_cast<Byte*>(packed.data()));
+
+    Real maxError = 0.0f;
+    UInt32 wrongW = 0;
+    for (UInt32 a = 0; a < count; a++) {
+        for (UInt32 c = 0; c < 3; c++) {
+            maxError = std::fmax(maxError, std::fabs(decodeSNorm10(packed[a] >> (c * 10)) - normals[a * 3 + c]));
+        }
+        // three component vectors get w = 1, as GL supplies for float data
+        if ((packed[a] >> 30) != 1) wrongW++;
+    }
+    CORE_CHECK(maxError <= 0.5f / 511.0f + 0.000001f);
+    CORE_CHECK_EQUAL(wrongW, 0u);
+
+    // tangents carry their handedness in w
+    std::vector<Real> tangents = {1.0f, 0.0f, 0.0f, -1.0f, 0.0f, 1.0f, 0.0f, 1.0f};
+    AttributeFormats::pack(AttributeFormat::SNorm10_10_10_2, tangents.data(), 4, 2, reinterpret_cast<Byte*>(packed.data()));
+    CORE_CHECK_EQUAL(packed[0] >> 30, 3u);
+    CORE_CHECK_EQUAL(packed[1] >> 30, 1u);
+    CORE_CHECK_NEAR(decodeSNorm10(packed[0]), 1.0f, 0.000001f);
+    CORE_CHECK_NEAR(decodeSNorm10(packed[1] >> 10), 1.0f, 0.000001f);
+}
+
+static void testUNorm8ClampsColors() {
+    std::vector<Real> colors = {0.0f, 1.0f, 0.5f, 2.0f, -1.0f, 0.2f, 1.0f / 255.0f, std::numeric_limits<Real>::quiet_NaN()};
+    Byte packed[8];
+    AttributeFormats::pack(AttributeFormat::UNorm8, colors.data(), 4, 2, packed);
+    const Byte expected[8] = {0, 255, 128, 255, 0, 51, 1, 0};
+    CORE_CHECK(memcmp(packed, expected, sizeof(packed)) == 0);
+}
+
+static void testUNorm8WeightsAddUpToOne() {
+    std::vector<Real> weights;
+    UInt32 seed = 777;
+    for (UInt32 a = 0; a < 1000; a++) {
+        Real w[4];
+        Real sum = 0.0f;
+        for (UInt32 c = 0; c < 4; c++) {
+            seed = seed * 1664525u + 1013904223u;
+            w[c] = (Real)(seed >> 8) / (Real)(1 << 24);
+            sum += w[c];
+        }
+        for (UInt32 c = 0; c < 4; c++) weights.push_back(w[c] / sum);
+    }
+    weights.insert(weights.end(), {1.0f / 3.0f, 1.0f / 3.0f, 1.0f / 3.0f, 0.0f});
+    weights.insert(weights.end(), {0.0f, 0.0f, 0.0f, 0.0f});
+    UInt32 count = (UInt32)weights.size() / 4;
+    std::vector<Byte> packed(count * 4);
+    AttributeFormats::pack(AttributeFormat::UNorm8Weights, weights.data(), 4, count, packed.data());
+
+    UInt32 wrongSums = 0;
+    Real maxError = 0.0f;
+    for (UInt32 a = 0; a + 1 < count; a++) {
+        UInt32 sum = 0;
+        for (UInt32 c = 0; c < 4; c++) {
+            sum += packed[a * 4 + c];
+            maxError = std::fmax(maxError, std::fabs((Real)packed[a * 4 + c] / 255.0f - weights[a * 4 + c]));
+        }
+        if (sum != 255) wrongSums++;
+    }
+    CORE_CHECK_EQUAL(wrongSums, 0u);
+    // the largest weight absorbs at most a couple of rounding steps
+    CORE_CHECK(maxError <= 2.5f / 255.0f);
+    // an unweighted vertex stays unweighted
+    for (UInt32 c = 0; c < 4; c++) CORE_CHECK_EQUAL(packed[(count - 1) * 4 + c], (Byte)0);
+}
+
+static void testIntegerFormatsClampBoneIndices() {
+    std::vector<Int32> indices = {0, 3, 255, 256, -1, 70000, 65535, 12};
+    Byte bytes[8];
+    AttributeFormats::pack(AttributeFormat::UInt8, indices.data(), 4, 2, bytes);
+    const Byte expectedBytes[8] = {0, 3, 255, 255, 0, 255, 255, 12};
+    CORE_CHECK(memcmp(bytes, expectedBytes, sizeof(bytes)) == 0);
+
+    UInt16 shorts[8];
+    AttributeFormats::pack(AttributeFormat::UInt16, indices.data(), 4, 2, reinterpret_cast<Byte*>(shorts));
+    const UInt16 expectedShorts[8] = {0, 3, 255, 256, 0, 65535, 65535, 12};
+    CORE_CHECK(memcmp(shorts, expectedShorts, sizeof(shorts)) == 0);
+}
+
+static void testFormatLayouts() {
+    CORE_CHECK(AttributeFormats::isSupported(AttributeFormat::HalfFloat, 2, true));
+    CORE_CHECK(!AttributeFormats::isSupported(AttributeFormat::HalfFloat, 3, true));
+    CORE_CHECK(!AttributeFormats::isSupported(AttributeFormat::UNorm8, 4, false));
+    CORE_CHECK(AttributeFormats::isSupported(AttributeFormat::SNorm10_10_10_2, 3, true));
+    CORE_CHECK(!AttributeFormats::isSupported(AttributeFormat::SNorm10_10_10_2, 2, true));
+    CORE_CHECK(!AttributeFormats::isSupported(AttributeFormat::UInt8, 4, true));
+    CORE_CHECK(AttributeFormats::isSupported(AttributeFormat::UInt16, 4, false));
+
+    CORE_CHECK_EQUAL(AttributeFormats::getAttributeSize(AttributeFormat::SNorm10_10_10_2, 3, 4), 4u);
+    CORE_CHECK_EQUAL(AttributeFormats::getComponentCount(AttributeFormat::SNorm10_10_10_2, 3), 4u);
+    CORE_CHECK_EQUAL(AttributeFormats::getAttributeSize(AttributeFormat::HalfFloat, 2, 4), 4u);
+    CORE_CHECK_EQUAL(AttributeFormats::getAttributeSize(AttributeFormat::UNorm8, 4, 4), 4u);
+    CORE_CHECK_EQUAL(AttributeFormats::getAttributeSize(AttributeFormat::UInt16, 4, 4), 8u);
+    CORE_CHECK_EQUAL(AttributeFormats::getAttributeSize(AttributeFormat::Native, 3, 4), 12u);
+    CORE_CHECK(AttributeFormats::isNormalized(AttributeFormat::SNorm10_10_10_2, false));
+    CORE_CHECK(!AttributeFormats::isNormalized(AttributeFormat::UInt8, true));
+    CORE_CHECK(AttributeFormats::getAttributeType(AttributeFormat::UInt16, AttributeType::Int) == AttributeType::UnsignedShort);
+
+    std::vector<Real> uvs = {0.0f, 0.0f, 0.0f};
+    Byte packed[8];
+    CORE_CHECK_THROWS(AttributeFormats::pack(AttributeFormat::HalfFloat, uvs.data(), 3, 1, packed));
+}
+
+int main(int argc, char** argv) {
+    Test::run("half floats round trip and round to nearest even", testHalfFloatRoundTrip);
+    Test::run("half float texture coordinates stay within half precision", testHalfFloatTextureCoordinates);
+    Test::run("10:10:10:2 packs unit vectors within one step", testSNorm10PacksUnitVectors);
+    Test::run("8-bit normalized colors are clamped", testUNorm8ClampsColors);
+    Test::run("8-bit bone weights add up to one", testUNorm8WeightsAddUpToOne);
+    Test::run("integer formats clamp bone indices", testIntegerFormatsClampBoneIndices);
+    Test::run("format sizes, types and support", testFormatLayouts);
+    return Test::result();
+}
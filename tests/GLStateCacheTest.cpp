@@ -0,0 +1,399 @@
+#include <map>
+
+#include "TestUtil.h"
+#include "../GL/GLStateCache.h"
+
+using namespace Core;
+
+// A stand-in for the driver: it keeps the state that the cache's calls set, answers the validation queries
+// from it, and counts the calls that reach it. Tests can change the state behind the cache's back.
+class MockGL {
+public:
+    static void reset() {
+        calls = 0;
+        enabled.clear();
+        integers.clear();
+        floats.clear();
+        activeUnit = 0;
+        textures.clear();
+        integers[GL_ACTIVE_TEXTURE] = GL_TEXTURE0;
+    }
+
+    static void enable(GLenum capability) { calls++; enabled[capability] = GL_TRUE; }
+    static void disable(GLenum capability) { calls++; enabled[capability] = GL_FALSE; }
+    static void blendEquation(GLenum equation) { calls++; integers[GL_BLEND_EQUATION_RGB] = (GLint)equation; }
+    static void blendFuncSeparate(GLenum source, GLenum dest, GLenum sourceAlpha, GLenum destAlpha) {
+        calls++;
+        integers[GL_BLEND_SRC_RGB] = (GLint)source;
+        integers[GL_BLEND_DST_RGB] = (GLint)dest;
+        integers[GL_BLEND_SRC_ALPHA] = (GLint)sourceAlpha;
+        integers[GL_BLEND_DST_ALPHA] = (GLint)destAlpha;
+    }
+    static void depthFunc(GLenum function) { calls++; integers[GL_DEPTH_FUNC] = (GLint)function; }
+    static void depthMask(GLboolean enabled) { calls++; MockGL::enabled[GL_DEPTH_WRITEMASK] = enabled; }
+    static void colorMask(GLboolean red, GLboolean green, GLboolean blue, GLboolean alpha) {
+        calls++;
+        colorWriteMask[0] = red;
+        colorWriteMask[1] = green;
+        colorWriteMask[2] = blue;
+        colorWriteMask[3] = alpha;
+    }
+    static void cullFace(GLenum face) { calls++; integers[GL_CULL_FACE_MODE] = (GLint)face; }
+    static void frontFace(GLenum face) { calls++; integers[GL_FRONT_FACE] = (GLint)face; }
+    static void stencilFunc(GLenum function, GLint reference, GLuint mask) {
+        calls++;
+        integers[GL_STENCIL_FUNC] = (GLint)function;
+        integers[GL_STENCIL_REF] = reference;
+        integers[GL_STENCIL_VALUE_MASK] = (GLint)mask;
+    }
+    static void stencilOp(GLenum sFail, GLenum dpFail, GLenum dpPass) {
+        calls++;
+        integers[GL_STENCIL_FAIL] = (GLint)sFail;
+        integers[GL_STENCIL_PASS_DEPTH_FAIL] = (GLint)dpFail;
+        integers[GL_STENCIL_PASS_DEPTH_PASS] = (GLint)dpPass;
+    }
+    static void stencilMask(GLuint mask) { calls++; integers[GL_STENCIL_WRITEMASK] = (GLint)mask; }
+    static void lineWidth(GLfloat width) { calls++; floats[GL_LINE_WIDTH] = width; }
+    static void polygonMode(GLenum face, GLenum mode) {
+        calls++;
+        if (face == GL_FRONT || face == GL_FRONT_AND_BACK) polygonModes[0] = (GLint)mode;
+        if (face == GL_BACK || face == GL_FRONT_AND_BACK) polygonModes[1] = (GLint)mode;
+    }
+    static void viewport(GLint x, GLint y, GLsizei width, GLsizei height) {
+        calls++;
+        viewportValues[0] = x;
+        viewportValues[1] = y;
+        viewportValues[2] = (GLint)width;
+        viewportValues[3] = (GLint)height;
+    }
+    static void clearColor(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha) {
+        calls++;
+        clearColorValues[0] = red;
+        clearColorValues[1] = green;
+        clearColorValues[2] = blue;
+        clearColorValues[3] = alpha;
+    }
+    static void useProgram(GLuint program) { calls++; integers[GL_CURRENT_PROGRAM] = (GLint)program; }
+    static void activeTexture(GLenum unit) {
+        calls++;
+        activeUnit = unit - GL_TEXTURE0;
+        integers[GL_ACTIVE_TEXTURE] = (GLint)unit;
+    }
+    static void bindTexture(GLenum target, GLuint texture) { calls++; textures[getTextureKey(activeUnit, target)] = texture; }
+    static void bindBuffer(GLenum target, GLuint buffer) { calls++; integers[getBufferBinding(target)] = (GLint)buffer; }
+    static void bindFramebuffer(GLenum target, GLuint framebuffer) {
+        calls++;
+        if (target == GL_FRAMEBUFFER || target == GL_DRAW_FRAMEBUFFER) integers[GL_DRAW_FRAMEBUFFER_BINDING] = (GLint)framebuffer;
+        if (target == GL_FRAMEBUFFER || target == GL_READ_FRAMEBUFFER) integers[GL_READ_FRAMEBUFFER_BINDING] = (GLint)framebuffer;
+    }
+
+    static void getIntegerv(GLenum name, GLint* values) {
+        switch (name) {
+            case GL_VIEWPORT:
+                for (UInt32 i = 0; i < 4; i++) values[i] = viewportValues[i];
+                return;
+            case GL_POLYGON_MODE:
+                values[0] = polygonModes[0];
+                values[1] = polygonModes[1];
+                return;
+            case GL_TEXTURE_BINDING_2D:
+                values[0] = (GLint)textures[getTextureKey(activeUnit, GL_TEXTURE_2D)];
+                return;
+            case GL_TEXTURE_BINDING_CUBE_MAP:
+                values[0] = (GLint)textures[getTextureKey(activeUnit, GL_TEXTURE_CUBE_MAP)];
+                return;
+            case GL_TEXTURE_BINDING_BUFFER:
+                values[0] = (GLint)textures[getTextureKey(activeUnit, GL_TEXTURE_BUFFER)];
+                return;
+            default:
+                break;
+        }
+        values[0] = integers[name];
+    }
+    static void getBooleanv(GLenum name, GLboolean* values) {
+        if (name == GL_COLOR_WRITEMASK) {
+            for (UInt32 i = 0; i < 4; i++) values[i] = colorWriteMask[i];
+            return;
+        }
+        values[0] = enabled[name];
+    }
+    static void getFloatv(GLenum name, GLfloat* values) {
+        if (name == GL_COLOR_CLEAR_VALUE) {
+            for (UInt32 i = 0; i < 4; i++) values[i] = clearColorValues[i];
+            return;
+        }
+        values[0] = floats[name];
+    }
+
+    static GLStateFunctions getFunctions() {
+        GLStateFunctions functions;
+        functions.enable = enable;
+        functions.disable = disable;
+        functions.blendEquation = blendEquation;
+        functions.blendFuncSeparate = blendFuncSeparate;
+        functions.depthFunc = depthFunc;
+        functions.depthMask = depthMask;
+        functions.colorMask = colorMask;
+        functions.cullFace = cullFace;
+        functions.frontFace = frontFace;
+        functions.stencilFunc = stencilFunc;
+        functions.stencilOp = stencilOp;
+        functions.stencilMask = stencilMask;
+        functions.lineWidth = lineWidth;
+        functions.polygonMode = polygonMode;
+        functions.viewport = viewport;
+        functions.clearColor = clearColor;
+        functions.useProgram = useProgram;
+        functions.activeTexture = activeTexture;
+        functions.bindTexture = bindTexture;
+        functions.bindBuffer = bindBuffer;
+        functions.bindFramebuffer = bindFramebuffer;
+        functions.getIntegerv = getIntegerv;
+        functions.getBooleanv = getBooleanv;
+        functions.getFloatv = getFloatv;
+        return functions;
+    }
+
+    static UInt64 getTextureKey(UInt32 unit, GLenum target) {
+        return ((UInt64)unit << 32) | target;
+    }
+
+    static GLenum getBufferBinding(GLenum target) {
+        switch (target) {
+            case GL_ARRAY_BUFFER:
+                return GL_ARRAY_BUFFER_BINDING;
+            case GL_ELEMENT_ARRAY_BUFFER:
+                return GL_ELEMENT_ARRAY_BUFFER_BINDING;
+            default:
+                break;
+        }
+        return target;
+    }
+
+    static UInt32 calls;
+    static std::map<GLenum, GLboolean> enabled;
+    static std::map<GLenum, GLint> integers;
+    static std::map<GLenum, GLfloat> floats;
+    static GLboolean colorWriteMask[4];
+    static GLint polygonModes[2];
+    static GLint viewportValues[4];
+    static GLfloat clearColorValues[4];
+    static UInt32 activeUnit;
+    static std::map<UInt64, GLuint> textures;
+};
+
+UInt32 MockGL::calls = 0;
+std::map<GLenum, GLboolean> MockGL::enabled;
+std::map<GLenum, GLint> MockGL::integers;
+std::map<GLenum, GLfloat> MockGL::floats;
+GLboolean MockGL::colorWriteMask[4];
+GLint MockGL::polygonModes[2];
+GLint MockGL::viewportValues[4];
+GLfloat MockGL::clearColorValues[4];
+UInt32 MockGL::activeUnit = 0;
+std::map<UInt64, GLuint> MockGL::textures;
+
+static void createCache(GLStateCache& cache) {
+    MockGL::reset();
+    cache.setFunctions(MockGL::getFunctions());
+}
+
+static void testRedundantCallsAreFiltered() {
+    GLStateCache cache;
+    createCache(cache);
+
+    // the first call of each setter reaches GL, since nothing is known about the state yet
+    cache.setCapability(GL_BLEND, true);
+    cache.setBlendFunction(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+    cache.setDepthMask(false);
+    cache.setViewport(0, 0, 640, 480);
+    cache.useProgram(7);
+    CORE_CHECK_EQUAL(MockGL::calls, 5u);
+    CORE_CHECK_EQUAL(cache.getFrameCounters().issued, 5u);
+
+    cache.setCapability(GL_BLEND, true);
+    cache.setBlendFunction(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+    cache.setDepthMask(false);
+    cache.setViewport(0, 0, 640, 480);
+    cache.useProgram(7);
+    CORE_CHECK_EQUAL(MockGL::calls, 5u);
+    CORE_CHECK_EQUAL(cache.getFrameCounters().filtered, 5u);
+
+    // a change in any one component goes through
+    cache.setBlendFunction(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ZERO, GL_ONE_MINUS_SRC_ALPHA);
+    cache.setViewport(0, 0, 640, 481);
+    cache.setCapability(GL_BLEND, false);
+    CORE_CHECK_EQUAL(MockGL::calls, 8u);
+    CORE_CHECK_EQUAL(MockGL::enabled[GL_BLEND], (GLboolean)GL_FALSE);
+
+    // capabilities the cache doesn't shadow always reach GL
+    cache.setCapability(GL_SCISSOR_TEST, true);
+    cache.setCapability(GL_SCISSOR_TEST, true);
+    CORE_CHECK_EQUAL(MockGL::calls, 10u);
+
+    cache.beginFrame();
+    CORE_CHECK_EQUAL(cache.getLastFrameCounters().issued, 10u);
+    CORE_CHECK_EQUAL(cache.getLastFrameCounters().filtered, 5u);
+    CORE_CHECK_EQUAL(cache.getFrameCounters().issued + cache.getFrameCounters().filtered, 0u);
+}
+
+static void testInvalidateForgetsTheState() {
+    GLStateCache cache;
+    createCache(cache);
+    cache.setDepthFunction(GL_LEQUAL);
+    cache.bindBuffer(GL_ARRAY_BUFFER, 3);
+    cache.invalidate();
+    cache.setDepthFunction(GL_LEQUAL);
+    cache.bindBuffer(GL_ARRAY_BUFFER, 3);
+    CORE_CHECK_EQUAL(MockGL::calls, 4u);
+
+    // installing a new function table invalidates as well
+    cache.setFunctions(MockGL::getFunctions());
+    cache.setDepthFunction(GL_LEQUAL);
+    CORE_CHECK_EQUAL(MockGL::calls, 5u);
+}
+
+static void testTextureBindingsArePerUnit() {
+    GLStateCache cache;
+    createCache(cache);
+    cache.bindTexture(0, GL_TEXTURE_2D, 10);
+    cache.bindTexture(1, GL_TEXTURE_2D, 11);
+    cache.bindTexture(1, GL_TEXTURE_CUBE_MAP, 12);
+    CORE_CHECK_EQUAL(MockGL::textures[MockGL::getTextureKey(0, GL_TEXTURE_2D)], 10u);
+    CORE_CHECK_EQUAL(MockGL::textures[MockGL::getTextureKey(1, GL_TEXTURE_2D)], 11u);
+    CORE_CHECK_EQUAL(MockGL::textures[MockGL::getTextureKey(1, GL_TEXTURE_CUBE_MAP)], 12u);
+
+    // rebinding what's already bound doesn't even switch the active unit
+    UInt32 calls = MockGL::calls;
+    cache.bindTexture(0, GL_TEXTURE_2D, 10);
+    cache.bindTexture(1, GL_TEXTURE_CUBE_MAP, 12);
+    CORE_CHECK_EQUAL(MockGL::calls, calls);
+    CORE_CHECK_EQUAL(MockGL::activeUnit, 1u);
+
+    // a binding on another unit switches the unit once
+    cache.bindTexture(0, GL_TEXTURE_2D, 13);
+    CORE_CHECK_EQUAL(MockGL::calls, calls + 2);
+    CORE_CHECK_EQUAL(MockGL::activeUnit, 0u);
+
+    // with the active unit unknown, bindings to it can't be attributed to a unit and aren't filtered
+    cache.invalidate();
+    calls = MockGL::calls;
+    cache.bindTexture(GL_TEXTURE_2D, 13);
+    cache.bindTexture(GL_TEXTURE_2D, 13);
+    CORE_CHECK_EQUAL(MockGL::calls, calls + 2);
+}
+
+static void testDeletedObjectsAreUnbound() {
+    GLStateCache cache;
+    createCache(cache);
+    cache.bindTexture(2, GL_TEXTURE_2D, 20);
+    cache.bindBuffer(GL_ARRAY_BUFFER, 21);
+    cache.bindFramebuffer(GL_FRAMEBUFFER, 22);
+
+    // GL reverts the bindings of deleted objects to zero and may reuse their names
+    cache.textureDeleted(20);
+    cache.bufferDeleted(21);
+    cache.framebufferDeleted(22);
+    MockGL::textures[MockGL::getTextureKey(2, GL_TEXTURE_2D)] = 0;
+    MockGL::integers[GL_ARRAY_BUFFER_BINDING] = 0;
+    MockGL::integers[GL_DRAW_FRAMEBUFFER_BINDING] = 0;
+    MockGL::integers[GL_READ_FRAMEBUFFER_BINDING] = 0;
+
+    // so binding zero is redundant, and binding a new object with a reused name is not
+    UInt32 calls = MockGL::calls;
+    cache.bindTexture(2, GL_TEXTURE_2D, 0);
+    cache.bindBuffer(GL_ARRAY_BUFFER, 0);
+    cache.bindFramebuffer(GL_FRAMEBUFFER, 0);
+    CORE_CHECK_EQUAL(MockGL::calls, calls);
+    cache.bindTexture(2, GL_TEXTURE_2D, 20);
+    cache.bindBuffer(GL_ARRAY_BUFFER, 21);
+    cache.bindFramebuffer(GL_FRAMEBUFFER, 22);
+    CORE_CHECK_EQUAL(MockGL::calls, calls + 3);
+    CORE_CHECK(cache.validate());
+}
+
+static void testFramebufferTargets() {
+    GLStateCache cache;
+    createCache(cache);
+    cache.bindFramebuffer(GL_FRAMEBUFFER, 5);
+    cache.bindFramebuffer(GL_DRAW_FRAMEBUFFER, 5);
+    cache.bindFramebuffer(GL_READ_FRAMEBUFFER, 5);
+    CORE_CHECK_EQUAL(MockGL::calls, 1u);
+
+    // GL_FRAMEBUFFER is only redundant when both the draw and the read binding match
+    cache.bindFramebuffer(GL_READ_FRAMEBUFFER, 6);
+    cache.bindFramebuffer(GL_FRAMEBUFFER, 5);
+    CORE_CHECK_EQUAL(MockGL::calls, 3u);
+    CORE_CHECK_EQUAL(MockGL::integers[GL_READ_FRAMEBUFFER_BINDING], 5);
+}
+
+static void testPolygonModeFaces() {
+    GLStateCache cache;
+    createCache(cache);
+    // a single face can't make the pair known
+    cache.setPolygonMode(GL_FRONT, GL_LINE);
+    cache.setPolygonMode(GL_FRONT, GL_LINE);
+    CORE_CHECK_EQUAL(MockGL::calls, 2u);
+
+    cache.setPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+    cache.setPolygonMode(GL_FRONT, GL_LINE);
+    cache.setPolygonMode(GL_FRONT, GL_LINE);
+    cache.setPolygonMode(GL_BACK, GL_FILL);
+    CORE_CHECK_EQUAL(MockGL::calls, 4u);
+    cache.setPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
+    CORE_CHECK_EQUAL(MockGL::calls, 5u);
+    CORE_CHECK(cache.validate());
+}
+
+static void testValidationCatchesOutsideChanges() {
+    GLStateCache cache;
+    createCache(cache);
+    cache.setCapability(GL_DEPTH_TEST, true);
+    cache.setStencilFunction(GL_EQUAL, 1, 0xFF);
+    cache.setColorMask(true, true, true, false);
+    cache.setClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+    cache.setLineWidth(2.0f);
+    CORE_CHECK(cache.validate());
+    CORE_CHECK_EQUAL(cache.getValidationFailureCount(), 0u);
+
+    // another user of the context changes some of the state
+    MockGL::enabled[GL_DEPTH_TEST] = GL_FALSE;
+    MockGL::integers[GL_STENCIL_REF] = 2;
+    MockGL::colorWriteMask[3] = GL_TRUE;
+    CORE_CHECK(!cache.validate());
+    CORE_CHECK_EQUAL(cache.getValidationFailureCount(), 3u);
+
+    // the mismatched state is invalidated, so setting it again repairs it
+    UInt32 calls = MockGL::calls;
+    cache.setCapability(GL_DEPTH_TEST, true);
+    cache.setStencilFunction(GL_EQUAL, 1, 0xFF);
+    cache.setColorMask(true, true, true, false);
+    cache.setClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+    cache.setLineWidth(2.0f);
+    CORE_CHECK_EQUAL(MockGL::calls, calls + 3);
+    CORE_CHECK(cache.validate());
+
+    // in validation mode a filtered call checks its state and lets the next call through on a mismatch
+    cache.setValidationEnabled(true);
+    MockGL::floats[GL_LINE_WIDTH] = 1.0f;
+    cache.setLineWidth(2.0f);
+    CORE_CHECK_EQUAL(cache.getValidationFailureCount(), 4u);
+    cache.setLineWidth(2.0f);
+    CORE_CHECK_EQUAL(MockGL::floats[GL_LINE_WIDTH], 2.0f);
+
+    // and every frame starts with a full check
+    MockGL::integers[GL_STENCIL_FUNC] = GL_ALWAYS;
+    cache.beginFrame();
+    CORE_CHECK_EQUAL(cache.getValidationFailureCount(), 5u);
+}
+
+int main(int argc, char** argv) {
+    Test::run("redundant calls are filtered", testRedundantCallsAreFiltered);
+    Test::run("invalidate forgets the shadowed state", testInvalidateForgetsTheState);
+    Test::run("texture bindings are shadowed per unit", testTextureBindingsArePerUnit);
+    Test::run("deleted objects are unbound", testDeletedObjectsAreUnbound);
+    Test::run("framebuffer targets are shadowed separately", testFramebufferTargets);
+    Test::run("polygon modes are shadowed per face", testPolygonModeFaces);
+    Test::run("validation catches changes made outside the cache", testValidationCatchesOutsideChanges);
+    return Test::result();
+}
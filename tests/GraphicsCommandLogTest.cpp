@@ -0,0 +1,132 @@
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "TestUtil.h"
+#include "../Null/GraphicsCommandLog.h"
+
+using namespace Core;
+
+static const char* LogFileName = "GraphicsCommandLogTest.gcmd";
+static const char* DamagedFileName = "GraphicsCommandLogTest.damaged.gcmd";
+// magic, version and record count
+static const UInt32 HeaderSize = 12;
+static const UInt32 RecordSize = 20;
+
+static void recordFrame(GraphicsCommandLog& log) {
+    log.record(GraphicsCommandType::BeginFrame, 0);
+    log.recordState(GraphicsStateType::ClearColor, GraphicsCommandLog::getRealBits(0.25f));
+    log.record(GraphicsCommandType::Upload, (UInt8)GraphicsResourceKind::VertexBuffer, 3, 4096);
+    log.record(GraphicsCommandType::DrawInstanced, 0, 6, 4, 100);
+    log.record(GraphicsCommandType::DrawIndexed, 0, 36, 4, 2);
+    log.record(GraphicsCommandType::EndFrame, 0);
+}
+
+static std::vector<Byte> readFile(const char* path) {
+    std::vector<Byte> bytes;
+    FILE* file = fopen(path, "rb");
+    if (!file) return bytes;
+    Int32 c;
+    while ((c = fgetc(file)) != EOF) bytes.push_back((Byte)c);
+    fclose(file);
+    return bytes;
+}
+
+static void writeFile(const char* path, const std::vector<Byte>& bytes) {
+    FILE* file = fopen(path, "wb");
+    if (!file) return;
+    fwrite(bytes.data(), 1, bytes.size(), file);
+    fclose(file);
+}
+
+// Returns true if [log] still holds exactly the one frame recorded by recordFrame().
+static Bool holdsOriginalFrame(const GraphicsCommandLog& log) {
+    return log.getCommandCount() == 6 && log.getCommand(3).type == GraphicsCommandType::DrawInstanced &&
+           log.getCounters().getDrawCallCount() == 2 && log.getCounters().vertexCount == 636;
+}
+
+static void testRoundTrip() {
+    GraphicsCommandLog saved;
+    recordFrame(saved);
+    if (!CORE_CHECK(saved.save(LogFileName))) return;
+
+    GraphicsCommandLog loaded;
+    loaded.record(GraphicsCommandType::Draw, 0, 3, 4);
+    if (!CORE_CHECK(loaded.load(LogFileName))) return;
+    CORE_CHECK(holdsOriginalFrame(loaded));
+    UInt32 differences = 0;
+    for (UInt32 i = 0; i < saved.getCommandCount(); i++) {
+        const GraphicsCommand& a = saved.getCommand(i);
+        const GraphicsCommand& b = loaded.getCommand(i);
+        if (a.type != b.type || a.detail != b.detail || memcmp(a.values, b.values, sizeof(a.values)) != 0) differences++;
+    }
+    CORE_CHECK_EQUAL(differences, 0u);
+
+    // the counters are rebuilt from the loaded commands
+    CORE_CHECK_EQUAL(loaded.getCounters().instanceCount, 101ull);
+    CORE_CHECK_EQUAL(loaded.getCounters().uploadedBytes, 4096ull);
+    CORE_CHECK_EQUAL(GraphicsCommandLog::getReal(loaded.getCommand(1).values[0]), 0.25f);
+}
+
+static void testInvalidRecordLeavesLogUnchanged() {
+    std::vector<Byte> bytes = readFile(LogFileName);
+    if (!CORE_CHECK_EQUAL(bytes.size(), (size_t)(HeaderSize + 6 * RecordSize))) return;
+    GraphicsCommandLog log;
+    recordFrame(log);
+
+    // an unknown command type in the last record rejects the whole file, not just the records after it
+    std::vector<Byte> damaged = bytes;
+    damaged[HeaderSize + 5 * RecordSize] = (Byte)GraphicsCommandType::_Count;
+    writeFile(DamagedFileName, damaged);
+    CORE_CHECK(!log.load(DamagedFileName));
+    CORE_CHECK(holdsOriginalFrame(log));
+    remove(DamagedFileName);
+}
+
+static void testRecordCountIsBoundedByFileSize() {
+    std::vector<Byte> bytes = readFile(LogFileName);
+    if (!CORE_CHECK(bytes.size() > HeaderSize)) return;
+    GraphicsCommandLog log;
+    recordFrame(log);
+
+    // counts that the file can't hold are rejected before anything is read for them
+    const UInt32 counts[] = {7, 0x10000000u, 0xFFFFFFFFu};
+    for (UInt32 count : counts) {
+        std::vector<Byte> damaged = bytes;
+        memcpy(damaged.data() + 8, &count, sizeof(UInt32));
+        writeFile(DamagedFileName, damaged);
+        CORE_CHECK(!log.load(DamagedFileName));
+        CORE_CHECK(holdsOriginalFrame(log));
+    }
+
+    // as are truncated files and files that aren't command logs
+    std::vector<Byte> truncated(bytes.begin(), bytes.end() - 1);
+    writeFile(DamagedFileName, truncated);
+    CORE_CHECK(!log.load(DamagedFileName));
+    std::vector<Byte> headerOnly(bytes.begin(), bytes.begin() + 8);
+    writeFile(DamagedFileName, headerOnly);
+    CORE_CHECK(!log.load(DamagedFileName));
+    std::vector<Byte> wrongMagic = bytes;
+    wrongMagic[0] ^= 0xFF;
+    writeFile(DamagedFileName, wrongMagic);
+    CORE_CHECK(!log.load(DamagedFileName));
+    CORE_CHECK(!log.load("GraphicsCommandLogTest.missing.gcmd"));
+    CORE_CHECK(holdsOriginalFrame(log));
+
+    // a smaller count than the file holds loads just those records
+    UInt32 count = 2;
+    std::vector<Byte> shorter = bytes;
+    memcpy(shorter.data() + 8, &count, sizeof(UInt32));
+    writeFile(DamagedFileName, shorter);
+    CORE_CHECK(log.load(DamagedFileName));
+    CORE_CHECK_EQUAL(log.getCommandCount(), 2u);
+    remove(DamagedFileName);
+}
+
+int main(int argc, char** argv) {
+    Test::run("commands round-trip through a file", testRoundTrip);
+    Test::run("an invalid record leaves the log unchanged", testInvalidRecordLeavesLogUnchanged);
+    Test::run("the record count is bounded by the file size", testRecordCountIsBoundedByFileSize);
+    remove(LogFileName);
+    return Test::result();
+}
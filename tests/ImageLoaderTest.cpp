@@ -0,0 +1,178 @@
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "TestUtil.h"
+#include "../image/ImageLoader.h"
+#include "../image/RawImage.h"
+#include "../math/Math.h"
+
+using namespace Core;
+
+static std::string getFixturePath(const std::string& name) {
+    return std::string(CORE_TEST_FIXTURES_DIR) + "/" + name;
+}
+
+// Reads the top-down RGBA pixels stored next to each fixture. They were written by a separate
+// decoder when the fixture was created, so they don't depend on either of the loaders under test.
+static std::vector<Byte> loadStoredPixels(const std::string& name) {
+    std::vector<Byte> pixels;
+    FILE* file = fopen(getFixturePath(name).c_str(), "rb");
+    if (!file) return pixels;
+    Byte buffer[4096];
+    size_t count = 0;
+    while ((count = fread(buffer, 1, sizeof(buffer), file)) > 0) pixels.insert(pixels.end(), buffer, buffer + count);
+    fclose(file);
+    return pixels;
+}
+
+// The DevIL decode that ImageLoader::loadImageU() used before it copied straight into the destination:
+// an in-place conversion to RGBA, an element-by-element copy, then the per-element gamma curve.
+static std::vector<Byte> loadWithPreviousDevILPath(const std::string& path, Bool reverseOrigin, Bool shouldGammaCompress,
+                                                   UInt32& width, UInt32& height) {
+    ilInit();
+    ilEnable(IL_ORIGIN_SET);
+    ilOriginFunc(reverseOrigin ? IL_ORIGIN_UPPER_LEFT : IL_ORIGIN_LOWER_LEFT);
+    ILuint imageIds[1];
+    ilGenImages(1, imageIds);
+    ilBindImage(imageIds[0]);
+    std::vector<Byte> pixels;
+    if (ilLoadImage(path.c_str()) && ilConvertImage(IL_RGBA, IL_UNSIGNED_BYTE)) {
+        width = ilGetInteger(IL_IMAGE_WIDTH);
+        height = ilGetInteger(IL_IMAGE_HEIGHT);
+        const ILubyte* data = ilGetData();
+        for (UInt32 i = 0; i < width * height * 4; i++) pixels.push_back((Byte)data[i]);
+    }
+    ilDeleteImages(1, imageIds);
+    ilOriginFunc(IL_ORIGIN_LOWER_LEFT);
+
+    if (shouldGammaCompress) {
+        for (UInt32 i = 0; i < pixels.size(); i++) {
+            if ((i + 1) % 4 == 0) continue;
+            Real compressed = Math::pow(((Real)pixels[i]) / 255.0f, 2.22f);
+            pixels[i] = Math::clamp((Byte)(compressed * 255.0f), (Byte)0, (Byte)255);
+        }
+    }
+    return pixels;
+}
+
+// Compares [image] with top-down [reference], allowing each component to differ by [tolerance].
+static Bool rowsMatch(const Byte* image, const std::vector<Byte>& reference, UInt32 width, UInt32 height, Bool flipped, UInt32 tolerance = 0) {
+    UInt32 rowSize = width * 4;
+    if (reference.size() != rowSize * height) return false;
+    for (UInt32 y = 0; y < height; y++) {
+        UInt32 referenceRow = flipped ? height - 1 - y : y;
+        for (UInt32 x = 0; x < rowSize; x++) {
+            Int32 difference = (Int32)image[y * rowSize + x] - (Int32)reference[referenceRow * rowSize + x];
+            if ((UInt32)(difference < 0 ? -difference : difference) > tolerance) return false;
+        }
+    }
+    return true;
+}
+
+static void checkStoredPixels(const std::string& name, const std::string& pixelsName, UInt32 width, UInt32 height, UInt32 tolerance) {
+    std::string path = getFixturePath(name);
+    std::vector<Byte> reference = loadStoredPixels(pixelsName);
+    if (!CORE_CHECK_EQUAL((UInt32)reference.size(), width * height * 4)) return;
+
+    // reverseOrigin selects an upper-left origin, which is the stored row order
+    std::shared_ptr<StandardImage> topDown = ImageLoader::loadImageU(path, true, false);
+    CORE_CHECK_EQUAL(topDown->getWidth(), width);
+    CORE_CHECK_EQUAL(topDown->getHeight(), height);
+    CORE_CHECK(rowsMatch(topDown->getImageData(), reference, width, height, false, tolerance));
+
+    std::shared_ptr<StandardImage> bottomUp = ImageLoader::loadImageU(path, false, false);
+    CORE_CHECK(rowsMatch(bottomUp->getImageData(), reference, width, height, true, tolerance));
+
+    // decoding into a caller-provided buffer gives the same pixels
+    std::vector<Byte> buffer(width * height * 4);
+    UInt32 bufferWidth = 0, bufferHeight = 0;
+    CORE_CHECK(ImageLoader::loadImageU(path, true, false, buffer.data(), (UInt32)buffer.size(), bufferWidth, bufferHeight));
+    CORE_CHECK(rowsMatch(buffer.data(), reference, width, height, false, tolerance));
+
+    // a buffer that is too small is left alone, but the dimensions are still reported
+    std::vector<Byte> smallBuffer(4, 7);
+    bufferWidth = bufferHeight = 0;
+    CORE_CHECK(!ImageLoader::loadImageU(path, true, false, smallBuffer.data(), (UInt32)smallBuffer.size(), bufferWidth, bufferHeight));
+    CORE_CHECK_EQUAL(bufferWidth, width);
+    CORE_CHECK_EQUAL(bufferHeight, height);
+    CORE_CHECK(smallBuffer[0] == 7 && smallBuffer[3] == 7);
+}
+
+static void checkMatchesPreviousDevILPath(const std::string& name) {
+    std::string path = getFixturePath(name);
+    for (UInt32 variant = 0; variant < 4; variant++) {
+        Bool reverseOrigin = (variant & 1) != 0;
+        Bool shouldGammaCompress = (variant & 2) != 0;
+        UInt32 width = 0, height = 0;
+        std::vector<Byte> previous = loadWithPreviousDevILPath(path, reverseOrigin, shouldGammaCompress, width, height);
+        if (!CORE_CHECK(previous.size() > 0)) return;
+
+        std::shared_ptr<StandardImage> image = ImageLoader::loadImageU(path, reverseOrigin, shouldGammaCompress);
+        CORE_CHECK_EQUAL(image->getWidth(), width);
+        CORE_CHECK_EQUAL(image->getHeight(), height);
+        CORE_CHECK(rowsMatch(image->getImageData(), previous, width, height, false));
+    }
+}
+
+static void testLoadImageHDR() {
+    std::string path = getFixturePath("rgbe_3x2.hdr");
+    // RGB values the fixture's RGBE pixels encode exactly, top row first; alpha is always 1
+    const Real expected[6][3] = {{1.0f, 0.5f, 0.25f}, {0.5f, 0.5f, 0.5f}, {3.0f, 0.0f, 1.0f},
+                                 {0.25f, 0.0f, 0.0f}, {0.0f, 0.0f, 0.0f}, {5.0f, 3.0f, 7.96875f}};
+    const UInt32 width = 3, height = 2;
+
+    for (UInt32 variant = 0; variant < 4; variant++) {
+        Bool invertY = (variant & 1) != 0;
+        Bool shouldGammaCompress = (variant & 2) != 0;
+        std::shared_ptr<HDRImage> image = ImageLoader::loadImageHDR(path, invertY, shouldGammaCompress);
+        if (!CORE_CHECK_EQUAL(image->getWidth(), width)) return;
+        CORE_CHECK_EQUAL(image->getHeight(), height);
+        const Real* data = image->getImageData();
+        for (UInt32 y = 0; y < height; y++) {
+            UInt32 expectedRow = invertY ? height - 1 - y : y;
+            for (UInt32 x = 0; x < width; x++) {
+                const Real* pixel = data + (y * width + x) * 4;
+                const Real* expectedPixel = expected[expectedRow * width + x];
+                for (UInt32 c = 0; c < 3; c++) {
+                    Real value = shouldGammaCompress ? Math::pow(expectedPixel[c], 2.22f) : expectedPixel[c];
+                    CORE_CHECK_NEAR(pixel[c], value, 1e-5f);
+                }
+                CORE_CHECK_NEAR(pixel[3], 1.0f, 0.0f);
+            }
+        }
+    }
+
+    std::vector<Real> buffer(width * height * 4, -1.0f);
+    UInt32 bufferWidth = 0, bufferHeight = 0;
+    CORE_CHECK(ImageLoader::loadImageHDR(path, false, false, buffer.data(), (UInt32)buffer.size(), bufferWidth, bufferHeight));
+    CORE_CHECK_NEAR(buffer[8], 3.0f, 0.0f);
+    CORE_CHECK_NEAR(buffer[buffer.size() - 1], 1.0f, 0.0f);
+
+    std::vector<Real> smallBuffer(4, -1.0f);
+    bufferWidth = bufferHeight = 0;
+    CORE_CHECK(!ImageLoader::loadImageHDR(path, false, false, smallBuffer.data(), (UInt32)smallBuffer.size(), bufferWidth, bufferHeight));
+    CORE_CHECK_EQUAL(bufferWidth, width);
+    CORE_CHECK_EQUAL(bufferHeight, height);
+    CORE_CHECK_NEAR(smallBuffer[0], -1.0f, 0.0f);
+}
+
+int main(int argc, char** argv) {
+    Test::run("PNG RGBA decode matches stored pixels", []() { checkStoredPixels("rgba_7x5.png", "rgba_7x5.rgba", 7, 5, 0); });
+    Test::run("PNG RGB decode matches stored pixels", []() { checkStoredPixels("rgb_6x4.png", "rgb_6x4.rgba", 6, 4, 0); });
+    Test::run("PNG grayscale decode matches stored pixels", []() { checkStoredPixels("gray_5x3.png", "gray_5x3.rgba", 5, 3, 0); });
+    // JPEG decoders may round the inverse DCT and chroma upsampling differently
+    Test::run("JPEG decode matches stored pixels", []() { checkStoredPixels("rgb_16x8.jpg", "rgb_16x8.rgba", 16, 8, 2); });
+    Test::run("PNG decode matches the previous DevIL path", []() {
+        checkMatchesPreviousDevILPath("rgba_7x5.png");
+        checkMatchesPreviousDevILPath("rgb_6x4.png");
+        checkMatchesPreviousDevILPath("gray_5x3.png");
+    });
+    Test::run("JPEG decode matches the previous DevIL path", []() { checkMatchesPreviousDevILPath("rgb_16x8.jpg"); });
+    Test::run("HDR decode gives the encoded values", testLoadImageHDR);
+    Test::run("missing file throws", []() {
+        CORE_CHECK_THROWS(ImageLoader::loadImageU(getFixturePath("missing.png"), false, false));
+        CORE_CHECK_THROWS(ImageLoader::loadImageHDR(getFixturePath("missing.hdr"), false, false));
+    });
+    return Test::result();
+}
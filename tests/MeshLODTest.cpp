@@ -0,0 +1,236 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <map>
+#include <vector>
+
+#include "TestUtil.h"
+#include "../Engine.h"
+#include "../animation/VertexBoneMap.h"
+#include "../geometry/GeometryUtils.h"
+#include "../geometry/MeshOptimizer.h"
+#include "../geometry/MeshSimplifier.h"
+#include "../render/MeshContainer.h"
+#include "../render/MeshLODSelector.h"
+
+using namespace Core;
+
+static const Real SphereRadius = 2.0f;
+
+class IndexedSphere {
+public:
+    std::vector<Real> positions;
+    std::vector<UInt32> indices;
+};
+
+// GeometryUtils::buildSphereMesh() geometry, welded by position. Neighbouring quads compute shared corners
+// separately, so positions are matched after rounding rather than bitwise.
+static void buildIndexedSphere(UInt32 subdivisions, IndexedSphere& sphere) {
+    std::vector<Real> sourcePositions;
+    GeometryUtils::buildSpherePositions(SphereRadius, subdivisions, sourcePositions);
+    std::map<std::array<Int64, 3>, UInt32> vertices;
+    for (UInt32 i = 0; i < sourcePositions.size(); i += 4) {
+        std::array<Int64, 3> key;
+        for (UInt32 k = 0; k < 3; k++) key[k] = (Int64)std::llround(sourcePositions[i + k] * 10000.0);
+        auto result = vertices.find(key);
+        if (result == vertices.end()) {
+            UInt32 index = (UInt32)sphere.positions.size() / 3;
+            result = vertices.insert(std::make_pair(key, index)).first;
+            sphere.positions.insert(sphere.positions.end(), sourcePositions.begin() + i, sourcePositions.begin() + i + 3);
+        }
+        sphere.indices.push_back(result->second);
+    }
+}
+
+// Give the triangles on the z >= 0 side their own copies of the vertices on the z = 0 plane, as a UV seam would.
+static void splitSeam(IndexedSphere& sphere) {
+    UInt32 vertexCount = (UInt32)sphere.positions.size() / 3;
+    std::vector<UInt32> seamCopies(vertexCount, MeshOptimizer::InvalidIndex);
+    for (UInt32 i = 0; i < sphere.indices.size(); i += 3) {
+        Real centroidZ = 0.0f;
+        for (UInt32 k = 0; k < 3; k++) centroidZ += sphere.positions[sphere.indices[i + k] * 3 + 2];
+        if (centroidZ < 0.0f) continue;
+        for (UInt32 k = 0; k < 3; k++) {
+            UInt32 vertex = sphere.indices[i + k];
+            if (std::fabs(sphere.positions[vertex * 3 + 2]) > 0.0001f) continue;
+            if (seamCopies[vertex] == MeshOptimizer::InvalidIndex) {
+                seamCopies[vertex] = (UInt32)sphere.positions.size() / 3;
+                for (UInt32 c = 0; c < 3; c++) sphere.positions.push_back(sphere.positions[vertex * 3 + c]);
+            }
+            sphere.indices[i + k] = seamCopies[vertex];
+        }
+    }
+}
+
+// Every edge of a closed surface, compared by position, must be shared by exactly two triangles.
+static Bool isClosedByPosition(const std::vector<Real>& positions, const std::vector<UInt32>& indices) {
+    std::map<std::array<Real, 3>, UInt32> positionIDs;
+    auto getPositionID = [&](UInt32 vertex) -> UInt32 {
+        std::array<Real, 3> key = {positions[vertex * 3], positions[vertex * 3 + 1], positions[vertex * 3 + 2]};
+        return positionIDs.insert(std::make_pair(key, (UInt32)positionIDs.size())).first->second;
+    };
+    std::map<std::pair<UInt32, UInt32>, UInt32> edgeUses;
+    for (UInt32 i = 0; i < indices.size(); i += 3) {
+        for (UInt32 k = 0; k < 3; k++) {
+            UInt32 a = getPositionID(indices[i + k]);
+            UInt32 b = getPositionID(indices[i + (k + 1) % 3]);
+            edgeUses[std::make_pair(std::min(a, b), std::max(a, b))]++;
+        }
+    }
+    for (auto& edge : edgeUses) {
+        if (edge.second != 2) return false;
+    }
+    return true;
+}
+
+static void testSimplifySphere() {
+    IndexedSphere sphere;
+    buildIndexedSphere(32, sphere);
+    UInt32 vertexCount = (UInt32)sphere.positions.size() / 3;
+    UInt32 indexCount = (UInt32)sphere.indices.size();
+    if (!CORE_CHECK(isClosedByPosition(sphere.positions, sphere.indices))) return;
+
+    std::vector<UInt32> simplified(indexCount);
+    Real resultError = -1.0f;
+    const Real targetError = 0.05f;
+    UInt32 simplifiedCount = MeshSimplifier::simplify(simplified.data(), sphere.indices.data(), indexCount, sphere.positions.data(), 3,
+                                                      vertexCount, indexCount / 2, targetError, &resultError);
+    simplified.resize(simplifiedCount);
+
+    CORE_CHECK(simplifiedCount > 0);
+    CORE_CHECK(simplifiedCount % 3 == 0);
+    CORE_CHECK(simplifiedCount <= indexCount / 2);
+    CORE_CHECK(resultError >= 0.0f && resultError <= targetError);
+    CORE_CHECK(isClosedByPosition(sphere.positions, simplified));
+    for (UInt32 i = 0; i < simplified.size(); i += 3) {
+        CORE_CHECK(simplified[i] != simplified[i + 1] && simplified[i + 1] != simplified[i + 2] && simplified[i] != simplified[i + 2]);
+    }
+    // half-edge collapses keep the surviving vertices where they were, on the sphere
+    for (UInt32 index : simplified) {
+        if (!CORE_CHECK(index < vertexCount)) return;
+        const Real* p = &sphere.positions[index * 3];
+        CORE_CHECK_NEAR(std::sqrt(p[0] * p[0] + p[1] * p[1] + p[2] * p[2]), SphereRadius, 0.001f);
+    }
+}
+
+static void testSimplifyKeepsSeamClosed() {
+    IndexedSphere sphere;
+    buildIndexedSphere(32, sphere);
+    UInt32 weldedVertexCount = (UInt32)sphere.positions.size() / 3;
+    splitSeam(sphere);
+    UInt32 vertexCount = (UInt32)sphere.positions.size() / 3;
+    CORE_CHECK(vertexCount > weldedVertexCount);
+    UInt32 indexCount = (UInt32)sphere.indices.size();
+
+    std::vector<UInt32> simplified(indexCount);
+    UInt32 simplifiedCount = MeshSimplifier::simplify(simplified.data(), sphere.indices.data(), indexCount, sphere.positions.data(), 3,
+                                                      vertexCount, indexCount / 4, 0.1f, nullptr);
+    simplified.resize(simplifiedCount);
+
+    CORE_CHECK(simplifiedCount < indexCount);
+    CORE_CHECK(isClosedByPosition(sphere.positions, simplified));
+}
+
+static void testSimplifyRespectsErrorBound() {
+    IndexedSphere sphere;
+    buildIndexedSphere(32, sphere);
+    UInt32 vertexCount = (UInt32)sphere.positions.size() / 3;
+    UInt32 indexCount = (UInt32)sphere.indices.size();
+
+    // no error budget: nothing on a curved surface may collapse
+    std::vector<UInt32> simplified(indexCount);
+    Real resultError = -1.0f;
+    UInt32 simplifiedCount = MeshSimplifier::simplify(simplified.data(), sphere.indices.data(), indexCount, sphere.positions.data(), 3,
+                                                      vertexCount, 3, 0.0f, &resultError);
+    CORE_CHECK_EQUAL(simplifiedCount, indexCount);
+    CORE_CHECK_NEAR(resultError, 0.0f, 0.000001f);
+}
+
+static void testSelectorHysteresis() {
+    MeshLODSelector selector;
+    selector.setSwitchSizes({100.0f, 50.0f});
+    selector.setHysteresis(0.1f);
+    const UInt64 view = 7;
+
+    CORE_CHECK_EQUAL(selector.getLevelCount(), 3u);
+    CORE_CHECK_EQUAL(selector.selectLevel(view, 95.0f, 1), 1u);
+    // growing back past the switch size is not enough, it has to clear it by 10%
+    CORE_CHECK_EQUAL(selector.selectLevel(view, 105.0f, 2), 1u);
+    CORE_CHECK_EQUAL(selector.selectLevel(view, 111.0f, 3), 0u);
+    CORE_CHECK_EQUAL(selector.selectLevel(view, 95.0f, 4), 0u);
+    CORE_CHECK_EQUAL(selector.selectLevel(view, 89.0f, 5), 1u);
+    // a large jump skips levels in one step
+    CORE_CHECK_EQUAL(selector.selectLevel(view, 10.0f, 6), 2u);
+    CORE_CHECK_EQUAL(selector.selectLevel(view, 200.0f, 7), 0u);
+
+    // views keep their own state
+    CORE_CHECK_EQUAL(selector.selectLevel(view + 1, 95.0f, 8), 1u);
+    CORE_CHECK_EQUAL(selector.selectLevel(view, 95.0f, 8), 0u);
+    CORE_CHECK_EQUAL(selector.getTrackedViewCount(), 2u);
+
+    CORE_CHECK_THROWS(selector.setSwitchSizes({50.0f, 100.0f}));
+    CORE_CHECK_THROWS(selector.setHysteresis(1.0f));
+}
+
+static void testSelectorEvictsStaleViews() {
+    MeshLODSelector selector;
+    selector.setSwitchSizes({100.0f});
+    const UInt64 activeView = 1;
+
+    // a new view every frame, as a short-lived camera or a light that keeps being recreated would produce
+    UInt64 frame = 0;
+    for (; frame < MeshLODSelector::StaleViewFrames * 10; frame++) {
+        selector.selectLevel(activeView, 95.0f, frame);
+        selector.selectLevel(1000 + frame, 95.0f, frame);
+        CORE_CHECK(selector.getTrackedViewCount() <= 2 * MeshLODSelector::StaleViewFrames + 2);
+    }
+
+    // the view in use every frame keeps its hysteresis state through evictions
+    CORE_CHECK_EQUAL(selector.selectLevel(activeView, 105.0f, frame), 1u);
+}
+
+static void testReplacedLODChainReleasesBoneMaps() {
+    WeakPointer<Engine> engine = Engine::instance();
+    WeakPointer<Object3D> owner = engine->createObject3D();
+    WeakPointer<MeshContainer> container = engine->createRenderableContainer<MeshContainer, Mesh>(owner);
+    WeakPointer<Mesh> mesh = engine->createMesh(3, 0);
+    container->addRenderable(mesh);
+    WeakPointer<VertexBoneMap> boneMap = engine->createVertexBoneMap(3, 3);
+    container->addVertexBoneMap(mesh->getObjectID(), boneMap);
+
+    std::vector<WeakPointer<Mesh>> lodMeshes;
+    std::vector<WeakPointer<VertexBoneMap>> lodBoneMaps;
+    std::vector<UInt64> lodMeshIDs;
+    for (UInt32 i = 0; i < 2; i++) {
+        lodMeshes.push_back(engine->createMesh(3, 0));
+        lodBoneMaps.push_back(engine->createVertexBoneMap(3, 3));
+        lodMeshIDs.push_back(lodMeshes[i]->getObjectID());
+        container->addVertexBoneMap(lodMeshIDs[i], lodBoneMaps[i]);
+    }
+    container->setLODChain(mesh->getObjectID(), lodMeshes, {100.0f, 50.0f});
+
+    // replacing the chain releases the old LOD meshes together with their bone maps
+    WeakPointer<Mesh> replacement = engine->createMesh(3, 0);
+    container->setLODChain(mesh->getObjectID(), {replacement}, {100.0f});
+    for (UInt32 i = 0; i < 2; i++) {
+        CORE_CHECK(lodMeshes[i].expired());
+        CORE_CHECK(lodBoneMaps[i].expired());
+        CORE_CHECK(!container->hasVertexBoneMap(lodMeshIDs[i]));
+    }
+    // the base mesh keeps its own
+    CORE_CHECK(container->hasVertexBoneMap(mesh->getObjectID()));
+    CORE_CHECK(!boneMap.expired());
+    CORE_CHECK(!replacement.expired());
+}
+
+int main(int argc, char** argv) {
+    Engine::setGraphicsBackend(GraphicsBackend::Null);
+    Engine::instance();
+    Test::run("simplified sphere stays closed, on the surface and within the error", testSimplifySphere);
+    Test::run("simplification keeps an attribute seam closed", testSimplifyKeepsSeamClosed);
+    Test::run("simplification respects a zero error bound", testSimplifyRespectsErrorBound);
+    Test::run("LOD selection applies hysteresis per view", testSelectorHysteresis);
+    Test::run("LOD selection forgets stale views", testSelectorEvictsStaleViews);
+    Test::run("replacing a LOD chain releases its bone maps", testReplacedLODChainReleasesBoneMaps);
+    return Test::result();
+}
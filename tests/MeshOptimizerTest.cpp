@@ -0,0 +1,365 @@
+#include <algorithm>
+#include <array>
+#include <vector>
+
+#include "TestUtil.h"
+#include "../Engine.h"
+#include "../animation/VertexBoneMap.h"
+#include "../geometry/IndexBuffer.h"
+#include "../geometry/Mesh.h"
+#include "../geometry/MeshOptimizer.h"
+#include "../geometry/Vector2.h"
+#include "../geometry/Vector3.h"
+
+using namespace Core;
+
+static const UInt32 CacheSize = 16;
+
+// A [size] x [size] quad grid in the z = 0 plane, triangulated row by row.
+static void buildGrid(UInt32 size, std::vector<Real>& positions, std::vector<UInt32>& indices) {
+    UInt32 rowVertices = size + 1;
+    for (UInt32 y = 0; y < rowVertices; y++) {
+        for (UInt32 x = 0; x < rowVertices; x++) {
+            positions.push_back((Real)x);
+            positions.push_back((Real)y);
+            positions.push_back(0.0f);
+        }
+    }
+    for (UInt32 y = 0; y < size; y++) {
+        for (UInt32 x = 0; x < size; x++) {
+            UInt32 v = y * rowVertices + x;
+            indices.insert(indices.end(), {v, v + 1, v + rowVertices});
+            indices.insert(indices.end(), {v + 1, v + rowVertices + 1, v + rowVertices});
+        }
+    }
+}
+
+// The same grid with its triangles in a scrambled but deterministic order, the worst case for the cache.
+static void scrambleTriangles(std::vector<UInt32>& indices) {
+    UInt32 triangleCount = (UInt32)indices.size() / 3;
+    std::vector<UInt32> scrambled;
+    scrambled.reserve(indices.size());
+    for (UInt32 t = 0; t < triangleCount; t++) {
+        UInt32 source = (UInt32)(((UInt64)t * 7919) % triangleCount);
+        scrambled.insert(scrambled.end(), indices.begin() + source * 3, indices.begin() + source * 3 + 3);
+    }
+    indices.swap(scrambled);
+}
+
+// Triangles as rotation-independent keys (smallest index first, winding kept), sorted.
+static std::vector<std::array<UInt32, 3>> getTriangleSet(const std::vector<UInt32>& indices) {
+    std::vector<std::array<UInt32, 3>> triangles;
+    for (UInt32 i = 0; i < indices.size(); i += 3) {
+        UInt32 a = indices[i], b = indices[i + 1], c = indices[i + 2];
+        if (b < a && b < c) triangles.push_back({b, c, a});
+        else if (c < a && c < b) triangles.push_back({c, a, b});
+        else triangles.push_back({a, b, c});
+    }
+    std::sort(triangles.begin(), triangles.end());
+    return triangles;
+}
+
+// Appends an axis-aligned box of half size [halfSize] centered on the origin, each face split into
+// [cells] x [cells] quads, wound clockwise when seen from outside. Every face is its own entry in [faces],
+// the triangle it starts at.
+static void buildBoxShell(Real halfSize, UInt32 cells, std::vector<Real>& positions, std::vector<UInt32>& indices, std::vector<UInt32>& faces) {
+    for (UInt32 axis = 0; axis < 3; axis++) {
+        for (Int32 sign = -1; sign <= 1; sign += 2) {
+            faces.push_back((UInt32)indices.size() / 3);
+            UInt32 base = (UInt32)positions.size() / 3;
+            UInt32 u = (axis + 1) % 3, v = (axis + 2) % 3;
+            for (UInt32 y = 0; y <= cells; y++) {
+                for (UInt32 x = 0; x <= cells; x++) {
+                    Real position[3];
+                    position[axis] = halfSize * (Real)sign;
+                    position[u] = halfSize * (2.0f * (Real)x / (Real)cells - 1.0f);
+                    position[v] = halfSize * (2.0f * (Real)y / (Real)cells - 1.0f);
+                    positions.insert(positions.end(), position, position + 3);
+                }
+            }
+            for (UInt32 y = 0; y < cells; y++) {
+                for (UInt32 x = 0; x < cells; x++) {
+                    UInt32 a = base + y * (cells + 1) + x;
+                    UInt32 b = a + 1, c = a + cells + 1, d = c + 1;
+                    // (u, v) is counter-clockwise around +axis, so the positive face swaps its winding
+                    if (sign > 0) indices.insert(indices.end(), {a, c, b,  b, c, d});
+                    else indices.insert(indices.end(), {a, b, c,  b, d, c});
+                }
+            }
+        }
+    }
+}
+
+// A grid vertex's attributes, derived from its grid coordinates so that they can be checked after remapping.
+static Vector2r getGridUV(UInt32 vertex, UInt32 rowVertices) {
+    return Vector2r((Real)(vertex % rowVertices) / (Real)rowVertices, (Real)(vertex / rowVertices) / (Real)rowVertices);
+}
+
+static void setGridBoneWeights(VertexBoneMap::VertexMappingDescriptor* desc, UInt32 vertex, UInt32 rowVertices) {
+    Real weight = (Real)(vertex % rowVertices) / (Real)(rowVertices - 1);
+    desc->UniqueVertexIndex = vertex;
+    desc->BoneCount = 2;
+    for (UInt32 b = 0; b < Constants::MaxBonesPerVertex; b++) {
+        desc->BoneIndex[b] = 0;
+        desc->Weight[b] = 0.0f;
+    }
+    desc->BoneIndex[0] = 1;
+    desc->BoneIndex[1] = 3;
+    desc->Weight[0] = weight;
+    desc->Weight[1] = 1.0f - weight;
+    desc->Name[0] = "left";
+    desc->Name[1] = "right";
+}
+
+// A non-indexed mesh of the triangles in [indices], with positions, UVs and colors, and a bone map to match.
+static WeakPointer<Mesh> buildTriangleSoupMesh(const std::vector<Real>& positions, const std::vector<UInt32>& indices, UInt32 rowVertices,
+                                               WeakPointer<VertexBoneMap>& vertexBoneMap) {
+    UInt32 vertexCount = (UInt32)indices.size();
+    WeakPointer<Mesh> mesh = Engine::instance()->createMesh(vertexCount, 0);
+    mesh->init();
+    mesh->enableAttribute(StandardAttribute::Position);
+    mesh->initVertexPositions();
+    mesh->enableAttribute(StandardAttribute::AlbedoUV);
+    mesh->initVertexAlbedoUVs();
+    mesh->enableAttribute(StandardAttribute::Color);
+    mesh->initVertexColors();
+    vertexBoneMap = Engine::instance()->createVertexBoneMap(vertexCount, rowVertices * rowVertices);
+    vertexBoneMap->init();
+
+    std::vector<Real> soupPositions, soupUVs, soupColors;
+    for (UInt32 i = 0; i < vertexCount; i++) {
+        UInt32 source = indices[i];
+        soupPositions.insert(soupPositions.end(), {positions[source * 3], positions[source * 3 + 1], positions[source * 3 + 2], 1.0f});
+        Vector2r uv = getGridUV(source, rowVertices);
+        soupUVs.insert(soupUVs.end(), {uv.x, uv.y});
+        soupColors.insert(soupColors.end(), {1.0f, 0.5f, 0.25f, 1.0f});
+        setGridBoneWeights(vertexBoneMap->getDescriptor(i), source, rowVertices);
+    }
+    mesh->getVertexPositions()->store(soupPositions.data());
+    mesh->getVertexAlbedoUVs()->store(soupUVs.data());
+    mesh->getVertexColors()->store(soupColors.data());
+    return mesh;
+}
+
+// The grid vertex a remapped vertex was copied from, found from its position.
+static UInt32 getGridVertex(const Real* position, UInt32 rowVertices) {
+    return (UInt32)position[1] * rowVertices + (UInt32)position[0];
+}
+
+static Bool gridVertexMatches(WeakPointer<Mesh> mesh, WeakPointer<VertexBoneMap> vertexBoneMap, UInt32 index, UInt32 gridVertex, UInt32 rowVertices) {
+    const Real* uv = mesh->getVertexAlbedoUVs()->getStorage() + index * 2;
+    const Real* color = mesh->getVertexColors()->getStorage() + index * 4;
+    Vector2r expectedUV = getGridUV(gridVertex, rowVertices);
+    VertexBoneMap::VertexMappingDescriptor expected;
+    setGridBoneWeights(&expected, gridVertex, rowVertices);
+    VertexBoneMap::VertexMappingDescriptor* desc = vertexBoneMap->getDescriptor(index);
+    Bool success = CORE_CHECK_NEAR(uv[0], expectedUV.x, 0.0f) && CORE_CHECK_NEAR(uv[1], expectedUV.y, 0.0f);
+    success = CORE_CHECK_NEAR(color[0], 1.0f, 0.0f) && CORE_CHECK_NEAR(color[2], 0.25f, 0.0f) && success;
+    success = CORE_CHECK_EQUAL(desc->UniqueVertexIndex, expected.UniqueVertexIndex) && success;
+    success = CORE_CHECK_EQUAL(desc->BoneCount, expected.BoneCount) && success;
+    for (UInt32 b = 0; b < expected.BoneCount; b++) {
+        success = CORE_CHECK_EQUAL(desc->BoneIndex[b], expected.BoneIndex[b]) && success;
+        success = CORE_CHECK_NEAR(desc->Weight[b], expected.Weight[b], 0.0f) && success;
+        success = CORE_CHECK(desc->Name[b] == expected.Name[b]) && success;
+    }
+    return success;
+}
+
+static void testVertexCacheImprovesACMR() {
+    std::vector<Real> positions;
+    std::vector<UInt32> indices;
+    buildGrid(32, positions, indices);
+    scrambleTriangles(indices);
+    UInt32 vertexCount = (UInt32)positions.size() / 3;
+
+    MeshOptimizer::Statistics before = MeshOptimizer::analyzeVertexCache(indices.data(), (UInt32)indices.size(), vertexCount, CacheSize);
+    std::vector<UInt32> optimized(indices.size());
+    std::vector<UInt32> clusters;
+    MeshOptimizer::optimizeVertexCache(indices.data(), (UInt32)indices.size(), vertexCount, CacheSize, optimized.data(), &clusters);
+    MeshOptimizer::Statistics after = MeshOptimizer::analyzeVertexCache(optimized.data(), (UInt32)optimized.size(), vertexCount, CacheSize);
+
+    CORE_CHECK_EQUAL(after.triangleCount, before.triangleCount);
+    CORE_CHECK(after.getACMR() < before.getACMR());
+    // Tipsify on a regular grid stays well under one miss per triangle
+    CORE_CHECK(after.getACMR() < 1.0f);
+    CORE_CHECK(getTriangleSet(optimized) == getTriangleSet(indices));
+    CORE_CHECK(clusters.size() > 0 && clusters[0] == 0);
+    for (UInt32 i = 1; i < clusters.size(); i++) CORE_CHECK(clusters[i] > clusters[i - 1]);
+}
+
+static void testOverdrawKeepsTriangles() {
+    std::vector<Real> positions;
+    std::vector<UInt32> indices;
+    buildGrid(16, positions, indices);
+    UInt32 vertexCount = (UInt32)positions.size() / 3;
+
+    std::vector<UInt32> optimized(indices.size());
+    std::vector<UInt32> clusters;
+    MeshOptimizer::optimizeVertexCache(indices.data(), (UInt32)indices.size(), vertexCount, CacheSize, optimized.data(), &clusters);
+    Real cacheOptimizedACMR = MeshOptimizer::analyzeVertexCache(optimized.data(), (UInt32)optimized.size(), vertexCount, CacheSize).getACMR();
+    std::vector<UInt32> overdrawOptimized = optimized;
+    MeshOptimizer::optimizeOverdraw(overdrawOptimized.data(), (UInt32)overdrawOptimized.size(), positions.data(), 3,
+                                    vertexCount, clusters, CacheSize, 1.05f);
+    Real overdrawOptimizedACMR = MeshOptimizer::analyzeVertexCache(overdrawOptimized.data(), (UInt32)overdrawOptimized.size(),
+                                                                   vertexCount, CacheSize).getACMR();
+
+    CORE_CHECK(getTriangleSet(overdrawOptimized) == getTriangleSet(indices));
+    // cluster splits may cost a little cache efficiency, but never more than the threshold allows per cluster
+    CORE_CHECK(overdrawOptimizedACMR <= cacheOptimizedACMR * 1.05f + 0.001f);
+}
+
+static void testOverdrawDrawsOuterSurfacesFirst() {
+    // two nested boxes, with the inner one first in the index buffer and every face a cluster of its own
+    std::vector<Real> positions;
+    std::vector<UInt32> innerIndices, outerIndices;
+    std::vector<UInt32> innerFaces, outerFaces;
+    buildBoxShell(1.0f, 3, positions, innerIndices, innerFaces);
+    UInt32 innerVertexCount = (UInt32)positions.size() / 3;
+    buildBoxShell(4.0f, 3, positions, outerIndices, outerFaces);
+    UInt32 vertexCount = (UInt32)positions.size() / 3;
+
+    std::vector<UInt32> indices = innerIndices;
+    indices.insert(indices.end(), outerIndices.begin(), outerIndices.end());
+    std::vector<UInt32> clusters = innerFaces;
+    for (UInt32 face : outerFaces) clusters.push_back((UInt32)innerIndices.size() / 3 + face);
+
+    std::vector<UInt32> optimized = indices;
+    MeshOptimizer::optimizeOverdraw(optimized.data(), (UInt32)optimized.size(), positions.data(), 3, vertexCount, clusters, CacheSize, 1.05f);
+    CORE_CHECK(getTriangleSet(optimized) == getTriangleSet(indices));
+
+    // the outer box hides the inner one from every direction, so all of it has to come first
+    UInt32 outerIndexCount = (UInt32)outerIndices.size();
+    for (UInt32 i = 0; i < optimized.size(); i++) {
+        Bool outer = optimized[i] >= innerVertexCount;
+        if (!CORE_CHECK(outer == (i < outerIndexCount))) break;
+    }
+}
+
+static void testOptimizeMeshKeepsVerticesAndBoneMap() {
+    const UInt32 size = 8;
+    const UInt32 rowVertices = size + 1;
+    std::vector<Real> positions;
+    std::vector<UInt32> indices;
+    buildGrid(size, positions, indices);
+    scrambleTriangles(indices);
+    WeakPointer<VertexBoneMap> vertexBoneMap;
+    WeakPointer<Mesh> mesh = buildTriangleSoupMesh(positions, indices, rowVertices, vertexBoneMap);
+
+    MeshOptimizer::Result result = MeshOptimizer::optimizeMesh(mesh, vertexBoneMap, MeshOptimizer::Settings());
+    if (!CORE_CHECK(result.mesh.isValid() && result.vertexBoneMap.isValid())) return;
+    CORE_CHECK(result.mesh->isIndexed());
+    // the soup welds back down to the grid's vertices
+    if (!CORE_CHECK_EQUAL(result.mesh->getVertexCount(), rowVertices * rowVertices)) return;
+    if (!CORE_CHECK_EQUAL(result.vertexBoneMap->getVertexCount(), result.mesh->getVertexCount())) return;
+    CORE_CHECK_EQUAL(result.vertexBoneMap->getUniqueVertexCount(), rowVertices * rowVertices);
+    if (!CORE_CHECK_EQUAL(result.mesh->getIndexCount(), (UInt32)indices.size())) return;
+    CORE_CHECK(result.after.getACMR() < result.before.getACMR());
+
+    // every vertex carries the attributes and skinning of the grid vertex at its position...
+    std::vector<UInt32> gridVertices(result.mesh->getVertexCount());
+    const Real* resultPositions = result.mesh->getVertexPositions()->getStorage();
+    for (UInt32 v = 0; v < gridVertices.size(); v++) {
+        gridVertices[v] = getGridVertex(resultPositions + v * Point3rs::ComponentCount, rowVertices);
+        if (!gridVertexMatches(result.mesh, result.vertexBoneMap, v, gridVertices[v], rowVertices)) break;
+    }
+    // ...and the index buffer draws the same triangles, with the same winding
+    std::vector<UInt32> resultIndices(result.mesh->getIndexCount());
+    for (UInt32 i = 0; i < resultIndices.size(); i++) resultIndices[i] = gridVertices[result.mesh->getIndexBuffer()->getIndex(i)];
+    CORE_CHECK(getTriangleSet(resultIndices) == getTriangleSet(indices));
+
+    Engine::safeReleaseObject(result.mesh);
+    Engine::safeReleaseObject(result.vertexBoneMap);
+}
+
+static void testRemappedMeshCopiesSourceVertices() {
+    const UInt32 rowVertices = 3;
+    std::vector<Real> positions;
+    std::vector<UInt32> gridIndices;
+    buildGrid(rowVertices - 1, positions, gridIndices);
+    WeakPointer<VertexBoneMap> vertexBoneMap;
+    WeakPointer<Mesh> mesh = buildTriangleSoupMesh(positions, gridIndices, rowVertices, vertexBoneMap);
+
+    // soup vertices 4, 0 and 17 are grid vertices 4, 0 and 7
+    std::vector<UInt32> sourceVertices = {4, 0, 17};
+    std::vector<UInt32> indices = {0, 1, 2,  2, 1, 0};
+    WeakPointer<Mesh> remappedMesh = MeshOptimizer::buildRemappedMesh(mesh, sourceVertices, indices);
+    WeakPointer<VertexBoneMap> remappedBoneMap = MeshOptimizer::buildRemappedVertexBoneMap(vertexBoneMap, sourceVertices);
+    if (!CORE_CHECK_EQUAL(remappedMesh->getVertexCount(), 3u)) return;
+    CORE_CHECK_EQUAL(remappedBoneMap->getVertexCount(), 3u);
+    for (UInt32 v = 0; v < sourceVertices.size(); v++) {
+        const Real* position = remappedMesh->getVertexPositions()->getStorage() + v * Point3rs::ComponentCount;
+        const Real* sourcePosition = mesh->getVertexPositions()->getStorage() + sourceVertices[v] * Point3rs::ComponentCount;
+        for (UInt32 c = 0; c < 3; c++) CORE_CHECK_NEAR(position[c], sourcePosition[c], 0.0f);
+        gridVertexMatches(remappedMesh, remappedBoneMap, v, gridIndices[sourceVertices[v]], rowVertices);
+    }
+    for (UInt32 i = 0; i < indices.size(); i++) CORE_CHECK_EQUAL(remappedMesh->getIndexBuffer()->getIndex(i), indices[i]);
+
+    std::vector<UInt32> outOfRange = {0, mesh->getVertexCount()};
+    CORE_CHECK_THROWS(MeshOptimizer::buildRemappedMesh(mesh, outOfRange, {0, 1, 1}));
+    CORE_CHECK_THROWS(MeshOptimizer::buildRemappedVertexBoneMap(vertexBoneMap, outOfRange));
+
+    Engine::safeReleaseObject(remappedMesh);
+    Engine::safeReleaseObject(remappedBoneMap);
+    Engine::safeReleaseObject(mesh);
+    Engine::safeReleaseObject(vertexBoneMap);
+}
+
+static void testVertexFetchUsesFirstReferenceOrder() {
+    std::vector<UInt32> indices = {5, 2, 7, 2, 5, 0, 7, 0, 3};
+    std::vector<UInt32> original = indices;
+    std::vector<UInt32> remap;
+    UInt32 usedVertices = MeshOptimizer::optimizeVertexFetch(indices.data(), (UInt32)indices.size(), 8, remap);
+
+    CORE_CHECK_EQUAL(usedVertices, 5u);
+    std::vector<UInt32> expected = {0, 1, 2, 1, 0, 3, 2, 3, 4};
+    CORE_CHECK(indices == expected);
+    CORE_CHECK_EQUAL(remap[1], MeshOptimizer::InvalidIndex);
+    CORE_CHECK_EQUAL(remap[4], MeshOptimizer::InvalidIndex);
+    CORE_CHECK_EQUAL(remap[6], MeshOptimizer::InvalidIndex);
+    for (UInt32 i = 0; i < original.size(); i++) CORE_CHECK_EQUAL(remap[original[i]], indices[i]);
+}
+
+static void testVertexRemapWeldsIdenticalVertices() {
+    // vertices 0/3 share both streams, 1/4 share positions only, 2/5 share both
+    std::vector<Real> positions = {0, 0, 0,  1, 0, 0,  0, 1, 0,  0, 0, 0,  1, 0, 0,  0, 1, 0};
+    std::vector<Real> uvs = {0, 0,  1, 0,  0, 1,  0, 0,  0.5f, 0,  0, 1};
+    std::vector<MeshOptimizer::VertexStream> streams(2);
+    streams[0].data = (const Byte*)positions.data();
+    streams[0].stride = 3 * sizeof(Real);
+    streams[1].data = (const Byte*)uvs.data();
+    streams[1].stride = 2 * sizeof(Real);
+
+    std::vector<UInt32> remap;
+    UInt32 uniqueCount = MeshOptimizer::generateVertexRemap(streams, 6, remap);
+    CORE_CHECK_EQUAL(uniqueCount, 4u);
+    std::vector<UInt32> expected = {0, 1, 2, 0, 3, 2};
+    CORE_CHECK(remap == expected);
+
+    streams.resize(1);
+    uniqueCount = MeshOptimizer::generateVertexRemap(streams, 6, remap);
+    CORE_CHECK_EQUAL(uniqueCount, 3u);
+    expected = {0, 1, 2, 0, 1, 2};
+    CORE_CHECK(remap == expected);
+}
+
+static void testInvalidIndicesAreRejected() {
+    std::vector<UInt32> indices = {0, 1, 2, 2, 1};
+    std::vector<UInt32> remap;
+    CORE_CHECK_THROWS(MeshOptimizer::optimizeVertexFetch(indices.data(), (UInt32)indices.size(), 3, remap));
+    indices.push_back(3);
+    CORE_CHECK_THROWS(MeshOptimizer::optimizeVertexFetch(indices.data(), (UInt32)indices.size(), 3, remap));
+}
+
+int main(int argc, char** argv) {
+    Engine::setGraphicsBackend(GraphicsBackend::Null);
+    Engine::instance();
+    Test::run("vertex cache optimization improves ACMR and keeps the triangles", testVertexCacheImprovesACMR);
+    Test::run("overdraw optimization keeps the triangles", testOverdrawKeepsTriangles);
+    Test::run("overdraw optimization draws outer surfaces first", testOverdrawDrawsOuterSurfacesFirst);
+    Test::run("optimizeMesh() keeps vertices, triangles and bone weights", testOptimizeMeshKeepsVerticesAndBoneMap);
+    Test::run("remapped meshes and bone maps copy their source vertices", testRemappedMeshCopiesSourceVertices);
+    Test::run("vertex fetch optimization uses first reference order", testVertexFetchUsesFirstReferenceOrder);
+    Test::run("vertex remap welds identical vertices", testVertexRemapWeldsIdenticalVertices);
+    Test::run("invalid index buffers are rejected", testInvalidIndicesAreRejected);
+    return Test::result();
+}
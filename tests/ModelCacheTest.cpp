@@ -0,0 +1,365 @@
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+#include "TestUtil.h"
+#include "../Engine.h"
+#include "../asset/ModelCache.h"
+#include "../asset/ModelLoader.h"
+#include "../filesys/FileSystem.h"
+#include "../animation/Bone.h"
+#include "../animation/Skeleton.h"
+#include "../animation/VertexBoneMap.h"
+#include "../geometry/IndexBuffer.h"
+#include "../geometry/Mesh.h"
+#include "../material/Material.h"
+#include "../material/StandardAttributes.h"
+#include "../geometry/Vector2.h"
+#include "../geometry/Vector3.h"
+#include "../render/MeshContainer.h"
+#include "../render/MeshRenderer.h"
+#include "../scene/Object3D.h"
+
+using namespace Core;
+
+static const char* CacheFileName = "ModelCacheTest.cmc";
+static const UInt64 CacheKey = 0x1234abcd5678ef01ULL;
+
+class SourceModel {
+public:
+    std::vector<Real> positions;
+    std::vector<Real> uvs;
+    std::vector<UInt32> indices;
+    ModelCache::ModelData data;
+};
+
+static void setIdentity(Real* matrix) {
+    for (UInt32 i = 0; i < 16; i++) matrix[i] = (i % 5 == 0) ? 1.0f : 0.0f;
+}
+
+// One skinned quad with positions and UVs, two nodes, a bone and a skeleton node.
+static void buildSourceModel(SourceModel& model) {
+    const UInt32 vertexCount = 4;
+    for (UInt32 v = 0; v < vertexCount * Point3rs::ComponentCount; v++) model.positions.push_back((Real)v * 0.25f);
+    for (UInt32 v = 0; v < vertexCount * Vector2rs::ComponentCount; v++) model.uvs.push_back((Real)v * 0.125f);
+    model.indices = {0, 1, 2, 2, 1, 3};
+
+    ModelCache::MaterialRecord material;
+    material.characteristics = 0x15;
+    material.albedoMapPath = "textures/albedo.png";
+    material.normalMapPath = "textures/normal.png";
+    model.data.materials.push_back(material);
+
+    ModelCache::MeshRecord mesh;
+    mesh.name = "quad";
+    mesh.vertexCount = vertexCount;
+    mesh.enabledAttributes = 0x3;
+    ModelCache::AttributeRecord positions;
+    positions.attribute = (UInt32)StandardAttribute::Position;
+    positions.byteSize = (UInt32)(model.positions.size() * sizeof(Real));
+    positions.data = (const Byte*)model.positions.data();
+    mesh.attributes.push_back(positions);
+    ModelCache::AttributeRecord uvs;
+    uvs.attribute = (UInt32)StandardAttribute::AlbedoUV;
+    uvs.byteSize = (UInt32)(model.uvs.size() * sizeof(Real));
+    uvs.data = (const Byte*)model.uvs.data();
+    mesh.attributes.push_back(uvs);
+    mesh.indexCount = (UInt32)model.indices.size();
+    mesh.indices = model.indices.data();
+    for (UInt32 v = 0; v < vertexCount; v++) {
+        ModelCache::BoneMapVertexRecord boneVertex = {};
+        boneVertex.uniqueVertexIndex = v;
+        boneVertex.boneCount = 1;
+        boneVertex.weight[0] = 1.0f;
+        mesh.boneMapStorage.push_back(boneVertex);
+    }
+    mesh.boneMapVertexCount = vertexCount;
+    mesh.boneMapUniqueVertexCount = vertexCount;
+    model.data.meshes.push_back(mesh);
+    model.data.meshes[0].boneMapVertices = model.data.meshes[0].boneMapStorage.data();
+
+    ModelCache::NodeRecord root;
+    root.name = "root";
+    root.parentIndex = -1;
+    setIdentity(root.localMatrix);
+    root.meshContainer = false;
+    root.materialIndex = -1;
+    model.data.nodes.push_back(root);
+    ModelCache::NodeRecord container;
+    container.name = "quad_container";
+    container.parentIndex = 0;
+    setIdentity(container.localMatrix);
+    container.localMatrix[12] = 3.0f;
+    container.meshContainer = true;
+    container.materialIndex = 0;
+    container.meshIndices.push_back(0);
+    model.data.nodes.push_back(container);
+
+    ModelCache::BoneRecord bone;
+    bone.name = "bone";
+    setIdentity(bone.offsetMatrix);
+    model.data.bones.push_back(bone);
+    ModelCache::SkeletonNodeRecord skeletonNode;
+    skeletonNode.name = "bone";
+    skeletonNode.boneIndex = 0;
+    skeletonNode.targetNodeIndex = 1;
+    setIdentity(skeletonNode.initialTransform);
+    model.data.skeletonNodes.push_back(skeletonNode);
+}
+
+static Bool bytesEqual(const void* a, const void* b, UInt64 size) {
+    return memcmp(a, b, (size_t)size) == 0;
+}
+
+static std::vector<Byte> readFile(const char* path) {
+    std::vector<Byte> bytes;
+    FILE* file = fopen(path, "rb");
+    if (!file) return bytes;
+    Int32 c;
+    while ((c = fgetc(file)) != EOF) bytes.push_back((Byte)c);
+    fclose(file);
+    return bytes;
+}
+
+static void writeFile(const char* path, const std::vector<Byte>& bytes, UInt64 size) {
+    FILE* file = fopen(path, "wb");
+    if (!file) return;
+    fwrite(bytes.data(), 1, (size_t)size, file);
+    fclose(file);
+}
+
+template <typename T>
+static void checkSameAttribute(WeakPointer<AttributeArray<T>> imported, WeakPointer<AttributeArray<T>> cached) {
+    if (!CORE_CHECK_EQUAL(imported.isValid(), cached.isValid()) || !imported.isValid()) return;
+    if (!CORE_CHECK_EQUAL(imported->getSize(), cached->getSize())) return;
+    CORE_CHECK(bytesEqual(imported->getStorage(), cached->getStorage(), imported->getSize()));
+}
+
+static void checkSameMesh(WeakPointer<Mesh> imported, WeakPointer<Mesh> cached) {
+    CORE_CHECK(imported->getName() == cached->getName());
+    if (!CORE_CHECK_EQUAL(imported->getVertexCount(), cached->getVertexCount())) return;
+    for (UInt32 a = 0; a < (UInt32)StandardAttribute::_Count; a++) {
+        CORE_CHECK_EQUAL(imported->isAttributeEnabled((StandardAttribute)a), cached->isAttributeEnabled((StandardAttribute)a));
+    }
+    checkSameAttribute(imported->getVertexPositions(), cached->getVertexPositions());
+    checkSameAttribute(imported->getVertexColors(), cached->getVertexColors());
+    checkSameAttribute(imported->getVertexAlbedoUVs(), cached->getVertexAlbedoUVs());
+    checkSameAttribute(imported->getVertexNormalUVs(), cached->getVertexNormalUVs());
+    checkSameAttribute(imported->getVertexNormals(), cached->getVertexNormals());
+    checkSameAttribute(imported->getVertexAveragedNormals(), cached->getVertexAveragedNormals());
+    checkSameAttribute(imported->getVertexTangents(), cached->getVertexTangents());
+    checkSameAttribute(imported->getVertexFaceNormals(), cached->getVertexFaceNormals());
+
+    if (!CORE_CHECK_EQUAL(imported->isIndexed(), cached->isIndexed()) || !imported->isIndexed()) return;
+    if (!CORE_CHECK_EQUAL(imported->getIndexCount(), cached->getIndexCount())) return;
+    for (UInt32 i = 0; i < imported->getIndexCount(); i++) {
+        if (!CORE_CHECK_EQUAL(imported->getIndexBuffer()->getIndex(i), cached->getIndexBuffer()->getIndex(i))) return;
+    }
+}
+
+static void checkSameVertexBoneMap(WeakPointer<VertexBoneMap> imported, WeakPointer<VertexBoneMap> cached) {
+    if (!CORE_CHECK_EQUAL(imported->getVertexCount(), cached->getVertexCount())) return;
+    CORE_CHECK_EQUAL(imported->getUniqueVertexCount(), cached->getUniqueVertexCount());
+    for (UInt32 v = 0; v < imported->getVertexCount(); v++) {
+        VertexBoneMap::VertexMappingDescriptor* importedDesc = imported->getDescriptor(v);
+        VertexBoneMap::VertexMappingDescriptor* cachedDesc = cached->getDescriptor(v);
+        CORE_CHECK_EQUAL(importedDesc->UniqueVertexIndex, cachedDesc->UniqueVertexIndex);
+        if (!CORE_CHECK_EQUAL(importedDesc->BoneCount, cachedDesc->BoneCount)) return;
+        for (UInt32 b = 0; b < importedDesc->BoneCount; b++) {
+            CORE_CHECK_EQUAL(importedDesc->BoneIndex[b], cachedDesc->BoneIndex[b]);
+            CORE_CHECK_EQUAL(importedDesc->Weight[b], cachedDesc->Weight[b]);
+            CORE_CHECK(importedDesc->Name[b] == cachedDesc->Name[b]);
+        }
+    }
+}
+
+static void checkSameSkeleton(WeakPointer<Skeleton> imported, WeakPointer<Skeleton> cached) {
+    if (!CORE_CHECK_EQUAL(imported.isValid(), cached.isValid()) || !imported.isValid()) return;
+    if (!CORE_CHECK_EQUAL(imported->getBoneCount(), cached->getBoneCount())) return;
+    CORE_CHECK_EQUAL(imported->getNodeCount(), cached->getNodeCount());
+    for (UInt32 b = 0; b < imported->getBoneCount(); b++) {
+        CORE_CHECK(imported->getBone(b)->Name == cached->getBone(b)->Name);
+        CORE_CHECK(bytesEqual(imported->getBone(b)->OffsetMatrix.getConstData(), cached->getBone(b)->OffsetMatrix.getConstData(), sizeof(Real) * 16));
+    }
+}
+
+// Walks both scene graphs in step; the cache stores processed data as-is, so everything must match exactly.
+static void checkSameObject(WeakPointer<Object3D> imported, WeakPointer<Object3D> cached) {
+    CORE_CHECK(imported->getName() == cached->getName());
+    CORE_CHECK(bytesEqual(imported->getTransform().getConstLocalMatrix().getConstData(),
+                          cached->getTransform().getConstLocalMatrix().getConstData(), sizeof(Real) * 16));
+
+    WeakPointer<MeshContainer> importedContainer = imported->getMeshContainer();
+    WeakPointer<MeshContainer> cachedContainer = cached->getMeshContainer();
+    if (CORE_CHECK_EQUAL(importedContainer.isValid(), cachedContainer.isValid()) && importedContainer.isValid()) {
+        WeakPointer<Material> importedMaterial = imported->getMeshRenderer()->getMaterial();
+        WeakPointer<Material> cachedMaterial = cached->getMeshRenderer()->getMaterial();
+        CORE_CHECK(typeid(*importedMaterial.get()) == typeid(*cachedMaterial.get()));
+        checkSameSkeleton(importedContainer->getSkeleton(), cachedContainer->getSkeleton());
+
+        if (CORE_CHECK_EQUAL(importedContainer->getBaseRenderableCount(), cachedContainer->getBaseRenderableCount())) {
+            for (UInt32 i = 0; i < importedContainer->getBaseRenderableCount(); i++) {
+                WeakPointer<Mesh> importedMesh = importedContainer->getRenderable(i);
+                WeakPointer<Mesh> cachedMesh = cachedContainer->getRenderable(i);
+                checkSameMesh(importedMesh, cachedMesh);
+                Bool hasBoneMap = importedContainer->hasVertexBoneMap(importedMesh->getObjectID());
+                if (CORE_CHECK_EQUAL(hasBoneMap, cachedContainer->hasVertexBoneMap(cachedMesh->getObjectID())) && hasBoneMap) {
+                    checkSameVertexBoneMap(importedContainer->getVertexBoneMap(importedMesh->getObjectID()),
+                                           cachedContainer->getVertexBoneMap(cachedMesh->getObjectID()));
+                }
+            }
+        }
+    }
+
+    if (!CORE_CHECK_EQUAL(imported->childCount(), cached->childCount())) return;
+    for (UInt32 i = 0; i < imported->childCount(); i++) checkSameObject(imported->getChild(i), cached->getChild(i));
+}
+
+static Real getMilliseconds(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<Real, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+static void testCachedModelMatchesImport() {
+    const std::string modelPath = std::string(CORE_TEST_FIXTURES_DIR) + "/skinned_strip.gltf";
+    ModelLoader loader;
+
+    // without a cache directory the model always goes through Assimp
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    WeakPointer<Object3D> imported = loader.loadModel(modelPath, 1.0f, 80, true, true, false, true);
+    Real importTime = getMilliseconds(start);
+
+    // the first load with the cache enabled imports again and writes the entry, the second one reads it
+    loader.setModelCacheDirectory(".");
+    std::string cacheFilePath = loader.getModelCacheFilePath(modelPath, 1.0f, 80, false, true);
+    if (!CORE_CHECK(cacheFilePath.size() > 0)) return;
+    remove(cacheFilePath.c_str());
+    loader.loadModel(modelPath, 1.0f, 80, true, true, false, true);
+    if (!CORE_CHECK(FileSystem::getInstance()->fileExists(cacheFilePath))) return;
+    start = std::chrono::steady_clock::now();
+    WeakPointer<Object3D> cached = loader.loadModel(modelPath, 1.0f, 80, true, true, false, true);
+    Real cacheTime = getMilliseconds(start);
+
+    checkSameObject(imported, cached);
+    printf("  skinned_strip.gltf: Assimp import %.3f ms, cache load %.3f ms\n", importTime, cacheTime);
+    remove(cacheFilePath.c_str());
+}
+
+int main(int argc, char** argv) {
+    Engine::setGraphicsBackend(GraphicsBackend::Null);
+    SourceModel source;
+    buildSourceModel(source);
+
+    Test::run("model round-trips through the cache", [&]() {
+        if (!CORE_CHECK(ModelCache::writeModel(CacheFileName, CacheKey, source.data))) return;
+        ModelCache::ModelData loaded;
+        if (!CORE_CHECK(ModelCache::readModel(CacheFileName, CacheKey, loaded))) return;
+
+        CORE_CHECK_EQUAL(loaded.materials.size(), (size_t)1);
+        CORE_CHECK_EQUAL(loaded.materials[0].characteristics, source.data.materials[0].characteristics);
+        CORE_CHECK(loaded.materials[0].albedoMapPath == "textures/albedo.png");
+        CORE_CHECK(loaded.materials[0].normalMapPath == "textures/normal.png");
+        CORE_CHECK(loaded.materials[0].opacityMapPath.empty());
+
+        if (!CORE_CHECK_EQUAL(loaded.meshes.size(), (size_t)1)) return;
+        const ModelCache::MeshRecord& mesh = loaded.meshes[0];
+        const ModelCache::MeshRecord& sourceMesh = source.data.meshes[0];
+        CORE_CHECK(mesh.name == "quad");
+        CORE_CHECK_EQUAL(mesh.vertexCount, sourceMesh.vertexCount);
+        CORE_CHECK_EQUAL(mesh.enabledAttributes, sourceMesh.enabledAttributes);
+        if (!CORE_CHECK_EQUAL(mesh.attributes.size(), (size_t)2)) return;
+        for (UInt32 a = 0; a < 2; a++) {
+            CORE_CHECK_EQUAL(mesh.attributes[a].attribute, sourceMesh.attributes[a].attribute);
+            CORE_CHECK_EQUAL(mesh.attributes[a].byteSize, sourceMesh.attributes[a].byteSize);
+            CORE_CHECK(bytesEqual(mesh.attributes[a].data, sourceMesh.attributes[a].data, sourceMesh.attributes[a].byteSize));
+            // blocks are mapped straight from the file and must be aligned for direct use
+            CORE_CHECK(((uintptr_t)mesh.attributes[a].data) % 16 == 0);
+        }
+        CORE_CHECK_EQUAL(mesh.indexCount, sourceMesh.indexCount);
+        CORE_CHECK(bytesEqual(mesh.indices, sourceMesh.indices, sourceMesh.indexCount * sizeof(UInt32)));
+        CORE_CHECK_EQUAL(mesh.boneMapVertexCount, 4u);
+        CORE_CHECK_EQUAL(mesh.boneMapUniqueVertexCount, 4u);
+        CORE_CHECK_EQUAL(mesh.boneMapVertices[2].uniqueVertexIndex, 2u);
+        CORE_CHECK_EQUAL(mesh.boneMapVertices[2].weight[0], 1.0f);
+
+        if (!CORE_CHECK_EQUAL(loaded.nodes.size(), (size_t)2)) return;
+        CORE_CHECK(loaded.nodes[1].name == "quad_container");
+        CORE_CHECK_EQUAL(loaded.nodes[1].parentIndex, 0);
+        CORE_CHECK(loaded.nodes[1].meshContainer);
+        CORE_CHECK_EQUAL(loaded.nodes[1].localMatrix[12], 3.0f);
+        CORE_CHECK_EQUAL(loaded.nodes[1].meshIndices.size(), (size_t)1);
+        CORE_CHECK_EQUAL(loaded.bones.size(), (size_t)1);
+        CORE_CHECK_EQUAL(loaded.skeletonNodes.size(), (size_t)1);
+        CORE_CHECK_EQUAL(loaded.skeletonNodes[0].targetNodeIndex, 1);
+
+        CORE_CHECK(ModelLoader::validateCachedModel(loaded));
+    });
+
+    Test::run("entries for another key are not read", [&]() {
+        ModelCache::ModelData loaded;
+        CORE_CHECK(!ModelCache::readModel(CacheFileName, CacheKey + 1, loaded));
+        CORE_CHECK(!ModelCache::readModel("ModelCacheTest.missing.cmc", CacheKey, loaded));
+    });
+
+    Test::run("truncated entries are rejected", [&]() {
+        std::vector<Byte> bytes = readFile(CacheFileName);
+        if (!CORE_CHECK(bytes.size() > 64)) return;
+        const char* truncatedName = "ModelCacheTest.truncated.cmc";
+        UInt64 sizes[] = {bytes.size() - 1, bytes.size() / 2, 40};
+        for (UInt64 size : sizes) {
+            writeFile(truncatedName, bytes, size);
+            ModelCache::ModelData loaded;
+            CORE_CHECK(!ModelCache::readModel(truncatedName, CacheKey, loaded));
+        }
+        remove(truncatedName);
+    });
+
+    Test::run("attributes whose size does not match the vertex count are rejected", [&]() {
+        CORE_CHECK(ModelLoader::validateCachedModel(source.data));
+
+        // a block that is well-formed but written with a different per-vertex layout
+        ModelCache::ModelData wrongStride = source.data;
+        wrongStride.meshes[0].attributes[1].byteSize = 4 * Vector3rs::ComponentCount * sizeof(Real);
+        CORE_CHECK(!ModelLoader::validateCachedModel(wrongStride));
+
+        ModelCache::ModelData wrongVertexCount = source.data;
+        wrongVertexCount.meshes[0].vertexCount = 5;
+        CORE_CHECK(!ModelLoader::validateCachedModel(wrongVertexCount));
+
+        ModelCache::ModelData unknownAttribute = source.data;
+        unknownAttribute.meshes[0].attributes[0].attribute = (UInt32)StandardAttribute::_Count;
+        CORE_CHECK(!ModelLoader::validateCachedModel(unknownAttribute));
+
+        ModelCache::ModelData badIndices = source.data;
+        badIndices.meshes[0].indexStorage = {0, 1, 4};
+        badIndices.meshes[0].indices = badIndices.meshes[0].indexStorage.data();
+        badIndices.meshes[0].indexCount = 3;
+        CORE_CHECK(!ModelLoader::validateCachedModel(badIndices));
+    });
+
+    Test::run("bone maps that do not match the mesh are rejected", [&]() {
+        ModelCache::ModelData tooFewVertices = source.data;
+        tooFewVertices.meshes[0].boneMapVertexCount = 3;
+        CORE_CHECK(!ModelLoader::validateCachedModel(tooFewVertices));
+
+        ModelCache::ModelData badUniqueVertex = source.data;
+        badUniqueVertex.meshes[0].boneMapStorage[3].uniqueVertexIndex = 4;
+        badUniqueVertex.meshes[0].boneMapVertices = badUniqueVertex.meshes[0].boneMapStorage.data();
+        CORE_CHECK(!ModelLoader::validateCachedModel(badUniqueVertex));
+
+        ModelCache::ModelData tooManyBones = source.data;
+        tooManyBones.meshes[0].boneMapStorage[0].boneCount = Constants::MaxBonesPerVertex + 1;
+        tooManyBones.meshes[0].boneMapVertices = tooManyBones.meshes[0].boneMapStorage.data();
+        CORE_CHECK(!ModelLoader::validateCachedModel(tooManyBones));
+
+        ModelCache::ModelData missingBoneMap = source.data;
+        missingBoneMap.meshes[0].boneMapVertices = nullptr;
+        CORE_CHECK(!ModelLoader::validateCachedModel(missingBoneMap));
+    });
+
+    Test::run("a model rebuilt from the cache matches the Assimp import", testCachedModelMatchesImport);
+
+    remove(CacheFileName);
+    return Test::result();
+}
@@ -0,0 +1,176 @@
+#include <algorithm>
+#include <atomic>
+#include <future>
+#include <thread>
+#include <vector>
+
+#include "TestUtil.h"
+#include "../util/ObjectPool.h"
+
+using namespace Core;
+
+class PooledItem {
+public:
+    PooledItem(): owner(0) {
+    }
+
+    // Set by whoever holds the item, so that an item handed out twice is caught.
+    std::atomic<UInt32> owner;
+};
+
+static Bool allDistinct(std::vector<PooledItem*> items) {
+    std::sort(items.begin(), items.end());
+    return std::adjacent_find(items.begin(), items.end()) == items.end();
+}
+
+static void testReturnedObjectsAreReused() {
+    ObjectPool<PooledItem> pool(4);
+    PooledItem& a = pool.acquireObject();
+    PooledItem& b = pool.acquireObject();
+    PooledItem& c = pool.acquireObject();
+    CORE_CHECK(allDistinct({&a, &b, &c}));
+    CORE_CHECK_EQUAL(pool.getSize(), 3u);
+
+    pool.returnObject(b);
+    CORE_CHECK_EQUAL(pool.getSize(), 2u);
+    CORE_CHECK_EQUAL(&pool.acquireObject(), &b);
+
+    // a double return is ignored instead of putting the object on the free list twice
+    pool.returnObject(c);
+    pool.returnObject(c);
+    CORE_CHECK_EQUAL(pool.getSize(), 2u);
+    CORE_CHECK_EQUAL(&pool.acquireObject(), &c);
+
+    // growing adds a slab and leaves acquired objects where they are
+    std::vector<PooledItem*> items = {&a, &b, &c};
+    for (UInt32 i = 0; i < 10; i++) items.push_back(&pool.acquireObject());
+    CORE_CHECK(allDistinct(items));
+    CORE_CHECK(pool.getCapacity() >= 13u);
+    ObjectPool<PooledItem>::Statistics stats = pool.getStatistics();
+    CORE_CHECK_EQUAL(stats.liveCount, 13u);
+    CORE_CHECK_EQUAL(stats.peakLiveCount, 13u);
+    CORE_CHECK_EQUAL(stats.returnCount, 2ull);
+    CORE_CHECK(stats.slabCount > 1);
+}
+
+static void testReturnAll() {
+    ObjectPool<PooledItem> pool(4);
+    std::vector<PooledItem*> before;
+    for (UInt32 i = 0; i < 6; i++) before.push_back(&pool.acquireObject());
+    UInt32 capacity = pool.getCapacity();
+    pool.returnAll();
+    CORE_CHECK_EQUAL(pool.getSize(), 0u);
+    CORE_CHECK_EQUAL(pool.getStatistics().returnCount, 6ull);
+
+    // objects acquired before returnAll() are already back, so returning them again does nothing
+    for (PooledItem* item : before) pool.returnObject(*item);
+    CORE_CHECK_EQUAL(pool.getSize(), 0u);
+
+    // every slot is handed out exactly once again, and the pool doesn't grow to do so
+    std::vector<PooledItem*> after;
+    for (UInt32 i = 0; i < capacity; i++) after.push_back(&pool.acquireObject());
+    CORE_CHECK(allDistinct(after));
+    CORE_CHECK_EQUAL(pool.getCapacity(), capacity);
+    std::vector<PooledItem*> sortedBefore = before;
+    std::vector<PooledItem*> sortedAfter = after;
+    std::sort(sortedBefore.begin(), sortedBefore.end());
+    std::sort(sortedAfter.begin(), sortedAfter.end());
+    CORE_CHECK(std::includes(sortedAfter.begin(), sortedAfter.end(), sortedBefore.begin(), sortedBefore.end()));
+}
+
+static void testReturnAllDiscardsCachedObjects() {
+    ObjectPool<PooledItem> pool(64, true);
+    ObjectPool<PooledItem>::ThreadCache cache(pool, 8);
+    PooledItem& stale = cache.acquireObject();
+    pool.returnAll();
+
+    // an object acquired before returnAll() and only returned to the cache afterwards is already back
+    cache.returnObject(stale);
+
+    // as are the seven objects that were still in the cache, which mustn't be handed out again
+    std::vector<PooledItem*> items;
+    for (UInt32 i = 0; i < 32; i++) items.push_back(&pool.acquireObject());
+    for (UInt32 i = 0; i < 12; i++) items.push_back(&cache.acquireObject());
+    CORE_CHECK(allDistinct(items));
+    // two batches of eight went to the cache
+    CORE_CHECK_EQUAL(pool.getSize(), 48u);
+
+    // flushing returns what's left in the cache
+    cache.flush();
+    CORE_CHECK_EQUAL(pool.getSize(), (UInt32)items.size());
+}
+
+static void testCacheOnAnotherThreadAfterReturnAll() {
+    ObjectPool<PooledItem> pool(64, true);
+    std::promise<void> filled;
+    std::promise<void> returned;
+    std::shared_future<void> returnedFuture = returned.get_future().share();
+    std::vector<PooledItem*> workerItems;
+
+    std::thread worker([&]() {
+        ObjectPool<PooledItem>::ThreadCache cache(pool, 16);
+        cache.acquireObject();
+        cache.acquireObject();
+        filled.set_value();
+        returnedFuture.wait();
+        for (UInt32 i = 0; i < 40; i++) workerItems.push_back(&cache.acquireObject());
+        cache.flush();
+    });
+
+    filled.get_future().wait();
+    pool.returnAll();
+    std::vector<PooledItem*> items;
+    for (UInt32 i = 0; i < 40; i++) items.push_back(&pool.acquireObject());
+    returned.set_value();
+    worker.join();
+
+    items.insert(items.end(), workerItems.begin(), workerItems.end());
+    CORE_CHECK(allDistinct(items));
+    CORE_CHECK_EQUAL(pool.getSize(), 80u);
+}
+
+static void testConcurrentCachesNeverShareObjects() {
+    const UInt32 threadCount = 4;
+    ObjectPool<PooledItem> pool(16, true);
+    std::atomic<UInt32> sharedCount(0);
+    std::vector<std::thread> threads;
+    for (UInt32 t = 0; t < threadCount; t++) {
+        threads.emplace_back([&pool, &sharedCount, t]() {
+            ObjectPool<PooledItem>::ThreadCache cache(pool, 8);
+            std::vector<PooledItem*> held;
+            UInt32 state = t * 7919 + 1;
+            for (UInt32 i = 0; i < 20000; i++) {
+                state = state * 1664525u + 1013904223u;
+                if (held.size() < 24 && (held.size() == 0 || (state >> 16) % 3 != 0)) {
+                    PooledItem& item = cache.acquireObject();
+                    UInt32 expected = 0;
+                    if (!item.owner.compare_exchange_strong(expected, t + 1)) sharedCount++;
+                    held.push_back(&item);
+                }
+                else {
+                    PooledItem* item = held[(state >> 8) % held.size()];
+                    std::swap(held[(state >> 8) % held.size()], held.back());
+                    held.pop_back();
+                    item->owner.store(0);
+                    cache.returnObject(*item);
+                }
+            }
+            for (PooledItem* item : held) {
+                item->owner.store(0);
+                cache.returnObject(*item);
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    CORE_CHECK_EQUAL(sharedCount.load(), 0u);
+    CORE_CHECK_EQUAL(pool.getSize(), 0u);
+}
+
+int main(int argc, char** argv) {
+    Test::run("returned objects are reused", testReturnedObjectsAreReused);
+    Test::run("returnAll() returns every object once", testReturnAll);
+    Test::run("returnAll() discards objects held in a thread cache", testReturnAllDiscardsCachedObjects);
+    Test::run("a cache on another thread is invalidated by returnAll()", testCacheOnAnotherThreadAfterReturnAll);
+    Test::run("concurrent thread caches never share an object", testConcurrentCachesNeverShareObjects);
+    return Test::result();
+}
@@ -0,0 +1,288 @@
+#include <cmath>
+#include <vector>
+
+#include "TestUtil.h"
+#include "../Engine.h"
+#include "../Null/GraphicsNull.h"
+#include "../light/LightPack.h"
+#include "../particles/ParticleSystem.h"
+#include "../particles/initializer/LifetimeInitializer.h"
+#include "../particles/material/ParticleStandardMaterial.h"
+#include "../particles/renderer/ParticleInstanceBuffer.h"
+#include "../particles/renderer/ParticleSystemAnimatedSpriteRenderer.h"
+#include "../particles/util/RandomGenerator.h"
+#include "../render/PrimitiveType.h"
+#include "../render/ViewDescriptor.h"
+
+using namespace Core;
+
+// Particle attribute arrays laid out like ParticleStateAttributeArray's, with every value derived from the
+// particle index and the attribute so that any mix-up shows in the packed records.
+class TestParticles {
+public:
+    static const UInt32 PositionStride = 4;
+
+    explicit TestParticles(UInt32 count): count(count), positions(count * PositionStride), sizes(count * 2),
+                                          rotations(count), sequenceElements(count * 4), colors(count * 4) {
+        for (UInt32 p = 0; p < count; p++) {
+            for (UInt32 c = 0; c < PositionStride; c++) this->positions[p * PositionStride + c] = getValue(p, 0, c);
+            for (UInt32 c = 0; c < 2; c++) this->sizes[p * 2 + c] = getValue(p, 1, c);
+            this->rotations[p] = getValue(p, 2, 0);
+            for (UInt32 c = 0; c < 4; c++) {
+                this->sequenceElements[p * 4 + c] = getValue(p, 3, c);
+                this->colors[p * 4 + c] = getValue(p, 4, c);
+            }
+        }
+    }
+
+    static Real getValue(UInt32 particle, UInt32 attribute, UInt32 component) {
+        return (Real)particle * 100.0f + (Real)attribute * 10.0f + (Real)component;
+    }
+
+    void pack(ParticleInstanceBuffer& buffer, const UInt32* order, UInt32 packCount) {
+        buffer.pack(this->positions.data(), PositionStride, this->sizes.data(), this->rotations.data(),
+                    this->sequenceElements.data(), this->colors.data(), this->count, order, packCount);
+    }
+
+    UInt32 count;
+    std::vector<Real> positions;
+    std::vector<Real> sizes;
+    std::vector<Real> rotations;
+    std::vector<Real> sequenceElements;
+    std::vector<Real> colors;
+};
+
+// Returns the number of components of instance [i] in [buffer] that don't hold the attributes of [particle].
+static UInt32 countInstanceErrors(const ParticleInstanceBuffer& buffer, UInt32 i, UInt32 particle) {
+    const Real* instance = buffer.getData() + i * ParticleInstanceBuffer::ComponentCount;
+    UInt32 errors = 0;
+    for (UInt32 c = 0; c < 3; c++) {
+        if (instance[ParticleInstanceBuffer::PositionOffset + c] != TestParticles::getValue(particle, 0, c)) errors++;
+    }
+    for (UInt32 c = 0; c < 2; c++) {
+        if (instance[ParticleInstanceBuffer::SizeOffset + c] != TestParticles::getValue(particle, 1, c)) errors++;
+    }
+    if (instance[ParticleInstanceBuffer::RotationOffset] != TestParticles::getValue(particle, 2, 0)) errors++;
+    for (UInt32 c = 0; c < 4; c++) {
+        if (instance[ParticleInstanceBuffer::SequenceElementOffset + c] != TestParticles::getValue(particle, 3, c)) errors++;
+        if (instance[ParticleInstanceBuffer::ColorOffset + c] != TestParticles::getValue(particle, 4, c)) errors++;
+    }
+    return errors;
+}
+
+static void testLayoutCoversEveryComponentOnce() {
+    // the attributes sit back to back in the record, as the instanced vertex layout expects
+    CORE_CHECK_EQUAL(ParticleInstanceBuffer::SizeOffset, ParticleInstanceBuffer::PositionOffset + 3);
+    CORE_CHECK_EQUAL(ParticleInstanceBuffer::RotationOffset, ParticleInstanceBuffer::SizeOffset + 2);
+    CORE_CHECK_EQUAL(ParticleInstanceBuffer::SequenceElementOffset, ParticleInstanceBuffer::RotationOffset + 1);
+    CORE_CHECK_EQUAL(ParticleInstanceBuffer::ColorOffset, ParticleInstanceBuffer::SequenceElementOffset + 4);
+    CORE_CHECK_EQUAL(ParticleInstanceBuffer::ComponentCount, ParticleInstanceBuffer::ColorOffset + 4);
+}
+
+static void testPackInStorageOrder() {
+    TestParticles particles(10);
+    ParticleInstanceBuffer buffer;
+    particles.pack(buffer, nullptr, 7);
+    if (!CORE_CHECK_EQUAL(buffer.getCount(), 7u)) return;
+    UInt32 errors = 0;
+    for (UInt32 i = 0; i < 7; i++) errors += countInstanceErrors(buffer, i, i);
+    CORE_CHECK_EQUAL(errors, 0u);
+}
+
+static void testPackInDrawingOrder() {
+    TestParticles particles(8);
+    const UInt32 order[] = {5, 2, 7, 0, 3};
+    ParticleInstanceBuffer buffer;
+    particles.pack(buffer, order, 5);
+    if (!CORE_CHECK_EQUAL(buffer.getCount(), 5u)) return;
+    UInt32 errors = 0;
+    for (UInt32 i = 0; i < 5; i++) errors += countInstanceErrors(buffer, i, order[i]);
+    CORE_CHECK_EQUAL(errors, 0u);
+
+    // repacking fewer particles leaves a buffer of the same capacity with the new records in front
+    const UInt32 reversed[] = {7, 6};
+    particles.pack(buffer, reversed, 2);
+    CORE_CHECK_EQUAL(buffer.getCount(), 2u);
+    CORE_CHECK_EQUAL(countInstanceErrors(buffer, 0, 7) + countInstanceErrors(buffer, 1, 6), 0u);
+
+    CORE_CHECK_THROWS(particles.pack(buffer, nullptr, 9));
+}
+
+static void testLargePackFollowsTheOrder() {
+    // enough particles for the pack to be split across threads
+    const UInt32 count = 100000;
+    TestParticles particles(count);
+    std::vector<UInt32> order(count);
+    for (UInt32 i = 0; i < count; i++) order[i] = (i * 7919) % count;
+    ParticleInstanceBuffer buffer;
+    particles.pack(buffer, order.data(), count);
+    UInt32 wrongInstances = 0;
+    for (UInt32 i = 0; i < count; i++) {
+        if (countInstanceErrors(buffer, i, order[i]) != 0) wrongInstances++;
+    }
+    CORE_CHECK_EQUAL(wrongInstances, 0u);
+}
+
+// The null backend commands recorded since command [first] that are of type [type].
+static std::vector<GraphicsCommand> getCommandsSince(UInt32 first, GraphicsCommandType type) {
+    std::vector<GraphicsCommand> commands;
+    const GraphicsCommandLog& log = GraphicsNull::getCommandLog();
+    for (UInt32 i = first; i < log.getCommandCount(); i++) {
+        if (log.getCommand(i).type == type) commands.push_back(log.getCommand(i));
+    }
+    return commands;
+}
+
+// Returns the index in [commands] of the command for attribute [location] with [value] as its third value, or -1.
+static Int32 findAttributeCommand(const std::vector<GraphicsCommand>& commands, Int32 location, UInt32 value) {
+    for (UInt32 i = 0; i < commands.size(); i++) {
+        if (commands[i].values[0] == (UInt32)location && commands[i].values[2] == value) return (Int32)i;
+    }
+    return -1;
+}
+
+// A camera at the origin looking down -Z with a 90 degree field of view.
+static ViewDescriptor getViewDescriptor() {
+    ViewDescriptor viewDescriptor;
+    viewDescriptor.inverseCameraTransformation.setIdentity();
+    Real nearPlane = 0.1f, farPlane = 100.0f;
+    Real f = 1.0f / std::tan(3.14159265f * 0.25f);
+    Real* projection = viewDescriptor.projectionMatrix.getData();
+    for (UInt32 i = 0; i < 16; i++) projection[i] = 0.0f;
+    projection[0] = f;
+    projection[5] = f;
+    projection[10] = (farPlane + nearPlane) / (nearPlane - farPlane);
+    projection[11] = -1.0f;
+    projection[14] = 2.0f * farPlane * nearPlane / (nearPlane - farPlane);
+    return viewDescriptor;
+}
+
+static const UInt32 RenderedMaximumParticles = 64;
+
+// A system that has emitted some, but not all, of its long lived particles, and an instanced sprite renderer for it.
+static WeakPointer<ParticleSystemAnimatedSpriteRenderer> createInstancedSystem(WeakPointer<ParticleSystem>& particleSystem) {
+    WeakPointer<Object3D> owner = Engine::instance()->createObject3D();
+    particleSystem = Engine::instance()->createParticleSystem(owner, RenderedMaximumParticles);
+    ConstantParticleEmitter& emitter = particleSystem->setEmitter<ConstantParticleEmitter>();
+    emitter.emissionRate = 100.0f;
+    particleSystem->addParticleStateInitializer<LifetimeInitializer>(RandomGenerator<Real>(1.0f, 10.0f, false));
+    particleSystem->start();
+    particleSystem->update(0.25f);
+
+    WeakPointer<ParticleSystemAnimatedSpriteRenderer> renderer =
+        Engine::instance()->createRenderer<ParticleSystemAnimatedSpriteRenderer, ParticleSystem>(owner);
+    renderer->setSpriteExpansion(ParticleSystemAnimatedSpriteRenderer::SpriteExpansion::InstancedQuad);
+    return renderer;
+}
+
+// The quad corners advance per vertex and the quad is drawn once per live particle.
+static void checkQuadDraw(UInt32 first, WeakPointer<ParticleStandardMaterial> material, UInt32 activeParticleCount) {
+    std::vector<GraphicsCommand> bindings = getCommandsSince(first, GraphicsCommandType::BindVertexAttribute);
+    Int32 quadCorners = findAttributeCommand(bindings, material->getQuadCornerLocation(), 2);
+    if (CORE_CHECK(quadCorners >= 0)) {
+        CORE_CHECK(findAttributeCommand(getCommandsSince(first, GraphicsCommandType::SetAttributeDivisor),
+                                        material->getQuadCornerLocation(), 1) < 0);
+    }
+
+    std::vector<GraphicsCommand> draws = getCommandsSince(first, GraphicsCommandType::DrawInstanced);
+    if (!CORE_CHECK_EQUAL((UInt32)draws.size(), 1u)) return;
+    CORE_CHECK_EQUAL(draws[0].values[0], 6u);
+    CORE_CHECK_EQUAL(draws[0].values[1], (UInt32)PrimitiveType::Triangles);
+    CORE_CHECK_EQUAL(draws[0].values[2], activeParticleCount);
+    CORE_CHECK_EQUAL((UInt32)getCommandsSince(first, GraphicsCommandType::Draw).size(), 0u);
+    CORE_CHECK_EQUAL((UInt32)getCommandsSince(first, GraphicsCommandType::DrawIndexed).size(), 0u);
+}
+
+static void testSortedInstancesAreDrawnFromThePackedBuffer() {
+    WeakPointer<ParticleSystem> particleSystem;
+    WeakPointer<ParticleSystemAnimatedSpriteRenderer> renderer = createInstancedSystem(particleSystem);
+    if (!CORE_CHECK(renderer->isInstanced())) return;
+    UInt32 activeParticleCount = particleSystem->getActiveParticleCount();
+    if (!CORE_CHECK(activeParticleCount > 1 && activeParticleCount < RenderedMaximumParticles)) return;
+    renderer->setDepthSortEnabled(true);
+
+    WeakPointer<ParticleStandardMaterial> material = renderer->getMaterial();
+    UInt32 first = GraphicsNull::getCommandLog().getCommandCount();
+    renderer->forwardRenderParticleSystem(getViewDescriptor(), particleSystem, false, 0, LightPack(), false);
+
+    // every attribute is read from its offset in one buffer and advances once per instance
+    const Int32 locations[] = {material->getWorldPositionLocation(), material->getSizeLocation(), material->getRotationLocation(),
+                               material->getSequenceElementLocation(), material->getColorLocation()};
+    const UInt32 componentCounts[] = {3, 2, 1, 4, 4};
+    const UInt32 offsets[] = {ParticleInstanceBuffer::PositionOffset, ParticleInstanceBuffer::SizeOffset, ParticleInstanceBuffer::RotationOffset,
+                              ParticleInstanceBuffer::SequenceElementOffset, ParticleInstanceBuffer::ColorOffset};
+    std::vector<GraphicsCommand> bindings = getCommandsSince(first, GraphicsCommandType::BindVertexAttribute);
+    std::vector<GraphicsCommand> divisors = getCommandsSince(first, GraphicsCommandType::SetAttributeDivisor);
+    if (!CORE_CHECK(locations[0] >= 0)) return;
+    Int32 positionBinding = findAttributeCommand(bindings, locations[0], componentCounts[0]);
+    if (!CORE_CHECK(positionBinding >= 0)) return;
+    UInt32 instanceBufferID = bindings[positionBinding].values[1];
+    for (UInt32 i = 0; i < 5; i++) {
+        if (!CORE_CHECK(locations[i] >= 0)) continue;
+        Int32 binding = findAttributeCommand(bindings, locations[i], componentCounts[i]);
+        if (!CORE_CHECK(binding >= 0)) continue;
+        CORE_CHECK_EQUAL(bindings[binding].values[1], instanceBufferID);
+        CORE_CHECK_EQUAL(bindings[binding].values[3], offsets[i] * (UInt32)sizeof(Real));
+        // the divisor is set for drawing and then put back
+        Int32 perInstance = findAttributeCommand(divisors, locations[i], 1);
+        Int32 perVertex = findAttributeCommand(divisors, locations[i], 0);
+        if (CORE_CHECK(perInstance >= 0 && perVertex > perInstance)) CORE_CHECK_EQUAL(divisors[perInstance].values[1], instanceBufferID);
+    }
+
+    // the buffer is uploaded once, with a record for every particle the system can hold
+    UInt32 uploadCount = 0;
+    for (const GraphicsCommand& upload : getCommandsSince(first, GraphicsCommandType::Upload)) {
+        if (upload.detail != (UInt8)GraphicsResourceKind::VertexBuffer || upload.values[0] != instanceBufferID) continue;
+        CORE_CHECK_EQUAL(upload.values[1], RenderedMaximumParticles * ParticleInstanceBuffer::ComponentCount * (UInt32)sizeof(Real));
+        uploadCount++;
+    }
+    CORE_CHECK_EQUAL(uploadCount, 1u);
+
+    checkQuadDraw(first, material, activeParticleCount);
+}
+
+static void testUnsortedInstancesAreDrawnFromTheParticleStates() {
+    WeakPointer<ParticleSystem> particleSystem;
+    WeakPointer<ParticleSystemAnimatedSpriteRenderer> renderer = createInstancedSystem(particleSystem);
+    if (!CORE_CHECK(renderer->isInstanced())) return;
+    UInt32 activeParticleCount = particleSystem->getActiveParticleCount();
+
+    WeakPointer<ParticleStandardMaterial> material = renderer->getMaterial();
+    UInt32 first = GraphicsNull::getCommandLog().getCommandCount();
+    renderer->forwardRenderParticleSystem(getViewDescriptor(), particleSystem, false, 0, LightPack(), false);
+
+    // each attribute comes whole from its own buffer, advancing once per instance
+    const Int32 locations[] = {material->getWorldPositionLocation(), material->getSizeLocation(), material->getRotationLocation(),
+                               material->getSequenceElementLocation(), material->getColorLocation()};
+    std::vector<GraphicsCommand> bindings = getCommandsSince(first, GraphicsCommandType::BindVertexAttribute);
+    std::vector<GraphicsCommand> divisors = getCommandsSince(first, GraphicsCommandType::SetAttributeDivisor);
+    std::vector<UInt32> bufferIDs;
+    for (UInt32 i = 0; i < 5; i++) {
+        if (!CORE_CHECK(locations[i] >= 0)) continue;
+        Int32 perInstance = findAttributeCommand(divisors, locations[i], 1);
+        Int32 perVertex = findAttributeCommand(divisors, locations[i], 0);
+        if (!CORE_CHECK(perInstance >= 0 && perVertex > perInstance)) continue;
+        UInt32 bufferID = divisors[perInstance].values[1];
+        Bool bound = false;
+        for (const GraphicsCommand& binding : bindings) {
+            if (binding.values[0] == (UInt32)locations[i] && binding.values[1] == bufferID && binding.values[3] == 0) bound = true;
+        }
+        CORE_CHECK(bound);
+        for (UInt32 other : bufferIDs) CORE_CHECK(other != bufferID);
+        bufferIDs.push_back(bufferID);
+    }
+
+    checkQuadDraw(first, material, activeParticleCount);
+}
+
+int main(int argc, char** argv) {
+    Engine::setGraphicsBackend(GraphicsBackend::Null);
+    Engine::instance();
+    Test::run("instance record layout covers every component once", testLayoutCoversEveryComponentOnce);
+    Test::run("particles are packed in storage order without an order", testPackInStorageOrder);
+    Test::run("particles are packed in drawing order", testPackInDrawingOrder);
+    Test::run("large packs match the drawing order", testLargePackFollowsTheOrder);
+    Test::run("sorted instances are drawn from the packed buffer", testSortedInstancesAreDrawnFromThePackedBuffer);
+    Test::run("unsorted instances are drawn from the particle states", testUnsortedInstancesAreDrawnFromTheParticleStates);
+    return Test::result();
+}
@@ -0,0 +1,88 @@
+#include <cmath>
+
+#include "TestUtil.h"
+#include "../geometry/Box3.h"
+#include "../math/Matrix4x4.h"
+#include "../render/RenderUtils.h"
+#include "../render/ViewDescriptor.h"
+
+using namespace Core;
+
+// A camera at the origin looking down -Z with a 90 degree field of view, near plane at 0.1 and far plane at 100.
+static ViewDescriptor getViewDescriptor() {
+    ViewDescriptor viewDescriptor;
+    viewDescriptor.inverseCameraTransformation.setIdentity();
+    Real nearPlane = 0.1f, farPlane = 100.0f;
+    Real f = 1.0f / std::tan(3.14159265f * 0.25f);
+    Real* projection = viewDescriptor.projectionMatrix.getData();
+    for (UInt32 i = 0; i < 16; i++) projection[i] = 0.0f;
+    projection[0] = f;
+    projection[5] = f;
+    projection[10] = (farPlane + nearPlane) / (nearPlane - farPlane);
+    projection[11] = -1.0f;
+    projection[14] = 2.0f * farPlane * nearPlane / (nearPlane - farPlane);
+    return viewDescriptor;
+}
+
+// A unit box of particles around [x, y, z].
+static Box3 getBounds(Real x, Real y, Real z) {
+    Box3 bounds;
+    bounds.setMin(x - 0.5f, y - 0.5f, z - 0.5f);
+    bounds.setMax(x + 0.5f, y + 0.5f, z + 0.5f);
+    return bounds;
+}
+
+static Matrix4x4 getOwnerMatrix(Real x, Real y, Real z, Real scale) {
+    Matrix4x4 matrix;
+    matrix.setIdentity();
+    matrix.scale(scale, scale, scale);
+    matrix.preTranslate(x, y, z);
+    return matrix;
+}
+
+static void testMovedOwnerDoesNotMoveBounds() {
+    ViewDescriptor viewDescriptor = getViewDescriptor();
+    Real cameraDistance;
+    // the owner has moved far behind the camera and been scaled up; the particles are drawn where their bounds are
+    Matrix4x4 movedOwner = getOwnerMatrix(0.0f, 0.0f, 500.0f, 10.0f);
+    for (UInt32 w = 0; w < 2; w++) {
+        Bool simulateInWorldSpace = w == 1;
+        CORE_CHECK(RenderUtils::isParticleSystemInView(viewDescriptor, true, getBounds(0.0f, 0.0f, -10.0f), simulateInWorldSpace,
+                                                       movedOwner, cameraDistance));
+        CORE_CHECK_NEAR(cameraDistance, 10.0f, 0.0001f);
+        CORE_CHECK(!RenderUtils::isParticleSystemInView(viewDescriptor, true, getBounds(0.0f, 0.0f, 10.0f), simulateInWorldSpace,
+                                                        movedOwner, cameraDistance));
+    }
+
+    // the owner moving in front of the camera doesn't bring bounds behind it into view either
+    Matrix4x4 ownerInView = getOwnerMatrix(0.0f, 0.0f, -20.0f, 1.0f);
+    CORE_CHECK(!RenderUtils::isParticleSystemInView(viewDescriptor, true, getBounds(0.0f, 0.0f, 10.0f), false, ownerInView, cameraDistance));
+
+    // the bounds sphere reaches into view from just outside the left plane
+    CORE_CHECK(RenderUtils::isParticleSystemInView(viewDescriptor, true, getBounds(-10.6f, 0.0f, -10.0f), false, movedOwner, cameraDistance));
+    CORE_CHECK(!RenderUtils::isParticleSystemInView(viewDescriptor, true, getBounds(-11.5f, 0.0f, -10.0f), false, movedOwner, cameraDistance));
+}
+
+static void testEmptySystemsAreTestedWhereParticlesAppear() {
+    ViewDescriptor viewDescriptor = getViewDescriptor();
+    Box3 noBounds;
+    Real cameraDistance;
+
+    // a world space system emits at its owner's position
+    CORE_CHECK(RenderUtils::isParticleSystemInView(viewDescriptor, false, noBounds, true, getOwnerMatrix(1.0f, 2.0f, -20.0f, 1.0f), cameraDistance));
+    CORE_CHECK_NEAR(cameraDistance, std::sqrt(405.0f), 0.0001f);
+    CORE_CHECK(!RenderUtils::isParticleSystemInView(viewDescriptor, false, noBounds, true, getOwnerMatrix(0.0f, 0.0f, 20.0f, 1.0f), cameraDistance));
+
+    // a local space system emits around the origin, wherever its owner is
+    ViewDescriptor cameraBehindOrigin = getViewDescriptor();
+    cameraBehindOrigin.inverseCameraTransformation.preTranslate(0.0f, 0.0f, -5.0f);
+    CORE_CHECK(RenderUtils::isParticleSystemInView(cameraBehindOrigin, false, noBounds, false, getOwnerMatrix(0.0f, 0.0f, 50.0f, 1.0f), cameraDistance));
+    CORE_CHECK_NEAR(cameraDistance, 5.0f, 0.0001f);
+    CORE_CHECK(!RenderUtils::isParticleSystemInView(viewDescriptor, false, noBounds, false, getOwnerMatrix(0.0f, 0.0f, -20.0f, 1.0f), cameraDistance));
+}
+
+int main(int argc, char** argv) {
+    Test::run("a moved owner does not move the particle bounds", testMovedOwnerDoesNotMoveBounds);
+    Test::run("empty systems are tested where particles appear", testEmptySystemsAreTestedWhereParticlesAppear);
+    return Test::result();
+}
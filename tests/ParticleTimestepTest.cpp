@@ -0,0 +1,163 @@
+#include <memory>
+#include <vector>
+
+#include "TestUtil.h"
+#include "../Engine.h"
+#include "../particles/ParticleSystem.h"
+#include "../particles/initializer/BasicParticleStateInitializer.h"
+#include "../particles/initializer/LifetimeInitializer.h"
+#include "../particles/initializer/RandomVelocityInitializer.h"
+#include "../particles/operator/BasicParticleStateOperator.h"
+#include "../particles/util/RandomGenerator.h"
+
+using namespace Core;
+
+static const UInt32 MaximumParticles = 1000;
+static const Real StepSize = 1.0f / 60.0f;
+static const UInt32 TotalSteps = 120;
+
+// A local space fountain: 150 particles a second living 0.5 to 1.5 seconds, so that particles are both born and
+// dying throughout the run.
+static std::unique_ptr<ParticleSystem> createSystem(UInt32 maxSubsteps) {
+    std::unique_ptr<ParticleSystem> system(new ParticleSystem(WeakPointer<Object3D>(), MaximumParticles));
+    ConstantParticleEmitter& emitter = system->setEmitter<ConstantParticleEmitter>();
+    emitter.emissionRate = 150.0f;
+    system->addParticleStateInitializer<BasicParticleStateInitializer>();
+    system->addParticleStateInitializer<LifetimeInitializer>(RandomGenerator<Real>(1.0f, 0.5f, false));
+    system->addParticleStateInitializer<RandomVelocityInitializer>(2.0f, 1.0f, 2.0f, -1.0f, 2.0f, -1.0f, 1.0f, 1.0f);
+    system->addParticleStateOperator<BasicParticleStateOperator>();
+    system->setRandomSeed(0x7E57ull);
+
+    ParticleSystem::TimestepSettings settings;
+    settings.fixed = true;
+    settings.stepSize = StepSize;
+    settings.maxSubsteps = maxSubsteps;
+    settings.interpolate = true;
+    system->setTimestepSettings(settings);
+    system->start();
+    return system;
+}
+
+// The simulated state of the live particles, for bit-exact comparison.
+static std::vector<Real> getState(ParticleSystem& system) {
+    ParticleStateAttributeArray& states = system.getParticleStates();
+    UInt32 count = system.getActiveParticleCount();
+    std::vector<Real> state;
+    state.push_back((Real)count);
+    const Real* positions = states.getPositions()->getStorage();
+    const Real* ages = states.getAges()->getAttributes();
+    const Real* lifetimes = states.getLifetimes()->getAttributes();
+    state.insert(state.end(), positions, positions + count * states.getPositions()->getComponentCount());
+    for (UInt32 i = 0; i < count; i++) {
+        const Vector3rs& velocity = *states.getStatePtr(i).velocity;
+        state.insert(state.end(), {velocity.x, velocity.y, velocity.z});
+    }
+    state.insert(state.end(), ages, ages + count);
+    state.insert(state.end(), lifetimes, lifetimes + count);
+    return state;
+}
+
+static std::vector<Real> runFrames(ParticleSystem& system, const std::vector<Real>& frameTimes) {
+    for (Real frameTime : frameTimes) system.update(frameTime);
+    return getState(system);
+}
+
+// TotalSteps steps' worth of time, split into frames of [stepsPerFrame] steps each.
+static std::vector<Real> getEvenFrames(UInt32 stepsPerFrame) {
+    return std::vector<Real>(TotalSteps / stepsPerFrame, StepSize * (Real)stepsPerFrame);
+}
+
+// The same time in irregular frames: fractions of a step that only add up to whole steps over several frames,
+// a frame without time, and a spike of many steps at once.
+static std::vector<Real> getIrregularFrames() {
+    const Real pattern[] = {0.3f, 0.7f, 2.5f, 0.5f, 0.0f, 0.25f, 1.25f, 0.5f, 1.0f, 0.1f, 0.9f, 12.0f};
+    std::vector<Real> frameTimes;
+    Real steps = 0.0f;
+    while (steps < (Real)TotalSteps) {
+        for (Real frameSteps : pattern) {
+            frameTimes.push_back(StepSize * frameSteps);
+            steps += frameSteps;
+        }
+    }
+    CORE_CHECK_EQUAL(steps, (Real)TotalSteps);
+    return frameTimes;
+}
+
+static void testResultDoesNotDependOnFrameSplit() {
+    std::vector<Real> reference = runFrames(*createSystem(0), getEvenFrames(1));
+    CORE_CHECK(reference[0] > 50.0f);
+
+    UInt32 mismatches = 0;
+    const UInt32 stepsPerFrame[] = {2, 3, 8};
+    for (UInt32 steps : stepsPerFrame) {
+        if (runFrames(*createSystem(0), getEvenFrames(steps)) != reference) mismatches++;
+    }
+    if (runFrames(*createSystem(0), getIrregularFrames()) != reference) mismatches++;
+    CORE_CHECK_EQUAL(mismatches, 0u);
+}
+
+static void testFrameSpikesAreCapped() {
+    // a half second spike under a four step limit simulates four steps and drops the rest of the time
+    std::unique_ptr<ParticleSystem> capped = createSystem(4);
+    std::vector<Real> cappedState = runFrames(*capped, std::vector<Real>(1, 0.5f));
+    CORE_CHECK(cappedState == runFrames(*createSystem(0), std::vector<Real>(4, StepSize)));
+    CORE_CHECK_NEAR(capped->getInterpolationFactor(), 0.0f, 0.0001f);
+}
+
+static void testLeftoverTimeInterpolatesRenderPositions() {
+    std::unique_ptr<ParticleSystem> system = createSystem(0);
+    runFrames(*system, getEvenFrames(1));
+    std::vector<Real> before = getState(*system);
+    system->update(StepSize * 0.25f);
+    // a quarter step doesn't run a step, it only moves the render positions a quarter of the way along the last one
+    CORE_CHECK(getState(*system) == before);
+    CORE_CHECK_NEAR(system->getInterpolationFactor(), 0.25f, 0.0001f);
+
+    ParticleStateAttributeArray& states = system->getParticleStates();
+    const Real* current = states.getPositions()->getStorage();
+    const Real* previous = states.getPreviousPositions()->getStorage();
+    const Real* rendered = system->getRenderPositions()->getStorage();
+    UInt32 wrong = 0;
+    for (UInt32 i = 0; i < system->getActiveParticleCount() * states.getPositions()->getComponentCount(); i++) {
+        if (Math::abs(rendered[i] - (previous[i] + (current[i] - previous[i]) * 0.25f)) > 0.0001f) wrong++;
+    }
+    CORE_CHECK_EQUAL(wrong, 0u);
+}
+
+static void testReplayIsBitExact() {
+    // record half a run, then keep going to get the reference
+    std::unique_ptr<ParticleSystem> recorded = createSystem(0);
+    runFrames(*recorded, getEvenFrames(1));
+    std::shared_ptr<ParticleEmissionRecording> recording = std::make_shared<ParticleEmissionRecording>();
+    recorded->startRecording(recording);
+    std::vector<Real> frameTimes = getIrregularFrames();
+    std::vector<std::vector<Real>> recordedStates;
+    for (Real frameTime : frameTimes) {
+        recorded->update(frameTime);
+        recordedStates.push_back(getState(*recorded));
+    }
+    recorded->stopRecording();
+    CORE_CHECK_EQUAL(recording->getFrameCount(), (UInt32)frameTimes.size());
+
+    // the replaying system starts out differently, with another seed, and is given other frame times
+    std::unique_ptr<ParticleSystem> replayed = createSystem(4);
+    replayed->setRandomSeed(0xDEADull);
+    runFrames(*replayed, getEvenFrames(3));
+    replayed->startReplay(recording);
+    UInt32 mismatches = 0;
+    for (UInt32 f = 0; f < frameTimes.size(); f++) {
+        replayed->update(1.0f);
+        if (getState(*replayed) != recordedStates[f]) mismatches++;
+    }
+    CORE_CHECK_EQUAL(mismatches, 0u);
+    CORE_CHECK(!replayed->isReplaying());
+}
+
+int main(int argc, char** argv) {
+    Engine::setGraphicsBackend(GraphicsBackend::Null);
+    Test::run("the result does not depend on how time is split into frames", testResultDoesNotDependOnFrameSplit);
+    Test::run("frame time spikes are capped at the substep limit", testFrameSpikesAreCapped);
+    Test::run("leftover time interpolates the render positions", testLeftoverTimeInterpolatesRenderPositions);
+    Test::run("replaying a recording is bit-exact", testReplayIsBitExact);
+    return Test::result();
+}
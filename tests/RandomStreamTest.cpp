@@ -0,0 +1,238 @@
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "TestUtil.h"
+#include "../particles/util/RandomStream.h"
+#include "../util/ParallelFor.h"
+
+using namespace Core;
+
+static const UInt64 Seed = 0x1234ABCDull;
+
+static void testStreamsAreReproducible() {
+    RandomStream a(Seed, 3);
+    RandomStream b(Seed, 3);
+    RandomStream otherStream(Seed, 4);
+    RandomStream otherSeed(Seed + 1, 3);
+    UInt32 differences = 0, otherStreamMatches = 0, otherSeedMatches = 0;
+    std::vector<UInt32> first;
+    for (UInt32 i = 0; i < 1000; i++) {
+        UInt32 value = a.nextUInt32();
+        first.push_back(value);
+        if (value != b.nextUInt32()) differences++;
+        if (value == otherStream.nextUInt32()) otherStreamMatches++;
+        if (value == otherSeed.nextUInt32()) otherSeedMatches++;
+    }
+    CORE_CHECK_EQUAL(differences, 0u);
+    CORE_CHECK(otherStreamMatches < 3);
+    CORE_CHECK(otherSeedMatches < 3);
+
+    // reseeding restarts the sequence
+    a.seed(Seed, 3);
+    differences = 0;
+    for (UInt32 i = 0; i < first.size(); i++) {
+        if (a.nextUInt32() != first[i]) differences++;
+    }
+    CORE_CHECK_EQUAL(differences, 0u);
+}
+
+static void testBulkMatchesSingleValues() {
+    // a fresh stream hands out the same values one at a time as it writes in bulk
+    const UInt32 count = 1001;
+    std::vector<Real> bulk(count * 2, -1.0f);
+    RandomStream bulkStream(Seed, 9);
+    bulkStream.fillUniform(bulk.data(), count, 2, 4.0f, -1.0f);
+    RandomStream singleStream(Seed, 9);
+    UInt32 differences = 0, untouched = 0;
+    for (UInt32 i = 0; i < count; i++) {
+        if (bulk[i * 2] != singleStream.nextReal(4.0f, -1.0f)) differences++;
+        if (bulk[i * 2 + 1] != -1.0f) untouched++;
+    }
+    CORE_CHECK_EQUAL(differences, 0u);
+    // the stride leaves the values in between alone
+    CORE_CHECK_EQUAL(untouched, 0u);
+}
+
+static void testUniformDistribution() {
+    const UInt32 count = 1 << 20;
+    const UInt32 bucketCount = 64;
+    std::vector<Real> values(count);
+    RandomStream random(Seed);
+    random.fillUniform(values.data(), count, 1, 1.0f, 0.0f);
+
+    std::vector<UInt32> buckets(bucketCount, 0);
+    RealDouble sum = 0.0, sumSquares = 0.0;
+    UInt32 outOfRange = 0;
+    for (Real value : values) {
+        if (!(value >= 0.0f && value < 1.0f)) {
+            outOfRange++;
+            continue;
+        }
+        sum += value;
+        sumSquares += (RealDouble)value * value;
+        buckets[(UInt32)(value * bucketCount)]++;
+    }
+    CORE_CHECK_EQUAL(outOfRange, 0u);
+    RealDouble mean = sum / count;
+    RealDouble variance = sumSquares / count - mean * mean;
+    CORE_CHECK_NEAR(mean, 0.5, 0.002);
+    CORE_CHECK_NEAR(variance, 1.0 / 12.0, 0.001);
+
+    // chi-square with 63 degrees of freedom stays under its 99.9th percentile
+    RealDouble expected = (RealDouble)count / bucketCount;
+    RealDouble chiSquare = 0.0;
+    for (UInt32 bucket : buckets) chiSquare += (bucket - expected) * (bucket - expected) / expected;
+    CORE_CHECK(chiSquare < 103.4);
+
+    // consecutive values are uncorrelated
+    RealDouble lagSum = 0.0;
+    for (UInt32 i = 1; i < count; i++) lagSum += ((RealDouble)values[i] - 0.5) * ((RealDouble)values[i - 1] - 0.5);
+    CORE_CHECK(std::fabs(lagSum / (count - 1) / (1.0 / 12.0)) < 0.01);
+}
+
+static void testStreamsAreUncorrelated() {
+    const UInt32 count = 1 << 18;
+    std::vector<Real> a(count), b(count);
+    RandomStream(Seed, 0).fillUniform(a.data(), count, 1, 1.0f, 0.0f);
+    RandomStream(Seed, 1).fillUniform(b.data(), count, 1, 1.0f, 0.0f);
+    RealDouble covariance = 0.0;
+    for (UInt32 i = 0; i < count; i++) covariance += ((RealDouble)a[i] - 0.5) * ((RealDouble)b[i] - 0.5);
+    CORE_CHECK(std::fabs(covariance / count / (1.0 / 12.0)) < 0.01);
+}
+
+static void testBoxAndSphere() {
+    const UInt32 count = 10003;
+    const Real range[] = {2.0f, 4.0f, 0.5f};
+    const Real offset[] = {-1.0f, 10.0f, 0.0f};
+    std::vector<Real> points(count * 4);
+    RandomStream random(Seed);
+    random.fillBox(points.data(), count, 4, range, offset);
+    UInt32 outside = 0;
+    RealDouble sums[3] = {0.0, 0.0, 0.0};
+    for (UInt32 i = 0; i < count; i++) {
+        for (UInt32 c = 0; c < 3; c++) {
+            Real value = points[i * 4 + c];
+            if (value < offset[c] || value >= offset[c] + range[c]) outside++;
+            sums[c] += value;
+        }
+    }
+    CORE_CHECK_EQUAL(outside, 0u);
+    for (UInt32 c = 0; c < 3; c++) CORE_CHECK_NEAR(sums[c] / count, offset[c] + range[c] * 0.5f, range[c] * 0.02f);
+
+    // a shell between radius 2 and 3 around (5, 0, -5), over the whole sphere
+    const Real scale[] = {1.0f, 1.0f, 1.0f};
+    const Real center[] = {5.0f, 0.0f, -5.0f};
+    const Real pi = 3.14159265f;
+    random.fillSphere(points.data(), count, 4, 2.0f * pi, 0.0f, pi, -pi * 0.5f, 1.0f, 2.0f, scale, center);
+    outside = 0;
+    for (UInt32 c = 0; c < 3; c++) sums[c] = 0.0;
+    for (UInt32 i = 0; i < count; i++) {
+        Real dx = points[i * 4] - center[0], dy = points[i * 4 + 1] - center[1], dz = points[i * 4 + 2] - center[2];
+        Real radius = std::sqrt(dx * dx + dy * dy + dz * dz);
+        if (radius < 2.0f - 0.0001f || radius > 3.0f + 0.0001f) outside++;
+        sums[0] += dx;
+        sums[1] += dy;
+        sums[2] += dz;
+    }
+    CORE_CHECK_EQUAL(outside, 0u);
+    for (UInt32 c = 0; c < 3; c++) CORE_CHECK_NEAR(sums[c] / count, 0.0, 0.1);
+}
+
+static void testParallelForCoversEveryIndexOnce() {
+    const UInt32 counts[] = {0, 1, 7, 1000, 100003};
+    for (UInt32 count : counts) {
+        std::vector<std::atomic<UInt32>> visits(count);
+        for (std::atomic<UInt32>& visit : visits) visit = 0;
+        parallelFor(count, 64, [&visits](UInt32 first, UInt32 last) {
+            for (UInt32 i = first; i < last; i++) visits[i]++;
+        });
+        UInt32 wrong = 0;
+        for (std::atomic<UInt32>& visit : visits) {
+            if (visit != 1) wrong++;
+        }
+        CORE_CHECK_EQUAL(wrong, 0u);
+    }
+
+    Bool thrown = false;
+    try {
+        parallelFor(100000, 16, [](UInt32 first, UInt32 last) {
+            if (last == 100000) throw std::runtime_error("last slice");
+        });
+    }
+    catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    CORE_CHECK(thrown);
+}
+
+static void testParallelForReusesItsThreads() {
+    std::mutex threadMutex;
+    std::vector<std::thread::id> threads;
+    for (UInt32 call = 0; call < 200; call++) {
+        parallelFor(4096, 16, [&](UInt32 first, UInt32 last) {
+            std::lock_guard<std::mutex> lock(threadMutex);
+            if (std::find(threads.begin(), threads.end(), std::this_thread::get_id()) == threads.end()) {
+                threads.push_back(std::this_thread::get_id());
+            }
+        });
+    }
+    // the calling thread plus the pool's workers, however many loops ran
+    CORE_CHECK(threads.size() <= ParallelForPool::getInstance().getWorkerCount() + 1);
+
+    // a slice may run a loop of its own
+    std::atomic<UInt32> visits(0);
+    parallelFor(64, 1, [&visits](UInt32 first, UInt32 last) {
+        for (UInt32 i = first; i < last; i++) {
+            parallelFor(64, 1, [&visits](UInt32 innerFirst, UInt32 innerLast) { visits += innerLast - innerFirst; });
+        }
+    });
+    CORE_CHECK_EQUAL(visits.load(), 64u * 64u);
+}
+
+// Fill [values] in fixed blocks with one stream per block, as parallel particle emission does.
+static void fillInBlocks(std::vector<Real>& values, UInt32 blockSize, Bool parallel) {
+    UInt32 blockCount = ((UInt32)values.size() + blockSize - 1) / blockSize;
+    auto fillBlocks = [&values, blockSize](UInt32 firstBlock, UInt32 lastBlock) {
+        for (UInt32 b = firstBlock; b < lastBlock; b++) {
+            RandomStream random(Seed, b);
+            UInt32 first = b * blockSize;
+            UInt32 count = first + blockSize < values.size() ? blockSize : (UInt32)values.size() - first;
+            random.fillUniform(&values[first], count, 1, 1.0f, 0.0f);
+        }
+    };
+    if (parallel) parallelFor(blockCount, 1, fillBlocks);
+    else fillBlocks(0, blockCount);
+}
+
+static void testBlockStreamsDoNotDependOnThreading() {
+    std::vector<Real> serial(100000), parallel(100000);
+    fillInBlocks(serial, 1024, false);
+    fillInBlocks(parallel, 1024, true);
+    CORE_CHECK(serial == parallel);
+
+    // the thread streams of different threads are seeded differently
+    UInt32 mainValue = RandomStream::getThreadStream().nextUInt32();
+    UInt32 otherValue = 0;
+    std::thread thread([&otherValue]() {
+        otherValue = RandomStream::getThreadStream().nextUInt32();
+    });
+    thread.join();
+    CORE_CHECK(mainValue != otherValue);
+}
+
+int main(int argc, char** argv) {
+    Test::run("streams are reproducible from their seed", testStreamsAreReproducible);
+    Test::run("bulk fills match single values", testBulkMatchesSingleValues);
+    Test::run("uniform values are uniformly distributed", testUniformDistribution);
+    Test::run("streams of the same seed are uncorrelated", testStreamsAreUncorrelated);
+    Test::run("box and sphere points stay in their shapes", testBoxAndSphere);
+    Test::run("parallelFor covers every index once and forwards exceptions", testParallelForCoversEveryIndexOnce);
+    Test::run("parallelFor reuses its threads and allows nesting", testParallelForReusesItsThreads);
+    Test::run("per-block streams do not depend on threading", testBlockStreamsDoNotDependOnThreading);
+    return Test::result();
+}
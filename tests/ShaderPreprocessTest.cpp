@@ -0,0 +1,121 @@
+#include <cstdio>
+#include <string>
+
+#include "TestUtil.h"
+#include "../GL/ShaderManagerGL.h"
+
+using namespace Core;
+
+static const char* PreprocessedFileName = "ShaderPreprocessTest.pre";
+
+// A light per include, with a shadow cascade per nested include, laid out like the engine's lighting shaders:
+// parameters are forwarded from one include to the next and run into identifiers and array subscripts.
+static const char* CascadeSource =
+    "float shadow_@lightIndex_@cascadeIndex(vec4 pos) {\n"
+    "    int offset = @lightIndex * 3 + @cascadeIndex;\n"
+    "    return shadowMaps[@lightIndex].x + float(offset);\n"
+    "}\n";
+static const char* LightSource =
+    "#include \"Cascade(lightIndex=@lightIndex,cascadeIndex=0)\"\n"
+    "#include \"Cascade(lightIndex=@lightIndex, cascadeIndex = 1)\"\n"
+    "vec4 lightColor@lightIndex() {\n"
+    "    return colors[@lightIndex];\n"
+    "}\n";
+static const char* CommonSource = "uniform vec4 colors[4];\n";
+static const char* ProgramSource =
+    "#version 330\n"
+    "#include \"Common\"\n"
+    "#include \"Light(lightIndex=0)\"\n"
+    "  #include \"Light(lightIndex=2)\"  \n"
+    "out vec4 color;\n"
+    "void main() {\n"
+    "    color = lightColor0() + lightColor2();\n"
+    "}\n";
+
+static std::string readFixture(const char* name) {
+    std::string path = std::string(CORE_TEST_FIXTURES_DIR) + "/" + name;
+    std::string contents;
+    FILE* file = fopen(path.c_str(), "rb");
+    if (!file) return contents;
+    Int32 c;
+    while ((c = fgetc(file)) != EOF) contents.push_back((char)c);
+    fclose(file);
+    return contents;
+}
+
+static void registerSources(ShaderManager& manager) {
+    manager.setShaderSource(ShaderType::Fragment, "Cascade", CascadeSource);
+    manager.setShaderSource(ShaderType::Fragment, "Light", LightSource);
+    // a base source stands in for every shader type
+    manager.setShaderSource(ShaderType::Base, "Common", CommonSource);
+    manager.setShaderSource(ShaderType::Vertex, "Program", "void main() {}\n");
+    manager.setShaderSource(ShaderType::Fragment, "Program", ProgramSource);
+}
+
+static void testVariantMatchesFixture() {
+    std::string expected = readFixture("shader_variant.frag");
+    if (!CORE_CHECK(expected.size() > 0)) return;
+    ShaderManager manager;
+    registerSources(manager);
+    CORE_CHECK(manager.getShaderSource(ShaderType::Fragment, "Program") == expected);
+
+    // a single variant of an include, with the parameters given directly
+    ShaderManager::IncludeParameterCollection params;
+    params.setValue("lightIndex", "3");
+    params.setValue("cascadeIndex", "1");
+    CORE_CHECK(manager.getShaderSource(ShaderType::Fragment, "Cascade", params) ==
+               "float shadow_3_1(vec4 pos) {\n"
+               "    int offset = 3 * 3 + 1;\n"
+               "    return shadowMaps[3].x + float(offset);\n"
+               "}\n");
+
+    // parameters that aren't given are marked rather than left for the GLSL compiler to misread
+    CORE_CHECK(manager.getShaderSource(ShaderType::Fragment, "Light").find("lightColor!!lightIndex()") != std::string::npos);
+}
+
+static void testPreprocessedFileMatchesFixture() {
+    std::string expected = readFixture("shader_variant.frag");
+    ShaderManager writer;
+    registerSources(writer);
+    if (!CORE_CHECK(writer.savePreprocessedSources(PreprocessedFileName))) return;
+
+    // what's read back must be the known-good expansion, not merely what the writer expanded
+    ShaderManager reader;
+    registerSources(reader);
+    if (!CORE_CHECK(reader.loadPreprocessedSources(PreprocessedFileName))) return;
+    std::string loaded;
+    CORE_CHECK(reader.getPreprocessedSource(ShaderType::Fragment, "Program", loaded));
+    CORE_CHECK(loaded == expected);
+    CORE_CHECK(reader.getShaderSource(ShaderType::Fragment, "Program") == expected);
+    CORE_CHECK(!reader.getPreprocessedSource(ShaderType::Geometry, "Program", loaded));
+
+    // a file written from other sources is not used
+    ShaderManager changed;
+    registerSources(changed);
+    changed.setShaderSource(ShaderType::Fragment, "Cascade", "float shadow_@lightIndex_@cascadeIndex(vec4 pos) { return 0.0; }\n");
+    CORE_CHECK(!changed.loadPreprocessedSources(PreprocessedFileName));
+    CORE_CHECK(!changed.getPreprocessedSource(ShaderType::Fragment, "Program", loaded));
+    remove(PreprocessedFileName);
+}
+
+static void testEngineLightingVariantIsExpanded() {
+    ShaderManagerGL manager;
+    manager.init();
+    ShaderManager::IncludeParameterCollection params;
+    params.setValue("lightIndex", "1");
+    std::string source = manager.getShaderSource(ShaderType::Fragment, "Lighting", params);
+
+    // the light index is forwarded to every cascade, and nothing is left unexpanded
+    const char* functions[] = {"calcDirShadowFactor_1_0(", "calcDirShadowFactor_1_1(", "calcDirShadowFactor_1_2(", "getDirLightColor1("};
+    for (const char* function : functions) CORE_CHECK(source.find(function) != std::string::npos);
+    CORE_CHECK(source.find("#include") == std::string::npos);
+    CORE_CHECK(source.find('@') == std::string::npos);
+    CORE_CHECK(source.find("!!") == std::string::npos);
+}
+
+int main(int argc, char** argv) {
+    Test::run("an expanded variant matches the known-good fixture", testVariantMatchesFixture);
+    Test::run("a preprocessed file reads back as the known-good fixture", testPreprocessedFileMatchesFixture);
+    Test::run("the engine's lighting variants are fully expanded", testEngineLightingVariantIsExpanded);
+    return Test::result();
+}
@@ -0,0 +1,107 @@
+#include <string>
+#include <vector>
+
+#include "TestUtil.h"
+#include "../Engine.h"
+#include "../Graphics.h"
+#include "../Null/GraphicsNull.h"
+#include "../Null/ShaderNull.h"
+#include "../material/ShaderManager.h"
+
+using namespace Core;
+
+static ShaderManager& getShaderManager() {
+    return Engine::instance()->getGraphicsSystem()->getShaderManager();
+}
+
+static UInt32 getBuildCount() {
+    return GraphicsNull::getCommandLog().getCounters().getCommandCount(GraphicsCommandType::BuildShader);
+}
+
+static Bool requestedNamesAre(const std::vector<std::string>& expected) {
+    return getShaderManager().getRequestedShaderNames() == expected;
+}
+
+static void testStartupBuildsOnlyTheFallback() {
+    // the engine creates its default materials at startup, but in lazy mode only the fallback is drawn with
+    CORE_CHECK(Engine::instance()->getFallbackMaterial().isValid());
+    CORE_CHECK_EQUAL(getBuildCount(), 1u);
+    CORE_CHECK(requestedNamesAre({"BasicColored"}));
+}
+
+static void testRequestsAreTrackedInFirstUseOrder() {
+    ShaderManager& shaderManager = getShaderManager();
+    UInt32 builds = getBuildCount();
+    // the single and multi light variants of the physical material are separate programs
+    CORE_CHECK(shaderManager.requestShader("StandardPhysicalMulti", true));
+    CORE_CHECK(shaderManager.requestShader("Basic", true));
+    CORE_CHECK(shaderManager.requestShader("StandardPhysicalMulti", true));
+    CORE_CHECK(shaderManager.requestShader("BasicColored", true));
+    CORE_CHECK_EQUAL(getBuildCount(), builds + 2);
+    CORE_CHECK(requestedNamesAre({"BasicColored", "StandardPhysicalMulti", "Basic"}));
+
+    // asking for a shader without drawing with it doesn't count as a use
+    shaderManager.getShader("StandardPhysical");
+    CORE_CHECK_EQUAL(getBuildCount(), builds + 2);
+    CORE_CHECK_EQUAL(shaderManager.getRequestedShaderNames().size(), (size_t)3);
+}
+
+static void testBackgroundBuildsCompleteLater() {
+    ShaderManager& shaderManager = getShaderManager();
+    ShaderNull::setBuildLatency(3);
+    UInt32 builds = getBuildCount();
+
+    // the variant is tracked on the first request, while the fallback is drawn in its place
+    CORE_CHECK(!shaderManager.requestShader("StandardPhysical", false));
+    CORE_CHECK_EQUAL(shaderManager.getPendingBuildCount(), 1u);
+    CORE_CHECK(shaderManager.getRequestedShaderNames().back() == "StandardPhysical");
+    CORE_CHECK(!shaderManager.requestShader("StandardPhysical", false));
+    CORE_CHECK_EQUAL(getBuildCount(), builds);
+
+    // the per-frame update finishes the build once the driver reports it complete
+    shaderManager.update();
+    CORE_CHECK_EQUAL(shaderManager.getPendingBuildCount(), 0u);
+    CORE_CHECK_EQUAL(getBuildCount(), builds + 1);
+    CORE_CHECK(shaderManager.requestShader("StandardPhysical", false));
+    CORE_CHECK_EQUAL(shaderManager.getRequestedShaderNames().size(), (size_t)4);
+    ShaderNull::setBuildLatency(0);
+}
+
+static void testWarmupIsSpreadOverFrames() {
+    ShaderManager& shaderManager = getShaderManager();
+    UInt32 builds = getBuildCount();
+    size_t requested = shaderManager.getRequestedShaderNames().size();
+    shaderManager.setWarmupBuildsPerUpdate(1);
+
+    CORE_CHECK(shaderManager.enqueueWarmup("BasicTextured"));
+    CORE_CHECK(shaderManager.enqueueWarmup("BasicTexturedLit"));
+    CORE_CHECK(shaderManager.enqueueWarmup("BasicTextured"));
+    // already built, so there's nothing to warm up
+    CORE_CHECK(shaderManager.enqueueWarmup("Basic"));
+    CORE_CHECK(!shaderManager.enqueueWarmup("NoSuchShader"));
+    CORE_CHECK_EQUAL(shaderManager.getWarmupQueueLength(), 2u);
+
+    shaderManager.update();
+    CORE_CHECK_EQUAL(getBuildCount(), builds + 1);
+    CORE_CHECK_EQUAL(shaderManager.getWarmupQueueLength(), 1u);
+    shaderManager.update();
+    CORE_CHECK_EQUAL(getBuildCount(), builds + 2);
+    CORE_CHECK_EQUAL(shaderManager.getWarmupQueueLength(), 0u);
+
+    // warmed up variants are ready on first use, which is tracked but builds nothing more
+    CORE_CHECK_EQUAL(shaderManager.getRequestedShaderNames().size(), requested);
+    CORE_CHECK(shaderManager.requestShader("BasicTexturedLit", false));
+    CORE_CHECK_EQUAL(getBuildCount(), builds + 2);
+    CORE_CHECK(shaderManager.getRequestedShaderNames().back() == "BasicTexturedLit");
+    shaderManager.setWarmupBuildsPerUpdate(2);
+}
+
+int main(int argc, char** argv) {
+    Engine::setGraphicsBackend(GraphicsBackend::Null);
+    Engine::setLazyShaderCompilation(true);
+    Test::run("startup builds only the fallback shader", testStartupBuildsOnlyTheFallback);
+    Test::run("requested variants are tracked in first-use order", testRequestsAreTrackedInFirstUseOrder);
+    Test::run("background builds complete on a later update", testBackgroundBuildsCompleteLater);
+    Test::run("warmup builds are spread over frames", testWarmupIsSpreadOverFrames);
+    return Test::result();
+}
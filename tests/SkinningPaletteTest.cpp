@@ -0,0 +1,158 @@
+#include <cmath>
+#include <memory>
+#include <string.h>
+#include <vector>
+
+#include "TestUtil.h"
+#include "../animation/SkinningPalette.h"
+#include "../math/Matrix4x4.h"
+#include "../math/Quaternion.h"
+
+using namespace Core;
+
+// A skeleton node that is not attached to a scene object: its full transformation is its parent's
+// full transformation times its local one.
+class TestSkeletonNode: public Skeleton::SkeletonNode {
+public:
+    TestSkeletonNode(Int32 boneIndex, TestSkeletonNode * parent): SkeletonNode(boneIndex, "node"), parent(parent) {
+    }
+
+    Matrix4x4& getFullTransform() override {
+        this->fullTransform.copy(this->localTransform);
+        if (this->parent != nullptr) this->fullTransform.preMultiply(this->parent->getFullTransform());
+        return this->fullTransform;
+    }
+
+    Matrix4x4& getLocalTransform() override {
+        return this->localTransform;
+    }
+
+    Bool hasTarget() const override {
+        return false;
+    }
+
+    SkeletonNode * fullClone() const override {
+        return nullptr;
+    }
+
+    TestSkeletonNode * parent;
+    Matrix4x4 localTransform;
+    Matrix4x4 fullTransform;
+};
+
+class TestSkeleton {
+public:
+    std::vector<std::unique_ptr<TestSkeletonNode>> nodes;
+    std::vector<Matrix4x4> offsets;
+    std::vector<Skeleton::SkeletonNode *> boneNodes;
+    std::vector<const Matrix4x4 *> boneOffsets;
+};
+
+static Matrix4x4 makeTransform(Real seed) {
+    Matrix4x4 transform;
+    Quaternion rotation = Quaternion::fromAngleAxis(seed * 0.7f, std::sin(seed), std::cos(seed), 0.5f);
+    rotation.normalize();
+    transform.compose(Vector3r(std::sin(seed * 3.0f), 0.5f + seed * 0.01f, std::cos(seed * 2.0f)), rotation,
+                      Vector3r(1.0f + 0.1f * std::sin(seed), 1.0f, 1.0f - 0.05f * std::cos(seed)));
+    return transform;
+}
+
+// [boneCount] bones in a branching hierarchy; every seventh bone has no node.
+static void buildSkeleton(UInt32 boneCount, TestSkeleton& skeleton) {
+    skeleton.offsets.resize(boneCount);
+    skeleton.boneNodes.assign(boneCount, nullptr);
+    skeleton.boneOffsets.resize(boneCount);
+    for (UInt32 b = 0; b < boneCount; b++) {
+        skeleton.offsets[b] = makeTransform((Real)b + 100.0f);
+        skeleton.offsets[b].invert();
+        skeleton.boneOffsets[b] = &skeleton.offsets[b];
+        if (b % 7 == 6) continue;
+        TestSkeletonNode * parent = skeleton.nodes.empty() ? nullptr : skeleton.nodes[(skeleton.nodes.size() - 1) / 2].get();
+        skeleton.nodes.emplace_back(new TestSkeletonNode((Int32)b, parent));
+        skeleton.nodes.back()->localTransform = makeTransform((Real)b);
+        skeleton.boneNodes[b] = skeleton.nodes.back().get();
+    }
+}
+
+// The skinning matrix of [bone] as MeshRenderer::preProcess() computed it per node before the palette existed.
+static Matrix4x4 getReferenceMatrix(TestSkeleton& skeleton, UInt32 bone, const Matrix4x4& rootTransformInverse) {
+    Matrix4x4 temp;
+    temp.copy(skeleton.offsets[bone]);
+    temp.preMultiply(skeleton.boneNodes[bone]->getFullTransform());
+    temp.preMultiply(rootTransformInverse);
+    return temp;
+}
+
+static void testPaletteMatchesPerNodeComputation() {
+    const UInt32 boneCount = 200;
+    TestSkeleton skeleton;
+    buildSkeleton(boneCount, skeleton);
+    Matrix4x4 rootTransformInverse = makeTransform(42.0f);
+    rootTransformInverse.invert();
+
+    SkinningPalette palette;
+    palette.setBones(skeleton.boneNodes, skeleton.boneOffsets);
+    if (!CORE_CHECK_EQUAL(palette.getBoneCount(), boneCount)) return;
+    palette.compute(rootTransformInverse, 0, boneCount);
+
+    static const Real identity[] = {1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1};
+    UInt32 mismatches = 0;
+    for (UInt32 b = 0; b < boneCount; b++) {
+        const Real * matrix = palette.getMatrices() + b * 16;
+        if (skeleton.boneNodes[b] == nullptr) {
+            if (memcmp(matrix, identity, sizeof(identity)) != 0) mismatches++;
+            continue;
+        }
+        Matrix4x4 reference = getReferenceMatrix(skeleton, b, rootTransformInverse);
+        if (memcmp(matrix, reference.getConstData(), sizeof(Real) * 16) != 0) mismatches++;
+    }
+    CORE_CHECK_EQUAL(mismatches, 0u);
+}
+
+static void testPaletteRangesAreIndependent() {
+    const UInt32 boneCount = 64;
+    TestSkeleton skeleton;
+    buildSkeleton(boneCount, skeleton);
+    Matrix4x4 rootTransformInverse = makeTransform(7.0f);
+    rootTransformInverse.invert();
+
+    SkinningPalette whole;
+    whole.setBones(skeleton.boneNodes, skeleton.boneOffsets);
+    whole.compute(rootTransformInverse, 0, boneCount);
+
+    // computing the palette in disjoint ranges, in any order, gives the same result
+    SkinningPalette ranges;
+    ranges.setBones(skeleton.boneNodes, skeleton.boneOffsets);
+    ranges.compute(rootTransformInverse, 40, boneCount);
+    ranges.compute(rootTransformInverse, 0, 17);
+    ranges.compute(rootTransformInverse, 17, 40);
+    CORE_CHECK(memcmp(whole.getMatrices(), ranges.getMatrices(), sizeof(Real) * 16 * boneCount) == 0);
+
+    CORE_CHECK_THROWS(ranges.compute(rootTransformInverse, 0, boneCount + 1));
+    std::vector<const Matrix4x4 *> tooFewOffsets(skeleton.boneOffsets.begin(), skeleton.boneOffsets.end() - 1);
+    CORE_CHECK_THROWS(ranges.setBones(skeleton.boneNodes, tooFewOffsets));
+}
+
+static void testPaletteLiftsTheOldBoneCap() {
+    // the uniform array the palette replaced held at most 128 bones
+    const UInt32 boneCount = 300;
+    TestSkeleton skeleton;
+    buildSkeleton(boneCount, skeleton);
+    Matrix4x4 rootTransformInverse;
+    rootTransformInverse.setIdentity();
+
+    SkinningPalette palette;
+    palette.setBones(skeleton.boneNodes, skeleton.boneOffsets);
+    palette.compute(rootTransformInverse, 0, boneCount);
+    UInt32 last = boneCount - 1;
+    while (skeleton.boneNodes[last] == nullptr) last--;
+    Matrix4x4 reference = getReferenceMatrix(skeleton, last, rootTransformInverse);
+    CORE_CHECK(memcmp(palette.getMatrices() + last * 16, reference.getConstData(), sizeof(Real) * 16) == 0);
+}
+
+int main(int argc, char** argv) {
+    Test::run("palette matches the per-node skinning matrices", testPaletteMatchesPerNodeComputation);
+    Test::run("palette ranges are computed independently", testPaletteRangesAreIndependent);
+    Test::run("palette holds more than 128 bones", testPaletteLiftsTheOldBoneCap);
+    return Test::result();
+}
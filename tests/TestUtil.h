@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cmath>
+#include <cstdio>
+#include <exception>
+#include <string>
+
+#include "../common/types.h"
+
+// Minimal self-contained test harness: each test executable registers its cases with
+// Core::Test::run() and returns Core::Test::result() from main(), which ctest reports.
+
+#define CORE_CHECK(condition) Core::Test::check((condition), #condition, __FILE__, __LINE__)
+#define CORE_CHECK_EQUAL(a, b) Core::Test::check((a) == (b), #a " == " #b, __FILE__, __LINE__)
+#define CORE_CHECK_NEAR(a, b, epsilon) Core::Test::check(std::fabs((double)(a) - (double)(b)) <= (double)(epsilon), \
+                                                         #a " ~= " #b, __FILE__, __LINE__)
+#define CORE_CHECK_THROWS(expression) Core::Test::checkThrows([&]() { expression; }, #expression, __FILE__, __LINE__)
+
+namespace Core {
+
+    namespace Test {
+
+        inline UInt32& failureCount() {
+            static UInt32 count = 0;
+            return count;
+        }
+
+        inline Bool check(Bool passed, const char* expression, const char* file, Int32 line) {
+            if (!passed) {
+                printf("  FAILED: %s (%s:%d)\n", expression, file, line);
+                failureCount()++;
+            }
+            return passed;
+        }
+
+        template <typename Function>
+        Bool checkThrows(Function function, const char* expression, const char* file, Int32 line) {
+            try {
+                function();
+            } catch (...) {
+                return true;
+            }
+            return check(false, (std::string(expression) + " throws").c_str(), file, line);
+        }
+
+        template <typename Function>
+        void run(const char* name, Function function) {
+            UInt32 failuresBefore = failureCount();
+            try {
+                function();
+            } catch (const std::exception& e) {
+                printf("  FAILED: uncaught exception: %s\n", e.what());
+                failureCount()++;
+            } catch (...) {
+                printf("  FAILED: uncaught exception\n");
+                failureCount()++;
+            }
+            printf("%s %s\n", failureCount() == failuresBefore ? "[pass]" : "[FAIL]", name);
+        }
+
+        inline int result() {
+            if (failureCount() > 0) printf("%u check(s) failed\n", failureCount());
+            return failureCount() > 0 ? 1 : 0;
+        }
+    }
+}
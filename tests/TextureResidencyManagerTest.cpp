@@ -0,0 +1,197 @@
+#include <vector>
+
+#include "TestUtil.h"
+#include "../image/TextureResidencyManager.h"
+
+using namespace Core;
+
+typedef TextureResidencyManager::Request Request;
+typedef TextureResidencyManager::RequestType RequestType;
+
+static const Request* findRequest(const std::vector<Request>& requests, TextureResidencyManager::StreamID id, RequestType type) {
+    for (const Request& request : requests) {
+        if (request.id == id && request.type == type) return &request;
+    }
+    return nullptr;
+}
+
+// Carry out every load immediately, as TextureStreamer does once an image is decoded.
+static void completeLoads(TextureResidencyManager& manager, const std::vector<Request>& requests) {
+    for (const Request& request : requests) {
+        if (request.type == RequestType::Load) manager.completeLoad(request.id, request.mipLevel);
+    }
+}
+
+static UInt64 baselineBytes(UInt32 size) {
+    return TextureResidencyManager::calcResidentBytes(size, size, 4, TextureResidencyManager::calcBaselineMipLevel(size, size, 64));
+}
+
+int main(int argc, char** argv) {
+    Test::run("mip level helpers", []() {
+        CORE_CHECK_EQUAL(TextureResidencyManager::calcMipLevelCount(256, 256), 9u);
+        CORE_CHECK_EQUAL(TextureResidencyManager::calcMipLevelCount(256, 1), 9u);
+        CORE_CHECK_EQUAL(TextureResidencyManager::calcBaselineMipLevel(1024, 512, 64), 4u);
+        CORE_CHECK_EQUAL(TextureResidencyManager::calcBaselineMipLevel(32, 32, 64), 0u);
+        CORE_CHECK_EQUAL(TextureResidencyManager::calcDesiredMipLevel(1024, 1024, 300.0f), 1u);
+        CORE_CHECK_EQUAL(TextureResidencyManager::calcDesiredMipLevel(1024, 1024, 2000.0f), 0u);
+        CORE_CHECK_EQUAL(TextureResidencyManager::calcResidentBytes(4, 4, 4, 0), (UInt64)(64 + 16 + 4));
+        CORE_CHECK_EQUAL(TextureResidencyManager::calcResidentBytes(4, 4, 4, 1), (UInt64)(16 + 4));
+    });
+
+    Test::run("textures start at their baseline and load on demand", []() {
+        TextureResidencyManager manager(64 * 1024 * 1024);
+        TextureResidencyManager::StreamID id = manager.registerTexture(1024, 1024, 4, 4);
+        CORE_CHECK_EQUAL(manager.getResidentMipLevel(id), 4u);
+        CORE_CHECK_EQUAL(manager.getStatistics().residentBytes, baselineBytes(1024));
+
+        std::vector<Request> requests;
+        manager.update(requests);
+        CORE_CHECK_EQUAL(requests.size(), (size_t)0);
+
+        manager.reportScreenSize(id, 300.0f);
+        manager.update(requests);
+        const Request* load = findRequest(requests, id, RequestType::Load);
+        if (!CORE_CHECK(load != nullptr)) return;
+        CORE_CHECK_EQUAL(load->mipLevel, 1u);
+        CORE_CHECK(manager.isLoadPending(id));
+        CORE_CHECK_EQUAL(manager.getStatistics().pendingBytes,
+                         TextureResidencyManager::calcResidentBytes(1024, 1024, 4, 1) - baselineBytes(1024));
+
+        manager.completeLoad(id, load->mipLevel);
+        CORE_CHECK(!manager.isLoadPending(id));
+        CORE_CHECK_EQUAL(manager.getResidentMipLevel(id), 1u);
+        CORE_CHECK_EQUAL(manager.getStatistics().pendingBytes, (UInt64)0);
+        CORE_CHECK_EQUAL(manager.getStatistics().residentBytes, TextureResidencyManager::calcResidentBytes(1024, 1024, 4, 1));
+    });
+
+    Test::run("a cancelled load keeps the resident level", []() {
+        TextureResidencyManager manager(64 * 1024 * 1024);
+        TextureResidencyManager::StreamID id = manager.registerTexture(512, 512, 4, 3);
+        std::vector<Request> requests;
+        manager.reportScreenSize(id, 512.0f);
+        manager.update(requests);
+        CORE_CHECK(manager.isLoadPending(id));
+        manager.cancelLoad(id);
+        CORE_CHECK_EQUAL(manager.getResidentMipLevel(id), 3u);
+        CORE_CHECK_EQUAL(manager.getStatistics().pendingBytes, (UInt64)0);
+    });
+
+    Test::run("loads settle for a coarser level when the budget is short", []() {
+        UInt64 fullBytes = TextureResidencyManager::calcResidentBytes(1024, 1024, 4, 0);
+        UInt64 halfBytes = TextureResidencyManager::calcResidentBytes(1024, 1024, 4, 1);
+        TextureResidencyManager manager(halfBytes + (fullBytes - halfBytes) / 2);
+        TextureResidencyManager::StreamID id = manager.registerTexture(1024, 1024, 4, 4);
+        std::vector<Request> requests;
+        manager.reportScreenSize(id, 4096.0f);
+        manager.update(requests);
+        const Request* load = findRequest(requests, id, RequestType::Load);
+        if (!CORE_CHECK(load != nullptr)) return;
+        CORE_CHECK_EQUAL(load->mipLevel, 1u);
+    });
+
+    Test::run("least recently used textures are evicted to make room", []() {
+        UInt64 halfBytes = TextureResidencyManager::calcResidentBytes(1024, 1024, 4, 1);
+        TextureResidencyManager manager(halfBytes + baselineBytes(1024) + 1024);
+        TextureResidencyManager::StreamID a = manager.registerTexture(1024, 1024, 4, 4);
+        TextureResidencyManager::StreamID b = manager.registerTexture(1024, 1024, 4, 4);
+
+        std::vector<Request> requests;
+        manager.reportScreenSize(a, 512.0f);
+        manager.update(requests);
+        completeLoads(manager, requests);
+        CORE_CHECK_EQUAL(manager.getResidentMipLevel(a), 1u);
+
+        // 'a' is no longer drawn, 'b' now needs the memory
+        requests.clear();
+        manager.reportScreenSize(b, 512.0f);
+        manager.update(requests);
+        CORE_CHECK(findRequest(requests, a, RequestType::Evict) != nullptr);
+        CORE_CHECK(findRequest(requests, b, RequestType::Load) != nullptr);
+        CORE_CHECK_EQUAL(manager.getResidentMipLevel(a), 4u);
+        CORE_CHECK_EQUAL(manager.getStatistics().evictionCount, (UInt64)1);
+    });
+
+    Test::run("textures drawn this frame are not evicted", []() {
+        UInt64 halfBytes = TextureResidencyManager::calcResidentBytes(1024, 1024, 4, 1);
+        TextureResidencyManager manager(halfBytes + baselineBytes(1024) + 1024);
+        TextureResidencyManager::StreamID a = manager.registerTexture(1024, 1024, 4, 4);
+        TextureResidencyManager::StreamID b = manager.registerTexture(1024, 1024, 4, 4);
+
+        std::vector<Request> requests;
+        manager.reportScreenSize(a, 512.0f);
+        manager.update(requests);
+        completeLoads(manager, requests);
+
+        requests.clear();
+        manager.reportScreenSize(a, 512.0f);
+        manager.reportScreenSize(b, 512.0f);
+        manager.update(requests);
+        CORE_CHECK(findRequest(requests, a, RequestType::Evict) == nullptr);
+        CORE_CHECK_EQUAL(manager.getResidentMipLevel(a), 1u);
+        const Request* load = findRequest(requests, b, RequestType::Load);
+        CORE_CHECK(load == nullptr || load->mipLevel > 1);
+    });
+
+    Test::run("lowering the budget evicts down to it", []() {
+        TextureResidencyManager manager(64 * 1024 * 1024);
+        TextureResidencyManager::StreamID id = manager.registerTexture(1024, 1024, 4, 4);
+        std::vector<Request> requests;
+        manager.reportScreenSize(id, 1024.0f);
+        manager.update(requests);
+        completeLoads(manager, requests);
+        CORE_CHECK_EQUAL(manager.getResidentMipLevel(id), 0u);
+
+        // advance a frame without drawing it so that it becomes an eviction candidate
+        requests.clear();
+        manager.update(requests);
+        manager.setBudget(baselineBytes(1024));
+        requests.clear();
+        manager.update(requests);
+        CORE_CHECK(findRequest(requests, id, RequestType::Evict) != nullptr);
+        CORE_CHECK(manager.getStatistics().residentBytes <= manager.getBudget());
+    });
+
+    Test::run("pending loads are capped per update", []() {
+        TextureResidencyManager manager(256 * 1024 * 1024);
+        manager.setMaxPendingLoads(2);
+        std::vector<TextureResidencyManager::StreamID> ids;
+        for (UInt32 i = 0; i < 5; i++) ids.push_back(manager.registerTexture(256, 256, 4, 2));
+        std::vector<Request> requests;
+        for (auto id : ids) manager.reportScreenSize(id, 256.0f);
+        manager.update(requests);
+        CORE_CHECK_EQUAL(requests.size(), (size_t)2);
+        CORE_CHECK_EQUAL(manager.getStatistics().pendingLoadCount, 2u);
+    });
+
+    Test::run("simulated frames never exceed the budget", []() {
+        const UInt32 textureCount = 24;
+        UInt64 budget = 8 * 1024 * 1024;
+        TextureResidencyManager manager(budget);
+        std::vector<TextureResidencyManager::StreamID> ids;
+        for (UInt32 i = 0; i < textureCount; i++) {
+            UInt32 size = 256u << (i % 3);
+            ids.push_back(manager.registerTexture(size, size, 4, TextureResidencyManager::calcBaselineMipLevel(size, size, 64)));
+        }
+
+        UInt32 seed = 12345;
+        std::vector<Request> requests;
+        Bool withinBudget = true;
+        for (UInt32 frame = 0; frame < 300; frame++) {
+            for (UInt32 i = 0; i < textureCount; i++) {
+                seed = seed * 1664525u + 1013904223u;
+                if ((seed >> 28) < 6) manager.reportScreenSize(ids[i], (Real)((seed >> 8) % 1200));
+            }
+            requests.clear();
+            manager.update(requests);
+            TextureResidencyManager::Statistics stats = manager.getStatistics();
+            if (stats.residentBytes + stats.pendingBytes > budget) withinBudget = false;
+            // uploads are carried out before the next frame, as TextureStreamer does
+            completeLoads(manager, requests);
+        }
+        CORE_CHECK(withinBudget);
+        CORE_CHECK(manager.getStatistics().loadRequestCount > 0);
+        CORE_CHECK(manager.getStatistics().evictionCount > 0);
+    });
+
+    return Test::result();
+}
@@ -0,0 +1,163 @@
+#include <chrono>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "TestUtil.h"
+#include "../Engine.h"
+#include "../Null/GraphicsNull.h"
+#include "../image/Texture2D.h"
+#include "../image/TextureStreamer.h"
+#include "../math/Math.h"
+
+using namespace Core;
+
+// 128x64, so with a baseline size of 16 the baseline is level 3 (16x8) and levels 0 - 2 are streamed
+static const UInt32 ImageWidth = 128;
+static const UInt32 ImageHeight = 64;
+static const UInt32 BaselineMipLevel = 3;
+
+class TextureUpload {
+public:
+    UInt32 textureID;
+    UInt32 byteCount;
+};
+
+static std::string getFixturePath(const std::string& name) {
+    return std::string(CORE_TEST_FIXTURES_DIR) + "/" + name;
+}
+
+// The 2D texture uploads recorded since command 'first'.
+static std::vector<TextureUpload> getUploadsSince(UInt32 first) {
+    std::vector<TextureUpload> uploads;
+    const GraphicsCommandLog& log = GraphicsNull::getCommandLog();
+    for (UInt32 i = first; i < log.getCommandCount(); i++) {
+        const GraphicsCommand& command = log.getCommand(i);
+        if (command.type != GraphicsCommandType::Upload || command.detail != (UInt8)GraphicsResourceKind::Texture2D) continue;
+        TextureUpload upload;
+        upload.textureID = command.values[0];
+        upload.byteCount = command.values[1];
+        uploads.push_back(upload);
+    }
+    return uploads;
+}
+
+// Run frames until 'done' holds, giving the decode thread time to catch up; false if it never does.
+static Bool runFramesUntil(TextureStreamer& streamer, std::function<Bool()> done, std::function<void()> beforeFrame = nullptr) {
+    for (UInt32 i = 0; i < 2000; i++) {
+        if (beforeFrame) beforeFrame();
+        streamer.update();
+        if (done()) return true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return false;
+}
+
+static WeakPointer<Texture2D> loadStreamedTexture(TextureStreamer& streamer) {
+    TextureAttributes attributes;
+    attributes.Format = TextureFormat::RGBA8;
+    attributes.FilterMode = TextureFilter::TriLinear;
+    attributes.MipLevels = 8;
+    WeakPointer<Texture2D> texture = streamer.loadTexture(getFixturePath("gradient_128x64.png"), attributes, false);
+    runFramesUntil(streamer, [&streamer]() { return streamer.getStatistics().textureCount == 1; });
+    return texture;
+}
+
+static void testOnlyTheBaselineIsUploadedAndNothingIsKept() {
+    TextureStreamer streamer;
+    streamer.setEnabled(true);
+    streamer.setBaselineSize(16);
+    UInt32 first = GraphicsNull::getCommandLog().getCommandCount();
+    WeakPointer<Texture2D> texture = loadStreamedTexture(streamer);
+    if (!CORE_CHECK_EQUAL(streamer.getStatistics().textureCount, 1u)) return;
+
+    // the placeholder, an empty streamable texture, then levels 7 (1x1) up to 3 (16x8), coarsest first
+    std::vector<TextureUpload> uploads = getUploadsSince(first);
+    if (!CORE_CHECK_EQUAL((UInt32)uploads.size(), 7u)) return;
+    CORE_CHECK_EQUAL(uploads[1].byteCount, 0u);
+    const UInt32 expectedBytes[5] = {4, 8, 32, 128, 512};
+    for (UInt32 i = 0; i < 5; i++) {
+        CORE_CHECK_EQUAL(uploads[2 + i].byteCount, expectedBytes[i]);
+        CORE_CHECK_EQUAL(uploads[2 + i].textureID, (UInt32)texture->getTextureID());
+    }
+    CORE_CHECK_EQUAL(streamer.getStatistics().residentBytes,
+                     TextureResidencyManager::calcResidentBytes(ImageWidth, ImageHeight, 4, BaselineMipLevel));
+    // the decoded image isn't kept around once its baseline is uploaded
+    CORE_CHECK_EQUAL(streamer.getDecodedBytes(), 0ull);
+}
+
+static void testLoadsAreUploadedLevelByLevelUnderTheFrameLimit() {
+    TextureStreamer streamer;
+    streamer.setEnabled(true);
+    streamer.setBaselineSize(16);
+    streamer.setMaxUploadBytesPerFrame(8192);
+    WeakPointer<Texture2D> texture = loadStreamedTexture(streamer);
+    UInt32 textureID = (UInt32)texture->getTextureID();
+
+    std::vector<std::vector<TextureUpload>> frames;
+    UInt64 peakDecodedBytes = 0;
+    UInt32 first = GraphicsNull::getCommandLog().getCommandCount();
+    Bool loaded = runFramesUntil(streamer, [&]() {
+        std::vector<TextureUpload> uploads = getUploadsSince(first);
+        if (uploads.size() > 0) frames.push_back(uploads);
+        first = GraphicsNull::getCommandLog().getCommandCount();
+        peakDecodedBytes = Math::max(peakDecodedBytes, streamer.getDecodedBytes());
+        return streamer.getStatistics().residentBytes == TextureResidencyManager::calcResidentBytes(ImageWidth, ImageHeight, 4, 0);
+    }, [&]() { streamer.reportScreenSize(texture, (Real)ImageWidth); });
+    if (!CORE_CHECK(loaded)) return;
+
+    // level 2 (32x16) and level 1 (64x32) don't fit in one frame together, and level 0 (128x64) is
+    // over the limit on its own, so it gets a frame to itself
+    if (!CORE_CHECK_EQUAL((UInt32)frames.size(), 3u)) return;
+    CORE_CHECK_EQUAL((UInt32)frames[0].size(), 1u);
+    CORE_CHECK_EQUAL(frames[0][0].byteCount, 2048u);
+    CORE_CHECK_EQUAL((UInt32)frames[1].size(), 1u);
+    CORE_CHECK_EQUAL(frames[1][0].byteCount, 8192u);
+    CORE_CHECK_EQUAL((UInt32)frames[2].size(), 1u);
+    CORE_CHECK_EQUAL(frames[2][0].byteCount, 32768u);
+    // every level goes into the same texture object instead of rebuilding it
+    for (const std::vector<TextureUpload>& frame : frames) CORE_CHECK_EQUAL(frame[0].textureID, textureID);
+    CORE_CHECK_EQUAL((UInt32)texture->getTextureID(), textureID);
+
+    // only the streamed levels were held in memory, and only until they were uploaded
+    CORE_CHECK_EQUAL(peakDecodedBytes, 2048ull + 8192ull + 32768ull);
+    CORE_CHECK_EQUAL(streamer.getDecodedBytes(), 0ull);
+    CORE_CHECK_EQUAL(streamer.getStatistics().pendingLoadCount, 0u);
+}
+
+static void testEvictionKeepsTheTextureAndReloadsOnlyFinerLevels() {
+    TextureStreamer streamer;
+    streamer.setEnabled(true);
+    streamer.setBaselineSize(16);
+    WeakPointer<Texture2D> texture = loadStreamedTexture(streamer);
+    UInt32 textureID = (UInt32)texture->getTextureID();
+    UInt64 fullBytes = TextureResidencyManager::calcResidentBytes(ImageWidth, ImageHeight, 4, 0);
+    UInt64 baselineBytes = TextureResidencyManager::calcResidentBytes(ImageWidth, ImageHeight, 4, BaselineMipLevel);
+    auto reportFullSize = [&]() { streamer.reportScreenSize(texture, (Real)ImageWidth); };
+    if (!CORE_CHECK(runFramesUntil(streamer, [&]() { return streamer.getStatistics().residentBytes == fullBytes; }, reportFullSize))) return;
+
+    // lowering the budget drops the unused texture back to its baseline without uploading anything
+    UInt32 first = GraphicsNull::getCommandLog().getCommandCount();
+    streamer.setBudget(baselineBytes);
+    streamer.update();
+    CORE_CHECK_EQUAL(streamer.getStatistics().residentBytes, baselineBytes);
+    CORE_CHECK_EQUAL(streamer.getStatistics().evictionCount, 1ull);
+    CORE_CHECK_EQUAL((UInt32)getUploadsSince(first).size(), 0u);
+
+    // only the levels finer than the baseline are decoded and uploaded again
+    streamer.setBudget(fullBytes);
+    if (!CORE_CHECK(runFramesUntil(streamer, [&]() { return streamer.getStatistics().residentBytes == fullBytes; }, reportFullSize))) return;
+    std::vector<TextureUpload> uploads = getUploadsSince(first);
+    CORE_CHECK_EQUAL((UInt32)uploads.size(), 3u);
+    for (const TextureUpload& upload : uploads) CORE_CHECK_EQUAL(upload.textureID, textureID);
+}
+
+int main(int argc, char** argv) {
+    Engine::setGraphicsBackend(GraphicsBackend::Null);
+    Engine::instance();
+    Test::run("only the baseline levels are uploaded, and nothing is kept", testOnlyTheBaselineIsUploadedAndNothingIsKept);
+    Test::run("loads are uploaded level by level under the frame limit", testLoadsAreUploadedLevelByLevelUnderTheFrameLimit);
+    Test::run("eviction keeps the texture and reloads only the finer levels", testEvictionKeepsTheTextureAndReloadsOnlyFinerLevels);
+    return Test::result();
+}
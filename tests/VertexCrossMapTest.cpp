@@ -0,0 +1,153 @@
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "TestUtil.h"
+#include "../geometry/Mesh.h"
+#include "../geometry/Vector3.h"
+
+using namespace Core;
+
+class Grouping {
+public:
+    std::vector<UInt32> starts;
+    std::vector<UInt32> members;
+    std::vector<UInt32> vertexGroups;
+
+    UInt32 getGroupCount() const {
+        return (UInt32)this->starts.size() - 1;
+    }
+};
+
+static void group(const std::vector<Point3r>& positions, Grouping& grouping) {
+    Mesh::groupEqualPositions(positions.data(), (UInt32)positions.size(), grouping.starts, grouping.members);
+    grouping.vertexGroups.assign(positions.size(), 0xFFFFFFFF);
+    for (UInt32 g = 0; g < grouping.getGroupCount(); g++) {
+        for (UInt32 m = grouping.starts[g]; m < grouping.starts[g + 1]; m++) grouping.vertexGroups[grouping.members[m]] = g;
+    }
+}
+
+// Every position appears exactly once, members are ascending and groups are ordered by their first member.
+static Bool isWellFormed(const Grouping& grouping, UInt32 count) {
+    if (grouping.starts.size() < 2 || grouping.starts.front() != 0 || grouping.starts.back() != count) return false;
+    for (UInt32 v = 0; v < count; v++) {
+        if (grouping.vertexGroups[v] >= grouping.getGroupCount()) return false;
+    }
+    for (UInt32 g = 0; g < grouping.getGroupCount(); g++) {
+        if (grouping.starts[g + 1] <= grouping.starts[g]) return false;
+        for (UInt32 m = grouping.starts[g] + 1; m < grouping.starts[g + 1]; m++) {
+            if (grouping.members[m] <= grouping.members[m - 1]) return false;
+        }
+        if (g > 0 && grouping.members[grouping.starts[g]] <= grouping.members[grouping.starts[g - 1]]) return false;
+    }
+    return true;
+}
+
+static void testPositionsAcrossCellBoundaryAreGrouped() {
+    // 0.0099 and 0.0101 fall in different cells but are equal within the tolerance
+    std::vector<Point3r> positions = {Point3r(0.0099f, 1.0f, 1.0f), Point3r(0.0101f, 1.0f, 1.0f),
+                                      Point3r(-0.0001f, 2.0f, 2.0f), Point3r(0.0001f, 2.0f, 2.0f),
+                                      Point3r(0.0f, 3.0f, 3.0f), Point3r(0.0051f, 3.0f, 3.0f)};
+    Grouping grouping;
+    group(positions, grouping);
+    if (!CORE_CHECK(isWellFormed(grouping, (UInt32)positions.size()))) return;
+
+    CORE_CHECK_EQUAL(grouping.vertexGroups[0], grouping.vertexGroups[1]);
+    CORE_CHECK_EQUAL(grouping.vertexGroups[2], grouping.vertexGroups[3]);
+    // further apart than the tolerance
+    CORE_CHECK(grouping.vertexGroups[4] != grouping.vertexGroups[5]);
+    CORE_CHECK_EQUAL(grouping.getGroupCount(), 4u);
+}
+
+static void testPositionsAcrossCellCornerAreGrouped() {
+    const Real c = 0.01f * 20.0f;
+    std::vector<Point3r> positions;
+    for (UInt32 corner = 0; corner < 8; corner++) {
+        positions.push_back(Point3r(c + ((corner & 1) ? 0.0009f : -0.0009f),
+                                    c + ((corner & 2) ? 0.0009f : -0.0009f),
+                                    -c + ((corner & 4) ? 0.0009f : -0.0009f)));
+    }
+    Grouping grouping;
+    group(positions, grouping);
+    if (!CORE_CHECK(isWellFormed(grouping, (UInt32)positions.size()))) return;
+    CORE_CHECK_EQUAL(grouping.getGroupCount(), 1u);
+}
+
+// Tight clusters around well separated centres, placed so that many of them straddle cell boundaries:
+// every cluster must come out as exactly one group.
+static void testJitteredClustersMatchTheirCentres() {
+    const UInt32 clusterCount = 2000;
+    const UInt32 clusterSize = 6;
+    std::vector<Point3r> positions;
+    std::vector<UInt32> clusters;
+    UInt32 seed = 12345;
+    auto random = [&seed]() -> Real {
+        seed = seed * 1664525u + 1013904223u;
+        return (Real)(seed >> 8) / (Real)(1 << 24);
+    };
+    for (UInt32 i = 0; i < clusterCount * clusterSize; i++) {
+        UInt32 cluster = (UInt32)(random() * clusterCount) % clusterCount;
+        // centres 0.0525 apart, so every other one lies on a cell boundary
+        Real x = (Real)(cluster % 20) * 0.0525f - 0.5f;
+        Real y = (Real)((cluster / 20) % 10) * 0.0525f;
+        Real z = (Real)(cluster / 200) * 0.0525f - 0.25f;
+        positions.push_back(Point3r(x + (random() - 0.5f) * 0.002f, y + (random() - 0.5f) * 0.002f, z + (random() - 0.5f) * 0.002f));
+        clusters.push_back(cluster);
+    }
+
+    Grouping grouping;
+    group(positions, grouping);
+    if (!CORE_CHECK(isWellFormed(grouping, (UInt32)positions.size()))) return;
+
+    std::vector<UInt32> clusterGroups(clusterCount, 0xFFFFFFFF);
+    std::vector<UInt32> groupClusters(grouping.getGroupCount(), 0xFFFFFFFF);
+    UInt32 mismatches = 0;
+    for (UInt32 v = 0; v < positions.size(); v++) {
+        UInt32 cluster = clusters[v];
+        UInt32 g = grouping.vertexGroups[v];
+        if (clusterGroups[cluster] == 0xFFFFFFFF) clusterGroups[cluster] = g;
+        if (groupClusters[g] == 0xFFFFFFFF) groupClusters[g] = cluster;
+        if (clusterGroups[cluster] != g || groupClusters[g] != cluster) mismatches++;
+    }
+    CORE_CHECK_EQUAL(mismatches, 0u);
+}
+
+static void testEveryMemberEqualsItsGroupLeader() {
+    std::vector<Point3r> positions;
+    for (UInt32 i = 0; i < 5000; i++) {
+        Real t = (Real)i * 0.0013f;
+        positions.push_back(Point3r(std::sin(t) * 0.05f, std::cos(t * 0.7f) * 0.05f, t * 0.001f));
+    }
+    Grouping grouping;
+    group(positions, grouping);
+    if (!CORE_CHECK(isWellFormed(grouping, (UInt32)positions.size()))) return;
+
+    Vector3Base<Real>::Eq equal;
+    UInt32 unequal = 0;
+    for (UInt32 v = 0; v < positions.size(); v++) {
+        UInt32 leader = grouping.members[grouping.starts[grouping.vertexGroups[v]]];
+        if (!equal(positions[leader], positions[v])) unequal++;
+    }
+    CORE_CHECK_EQUAL(unequal, 0u);
+}
+
+static void testNonFinitePositionsStayAlone() {
+    const Real nan = std::numeric_limits<Real>::quiet_NaN();
+    const Real infinity = std::numeric_limits<Real>::infinity();
+    std::vector<Point3r> positions = {Point3r(nan, 0.0f, 0.0f), Point3r(nan, 0.0f, 0.0f), Point3r(infinity, 0.0f, 0.0f),
+                                      Point3r(infinity, 0.0f, 0.0f), Point3r(1.0f, 1.0f, 1.0f), Point3r(1.0f, 1.0f, 1.0f)};
+    Grouping grouping;
+    group(positions, grouping);
+    if (!CORE_CHECK(isWellFormed(grouping, (UInt32)positions.size()))) return;
+    CORE_CHECK_EQUAL(grouping.getGroupCount(), 5u);
+    CORE_CHECK_EQUAL(grouping.vertexGroups[4], grouping.vertexGroups[5]);
+}
+
+int main(int argc, char** argv) {
+    Test::run("positions across a cell boundary are grouped", testPositionsAcrossCellBoundaryAreGrouped);
+    Test::run("positions across a cell corner are grouped", testPositionsAcrossCellCornerAreGrouped);
+    Test::run("jittered clusters map one to one onto groups", testJitteredClustersMatchTheirCentres);
+    Test::run("every member equals its group leader", testEveryMemberEqualsItsGroupLeader);
+    Test::run("non-finite positions are never grouped", testNonFinitePositionsStayAlone);
+    return Test::result();
+}
@@ -0,0 +1,28 @@
+#version 330
+uniform vec4 colors[4];
+float shadow_0_0(vec4 pos) {
+    int offset = 0 * 3 + 0;
+    return shadowMaps[0].x + float(offset);
+}
+float shadow_0_1(vec4 pos) {
+    int offset = 0 * 3 + 1;
+    return shadowMaps[0].x + float(offset);
+}
+vec4 lightColor0() {
+    return colors[0];
+}
+float shadow_2_0(vec4 pos) {
+    int offset = 2 * 3 + 0;
+    return shadowMaps[2].x + float(offset);
+}
+float shadow_2_1(vec4 pos) {
+    int offset = 2 * 3 + 1;
+    return shadowMaps[2].x + float(offset);
+}
+vec4 lightColor2() {
+    return colors[2];
+}
+out vec4 color;
+void main() {
+    color = lightColor0() + lightColor2();
+}
@@ -0,0 +1,87 @@
+// Build step that expands the engine's shader sources ahead of time (see
+// ShaderManager::savePreprocessedSources()). Needs no GL context.
+//
+//   PreprocessShaders <output>          write the preprocessed sources to <output>
+//   PreprocessShaders --verify <file>   check that <file> matches the runtime expansion of the current sources
+//
+// Matching the runtime expansion only shows that <file> is current, since both come from the same expander.
+// The expansion itself is checked against hand-written fixtures by tests/ShaderPreprocessTest.cpp; here every
+// preprocessed source is also checked for leftovers of an incomplete expansion.
+
+#include <stdio.h>
+#include <string.h>
+
+#include "../GL/ShaderManagerGL.h"
+
+using namespace Core;
+
+// Returns the first line of [source] that still holds an include directive or a parameter reference, or an
+// empty string if the expansion is complete.
+static std::string findUnexpandedLine(const std::string& source) {
+    size_t start = 0;
+    while (start < source.size()) {
+        size_t end = source.find('\n', start);
+        if (end == std::string::npos) end = source.size();
+        std::string line = source.substr(start, end - start);
+        if (line.find("#include") != std::string::npos || line.find('@') != std::string::npos) return line;
+        start = end + 1;
+    }
+    return std::string();
+}
+
+static int verify(const std::string& path) {
+    ShaderManagerGL runtimeManager;
+    runtimeManager.init();
+    ShaderManagerGL preprocessedManager;
+    preprocessedManager.init();
+    if (!preprocessedManager.loadPreprocessedSources(path)) {
+        fprintf(stderr, "%s is missing, damaged or was written from different shader sources.\n", path.c_str());
+        return 1;
+    }
+
+    UInt32 mismatches = 0;
+    const ShaderType types[] = {ShaderType::Vertex, ShaderType::Geometry, ShaderType::Fragment};
+    const char* typeNames[] = {"vertex", "geometry", "fragment"};
+    for (const std::string& name : runtimeManager.getProgramNames()) {
+        for (UInt32 t = 0; t < 3; t++) {
+            if (!runtimeManager.hasShaderSource(types[t], name)) continue;
+            // read the file's entry directly: getShaderSource() would fall back to the runtime expansion
+            std::string preprocessed;
+            if (!preprocessedManager.getPreprocessedSource(types[t], name, preprocessed)) {
+                fprintf(stderr, "Preprocessed %s shader of %s is missing.\n", typeNames[t], name.c_str());
+                mismatches++;
+                continue;
+            }
+            if (runtimeManager.getShaderSource(types[t], name) != preprocessed) {
+                fprintf(stderr, "Preprocessed %s shader of %s differs from the runtime expansion.\n", typeNames[t], name.c_str());
+                mismatches++;
+            }
+            std::string unexpanded = findUnexpandedLine(preprocessed);
+            if (unexpanded.size() > 0) {
+                fprintf(stderr, "Preprocessed %s shader of %s is not fully expanded: %s\n", typeNames[t], name.c_str(), unexpanded.c_str());
+                mismatches++;
+            }
+        }
+    }
+    if (mismatches > 0) return 1;
+    printf("%u shader programs match the runtime expansion.\n", (unsigned)runtimeManager.getProgramNames().size());
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc == 3 && strcmp(argv[1], "--verify") == 0) {
+        return verify(argv[2]);
+    }
+    if (argc != 2) {
+        fprintf(stderr, "usage: %s <output> | --verify <file>\n", argv[0]);
+        return 2;
+    }
+
+    ShaderManagerGL shaderManager;
+    shaderManager.init();
+    if (!shaderManager.savePreprocessedSources(argv[1])) {
+        fprintf(stderr, "Could not write %s\n", argv[1]);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,117 @@
+#include "FrameArena.h"
+#include "../common/Exception.h"
+
+namespace Core {
+
+    FrameArena::FrameArena(UInt64 chunkSize) {
+        this->chunkSize = chunkSize > 0 ? chunkSize : 1024;
+        this->currentChunk = 0;
+        this->currentOffset = 0;
+        this->bytesUsed = 0;
+        this->framePeakBytes = 0;
+        this->peakBytes = 0;
+        this->steadyStateBytes = 0;
+        this->capacity = 0;
+        this->resetCount = 0;
+    }
+
+    FrameArena::~FrameArena() {
+        this->reset();
+        for (UInt32 i = 0; i < this->chunks.size(); i++) {
+            delete[] this->chunks[i].data;
+        }
+        this->chunks.clear();
+    }
+
+    void* FrameArena::allocate(UInt64 size, UInt64 alignment) {
+        if (alignment == 0 || (alignment & (alignment - 1)) != 0) {
+            throw InvalidArgumentException("FrameArena::allocate() -> 'alignment' must be a power of two.");
+        }
+        while (true) {
+            if (this->currentChunk < this->chunks.size()) {
+                Chunk& chunk = this->chunks[this->currentChunk];
+                UInt64 address = (UInt64)(chunk.data + this->currentOffset);
+                UInt64 padding = (alignment - (address & (alignment - 1))) & (alignment - 1);
+                if (this->currentOffset + padding + size <= chunk.size) {
+                    void* result = chunk.data + this->currentOffset + padding;
+                    this->currentOffset += padding + size;
+                    this->bytesUsed += padding + size;
+                    if (this->bytesUsed > this->framePeakBytes) this->framePeakBytes = this->bytesUsed;
+                    return result;
+                }
+                if (this->currentChunk + 1 < this->chunks.size()) {
+                    this->currentChunk++;
+                    this->currentOffset = 0;
+                    continue;
+                }
+            }
+            this->addChunk(size + alignment);
+            this->currentChunk = this->chunks.size() - 1;
+            this->currentOffset = 0;
+        }
+    }
+
+    void FrameArena::reset() {
+        for (UInt32 i = 0; i < this->destructors.size(); i++) {
+            Destructor& destructor = this->destructors[i];
+            destructor.destroy(destructor.objects, destructor.count);
+        }
+        this->destructors.resize(0);
+
+        if (this->framePeakBytes > this->peakBytes) this->peakBytes = this->framePeakBytes;
+        // exponential moving average of per-frame peaks, weighted so that spikes decay within a few dozen frames
+        this->steadyStateBytes = (this->steadyStateBytes * 15 + this->framePeakBytes) / 16;
+
+        this->trimChunks(this->framePeakBytes);
+        this->currentChunk = 0;
+        this->currentOffset = 0;
+        this->bytesUsed = 0;
+        this->framePeakBytes = 0;
+        this->resetCount++;
+    }
+
+    FrameArena::Statistics FrameArena::getStatistics() const {
+        Statistics stats;
+        stats.bytesUsed = this->bytesUsed;
+        stats.framePeakBytes = this->framePeakBytes;
+        stats.peakBytes = this->framePeakBytes > this->peakBytes ? this->framePeakBytes : this->peakBytes;
+        stats.steadyStateBytes = this->steadyStateBytes;
+        stats.capacity = this->capacity;
+        stats.chunkCount = this->chunks.size();
+        return stats;
+    }
+
+    // Incremented by every reset(), so holders of arena memory can tell when it has been released.
+    UInt64 FrameArena::getResetCount() const {
+        return this->resetCount;
+    }
+
+    void FrameArena::addChunk(UInt64 minSize) {
+        // grow geometrically so that a large frame needs only a handful of chunks
+        UInt64 size = this->capacity > this->chunkSize ? this->capacity : this->chunkSize;
+        Chunk chunk;
+        chunk.size = minSize > size ? minSize : size;
+        chunk.data = new Byte[chunk.size];
+        this->chunks.push_back(chunk);
+        this->capacity += chunk.size;
+    }
+
+    // Releases trailing chunks that neither the last frame nor the steady-state usage needs. The
+    // first chunk is always kept so that small frames never touch the system allocator.
+    void FrameArena::trimChunks(UInt64 lastFramePeakBytes) {
+        UInt64 retain = this->steadyStateBytes * 2;
+        if (lastFramePeakBytes > retain) retain = lastFramePeakBytes;
+        UInt64 retained = 0;
+        UInt32 keepCount = 0;
+        while (keepCount < this->chunks.size() && (keepCount == 0 || retained < retain)) {
+            retained += this->chunks[keepCount].size;
+            keepCount++;
+        }
+        while (this->chunks.size() > keepCount) {
+            Chunk& chunk = this->chunks.back();
+            this->capacity -= chunk.size;
+            delete[] chunk.data;
+            this->chunks.pop_back();
+        }
+    }
+}
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <vector>
+#include <new>
+#include <cstddef>
+#include <type_traits>
+
+#include "../common/types.h"
+
+namespace Core {
+
+    // Linear (bump) allocator for data that only lives until the end of a frame. reset() releases
+    // everything at once; it is O(1) unless objects with non-trivial destructors were created,
+    // in which case only those objects are destroyed. Chunks that are not needed for the recent
+    // steady-state usage are released on reset, so a one-off spike does not pin memory forever.
+    class FrameArena final {
+    public:
+
+        class Statistics {
+        public:
+            Statistics() {
+                this->bytesUsed = 0;
+                this->framePeakBytes = 0;
+                this->peakBytes = 0;
+                this->steadyStateBytes = 0;
+                this->capacity = 0;
+                this->chunkCount = 0;
+            }
+
+            UInt64 bytesUsed;
+            UInt64 framePeakBytes;
+            UInt64 peakBytes;
+            UInt64 steadyStateBytes;
+            UInt64 capacity;
+            UInt32 chunkCount;
+        };
+
+        FrameArena(UInt64 chunkSize = 64 * 1024);
+        ~FrameArena();
+        FrameArena(const FrameArena&) = delete;
+        FrameArena& operator =(const FrameArena&) = delete;
+
+        void* allocate(UInt64 size, UInt64 alignment);
+        void reset();
+        Statistics getStatistics() const;
+        UInt64 getResetCount() const;
+
+        template <typename T>
+        T* allocateArray(UInt32 count) {
+            static_assert(std::is_trivially_destructible<T>::value, "FrameArena::allocateArray() -> Type must be trivially destructible, use create().");
+            return static_cast<T*>(this->allocate(sizeof(T) * count, alignof(T)));
+        }
+
+        // Constructs 'count' instances of T from 'args'. Objects with non-trivial destructors are
+        // destroyed when the arena is reset.
+        template <typename T, typename... Args>
+        T* create(UInt32 count = 1, const Args&... args) {
+            T* objects = static_cast<T*>(this->allocate(sizeof(T) * count, alignof(T)));
+            for (UInt32 i = 0; i < count; i++) new (objects + i) T(args...);
+            if (!std::is_trivially_destructible<T>::value) {
+                Destructor destructor;
+                destructor.objects = objects;
+                destructor.count = count;
+                destructor.destroy = &FrameArena::destroyObjects<T>;
+                this->destructors.push_back(destructor);
+            }
+            return objects;
+        }
+
+    private:
+
+        class Chunk {
+        public:
+            Byte* data;
+            UInt64 size;
+        };
+
+        class Destructor {
+        public:
+            void* objects;
+            UInt32 count;
+            void (*destroy)(void*, UInt32);
+        };
+
+        template <typename T>
+        static void destroyObjects(void* objects, UInt32 count) {
+            T* typed = static_cast<T*>(objects);
+            for (UInt32 i = 0; i < count; i++) typed[i].~T();
+        }
+
+        void addChunk(UInt64 minSize);
+        void trimChunks(UInt64 lastFramePeakBytes);
+
+        UInt64 chunkSize;
+        std::vector<Chunk> chunks;
+        std::vector<Destructor> destructors;
+        UInt32 currentChunk;
+        UInt64 currentOffset;
+        UInt64 bytesUsed;
+        UInt64 framePeakBytes;
+        UInt64 peakBytes;
+        UInt64 steadyStateBytes;
+        UInt64 capacity;
+        UInt64 resetCount;
+    };
+
+    // Standard allocator for containers that only live until the end of a frame. Memory comes from
+    // [arena] and is never freed individually, so a container using it must be destroyed before the
+    // arena is reset (e.g. by creating the container itself with FrameArena::create()). Without an
+    // arena it falls back to the heap.
+    template <typename T>
+    class FrameArenaAllocator {
+    public:
+        typedef T value_type;
+
+        FrameArenaAllocator(FrameArena* arena = nullptr): arena(arena) {
+        }
+
+        template <typename U>
+        FrameArenaAllocator(const FrameArenaAllocator<U>& other): arena(other.getArena()) {
+        }
+
+        T* allocate(std::size_t count) {
+            if (this->arena) return static_cast<T*>(this->arena->allocate(sizeof(T) * count, alignof(T)));
+            return static_cast<T*>(::operator new(sizeof(T) * count));
+        }
+
+        void deallocate(T* pointer, std::size_t count) {
+            if (!this->arena) ::operator delete(pointer);
+        }
+
+        FrameArena* getArena() const {
+            return this->arena;
+        }
+
+    private:
+        FrameArena* arena;
+    };
+
+    template <typename T, typename U>
+    Bool operator ==(const FrameArenaAllocator<T>& a, const FrameArenaAllocator<U>& b) {
+        return a.getArena() == b.getArena();
+    }
+
+    template <typename T, typename U>
+    Bool operator !=(const FrameArenaAllocator<T>& a, const FrameArenaAllocator<U>& b) {
+        return a.getArena() != b.getArena();
+    }
+}
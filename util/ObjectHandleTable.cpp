@@ -0,0 +1,73 @@
+#include <vector>
+
+#include "ObjectHandleTable.h"
+#include "../common/Exception.h"
+
+namespace Core {
+
+    std::atomic<UInt32> ObjectHandleTable::slots[ObjectHandleTable::MaxHandles];
+    std::atomic<UInt32> ObjectHandleTable::nextUnusedIndex(1);
+    std::atomic<UInt32> ObjectHandleTable::liveHandleCount(0);
+    std::mutex ObjectHandleTable::tableMutex;
+
+    // Function-local so that objects created during static initialization can still acquire handles.
+    static std::vector<UInt32>& getFreeIndices() {
+        static std::vector<UInt32> freeIndices;
+        return freeIndices;
+    }
+
+    // Trivially destructible, so objects released during thread or static teardown can still use it.
+    static thread_local UInt32 localFreeIndices[ObjectHandleTable::LocalFreeIndexCapacity];
+    static thread_local UInt32 localFreeIndexCount = 0;
+
+    ObjectHandle ObjectHandleTable::acquire() {
+        if (localFreeIndexCount == 0) {
+            std::lock_guard<std::mutex> lock(tableMutex);
+            std::vector<UInt32>& freeIndices = getFreeIndices();
+            while (freeIndices.size() > 0 && localFreeIndexCount < FreeIndexBatchSize) {
+                localFreeIndices[localFreeIndexCount++] = freeIndices.back();
+                freeIndices.pop_back();
+            }
+        }
+
+        UInt32 index;
+        UInt32 generation;
+        if (localFreeIndexCount > 0) {
+            index = localFreeIndices[--localFreeIndexCount];
+            generation = slots[index].load(std::memory_order_relaxed);
+        }
+        else {
+            index = nextUnusedIndex.fetch_add(1, std::memory_order_relaxed);
+            if (index >= MaxHandles) {
+                throw AllocationException("ObjectHandleTable::acquire() -> Handle table is full.");
+            }
+            // no handle has been issued for a fresh index yet, so nothing can be checking its slot
+            generation = 1;
+            slots[index].store(generation, std::memory_order_relaxed);
+        }
+        liveHandleCount.fetch_add(1, std::memory_order_relaxed);
+        return ObjectHandle(index, generation);
+    }
+
+    void ObjectHandleTable::release(const ObjectHandle& handle) {
+        if (handle.isNull()) return;
+        std::atomic<UInt32>& generation = slots[handle.index];
+        UInt32 nextGeneration = handle.generation + 1;
+        UInt32 expected = handle.generation;
+        if (!generation.compare_exchange_strong(expected, nextGeneration, std::memory_order_release, std::memory_order_relaxed)) return;
+        liveHandleCount.fetch_sub(1, std::memory_order_relaxed);
+
+        if (localFreeIndexCount == LocalFreeIndexCapacity) {
+            std::lock_guard<std::mutex> lock(tableMutex);
+            std::vector<UInt32>& freeIndices = getFreeIndices();
+            while (localFreeIndexCount > LocalFreeIndexCapacity - FreeIndexBatchSize) {
+                freeIndices.push_back(localFreeIndices[--localFreeIndexCount]);
+            }
+        }
+        localFreeIndices[localFreeIndexCount++] = handle.index;
+    }
+
+    UInt32 ObjectHandleTable::getLiveHandleCount() {
+        return liveHandleCount.load(std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <atomic>
+#include <mutex>
+
+#include "../common/types.h"
+
+// When enabled, CoreObject instances acquire a generational handle from the ObjectHandleTable, and
+// weak pointers to them are validated against it, which also catches destroyed objects. Off by
+// default: the table load makes a check slower than the std::weak_ptr emptiness test it replaces, and
+// acquiring handles makes creating a CoreObject several times slower (see benchmarks/WeakPointerBenchmark.cpp).
+//#define __CORE_WEAK_POINTER_USE_HANDLES true
+
+namespace Core {
+
+    // An index into the global handle table combined with the generation of the slot at
+    // the time the handle was issued. A handle is alive for as long as the generation stored
+    // in its slot matches the generation stored in the handle.
+    class ObjectHandle {
+    public:
+        // Index 0 is never issued, so its slot always holds 0 and a null handle is never alive.
+        static const UInt32 NullGeneration = 0xFFFFFFFF;
+
+        ObjectHandle(): index(0), generation(NullGeneration) {
+        }
+
+        ObjectHandle(UInt32 index, UInt32 generation): index(index), generation(generation) {
+        }
+
+        Bool isNull() const {
+            return this->index == 0;
+        }
+
+        UInt32 index;
+        UInt32 generation;
+    };
+
+    class ObjectHandleTable final {
+    public:
+        // The slots are a single zero-initialized static array, so checking a handle needs no
+        // chunk lookup. Only the pages holding issued slots are ever touched.
+        static const UInt32 MaxHandles = 1 << 22;
+
+        // Freed indices are kept in a small per-thread cache and only exchanged with the shared
+        // free list in batches, so acquire() and release() take the table mutex once every
+        // FreeIndexBatchSize calls at most. Indices cached by a thread that exits are not reused.
+        static const UInt32 LocalFreeIndexCapacity = 64;
+        static const UInt32 FreeIndexBatchSize = 32;
+
+        static ObjectHandle acquire();
+        static void release(const ObjectHandle& handle);
+        static UInt32 getLiveHandleCount();
+
+        // A single atomic load and compare; safe to call from any thread. Null handles are never
+        // alive, so callers don't need to check for them first.
+        static Bool isAlive(UInt32 index, UInt32 generation) {
+            return slots[index].load(std::memory_order_acquire) == generation;
+        }
+
+        static Bool isAlive(const ObjectHandle& handle) {
+            return isAlive(handle.index, handle.generation);
+        }
+
+    private:
+        ObjectHandleTable();
+
+        static std::atomic<UInt32> slots[MaxHandles];
+        static std::atomic<UInt32> nextUnusedIndex;
+        static std::atomic<UInt32> liveHandleCount;
+        static std::mutex tableMutex;
+    };
+}
@@ -1,22 +1,112 @@
 #pragma once
 
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <type_traits>
 #include <vector>
-#include <unordered_map>
+#include <mutex>
 
 #include "../common/types.h"
 
 namespace Core {
 
+    // Growable slab pool. Objects are default-constructed once, when the slab that holds them
+    // is allocated, and are reused (not re-constructed) across acquire/return cycles. Slabs are
+    // never moved or freed before the pool is destroyed, so acquired objects have stable addresses.
+    // Free slots are kept on an intrusive singly-linked list, so acquire and return are O(1).
     template <typename T> class ObjectPool final {
+    private:
+        class Slot;
+
     public:
-        ObjectPool(UInt32 initialCapacity) {
+
+        class Statistics {
+        public:
+            Statistics() {
+                this->capacity = 0;
+                this->liveCount = 0;
+                this->peakLiveCount = 0;
+                this->slabCount = 0;
+                this->acquireCount = 0;
+                this->returnCount = 0;
+            }
+
+            UInt32 capacity;
+            UInt32 liveCount;
+            UInt32 peakLiveCount;
+            UInt32 slabCount;
+            UInt64 acquireCount;
+            UInt64 returnCount;
+        };
+
+        // Per-thread front end for a thread-safe pool: objects are moved between the cache and the
+        // pool in batches, so the pool's lock is only taken once per batch. returnAll() returns the
+        // objects held in caches too: a cache discards them the next time it is used. It must not
+        // be called while other threads are acquiring objects through caches.
+        class ThreadCache final {
+        public:
+            ThreadCache(ObjectPool<T>& pool, UInt32 batchSize = 32): pool(pool), batchSize(batchSize), epoch(0) {
+                this->cached.reserve(batchSize * 2);
+            }
+
+            ~ThreadCache() {
+                this->flush();
+            }
+
+            T& acquireObject() {
+                this->discardIfStale();
+                if (this->cached.size() == 0) this->epoch = this->pool.acquireBatch(this->batchSize, this->cached);
+                T* object = this->cached.back();
+                this->cached.pop_back();
+                return *object;
+            }
+
+            void returnObject(const T& object) {
+                this->discardIfStale();
+                // objects acquired before the last returnAll() are already back in the pool
+                if (Slot::fromObject(object)->epoch.load(std::memory_order_relaxed) != this->epoch) return;
+                this->cached.push_back(const_cast<T*>(&object));
+                if (this->cached.size() >= this->batchSize * 2) {
+                    this->pool.returnBatch(this->cached, this->batchSize);
+                }
+            }
+
+            void flush() {
+                this->discardIfStale();
+                this->pool.returnBatch(this->cached, (UInt32)this->cached.size());
+            }
+
+        private:
+            void discardIfStale() {
+                UInt32 poolEpoch = this->pool.epoch.load(std::memory_order_acquire);
+                if (poolEpoch == this->epoch) return;
+                this->cached.clear();
+                this->epoch = poolEpoch;
+            }
+
+            ObjectPool<T>& pool;
+            UInt32 batchSize;
+            UInt32 epoch;
+            std::vector<T*> cached;
+        };
+
+        ObjectPool(UInt32 initialCapacity, Bool threadSafe = false) {
             this->capacity = 0;
             this->size = 0;
-            this->increaseCapacity(initialCapacity);
+            this->peakSize = 0;
+            this->acquireCount = 0;
+            this->returnCount = 0;
+            this->epoch = 1;
+            this->threadSafe = threadSafe;
+            this->freeList = nullptr;
+            this->bumpSlab = 0;
+            this->bumpIndex = 0;
+            this->increaseCapacity(initialCapacity > 0 ? initialCapacity : 1);
         }
 
         ObjectPool(): ObjectPool(32) {
-            
+
         }
 
         ~ObjectPool() {
@@ -24,58 +114,173 @@ namespace Core {
         }
 
         UInt32 getCapacity() {
+            std::unique_lock<std::mutex> lock(this->poolMutex, std::defer_lock);
+            if (this->threadSafe) lock.lock();
             return this->capacity;
         }
 
+        UInt32 getSize() {
+            std::unique_lock<std::mutex> lock(this->poolMutex, std::defer_lock);
+            if (this->threadSafe) lock.lock();
+            return this->size;
+        }
+
+        Statistics getStatistics() {
+            if (this->threadSafe) {
+                std::lock_guard<std::mutex> lock(this->poolMutex);
+                return this->getStatisticsUnlocked();
+            }
+            return this->getStatisticsUnlocked();
+        }
+
         T& acquireObject() {
-            if (this->size >= this->capacity) this->increaseCapacity();
-            UInt32 nextFreeLocation = this->nextFreeLocations.back();
-            StorageDesc storageDesc = this->storageMap[nextFreeLocation];
-            this->nextFreeLocations.pop_back();
-            T& targetObj = this->objects[storageDesc.array][storageDesc.index];
-            this->size++;
-            return targetObj;
+            if (this->threadSafe) {
+                std::lock_guard<std::mutex> lock(this->poolMutex);
+                return this->acquireSlot()->getObject();
+            }
+            return this->acquireSlot()->getObject();
         }
 
         void returnObject(const T& object) {
-            if (this->objectLocations.find(&object) != this->objectLocations.end()) {
-                UInt32 returnLocation = this->objectLocations[&object];
-                this->nextFreeLocations.push_back(returnLocation);
-                this->size--;
+            if (this->threadSafe) {
+                std::lock_guard<std::mutex> lock(this->poolMutex);
+                this->returnSlot(Slot::fromObject(object));
+                return;
             }
-        }   
+            this->returnSlot(Slot::fromObject(object));
+        }
 
+        // Returns every acquired object to the pool in O(1) by invalidating the current epoch.
         void returnAll() {
-            this->objectLocations.clear();
-            this->size = 0;
-            this->nextFreeLocations.clear();
-            this->setupNextFreeLocations(0, this->capacity);
+            if (this->threadSafe) {
+                std::lock_guard<std::mutex> lock(this->poolMutex);
+                this->returnAllUnlocked();
+                return;
+            }
+            this->returnAllUnlocked();
+        }
+
+        // Returns the epoch the objects were acquired in.
+        UInt32 acquireBatch(UInt32 count, std::vector<T*>& dest) {
+            std::unique_lock<std::mutex> lock(this->poolMutex, std::defer_lock);
+            if (this->threadSafe) lock.lock();
+            for (UInt32 i = 0; i < count; i++) {
+                dest.push_back(&this->acquireSlot()->getObject());
+            }
+            return this->epoch.load(std::memory_order_relaxed);
+        }
+
+        // Returns the last 'count' objects in 'src' to the pool and removes them from 'src'.
+        void returnBatch(std::vector<T*>& src, UInt32 count) {
+            std::unique_lock<std::mutex> lock(this->poolMutex, std::defer_lock);
+            if (this->threadSafe) lock.lock();
+            for (UInt32 i = 0; i < count && src.size() > 0; i++) {
+                this->returnSlot(Slot::fromObject(*src.back()));
+                src.pop_back();
+            }
         }
 
     private:
 
-        class StorageDesc {
-            public:
-            StorageDesc() {}
-            StorageDesc(UInt32 array, UInt32 index) {
-                this->array = array;
-                this->index = index;
+        // The object lives in raw storage at the start of the slot, which keeps Slot standard-layout
+        // whatever T is, so an object's address is also its slot's address.
+        class Slot {
+        public:
+            Slot(): epoch(0) {
+                this->nextFree = nullptr;
+                new (this->storage) T();
+            }
+
+            ~Slot() {
+                this->getObject().~T();
+            }
+
+            Slot(const Slot& other) = delete;
+            Slot& operator =(const Slot& other) = delete;
+
+            T& getObject() {
+                return *reinterpret_cast<T*>(this->storage);
+            }
+
+            static Slot* fromObject(const T& object) {
+                static_assert(std::is_standard_layout<Slot>::value, "ObjectPool::Slot must be standard-layout.");
+                static_assert(offsetof(Slot, storage) == 0, "ObjectPool::Slot storage must be its first member.");
+                return reinterpret_cast<Slot*>(const_cast<T*>(&object));
             }
-            UInt32 array;
-            UInt32 index;
+
+            alignas(T) unsigned char storage[sizeof(T)];
+            Slot* nextFree;
+            // Atomic only so that thread caches can check it without the pool's lock.
+            std::atomic<UInt32> epoch;
         };
 
-        void deallocateObjects () {
-            for (UInt32 i = 0; i < this->objects.size(); i++) {
-                delete[] this->objects[i];
+        class Slab {
+        public:
+            Slot* slots;
+            UInt32 count;
+        };
+
+        Slot* acquireSlot() {
+            Slot* slot = this->freeList;
+            if (slot) {
+                this->freeList = slot->nextFree;
             }
-            this->objects.erase(this->objects.begin(), this->objects.end());
+            else {
+                if (this->size >= this->capacity) this->increaseCapacity();
+                if (this->bumpIndex >= this->slabs[this->bumpSlab].count) {
+                    this->bumpSlab++;
+                    this->bumpIndex = 0;
+                }
+                slot = &this->slabs[this->bumpSlab].slots[this->bumpIndex];
+                this->bumpIndex++;
+            }
+            slot->epoch.store(this->epoch.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            slot->nextFree = nullptr;
+            this->size++;
+            this->acquireCount++;
+            if (this->size > this->peakSize) this->peakSize = this->size;
+            return slot;
+        }
+
+        void returnSlot(Slot* slot) {
+            // ignore objects that are not currently acquired (double returns, or objects
+            // that were implicitly returned by returnAll())
+            if (slot->epoch.load(std::memory_order_relaxed) != this->epoch.load(std::memory_order_relaxed)) return;
+            slot->epoch.store(0, std::memory_order_relaxed);
+            slot->nextFree = this->freeList;
+            this->freeList = slot;
+            this->size--;
+            this->returnCount++;
         }
-        
-        void setupNextFreeLocations(UInt32 oldCapacity, UInt32 newCapacity) {
-            for (UInt32 i = oldCapacity; i < newCapacity; i++) {
-                this->nextFreeLocations.push_back(i);
+
+        void returnAllUnlocked() {
+            this->returnCount += this->size;
+            this->size = 0;
+            this->freeList = nullptr;
+            this->bumpSlab = 0;
+            this->bumpIndex = 0;
+            UInt32 nextEpoch = this->epoch.load(std::memory_order_relaxed) + 1;
+            // epoch 0 marks free slots, and caches that haven't acquired anything yet
+            if (nextEpoch == 0) nextEpoch = 1;
+            this->epoch.store(nextEpoch, std::memory_order_release);
+        }
+
+        Statistics getStatisticsUnlocked() const {
+            Statistics stats;
+            stats.capacity = this->capacity;
+            stats.liveCount = this->size;
+            stats.peakLiveCount = this->peakSize;
+            stats.slabCount = (UInt32)this->slabs.size();
+            stats.acquireCount = this->acquireCount;
+            stats.returnCount = this->returnCount;
+            return stats;
+        }
+
+        void deallocateObjects () {
+            for (UInt32 i = 0; i < this->slabs.size(); i++) {
+                delete[] this->slabs[i].slots;
             }
+            this->slabs.clear();
         }
 
         void increaseCapacity() {
@@ -83,28 +288,25 @@ namespace Core {
         }
 
         void increaseCapacity(UInt32 newCapacity) {
-            UInt32 capacityDelta = newCapacity - this->capacity;
-            T* temp = new T[capacityDelta];
-            UInt32 nextArray = this->objects.size();
-            this->objects.push_back(temp);
-            for (unsigned int i = 0; i < capacityDelta; i++) {
-                this->storageMap[i + this->capacity] = StorageDesc(nextArray, i);
-            }
-            for (unsigned int i = capacity; i < newCapacity; i++) {
-                StorageDesc storageDesc = this->storageMap[i];
-                T& object = this->objects[storageDesc.array][storageDesc.index];
-                this->objectLocations[&object] = i;
-            }
-            setupNextFreeLocations(capacity, newCapacity);
+            Slab slab;
+            slab.count = newCapacity - this->capacity;
+            slab.slots = new Slot[slab.count];
+            this->slabs.push_back(slab);
             this->capacity = newCapacity;
         }
 
         UInt32 size;
-        std::vector<T*> objects;
+        UInt32 peakSize;
         UInt32 capacity;
-        std::unordered_map<UInt32, StorageDesc> storageMap;
-        std::unordered_map<T*, UInt32> objectLocations;
-        std::vector<UInt32> nextFreeLocations;
+        std::atomic<UInt32> epoch;
+        Bool threadSafe;
+        UInt64 acquireCount;
+        UInt64 returnCount;
+        std::vector<Slab> slabs;
+        Slot* freeList;
+        UInt32 bumpSlab;
+        UInt32 bumpIndex;
+        std::mutex poolMutex;
     };
 
-}
\ No newline at end of file
+}
@@ -0,0 +1,85 @@
+#include <algorithm>
+
+#include "ParallelFor.h"
+
+namespace Core {
+
+    ParallelForPool& ParallelForPool::getInstance() {
+        static ParallelForPool pool;
+        return pool;
+    }
+
+    ParallelForPool::ParallelForPool() {
+        this->stopping = false;
+        // the thread that calls run() does a share of the work, so it doesn't need a worker of its own
+        UInt32 hardwareThreads = std::thread::hardware_concurrency();
+        UInt32 workerCount = hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+        for (UInt32 i = 0; i < workerCount; i++) {
+            this->workers.push_back(std::thread(&ParallelForPool::workerLoop, this));
+        }
+    }
+
+    ParallelForPool::~ParallelForPool() {
+        {
+            std::lock_guard<std::mutex> lock(this->jobMutex);
+            this->stopping = true;
+        }
+        this->jobAvailable.notify_all();
+        for (std::thread& worker : this->workers) worker.join();
+    }
+
+    UInt32 ParallelForPool::getWorkerCount() const {
+        return (UInt32)this->workers.size();
+    }
+
+    void ParallelForPool::run(UInt32 taskCount, const std::function<void(UInt32)>& task) {
+        if (taskCount == 0) return;
+        std::shared_ptr<Job> job = std::make_shared<Job>(taskCount, task);
+        {
+            std::lock_guard<std::mutex> lock(this->jobMutex);
+            this->jobs.push_back(job);
+        }
+        if (taskCount > 2) this->jobAvailable.notify_all();
+        else this->jobAvailable.notify_one();
+
+        job->runTasks();
+        {
+            std::lock_guard<std::mutex> lock(this->jobMutex);
+            auto queued = std::find(this->jobs.begin(), this->jobs.end(), job);
+            if (queued != this->jobs.end()) this->jobs.erase(queued);
+        }
+        std::unique_lock<std::mutex> lock(job->finishedMutex);
+        job->finished.wait(lock, [&job]() { return job->finishedCount.load() == job->taskCount; });
+    }
+
+    Bool ParallelForPool::Job::runTasks() {
+        Bool ranAny = false;
+        for (;;) {
+            UInt32 index = this->nextTask.fetch_add(1);
+            if (index >= this->taskCount) return ranAny;
+            ranAny = true;
+            this->task(index);
+            if (this->finishedCount.fetch_add(1) + 1 == this->taskCount) {
+                std::lock_guard<std::mutex> lock(this->finishedMutex);
+                this->finished.notify_all();
+            }
+        }
+    }
+
+    void ParallelForPool::workerLoop() {
+        for (;;) {
+            std::shared_ptr<Job> job;
+            {
+                std::unique_lock<std::mutex> lock(this->jobMutex);
+                this->jobAvailable.wait(lock, [this]() { return this->stopping || this->jobs.size() > 0; });
+                if (this->stopping) return;
+                job = this->jobs.front();
+            }
+            if (!job->runTasks()) {
+                // every task has been claimed, so nobody else needs to find this job
+                std::lock_guard<std::mutex> lock(this->jobMutex);
+                if (this->jobs.size() > 0 && this->jobs.front() == job) this->jobs.pop_front();
+            }
+        }
+    }
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "../common/types.h"
+
+namespace Core {
+
+    // Worker threads shared by every parallelFor() call. They are started on first use and then wait
+    // for work, so a parallel loop costs a wake-up instead of creating and joining threads each time.
+    class ParallelForPool final {
+    public:
+        static ParallelForPool& getInstance();
+
+        ~ParallelForPool();
+        ParallelForPool(const ParallelForPool&) = delete;
+        ParallelForPool& operator=(const ParallelForPool&) = delete;
+
+        UInt32 getWorkerCount() const;
+        // Call [task](i) for every i in [0, taskCount), on the workers and the calling thread, and return
+        // once all calls have finished. The calling thread takes tasks itself while it waits, so a task
+        // may start a nested run() without deadlocking. [task] must not throw.
+        void run(UInt32 taskCount, const std::function<void(UInt32)>& task);
+
+    private:
+        class Job {
+        public:
+            Job(UInt32 taskCount, const std::function<void(UInt32)>& task): taskCount(taskCount), task(task) {
+                this->nextTask = 0;
+                this->finishedCount = 0;
+            }
+
+            // Run unclaimed tasks until none are left; returns false if there were none to begin with.
+            Bool runTasks();
+
+            UInt32 taskCount;
+            const std::function<void(UInt32)>& task;
+            std::atomic<UInt32> nextTask;
+            std::atomic<UInt32> finishedCount;
+            std::mutex finishedMutex;
+            std::condition_variable finished;
+        };
+
+        ParallelForPool();
+        void workerLoop();
+
+        std::vector<std::thread> workers;
+        std::deque<std::shared_ptr<Job>> jobs;
+        std::mutex jobMutex;
+        std::condition_variable jobAvailable;
+        Bool stopping;
+    };
+
+    // Call [function](first, last) for consecutive slices of [0, count) on as many threads as the work justifies,
+    // with no slice smaller than [minimumSliceSize]. Exceptions thrown by any slice are re-thrown on the calling
+    // thread once all slices have finished.
+    template <typename T>
+    void parallelFor(UInt32 count, UInt32 minimumSliceSize, T function) {
+        if (minimumSliceSize == 0) minimumSliceSize = 1;
+        UInt32 threadCount = count / minimumSliceSize;
+        // checked first so that small loops never start the pool
+        if (threadCount <= 1) {
+            function(0, count);
+            return;
+        }
+        ParallelForPool& pool = ParallelForPool::getInstance();
+        if (threadCount > pool.getWorkerCount() + 1) threadCount = pool.getWorkerCount() + 1;
+        if (threadCount <= 1) {
+            function(0, count);
+            return;
+        }
+
+        UInt32 sliceSize = (count + threadCount - 1) / threadCount;
+        UInt32 sliceCount = (count + sliceSize - 1) / sliceSize;
+        std::vector<std::exception_ptr> errors(sliceCount);
+        pool.run(sliceCount, [&function, &errors, sliceSize, count](UInt32 slice) {
+            UInt32 first = slice * sliceSize;
+            UInt32 last = first + sliceSize < count ? first + sliceSize : count;
+            try {
+                function(first, last);
+            }
+            catch(...) {
+                errors[slice] = std::current_exception();
+            }
+        });
+        for (std::exception_ptr& error : errors) {
+            if (error) std::rethrow_exception(error);
+        }
+    }
+}
@@ -1,22 +1,25 @@
 #pragma once
 
 #include <vector>
-#include <unordered_map>
 
 #include "../common/types.h"
 
 namespace Core {
 
+    // Bump-allocating pool that only supports returning all objects at once. Storage grows in
+    // slabs that are never moved, so acquired objects keep stable addresses.
     template <typename T> class SimpleObjectPool final {
     public:
         SimpleObjectPool(UInt32 initialCapacity) {
             this->capacity = 0;
             this->size = 0;
-            this->increaseCapacity(initialCapacity);
+            this->currentSlab = 0;
+            this->currentIndex = 0;
+            this->increaseCapacity(initialCapacity > 0 ? initialCapacity : 1);
         }
 
         SimpleObjectPool(): SimpleObjectPool(512) {
-            
+
         }
 
         ~SimpleObjectPool() {
@@ -27,27 +30,36 @@ namespace Core {
             return this->capacity;
         }
 
+        UInt32 getSize() {
+            return this->size;
+        }
+
         T& acquireObject() {
-            if (this->size >= this->capacity) throw "Error!";
-            T& object = this->objects[this->size];
+            if (this->size >= this->capacity) this->increaseCapacity();
+            if (this->currentIndex >= this->slabSizes[this->currentSlab]) {
+                this->currentSlab++;
+                this->currentIndex = 0;
+            }
+            T& object = this->slabs[this->currentSlab][this->currentIndex];
+            this->currentIndex++;
             this->size++;
             return object;
         }
 
         void returnAll() {
             this->size = 0;
+            this->currentSlab = 0;
+            this->currentIndex = 0;
         }
 
     private:
 
         void deallocateObjects () {
-            this->objects.erase(this->objects.begin(), this->objects.end());
-        }
-        
-        void allocate(UInt32 oldCapacity, UInt32 newCapacity) {
-            for (UInt32 i = oldCapacity; i < newCapacity; i++) {
-                this->objects.push_back(T());
+            for (UInt32 i = 0; i < this->slabs.size(); i++) {
+                delete[] this->slabs[i];
             }
+            this->slabs.clear();
+            this->slabSizes.clear();
         }
 
         void increaseCapacity() {
@@ -55,13 +67,18 @@ namespace Core {
         }
 
         void increaseCapacity(UInt32 newCapacity) {
-            allocate(0, newCapacity);
+            UInt32 capacityDelta = newCapacity - this->capacity;
+            this->slabs.push_back(new T[capacityDelta]);
+            this->slabSizes.push_back(capacityDelta);
             this->capacity = newCapacity;
         }
 
         UInt32 size;
-        std::vector<T> objects;
         UInt32 capacity;
+        UInt32 currentSlab;
+        UInt32 currentIndex;
+        std::vector<T*> slabs;
+        std::vector<UInt32> slabSizes;
     };
 
-}
\ No newline at end of file
+}
@@ -8,6 +8,7 @@ namespace Core {
   Real Time::lastRecordedRealTime = 0;
   Real Time::deltaTime = 0;
   Real Time::realDeltaTime = 0;
+  UInt64 Time::frameCount = 0;
   std::chrono::high_resolution_clock::time_point Time::_startupTime;
 
   Time::Time() {
@@ -51,6 +52,7 @@ namespace Core {
 
     lastRecordedTime = scaledTimeVal;
     lastRecordedRealTime = timeVal;
+    frameCount++;
   }
 
   Real Time::getDeltaTime() {
@@ -62,4 +64,11 @@ namespace Core {
     initialize();
     return realDeltaTime;
   }
+
+  /*
+   * Number of times update() has been called, i.e. the index of the current frame.
+   */
+  UInt64 Time::getFrameCount() {
+    return frameCount;
+  }
 }
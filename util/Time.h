@@ -16,6 +16,7 @@ namespace Core {
 		static Real getTime();
 		static Real getRealDeltaTime();
 		static Real getDeltaTime();
+		static UInt64 getFrameCount();
 
   private:
     static Real timeScale;
@@ -26,6 +27,7 @@ namespace Core {
 		static Real lastRecordedRealTime;
 		static Real deltaTime;
 		static Real realDeltaTime;
+		static UInt64 frameCount;
 
 		static void initialize();
 
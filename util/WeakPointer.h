@@ -4,6 +4,8 @@
 
 #include "../common/Exception.h"
 #include "../common/types.h"
+#include "../base/CoreObject.h"
+#include "ObjectHandleTable.h"
 
 
 //#define __CORE_WEAK_POINTER_CACHE_SHARED true
@@ -18,6 +20,22 @@ namespace Core {
         }
     };
 
+    template <typename T, Bool IsCoreObject = std::is_base_of<CoreObject, T>::value>
+    class WeakPointerHandleResolver {
+    public:
+        static ObjectHandle getHandle(const T* ptr) {
+            return ObjectHandle();
+        }
+    };
+
+    template <typename T>
+    class WeakPointerHandleResolver<T, true> {
+    public:
+        static ObjectHandle getHandle(const T* ptr) {
+            return static_cast<const CoreObject*>(ptr)->getObjectHandle();
+        }
+    };
+
     template <typename T>
     class WeakPointer : public std::weak_ptr<T> {
     public:
@@ -25,31 +43,39 @@ namespace Core {
         template<typename U>
         friend class WeakPointer;
 
-        WeakPointer(): std::weak_ptr<T>(), _ptr(nullptr), _cacheShared(true), _cachedSharedSet(false)  {
+        WeakPointer(): std::weak_ptr<T>() {
+            this->initSharedCache(true);
+            this->clearResolved();
         }
 
-        WeakPointer(const std::weak_ptr<T>& ptr) : std::weak_ptr<T>(ptr), _ptr(nullptr), _cacheShared(true), _cachedSharedSet(false) {
+        // Not resolved here, since that would take a lock() on every construction: see tryGetPtrSlow().
+        WeakPointer(const std::weak_ptr<T>& ptr) : std::weak_ptr<T>(ptr) {
+            this->initSharedCache(true);
+            this->clearResolved();
         }
 
-        WeakPointer(const std::shared_ptr<T>& ptr) : std::weak_ptr<T>(ptr), _ptr(nullptr), _cacheShared(true), _cachedSharedSet(false) {
+        WeakPointer(const std::shared_ptr<T>& ptr) : std::weak_ptr<T>(ptr) {
+            this->initSharedCache(true);
+            this->resolve(ptr.get());
         }
 
         template <typename U>
-        WeakPointer(const WeakPointer<U>& ptr) : std::weak_ptr<T>(ptr),  _cacheShared(true), _cachedSharedSet(false) {
-            this->_ptr = ptr._ptr;
+        WeakPointer(const WeakPointer<U>& ptr) : std::weak_ptr<T>(ptr) {
+            this->initSharedCache(true);
+            this->copyResolved(ptr);
         }
 
         template <typename U>
         WeakPointer<typename std::enable_if<std::is_base_of<T, U>::value, T>::type>& operator =(const WeakPointer<U>& other) {
             if ((void *)&other == (void *)this) return *this;
             std::weak_ptr<T>::operator=(other);
-            this->_ptr = other._ptr;
+            this->copyResolved(other);
             return *this;
         }
 
         WeakPointer& operator =(std::shared_ptr<T>& other) {
             std::weak_ptr<T>::operator=(other);
-            this->_ptr = other.get();
+            this->resolve(other.get());
             return *this;
         }
 
@@ -62,7 +88,7 @@ namespace Core {
             return this->tryGetPtr();
         }
 
-        // TODO: Make this thread-safe. The following code is only valid in a SINGLE THREADED context!
+        // Dereferencing never writes to the instance, so it is safe to do from several threads.
         T* operator ->() {
             return this->tryGetPtr();
         }
@@ -76,6 +102,12 @@ namespace Core {
         }
 
         Bool isValid() const {
+#ifdef __CORE_WEAK_POINTER_USE_HANDLES
+            // Pointers without a handle (unresolved, or to non-CoreObject types) hold the null handle,
+            // which is never alive.
+            if (ObjectHandleTable::isAlive(this->_handleIndex, this->_handleGeneration)) return true;
+            if (this->_handleIndex != 0) return false;
+#endif
             return isValid(*this);
         }
 
@@ -102,15 +134,23 @@ namespace Core {
 
         template<typename U> 
         static WeakPointer<U> dynamicPointerCast(const WeakPointer<T>& src) {
+#ifdef __CORE_WEAK_POINTER_USE_HANDLES
+            // A resolved, live source lets a failed cast be rejected without touching the reference count.
+            if (ObjectHandleTable::isAlive(src._handleIndex, src._handleGeneration)) {
+                if (!dynamic_cast<U*>(src._ptr)) return WeakPointer<U>::nullPtr();
+            }
+#endif
             std::shared_ptr<T> _src_shared = src.lock();
             if (_src_shared) {
-                std::shared_ptr<U> u_shared = std::dynamic_pointer_cast<U>(_src_shared);
-                if (u_shared) {
+                U* u_ptr = dynamic_cast<U*>(_src_shared.get());
+                if (u_ptr) {
+                    std::shared_ptr<U> u_shared(_src_shared, u_ptr);
                     WeakPointer<U> t(u_shared);
-                    t._ptr = u_shared.get();
+#ifdef __CORE_WEAK_POINTER_CACHE_SHARED
                     t._cacheShared = src._cacheShared;
                     t._cachedSharedSet = src._cachedSharedSet;
                     if (t._cachedSharedSet) t._cachedShared = u_shared;
+#endif
                     return t;
                 }
             }
@@ -123,25 +163,87 @@ namespace Core {
 
     protected:
 
-        WeakPointer(const std::weak_ptr<T>& ptr, Bool cacheShared) : std::weak_ptr<T>(ptr), _ptr(nullptr), _cacheShared(cacheShared), _cachedSharedSet(false) {
+        WeakPointer(const std::weak_ptr<T>& ptr, Bool cacheShared) : std::weak_ptr<T>(ptr) {
+            this->initSharedCache(cacheShared);
+            this->clearResolved();
         }
 
-        WeakPointer(const std::shared_ptr<T>& ptr, Bool cacheShared) : std::weak_ptr<T>(ptr), _ptr(nullptr), _cacheShared(cacheShared), _cachedSharedSet(false) {
+        WeakPointer(const std::shared_ptr<T>& ptr, Bool cacheShared) : std::weak_ptr<T>(ptr) {
+            this->initSharedCache(cacheShared);
+            this->resolve(ptr.get());
         }
 
         template <typename U>
-        WeakPointer(const WeakPointer<U>& ptr, Bool cacheShared) : std::weak_ptr<T>(ptr),  _cacheShared(cacheShared), _cachedSharedSet(false) {
-            this->_ptr = ptr._ptr;
+        WeakPointer(const WeakPointer<U>& ptr, Bool cacheShared) : std::weak_ptr<T>(ptr) {
+            this->initSharedCache(cacheShared);
+            this->copyResolved(ptr);
         }
 
-        WeakPointer(Bool cacheShared): std::weak_ptr<T>(), _ptr(nullptr), _cacheShared(cacheShared), _cachedSharedSet(false)  {
+        WeakPointer(Bool cacheShared): std::weak_ptr<T>() {
+            this->initSharedCache(cacheShared);
+            this->clearResolved();
+        }
+
+        void initSharedCache(Bool cacheShared) {
+#ifdef __CORE_WEAK_POINTER_CACHE_SHARED
+            this->_cacheShared = cacheShared;
+            this->_cachedSharedSet = false;
+#endif
         }
 
         T * _getPtr() {
             return this->_ptr;
         }
 
+        void resolve(T* ptr) {
+            this->_ptr = ptr;
+#ifdef __CORE_WEAK_POINTER_USE_HANDLES
+            ObjectHandle handle = ptr ? WeakPointerHandleResolver<T>::getHandle(ptr) : ObjectHandle();
+            this->_handleIndex = handle.index;
+            this->_handleGeneration = handle.generation;
+#endif
+        }
+
+        // Unlike resolve(), doesn't need T to be complete.
+        void clearResolved() {
+            this->_ptr = nullptr;
+#ifdef __CORE_WEAK_POINTER_USE_HANDLES
+            ObjectHandle handle;
+            this->_handleIndex = handle.index;
+            this->_handleGeneration = handle.generation;
+#endif
+        }
+
+        template <typename U>
+        void copyResolved(const WeakPointer<U>& other) {
+            this->_ptr = other._ptr;
+#ifdef __CORE_WEAK_POINTER_USE_HANDLES
+            this->_handleIndex = other._handleIndex;
+            this->_handleGeneration = other._handleGeneration;
+#endif
+        }
+
         T* tryGetPtr() const {
+#ifdef __CORE_WEAK_POINTER_USE_HANDLES
+            if (ObjectHandleTable::isAlive(this->_handleIndex, this->_handleGeneration)) {
+                return this->_ptr;
+            }
+#else
+            if (this->_ptr && isValid(*this)) {
+                return this->_ptr;
+            }
+#endif
+            return this->tryGetPtrSlow();
+        }
+
+        // Kept out of tryGetPtr() so that the check above stays small enough to inline.
+        T* tryGetPtrSlow() const {
+
+#ifdef __CORE_WEAK_POINTER_USE_HANDLES
+            if (this->_handleIndex != 0) {
+                throw WeakPointerAssertionFailure("Tried to use invalid weak pointer.");
+            }
+#endif
 
 #ifdef __CORE_WEAK_POINTER_CACHE_SHARED
             if (this->_cacheShared) {
@@ -156,11 +258,14 @@ namespace Core {
             }
 #endif
 
+            // Built from a bare std::weak_ptr: locked on each use rather than cached, so that the
+            // instance is still never written to.
             if (!this->_ptr) {
-                this->tryUpdatePtr();
-            }
-            if (!this->_ptr) {
-                throw WeakPointerAssertionFailure("Tried to use null weak pointer (2nd try).");
+                std::shared_ptr<T> temp = this->lock();
+                if (!temp) {
+                    throw WeakPointerAssertionFailure("Tried to use null weak pointer.");
+                }
+                return temp.get();
             }
             if (!this->isValid()) {
                 throw WeakPointerAssertionFailure("Tried to use invalid weak pointer.");
@@ -168,17 +273,17 @@ namespace Core {
             return this->_ptr;
         }
 
-        void tryUpdatePtr() const {
-            std::shared_ptr<T> temp = this->lock();
-            if (!temp) {
-                throw WeakPointerAssertionFailure("Tried to use null weak pointer (1st try).");
-            }
-            this->_ptr = temp.get();
-        }
-
-        mutable T * _ptr;
+        // Members of disabled options are compiled out: checking many pointers in a row is bound by
+        // how many of them fit in the cache.
+        T * _ptr;
+#ifdef __CORE_WEAK_POINTER_USE_HANDLES
+        UInt32 _handleIndex;
+        UInt32 _handleGeneration;
+#endif
+#ifdef __CORE_WEAK_POINTER_CACHE_SHARED
         Bool _cacheShared;
         mutable Bool _cachedSharedSet;
         mutable std::shared_ptr<T> _cachedShared;
+#endif
     };
 }